@@ -62,6 +62,11 @@ DEFINE_uint32(value_bytes_estimate, 0,
               "min_avg_entry_charge depending on cache_type.");
 DEFINE_double(compressible_to_ratio, 0.5,
               "Approximate size ratio that values can be compressed to.");
+DEFINE_double(value_shared_ratio, 0.0,
+              "Portion of each value copied from one of a few templates "
+              "shared by all values, like blocks with common structure. "
+              "Compressed secondary cache dictionaries can exploit this, "
+              "see max_dict_bytes in --secondary_cache_uri.");
 
 DEFINE_int32(
     degenerate_hash_bits, 0,
@@ -89,6 +94,14 @@ DEFINE_uint32(lookup_percent, 10,
               "Ratio of lookup to total workload (expressed as a percentage)");
 DEFINE_uint32(erase_percent, 1,
               "Ratio of erase to total workload (expressed as a percentage)");
+DEFINE_uint32(scan_percent, 0,
+              "Percentage of operations that, instead of the workload above, "
+              "look up (and insert on miss) the next key of a one-pass "
+              "sequential scan over keys outside the regular key space. "
+              "Simulates scans polluting the cache; scan lookups are not "
+              "included in the reported hit ratio.");
+DEFINE_bool(tiny_lfu_admission, false,
+            "ShardedCacheOptions::tiny_lfu_admission");
 DEFINE_bool(gather_stats, false,
             "Whether to periodically simulate gathering block cache stats, "
             "using one more thread.");
@@ -263,7 +276,10 @@ struct KeyGen {
     for (uint32_t i = 0; i < skew; ++i) {
       raw = std::min(raw, rnd.Next());
     }
-    uint64_t key = FastRange64(raw, max_key);
+    return Get(FastRange64(raw, max_key));
+  }
+
+  Slice Get(uint64_t key) {
     if (FLAGS_degenerate_hash_bits) {
       uint64_t key_hash =
           Hash64(reinterpret_cast<const char*>(&key), sizeof(key));
@@ -291,20 +307,48 @@ struct KeyGen {
   }
 };
 
+const std::vector<std::string>& GetValueTemplates() {
+  static const std::vector<std::string> templates = [] {
+    Random64 rnd(FLAGS_seed);
+    std::vector<std::string> ret(16);
+    for (auto& t : ret) {
+      t.resize(FLAGS_value_bytes + 8);
+      for (uint32_t i = 0; i < FLAGS_value_bytes; i += 8) {
+        EncodeFixed64(&t[i], rnd.Next());
+      }
+    }
+    return ret;
+  }();
+  return templates;
+}
+
 Cache::ObjectPtr createValue(Random64& rnd, MemoryAllocator* alloc) {
   char* rv = AllocateBlock(FLAGS_value_bytes, alloc).release();
+  const uint32_t shared_size = std::min(
+      FLAGS_value_bytes,
+      static_cast<uint32_t>(std::max(FLAGS_value_shared_ratio, 0.0) *
+                            FLAGS_value_bytes));
+  if (shared_size > 0) {
+    const auto& templates = GetValueTemplates();
+    memcpy(rv, templates[rnd.Uniform(templates.size())].data(), shared_size);
+  }
+  char* fill = rv + shared_size;
+  const uint32_t fill_bytes = FLAGS_value_bytes - shared_size;
+  if (fill_bytes == 0) {
+    return rv;
+  }
   // Fill with some filler data, and take some CPU time, but add redundancy
   // as requested for compressibility.
   uint32_t random_fill_size = std::max(
-      uint32_t{1}, std::min(FLAGS_value_bytes,
-                            static_cast<uint32_t>(FLAGS_compressible_to_ratio *
-                                                  FLAGS_value_bytes)));
+      uint32_t{1},
+      std::min(fill_bytes, static_cast<uint32_t>(FLAGS_compressible_to_ratio *
+                                                 fill_bytes)));
   uint32_t i = 0;
   for (; i < random_fill_size; i += 8) {
-    EncodeFixed64(rv + i, rnd.Next());
+    EncodeFixed64(fill + i, rnd.Next());
   }
-  for (; i < FLAGS_value_bytes; i++) {
-    rv[i] = rv[i % random_fill_size];
+  for (; i < fill_bytes; i++) {
+    fill[i] = fill[i % random_fill_size];
   }
   return rv;
 }
@@ -406,6 +450,7 @@ class CacheBench {
       opts.hash_seed = BitwiseAnd(FLAGS_seed, INT32_MAX);
       opts.memory_allocator = allocator;
       opts.eviction_effort_cap = FLAGS_eviction_effort_cap;
+      opts.tiny_lfu_admission = FLAGS_tiny_lfu_admission;
       if (FLAGS_cache_type == "fixed_hyper_clock_cache" ||
           FLAGS_cache_type == "hyper_clock_cache") {
         opts.estimated_entry_charge = FLAGS_value_bytes_estimate > 0
@@ -427,6 +472,7 @@ class CacheBench {
                            0.5 /* high_pri_pool_ratio */);
       opts.hash_seed = BitwiseAnd(FLAGS_seed, INT32_MAX);
       opts.memory_allocator = allocator;
+      opts.tiny_lfu_admission = FLAGS_tiny_lfu_admission;
       ConfigureSecondaryCache(opts);
       cache_ = NewLRUCache(opts);
     } else {
@@ -708,10 +754,17 @@ class CacheBench {
     StopWatchNano timer(clock);
     auto system_clock = SystemClock::Default();
     size_t steps_to_next_capacity_change = 0;
+    // Each thread scans its own range of keys, above the regular key space
+    uint64_t next_scan_key = max_key_ + (uint64_t{thread->tid} << 40);
 
     for (uint64_t i = 0; i < FLAGS_ops_per_thread; i++) {
       Slice key = gen.GetRand(thread->rnd, max_key_, FLAGS_skew);
       uint64_t random_op = thread->rnd.Next();
+      bool scan_op = FLAGS_scan_percent > 0 &&
+                     thread->rnd.Uniform(100) < FLAGS_scan_percent;
+      if (scan_op) {
+        key = gen.Get(next_scan_key++);
+      }
 
       if (FLAGS_vary_capacity_ratio > 0.0 && thread->tid == 0) {
         if (steps_to_next_capacity_change == 0) {
@@ -730,7 +783,20 @@ class CacheBench {
         timer.Start();
       }
 
-      if (random_op < lookup_insert_threshold_) {
+      if (scan_op) {
+        // do lookup, and insert on miss, without pinning
+        auto handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
+                                     Cache::Priority::LOW);
+        if (handle) {
+          cache_->Release(handle);
+        } else {
+          Status s = cache_->Insert(
+              key, createValue(thread->rnd, cache_->memory_allocator()),
+              &helper2, FLAGS_value_bytes, &handle);
+          assert(s.ok());
+          cache_->Release(handle);
+        }
+      } else if (random_op < lookup_insert_threshold_) {
         // do lookup
         auto handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
                                      Cache::Priority::LOW);
@@ -842,6 +908,8 @@ class CacheBench {
     printf("Insert percentage   : %u%%\n", FLAGS_insert_percent);
     printf("Lookup percentage   : %u%%\n", FLAGS_lookup_percent);
     printf("Erase percentage    : %u%%\n", FLAGS_erase_percent);
+    printf("Scan percentage     : %u%%\n", FLAGS_scan_percent);
+    printf("TinyLFU admission   : %d\n", int{FLAGS_tiny_lfu_admission});
     std::ostringstream stats;
     if (FLAGS_gather_stats) {
       stats << "enabled (" << FLAGS_gather_stats_sleep_ms << "ms, "
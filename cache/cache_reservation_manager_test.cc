@@ -235,6 +235,57 @@ TEST(CacheReservationManagerIncreaseReservcationOnFullCacheTest,
          "cache capacity and mitigating cache full error";
 }
 
+TEST(CacheReservationManagerIncreaseReservcationOnFullCacheTest,
+     IncreaseCacheReservationWithTinyLFUAdmission) {
+  constexpr std::size_t kSizeDummyEntry =
+      CacheReservationManagerImpl<CacheEntryRole::kMisc>::GetDummyEntrySize();
+  constexpr std::size_t kSmallCacheCapacity = 4 * kSizeDummyEntry;
+
+  LRUCacheOptions lo;
+  lo.capacity = kSmallCacheCapacity;
+  lo.num_shard_bits = 0;  // 2^0 shard
+  lo.strict_capacity_limit = true;
+  lo.metadata_charge_policy = kDontChargeCacheMetadata;
+  lo.tiny_lfu_admission = true;
+  std::shared_ptr<Cache> cache = NewLRUCache(lo);
+  std::shared_ptr<CacheReservationManager> test_cache_rev_mng =
+      std::make_shared<CacheReservationManagerImpl<CacheEntryRole::kMisc>>(
+          cache);
+
+  // Fill the cache with frequently accessed entries
+  static const Cache::CacheItemHelper kHelper{
+      CacheEntryRole::kMisc, [](Cache::ObjectPtr, MemoryAllocator*) {}};
+  for (int i = 0; i < 4; i++) {
+    std::string key = "key" + std::to_string(i);
+    ASSERT_OK(cache->Insert(key, nullptr, &kHelper, kSizeDummyEntry));
+    for (int j = 0; j < 3; j++) {
+      Cache::Handle* handle = cache->Lookup(key);
+      ASSERT_NE(handle, nullptr);
+      cache->Release(handle);
+    }
+  }
+  ASSERT_EQ(cache->GetUsage(), kSmallCacheCapacity);
+  ASSERT_EQ(cache->GetPinnedUsage(), 0);
+
+  // Dummy entries are never looked up, but still displace other entries
+  std::size_t new_mem_used = 2 * kSizeDummyEntry;
+  Status s = test_cache_rev_mng->UpdateCacheReservation(new_mem_used);
+  ASSERT_OK(s);
+  ASSERT_EQ(test_cache_rev_mng->GetTotalReservedCacheSize(),
+            2 * kSizeDummyEntry);
+  ASSERT_EQ(cache->GetPinnedUsage(), 2 * kSizeDummyEntry);
+  ASSERT_EQ(cache->GetUsage(), kSmallCacheCapacity);
+
+  // And fail to go beyond the strict capacity limit
+  new_mem_used = kSmallCacheCapacity + 1;
+  s = test_cache_rev_mng->UpdateCacheReservation(new_mem_used);
+  ASSERT_EQ(s, Status::MemoryLimit());
+  ASSERT_EQ(test_cache_rev_mng->GetTotalReservedCacheSize(),
+            kSmallCacheCapacity);
+  ASSERT_EQ(cache->GetPinnedUsage(), kSmallCacheCapacity);
+  ASSERT_LE(cache->GetUsage(), kSmallCacheCapacity);
+}
+
 TEST_F(CacheReservationManagerTest,
        DecreaseCacheReservationByMultiplesOfDummyEntrySize) {
   std::size_t new_mem_used = 2 * kSizeDummyEntry;
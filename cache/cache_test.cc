@@ -748,6 +748,64 @@ TEST_P(LRUCacheTest, SetStrictCapacityLimit) {
   }
 }
 
+TEST_P(LRUCacheTest, TinyLFUAdmissionScanResistance) {
+  constexpr int kNumEntries = 100;
+  constexpr int kCharge = 8192;
+  for (bool tiny_lfu_admission : {false, true}) {
+    SCOPED_TRACE("tiny_lfu_admission=" + std::to_string(tiny_lfu_admission));
+    auto cache = NewCache(kNumEntries * kCharge, [=](ShardedCacheOptions& o) {
+      o.num_shard_bits = 0;
+      o.metadata_charge_policy = kDontChargeCacheMetadata;
+      o.tiny_lfu_admission = tiny_lfu_admission;
+    });
+    deleted_values_.clear();
+
+    // Frequently accessed working set, filling half of the cache
+    for (int i = 0; i < kNumEntries / 2; i++) {
+      ASSERT_EQ(-1, Lookup(cache, i));
+      Insert(cache, i, i, kCharge);
+      for (int j = 0; j < 3; j++) {
+        ASSERT_EQ(i, Lookup(cache, i));
+      }
+    }
+
+    // A scan touching each of many more keys than fit in the cache once,
+    // alternating between inserts with and without a handle
+    for (int i = 1000; i < 1000 + 10 * kNumEntries; i++) {
+      ASSERT_EQ(-1, Lookup(cache, i));
+      if (i % 2 == 0) {
+        Insert(cache, i, i, kCharge);
+      } else {
+        Cache::Handle* handle = nullptr;
+        ASSERT_OK(cache->Insert(EncodeKey(i), EncodeValue(i), &kHelper,
+                                kCharge, &handle));
+        ASSERT_NE(handle, nullptr);
+        ASSERT_EQ(i, DecodeValue(cache->Value(handle)));
+        // Charged to the cache even if declined
+        ASSERT_GE(cache->GetPinnedUsage(), kCharge);
+        cache->Release(handle);
+      }
+      ASSERT_LE(cache->GetUsage(), kNumEntries * kCharge);
+    }
+
+    int working_set_hits = 0;
+    for (int i = 0; i < kNumEntries / 2; i++) {
+      if (Lookup(cache, i) == i) {
+        working_set_hits++;
+      }
+    }
+    if (tiny_lfu_admission) {
+      ASSERT_EQ(kNumEntries / 2, working_set_hits);
+      // Declined entries are freed right away or on their last release
+      ASSERT_EQ(size_t{10 * kNumEntries - kNumEntries / 2},
+                deleted_values_.size());
+    } else {
+      ASSERT_EQ(0, working_set_hits);
+    }
+    ASSERT_EQ(0, cache->GetPinnedUsage());
+  }
+}
+
 TEST_P(CacheTest, OverCapacity) {
   size_t n = 10;
 
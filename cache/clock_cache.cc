@@ -437,6 +437,23 @@ typename Table::HandleImpl* BaseClockTable::CreateStandalone(
   return StandaloneInsert<typename Table::HandleImpl>(proto);
 }
 
+template <class Table>
+typename Table::HandleImpl* BaseClockTable::CreateStandaloneNoEvict(
+    ClockHandleBasicData& proto, size_t capacity, uint32_t eec_and_scl) {
+  const size_t total_charge = proto.GetTotalCharge();
+  if (eec_and_scl & kStrictCapacityLimitBit) {
+    size_t old_usage = usage_.LoadRelaxed();
+    do {
+      if (old_usage + total_charge > capacity) {
+        return nullptr;
+      }
+    } while (!usage_.CasWeakRelaxed(old_usage, old_usage + total_charge));
+  } else {
+    usage_.FetchAddRelaxed(total_charge);
+  }
+  return StandaloneInsert<typename Table::HandleImpl>(proto);
+}
+
 template <class Table>
 Status BaseClockTable::ChargeUsageMaybeEvictStrict(
     size_t total_charge, size_t capacity, bool need_evict_for_occupancy,
@@ -1293,6 +1310,59 @@ typename Table::HandleImpl* ClockCacheShard<Table>::CreateStandalone(
                                                  allow_uncharged);
 }
 
+template <class Table>
+Status ClockCacheShard<Table>::InsertWithAdmission(
+    const Slice& key, const UniqueId64x2& hashed_key, Cache::ObjectPtr value,
+    const Cache::CacheItemHelper* helper, size_t charge, HandleImpl** handle,
+    Cache::Priority priority, const FrequencySketch& sketch) {
+  const size_t capacity = capacity_.LoadRelaxed();
+  if (UNLIKELY(key.size() != kCacheKeySize) ||
+      table_.GetUsage() + charge <= capacity) {
+    return Insert(key, hashed_key, value, helper, charge, handle, priority);
+  }
+  // Approximate the next victim by the first entry visible to lookups at or
+  // just after the clock pointer. (Which entry is actually evicted also
+  // depends on its clock state.) This is lock free, like the rest of
+  // HyperClockCache.
+  constexpr size_t kMaxProbes = 4;
+  size_t length = table_.GetTableSize();
+  uint64_t clock_pointer = table_.GetClockPointer();
+  bool found = false;
+  uint64_t victim_hash = 0;
+  for (size_t i = 0; i < kMaxProbes && !found; i++) {
+    const HandleImpl* h =
+        table_.HandlePtr(static_cast<size_t>((clock_pointer + i) % length));
+    ConstApplyToEntriesRange(
+        [&](const HandleImpl& e) {
+          victim_hash = HashForAdmission(e.hashed_key);
+          found = true;
+        },
+        h, h + 1, /*apply_if_will_be_deleted=*/false);
+  }
+  if (!found || sketch.Estimate(HashForAdmission(hashed_key)) >
+                    sketch.Estimate(victim_hash)) {
+    return Insert(key, hashed_key, value, helper, charge, handle, priority);
+  }
+
+  ClockHandleBasicData proto;
+  proto.hashed_key = hashed_key;
+  proto.value = value;
+  proto.helper = helper;
+  proto.total_charge = charge;
+  if (handle == nullptr) {
+    // As if inserted and immediately evicted
+    proto.FreeData(table_.GetAllocator());
+    return Status::OK();
+  }
+  *handle = table_.template CreateStandaloneNoEvict<Table>(
+      proto, capacity, eec_and_scl_.LoadRelaxed());
+  if (*handle != nullptr) {
+    return Status::OK();
+  }
+  // Does not fit under strict_capacity_limit
+  return Insert(key, hashed_key, value, helper, charge, handle, priority);
+}
+
 template <class Table>
 typename ClockCacheShard<Table>::HandleImpl* ClockCacheShard<Table>::Lookup(
     const Slice& key, const UniqueId64x2& hashed_key) {
@@ -403,6 +403,12 @@ class BaseClockTable {
                 typename Table::HandleImpl** handle, Cache::Priority priority,
                 size_t capacity, uint32_t eec_and_scl);
 
+  // Like CreateStandalone, but charged without evicting anything to make
+  // room. Returns nullptr under strict_capacity_limit if it does not fit.
+  template <class Table>
+  typename Table::HandleImpl* CreateStandaloneNoEvict(
+      ClockHandleBasicData& proto, size_t capacity, uint32_t eec_and_scl);
+
   void Ref(ClockHandle& handle);
 
   size_t GetOccupancy() const { return occupancy_.LoadRelaxed(); }
@@ -413,6 +419,10 @@ class BaseClockTable {
 
   uint32_t GetHashSeed() const { return hash_seed_; }
 
+  MemoryAllocator* GetAllocator() const { return allocator_; }
+
+  uint64_t GetClockPointer() const { return clock_pointer_.LoadRelaxed(); }
+
   uint64_t GetYieldCount() const { return yield_count_.LoadRelaxed(); }
 
   uint64_t GetEvictionEffortExceededCount() const {
@@ -653,8 +663,6 @@ class FixedHyperClockTable : public BaseClockTable {
   // before releasing it so that it can be provided to this function.
   inline void ReclaimEntryUsage(size_t total_charge);
 
-  MemoryAllocator* GetAllocator() const { return allocator_; }
-
   // Returns the number of bits used to hash an element in the hash
   // table.
   static int CalcHashBits(size_t capacity, size_t estimated_value_size,
@@ -1010,6 +1018,7 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
   static inline uint32_t HashPieceForSharding(HashCref hash) {
     return Upper32of64(hash[0]);
   }
+  static inline uint64_t HashForAdmission(HashCref hash) { return hash[1]; }
   static inline HashVal ComputeHash(const Slice& key, uint32_t seed) {
     assert(key.size() == kCacheKeySize);
     HashVal in;
@@ -1047,6 +1056,13 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
                                const Cache::CacheItemHelper* helper,
                                size_t charge, bool allow_uncharged);
 
+  Status InsertWithAdmission(const Slice& key, const UniqueId64x2& hashed_key,
+                             Cache::ObjectPtr value,
+                             const Cache::CacheItemHelper* helper,
+                             size_t charge, HandleImpl** handle,
+                             Cache::Priority priority,
+                             const FrequencySketch& sketch);
+
   HandleImpl* Lookup(const Slice& key, const UniqueId64x2& hashed_key);
 
   bool Release(HandleImpl* handle, bool useful, bool erase_if_last_ref);
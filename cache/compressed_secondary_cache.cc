@@ -6,13 +6,20 @@
 #include "cache/compressed_secondary_cache.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cstdint>
 #include <memory>
 
+#include "cache/sharded_cache.h"
 #include "memory/memory_allocator_impl.h"
 #include "monitoring/perf_context_imp.h"
+#include "test_util/sync_point.h"
 #include "util/coding.h"
 #include "util/compression.h"
+#include "util/defer.h"
+#include "util/fastrange.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -33,8 +40,22 @@ namespace {
 //    CompressedSecondaryCache iff source == CacheTier::kVolatileCompressedTier
 //    (original entry passed in was uncompressed). Otherwise, the compression
 //    type is preserved from the entry passed in.
+//
+// With max_dict_bytes > 0, data compressed by CompressedSecondaryCache is
+// preceded by a pointer to the dictionary it was compressed with, or nullptr
+// for none. The entry holds a reference to the dictionary.
 constexpr uint32_t kTagSize = 2;
 
+// Number of blocks sampled into each dictionary.
+constexpr uint32_t kSamplesPerDict = 64;
+
+constexpr uint64_t kGoldenRatio64 = 0x9E3779B97F4A7C15;
+
+bool SupportsDict(CompressionType type) {
+  return type == kZSTD || type == kLZ4Compression ||
+         type == kLZ4HCCompression;
+}
+
 // Size of tag + varint size prefix when applicable
 uint32_t GetHeaderSize(size_t data_size, bool enable_split_merge) {
   return (enable_split_merge ? 0 : VarintLength(kTagSize + data_size)) +
@@ -50,15 +71,47 @@ CompressedSecondaryCache::CompressedSecondaryCache(
           std::make_shared<CacheReservationManagerImpl<CacheEntryRole::kMisc>>(
               cache_))),
       disable_cache_(opts.capacity == 0) {
-  auto mgr =
+  std::shared_ptr<CompressionManager> mgr =
       GetBuiltinCompressionManager(cache_options_.compress_format_version);
-  compressor_ = mgr->GetCompressor(cache_options_.compression_opts,
-                                   cache_options_.compression_type);
+  TEST_SYNC_POINT_CALLBACK(
+      "CompressedSecondaryCache::CompressedSecondaryCache:CompressionManager",
+      &mgr);
+  CompressionOptions compression_opts = cache_options_.compression_opts;
+  const bool use_dict = cache_options_.max_dict_bytes > 0 &&
+                        SupportsDict(cache_options_.compression_type) &&
+                        cache_options_.compress_format_version >= 2;
+  compression_opts.max_dict_bytes =
+      use_dict ? cache_options_.max_dict_bytes : 0;
+  compressor_ =
+      mgr->GetCompressor(compression_opts, cache_options_.compression_type);
   decompressor_ =
       mgr->GetDecompressorOptimizeFor(cache_options_.compression_type);
+  if (use_dict && compressor_) {
+    max_dict_sample_bytes_ =
+        compressor_->GetMaxSampleSizeIfWantDict(CacheEntryRole::kMisc);
+  }
+  if (max_dict_sample_bytes_ > 0) {
+    const int num_shard_bits =
+        cache_options_.num_shard_bits >= 0
+            ? cache_options_.num_shard_bits
+            : GetDefaultCacheShardBits(cache_options_.capacity);
+    dict_shards_.reset(new DictShard[size_t{1} << num_shard_bits]);
+    dict_shard_mask_ = (uint32_t{1} << num_shard_bits) - 1;
+  }
 }
 
-CompressedSecondaryCache::~CompressedSecondaryCache() = default;
+CompressedSecondaryCache::~CompressedSecondaryCache() {
+  // The entries reference the dictionaries, which report back here when they
+  // are released, so free them while the rest is still alive.
+  cache_res_mgr_.reset();
+  cache_.reset();
+  for (uint32_t i = 0; dict_shards_ && i <= dict_shard_mask_; ++i) {
+    if (dict_shards_[i].dict) {
+      dict_shards_[i].dict->Unref();
+    }
+  }
+  assert(num_dicts_.load(std::memory_order_relaxed) == 0);
+}
 
 std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
     const Slice& key, const Cache::CacheItemHelper* helper,
@@ -101,15 +154,24 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   Slice saved(tagged_data.data() + kTagSize, tagged_data.size() - kTagSize);
   if (source == CacheTier::kVolatileCompressedTier) {
     if (type != kNoCompression) {
+      Decompressor* decompressor = decompressor_.get();
+      if (dict_shards_) {
+        // Kept alive by the entry, which lru_handle pins.
+        CompressionDictionary* const dict = GetEntryDict(tagged_data);
+        saved.remove_prefix(sizeof(dict));
+        if (dict) {
+          decompressor = dict->decompressor.get();
+        }
+      }
       // TODO: can we do something to avoid yet another allocation?
       Decompressor::Args args;
       args.compressed_data = saved;
       args.compression_type = type;
-      Status s = decompressor_->ExtractUncompressedSize(args);
+      Status s = decompressor->ExtractUncompressedSize(args);
       assert(s.ok());  // in-memory data
       if (s.ok()) {
         uncompressed = std::make_unique<char[]>(args.uncompressed_size);
-        s = decompressor_->DecompressBlock(args, uncompressed.get());
+        s = decompressor->DecompressBlock(args, uncompressed.get());
         assert(s.ok());  // in-memory data
       }
       if (!s.ok()) {
@@ -204,19 +266,39 @@ Status CompressedSecondaryCache::InsertInternal(
 
   std::unique_ptr<char[]> tagged_compressed_data;
   CompressionType to_type = kNoCompression;
+  // Reference to the dictionary the data is compressed with, until it is
+  // handed over to the entry.
+  CompressionDictionary* dict = nullptr;
+  Defer unref_dict([&dict]() {
+    if (dict) {
+      dict->Unref();
+    }
+  });
   if (compressor_ && from_type == kNoCompression &&
       !cache_options_.do_not_compress_roles.Contains(helper->role)) {
     assert(source == CacheTier::kVolatileCompressedTier);
 
+    Compressor* compressor = compressor_.get();
+    size_t dict_ptr_len = 0;
+    if (dict_shards_) {
+      dict = SampleAndGetDict(GetDictShard(key),
+                              Slice(data_ptr, data_size_original));
+      if (dict) {
+        compressor = dict->compressor.get();
+      }
+      dict_ptr_len = sizeof(dict);
+    }
+
     // TODO: consider malloc sizes for max acceptable compressed size
     // Or maybe max_compressed_bytes_per_kb
     size_t data_size_compressed = data_size_original - 1;
-    tagged_compressed_data =
-        std::make_unique<char[]>(data_size_compressed + kTagSize);
-    s = compressor_->CompressBlock(Slice(data_ptr, data_size_original),
-                                   tagged_compressed_data.get() + kTagSize,
-                                   &data_size_compressed, &to_type,
-                                   nullptr /*working_area*/);
+    tagged_compressed_data = std::make_unique<char[]>(
+        data_size_compressed + kTagSize + dict_ptr_len);
+    std::memcpy(tagged_compressed_data.get() + kTagSize, &dict, dict_ptr_len);
+    s = compressor->CompressBlock(
+        Slice(data_ptr, data_size_original),
+        tagged_compressed_data.get() + kTagSize + dict_ptr_len,
+        &data_size_compressed, &to_type, nullptr /*working_area*/);
     if (!s.ok()) {
       return s;
     }
@@ -226,12 +308,18 @@ Status CompressedSecondaryCache::InsertInternal(
       // Compression rejected or otherwise aborted/failed
       to_type = kNoCompression;
       tagged_compressed_data.reset();
+      if (dict) {
+        dict->Unref();
+        dict = nullptr;
+      }
       // TODO: consider separate counters for rejected compressions
       PERF_COUNTER_ADD(compressed_sec_cache_compressed_bytes,
                        data_size_original);
     } else {
       PERF_COUNTER_ADD(compressed_sec_cache_compressed_bytes,
                        data_size_compressed);
+      // The dictionary pointer is stored along with the compressed data.
+      data_size_compressed += dict_ptr_len;
       if (enable_split_merge) {
         // Only need tagged_data for copying into CacheValueChunks.
         tagged_data = Slice(tagged_compressed_data.get(),
@@ -261,6 +349,12 @@ Status CompressedSecondaryCache::InsertInternal(
   const_cast<char*>(tagged_data.data())[1] = lossless_cast<char>(
       source == CacheTier::kVolatileCompressedTier ? to_type : from_type);
 
+  if (dict) {
+    // Released through the helper when the entry is freed
+    internal_helper = GetHelper(enable_split_merge, /*with_dict=*/true);
+    dict = nullptr;
+  }
+
   if (enable_split_merge) {
     size_t split_charge{0};
     CacheValueChunk* value_chunks_head =
@@ -359,9 +453,141 @@ std::string CompressedSecondaryCache::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
            cache_options_.compress_format_version);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    max_dict_bytes : %" PRIu32 "\n",
+           cache_options_.max_dict_bytes);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    dict_retrain_interval : %" PRIu32 "\n",
+           cache_options_.dict_retrain_interval);
+  ret.append(buffer);
   return ret;
 }
 
+CompressedSecondaryCache::DictShard& CompressedSecondaryCache::GetDictShard(
+    const Slice& key) {
+  assert(dict_shards_);
+  return dict_shards_[Lower32of64(GetSliceNPHash64(key)) & dict_shard_mask_];
+}
+
+CompressedSecondaryCache::CompressionDictionary*
+CompressedSecondaryCache::SampleAndGetDict(DictShard& shard,
+                                           const Slice& data) {
+  ReturnReleasedDictCharge();
+
+  const uint32_t retrain_interval =
+      std::max(cache_options_.dict_retrain_interval, uint32_t{1});
+  const uint32_t sample_stride =
+      std::max(retrain_interval / kSamplesPerDict, uint32_t{1});
+  CompressionDictionary* dict = nullptr;
+  Compressor::DictSampleArgs samples;
+  {
+    MutexLock l(&shard.mutex);
+    dict = shard.dict;
+    if (dict) {
+      dict->Ref();
+    }
+    ++shard.inserts_since_training;
+    if (shard.inserts_since_training % sample_stride == 0) {
+      // Part of the block, so that each dictionary covers many blocks. The
+      // offset varies so that it does not only cover their headers.
+      const size_t len = std::min(
+          {data.size(),
+           max_dict_sample_bytes_ - shard.samples.sample_data.size(),
+           std::max(max_dict_sample_bytes_ /
+                        std::min(kSamplesPerDict, retrain_interval),
+                    size_t{1})});
+      if (len > 0) {
+        const size_t offset = static_cast<size_t>(
+            FastRange64(shard.inserts_since_training * kGoldenRatio64,
+                        data.size() - len + 1));
+        shard.samples.sample_data.append(data.data() + offset, len);
+        shard.samples.sample_lens.push_back(len);
+      }
+    }
+    if (shard.inserts_since_training >= retrain_interval && !shard.training &&
+        !shard.samples.empty()) {
+      shard.training = true;
+      shard.inserts_since_training = 0;
+      samples = std::move(shard.samples);
+      shard.samples = Compressor::DictSampleArgs();
+    }
+  }
+  if (!samples.empty()) {
+    // Trained outside of the mutex, which only blocks this insertion.
+    TrainDict(shard, std::move(samples));
+  }
+  return dict;
+}
+
+void CompressedSecondaryCache::TrainDict(
+    DictShard& shard, Compressor::DictSampleArgs&& samples) {
+  auto dict = std::make_unique<CompressionDictionary>();
+  dict->owner = this;
+  dict->compressor =
+      compressor_->MaybeCloneSpecialized(CacheEntryRole::kMisc,
+                                         std::move(samples));
+  if (dict->compressor == nullptr ||
+      dict->compressor->GetSerializedDict().empty() ||
+      !decompressor_
+           ->MaybeCloneForDict(dict->compressor->GetSerializedDict(),
+                               &dict->decompressor)
+           .ok()) {
+    dict.reset();
+  } else {
+    dict->charge = dict->compressor->GetSerializedDict().size() +
+                   dict->decompressor->ApproximateOwnedMemoryUsage();
+    num_dicts_.fetch_add(1, std::memory_order_relaxed);
+    // Dictionaries are charged to the cache like its other overheads.
+    cache_res_mgr_->UpdateCacheReservation(dict->charge, /*increase=*/true)
+        .PermitUncheckedError();
+  }
+
+  CompressionDictionary* old_dict = nullptr;
+  {
+    MutexLock l(&shard.mutex);
+    shard.training = false;
+    if (dict) {
+      old_dict = shard.dict;
+      shard.dict = dict.release();
+    }
+  }
+  // The entries compressed with the old dictionary keep it alive.
+  if (old_dict) {
+    old_dict->Unref();
+  }
+}
+
+void CompressedSecondaryCache::CompressionDictionary::Unref() {
+  if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    owner->OnDictReleased(this);
+  }
+}
+
+void CompressedSecondaryCache::OnDictReleased(CompressionDictionary* dict) {
+  released_dict_charge_.fetch_add(dict->charge, std::memory_order_relaxed);
+  num_dicts_.fetch_sub(1, std::memory_order_relaxed);
+  delete dict;
+}
+
+void CompressedSecondaryCache::ReturnReleasedDictCharge() {
+  if (released_dict_charge_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  const size_t charge =
+      released_dict_charge_.exchange(0, std::memory_order_relaxed);
+  if (charge > 0) {
+    cache_res_mgr_->UpdateCacheReservation(charge, /*increase=*/false)
+        .PermitUncheckedError();
+  }
+}
+
+CompressedSecondaryCache::CompressionDictionary*
+CompressedSecondaryCache::GetEntryDict(const Slice& tagged_data) {
+  CompressionDictionary* dict = nullptr;
+  assert(tagged_data.size() >= kTagSize + sizeof(dict));
+  std::memcpy(&dict, tagged_data.data() + kTagSize, sizeof(dict));
+  return dict;
+}
+
 // FIXME: this could use a lot of attention, including:
 // * Use allocator
 // * We shouldn't be worse than non-split; be more pro-actively aware of
@@ -433,7 +659,7 @@ std::string CompressedSecondaryCache::MergeChunksIntoValue(
 }
 
 const Cache::CacheItemHelper* CompressedSecondaryCache::GetHelper(
-    bool enable_custom_split_merge) const {
+    bool enable_custom_split_merge, bool with_dict) const {
   if (enable_custom_split_merge) {
     static const Cache::CacheItemHelper kHelper{
         CacheEntryRole::kMisc,
@@ -445,7 +671,26 @@ const Cache::CacheItemHelper* CompressedSecondaryCache::GetHelper(
             tmp_chunk->Free();
           }
         }};
-    return &kHelper;
+    static const Cache::CacheItemHelper kDictHelper{
+        CacheEntryRole::kMisc,
+        [](Cache::ObjectPtr obj, MemoryAllocator* alloc) {
+          // The tag and the dictionary pointer, which can span chunks
+          char prefix[kTagSize + sizeof(CompressionDictionary*)];
+          size_t prefix_size = 0;
+          for (auto* chunk = static_cast<CacheValueChunk*>(obj);
+               chunk != nullptr && prefix_size < sizeof(prefix);
+               chunk = chunk->next) {
+            const size_t n =
+                std::min(chunk->size, sizeof(prefix) - prefix_size);
+            std::memcpy(prefix + prefix_size, chunk->data, n);
+            prefix_size += n;
+          }
+          CompressionDictionary* const dict =
+              GetEntryDict(Slice(prefix, prefix_size));
+          kHelper.del_cb(obj, alloc);
+          dict->Unref();
+        }};
+    return with_dict ? &kDictHelper : &kHelper;
   } else {
     static const Cache::CacheItemHelper kHelper{
         CacheEntryRole::kMisc,
@@ -454,7 +699,15 @@ const Cache::CacheItemHelper* CompressedSecondaryCache::GetHelper(
             CacheAllocationDeleter{alloc}(static_cast<char*>(obj));
           }
         }};
-    return &kHelper;
+    static const Cache::CacheItemHelper kDictHelper{
+        CacheEntryRole::kMisc,
+        [](Cache::ObjectPtr obj, MemoryAllocator* alloc) {
+          CompressionDictionary* const dict =
+              GetEntryDict(GetLengthPrefixedSlice(static_cast<char*>(obj)));
+          kHelper.del_cb(obj, alloc);
+          dict->Unref();
+        }};
+    return with_dict ? &kDictHelper : &kHelper;
   }
 }
 
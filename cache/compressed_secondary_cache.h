@@ -6,6 +6,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <memory>
 
@@ -105,6 +106,12 @@ class CompressedSecondaryCache : public SecondaryCache {
 
   size_t TEST_GetUsage() { return cache_->GetUsage(); }
 
+  // Number of dictionaries currently alive, over all shards: the newest one
+  // of each shard, and the older ones still used by some entry.
+  size_t TEST_GetNumDicts() const {
+    return num_dicts_.load(std::memory_order_relaxed);
+  }
+
  private:
   friend class CompressedSecondaryCacheTestBase;
   static constexpr std::array<uint16_t, 8> malloc_bin_sizes_{
@@ -135,8 +142,55 @@ class CompressedSecondaryCache : public SecondaryCache {
 
   size_t TEST_GetCharge(const Slice& key);
 
+  // A compression dictionary trained for one shard, with the matching
+  // compressor and decompressor. The decompressor references the dictionary
+  // owned by the compressor. Referenced by its shard while it is the newest
+  // one there, and by every entry compressed with it, so that it stays
+  // readable for as long as they are cached.
+  struct CompressionDictionary {
+    CompressedSecondaryCache* owner = nullptr;
+    size_t charge = 0;
+    std::atomic<uint32_t> refs{1};
+    std::unique_ptr<Compressor> compressor;
+    std::unique_ptr<Decompressor> decompressor;
+
+    void Ref() { refs.fetch_add(1, std::memory_order_relaxed); }
+    // Deletes the dictionary when dropping the last reference.
+    void Unref();
+  };
+
+  struct DictShard {
+    port::Mutex mutex;
+    // The newest dictionary, used for new entries, or nullptr
+    CompressionDictionary* dict = nullptr;
+    Compressor::DictSampleArgs samples;
+    uint32_t inserts_since_training = 0;
+    bool training = false;
+  };
+
+  DictShard& GetDictShard(const Slice& key);
+
+  // Samples `data`, which is about to be compressed into `shard`, and returns
+  // the newest dictionary of the shard with a reference for the caller, if
+  // any. Trains a new dictionary when it is time to.
+  CompressionDictionary* SampleAndGetDict(DictShard& shard, const Slice& data);
+
+  void TrainDict(DictShard& shard, Compressor::DictSampleArgs&& samples);
+
+  // Called when the last reference to `dict` is dropped.
+  void OnDictReleased(CompressionDictionary* dict);
+
+  // Returns the charge of the released dictionaries to the cache. Not done by
+  // OnDictReleased() itself, which can run within a cache reservation.
+  void ReturnReleasedDictCharge();
+
+  // The dictionary referenced by an entry stored with GetHelper(_, true)
+  static CompressionDictionary* GetEntryDict(const Slice& tagged_data);
+
   // TODO: clean up to use cleaner interfaces in typed_cache.h
-  const Cache::CacheItemHelper* GetHelper(bool enable_custom_split_merge) const;
+  // With `with_dict`, the helper of entries referencing a dictionary.
+  const Cache::CacheItemHelper* GetHelper(bool enable_custom_split_merge,
+                                          bool with_dict = false) const;
   std::shared_ptr<Cache> cache_;
   CompressedSecondaryCacheOptions cache_options_;
   std::unique_ptr<Compressor> compressor_;
@@ -144,6 +198,12 @@ class CompressedSecondaryCache : public SecondaryCache {
   mutable port::Mutex capacity_mutex_;
   std::shared_ptr<ConcurrentCacheReservationManager> cache_res_mgr_;
   RelaxedAtomic<bool> disable_cache_;
+  // Only allocated when dictionary compression is used.
+  std::unique_ptr<DictShard[]> dict_shards_;
+  uint32_t dict_shard_mask_ = 0;
+  size_t max_dict_sample_bytes_ = 0;
+  std::atomic<size_t> num_dicts_{0};
+  std::atomic<size_t> released_dict_charge_{0};
 };
 
 }  // namespace ROCKSDB_NAMESPACE
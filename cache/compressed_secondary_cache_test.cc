@@ -6,6 +6,7 @@
 #include "cache/compressed_secondary_cache.h"
 
 #include <array>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <tuple>
@@ -15,9 +16,11 @@
 #include "rocksdb/cache.h"
 #include "rocksdb/convenience.h"
 #include "test_util/secondary_cache_test_util.h"
+#include "test_util/sync_point.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/cast_util.h"
+#include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -1049,6 +1052,266 @@ TEST_P(CompressedSecondaryCacheTest, SplictValueAndMergeChunksTest) {
   SplictValueAndMergeChunksTest();
 }
 
+TEST_P(CompressedSecondaryCacheTest, DictionaryCompression) {
+  if (!LZ4_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+    return;
+  }
+  // Values that are not compressible on their own, but share most of their
+  // bytes with each other.
+  Random rnd(301);
+  const std::string shared = rnd.RandomString(512);
+  constexpr int kNumValues = 200;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumValues; ++i) {
+    values.push_back(shared + rnd.RandomString(64));
+  }
+  auto key = [](int i) {
+    // 16 bytes for HCC compatibility
+    char buf[17];
+    snprintf(buf, sizeof(buf), "____    ____%04d", i);
+    return std::string(buf);
+  };
+
+  size_t compressed_bytes[2];
+  for (bool use_dict : {false, true}) {
+    CompressedSecondaryCacheOptions opts;
+    opts.capacity = 1 << 20;
+    opts.num_shard_bits = 0;
+    opts.compression_type = CompressionType::kLZ4Compression;
+    opts.max_dict_bytes = use_dict ? 4096 : 0;
+    opts.dict_retrain_interval = 16;
+    std::shared_ptr<SecondaryCache> sec_cache =
+        NewCompressedSecondaryCache(opts);
+    auto* comp_sec_cache =
+        static_cast<CompressedSecondaryCache*>(sec_cache.get());
+
+    get_perf_context()->Reset();
+    for (int i = 0; i < kNumValues; ++i) {
+      TestItem item(values[i].data(), values[i].size());
+      ASSERT_OK(sec_cache->Insert(key(i), &item, GetHelper(),
+                                  /*force_insert=*/true));
+    }
+    compressed_bytes[use_dict] =
+        get_perf_context()->compressed_sec_cache_compressed_bytes;
+    // The older dictionaries are kept for the entries compressed with them.
+    if (use_dict) {
+      ASSERT_GT(comp_sec_cache->TEST_GetNumDicts(), 4);
+    } else {
+      ASSERT_EQ(comp_sec_cache->TEST_GetNumDicts(), 0);
+    }
+
+    for (int i = 0; i < kNumValues; ++i) {
+      bool kept_in_sec_cache = false;
+      std::unique_ptr<SecondaryCacheResultHandle> handle =
+          sec_cache->Lookup(key(i), GetHelper(), this, true,
+                            /*advise_erase=*/false, /*stats=*/nullptr,
+                            kept_in_sec_cache);
+      ASSERT_NE(handle, nullptr);
+      std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+      ASSERT_EQ(values[i], std::string(val->Buf(), val->Size()));
+    }
+  }
+  // Most values are compressed with a dictionary that covers their shared
+  // bytes.
+  ASSERT_LT(compressed_bytes[true], compressed_bytes[false] / 2);
+}
+
+namespace {
+// "Compresses" data starting with a fixed prefix by dropping it, once the
+// prefix is trained as the dictionary, so that the dictionary handling can be
+// tested without a compression library.
+class PrefixDictDecompressor : public Decompressor {
+ public:
+  const char* Name() const override { return "PrefixDictDecompressor"; }
+
+  const Slice& GetSerializedDict() const override { return dict_; }
+
+  Status MaybeCloneForDict(const Slice& serialized_dict,
+                           std::unique_ptr<Decompressor>* out) override {
+    auto decompressor = std::make_unique<PrefixDictDecompressor>();
+    decompressor->dict_ = serialized_dict;
+    *out = std::move(decompressor);
+    return Status::OK();
+  }
+
+  Status DecompressBlock(const Args& args, char* uncompressed_output) override {
+    if (dict_.empty() ||
+        args.uncompressed_size != dict_.size() + args.compressed_data.size()) {
+      return Status::Corruption("Not compressed with a dictionary");
+    }
+    std::memcpy(uncompressed_output, dict_.data(), dict_.size());
+    std::memcpy(uncompressed_output + dict_.size(),
+                args.compressed_data.data(), args.compressed_data.size());
+    return Status::OK();
+  }
+
+ private:
+  Slice dict_;
+};
+
+class PrefixDictCompressor : public Compressor {
+ public:
+  explicit PrefixDictCompressor(const std::string& prefix, bool trained)
+      : prefix_(prefix), trained_(trained) {}
+
+  const char* Name() const override { return "PrefixDictCompressor"; }
+
+  size_t GetMaxSampleSizeIfWantDict(CacheEntryRole /*role*/) const override {
+    return trained_ ? 0 : 4096;
+  }
+
+  Slice GetSerializedDict() const override {
+    return trained_ ? Slice(prefix_) : Slice();
+  }
+
+  std::unique_ptr<Compressor> MaybeCloneSpecialized(
+      CacheEntryRole /*role*/, DictSampleArgs&& /*samples*/) override {
+    return std::make_unique<PrefixDictCompressor>(prefix_, /*trained=*/true);
+  }
+
+  Status CompressBlock(Slice uncompressed_data, char* compressed_output,
+                       size_t* compressed_output_size,
+                       CompressionType* out_compression_type,
+                       ManagedWorkingArea* /*working_area*/) override {
+    *out_compression_type = kNoCompression;
+    if (!trained_ || !uncompressed_data.starts_with(prefix_)) {
+      return Status::OK();
+    }
+    uncompressed_data.remove_prefix(prefix_.size());
+    char* ptr = EncodeVarint64(compressed_output,
+                               prefix_.size() + uncompressed_data.size());
+    const size_t size =
+        static_cast<size_t>(ptr - compressed_output) + uncompressed_data.size();
+    if (size > *compressed_output_size) {
+      return Status::OK();
+    }
+    std::memcpy(ptr, uncompressed_data.data(), uncompressed_data.size());
+    *compressed_output_size = size;
+    *out_compression_type = kLZ4Compression;
+    return Status::OK();
+  }
+
+ private:
+  std::string prefix_;
+  bool trained_;
+};
+
+class PrefixDictCompressionManager : public CompressionManager {
+ public:
+  explicit PrefixDictCompressionManager(const std::string& prefix)
+      : prefix_(prefix) {}
+
+  const char* Name() const override { return "PrefixDictCompressionManager"; }
+  const char* CompatibilityName() const override { return "PrefixDict"; }
+
+  bool SupportsCompressionType(CompressionType type) const override {
+    return type == kLZ4Compression;
+  }
+
+  std::unique_ptr<Compressor> GetCompressor(const CompressionOptions& /*opts*/,
+                                            CompressionType type) override {
+    if (type != kLZ4Compression) {
+      return nullptr;
+    }
+    return std::make_unique<PrefixDictCompressor>(prefix_, /*trained=*/false);
+  }
+
+  std::shared_ptr<Decompressor> GetDecompressor() override {
+    return std::make_shared<PrefixDictDecompressor>();
+  }
+
+ private:
+  std::string prefix_;
+};
+}  // namespace
+
+TEST_P(CompressedSecondaryCacheTest, DictionaryLifetime) {
+  Random rnd(301);
+  const std::string shared = rnd.RandomString(512);
+  constexpr int kNumValues = 200;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumValues; ++i) {
+    values.push_back(shared + rnd.RandomString(64));
+  }
+  auto key = [](int i) {
+    // 16 bytes for HCC compatibility
+    char buf[17];
+    snprintf(buf, sizeof(buf), "____    ____%04d", i);
+    return std::string(buf);
+  };
+
+  // Mock the dictionary compression, so that this does not depend on a
+  // compression library.
+  std::shared_ptr<CompressionManager> mgr =
+      std::make_shared<PrefixDictCompressionManager>(shared);
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompressedSecondaryCache::CompressedSecondaryCache:CompressionManager",
+      [&](void* arg) {
+        *static_cast<std::shared_ptr<CompressionManager>*>(arg) = mgr;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (bool enable_split_merge : {false, true}) {
+    CompressedSecondaryCacheOptions opts;
+    opts.capacity = 1 << 20;
+    opts.num_shard_bits = 0;
+    opts.compression_type = CompressionType::kLZ4Compression;
+    opts.max_dict_bytes = 4096;
+    opts.dict_retrain_interval = 16;
+    opts.enable_custom_split_merge = enable_split_merge;
+    std::shared_ptr<SecondaryCache> sec_cache =
+        NewCompressedSecondaryCache(opts);
+    auto* comp_sec_cache =
+        static_cast<CompressedSecondaryCache*>(sec_cache.get());
+
+    get_perf_context()->Reset();
+    for (int i = 0; i < kNumValues; ++i) {
+      TestItem item(values[i].data(), values[i].size());
+      ASSERT_OK(sec_cache->Insert(key(i), &item, GetHelper(),
+                                  /*force_insert=*/true));
+    }
+    // Only the entries inserted before the first dictionary are not
+    // compressed.
+    ASSERT_LT(get_perf_context()->compressed_sec_cache_compressed_bytes,
+              get_perf_context()->compressed_sec_cache_uncompressed_bytes / 4);
+    // Retraining does not retire the dictionaries still used by some entry.
+    ASSERT_EQ(comp_sec_cache->TEST_GetNumDicts(),
+              static_cast<size_t>(kNumValues / 16));
+
+    for (int i = 0; i < kNumValues; ++i) {
+      bool kept_in_sec_cache = false;
+      std::unique_ptr<SecondaryCacheResultHandle> handle =
+          sec_cache->Lookup(key(i), GetHelper(), this, true,
+                            /*advise_erase=*/false, /*stats=*/nullptr,
+                            kept_in_sec_cache);
+      ASSERT_NE(handle, nullptr);
+      std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+      ASSERT_EQ(values[i], std::string(val->Buf(), val->Size()));
+    }
+
+    // The older dictionaries go away with their last entry. The newest one
+    // stays for new entries.
+    for (int i = 0; i < kNumValues; ++i) {
+      sec_cache->Erase(key(i));
+    }
+    ASSERT_EQ(comp_sec_cache->TEST_GetNumDicts(), 1);
+
+    // Same when evicted
+    for (int i = 0; i < kNumValues; ++i) {
+      TestItem item(values[i].data(), values[i].size());
+      ASSERT_OK(sec_cache->Insert(key(i), &item, GetHelper(),
+                                  /*force_insert=*/true));
+    }
+    ASSERT_GT(comp_sec_cache->TEST_GetNumDicts(), 1);
+    ASSERT_OK(sec_cache->SetCapacity(0));
+    ASSERT_EQ(comp_sec_cache->TEST_GetNumDicts(), 1);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 using secondary_cache_test_util::WithCacheType;
 
 class CompressedSecCacheTestWithTiered
@@ -0,0 +1,145 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/frequency_sketch.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "util/math.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+size_t NumWords(size_t max_memory_bytes, size_t words_per_block) {
+  size_t num_blocks =
+      std::max(size_t{1}, max_memory_bytes / sizeof(uint64_t) /
+                              words_per_block);
+  // Round down to a power of two
+  return (size_t{1} << FloorLog2(num_blocks)) * words_per_block;
+}
+
+// Two rounds of multiply-xorshift, so that both small (e.g. 32-bit) and
+// already well mixed hashes spread over the whole table.
+inline uint64_t Spread(uint64_t h) {
+  h *= uint64_t{0x9e3779b97f4a7c15};
+  return h ^ (h >> 29);
+}
+
+inline uint64_t Rehash(uint64_t h) {
+  h *= uint64_t{0xbf58476d1ce4e5b9};
+  return h ^ (h >> 31);
+}
+}  // namespace
+
+FrequencySketch::Table::Table(size_t _num_words)
+    : words(new RelaxedAtomic<uint64_t>[_num_words]),
+      num_words(_num_words),
+      block_mask(_num_words / kWordsPerBlock - 1),
+      // About 10x the number of entries for 8KB blocks and a sketch using 1%
+      // of the cache capacity, as suggested for TinyLFU
+      sample_size(static_cast<uint32_t>(std::min(
+          _num_words, size_t{std::numeric_limits<uint32_t>::max()}))) {}
+
+FrequencySketch::FrequencySketch(size_t max_memory_bytes) {
+  Resize(max_memory_bytes);
+}
+
+void FrequencySketch::Resize(size_t max_memory_bytes) {
+  size_t num_words = NumWords(max_memory_bytes, kWordsPerBlock);
+  MutexLock l(&resize_mutex_);
+  Table* current = current_.LoadRelaxed();
+  if (current != nullptr && current->num_words == num_words) {
+    return;
+  }
+  std::unique_ptr<Table>& table = tables_[FloorLog2(num_words)];
+  if (table == nullptr) {
+    table.reset(new Table(num_words));
+  } else {
+    // Reused; may still get stray updates from before it was replaced
+    for (size_t i = 0; i < num_words; ++i) {
+      table->words[i].StoreRelaxed(0);
+    }
+    table->additions.StoreRelaxed(0);
+  }
+  current_.Store(table.get());
+}
+
+void FrequencySketch::CounterFor(size_t block, uint64_t counter_hash,
+                                 int depth, size_t* word, int* shift) {
+  // Each depth uses one of two words of its own, and one of the 16 counters
+  // in that word, based on a different byte of the counter hash.
+  uint32_t h = static_cast<uint32_t>(counter_hash >> (depth * 8));
+  *word = block + static_cast<size_t>(depth) * 2 + (h & 1);
+  *shift = static_cast<int>((h >> 1) & 15) * 4;
+}
+
+void FrequencySketch::Increment(uint64_t hash) {
+  Table* table = current_.Load();
+  uint64_t block_hash = Spread(hash);
+  uint64_t counter_hash = Rehash(block_hash);
+  size_t block =
+      static_cast<size_t>(block_hash & table->block_mask) * kWordsPerBlock;
+  bool added = false;
+  for (int depth = 0; depth < kDepth; ++depth) {
+    size_t word;
+    int shift;
+    CounterFor(block, counter_hash, depth, &word, &shift);
+    RelaxedAtomic<uint64_t>& w = table->words[word];
+    uint64_t old_val = w.LoadRelaxed();
+    while (((old_val >> shift) & kMaxCount) < kMaxCount) {
+      if (w.CasWeakRelaxed(old_val, old_val + (uint64_t{1} << shift))) {
+        added = true;
+        break;
+      }
+    }
+  }
+  // Exactly one thread observes reaching the sample size
+  if (added &&
+      table->additions.FetchAddRelaxed(1) + 1 == table->sample_size) {
+    Halve(table);
+  }
+}
+
+uint32_t FrequencySketch::Estimate(uint64_t hash) const {
+  const Table* table = current_.Load();
+  uint64_t block_hash = Spread(hash);
+  uint64_t counter_hash = Rehash(block_hash);
+  size_t block =
+      static_cast<size_t>(block_hash & table->block_mask) * kWordsPerBlock;
+  uint32_t result = kMaxCount;
+  for (int depth = 0; depth < kDepth; ++depth) {
+    size_t word;
+    int shift;
+    CounterFor(block, counter_hash, depth, &word, &shift);
+    uint32_t count =
+        static_cast<uint32_t>((table->words[word].LoadRelaxed() >> shift) &
+                              kMaxCount);
+    result = std::min(result, count);
+  }
+  return result;
+}
+
+void FrequencySketch::Halve(Table* table) {
+  for (size_t i = 0; i < table->num_words; ++i) {
+    uint64_t v = table->words[i].LoadRelaxed();
+    table->words[i].StoreRelaxed((v >> 1) & uint64_t{0x7777777777777777});
+  }
+  table->additions.StoreRelaxed(table->sample_size / 2);
+}
+
+size_t FrequencySketch::ApproximateMemoryUsage() const {
+  size_t usage = sizeof(*this);
+  MutexLock l(&resize_mutex_);
+  for (const auto& table : tables_) {
+    if (table != nullptr) {
+      usage += sizeof(Table) + table->num_words * sizeof(uint64_t);
+    }
+  }
+  return usage;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
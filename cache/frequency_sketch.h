@@ -0,0 +1,87 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "port/port.h"
+#include "rocksdb/rocksdb_namespace.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A count-min sketch of 4-bit saturating counters estimating how often each
+// key (by hash) has been accessed recently, as used by TinyLFU cache
+// admission (https://arxiv.org/abs/1512.00727). The four counters of a key
+// live in one 64-byte block so that an update touches a single cache line.
+// After a number of additions proportional to the sketch size, all counters
+// are halved, so that estimates follow recent rather than all-time
+// popularity.
+//
+// Thread safe and lock free, except for Resize(). Concurrent increments can
+// occasionally be lost, including around the periodic halving, which only
+// makes estimates a bit lower.
+class FrequencySketch {
+ public:
+  // Uses at most `max_memory_bytes` for counters (at least one block).
+  explicit FrequencySketch(size_t max_memory_bytes);
+
+  // No copying or moving
+  FrequencySketch(const FrequencySketch&) = delete;
+  FrequencySketch& operator=(const FrequencySketch&) = delete;
+
+  // Records an access to the key with the given hash.
+  void Increment(uint64_t hash);
+
+  // Returns the estimated number of recent accesses to the key with the
+  // given hash, in [0, kMaxCount]. Can overestimate (on hash collisions) but
+  // does not underestimate, except for lost concurrent updates.
+  uint32_t Estimate(uint64_t hash) const;
+
+  // Switches to counters using at most `max_memory_bytes`, e.g. after the
+  // cache capacity changed, if that changes the number of counters. The new
+  // counters start from zero. Safe to call concurrently with Increment() and
+  // Estimate(), which can keep using the old counters for a while, so
+  // counter tables are kept (and reused) until destruction. As table sizes
+  // are powers of two, they take less than twice the largest size.
+  void Resize(size_t max_memory_bytes);
+
+  size_t ApproximateMemoryUsage() const;
+
+  static constexpr uint32_t kMaxCount = 15;
+
+ private:
+  static constexpr size_t kWordsPerBlock = 8;
+  static constexpr int kDepth = 4;
+
+  struct Table {
+    explicit Table(size_t num_words);
+
+    std::unique_ptr<RelaxedAtomic<uint64_t>[]> words;
+    const size_t num_words;
+    const uint64_t block_mask;
+    // Number of counter increments between halving all counters
+    const uint32_t sample_size;
+    RelaxedAtomic<uint32_t> additions{0};
+  };
+
+  // Locates the counter for `depth` (row of the count-min sketch) of the key
+  // whose block starts at word `block`.
+  static void CounterFor(size_t block, uint64_t counter_hash, int depth,
+                         size_t* word, int* shift);
+
+  static void Halve(Table* table);
+
+  AcqRelAtomic<Table*> current_;
+  mutable port::Mutex resize_mutex_;
+  // All tables allocated, by FloorLog2 of the number of words
+  std::array<std::unique_ptr<Table>, 64> tables_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,486 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/local_file_secondary_cache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+#include "rocksdb/env.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/hash.h"
+#include "util/math.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Segments are sized and aligned for direct I/O on common devices
+constexpr size_t kSegmentAlignment = 4096;
+// Bounds on the number of recently refused keys remembered for admission
+constexpr uint64_t kMinGhosts = uint64_t{1} << 10;
+constexpr uint64_t kMaxGhosts = uint64_t{1} << 22;
+}  // namespace
+
+void LocalFileSecondaryCacheResultHandle::Wait() {
+  if (!ready_) {
+    cache_->WaitAll({this});
+  }
+}
+
+LocalFileSecondaryCache::LocalFileSecondaryCache(
+    const LocalFileSecondaryCacheOptions& opts)
+    : opts_(opts), log_cv_(&log_mutex_) {}
+
+LocalFileSecondaryCache::~LocalFileSecondaryCache() {
+  if (writer_thread_.joinable()) {
+    {
+      MutexLock l(&log_mutex_);
+      shutdown_ = true;
+      log_cv_.SignalAll();
+    }
+    writer_thread_.join();
+  }
+  if (writer_) {
+    writer_->Close(IOOptions(), nullptr).PermitUncheckedError();
+  }
+}
+
+Status LocalFileSecondaryCache::Open() {
+  if (opts_.path.empty()) {
+    return Status::InvalidArgument("A path is required");
+  }
+  if (opts_.max_write_buffer_number < 1) {
+    return Status::InvalidArgument(
+        "max_write_buffer_number must be at least 1");
+  }
+  segment_size_ = Roundup(std::max(opts_.write_buffer_size, size_t{1}),
+                          kSegmentAlignment);
+  num_segments_ = opts_.capacity / segment_size_;
+  if (num_segments_ < 2) {
+    return Status::InvalidArgument(
+        "capacity must allow for at least two write buffers");
+  }
+  file_size_ = num_segments_ * segment_size_;
+
+  Env* env = opts_.env ? opts_.env : Env::Default();
+  fs_ = env->GetFileSystem();
+  FileOptions file_opts;
+  file_opts.use_direct_reads = opts_.use_direct_io;
+  file_opts.use_direct_writes = opts_.use_direct_io;
+  IOStatus io_s =
+      fs_->NewWritableFile(opts_.path, file_opts, &writer_, nullptr /*dbg*/);
+  if (io_s.ok()) {
+    io_s = fs_->NewRandomAccessFile(opts_.path, file_opts, &reader_,
+                                    nullptr /*dbg*/);
+  }
+  if (!io_s.ok()) {
+    return io_s;
+  }
+  if (opts_.use_direct_io) {
+    alignment_ = std::max(writer_->GetRequiredBufferAlignment(),
+                          reader_->GetRequiredBufferAlignment());
+    if (segment_size_ % alignment_ != 0) {
+      return Status::InvalidArgument(
+          "write_buffer_size is not a multiple of the direct I/O alignment");
+    }
+  }
+
+  for (int i = 0; i < opts_.max_write_buffer_number; ++i) {
+    buffers_.emplace_back(new WriteBuffer());
+    WriteBuffer* wb = buffers_.back().get();
+    wb->buf.Alignment(std::max(alignment_, kSegmentAlignment));
+    wb->buf.AllocateNewBuffer(segment_size_);
+    wb->segment = kNoSegment;
+    free_buffers_.push_back(wb);
+  }
+  segment_keys_.resize(num_segments_);
+
+  // About one ghost per 4KB block the file can hold
+  const uint64_t num_ghosts =
+      std::min(std::max(file_size_ / kSegmentAlignment, kMinGhosts),
+               kMaxGhosts);
+  ghosts_mask_ = (uint64_t{1} << FloorLog2(num_ghosts)) - 1;
+  ghosts_.reset(new std::atomic<uint64_t>[ghosts_mask_ + 1]);
+  for (uint64_t i = 0; i <= ghosts_mask_; ++i) {
+    ghosts_[i].store(0, std::memory_order_relaxed);
+  }
+
+  writer_thread_ =
+      port::Thread(&LocalFileSecondaryCache::BackgroundWrite, this);
+  return Status::OK();
+}
+
+LocalFileSecondaryCache::IndexShard& LocalFileSecondaryCache::GetShard(
+    const Slice& key) {
+  return index_[GetSliceNPHash64(key) % kNumIndexShards];
+}
+
+bool LocalFileSecondaryCache::Admit(const Slice& key, bool force_insert) {
+  {
+    IndexShard& shard = GetShard(key);
+    MutexLock l(&shard.mutex);
+    auto it = shard.map.find(key.ToString());
+    if (it != shard.map.end() &&
+        it->second.offset >= valid_offset_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+  }
+  if (force_insert) {
+    return true;
+  }
+  // Never 0, which marks an empty slot
+  const uint64_t hash = GetSliceNPHash64(key, /*seed=*/1) | 1;
+  std::atomic<uint64_t>& ghost = ghosts_[(hash >> 1) & ghosts_mask_];
+  if (ghost.load(std::memory_order_relaxed) == hash) {
+    ghost.store(0, std::memory_order_relaxed);
+    return true;
+  }
+  ghost.store(hash, std::memory_order_relaxed);
+  return false;
+}
+
+Status LocalFileSecondaryCache::Insert(const Slice& key,
+                                       Cache::ObjectPtr value,
+                                       const Cache::CacheItemHelper* helper,
+                                       bool force_insert) {
+  if (value == nullptr) {
+    return Status::InvalidArgument();
+  }
+  if (!helper->IsSecondaryCacheCompatible() || !Admit(key, force_insert)) {
+    return Status::OK();
+  }
+  const size_t size = (*helper->size_cb)(value);
+  return InsertRecord(key, size, kNoCompression, CacheTier::kVolatileTier,
+                      [&](char* data) {
+                        return (*helper->saveto_cb)(value, 0, size, data);
+                      });
+}
+
+Status LocalFileSecondaryCache::InsertSaved(const Slice& key,
+                                            const Slice& saved,
+                                            CompressionType type,
+                                            CacheTier source) {
+  if (!Admit(key, /*force_insert=*/true)) {
+    return Status::OK();
+  }
+  return InsertRecord(key, saved.size(), type, source, [&](char* data) {
+    memcpy(data, saved.data(), saved.size());
+    return Status::OK();
+  });
+}
+
+Status LocalFileSecondaryCache::InsertRecord(const Slice& key,
+                                             size_t data_size,
+                                             CompressionType type,
+                                             CacheTier source,
+                                             const FillFn& fill) {
+  const size_t record_size = kHeaderSize + data_size;
+  if (record_size > segment_size_) {
+    // Too large to cache
+    return Status::OK();
+  }
+  WriteBuffer* wb = nullptr;
+  uint64_t offset = 0;
+  char* record = nullptr;
+  {
+    MutexLock l(&log_mutex_);
+    record = Reserve(key, record_size, &wb, &offset);
+  }
+  if (record == nullptr) {
+    // The writer is behind; drop the insertion rather than wait
+    return Status::OK();
+  }
+
+  // Fill the reserved space without holding the lock
+  Status s = fill(record + kHeaderSize);
+  if (s.ok()) {
+    record[4] = static_cast<char>(type);
+    record[5] = static_cast<char>(source);
+    uint32_t crc = crc32c::Value(key.data(), key.size());
+    crc = crc32c::Extend(crc, record + 4, record_size - 4);
+    EncodeFixed32(record, crc32c::Mask(crc));
+
+    IndexShard& shard = GetShard(key);
+    MutexLock l(&shard.mutex);
+    shard.map[key.ToString()] =
+        Location{offset, static_cast<uint32_t>(record_size)};
+  }
+
+  MutexLock l(&log_mutex_);
+  if (--wb->pending_copies == 0) {
+    log_cv_.SignalAll();
+  }
+  return s;
+}
+
+char* LocalFileSecondaryCache::Reserve(const Slice& key, size_t record_size,
+                                       WriteBuffer** wb, uint64_t* offset) {
+  log_mutex_.AssertHeld();
+  if (active_ == nullptr || active_->used + record_size > segment_size_) {
+    if (active_ != nullptr) {
+      write_queue_.push_back(active_);
+      active_ = nullptr;
+      log_cv_.SignalAll();
+    }
+    if (!StartSegment()) {
+      return nullptr;
+    }
+  }
+  *wb = active_;
+  *offset = active_->segment + active_->used;
+  char* record = active_->buf.BufferStart() + active_->used;
+  active_->used += record_size;
+  ++active_->pending_copies;
+  segment_keys_[(active_->segment / segment_size_) % num_segments_]
+      .push_back(key.ToString());
+  return record;
+}
+
+bool LocalFileSecondaryCache::StartSegment() {
+  log_mutex_.AssertHeld();
+  assert(active_ == nullptr);
+  if (free_buffers_.empty()) {
+    return false;
+  }
+  active_ = free_buffers_.back();
+  free_buffers_.pop_back();
+  active_->segment = next_segment_;
+  active_->used = 0;
+  next_segment_ += segment_size_;
+  if (next_segment_ > file_size_) {
+    // Writing this segment overwrites the oldest one in the file
+    valid_offset_.store(next_segment_ - file_size_, std::memory_order_relaxed);
+    DropSegment(active_->segment - file_size_);
+  }
+  return true;
+}
+
+void LocalFileSecondaryCache::DropSegment(uint64_t segment) {
+  log_mutex_.AssertHeld();
+  std::vector<std::string>& keys =
+      segment_keys_[(segment / segment_size_) % num_segments_];
+  for (const std::string& key : keys) {
+    IndexShard& shard = GetShard(key);
+    MutexLock l(&shard.mutex);
+    auto it = shard.map.find(key);
+    // Unless the key was inserted again since
+    if (it != shard.map.end() && it->second.offset >= segment &&
+        it->second.offset < segment + segment_size_) {
+      shard.map.erase(it);
+    }
+  }
+  keys.clear();
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> LocalFileSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool advise_erase,
+    Statistics* /*stats*/, bool& kept_in_sec_cache) {
+  assert(helper);
+  kept_in_sec_cache = false;
+  Location loc;
+  {
+    IndexShard& shard = GetShard(key);
+    MutexLock l(&shard.mutex);
+    auto it = shard.map.find(key.ToString());
+    if (it == shard.map.end()) {
+      return nullptr;
+    }
+    loc = it->second;
+    if (loc.offset < valid_offset_.load(std::memory_order_relaxed)) {
+      shard.map.erase(it);
+      return nullptr;
+    }
+    if (advise_erase) {
+      shard.map.erase(it);
+    } else {
+      kept_in_sec_cache = true;
+    }
+  }
+
+  auto handle = std::make_unique<LocalFileSecondaryCacheResultHandle>(
+      this, key, loc.offset, loc.size, helper, create_context);
+  if (!ReadFromWriteBuffer(handle.get()) && wait) {
+    handle->Wait();
+  }
+  return handle;
+}
+
+bool LocalFileSecondaryCache::ReadFromWriteBuffer(
+    LocalFileSecondaryCacheResultHandle* handle) {
+  const uint64_t segment = handle->offset_ - handle->offset_ % segment_size_;
+  {
+    MutexLock l(&log_mutex_);
+    WriteBuffer* wb = nullptr;
+    for (const auto& b : buffers_) {
+      if (b->segment == segment) {
+        wb = b.get();
+        break;
+      }
+    }
+    if (wb == nullptr) {
+      return false;
+    }
+    handle->buf_.Alignment(1);
+    handle->buf_.AllocateNewBuffer(handle->size_);
+    memcpy(handle->buf_.BufferStart(),
+           wb->buf.BufferStart() + (handle->offset_ - segment), handle->size_);
+  }
+  Complete(handle, Slice(handle->buf_.BufferStart(), handle->size_));
+  return true;
+}
+
+void LocalFileSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  std::vector<LocalFileSecondaryCacheResultHandle*> pending;
+  std::vector<FSReadRequest> reqs;
+  for (SecondaryCacheResultHandle* h : handles) {
+    auto handle = static_cast<LocalFileSecondaryCacheResultHandle*>(h);
+    if (handle->IsReady() || ReadFromWriteBuffer(handle)) {
+      continue;
+    }
+    const uint64_t offset = PhysicalOffset(handle->offset_);
+    FSReadRequest req;
+    req.offset = offset - offset % alignment_;
+    req.len = Roundup(static_cast<size_t>(offset - req.offset) + handle->size_,
+                      alignment_);
+    handle->buf_.Alignment(alignment_);
+    handle->buf_.AllocateNewBuffer(req.len);
+    req.scratch = handle->buf_.BufferStart();
+    reqs.push_back(std::move(req));
+    pending.push_back(handle);
+  }
+  if (reqs.empty()) {
+    return;
+  }
+
+  IOStatus io_s =
+      reader_->MultiRead(reqs.data(), reqs.size(), IOOptions(), nullptr);
+  for (size_t i = 0; i < reqs.size(); ++i) {
+    LocalFileSecondaryCacheResultHandle* handle = pending[i];
+    const size_t skip =
+        static_cast<size_t>(PhysicalOffset(handle->offset_) - reqs[i].offset);
+    Slice record;
+    if (io_s.ok() && reqs[i].status.ok() &&
+        reqs[i].result.size() >= skip + handle->size_) {
+      record = Slice(reqs[i].result.data() + skip, handle->size_);
+    }
+    Complete(handle, record);
+  }
+}
+
+void LocalFileSecondaryCache::Complete(
+    LocalFileSecondaryCacheResultHandle* handle, const Slice& record) {
+  handle->ready_ = true;
+  // An empty or mismatching record means a failed read, or that the segment
+  // was overwritten since the lookup, and is a miss
+  if (record.size() == handle->size_ && record.size() >= kHeaderSize) {
+    uint32_t crc = crc32c::Value(handle->key_.data(), handle->key_.size());
+    crc = crc32c::Extend(crc, record.data() + 4, record.size() - 4);
+    if (crc32c::Unmask(DecodeFixed32(record.data())) == crc) {
+      const auto type = static_cast<CompressionType>(record[4]);
+      const auto source = static_cast<CacheTier>(record[5]);
+      Slice data(record.data() + kHeaderSize, record.size() - kHeaderSize);
+      Status s = handle->helper_->create_cb(
+          data, type, source, handle->create_context_, nullptr /*allocator*/,
+          &handle->value_, &handle->charge_);
+      if (!s.ok()) {
+        handle->value_ = nullptr;
+        handle->charge_ = 0;
+      }
+    }
+  }
+  // Free the record now that the value holds its own copy
+  handle->buf_ = AlignedBuffer();
+}
+
+void LocalFileSecondaryCache::Erase(const Slice& key) {
+  IndexShard& shard = GetShard(key);
+  MutexLock l(&shard.mutex);
+  shard.map.erase(key.ToString());
+}
+
+void LocalFileSecondaryCache::BackgroundWrite() {
+  MutexLock l(&log_mutex_);
+  while (true) {
+    while (!shutdown_ && (write_queue_.empty() ||
+                          write_queue_.front()->pending_copies > 0)) {
+      log_cv_.Wait();
+    }
+    if (shutdown_) {
+      return;
+    }
+    // Sealed, so no longer modified by insertions
+    WriteBuffer* wb = write_queue_.front();
+    const size_t len = Roundup(wb->used, alignment_);
+    log_mutex_.Unlock();
+    memset(wb->buf.BufferStart() + wb->used, 0, len - wb->used);
+    IOStatus io_s = writer_->PositionedAppend(
+        Slice(wb->buf.BufferStart(), len), PhysicalOffset(wb->segment),
+        IOOptions(), nullptr /*dbg*/);
+    log_mutex_.Lock();
+    if (!io_s.ok()) {
+      DropSegment(wb->segment);
+    }
+    write_queue_.pop_front();
+    wb->segment = kNoSegment;
+    wb->used = 0;
+    free_buffers_.push_back(wb);
+    log_cv_.SignalAll();
+  }
+}
+
+void LocalFileSecondaryCache::TEST_Flush() {
+  MutexLock l(&log_mutex_);
+  if (active_ != nullptr) {
+    write_queue_.push_back(active_);
+    active_ = nullptr;
+    log_cv_.SignalAll();
+  }
+  while (!write_queue_.empty()) {
+    log_cv_.Wait();
+  }
+}
+
+Status LocalFileSecondaryCache::GetCapacity(size_t& capacity) {
+  capacity = static_cast<size_t>(file_size_);
+  return Status::OK();
+}
+
+std::string LocalFileSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  const int kBufferSize{200};
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    path : %s\n", opts_.path.c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    capacity : %" PRIu64 "\n", file_size_);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    write_buffer_size : %" PRIu64 "\n",
+           segment_size_);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    max_write_buffer_number : %d\n",
+           opts_.max_write_buffer_number);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    use_direct_io : %d\n",
+           static_cast<int>(opts_.use_direct_io));
+  ret.append(buffer);
+  return ret;
+}
+
+Status NewLocalFileSecondaryCache(const LocalFileSecondaryCacheOptions& opts,
+                                  std::shared_ptr<SecondaryCache>* result) {
+  assert(result);
+  auto cache = std::make_shared<LocalFileSecondaryCache>(opts);
+  Status s = cache->Open();
+  if (s.ok()) {
+    *result = std::move(cache);
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
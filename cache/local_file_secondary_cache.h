@@ -0,0 +1,221 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/secondary_cache.h"
+#include "util/aligned_buffer.h"
+#include "util/hash_containers.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class LocalFileSecondaryCache;
+
+// Result of a LocalFileSecondaryCache::Lookup(). Blocks still in a write
+// buffer are ready right away; others are read from the file by Wait() or
+// LocalFileSecondaryCache::WaitAll().
+class LocalFileSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
+ public:
+  LocalFileSecondaryCacheResultHandle(LocalFileSecondaryCache* cache,
+                                      const Slice& key, uint64_t offset,
+                                      uint32_t size,
+                                      const Cache::CacheItemHelper* helper,
+                                      Cache::CreateContext* create_context)
+      : cache_(cache),
+        key_(key.ToString()),
+        offset_(offset),
+        size_(size),
+        helper_(helper),
+        create_context_(create_context) {}
+  ~LocalFileSecondaryCacheResultHandle() override = default;
+
+  LocalFileSecondaryCacheResultHandle(
+      const LocalFileSecondaryCacheResultHandle&) = delete;
+  LocalFileSecondaryCacheResultHandle& operator=(
+      const LocalFileSecondaryCacheResultHandle&) = delete;
+
+  bool IsReady() override { return ready_; }
+
+  void Wait() override;
+
+  Cache::ObjectPtr Value() override { return value_; }
+
+  size_t Size() override { return charge_; }
+
+ private:
+  friend class LocalFileSecondaryCache;
+
+  LocalFileSecondaryCache* const cache_;
+  const std::string key_;
+  // Logical offset and size of the record in the cache log
+  const uint64_t offset_;
+  const uint32_t size_;
+  const Cache::CacheItemHelper* const helper_;
+  Cache::CreateContext* const create_context_;
+  // Holds the record as read from the file or copied from a write buffer
+  AlignedBuffer buf_;
+  bool ready_ = false;
+  Cache::ObjectPtr value_ = nullptr;
+  size_t charge_ = 0;
+};
+
+// A SecondaryCache keeping blocks in a local file, as a circular log of
+// segments. Each segment is filled in an in-memory write buffer and written
+// to the file whole by a background thread. An in-memory hash index maps
+// each key to the logical offset of its latest record in the log; the
+// physical offset is the logical one modulo the file size, so reusing a
+// segment implicitly evicts everything in it (FIFO). Each record is
+//   fixed32: masked crc32c of the key and the rest of the record
+//   char: CompressionType
+//   char: CacheTier
+//   char[]: saved data
+// so that a read racing with reuse of its segment is detected and treated
+// as a miss.
+class LocalFileSecondaryCache : public SecondaryCache {
+ public:
+  explicit LocalFileSecondaryCache(const LocalFileSecondaryCacheOptions& opts);
+  ~LocalFileSecondaryCache() override;
+
+  // Opens the file and starts the background writer
+  Status Open();
+
+  const char* Name() const override { return "LocalFileSecondaryCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr value,
+                const Cache::CacheItemHelper* helper,
+                bool force_insert) override;
+
+  Status InsertSaved(const Slice& key, const Slice& saved, CompressionType type,
+                     CacheTier source) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      Statistics* stats, bool& kept_in_sec_cache) override;
+
+  bool SupportForceErase() const override { return true; }
+
+  void Erase(const Slice& key) override;
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  // Writes all write buffers to the file, including the one being filled
+  void TEST_Flush();
+
+ private:
+  friend class LocalFileSecondaryCacheResultHandle;
+
+  static constexpr size_t kHeaderSize = 6;
+  static constexpr size_t kNumIndexShards = 16;
+
+  struct Location {
+    uint64_t offset;
+    uint32_t size;
+  };
+
+  struct IndexShard {
+    port::Mutex mutex;
+    UnorderedMap<std::string, Location> map;
+  };
+
+  struct WriteBuffer {
+    AlignedBuffer buf;
+    // Logical offset of the segment being filled, or kNoSegment when free
+    uint64_t segment = 0;
+    size_t used = 0;
+    // Insertions still copying into space reserved in the buffer
+    int pending_copies = 0;
+  };
+
+  static constexpr uint64_t kNoSegment = UINT64_MAX;
+
+  IndexShard& GetShard(const Slice& key);
+
+  // Returns false if the key is not worth writing: either already in the
+  // cache, or (without force_insert) not evicted recently before.
+  bool Admit(const Slice& key, bool force_insert);
+
+  // Reserves `record_size` bytes in the active write buffer, sealing it and
+  // starting a new segment as needed. Returns nullptr if no write buffer is
+  // free. REQUIRES: log_mutex_ held
+  char* Reserve(const Slice& key, size_t record_size, WriteBuffer** wb,
+                uint64_t* offset);
+
+  // Starts filling a free write buffer with the next segment of the log,
+  // dropping what the file holds for that segment from the index.
+  // REQUIRES: log_mutex_ held
+  bool StartSegment();
+
+  // Drops index entries of records in the segment at logical offset
+  // `segment`. REQUIRES: log_mutex_ held
+  void DropSegment(uint64_t segment);
+
+  using FillFn = std::function<Status(char* data)>;
+  Status InsertRecord(const Slice& key, size_t data_size, CompressionType type,
+                      CacheTier source, const FillFn& fill);
+
+  // Copies the record from a write buffer into the handle if it has not been
+  // written to the file yet
+  bool ReadFromWriteBuffer(LocalFileSecondaryCacheResultHandle* handle);
+
+  // Creates the handle's value from its record, which is empty if it could
+  // not be read
+  void Complete(LocalFileSecondaryCacheResultHandle* handle,
+                const Slice& record);
+
+  void BackgroundWrite();
+
+  uint64_t PhysicalOffset(uint64_t offset) const {
+    return offset % file_size_;
+  }
+
+  const LocalFileSecondaryCacheOptions opts_;
+  std::shared_ptr<FileSystem> fs_;
+  std::unique_ptr<FSWritableFile> writer_;
+  std::unique_ptr<FSRandomAccessFile> reader_;
+  size_t alignment_ = 1;
+  uint64_t segment_size_ = 0;
+  uint64_t num_segments_ = 0;
+  uint64_t file_size_ = 0;
+
+  std::array<IndexShard, kNumIndexShards> index_;
+
+  // Hashes of keys recently refused admission, direct-mapped
+  std::unique_ptr<std::atomic<uint64_t>[]> ghosts_;
+  uint64_t ghosts_mask_ = 0;
+
+  port::Mutex log_mutex_;
+  port::CondVar log_cv_;
+  std::vector<std::unique_ptr<WriteBuffer>> buffers_;
+  WriteBuffer* active_ = nullptr;
+  // Filled buffers in log order, waiting to be written to the file
+  std::deque<WriteBuffer*> write_queue_;
+  std::vector<WriteBuffer*> free_buffers_;
+  // Logical offset of the next segment to start
+  uint64_t next_segment_ = 0;
+  // Keys with records in each segment of the file
+  std::vector<std::vector<std::string>> segment_keys_;
+  // Records at logical offsets below this may be overwritten
+  std::atomic<uint64_t> valid_offset_{0};
+  bool shutdown_ = false;
+  port::Thread writer_thread_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
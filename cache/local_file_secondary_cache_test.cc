@@ -0,0 +1,225 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/local_file_secondary_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/cache.h"
+#include "rocksdb/env.h"
+#include "test_util/secondary_cache_test_util.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using secondary_cache_test_util::WithCacheType;
+
+class LocalFileSecondaryCacheTest : public testing::Test,
+                                    public WithCacheType {
+ public:
+  LocalFileSecondaryCacheTest()
+      : path_(test::PerThreadDBPath("local_file_secondary_cache")) {}
+  ~LocalFileSecondaryCacheTest() override {
+    sec_cache_.reset();
+    Env::Default()->DeleteFile(path_).PermitUncheckedError();
+  }
+
+  const std::string& Type() const override {
+    static const std::string kType = kLRU;
+    return kType;
+  }
+
+ protected:
+  void Open(uint64_t capacity, size_t write_buffer_size = 4096,
+            int max_write_buffer_number = 2) {
+    LocalFileSecondaryCacheOptions opts;
+    opts.path = path_;
+    opts.capacity = capacity;
+    opts.write_buffer_size = write_buffer_size;
+    opts.max_write_buffer_number = max_write_buffer_number;
+    ASSERT_OK(NewLocalFileSecondaryCache(opts, &sec_cache_));
+  }
+
+  LocalFileSecondaryCache* sec_cache() {
+    return static_cast<LocalFileSecondaryCache*>(sec_cache_.get());
+  }
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(const std::string& key,
+                                                     bool wait,
+                                                     bool advise_erase) {
+    bool kept_in_sec_cache = false;
+    auto handle = sec_cache_->Lookup(key, GetHelper(), this, wait,
+                                     advise_erase, /*stats=*/nullptr,
+                                     kept_in_sec_cache);
+    if (handle) {
+      EXPECT_EQ(kept_in_sec_cache, !advise_erase);
+    }
+    return handle;
+  }
+
+  static std::string TakeValue(SecondaryCacheResultHandle* handle) {
+    EXPECT_TRUE(handle->IsReady());
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+    if (item == nullptr) {
+      return "(miss)";
+    }
+    EXPECT_EQ(handle->Size(), item->Size());
+    return item->ToString();
+  }
+
+  const std::string path_;
+  std::shared_ptr<SecondaryCache> sec_cache_;
+};
+
+TEST_F(LocalFileSecondaryCacheTest, InvalidOptions) {
+  LocalFileSecondaryCacheOptions opts;
+  opts.capacity = 1 << 20;
+  // No path
+  Status s = NewLocalFileSecondaryCache(opts, &sec_cache_);
+  ASSERT_TRUE(s.IsInvalidArgument());
+  // Room for only one write buffer
+  opts.path = path_;
+  opts.capacity = opts.write_buffer_size;
+  s = NewLocalFileSecondaryCache(opts, &sec_cache_);
+  ASSERT_TRUE(s.IsInvalidArgument());
+  ASSERT_EQ(sec_cache_, nullptr);
+}
+
+TEST_F(LocalFileSecondaryCacheTest, Basic) {
+  Open(/*capacity=*/4 * 4096);
+  size_t capacity = 0;
+  ASSERT_OK(sec_cache_->GetCapacity(capacity));
+  ASSERT_EQ(capacity, 4 * 4096);
+
+  Random rnd(301);
+  std::string str1 = rnd.RandomString(1000);
+  TestItem item1(str1.data(), str1.size());
+
+  ASSERT_EQ(Lookup("k1", /*wait=*/true, /*advise_erase=*/false), nullptr);
+  // Only admitted when evicted from the primary cache a second time
+  ASSERT_OK(sec_cache_->Insert("k1", &item1, GetHelper(), false));
+  ASSERT_EQ(Lookup("k1", true, false), nullptr);
+  ASSERT_OK(sec_cache_->Insert("k1", &item1, GetHelper(), false));
+
+  // Served from the write buffer
+  auto handle = Lookup("k1", /*wait=*/false, /*advise_erase=*/false);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(TakeValue(handle.get()), str1);
+
+  // Served from the file
+  sec_cache()->TEST_Flush();
+  handle = Lookup("k1", /*wait=*/true, /*advise_erase=*/false);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(TakeValue(handle.get()), str1);
+
+  handle = Lookup("k1", /*wait=*/false, /*advise_erase=*/true);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_FALSE(handle->IsReady());
+  handle->Wait();
+  ASSERT_EQ(TakeValue(handle.get()), str1);
+  ASSERT_EQ(Lookup("k1", true, false), nullptr);
+
+  // Not secondary cache compatible
+  ASSERT_OK(sec_cache_->Insert("k2", &item1,
+                               GetHelper(CacheEntryRole::kDataBlock, false),
+                               true));
+  ASSERT_EQ(Lookup("k2", true, false), nullptr);
+
+  // Saved data, and erasing
+  ASSERT_OK(sec_cache_->InsertSaved("k3", "saved"));
+  handle = Lookup("k3", true, false);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(TakeValue(handle.get()), "saved");
+  sec_cache_->Erase("k3");
+  ASSERT_EQ(Lookup("k3", true, false), nullptr);
+
+  // Too large
+  std::string str4 = rnd.RandomString(5000);
+  TestItem item4(str4.data(), str4.size());
+  ASSERT_OK(sec_cache_->Insert("k4", &item4, GetHelper(), true));
+  ASSERT_EQ(Lookup("k4", true, false), nullptr);
+}
+
+TEST_F(LocalFileSecondaryCacheTest, WaitAllAndEviction) {
+  Open(/*capacity=*/4 * 4096);
+  Random rnd(302);
+  std::vector<std::string> values;
+  // Three records per segment, flushed three at a time to fill 7 segments
+  for (int i = 0; i < 20; ++i) {
+    values.push_back(rnd.RandomString(1200));
+    TestItem item(values.back().data(), values.back().size());
+    ASSERT_OK(sec_cache_->Insert("k" + std::to_string(i), &item, GetHelper(),
+                                 /*force_insert=*/true));
+    if (i % 3 == 2) {
+      // Keep the writer from falling behind
+      sec_cache()->TEST_Flush();
+    }
+  }
+  sec_cache()->TEST_Flush();
+
+  std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+  std::vector<SecondaryCacheResultHandle*> pending;
+  std::vector<int> found;
+  for (int i = 0; i < 20; ++i) {
+    auto handle = Lookup("k" + std::to_string(i), false, false);
+    if (handle) {
+      found.push_back(i);
+      pending.push_back(handle.get());
+      handles.push_back(std::move(handle));
+    }
+  }
+  // The oldest three segments were overwritten
+  ASSERT_EQ(found.front(), 9);
+  ASSERT_EQ(found.back(), 19);
+  ASSERT_EQ(found.size(), 11);
+
+  sec_cache_->WaitAll(pending);
+  for (size_t i = 0; i < found.size(); ++i) {
+    ASSERT_EQ(TakeValue(handles[i].get()), values[found[i]]);
+  }
+}
+
+TEST_F(LocalFileSecondaryCacheTest, Integration) {
+  Open(/*capacity=*/1 << 20, /*write_buffer_size=*/64 << 10);
+  std::shared_ptr<Cache> cache =
+      NewCache(/*capacity=*/1100, /*num_shard_bits=*/0,
+               /*strict_capacity_limit=*/false, sec_cache_);
+
+  Random rnd(303);
+  std::vector<std::string> values;
+  for (int i = 0; i < 10; ++i) {
+    values.push_back(rnd.RandomString(500));
+  }
+  // Everything is evicted from the primary cache twice but the last two
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < 10; ++i) {
+      auto item = new TestItem(values[i].data(), values[i].size());
+      ASSERT_OK(cache->Insert("k" + std::to_string(i), item, GetHelper(),
+                              values[i].size()));
+    }
+  }
+
+  for (int i = 0; i < 8; ++i) {
+    Cache::Handle* handle =
+        cache->Lookup("k" + std::to_string(i), GetHelper(), this,
+                      Cache::Priority::LOW);
+    ASSERT_NE(handle, nullptr);
+    auto item = static_cast<TestItem*>(cache->Value(handle));
+    ASSERT_EQ(item->ToString(), values[i]);
+    cache->Release(handle);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -369,55 +369,82 @@ void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
   strict_capacity_limit_ = strict_capacity_limit;
 }
 
-Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
+Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle,
+                                 const FrequencySketch* admission_sketch) {
   Status s = Status::OK();
   autovector<LRUHandle*> last_reference_list;
 
   {
     DMutexLock l(mutex_);
 
-    // Free the space following strict LRU policy until enough space
-    // is freed or the lru list is empty.
-    EvictFromLRU(e->total_charge, &last_reference_list);
+    // TinyLFU admission, against the oldest entry of the LRU list, which
+    // EvictFromLRU() would evict first. Overwrites are always admitted.
+    bool declined = false;
+    if (admission_sketch != nullptr &&
+        (usage_ + e->total_charge) > capacity_ && lru_.next != &lru_ &&
+        (handle == nullptr || !strict_capacity_limit_) &&
+        table_.Lookup(e->key(), e->hash) == nullptr) {
+      declined = admission_sketch->Estimate(HashForAdmission(e->hash)) <=
+                 admission_sketch->Estimate(HashForAdmission(lru_.next->hash));
+    }
 
-    if ((usage_ + e->total_charge) > capacity_ &&
-        (strict_capacity_limit_ || handle == nullptr)) {
+    if (declined) {
+      // Evict nothing
       e->SetInCache(false);
       if (handle == nullptr) {
-        // Don't insert the entry but still return ok, as if the entry inserted
-        // into cache and get evicted immediately.
+        // As if inserted into cache and evicted immediately
         last_reference_list.push_back(e);
       } else {
-        free(e);
-        e = nullptr;
-        *handle = nullptr;
-        s = Status::MemoryLimit("Insert failed due to LRU cache being full.");
+        // Standalone, still charged to the cache until released
+        e->SetIsStandalone(true);
+        e->Ref();
+        usage_ += e->total_charge;
+        *handle = e;
       }
     } else {
-      // Insert into the cache. Note that the cache might get larger than its
-      // capacity if not enough space was freed up.
-      LRUHandle* old = table_.Insert(e);
-      usage_ += e->total_charge;
-      if (old != nullptr) {
-        s = Status::OkOverwritten();
-        assert(old->InCache());
-        old->SetInCache(false);
-        if (!old->HasRefs()) {
-          // old is on LRU because it's in cache and its reference count is 0.
-          LRU_Remove(old);
-          assert(usage_ >= old->total_charge);
-          usage_ -= old->total_charge;
-          last_reference_list.push_back(old);
+      // Free the space following strict LRU policy until enough space
+      // is freed or the lru list is empty.
+      EvictFromLRU(e->total_charge, &last_reference_list);
+
+      if ((usage_ + e->total_charge) > capacity_ &&
+          (strict_capacity_limit_ || handle == nullptr)) {
+        e->SetInCache(false);
+        if (handle == nullptr) {
+          // Don't insert the entry but still return ok, as if the entry
+          // inserted into cache and get evicted immediately.
+          last_reference_list.push_back(e);
+        } else {
+          free(e);
+          e = nullptr;
+          *handle = nullptr;
+          s = Status::MemoryLimit("Insert failed due to LRU cache being full.");
         }
-      }
-      if (handle == nullptr) {
-        LRU_Insert(e);
       } else {
-        // If caller already holds a ref, no need to take one here.
-        if (!e->HasRefs()) {
-          e->Ref();
+        // Insert into the cache. Note that the cache might get larger than its
+        // capacity if not enough space was freed up.
+        LRUHandle* old = table_.Insert(e);
+        usage_ += e->total_charge;
+        if (old != nullptr) {
+          s = Status::OkOverwritten();
+          assert(old->InCache());
+          old->SetInCache(false);
+          if (!old->HasRefs()) {
+            // old is on LRU because it's in cache and its reference count is 0.
+            LRU_Remove(old);
+            assert(usage_ >= old->total_charge);
+            usage_ -= old->total_charge;
+            last_reference_list.push_back(old);
+          }
+        }
+        if (handle == nullptr) {
+          LRU_Insert(e);
+        } else {
+          // If caller already holds a ref, no need to take one here.
+          if (!e->HasRefs()) {
+            e->Ref();
+          }
+          *handle = e;
         }
-        *handle = e;
       }
     }
   }
@@ -556,6 +583,16 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash,
   return InsertItem(e, handle);
 }
 
+Status LRUCacheShard::InsertWithAdmission(
+    const Slice& key, uint32_t hash, Cache::ObjectPtr value,
+    const Cache::CacheItemHelper* helper, size_t charge, LRUHandle** handle,
+    Cache::Priority priority, const FrequencySketch& sketch) {
+  LRUHandle* e = CreateHandle(key, hash, value, helper, charge);
+  e->SetPriority(priority);
+  e->SetInCache(true);
+  return InsertItem(e, handle, &sketch);
+}
+
 LRUHandle* LRUCacheShard::CreateStandalone(const Slice& key, uint32_t hash,
                                            Cache::ObjectPtr value,
                                            const Cache::CacheItemHelper* helper,
@@ -307,6 +307,13 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
                               const Cache::CacheItemHelper* helper,
                               size_t charge, bool allow_uncharged);
 
+  Status InsertWithAdmission(const Slice& key, uint32_t hash,
+                             Cache::ObjectPtr value,
+                             const Cache::CacheItemHelper* helper,
+                             size_t charge, LRUHandle** handle,
+                             Cache::Priority priority,
+                             const FrequencySketch& sketch);
+
   LRUHandle* Lookup(const Slice& key, uint32_t hash,
                     const Cache::CacheItemHelper* helper,
                     Cache::CreateContext* create_context,
@@ -354,7 +361,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // Insert an item into the hash table and, if handle is null, insert into
   // the LRU list. Older items are evicted as necessary. Frees `item` on
   // non-OK status.
-  Status InsertItem(LRUHandle* item, LRUHandle** handle);
+  // With `admission_sketch`, see InsertWithAdmission()
+  Status InsertItem(LRUHandle* item, LRUHandle** handle,
+                    const FrequencySketch* admission_sketch = nullptr);
 
   void LRU_Remove(LRUHandle* e);
   void LRU_Insert(LRUHandle* e);
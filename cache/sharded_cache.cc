@@ -62,6 +62,7 @@ ShardedCacheBase::ShardedCacheBase(const ShardedCacheOptions& opts)
       last_id_(1),
       shard_mask_((uint32_t{1} << opts.num_shard_bits) - 1),
       hash_seed_(DetermineSeed(opts.hash_seed)),
+      tiny_lfu_admission_(opts.tiny_lfu_admission),
       strict_capacity_limit_(opts.strict_capacity_limit),
       capacity_(opts.capacity) {}
 
@@ -119,6 +120,9 @@ std::string ShardedCacheBase::GetPrintableOptions() const {
              strict_capacity_limit_);
     ret.append(buffer);
   }
+  snprintf(buffer, kBufferSize, "    tiny_lfu_admission : %d\n",
+           tiny_lfu_admission_);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "    memory_allocator : %s\n",
            memory_allocator() ? memory_allocator()->Name() : "None");
   ret.append(buffer);
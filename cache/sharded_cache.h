@@ -11,9 +11,13 @@
 
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "cache/frequency_sketch.h"
 #include "port/lang.h"
+#include "port/likely.h"
 #include "port/port.h"
 #include "rocksdb/advanced_cache.h"
 #include "util/hash.h"
@@ -40,6 +44,8 @@ class CacheShardBase {
   static inline uint32_t HashPieceForSharding(HashCref hash) {
     return Lower32of64(hash);
   }
+  // Hash for the ShardedCacheOptions::tiny_lfu_admission frequency sketch
+  static inline uint64_t HashForAdmission(HashCref hash) { return hash; }
   void AppendPrintableOptions(std::string& /*str*/) const {}
 
   // Must be provided for concept CacheShard (TODO with C++20 support)
@@ -53,6 +59,21 @@ class CacheShardBase {
                 const Cache::CacheItemHelper* helper, size_t charge,
                 HandleImpl** handle, Cache::Priority priority,
                 bool standalone) = 0;
+  // For ShardedCacheOptions::tiny_lfu_admission. Like Insert(), except
+  // that when the insert would require an eviction, the entry is admitted
+  // only if `sketch` estimates it to be accessed more frequently than (an
+  // approximation of) the next entry to be evicted. A declined entry evicts
+  // nothing: without `handle`, it is dropped as if inserted and immediately
+  // evicted; with `handle`, it becomes a standalone entry (not findable by
+  // Lookup()) that is still charged to the cache until released. With
+  // strict_capacity_limit, an entry that does not fit without evicting is
+  // inserted as by Insert(), which might fail with MemoryLimit.
+  Status InsertWithAdmission(const Slice& key, HashCref hash,
+                             Cache::ObjectPtr value,
+                             const Cache::CacheItemHelper* helper,
+                             size_t charge, HandleImpl** handle,
+                             Cache::Priority priority,
+                             const FrequencySketch& sketch) = 0;
   Handle* CreateStandalone(const Slice& key, HashCref hash, ObjectPtr obj,
                            const CacheItemHelper* helper,
                            size_t charge, bool allow_uncharged) = 0;
@@ -117,6 +138,7 @@ class ShardedCacheBase : public Cache {
   std::atomic<uint64_t> last_id_;  // For NewId
   const uint32_t shard_mask_;
   const uint32_t hash_seed_;
+  const bool tiny_lfu_admission_;
 
   // Dynamic configuration parameters, guarded by config_mutex_
   bool strict_capacity_limit_;
@@ -141,7 +163,15 @@ class ShardedCache : public ShardedCacheBase {
       : ShardedCacheBase(opts),
         shards_(static_cast<CacheShard*>(port::cacheline_aligned_alloc(
             sizeof(CacheShard) * GetNumShards()))),
-        destroy_shards_in_dtor_(false) {}
+        destroy_shards_in_dtor_(false) {
+    if (tiny_lfu_admission_) {
+      // Budget ~1% of the capacity for the frequency sketches
+      size_t sketch_bytes = ComputePerShardCapacity(opts.capacity) / 100;
+      for (uint32_t i = 0; i < GetNumShards(); i++) {
+        admission_sketches_.emplace_back(new FrequencySketch(sketch_bytes));
+      }
+    }
+  }
 
   virtual ~ShardedCache() {
     if (destroy_shards_in_dtor_) {
@@ -163,6 +193,9 @@ class ShardedCache : public ShardedCacheBase {
     capacity_ = capacity;
     auto per_shard = ComputePerShardCapacity(capacity);
     ForEachShard([=](CacheShard* cs) { cs->SetCapacity(per_shard); });
+    for (auto& sketch : admission_sketches_) {
+      sketch->Resize(per_shard / 100);
+    }
   }
 
   void SetStrictCapacityLimit(bool s_c_l) override {
@@ -181,8 +214,14 @@ class ShardedCache : public ShardedCacheBase {
     assert(helper);
     HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
     auto h_out = reinterpret_cast<HandleImpl**>(handle);
-    return GetShard(hash).Insert(key, hash, obj, helper, charge, h_out,
-                                 priority);
+    CacheShard& shard = GetShard(hash);
+    // Placeholder entries, such as those of CacheReservationManager, own no
+    // object and only account for memory used elsewhere, so always go in.
+    if (UNLIKELY(tiny_lfu_admission_) && helper->del_cb != nullptr) {
+      return shard.InsertWithAdmission(key, hash, obj, helper, charge, h_out,
+                                       priority, GetAdmissionSketch(hash));
+    }
+    return shard.Insert(key, hash, obj, helper, charge, h_out, priority);
   }
 
   Handle* CreateStandalone(const Slice& key, ObjectPtr obj,
@@ -200,6 +239,9 @@ class ShardedCache : public ShardedCacheBase {
                  Priority priority = Priority::LOW,
                  Statistics* stats = nullptr) override {
     HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    if (UNLIKELY(tiny_lfu_admission_)) {
+      GetAdmissionSketch(hash).Increment(CacheShard::HashForAdmission(hash));
+    }
     HandleImpl* result = GetShard(hash).Lookup(key, hash, helper,
                                                create_context, priority, stats);
     return static_cast<Handle*>(result);
@@ -310,9 +352,16 @@ class ShardedCache : public ShardedCacheBase {
     shards_[0].AppendPrintableOptions(str);
   }
 
+  FrequencySketch& GetAdmissionSketch(HashCref hash) const {
+    return *admission_sketches_[CacheShard::HashPieceForSharding(hash) &
+                                shard_mask_];
+  }
+
  private:
   CacheShard* const shards_;
   bool destroy_shards_in_dtor_;
+  // One per shard if tiny_lfu_admission_, otherwise empty
+  std::vector<std::unique_ptr<FrequencySketch>> admission_sketches_;
 };
 
 // 512KB is traditional minimum shard size.
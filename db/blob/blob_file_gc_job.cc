@@ -0,0 +1,513 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob/blob_file_gc_job.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "db/blob/blob_file_completion_callback.h"
+#include "db/blob/blob_file_meta.h"
+#include "db/blob/blob_file_reader.h"
+#include "db/blob/blob_index.h"
+#include "db/blob/blob_log_format.h"
+#include "db/blob/blob_log_writer.h"
+#include "db/blob/blob_source.h"
+#include "db/column_family.h"
+#include "db/dbformat.h"
+#include "db/table_cache.h"
+#include "db/version_edit.h"
+#include "db/version_set.h"
+#include "file/filename.h"
+#include "file/read_write_util.h"
+#include "file/writable_file_writer.h"
+#include "logging/logging.h"
+#include "monitoring/statistics_impl.h"
+#include "table/internal_iterator.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Live blobs separated by at most this many bytes of garbage are read with a
+// single read, as long as the read stays below kMaxReadBytes.
+constexpr uint64_t kMaxReadGap = 16 << 10;
+constexpr uint64_t kMaxReadBytes = 4 << 20;
+}  // namespace
+
+BlobFileGCJob::BlobFileGCJob(int job_id, ColumnFamilyData* cfd,
+                             const ImmutableDBOptions& db_options,
+                             const FileOptions& file_options,
+                             VersionSet* versions,
+                             const std::atomic<bool>* shutting_down,
+                             BlobFileCompletionCallback* blob_callback,
+                             const std::shared_ptr<IOTracer>& io_tracer,
+                             const CompactBlobFilesOptions& options)
+    : job_id_(job_id),
+      cfd_(cfd),
+      db_options_(db_options),
+      file_options_(file_options),
+      versions_(versions),
+      shutting_down_(shutting_down),
+      blob_callback_(blob_callback),
+      io_tracer_(io_tracer),
+      options_(options) {
+  assert(cfd_);
+  assert(versions_);
+  assert(shutting_down_);
+}
+
+BlobFileGCJob::~BlobFileGCJob() = default;
+
+void BlobFileGCJob::Prepare(Version* version) {
+  assert(version);
+
+  version_ = version;
+  mutable_cf_options_ = version->GetMutableCFOptions();
+
+  for (const auto& meta : version->storage_info()->GetBlobFiles()) {
+    assert(meta);
+
+    const uint64_t stored_blob_bytes =
+        meta->GetTotalBlobBytes() -
+        meta->GetSharedMeta()->GetReclaimedBlobBytes();
+    const uint64_t garbage_blob_bytes = meta->GetStoredGarbageBlobBytes();
+    if (garbage_blob_bytes == 0 || garbage_blob_bytes >= stored_blob_bytes) {
+      // Nothing to reclaim, or nothing to copy. In the latter case, the file
+      // is about to be dropped anyway.
+      continue;
+    }
+
+    if (static_cast<double>(garbage_blob_bytes) <
+        options_.garbage_ratio_threshold *
+            static_cast<double>(stored_blob_bytes)) {
+      continue;
+    }
+
+    Input input;
+    input.meta = meta;
+    inputs_.emplace_back(std::move(input));
+  }
+
+  ROCKS_LOG_INFO(db_options_.info_log,
+                 "[%s] [JOB %d] Blob file GC picked %zu blob file(s)",
+                 cfd_->GetName().c_str(), job_id_, inputs_.size());
+}
+
+Status BlobFileGCJob::Run() {
+  assert(version_);
+
+  if (inputs_.empty()) {
+    return Status::OK();
+  }
+
+  Status s = CollectLiveBlobs();
+
+  for (auto& input : inputs_) {
+    if (!s.ok()) {
+      break;
+    }
+
+    if (shutting_down_->load(std::memory_order_acquire)) {
+      s = Status::ShutdownInProgress();
+      break;
+    }
+
+    s = RewriteBlobFile(&input);
+  }
+
+  Statistics* const statistics = cfd_->ioptions().stats;
+  RecordTick(statistics, BLOB_FILE_GC_BYTES_READ, bytes_read_);
+  RecordTick(statistics, BLOB_FILE_GC_BYTES_WRITTEN, bytes_written_);
+
+  return s;
+}
+
+Status BlobFileGCJob::CollectLiveBlobs() {
+  // Blob files are numbered in creation order, and SSTs only reference blob
+  // files at or above their oldest one.
+  const uint64_t max_blob_file_number =
+      inputs_.back().meta->GetBlobFileNumber();
+
+  ReadOptions read_options(Env::IOActivity::kCompaction);
+  read_options.fill_cache = false;
+  read_options.verify_checksums = true;
+  read_options.rate_limiter_priority = options_.rate_limiter_priority;
+
+  const VersionStorageInfo* const storage_info = version_->storage_info();
+
+  for (int level = 0; level < storage_info->num_levels(); ++level) {
+    for (const FileMetaData* const f : storage_info->LevelFiles(level)) {
+      assert(f);
+
+      if (f->oldest_blob_file_number == kInvalidBlobFileNumber ||
+          f->oldest_blob_file_number > max_blob_file_number) {
+        continue;
+      }
+
+      std::unique_ptr<InternalIterator> iter(cfd_->table_cache()->NewIterator(
+          read_options, file_options_, cfd_->internal_comparator(), *f,
+          /*range_del_agg=*/nullptr, mutable_cf_options_,
+          /*table_reader_ptr=*/nullptr, /*file_read_hist=*/nullptr,
+          TableReaderCaller::kCompaction, /*arena=*/nullptr,
+          /*skip_filters=*/true, level,
+          /*max_file_size_for_l0_meta_pin=*/0,
+          /*smallest_compaction_key=*/nullptr,
+          /*largest_compaction_key=*/nullptr,
+          /*allow_unprepared_value=*/false));
+
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        ParsedInternalKey ikey;
+        Status s = ParseInternalKey(iter->key(), &ikey,
+                                    /*log_err_key=*/false);
+        if (!s.ok()) {
+          return s;
+        }
+
+        if (ikey.type != kTypeBlobIndex) {
+          continue;
+        }
+
+        BlobIndex blob_index;
+        s = blob_index.DecodeFrom(iter->value());
+        if (!s.ok()) {
+          return s;
+        }
+
+        if (blob_index.IsInlined() || blob_index.HasTTL()) {
+          continue;
+        }
+
+        auto it = std::lower_bound(
+            inputs_.begin(), inputs_.end(), blob_index.file_number(),
+            [](const Input& input, uint64_t blob_file_number) {
+              return input.meta->GetBlobFileNumber() < blob_file_number;
+            });
+        if (it == inputs_.end() ||
+            it->meta->GetBlobFileNumber() != blob_index.file_number()) {
+          continue;
+        }
+
+        it->live_blobs.push_back(LiveBlob{blob_index.offset(),
+                                          blob_index.size(),
+                                          ikey.user_key.size()});
+      }
+
+      if (!iter->status().ok()) {
+        return iter->status();
+      }
+    }
+  }
+
+  // Copy each blob once even if more than one entry references it.
+  for (auto& input : inputs_) {
+    auto& live_blobs = input.live_blobs;
+    std::sort(live_blobs.begin(), live_blobs.end(),
+              [](const LiveBlob& lhs, const LiveBlob& rhs) {
+                return lhs.offset < rhs.offset;
+              });
+    live_blobs.erase(std::unique(live_blobs.begin(), live_blobs.end(),
+                                 [](const LiveBlob& lhs, const LiveBlob& rhs) {
+                                   return lhs.offset == rhs.offset;
+                                 }),
+                     live_blobs.end());
+  }
+
+  return Status::OK();
+}
+
+Status BlobFileGCJob::RewriteBlobFile(Input* input) {
+  assert(input);
+
+  const BlobFileMetaData& meta = *input->meta;
+  const BlobFileRelocation* const prev_relocation = meta.GetRelocation();
+  // Offsets in the blob indexes refer to the original file, even if the
+  // blobs were moved before.
+  auto physical_offset = [prev_relocation](uint64_t offset) {
+    return prev_relocation ? prev_relocation->MapOffset(offset) : offset;
+  };
+  auto record_offset = [&physical_offset](const LiveBlob& blob) {
+    return physical_offset(blob.offset) -
+           BlobLogRecord::CalculateAdjustmentForRecordHeader(blob.key_size);
+  };
+  auto record_end = [&physical_offset](const LiveBlob& blob) {
+    return physical_offset(blob.offset) + blob.value_size;
+  };
+
+  ReadOptions read_options(Env::IOActivity::kCompaction);
+  read_options.fill_cache = false;
+  read_options.rate_limiter_priority = options_.rate_limiter_priority;
+
+  CacheHandleGuard<BlobFileReader> blob_file_reader;
+  Status s = cfd_->blob_source()->GetBlobFileReader(
+      read_options, meta.GetPhysicalBlobFileNumber(), &blob_file_reader);
+  if (!s.ok()) {
+    return s;
+  }
+  const BlobFileReader* const reader = blob_file_reader.GetValue();
+  assert(reader);
+
+  const ImmutableOptions& ioptions = cfd_->ioptions();
+  assert(!ioptions.cf_paths.empty());
+
+  const uint64_t new_blob_file_number = versions_->NewFileNumber();
+  input->new_file_path =
+      BlobFileName(ioptions.cf_paths.front().path, new_blob_file_number);
+
+  if (blob_callback_) {
+    blob_callback_->OnBlobFileCreationStarted(
+        input->new_file_path, cfd_->GetName(), job_id_,
+        BlobFileCreationReason::kCompaction);
+  }
+
+  WriteOptions write_options(Env::IOActivity::kCompaction);
+  write_options.rate_limiter_priority = options_.rate_limiter_priority;
+
+  std::unique_ptr<FSWritableFile> file;
+  s = NewWritableFile(ioptions.fs.get(), input->new_file_path, &file,
+                      file_options_);
+  if (!s.ok()) {
+    return s;
+  }
+
+  file->SetIOPriority(write_options.rate_limiter_priority);
+  FileTypeSet tmp_set = ioptions.checksum_handoff_file_types;
+  std::unique_ptr<WritableFileWriter> file_writer(new WritableFileWriter(
+      std::move(file), input->new_file_path, file_options_, ioptions.clock,
+      io_tracer_, ioptions.stats, Histograms::BLOB_DB_BLOB_FILE_WRITE_MICROS,
+      ioptions.listeners, ioptions.file_checksum_gen_factory.get(),
+      tmp_set.Contains(FileType::kBlobFile), false));
+
+  BlobLogWriter writer(std::move(file_writer), ioptions.clock, ioptions.stats,
+                       new_blob_file_number, ioptions.use_fsync,
+                       /*do_flush=*/false);
+
+  // The blobs are copied as they are, so the new file keeps the compression
+  // type of the original.
+  BlobLogHeader header(cfd_->GetID(), reader->GetCompressionType(),
+                       /*has_ttl=*/false, ExpirationRange());
+  s = writer.WriteHeader(write_options, header);
+
+  const auto& live_blobs = input->live_blobs;
+  BlobFileRelocation::OffsetRuns offset_runs;
+  uint64_t blob_bytes = 0;
+  std::string records;
+
+  for (size_t i = 0; s.ok() && i < live_blobs.size();) {
+    // Read the records of nearby blobs at once
+    const uint64_t read_offset = record_offset(live_blobs[i]);
+    uint64_t read_end = record_end(live_blobs[i]);
+    size_t end = i + 1;
+    for (; end < live_blobs.size(); ++end) {
+      const uint64_t next_offset = record_offset(live_blobs[end]);
+      const uint64_t next_end = record_end(live_blobs[end]);
+      if (next_offset < read_end || next_offset - read_end > kMaxReadGap ||
+          next_end - read_offset > kMaxReadBytes) {
+        break;
+      }
+      read_end = next_end;
+    }
+
+    s = reader->ReadRecords(read_options, read_offset,
+                            static_cast<size_t>(read_end - read_offset),
+                            &records);
+    if (!s.ok()) {
+      break;
+    }
+    bytes_read_ += records.size();
+
+    for (; i < end; ++i) {
+      const LiveBlob& blob = live_blobs[i];
+      const Slice record(records.data() + (record_offset(blob) - read_offset),
+                         BlobLogRecord::kHeaderSize + blob.key_size +
+                             blob.value_size);
+      const Slice user_key(record.data() + BlobLogRecord::kHeaderSize,
+                           blob.key_size);
+      const Slice value(user_key.data() + user_key.size(), blob.value_size);
+
+      s = BlobFileReader::VerifyBlob(record, user_key, blob.value_size);
+      if (!s.ok()) {
+        break;
+      }
+
+      uint64_t key_offset = 0;
+      uint64_t new_offset = 0;
+      s = writer.EmitPhysicalRecord(
+          write_options,
+          Slice(record.data(), BlobLogRecord::kHeaderSize).ToString(),
+          user_key, value, &key_offset, &new_offset);
+      if (!s.ok()) {
+        break;
+      }
+
+      // Blobs only move towards the start of the file, by more and more.
+      assert(new_offset <= blob.offset);
+      if (offset_runs.empty() ||
+          blob.offset - new_offset !=
+              offset_runs.back().first - offset_runs.back().second) {
+        offset_runs.emplace_back(blob.offset, new_offset);
+      }
+      blob_bytes += record.size();
+    }
+  }
+
+  std::string checksum_method;
+  std::string checksum_value;
+  if (s.ok()) {
+    BlobLogFooter footer;
+    footer.blob_count = live_blobs.size();
+    s = writer.AppendFooter(write_options, footer, &checksum_method,
+                            &checksum_value);
+  }
+
+  TEST_SYNC_POINT_CALLBACK("BlobFileGCJob::RewriteBlobFile:Finish", &s);
+
+  if (blob_callback_) {
+    s = blob_callback_->OnBlobFileCompleted(
+        input->new_file_path, cfd_->GetName(), job_id_, new_blob_file_number,
+        BlobFileCreationReason::kCompaction, s, checksum_value,
+        checksum_method, live_blobs.size(), blob_bytes);
+  }
+
+  if (!s.ok()) {
+    return s;
+  }
+
+  bytes_written_ += BlobLogHeader::kSize + blob_bytes + BlobLogFooter::kSize;
+
+  input->relocation.reset(new BlobFileRelocation(
+      meta.GetBlobFileNumber(), new_blob_file_number, live_blobs.size(),
+      blob_bytes, std::move(checksum_method), std::move(checksum_value),
+      std::move(offset_runs)));
+
+  ROCKS_LOG_INFO(db_options_.info_log,
+                 "[%s] [JOB %d] Blob file GC copied %zu live blob(s) of blob "
+                 "file #%" PRIu64 " (%" PRIu64 " bytes) to blob file #%" PRIu64
+                 " (%" PRIu64 " bytes)",
+                 cfd_->GetName().c_str(), job_id_, live_blobs.size(),
+                 meta.GetBlobFileNumber(), reader->GetFileSize(),
+                 new_blob_file_number,
+                 input->relocation->GetNewBlobFileSize());
+
+  return Status::OK();
+}
+
+Status BlobFileGCJob::Install(InstrumentedMutex* mu,
+                              FSDirectory* db_directory,
+                              FSDirectory* blob_output_directory) {
+  assert(mu);
+  mu->AssertHeld();
+
+  if (cfd_->IsDropped()) {
+    return Status::ColumnFamilyDropped();
+  }
+
+  VersionEdit edit;
+  edit.SetColumnFamily(cfd_->GetID());
+
+  const VersionStorageInfo* storage_info = cfd_->current()->storage_info();
+
+  for (auto& input : inputs_) {
+    if (!input.relocation) {
+      continue;
+    }
+
+    // The file may have been dropped or rewritten again in the meantime. The
+    // compactions that ran meanwhile may only have dropped references to the
+    // live blobs that were copied.
+    const auto meta =
+        storage_info->GetBlobFileMetaData(input.meta->GetBlobFileNumber());
+    if (!meta || meta->GetSharedMeta() != input.meta->GetSharedMeta()) {
+      ROCKS_LOG_INFO(db_options_.info_log,
+                     "[%s] [JOB %d] Blob file #%" PRIu64
+                     " changed during blob file GC, dropping its copy",
+                     cfd_->GetName().c_str(), job_id_,
+                     input.meta->GetBlobFileNumber());
+      has_dropped_outputs_ = true;
+      input.relocation.reset();
+      continue;
+    }
+
+    edit.AddBlobFileRelocation(*input.relocation);
+  }
+
+  if (edit.NumEntries() == 0) {
+    return Status::OK();
+  }
+
+  // Compactions can still drop the files from here until the edit is
+  // applied, in which case VersionBuilder skips their relocations. The
+  // caller makes sure no other blob file GC job installs in the meantime.
+  mu->Unlock();
+  TEST_SYNC_POINT("BlobFileGCJob::Install:BeforeDirFsync");
+  IOStatus io_s;
+  if (blob_output_directory) {
+    io_s = blob_output_directory->FsyncWithDirOptions(
+        IOOptions(), nullptr,
+        DirFsyncOptions(DirFsyncOptions::FsyncReason::kNewFileSynced));
+  }
+  mu->Lock();
+  if (!io_s.ok()) {
+    return io_s;
+  }
+
+  const ReadOptions read_options(Env::IOActivity::kCompaction);
+  const WriteOptions write_options(Env::IOActivity::kCompaction);
+  const Status s = versions_->LogAndApply(cfd_, read_options, write_options,
+                                          &edit, mu, db_directory);
+  if (!s.ok()) {
+    return s;
+  }
+
+  storage_info = cfd_->current()->storage_info();
+  uint64_t reclaimed_bytes = 0;
+  uint64_t num_files = 0;
+
+  for (const auto& input : inputs_) {
+    if (!input.relocation) {
+      continue;
+    }
+
+    const auto meta =
+        storage_info->GetBlobFileMetaData(input.meta->GetBlobFileNumber());
+    if (!meta || !meta->GetRelocation() ||
+        meta->GetRelocation()->GetNewBlobFileNumber() !=
+            input.relocation->GetNewBlobFileNumber()) {
+      ROCKS_LOG_INFO(db_options_.info_log,
+                     "[%s] [JOB %d] Blob file #%" PRIu64
+                     " dropped during blob file GC, dropping its copy",
+                     cfd_->GetName().c_str(), job_id_,
+                     input.meta->GetBlobFileNumber());
+      has_dropped_outputs_ = true;
+      continue;
+    }
+
+    reclaimed_bytes += input.meta->GetBlobFileSize() -
+                       input.relocation->GetNewBlobFileSize();
+    ++num_files;
+  }
+
+  Statistics* const statistics = cfd_->ioptions().stats;
+  RecordTick(statistics, BLOB_FILE_GC_NUM_FILES, num_files);
+  RecordTick(statistics, BLOB_FILE_GC_BYTES_RECLAIMED, reclaimed_bytes);
+
+  ROCKS_LOG_INFO(db_options_.info_log,
+                 "[%s] [JOB %d] Blob file GC rewrote %" PRIu64
+                 " blob file(s): read %" PRIu64 " bytes, wrote %" PRIu64
+                 " bytes, reclaimed %" PRIu64 " bytes",
+                 cfd_->GetName().c_str(), job_id_, num_files, bytes_read_,
+                 bytes_written_, reclaimed_bytes);
+
+  return Status::OK();
+}
+
+void BlobFileGCJob::ReleaseInputs() {
+  // Dropping the last reference to a SharedBlobFileMetaData marks its file
+  // obsolete, which requires the mutex.
+  inputs_.clear();
+  version_ = nullptr;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,119 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/blob/blob_file_relocation.h"
+#include "options/cf_options.h"
+#include "options/db_options.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/options.h"
+#include "rocksdb/rocksdb_namespace.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class BlobFileCompletionCallback;
+class BlobFileMetaData;
+class ColumnFamilyData;
+class InstrumentedMutex;
+class IOTracer;
+class Version;
+class VersionSet;
+
+// BlobFileGCJob reclaims the garbage in the blob files of a column family
+// without compacting any SST. For each blob file where the share of garbage
+// reaches CompactBlobFilesOptions::garbage_ratio_threshold, it copies the
+// blobs still referenced by the SSTs to a new blob file and installs a
+// BlobFileRelocation, which makes reads look the blobs up in the new file.
+//
+// Like CompactionJob, the job is driven by DBImpl in three steps: Prepare()
+// and Install() are called with the DB mutex held, Run() without.
+class BlobFileGCJob {
+ public:
+  BlobFileGCJob(int job_id, ColumnFamilyData* cfd,
+                const ImmutableDBOptions& db_options,
+                const FileOptions& file_options, VersionSet* versions,
+                const std::atomic<bool>* shutting_down,
+                BlobFileCompletionCallback* blob_callback,
+                const std::shared_ptr<IOTracer>& io_tracer,
+                const CompactBlobFilesOptions& options);
+
+  BlobFileGCJob(const BlobFileGCJob&) = delete;
+  BlobFileGCJob& operator=(const BlobFileGCJob&) = delete;
+
+  ~BlobFileGCJob();
+
+  // Picks the blob files to rewrite in `version`, which must stay referenced
+  // until Run() returns.
+  // REQUIRES: mutex held
+  void Prepare(Version* version);
+
+  bool HasInputs() const { return !inputs_.empty(); }
+
+  // Copies the live blobs of the picked files to new files.
+  // REQUIRES: mutex not held
+  Status Run();
+
+  // Installs the relocations of the files that were not changed by others in
+  // the meantime and deletes the other new files. Releases the mutex while
+  // syncing the new files' directory.
+  // REQUIRES: mutex held, no other job's Install() running
+  Status Install(InstrumentedMutex* mu, FSDirectory* db_directory,
+                 FSDirectory* blob_output_directory);
+
+  // Whether some new files were not installed, in which case they have to be
+  // found by a full scan for obsolete files.
+  bool HasDroppedOutputs() const { return has_dropped_outputs_; }
+
+  // Drops the references to the metadata of the picked files, so that the
+  // files replaced by Install() can be found obsolete.
+  // REQUIRES: mutex held
+  void ReleaseInputs();
+
+ private:
+  // A blob referenced by an SST
+  struct LiveBlob {
+    uint64_t offset;
+    uint64_t value_size;
+    uint64_t key_size;
+  };
+
+  struct Input {
+    std::shared_ptr<BlobFileMetaData> meta;
+    std::vector<LiveBlob> live_blobs;
+    std::string new_file_path;
+    std::unique_ptr<BlobFileRelocation> relocation;
+  };
+
+  Status CollectLiveBlobs();
+  Status RewriteBlobFile(Input* input);
+
+  const int job_id_;
+  ColumnFamilyData* const cfd_;
+  const ImmutableDBOptions& db_options_;
+  const FileOptions file_options_;
+  VersionSet* const versions_;
+  const std::atomic<bool>* const shutting_down_;
+  BlobFileCompletionCallback* const blob_callback_;
+  const std::shared_ptr<IOTracer> io_tracer_;
+  const CompactBlobFilesOptions options_;
+
+  Version* version_ = nullptr;
+  MutableCFOptions mutable_cf_options_;
+  std::vector<Input> inputs_;
+
+  uint64_t bytes_read_ = 0;
+  uint64_t bytes_written_ = 0;
+  bool has_dropped_outputs_ = false;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -8,14 +8,38 @@
 #include <ostream>
 #include <sstream>
 
+#include "db/blob/blob_file_relocation.h"
 #include "db/blob/blob_log_format.h"
 #include "rocksdb/slice.h"
 
 namespace ROCKSDB_NAMESPACE {
 uint64_t SharedBlobFileMetaData::GetBlobFileSize() const {
+  if (relocation_) {
+    return relocation_->GetNewBlobFileSize();
+  }
   return BlobLogHeader::kSize + total_blob_bytes_ + BlobLogFooter::kSize;
 }
 
+uint64_t SharedBlobFileMetaData::GetPhysicalBlobFileNumber() const {
+  return relocation_ ? relocation_->GetNewBlobFileNumber() : blob_file_number_;
+}
+
+const std::string& SharedBlobFileMetaData::GetPhysicalChecksumMethod() const {
+  return relocation_ ? relocation_->GetChecksumMethod() : checksum_method_;
+}
+
+const std::string& SharedBlobFileMetaData::GetPhysicalChecksumValue() const {
+  return relocation_ ? relocation_->GetChecksumValue() : checksum_value_;
+}
+
+uint64_t SharedBlobFileMetaData::GetReclaimedBlobBytes() const {
+  if (!relocation_) {
+    return 0;
+  }
+  assert(relocation_->GetBlobBytes() <= total_blob_bytes_);
+  return total_blob_bytes_ - relocation_->GetBlobBytes();
+}
+
 std::string SharedBlobFileMetaData::DebugString() const {
   std::ostringstream oss;
   oss << (*this);
@@ -31,6 +55,9 @@ std::ostream& operator<<(std::ostream& os,
      << " checksum_method: " << shared_meta.GetChecksumMethod()
      << " checksum_value: "
      << Slice(shared_meta.GetChecksumValue()).ToString(/* hex */ true);
+  if (shared_meta.GetRelocation()) {
+    os << " relocation: {" << *shared_meta.GetRelocation() << " }";
+  }
 
   return os;
 }
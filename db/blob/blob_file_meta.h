@@ -16,12 +16,17 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class BlobFileRelocation;
+
 // SharedBlobFileMetaData represents the immutable part of blob files' metadata,
 // like the blob file number, total number and size of blobs, or checksum
 // method and value. There is supposed to be one object of this class per blob
 // file (shared across all versions that include the blob file in question);
 // hence, the type is neither copyable nor movable. A blob file can be marked
 // obsolete when the corresponding SharedBlobFileMetaData object is destroyed.
+// Once blob file GC has copied the live blobs of the file to a new file (see
+// BlobFileRelocation), the blob file is described by a new object, which
+// makes the new file obsolete when destroyed.
 
 class SharedBlobFileMetaData {
  public:
@@ -46,12 +51,29 @@ class SharedBlobFileMetaData {
         deleter);
   }
 
+  // Returns the metadata of the blob file described by `shared_meta` once
+  // its blobs have been moved as described by `relocation`.
+  template <typename Deleter>
+  static std::shared_ptr<SharedBlobFileMetaData> CreateRelocated(
+      const SharedBlobFileMetaData& shared_meta,
+      std::shared_ptr<const BlobFileRelocation> relocation, Deleter deleter) {
+    std::shared_ptr<SharedBlobFileMetaData> result(
+        new SharedBlobFileMetaData(
+            shared_meta.blob_file_number_, shared_meta.total_blob_count_,
+            shared_meta.total_blob_bytes_, shared_meta.checksum_method_,
+            shared_meta.checksum_value_),
+        deleter);
+    result->relocation_ = std::move(relocation);
+    return result;
+  }
+
   SharedBlobFileMetaData(const SharedBlobFileMetaData&) = delete;
   SharedBlobFileMetaData& operator=(const SharedBlobFileMetaData&) = delete;
 
   SharedBlobFileMetaData(SharedBlobFileMetaData&&) = delete;
   SharedBlobFileMetaData& operator=(SharedBlobFileMetaData&&) = delete;
 
+  // The size of the file holding the blobs
   uint64_t GetBlobFileSize() const;
   uint64_t GetBlobFileNumber() const { return blob_file_number_; }
   uint64_t GetTotalBlobCount() const { return total_blob_count_; }
@@ -59,6 +81,18 @@ class SharedBlobFileMetaData {
   const std::string& GetChecksumMethod() const { return checksum_method_; }
   const std::string& GetChecksumValue() const { return checksum_value_; }
 
+  // Null unless blob file GC has moved the blobs to another file.
+  const BlobFileRelocation* GetRelocation() const { return relocation_.get(); }
+
+  // The number and checksum of the file holding the blobs, which differ from
+  // the above once the blobs have been moved.
+  uint64_t GetPhysicalBlobFileNumber() const;
+  const std::string& GetPhysicalChecksumMethod() const;
+  const std::string& GetPhysicalChecksumValue() const;
+
+  // The size of the blobs dropped when blob file GC moved the blobs
+  uint64_t GetReclaimedBlobBytes() const;
+
   std::string DebugString() const;
 
  private:
@@ -78,6 +112,7 @@ class SharedBlobFileMetaData {
   uint64_t total_blob_bytes_;
   std::string checksum_method_;
   std::string checksum_value_;
+  std::shared_ptr<const BlobFileRelocation> relocation_;
 };
 
 std::ostream& operator<<(std::ostream& os,
@@ -139,12 +174,37 @@ class BlobFileMetaData {
     assert(shared_meta_);
     return shared_meta_->GetChecksumValue();
   }
+  const BlobFileRelocation* GetRelocation() const {
+    assert(shared_meta_);
+    return shared_meta_->GetRelocation();
+  }
+  uint64_t GetPhysicalBlobFileNumber() const {
+    assert(shared_meta_);
+    return shared_meta_->GetPhysicalBlobFileNumber();
+  }
+  const std::string& GetPhysicalChecksumMethod() const {
+    assert(shared_meta_);
+    return shared_meta_->GetPhysicalChecksumMethod();
+  }
+  const std::string& GetPhysicalChecksumValue() const {
+    assert(shared_meta_);
+    return shared_meta_->GetPhysicalChecksumValue();
+  }
 
   const LinkedSsts& GetLinkedSsts() const { return linked_ssts_; }
 
   uint64_t GetGarbageBlobCount() const { return garbage_blob_count_; }
   uint64_t GetGarbageBlobBytes() const { return garbage_blob_bytes_; }
 
+  // The garbage still taking up space in the file holding the blobs, i.e. the
+  // garbage not dropped by blob file GC
+  uint64_t GetStoredGarbageBlobBytes() const {
+    assert(shared_meta_);
+    const uint64_t reclaimed = shared_meta_->GetReclaimedBlobBytes();
+    return garbage_blob_bytes_ > reclaimed ? garbage_blob_bytes_ - reclaimed
+                                           : 0;
+  }
+
   std::string DebugString() const;
 
  private:
@@ -294,6 +294,31 @@ BlobFileReader::BlobFileReader(
 
 BlobFileReader::~BlobFileReader() = default;
 
+Status BlobFileReader::ReadRecords(const ReadOptions& read_options,
+                                   uint64_t offset, size_t size,
+                                   std::string* records) const {
+  assert(records);
+
+  if (offset < BlobLogHeader::kSize ||
+      offset + size + BlobLogFooter::kSize > file_size_) {
+    return Status::Corruption("Invalid blob record range");
+  }
+
+  Slice slice;
+  Buffer buf;
+  AlignedBuf aligned_buf;
+
+  const Status s = ReadFromFile(file_reader_.get(), read_options, offset, size,
+                                statistics_, &slice, &buf, &aligned_buf);
+  if (!s.ok()) {
+    return s;
+  }
+
+  records->assign(slice.data(), slice.size());
+
+  return Status::OK();
+}
+
 Status BlobFileReader::GetBlob(
     const ReadOptions& read_options, const Slice& user_key, uint64_t offset,
     uint64_t value_size, CompressionType compression_type,
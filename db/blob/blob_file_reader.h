@@ -7,6 +7,7 @@
 
 #include <cinttypes>
 #include <memory>
+#include <string>
 
 #include "db/blob/blob_read_request.h"
 #include "file/random_access_file_reader.h"
@@ -57,6 +58,17 @@ class BlobFileReader {
           blob_reqs,
       uint64_t* bytes_read) const;
 
+  // Reads the bytes in [offset, offset + size) as they are stored in the file,
+  // without verifying or uncompressing anything. Used by blob file GC to copy
+  // blob records to another file.
+  Status ReadRecords(const ReadOptions& read_options, uint64_t offset,
+                     size_t size, std::string* records) const;
+
+  // Checks that `record_slice` is the record of the blob of `user_key` with
+  // the given size, including the checksums of the header and the blob.
+  static Status VerifyBlob(const Slice& record_slice, const Slice& user_key,
+                           uint64_t value_size);
+
   CompressionType GetCompressionType() const { return compression_type_; }
 
   uint64_t GetFileSize() const { return file_size_; }
@@ -91,9 +103,6 @@ class BlobFileReader {
                              Statistics* statistics, Slice* slice, Buffer* buf,
                              AlignedBuf* aligned_buf);
 
-  static Status VerifyBlob(const Slice& record_slice, const Slice& user_key,
-                           uint64_t value_size);
-
   static Status UncompressBlobIfNeeded(const Slice& value_slice,
                                        CompressionType compression_type,
                                        MemoryAllocator* allocator,
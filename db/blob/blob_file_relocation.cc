@@ -0,0 +1,230 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob/blob_file_relocation.h"
+
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+
+#include "db/blob/blob_log_format.h"
+#include "logging/event_logger.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "test_util/sync_point.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Tags for custom fields. Note that these get persisted in the manifest,
+// so existing tags should not be modified.
+enum BlobFileRelocation::CustomFieldTags : uint32_t {
+  kEndMarker,
+
+  // Add forward compatible fields here
+
+  /////////////////////////////////////////////////////////////////////
+
+  kForwardIncompatibleMask = 1 << 6,
+
+  // Add forward incompatible fields here
+};
+
+uint64_t BlobFileRelocation::GetNewBlobFileSize() const {
+  return BlobLogHeader::kSize + blob_bytes_ + BlobLogFooter::kSize;
+}
+
+uint64_t BlobFileRelocation::MapOffset(uint64_t offset) const {
+  // Find the last run starting at or before the offset.
+  auto it = std::upper_bound(
+      offset_runs_.begin(), offset_runs_.end(), offset,
+      [](uint64_t lhs, const std::pair<uint64_t, uint64_t>& rhs) {
+        return lhs < rhs.first;
+      });
+  if (it == offset_runs_.begin()) {
+    // Not a copied blob; reading it will fail the checks on the record.
+    return offset;
+  }
+  --it;
+  assert(it->first >= it->second);
+
+  return offset - (it->first - it->second);
+}
+
+void BlobFileRelocation::EncodeTo(std::string* output) const {
+  PutVarint64(output, blob_file_number_);
+  PutVarint64(output, new_blob_file_number_);
+  PutVarint64(output, blob_count_);
+  PutVarint64(output, blob_bytes_);
+  PutLengthPrefixedSlice(output, checksum_method_);
+  PutLengthPrefixedSlice(output, checksum_value_);
+
+  // Both the offsets and the distances the blobs moved only grow from run to
+  // run, so they are stored as deltas.
+  PutVarint64(output, offset_runs_.size());
+  uint64_t prev_offset = 0;
+  uint64_t prev_shift = 0;
+  for (const auto& run : offset_runs_) {
+    assert(run.first >= prev_offset);
+    assert(run.first - run.second >= prev_shift);
+    PutVarint64(output, run.first - prev_offset);
+    PutVarint64(output, run.first - run.second - prev_shift);
+    prev_offset = run.first;
+    prev_shift = run.first - run.second;
+  }
+
+  // Encode any custom fields here. The format to use is a Varint32 tag (see
+  // CustomFieldTags above) followed by a length prefixed slice. Unknown custom
+  // fields will be ignored during decoding unless they're in the forward
+  // incompatible range.
+
+  TEST_SYNC_POINT_CALLBACK("BlobFileRelocation::EncodeTo::CustomFields",
+                           output);
+
+  PutVarint32(output, kEndMarker);
+}
+
+Status BlobFileRelocation::DecodeFrom(Slice* input) {
+  constexpr char class_name[] = "BlobFileRelocation";
+
+  if (!GetVarint64(input, &blob_file_number_)) {
+    return Status::Corruption(class_name, "Error decoding blob file number");
+  }
+
+  if (!GetVarint64(input, &new_blob_file_number_)) {
+    return Status::Corruption(class_name,
+                              "Error decoding new blob file number");
+  }
+
+  if (!GetVarint64(input, &blob_count_)) {
+    return Status::Corruption(class_name, "Error decoding blob count");
+  }
+
+  if (!GetVarint64(input, &blob_bytes_)) {
+    return Status::Corruption(class_name, "Error decoding blob bytes");
+  }
+
+  Slice checksum_method;
+  if (!GetLengthPrefixedSlice(input, &checksum_method)) {
+    return Status::Corruption(class_name, "Error decoding checksum method");
+  }
+  checksum_method_ = checksum_method.ToString();
+
+  Slice checksum_value;
+  if (!GetLengthPrefixedSlice(input, &checksum_value)) {
+    return Status::Corruption(class_name, "Error decoding checksum value");
+  }
+  checksum_value_ = checksum_value.ToString();
+
+  uint64_t num_runs = 0;
+  if (!GetVarint64(input, &num_runs) || num_runs > blob_count_) {
+    return Status::Corruption(class_name, "Error decoding offset runs");
+  }
+
+  offset_runs_.clear();
+  offset_runs_.reserve(num_runs);
+  uint64_t offset = 0;
+  uint64_t shift = 0;
+  for (uint64_t i = 0; i < num_runs; ++i) {
+    uint64_t offset_delta = 0;
+    uint64_t shift_delta = 0;
+    if (!GetVarint64(input, &offset_delta) ||
+        !GetVarint64(input, &shift_delta)) {
+      return Status::Corruption(class_name, "Error decoding offset runs");
+    }
+    offset += offset_delta;
+    shift += shift_delta;
+    if (shift > offset) {
+      return Status::Corruption(class_name, "Invalid offset run");
+    }
+    offset_runs_.emplace_back(offset, offset - shift);
+  }
+
+  while (true) {
+    uint32_t custom_field_tag = 0;
+    if (!GetVarint32(input, &custom_field_tag)) {
+      return Status::Corruption(class_name, "Error decoding custom field tag");
+    }
+
+    if (custom_field_tag == kEndMarker) {
+      break;
+    }
+
+    if (custom_field_tag & kForwardIncompatibleMask) {
+      return Status::Corruption(
+          class_name, "Forward incompatible custom field encountered");
+    }
+
+    Slice custom_field_value;
+    if (!GetLengthPrefixedSlice(input, &custom_field_value)) {
+      return Status::Corruption(class_name,
+                                "Error decoding custom field value");
+    }
+  }
+
+  return Status::OK();
+}
+
+std::string BlobFileRelocation::DebugString() const {
+  std::ostringstream oss;
+
+  oss << *this;
+
+  return oss.str();
+}
+
+std::string BlobFileRelocation::DebugJSON() const {
+  JSONWriter jw;
+
+  jw << *this;
+
+  jw.EndObject();
+
+  return jw.Get();
+}
+
+bool operator==(const BlobFileRelocation& lhs, const BlobFileRelocation& rhs) {
+  return lhs.GetBlobFileNumber() == rhs.GetBlobFileNumber() &&
+         lhs.GetNewBlobFileNumber() == rhs.GetNewBlobFileNumber() &&
+         lhs.GetBlobCount() == rhs.GetBlobCount() &&
+         lhs.GetBlobBytes() == rhs.GetBlobBytes() &&
+         lhs.GetChecksumMethod() == rhs.GetChecksumMethod() &&
+         lhs.GetChecksumValue() == rhs.GetChecksumValue() &&
+         lhs.GetOffsetRuns() == rhs.GetOffsetRuns();
+}
+
+bool operator!=(const BlobFileRelocation& lhs, const BlobFileRelocation& rhs) {
+  return !(lhs == rhs);
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const BlobFileRelocation& blob_file_relocation) {
+  os << "blob_file_number: " << blob_file_relocation.GetBlobFileNumber()
+     << " new_blob_file_number: "
+     << blob_file_relocation.GetNewBlobFileNumber()
+     << " blob_count: " << blob_file_relocation.GetBlobCount()
+     << " blob_bytes: " << blob_file_relocation.GetBlobBytes()
+     << " checksum_method: " << blob_file_relocation.GetChecksumMethod()
+     << " checksum_value: "
+     << Slice(blob_file_relocation.GetChecksumValue()).ToString(/* hex */ true)
+     << " offset_runs: " << blob_file_relocation.GetOffsetRuns().size();
+
+  return os;
+}
+
+JSONWriter& operator<<(JSONWriter& jw,
+                       const BlobFileRelocation& blob_file_relocation) {
+  jw << "BlobFileNumber" << blob_file_relocation.GetBlobFileNumber()
+     << "NewBlobFileNumber" << blob_file_relocation.GetNewBlobFileNumber()
+     << "BlobCount" << blob_file_relocation.GetBlobCount() << "BlobBytes"
+     << blob_file_relocation.GetBlobBytes() << "ChecksumMethod"
+     << blob_file_relocation.GetChecksumMethod() << "ChecksumValue"
+     << Slice(blob_file_relocation.GetChecksumValue()).ToString(/* hex */ true)
+     << "OffsetRuns" << blob_file_relocation.GetOffsetRuns().size();
+
+  return jw;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
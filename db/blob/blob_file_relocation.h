@@ -0,0 +1,97 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "db/blob/blob_constants.h"
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class JSONWriter;
+class Slice;
+class Status;
+
+// BlobFileRelocation records that blob file GC (see DB::CompactBlobFiles) has
+// copied the live blobs of a blob file to a new file. The blob file keeps its
+// number, its linked SSTs and its garbage accounting, and the blob indexes in
+// the SSTs keep pointing to it; only the blobs move. Reads map the offset in a
+// blob index to the offset of the blob in the new file.
+//
+// Blobs are copied in file order, record by record, so the mapping is stored
+// as runs: each run is the pair of the old and new offsets of the first blob
+// of a sequence of blobs that were adjacent in the old file. Offsets of blobs
+// that were not copied cannot be mapped.
+class BlobFileRelocation {
+ public:
+  using OffsetRuns = std::vector<std::pair<uint64_t, uint64_t>>;
+
+  BlobFileRelocation() = default;
+
+  BlobFileRelocation(uint64_t blob_file_number, uint64_t new_blob_file_number,
+                     uint64_t blob_count, uint64_t blob_bytes,
+                     std::string checksum_method, std::string checksum_value,
+                     OffsetRuns offset_runs)
+      : blob_file_number_(blob_file_number),
+        new_blob_file_number_(new_blob_file_number),
+        blob_count_(blob_count),
+        blob_bytes_(blob_bytes),
+        checksum_method_(std::move(checksum_method)),
+        checksum_value_(std::move(checksum_value)),
+        offset_runs_(std::move(offset_runs)) {
+    assert(checksum_method_.empty() == checksum_value_.empty());
+  }
+
+  uint64_t GetBlobFileNumber() const { return blob_file_number_; }
+  // The file now holding the blobs
+  uint64_t GetNewBlobFileNumber() const { return new_blob_file_number_; }
+  // The number and total size of the blobs copied to the new file
+  uint64_t GetBlobCount() const { return blob_count_; }
+  uint64_t GetBlobBytes() const { return blob_bytes_; }
+  // Checksum of the new file
+  const std::string& GetChecksumMethod() const { return checksum_method_; }
+  const std::string& GetChecksumValue() const { return checksum_value_; }
+  const OffsetRuns& GetOffsetRuns() const { return offset_runs_; }
+
+  uint64_t GetNewBlobFileSize() const;
+
+  // Returns the offset in the new file of the blob at `offset` in the
+  // original file. The result is meaningless if the blob was not copied.
+  uint64_t MapOffset(uint64_t offset) const;
+
+  void EncodeTo(std::string* output) const;
+  Status DecodeFrom(Slice* input);
+
+  std::string DebugString() const;
+  std::string DebugJSON() const;
+
+ private:
+  enum CustomFieldTags : uint32_t;
+
+  uint64_t blob_file_number_ = kInvalidBlobFileNumber;
+  uint64_t new_blob_file_number_ = kInvalidBlobFileNumber;
+  uint64_t blob_count_ = 0;
+  uint64_t blob_bytes_ = 0;
+  std::string checksum_method_;
+  std::string checksum_value_;
+  OffsetRuns offset_runs_;
+};
+
+bool operator==(const BlobFileRelocation& lhs, const BlobFileRelocation& rhs);
+bool operator!=(const BlobFileRelocation& lhs, const BlobFileRelocation& rhs);
+
+std::ostream& operator<<(std::ostream& os,
+                         const BlobFileRelocation& blob_file_relocation);
+JSONWriter& operator<<(JSONWriter& jw,
+                       const BlobFileRelocation& blob_file_relocation);
+
+}  // namespace ROCKSDB_NAMESPACE
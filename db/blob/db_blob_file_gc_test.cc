@@ -0,0 +1,355 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob/blob_file_relocation.h"
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+#include "rocksdb/file_checksum.h"
+#include "rocksdb/utilities/checkpoint.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class DBBlobFileGCTest : public DBTestBase {
+ protected:
+  DBBlobFileGCTest()
+      : DBTestBase("db_blob_file_gc_test", /* env_do_fsync */ false) {}
+
+  Options GetBlobOptions() {
+    Options options = GetDefaultOptions();
+    options.enable_blob_files = true;
+    options.min_blob_size = 0;
+    options.disable_auto_compactions = true;
+    options.statistics = CreateDBStatistics();
+    options.file_checksum_gen_factory = GetFileChecksumGenCrc32cFactory();
+    return options;
+  }
+
+  static std::string Key(int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%04d", i);
+    return buf;
+  }
+
+  static std::string Value(int i, int version) {
+    return std::string(100, static_cast<char>('a' + version)) +
+           std::to_string(i);
+  }
+
+  // Writes version `version` of the keys in [begin, end) to a new blob file.
+  void WriteKeys(int begin, int end, int version) {
+    for (int i = begin; i < end; ++i) {
+      ASSERT_OK(Put(Key(i), Value(i, version)));
+    }
+    ASSERT_OK(Flush());
+  }
+
+  // Checks that key i has version versions[i], with Get, MultiGet and an
+  // iterator.
+  void Verify(const std::vector<int>& versions) {
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < versions.size(); ++i) {
+      keys.push_back(Key(static_cast<int>(i)));
+      ASSERT_EQ(Get(keys.back()), Value(static_cast<int>(i), versions[i]));
+    }
+
+    std::vector<Slice> key_slices(keys.begin(), keys.end());
+    std::vector<PinnableSlice> values(keys.size());
+    std::vector<Status> statuses(keys.size());
+    db_->MultiGet(ReadOptions(), db_->DefaultColumnFamily(), keys.size(),
+                  key_slices.data(), values.data(), statuses.data());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      ASSERT_OK(statuses[i]);
+      ASSERT_EQ(values[i], Value(static_cast<int>(i), versions[i]));
+    }
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    size_t i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++i) {
+      ASSERT_LT(i, keys.size());
+      ASSERT_EQ(iter->key(), keys[i]);
+      ASSERT_EQ(iter->value(), Value(static_cast<int>(i), versions[i]));
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(i, keys.size());
+  }
+
+  std::vector<BlobMetaData> GetBlobFiles() {
+    ColumnFamilyMetaData cf_meta;
+    db_->GetColumnFamilyMetaData(&cf_meta);
+    return cf_meta.blob_files;
+  }
+};
+
+TEST_F(DBBlobFileGCTest, RewriteBlobFile) {
+  Options options = GetBlobOptions();
+  Reopen(options);
+
+  // Overwrite 80 of the 100 blobs of the first blob file, and turn them into
+  // garbage without compacting away the rest.
+  constexpr int kNumKeys = 100;
+  WriteKeys(0, kNumKeys, 0);
+  WriteKeys(0, 80, 1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  std::vector<int> versions(kNumKeys, 0);
+  std::fill(versions.begin(), versions.begin() + 80, 1);
+  Verify(versions);
+
+  const std::vector<BlobMetaData> before = GetBlobFiles();
+  ASSERT_EQ(before.size(), 2);
+  ASSERT_EQ(before[0].garbage_blob_count, 80);
+  ASSERT_EQ(before[1].garbage_blob_count, 0);
+
+  ASSERT_OK(db_->CompactBlobFiles(CompactBlobFilesOptions(),
+                                  db_->DefaultColumnFamily()));
+
+  // Only the first file is rewritten. It keeps its number and its garbage
+  // accounting, but is now stored in a smaller file.
+  const std::vector<BlobMetaData> after = GetBlobFiles();
+  ASSERT_EQ(after.size(), 2);
+  ASSERT_EQ(after[0].blob_file_number, before[0].blob_file_number);
+  ASSERT_NE(after[0].blob_file_name, before[0].blob_file_name);
+  ASSERT_EQ(after[0].garbage_blob_count, 80);
+  ASSERT_LT(after[0].blob_file_size * 4, before[0].blob_file_size);
+  ASSERT_EQ(after[1].blob_file_name, before[1].blob_file_name);
+  ASSERT_TRUE(
+      env_->FileExists(dbname_ + before[0].blob_file_name).IsNotFound());
+  ASSERT_OK(env_->FileExists(dbname_ + after[0].blob_file_name));
+
+  Statistics* const statistics = options.statistics.get();
+  ASSERT_EQ(statistics->getTickerCount(BLOB_FILE_GC_NUM_FILES), 1);
+  ASSERT_EQ(statistics->getTickerCount(BLOB_FILE_GC_BYTES_RECLAIMED),
+            before[0].blob_file_size - after[0].blob_file_size);
+  ASSERT_GT(statistics->getTickerCount(BLOB_FILE_GC_BYTES_READ), 0);
+  ASSERT_EQ(statistics->getTickerCount(BLOB_FILE_GC_BYTES_WRITTEN),
+            after[0].blob_file_size);
+
+  Verify(versions);
+  ASSERT_OK(db_->VerifyFileChecksums(ReadOptions()));
+
+  // The relocation survives reopening, also from a new MANIFEST.
+  Reopen(options);
+  Verify(versions);
+  ASSERT_EQ(GetBlobFiles()[0].blob_file_name, after[0].blob_file_name);
+
+  options.max_manifest_file_size = 1;
+  Reopen(options);
+  WriteKeys(kNumKeys, kNumKeys + 1, 0);
+  versions.push_back(0);
+  Reopen(options);
+  Verify(versions);
+  ASSERT_EQ(GetBlobFiles()[0].blob_file_name, after[0].blob_file_name);
+}
+
+TEST_F(DBBlobFileGCTest, RewriteTwice) {
+  Options options = GetBlobOptions();
+  Reopen(options);
+
+  constexpr int kNumKeys = 100;
+  WriteKeys(0, kNumKeys, 0);
+  WriteKeys(0, 80, 1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(db_->CompactBlobFiles(CompactBlobFilesOptions(),
+                                  db_->DefaultColumnFamily()));
+  const uint64_t first_number = GetBlobFiles()[0].blob_file_number;
+  const uint64_t first_size = GetBlobFiles()[0].blob_file_size;
+
+  // 10 of the 20 remaining blobs become garbage: the earlier garbage does not
+  // count towards the ratio, which is exactly the threshold.
+  WriteKeys(80, 90, 1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(GetBlobFiles()[0].garbage_blob_count, 90);
+
+  CompactBlobFilesOptions gc_options;
+  gc_options.garbage_ratio_threshold = 0.6;
+  ASSERT_OK(db_->CompactBlobFiles(gc_options, db_->DefaultColumnFamily()));
+  ASSERT_EQ(GetBlobFiles()[0].blob_file_size, first_size);
+
+  gc_options.garbage_ratio_threshold = 0.5;
+  ASSERT_OK(db_->CompactBlobFiles(gc_options, db_->DefaultColumnFamily()));
+  ASSERT_LT(GetBlobFiles()[0].blob_file_size, first_size);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_FILE_GC_NUM_FILES), 2);
+
+  std::vector<int> versions(kNumKeys, 0);
+  std::fill(versions.begin(), versions.begin() + 90, 1);
+  Verify(versions);
+
+  // Dropping the last references drops the file as usual.
+  WriteKeys(90, kNumKeys, 1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  std::fill(versions.begin(), versions.end(), 1);
+  Verify(versions);
+  const std::vector<BlobMetaData> blob_files = GetBlobFiles();
+  ASSERT_EQ(blob_files.size(), 3);
+  ASSERT_GT(blob_files[0].blob_file_number, first_number);
+
+  Reopen(options);
+  Verify(versions);
+}
+
+TEST_F(DBBlobFileGCTest, Checkpoint) {
+  Options options = GetBlobOptions();
+  Reopen(options);
+
+  constexpr int kNumKeys = 50;
+  WriteKeys(0, kNumKeys, 0);
+  WriteKeys(0, 40, 1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(db_->CompactBlobFiles(CompactBlobFilesOptions(),
+                                  db_->DefaultColumnFamily()));
+
+  const std::string checkpoint_dir = dbname_ + "_checkpoint";
+  ASSERT_OK(DestroyDB(checkpoint_dir, options));
+  Checkpoint* checkpoint = nullptr;
+  ASSERT_OK(Checkpoint::Create(db_, &checkpoint));
+  ASSERT_OK(checkpoint->CreateCheckpoint(checkpoint_dir));
+  delete checkpoint;
+
+  Close();
+  ASSERT_OK(DestroyDB(dbname_, options));
+
+  DB* db = nullptr;
+  ASSERT_OK(DB::Open(options, checkpoint_dir, &db));
+  for (int i = 0; i < kNumKeys; ++i) {
+    std::string value;
+    ASSERT_OK(db->Get(ReadOptions(), Key(i), &value));
+    ASSERT_EQ(value, Value(i, i < 40 ? 1 : 0));
+  }
+  delete db;
+  ASSERT_OK(DestroyDB(checkpoint_dir, options));
+}
+
+TEST_F(DBBlobFileGCTest, ConcurrentRewrite) {
+  Options options = GetBlobOptions();
+  Reopen(options);
+
+  constexpr int kNumKeys = 100;
+  WriteKeys(0, kNumKeys, 0);
+  WriteKeys(0, 80, 1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  const std::vector<BlobMetaData> before = GetBlobFiles();
+
+  // Rewrite the file while the outer job is between copying and installing,
+  // so the outer job has to drop its copy.
+  bool nested = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::CompactBlobFiles:AfterRun", [&](void*) {
+        if (nested) {
+          return;
+        }
+        nested = true;
+        ASSERT_OK(db_->CompactBlobFiles(CompactBlobFilesOptions(),
+                                        db_->DefaultColumnFamily()));
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(db_->CompactBlobFiles(CompactBlobFilesOptions(),
+                                  db_->DefaultColumnFamily()));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_TRUE(nested);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_FILE_GC_NUM_FILES), 1);
+
+  std::vector<int> versions(kNumKeys, 0);
+  std::fill(versions.begin(), versions.begin() + 80, 1);
+  Verify(versions);
+
+  // Only the installed copy is left.
+  std::vector<std::string> files;
+  ASSERT_OK(env_->GetChildren(dbname_, &files));
+  size_t num_blob_files = 0;
+  for (const auto& file : files) {
+    uint64_t number = 0;
+    FileType type;
+    if (ParseFileName(file, &number, &type) && type == kBlobFile) {
+      ++num_blob_files;
+    }
+  }
+  ASSERT_EQ(num_blob_files, before.size());
+}
+
+TEST_F(DBBlobFileGCTest, FileDroppedDuringInstall) {
+  Options options = GetBlobOptions();
+  Reopen(options);
+
+  constexpr int kNumKeys = 100;
+  WriteKeys(0, kNumKeys, 0);
+  WriteKeys(0, 80, 1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(GetBlobFiles().size(), 2);
+
+  // Drop all SSTs, and with them the blob files, after the job checked its
+  // relocations but before it writes them to the MANIFEST.
+  bool dropped = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobFileGCJob::Install:BeforeDirFsync", [&](void*) {
+        dropped = true;
+        ASSERT_OK(DeleteFilesInRange(db_, db_->DefaultColumnFamily(), nullptr,
+                                     nullptr));
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(db_->CompactBlobFiles(CompactBlobFilesOptions(),
+                                  db_->DefaultColumnFamily()));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_TRUE(dropped);
+  ASSERT_TRUE(GetBlobFiles().empty());
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_FILE_GC_NUM_FILES), 0);
+
+  // The DB is still writable, and the copy was deleted.
+  WriteKeys(0, 1, 2);
+  ASSERT_EQ(Get(Key(0)), Value(0, 2));
+  std::vector<std::string> files;
+  ASSERT_OK(env_->GetChildren(dbname_, &files));
+  size_t num_blob_files = 0;
+  for (const auto& file : files) {
+    uint64_t number = 0;
+    FileType type;
+    if (ParseFileName(file, &number, &type) && type == kBlobFile) {
+      ++num_blob_files;
+    }
+  }
+  ASSERT_EQ(num_blob_files, 1);
+
+  Reopen(options);
+  ASSERT_EQ(Get(Key(0)), Value(0, 2));
+  ASSERT_EQ(Get(Key(1)), "NOT_FOUND");
+}
+
+TEST_F(DBBlobFileGCTest, InvalidArguments) {
+  Options options = GetBlobOptions();
+  Reopen(options);
+
+  CompactBlobFilesOptions gc_options;
+  gc_options.garbage_ratio_threshold = 0.0;
+  ASSERT_TRUE(db_->CompactBlobFiles(gc_options, db_->DefaultColumnFamily())
+                  .IsInvalidArgument());
+  gc_options.garbage_ratio_threshold = 1.5;
+  ASSERT_TRUE(db_->CompactBlobFiles(gc_options, db_->DefaultColumnFamily())
+                  .IsInvalidArgument());
+  ASSERT_TRUE(db_->CompactBlobFiles(CompactBlobFilesOptions(), nullptr)
+                  .IsInvalidArgument());
+
+  // Without garbage, there is nothing to do.
+  WriteKeys(0, 10, 0);
+  ASSERT_OK(db_->CompactBlobFiles(CompactBlobFilesOptions(),
+                                  db_->DefaultColumnFamily()));
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_FILE_GC_NUM_FILES), 0);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  RegisterCustomObjects(argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -304,9 +304,11 @@ Compaction::Compaction(
       output_compression_(_compression),
       output_compression_opts_(_compression_opts),
       output_temperature_(_output_temperature),
-      deletion_compaction_(_compaction_reason == CompactionReason::kFIFOTtl ||
-                           _compaction_reason ==
-                               CompactionReason::kFIFOMaxSize),
+      deletion_compaction_(
+          _compaction_reason == CompactionReason::kFIFOTtl ||
+          _compaction_reason == CompactionReason::kFIFOMaxSize ||
+          _compaction_reason ==
+              CompactionReason::kFilesCoveredByRangeDeletion),
       l0_files_might_overlap_(l0_files_might_overlap),
       inputs_(PopulateWithAtomicBoundaries(vstorage, std::move(_inputs))),
       grandparents_(std::move(_grandparents)),
@@ -1092,10 +1094,6 @@ void Compaction::FilterInputsForCompactionIterator() {
     return;
   }
 
-  Slice rangedel_start_ukey = rangedel_candidate->smallest.user_key();
-  Slice rangedel_end_ukey = rangedel_candidate->largest.user_key();
-  SequenceNumber rangedel_seqno = rangedel_candidate->fd.smallest_seqno;
-
   std::vector<std::vector<FileMetaData*>> non_start_level_input_files;
   non_start_level_input_files.reserve(num_input_levels - 1);
   non_start_level_input_files_filtered_.reserve(num_input_levels - 1);
@@ -1104,14 +1102,7 @@ void Compaction::FilterInputsForCompactionIterator() {
     non_start_level_input_files_filtered_.emplace_back();
     for (FileMetaData* file : inputs_[level].files) {
       non_start_level_input_files_filtered_.back().push_back(false);
-      // When range data and point data has the same sequence number, point
-      // data wins. Range deletion end key is exclusive, so check it's bigger
-      // than file right boundary user key.
-      if (rangedel_seqno > file->fd.largest_seqno &&
-          ucmp->CompareWithoutTimestamp(rangedel_start_ukey,
-                                        file->smallest.user_key()) <= 0 &&
-          ucmp->CompareWithoutTimestamp(rangedel_end_ukey,
-                                        file->largest.user_key()) > 0) {
+      if (rangedel_candidate->StandAloneRangeTombstoneCovers(*file, ucmp)) {
         non_start_level_input_files_filtered_.back().back() = true;
         filtered_input_levels_[level].push_back(file);
       } else {
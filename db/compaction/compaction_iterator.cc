@@ -22,6 +22,129 @@
 #include "test_util/sync_point.h"
 
 namespace ROCKSDB_NAMESPACE {
+void SequenceIterWrapper::FillBatch() {
+  assert(batch_size_ > 0);
+  cur_buf_ ^= 1;
+  // Release what was pinned for the batch before the previous one, and pin
+  // whatever the wrapped iterator moves off during this one
+  PinnedIteratorsManager& pinned_mgr = pinned_mgrs_[cur_buf_];
+  if (pinned_mgr.PinningEnabled()) {
+    pinned_mgr.ReleasePinnedData();
+  }
+  pinned_mgr.StartPinning();
+  inner_iter_->SetPinnedItersMgr(&pinned_mgr);
+  std::string& copy_buf = copy_bufs_[cur_buf_];
+  copy_buf.clear();
+  copy_offsets_.clear();
+  keys_.clear();
+  values_.clear();
+  flags_.clear();
+  batch_pos_ = 0;
+
+  // The only per-entry calls into the wrapped iterator
+  size_t batch_bytes = 0;
+  while (flags_.size() < batch_size_ && batch_bytes < kMaxBatchBytes &&
+         inner_iter_->Valid()) {
+    const Slice k = inner_iter_->key();
+    const Slice v = inner_iter_->value();
+    uint8_t flags = 0;
+    // Sentinel keys are file boundaries rather than data of the iterator
+    if (inner_iter_->IsDeleteRangeSentinelKey()) {
+      flags = kSentinel | kKeyCopied | kValueCopied;
+    } else {
+      if (!inner_iter_->IsKeyPinned()) {
+        flags |= kKeyCopied;
+      }
+      if (!inner_iter_->IsValuePinned()) {
+        flags |= kValueCopied;
+      }
+    }
+    if (flags & kKeyCopied) {
+      copy_offsets_.push_back(copy_buf.size());
+      copy_buf.append(k.data(), k.size());
+    }
+    if (flags & kValueCopied) {
+      copy_offsets_.push_back(copy_buf.size());
+      copy_buf.append(v.data(), v.size());
+    }
+    keys_.push_back(k);
+    values_.push_back(v);
+    flags_.push_back(flags);
+    batch_bytes += k.size() + v.size();
+    inner_iter_->Next();
+  }
+  batch_count_ = flags_.size();
+  // Point the copied keys and values into the copy buffer, which no longer
+  // grows
+  size_t copied = 0;
+  for (size_t i = 0; i < batch_count_; ++i) {
+    if (flags_[i] & kKeyCopied) {
+      keys_[i] = Slice(copy_buf.data() + copy_offsets_[copied++],
+                       keys_[i].size());
+    }
+    if (flags_[i] & kValueCopied) {
+      values_[i] = Slice(copy_buf.data() + copy_offsets_[copied++],
+                         values_[i].size());
+    }
+  }
+  sequences_.resize(batch_count_);
+  types_.resize(batch_count_);
+  if (snapshots_ != nullptr) {
+    earliest_snapshots_.resize(batch_count_);
+    prev_snapshots_.resize(batch_count_);
+  }
+
+  const Comparator* ucmp = icmp_.user_comparator();
+  Slice prev_user_key = last_user_key_;
+  bool has_prev_user_key = has_last_user_key_;
+  bool prev_user_key_in_batch = false;
+  for (size_t i = 0; i < batch_count_; ++i) {
+    const char* k = keys_[i].data();
+    const size_t n = keys_[i].size();
+    uint8_t flags = flags_[i];
+    if (n >= kNumInternalBytes) {
+      const uint64_t packed = DecodeFixed64(k + n - kNumInternalBytes);
+      const ValueType type = static_cast<ValueType>(packed & 0xff);
+      if (IsExtendedValueType(type)) {
+        flags |= kParsed;
+        sequences_[i] = packed >> 8;
+        types_[i] = type;
+      }
+    }
+    if ((flags & kParsed) == 0) {
+      // Left for the consumer to report. Nothing after it is compared.
+      flags_[i] = flags;
+      has_prev_user_key = false;
+      continue;
+    }
+    const Slice user_key(k, n - kNumInternalBytes);
+    if ((flags & kSentinel) == 0) {
+      if (has_prev_user_key) {
+        const UserKeyMatch match =
+            ucmp->EqualWithoutTimestamp(user_key, prev_user_key)
+                ? UserKeyMatch::kSame
+                : UserKeyMatch::kDifferent;
+        flags |= static_cast<uint8_t>(match) << kMatchShift;
+      }
+      prev_user_key = user_key;
+      has_prev_user_key = true;
+      prev_user_key_in_batch = true;
+    }
+    flags_[i] = flags;
+    if (snapshots_ != nullptr) {
+      auto it = std::lower_bound(snapshots_->begin(), snapshots_->end(),
+                                 sequences_[i]);
+      earliest_snapshots_[i] = it != snapshots_->end() ? *it
+                                                       : kMaxSequenceNumber;
+      prev_snapshots_[i] = it == snapshots_->begin() ? 0 : *std::prev(it);
+    }
+  }
+  if (prev_user_key_in_batch) {
+    last_user_key_.assign(prev_user_key.data(), prev_user_key.size());
+  }
+  has_last_user_key_ = has_prev_user_key;
+}
+
 CompactionIterator::CompactionIterator(
     InternalIterator* input, const Comparator* cmp, MergeHelper* merge_helper,
     SequenceNumber last_sequence, std::vector<SequenceNumber>* snapshots,
@@ -38,7 +161,7 @@ CompactionIterator::CompactionIterator(
     const std::atomic<bool>* shutting_down,
     const std::shared_ptr<Logger> info_log,
     const std::string* full_history_ts_low,
-    std::optional<SequenceNumber> preserve_seqno_min)
+    std::optional<SequenceNumber> preserve_seqno_min, size_t input_batch_size)
     : CompactionIterator(
           input, cmp, merge_helper, last_sequence, snapshots, earliest_snapshot,
           earliest_write_conflict_snapshot, job_snapshot, snapshot_checker, env,
@@ -47,7 +170,7 @@ CompactionIterator::CompactionIterator(
           manual_compaction_canceled,
           compaction ? std::make_unique<RealCompaction>(compaction) : nullptr,
           must_count_input_entries, compaction_filter, shutting_down, info_log,
-          full_history_ts_low, preserve_seqno_min) {}
+          full_history_ts_low, preserve_seqno_min, input_batch_size) {}
 
 CompactionIterator::CompactionIterator(
     InternalIterator* input, const Comparator* cmp, MergeHelper* merge_helper,
@@ -65,8 +188,14 @@ CompactionIterator::CompactionIterator(
     const std::atomic<bool>* shutting_down,
     const std::shared_ptr<Logger> info_log,
     const std::string* full_history_ts_low,
-    std::optional<SequenceNumber> preserve_seqno_min)
-    : input_(input, cmp, must_count_input_entries),
+    std::optional<SequenceNumber> preserve_seqno_min, size_t input_batch_size)
+    : input_(input, cmp, must_count_input_entries, input_batch_size,
+             // Without a snapshot checker, the earliest visible snapshot only
+             // depends on the sequence number
+             snapshot_checker == nullptr && snapshots != nullptr &&
+                     !snapshots->empty()
+                 ? snapshots
+                 : nullptr),
       cmp_(cmp),
       merge_helper_(merge_helper),
       snapshots_(snapshots),
@@ -459,7 +588,7 @@ void CompactionIterator::NextFromInput() {
     iter_stats_.num_input_records++;
     is_range_del_ = input_.IsDeleteRangeSentinelKey();
 
-    Status pik_status = ParseInternalKey(key_, &ikey_, allow_data_in_errors_);
+    Status pik_status = ParseInputKey(&ikey_);
     if (!pik_status.ok()) {
       iter_stats_.num_input_corrupt_records++;
 
@@ -492,8 +621,21 @@ void CompactionIterator::NextFromInput() {
     bool user_key_equal_without_ts = false;
     int cmp_ts = 0;
     if (has_current_user_key_) {
-      user_key_equal_without_ts =
-          cmp_->EqualWithoutTimestamp(ikey_.user_key, current_user_key_);
+      // current_user_key_ is always that of the previous non-sentinel input
+      // entry, so the input batch may have compared them already.
+      switch (input_.MatchPreviousUserKey()) {
+        case SequenceIterWrapper::UserKeyMatch::kSame:
+          user_key_equal_without_ts = true;
+          break;
+        case SequenceIterWrapper::UserKeyMatch::kDifferent:
+          user_key_equal_without_ts = false;
+          break;
+        default:
+          user_key_equal_without_ts =
+              cmp_->EqualWithoutTimestamp(ikey_.user_key, current_user_key_);
+      }
+      assert(user_key_equal_without_ts ==
+             cmp_->EqualWithoutTimestamp(ikey_.user_key, current_user_key_));
       // if timestamp_size_ > 0, then curr_ts_ has been initialized by a
       // previous key.
       cmp_ts = timestamp_size_ ? cmp_->CompareTimestamp(
@@ -593,10 +735,13 @@ void CompactionIterator::NextFromInput() {
     current_user_key_sequence_ = ikey_.sequence;
     SequenceNumber last_snapshot = current_user_key_snapshot_;
     SequenceNumber prev_snapshot = 0;  // 0 means no previous snapshot
-    current_user_key_snapshot_ =
-        visible_at_tip_
-            ? earliest_snapshot_
-            : findEarliestVisibleSnapshot(ikey_.sequence, &prev_snapshot);
+    if (visible_at_tip_) {
+      current_user_key_snapshot_ = earliest_snapshot_;
+    } else if (!input_.GetEarliestVisibleSnapshot(&current_user_key_snapshot_,
+                                                  &prev_snapshot)) {
+      current_user_key_snapshot_ =
+          findEarliestVisibleSnapshot(ikey_.sequence, &prev_snapshot);
+    }
 
     if (need_skip) {
       // This case is handled below.
@@ -699,8 +844,7 @@ void CompactionIterator::NextFromInput() {
       ParsedInternalKey next_ikey;
       AdvanceInputIter();
       while (input_.Valid() && input_.IsDeleteRangeSentinelKey() &&
-             ParseInternalKey(input_.key(), &next_ikey, allow_data_in_errors_)
-                 .ok() &&
+             ParseInputKey(&next_ikey).ok() &&
              cmp_->EqualWithoutTimestamp(ikey_.user_key, next_ikey.user_key)) {
         // skip range tombstone start keys with the same user key
         // since they are not "real" point keys.
@@ -709,9 +853,7 @@ void CompactionIterator::NextFromInput() {
 
       // Check whether the next key exists, is not corrupt, and is the same key
       // as the single delete.
-      if (input_.Valid() &&
-          ParseInternalKey(input_.key(), &next_ikey, allow_data_in_errors_)
-              .ok() &&
+      if (input_.Valid() && ParseInputKey(&next_ikey).ok() &&
           cmp_->EqualWithoutTimestamp(ikey_.user_key, next_ikey.user_key)) {
         assert(!input_.IsDeleteRangeSentinelKey());
 #ifndef NDEBUG
@@ -960,9 +1102,7 @@ void CompactionIterator::NextFromInput() {
       //
       // Range tombstone start keys are skipped as they are not "real" keys.
       while (!IsPausingManualCompaction() && !IsShuttingDown() &&
-             input_.Valid() &&
-             (ParseInternalKey(input_.key(), &next_ikey, allow_data_in_errors_)
-                  .ok()) &&
+             input_.Valid() && (ParseInputKey(&next_ikey).ok()) &&
              cmp_->EqualWithoutTimestamp(ikey_.user_key, next_ikey.user_key) &&
              (prev_snapshot == 0 || input_.IsDeleteRangeSentinelKey() ||
               DefinitelyNotInSnapshot(next_ikey.sequence, prev_snapshot))) {
@@ -970,9 +1110,7 @@ void CompactionIterator::NextFromInput() {
       }
       // If you find you still need to output a row with this key, we need to
       // output the delete too
-      if (input_.Valid() &&
-          (ParseInternalKey(input_.key(), &next_ikey, allow_data_in_errors_)
-               .ok()) &&
+      if (input_.Valid() && (ParseInputKey(&next_ikey).ok()) &&
           cmp_->EqualWithoutTimestamp(ikey_.user_key, next_ikey.user_key)) {
         validity_info_.SetValid(ValidContext::kKeepDel);
         at_next_ = true;
@@ -28,36 +28,86 @@ class PrefetchBufferCollection;
 
 // A wrapper of internal iterator whose purpose is to count how
 // many entries there are in the iterator.
+//
+// With a non-zero batch_size, it also reads up to batch_size entries at a time
+// from the wrapped iterator into a columnar buffer, and then parses the keys,
+// detects user key changes and (given snapshots) finds the earliest visible
+// snapshot of each entry in one tight loop over the batch. CompactionIterator
+// consumes those results instead of redoing the work per entry. The wrapped
+// iterator must already be positioned when the wrapper is constructed.
 class SequenceIterWrapper : public InternalIterator {
  public:
+  // How an entry's user key (without timestamp) compares to that of the
+  // previous non-sentinel entry read from this iterator
+  enum class UserKeyMatch : uint8_t { kUnknown, kSame, kDifferent };
+
   SequenceIterWrapper(InternalIterator* iter, const Comparator* cmp,
-                      bool need_count_entries)
+                      bool need_count_entries, size_t batch_size = 0,
+                      const std::vector<SequenceNumber>* snapshots = nullptr)
       : icmp_(cmp),
         inner_iter_(iter),
-        need_count_entries_(need_count_entries) {}
-  bool Valid() const override { return inner_iter_->Valid(); }
-  Status status() const override { return inner_iter_->status(); }
+        need_count_entries_(need_count_entries),
+        batch_size_(batch_size),
+        snapshots_(snapshots) {
+    if (batch_size_ > 0) {
+      FillBatch();
+    }
+  }
+  ~SequenceIterWrapper() override {
+    if (batch_size_ > 0) {
+      // inner_iter_ outlives pinned_mgrs_
+      inner_iter_->SetPinnedItersMgr(nullptr);
+    }
+  }
+  bool Valid() const override {
+    return batch_size_ == 0 ? inner_iter_->Valid() : batch_pos_ < batch_count_;
+  }
+  Status status() const override {
+    return batch_pos_ < batch_count_ ? Status::OK() : inner_iter_->status();
+  }
   void Next() override {
-    if (!inner_iter_->IsDeleteRangeSentinelKey()) {
+    if (batch_size_ == 0) {
+      if (!inner_iter_->IsDeleteRangeSentinelKey()) {
+        num_itered_++;
+      }
+      inner_iter_->Next();
+      return;
+    }
+    if ((flags_[batch_pos_] & kSentinel) == 0) {
       num_itered_++;
     }
-    inner_iter_->Next();
+    if (++batch_pos_ == batch_count_) {
+      FillBatch();
+    }
   }
   void Seek(const Slice& target) override {
     if (!need_count_entries_) {
       has_num_itered_ = false;
       inner_iter_->Seek(target);
+      if (batch_size_ > 0) {
+        has_last_user_key_ = false;
+        FillBatch();
+      }
     } else {
       // Need to count total number of entries,
       // so we do Next() rather than Seek().
-      while (inner_iter_->Valid() &&
-             icmp_.Compare(inner_iter_->key(), target) < 0) {
+      while (Valid() && icmp_.Compare(key(), target) < 0) {
         Next();
       }
     }
   }
-  Slice key() const override { return inner_iter_->key(); }
-  Slice value() const override { return inner_iter_->value(); }
+  Slice key() const override {
+    if (batch_size_ == 0) {
+      return inner_iter_->key();
+    }
+    return keys_[batch_pos_];
+  }
+  Slice value() const override {
+    if (batch_size_ == 0) {
+      return inner_iter_->value();
+    }
+    return values_[batch_pos_];
+  }
 
   // Unused InternalIterator methods
   void SeekToFirst() override { assert(false); }
@@ -69,15 +119,88 @@ class SequenceIterWrapper : public InternalIterator {
   bool HasNumItered() const { return has_num_itered_; }
   bool IsDeleteRangeSentinelKey() const override {
     assert(Valid());
-    return inner_iter_->IsDeleteRangeSentinelKey();
+    if (batch_size_ == 0) {
+      return inner_iter_->IsDeleteRangeSentinelKey();
+    }
+    return (flags_[batch_pos_] & kSentinel) != 0;
+  }
+
+  // Results precomputed for the current entry in batch mode. Each returns
+  // false (or kUnknown) if not available, in which case the caller has to
+  // compute it.
+  bool GetParsedKey(ParsedInternalKey* ikey) const {
+    if (batch_size_ == 0 || (flags_[batch_pos_] & kParsed) == 0) {
+      return false;
+    }
+    const Slice k = key();
+    ikey->user_key = Slice(k.data(), k.size() - kNumInternalBytes);
+    ikey->sequence = sequences_[batch_pos_];
+    ikey->type = types_[batch_pos_];
+    return true;
+  }
+  UserKeyMatch MatchPreviousUserKey() const {
+    if (batch_size_ == 0) {
+      return UserKeyMatch::kUnknown;
+    }
+    return static_cast<UserKeyMatch>((flags_[batch_pos_] >> kMatchShift) &
+                                     kMatchMask);
+  }
+  bool GetEarliestVisibleSnapshot(SequenceNumber* snapshot,
+                                  SequenceNumber* prev_snapshot) const {
+    if (batch_size_ == 0 || snapshots_ == nullptr ||
+        (flags_[batch_pos_] & kParsed) == 0) {
+      return false;
+    }
+    *snapshot = earliest_snapshots_[batch_pos_];
+    *prev_snapshot = prev_snapshots_[batch_pos_];
+    return true;
   }
 
  private:
+  // Bits of flags_, with a UserKeyMatch at kMatchShift
+  static constexpr uint8_t kSentinel = 1;
+  static constexpr uint8_t kParsed = 2;
+  static constexpr int kMatchShift = 2;
+  static constexpr uint8_t kMatchMask = 3;
+  static constexpr uint8_t kKeyCopied = 1 << 4;
+  static constexpr uint8_t kValueCopied = 1 << 5;
+  // Stop filling a batch early past this many bytes of keys and values
+  static constexpr size_t kMaxBatchBytes = size_t{1} << 20;
+
+  void FillBatch();
+
   InternalKeyComparator icmp_;
   InternalIterator* inner_iter_;  // not owned
   uint64_t num_itered_ = 0;
   bool need_count_entries_;
   bool has_num_itered_ = true;
+
+  // Batch mode state
+  const size_t batch_size_;
+  // Sorted, or nullptr to not precompute earliest visible snapshots
+  const std::vector<SequenceNumber>* const snapshots_;
+  size_t batch_pos_ = 0;
+  size_t batch_count_ = 0;
+  // Keys and values of a batch are kept where the wrapped iterator has them,
+  // pinned by one of two alternating PinnedIteratorsManagers, or otherwise
+  // copied into one of two alternating buffers. Either way, the last entry of
+  // a batch stays readable after moving into the next one, as the wrapped
+  // iterator's would (e.g. for a SingleDelete peeking ahead).
+  int cur_buf_ = 0;
+  PinnedIteratorsManager pinned_mgrs_[2];
+  std::string copy_bufs_[2];
+  std::vector<Slice> keys_;
+  std::vector<Slice> values_;
+  // Offsets into the copy buffer of the copied keys and values, in order
+  std::vector<size_t> copy_offsets_;
+  std::vector<SequenceNumber> sequences_;
+  std::vector<ValueType> types_;
+  std::vector<uint8_t> flags_;
+  std::vector<SequenceNumber> earliest_snapshots_;
+  std::vector<SequenceNumber> prev_snapshots_;
+  // User key of the last non-sentinel entry of previous batches
+  std::string last_user_key_;
+  bool has_last_user_key_ = false;
 };
 
 class CompactionIterator {
@@ -183,6 +306,8 @@ class CompactionIterator {
     const Compaction* compaction_;
   };
 
+  // @param input_batch_size  if non-zero, input is read this many entries at a
+  // time (see SequenceIterWrapper), with identical output.
   // @param must_count_input_entries  if true, `NumInputEntryScanned()` will
   // return the number of input keys scanned. If false, `NumInputEntryScanned()`
   // will return this number if no Seek was called on `input`. User should call
@@ -203,7 +328,8 @@ class CompactionIterator {
       const std::atomic<bool>* shutting_down = nullptr,
       const std::shared_ptr<Logger> info_log = nullptr,
       const std::string* full_history_ts_low = nullptr,
-      std::optional<SequenceNumber> preserve_seqno_min = {});
+      std::optional<SequenceNumber> preserve_seqno_min = {},
+      size_t input_batch_size = 0);
 
   // Constructor with custom CompactionProxy, used for tests.
   CompactionIterator(InternalIterator* input, const Comparator* cmp,
@@ -225,7 +351,8 @@ class CompactionIterator {
                      const std::atomic<bool>* shutting_down = nullptr,
                      const std::shared_ptr<Logger> info_log = nullptr,
                      const std::string* full_history_ts_low = nullptr,
-                     std::optional<SequenceNumber> preserve_seqno_min = {});
+                     std::optional<SequenceNumber> preserve_seqno_min = {},
+                     size_t input_batch_size = 0);
 
   ~CompactionIterator();
 
@@ -482,6 +609,15 @@ class CompactionIterator {
 
   void AdvanceInputIter() { input_.Next(); }
 
+  // Parses the current input key, or takes it as already parsed by the input
+  // batch
+  Status ParseInputKey(ParsedInternalKey* ikey) {
+    if (input_.GetParsedKey(ikey)) {
+      return Status::OK();
+    }
+    return ParseInternalKey(input_.key(), ikey, allow_data_in_errors_);
+  }
+
   void SkipUntil(const Slice& skip_until) { input_.Seek(skip_until); }
 
   bool IsShuttingDown() {
@@ -12,6 +12,7 @@
 #include "port/port.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
+#include "util/random.h"
 #include "util/string_util.h"
 #include "util/vector_iterator.h"
 #include "utilities/merge_operators.h"
@@ -138,20 +139,40 @@ class LoggingForwardVectorIterator : public VectorIterator {
   void Next() override {
     assert(Valid());
     log.emplace_back(Action::Type::NEXT);
+    // Clobber what an unpinned key and value pointed to
+    key_scratch_.assign(key_scratch_.size(), '\0');
+    value_scratch_.assign(value_scratch_.size(), '\0');
     VectorIterator::Next();
   }
   void Prev() override { assert(false); }
 
   Slice key() const override {
     assert(Valid());
+    if (!pinned) {
+      key_scratch_ = VectorIterator::key().ToString();
+      return key_scratch_;
+    }
     return VectorIterator::key();
   }
   Slice value() const override {
     assert(Valid());
+    if (!pinned) {
+      value_scratch_ = VectorIterator::value().ToString();
+      return value_scratch_;
+    }
     return VectorIterator::value();
   }
 
+  bool IsKeyPinned() const override { return pinned; }
+  bool IsValuePinned() const override { return pinned; }
+
   std::vector<Action> log;
+  // Whether key() and value() stay valid after moving on
+  bool pinned = true;
+
+ private:
+  mutable std::string key_scratch_;
+  mutable std::string value_scratch_;
 };
 
 class FakeCompaction : public CompactionIterator::CompactionProxy {
@@ -288,6 +309,7 @@ class CompactionIteratorTest : public testing::TestWithParam<bool> {
       c_iter_.reset();
     }
     iter_.reset(new LoggingForwardVectorIterator(ks, vs));
+    iter_->pinned = input_pinned_;
     iter_->SeekToFirst();
     c_iter_.reset(new CompactionIterator(
         iter_.get(), cmp_, merge_helper_.get(), last_sequence, &snapshots_,
@@ -299,7 +321,8 @@ class CompactionIteratorTest : public testing::TestWithParam<bool> {
         true /*enforce_single_del_contracts*/,
         /*manual_compaction_canceled=*/kManualCompactionCanceledFalse_,
         std::move(compaction), /*must_count_input_entries=*/false, filter,
-        &shutting_down_, /*info_log=*/nullptr, full_history_ts_low));
+        &shutting_down_, /*info_log=*/nullptr, full_history_ts_low,
+        /*preserve_seqno_min=*/{}, input_batch_size_));
   }
 
   void AddSnapshot(SequenceNumber snapshot,
@@ -361,6 +384,8 @@ class CompactionIteratorTest : public testing::TestWithParam<bool> {
   std::atomic<bool> shutting_down_{false};
   const std::atomic<bool> kManualCompactionCanceledFalse_{false};
   FakeCompaction* compaction_proxy_;
+  size_t input_batch_size_ = 0;
+  bool input_pinned_ = true;
 };
 
 // It is possible that the output of the compaction iterator is empty even if
@@ -831,6 +856,66 @@ TEST_P(CompactionIteratorTest, ZeroSeqOfKeyAndSnapshot) {
   RunTest(input_keys, input_values, input_keys, input_values);
 }
 
+// Reading input in batches of any size, pinned or not, must not change the
+// output.
+TEST_P(CompactionIteratorTest, BatchedInput) {
+  Random rnd(301);
+  std::vector<std::string> ks;
+  std::vector<std::string> vs;
+  SequenceNumber seq = 400;
+  for (int k = 0; k < 50; ++k) {
+    const std::string user_key = "key" + std::to_string(1000 + k);
+    const bool single_del = rnd.OneIn(4);
+    const int versions = 1 + static_cast<int>(rnd.Uniform(5));
+    for (int v = 0; v < versions; ++v) {
+      ValueType type = kTypeValue;
+      if (single_del) {
+        type = rnd.OneIn(2) ? kTypeSingleDeletion : kTypeValue;
+      } else if (rnd.OneIn(4)) {
+        type = kTypeDeletion;
+      } else if (rnd.OneIn(3)) {
+        type = kTypeMerge;
+      }
+      ks.push_back(test::KeyStr(user_key, seq--, type));
+      vs.push_back(type == kTypeDeletion || type == kTypeSingleDeletion
+                       ? ""
+                       : rnd.RandomString(8));
+    }
+  }
+  AddSnapshot(150);
+  AddSnapshot(250);
+  AddSnapshot(300);
+
+  auto merge_op = MergeOperators::CreateStringAppendOperator();
+  for (bool bottommost_level : {false, true}) {
+    std::vector<std::string> expected;
+    for (bool input_pinned : {true, false}) {
+      for (size_t batch_size : {0, 1, 2, 7, 1000}) {
+        SCOPED_TRACE("input_pinned = " + std::to_string(input_pinned) +
+                     ", batch_size = " + std::to_string(batch_size));
+        input_pinned_ = input_pinned;
+        input_batch_size_ = batch_size;
+        InitIterators(ks, vs,
+                      {test::KeyStr("key1010", 200, kTypeRangeDeletion)},
+                      {"key1020"}, kMaxSequenceNumber, kMaxSequenceNumber,
+                      merge_op.get(), nullptr, bottommost_level);
+        std::vector<std::string> output;
+        for (c_iter_->SeekToFirst(); c_iter_->Valid(); c_iter_->Next()) {
+          output.push_back(c_iter_->key().ToString() + "=" +
+                           c_iter_->value().ToString());
+        }
+        ASSERT_OK(c_iter_->status());
+        if (expected.empty()) {
+          ASSERT_FALSE(output.empty());
+          expected = output;
+        } else {
+          ASSERT_EQ(expected, output);
+        }
+      }
+    }
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(CompactionIteratorTestInstance, CompactionIteratorTest,
                         testing::Values(true, false));
 
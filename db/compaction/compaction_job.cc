@@ -101,6 +101,8 @@ const char* GetCompactionReasonString(CompactionReason compaction_reason) {
       return "RoundRobinTtl";
     case CompactionReason::kRefitLevel:
       return "RefitLevel";
+    case CompactionReason::kFilesCoveredByRangeDeletion:
+      return "FilesCoveredByRangeDeletion";
     case CompactionReason::kNumOfReasons:
       // fall through
     default:
@@ -1110,6 +1112,12 @@ Status CompactionJob::Install(bool* compaction_released) {
     stream << "file_fsync_nanos" << job_stats_->file_fsync_nanos;
     stream << "file_prepare_write_nanos"
            << job_stats_->file_prepare_write_nanos;
+    stream << "output_data_blocks_finish_nanos"
+           << job_stats_->output_data_blocks_finish_nanos;
+    stream << "output_filter_finish_nanos"
+           << job_stats_->output_filter_finish_nanos;
+    stream << "output_index_finish_nanos"
+           << job_stats_->output_index_finish_nanos;
   }
 
   stream << "lsm_state";
@@ -1405,7 +1413,9 @@ std::unique_ptr<CompactionIterator> CompactionJob::CreateCompactionIterator(
       db_options_.enforce_single_del_contracts, manual_compaction_canceled_,
       sub_compact->compaction->DoesInputReferenceBlobFiles(),
       sub_compact->compaction, compaction_filter, shutting_down_,
-      db_options_.info_log, full_history_ts_low, preserve_seqno_after_);
+      db_options_.info_log, full_history_ts_low, preserve_seqno_after_,
+      sub_compact->compaction->mutable_cf_options()
+          .compaction_iterator_batch_size);
 }
 
 std::pair<CompactionFileOpenFunc, CompactionFileCloseFunc>
@@ -1855,6 +1865,15 @@ Status CompactionJob::FinishCompactionOutputFile(
   TEST_SYNC_POINT_CALLBACK(
       "CompactionJob::FinishCompactionOutputFile()::AfterFinish", &s);
 
+  if (s.ok() && measure_io_stats_) {
+    const TableBuilderFinishTimes finish_times = outputs.GetFinishTimes();
+    CompactionJobStats& job_stats = sub_compact->compaction_job_stats;
+    job_stats.output_data_blocks_finish_nanos +=
+        finish_times.data_blocks_nanos;
+    job_stats.output_filter_finish_nanos += finish_times.filter_nanos;
+    job_stats.output_index_finish_nanos += finish_times.index_nanos;
+  }
+
   if (s.ok()) {
     // With accurate smallest and largest key, we can get a slightly more
     // accurate oldest ancester time.
@@ -2246,6 +2265,13 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
       0 /* oldest_key_time */, current_time, db_id_, db_session_id_,
       sub_compact->compaction->max_output_file_size(), file_number,
       proximal_after_seqno_ /*last_level_inclusive_max_seqno_threshold*/);
+  tboptions.adaptive_filter_bits_per_key =
+      sub_compact->compaction->input_version()
+          ->storage_info()
+          ->GetAdaptiveFilterBitsPerKey(
+              sub_compact->compaction->mutable_cf_options()
+                  .filter_memory_budget_bits_per_key,
+              sub_compact->compaction->output_level());
 
   outputs.NewBuilder(tboptions);
 
@@ -128,6 +128,10 @@ class CompactionOutputs {
     return builder_->GetTableProperties();
   }
 
+  TableBuilderFinishTimes GetFinishTimes() const {
+    return builder_->GetFinishTimes();
+  }
+
   Slice SmallestUserKey() const {
     if (!outputs_.empty() && outputs_[0].finished) {
       return outputs_[0].meta.smallest.user_key();
@@ -9,12 +9,16 @@
 
 #include "db/compaction/compaction_picker_level.h"
 
+#include <cinttypes>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "db/snapshot_checker.h"
 #include "db/version_edit.h"
 #include "logging/log_buffer.h"
+#include "logging/logging.h"
 #include "test_util/sync_point.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -36,6 +40,9 @@ bool LevelCompactionPicker::NeedsCompaction(
   if (!vstorage->FilesMarkedForForcedBlobGC().empty()) {
     return true;
   }
+  if (!vstorage->FilesCoveredByRangeTombstones().empty()) {
+    return true;
+  }
   for (int i = 0; i <= vstorage->MaxInputLevel(); i++) {
     if (vstorage->CompactionScore(i) >= 1) {
       return true;
@@ -61,18 +68,34 @@ class LevelCompactionBuilder {
                          LogBuffer* log_buffer,
                          const MutableCFOptions& mutable_cf_options,
                          const ImmutableOptions& ioptions,
-                         const MutableDBOptions& mutable_db_options)
+                         const MutableDBOptions& mutable_db_options,
+                         const std::vector<SequenceNumber>& existing_snapshots,
+                         const SnapshotChecker* snapshot_checker)
       : cf_name_(cf_name),
         vstorage_(vstorage),
         compaction_picker_(compaction_picker),
         log_buffer_(log_buffer),
         mutable_cf_options_(mutable_cf_options),
         ioptions_(ioptions),
-        mutable_db_options_(mutable_db_options) {}
+        mutable_db_options_(mutable_db_options) {
+    // These parameters are only passed when user-defined timestamp is not
+    // enabled.
+    if (vstorage_->user_comparator()->timestamp_size() == 0) {
+      earliest_snapshot_ = existing_snapshots.empty()
+                               ? kMaxSequenceNumber
+                               : existing_snapshots.at(0);
+      snapshot_checker_ = snapshot_checker;
+    }
+  }
 
   // Pick and return a compaction.
   Compaction* PickCompaction();
 
+  // Pick files that standalone range tombstone files in higher levels cover
+  // and no snapshot can see, all from the same level, and return a deletion
+  // compaction dropping them. Returns nullptr if there are none.
+  Compaction* PickFilesCoveredByRangeTombstones();
+
   // Pick the initial files to compact to the next level. (or together
   // in Intra-L0 compactions)
   void SetupInitialFiles();
@@ -155,6 +178,8 @@ class LevelCompactionBuilder {
   const MutableCFOptions& mutable_cf_options_;
   const ImmutableOptions& ioptions_;
   const MutableDBOptions& mutable_db_options_;
+  std::optional<SequenceNumber> earliest_snapshot_;
+  const SnapshotChecker* snapshot_checker_ = nullptr;
   // Pick a path ID to place a newly generated file, with its level
   static uint32_t GetPathId(const ImmutableCFOptions& ioptions,
                             const MutableCFOptions& mutable_cf_options,
@@ -507,6 +532,13 @@ bool LevelCompactionBuilder::SetupOtherInputsIfNeeded() {
 }
 
 Compaction* LevelCompactionBuilder::PickCompaction() {
+  // Dropping covered files only takes a manifest write and makes the other
+  // compactions cheaper, so it goes first.
+  Compaction* c = PickFilesCoveredByRangeTombstones();
+  if (c != nullptr) {
+    return c;
+  }
+
   // Pick up the first file to start compaction. It may have been extended
   // to a clean cut.
   SetupInitialFiles();
@@ -528,13 +560,57 @@ Compaction* LevelCompactionBuilder::PickCompaction() {
   }
 
   // Form a compaction object containing the files we picked.
-  Compaction* c = GetCompaction();
+  c = GetCompaction();
 
   TEST_SYNC_POINT_CALLBACK("LevelCompactionPicker::PickCompaction:Return", c);
 
   return c;
 }
 
+Compaction* LevelCompactionBuilder::PickFilesCoveredByRangeTombstones() {
+  if (!earliest_snapshot_.has_value()) {
+    return nullptr;
+  }
+  CompactionInputFiles inputs;
+  uint64_t total_size = 0;
+  for (const auto& covered : vstorage_->FilesCoveredByRangeTombstones()) {
+    if (!inputs.empty() && covered.level != inputs.level) {
+      break;
+    }
+    assert(!covered.file->being_compacted);
+    // A snapshot older than the range tombstone still sees the file.
+    if (!DataIsDefinitelyInSnapshot(covered.tombstone_seqno,
+                                    earliest_snapshot_.value(),
+                                    snapshot_checker_)) {
+      continue;
+    }
+    inputs.level = covered.level;
+    inputs.files.push_back(covered.file);
+    total_size += covered.file->fd.GetFileSize();
+  }
+  if (inputs.empty()) {
+    return nullptr;
+  }
+
+  ROCKS_LOG_BUFFER(log_buffer_,
+                   "[%s] Dropping %" ROCKSDB_PRIszt " files of level %d with "
+                   "%" PRIu64 " bytes covered by range tombstones",
+                   cf_name_.c_str(), inputs.size(), inputs.level, total_size);
+  const int level = inputs.level;
+  std::vector<CompactionInputFiles> compaction_inputs{std::move(inputs)};
+  auto c = new Compaction(
+      vstorage_, ioptions_, mutable_cf_options_, mutable_db_options_,
+      std::move(compaction_inputs), level, 0, 0, 0, kNoCompression,
+      mutable_cf_options_.compression_opts,
+      mutable_cf_options_.default_write_temperature,
+      /* max_subcompactions */ 0, {}, /* earliest_snapshot */ std::nullopt,
+      /* snapshot_checker */ nullptr,
+      CompactionReason::kFilesCoveredByRangeDeletion);
+  compaction_picker_->RegisterCompaction(c);
+  vstorage_->ComputeCompactionScore(ioptions_, mutable_cf_options_);
+  return c;
+}
+
 Compaction* LevelCompactionBuilder::GetCompaction() {
   // TryPickL0TrivialMove() does not apply to the case when compacting L0 to an
   // empty output level. So L0 files is picked in PickFileToCompact() by
@@ -559,8 +635,7 @@ Compaction* LevelCompactionBuilder::GetCompaction() {
       GetCompressionOptions(mutable_cf_options_, vstorage_, output_level_),
       mutable_cf_options_.default_write_temperature,
       /* max_subcompactions */ 0, std::move(grandparents_),
-      /* earliest_snapshot */ std::nullopt, /* snapshot_checker */ nullptr,
-      compaction_reason_,
+      earliest_snapshot_, snapshot_checker_, compaction_reason_,
       /* trim_ts */ "", start_level_score_, l0_files_might_overlap);
 
   // If it's level 0 compaction, make sure we don't execute any other level 0
@@ -974,12 +1049,13 @@ bool LevelCompactionBuilder::PickSizeBasedIntraL0Compaction() {
 Compaction* LevelCompactionPicker::PickCompaction(
     const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
     const MutableDBOptions& mutable_db_options,
-    const std::vector<SequenceNumber>& /*existing_snapshots */,
-    const SnapshotChecker* /*snapshot_checker*/, VersionStorageInfo* vstorage,
+    const std::vector<SequenceNumber>& existing_snapshots,
+    const SnapshotChecker* snapshot_checker, VersionStorageInfo* vstorage,
     LogBuffer* log_buffer, bool /* require_max_output_level*/) {
   LevelCompactionBuilder builder(cf_name, vstorage, this, log_buffer,
                                  mutable_cf_options, ioptions_,
-                                 mutable_db_options);
+                                 mutable_db_options, existing_snapshots,
+                                 snapshot_checker);
   return builder.PickCompaction();
 }
 }  // namespace ROCKSDB_NAMESPACE
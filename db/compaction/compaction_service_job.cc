@@ -725,6 +725,18 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct CompactionJobStats, file_prepare_write_nanos),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"output_data_blocks_finish_nanos",
+         {offsetof(struct CompactionJobStats, output_data_blocks_finish_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"output_filter_finish_nanos",
+         {offsetof(struct CompactionJobStats, output_filter_finish_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"output_index_finish_nanos",
+         {offsetof(struct CompactionJobStats, output_index_finish_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"smallest_output_key_prefix",
          {offsetof(struct CompactionJobStats, smallest_output_key_prefix),
           OptionType::kEncodedString, OptionVerificationType::kNormal,
@@ -1157,6 +1157,64 @@ TEST_F(DBBasicTest, MultiGetSimple) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBasicTest, MultiGetPinned) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  Reopen(options);
+  ASSERT_OK(Put("k1", "sst1"));
+  ASSERT_OK(Put("k2", "sst2"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("k2", "mem2"));
+  ASSERT_OK(Put("k3", "mem3"));
+  ASSERT_OK(Put("k4", "mem4"));
+
+  std::array<Slice, 5> keys{{"k1", "k2", "k3", "k4", "no_key"}};
+  std::array<PinnableSlice, 5> values;
+  std::array<Status, 5> statuses;
+
+  db_->MultiGetPinned(ReadOptions(), db_->DefaultColumnFamily(), keys.size(),
+                      keys.data(), values.data(), statuses.data(),
+                      /*max_pinned_bytes=*/1 << 20);
+  ASSERT_OK(statuses[0]);
+  ASSERT_EQ(values[0], "sst1");
+  ASSERT_OK(statuses[1]);
+  ASSERT_EQ(values[1], "mem2");
+  ASSERT_OK(statuses[2]);
+  ASSERT_EQ(values[2], "mem3");
+  ASSERT_OK(statuses[3]);
+  ASSERT_EQ(values[3], "mem4");
+  ASSERT_TRUE(statuses[4].IsNotFound());
+  // Memtable values are referenced in place
+  ASSERT_TRUE(values[1].IsPinned());
+  ASSERT_TRUE(values[2].IsPinned());
+  ASSERT_TRUE(values[3].IsPinned());
+
+  // And remain valid after the memtable is flushed and the db is written
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("k3", "new3"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(values[1], "mem2");
+  ASSERT_EQ(values[2], "mem3");
+  ASSERT_EQ(values[3], "mem4");
+  for (auto& value : values) {
+    value.Reset();
+  }
+
+  // Values beyond the cap are copied
+  ASSERT_OK(Put("k1", "mem1"));
+  ASSERT_OK(Put("k2", "mem2"));
+  db_->MultiGetPinned(ReadOptions(), db_->DefaultColumnFamily(), 2,
+                      keys.data(), values.data(), statuses.data(),
+                      /*max_pinned_bytes=*/6);
+  ASSERT_OK(statuses[0]);
+  ASSERT_EQ(values[0], "mem1");
+  ASSERT_TRUE(values[0].IsPinned());
+  ASSERT_OK(statuses[1]);
+  ASSERT_EQ(values[1], "mem2");
+  ASSERT_FALSE(values[1].IsPinned());
+}
+
 TEST_F(DBBasicTest, MultiGetEmpty) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
@@ -3476,6 +3534,92 @@ TEST_F(DBBasicTest, IncrementalRecoveryNoCorrupt) {
   }
 }
 
+TEST_F(DBBasicTest, ParallelManifestRecovery) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+  const std::vector<std::string> cf_names = {"one", "two",  "three",
+                                             "four", "five", "six"};
+  CreateAndReopenWithCF(cf_names, options);
+  const int num_cfs = static_cast<int>(handles_.size());
+  // Enough flushes for the MANIFEST records to be decoded in parallel.
+  for (int i = 0; i < 20; ++i) {
+    for (int cf = 0; cf < num_cfs; ++cf) {
+      ASSERT_OK(Put(cf, Key(i), std::to_string(cf) + "_" + std::to_string(i)));
+      ASSERT_OK(Flush(cf));
+    }
+  }
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), handles_[2], nullptr,
+                              nullptr));
+  ASSERT_OK(db_->DropColumnFamily(handles_[num_cfs - 1]));
+  Close();
+
+  std::vector<std::string> open_cf_names = {kDefaultColumnFamilyName};
+  open_cf_names.insert(open_cf_names.end(), cf_names.begin(),
+                       cf_names.end() - 1);
+  size_t recovered_edits = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionEditHandlerBase::Iterate:Finish",
+      [&](void* arg) { recovered_edits = *static_cast<size_t*>(arg); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  auto get_live_files = [&]() {
+    std::vector<LiveFileMetaData> files;
+    db_->GetLiveFilesMetaData(&files);
+    std::vector<std::string> ret;
+    for (const auto& f : files) {
+      ret.push_back(f.column_family_name + "/" + std::to_string(f.level) +
+                    "/" + f.relative_filename);
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+  };
+  auto verify_values = [&]() {
+    for (int cf = 0; cf < num_cfs - 1; ++cf) {
+      for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(std::to_string(cf) + "_" + std::to_string(i),
+                  Get(cf, Key(i)));
+      }
+    }
+  };
+  // Read-only opens leave the MANIFEST as is, so that each of them replays
+  // the whole history.
+  auto open_read_only = [&]() {
+    std::vector<ColumnFamilyDescriptor> cf_descs;
+    for (const auto& name : open_cf_names) {
+      cf_descs.emplace_back(name, options);
+    }
+    ASSERT_OK(
+        DB::OpenForReadOnly(options, dbname_, cf_descs, &handles_, &db_));
+  };
+
+  open_read_only();
+  const std::vector<std::string> expected_files = get_live_files();
+  const size_t expected_recovered_edits = recovered_edits;
+  ASSERT_GT(expected_recovered_edits, 64);
+  Close();
+
+  options.manifest_recovery_threads = 4;
+  recovered_edits = 0;
+  open_read_only();
+  ASSERT_EQ(expected_recovered_edits, recovered_edits);
+  ASSERT_EQ(expected_files, get_live_files());
+  verify_values();
+  Close();
+
+  // Best-efforts recovery still decodes in parallel, but applies the edits
+  // one at a time to track the missing files.
+  options.best_efforts_recovery = true;
+  recovered_edits = 0;
+  ReopenWithColumnFamilies(open_cf_names, options);
+  ASSERT_EQ(expected_recovered_edits, recovered_edits);
+  ASSERT_EQ(expected_files, get_live_files());
+  verify_values();
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBBasicTest, BestEffortsRecoveryWithVersionBuildingFailure) {
   Options options = CurrentOptions();
   DestroyAndReopen(options);
@@ -9,8 +9,11 @@
 
 #include <cstring>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "cache/cache_entry_roles.h"
 #include "cache/cache_reservation_manager.h"
@@ -955,6 +958,87 @@ TEST_F(DBBloomFilterTest, BloomFilterRate) {
   }
 }
 
+TEST_F(DBBloomFilterTest, ParallelCompressionFilterConstruction) {
+  // With parallel compression, full filters are finished while the last data
+  // blocks are in flight, and partitioned filters finish each partition, on
+  // the compression threads. Results must be the same as without.
+  std::mutex mu;
+  std::thread::id flush_thread;
+  std::vector<std::thread::id> filter_threads;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BuildTable:BeforeFinishBuildTable", [&](void*) {
+        std::lock_guard<std::mutex> l(mu);
+        flush_thread = std::this_thread::get_id();
+      });
+  auto record_filter_thread = [&](void*) {
+    std::lock_guard<std::mutex> l(mu);
+    filter_threads.push_back(std::this_thread::get_id());
+  };
+  SyncPoint::GetInstance()->SetCallBack(
+      "FullFilterBlockBuilder::BGWorkFinishFilter", record_filter_thread);
+  SyncPoint::GetInstance()->SetCallBack(
+      "PartitionedFilterBlockBuilder::BGWorkFinishFilter",
+      record_filter_thread);
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (bool partitioned : {false, true}) {
+    Options options = CurrentOptions();
+    options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+    options.compression_opts.parallel_threads = 4;
+    BlockBasedTableOptions table_options;
+    table_options.filter_policy.reset(NewRibbonFilterPolicy(10, -1));
+    table_options.partition_filters = partitioned;
+    table_options.decouple_partitioned_filters = true;
+    table_options.metadata_block_size = 256;
+    if (partitioned) {
+      table_options.index_type =
+          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+    }
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    const int maxKey = 10000;
+    for (int i = 0; i < maxKey; i++) {
+      ASSERT_OK(Put(Key(i), Key(i)));
+    }
+    {
+      std::lock_guard<std::mutex> l(mu);
+      filter_threads.clear();
+    }
+    ASSERT_OK(Flush());
+
+    TablePropertiesCollection props;
+    ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+    ASSERT_EQ(props.size(), 1U);
+    for (const auto& p : props) {
+      ASSERT_EQ(p.second->num_filter_entries, static_cast<uint64_t>(maxKey));
+      ASSERT_GT(p.second->filter_size, 0U);
+      // The filter, or each of the many filter partitions, was finished off
+      // the flush thread
+      std::lock_guard<std::mutex> l(mu);
+      if (partitioned) {
+        ASSERT_GT(filter_threads.size(), 1U);
+      } else {
+        ASSERT_EQ(filter_threads.size(), 1U);
+      }
+      for (const auto& id : filter_threads) {
+        ASSERT_NE(id, flush_thread);
+      }
+    }
+
+    for (int i = 0; i < maxKey; i++) {
+      ASSERT_EQ(Key(i), Get(Key(i)));
+    }
+    ASSERT_EQ(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), 0);
+    for (int i = 0; i < maxKey; i++) {
+      ASSERT_EQ("NOT_FOUND", Get(Key(i + 33333)));
+    }
+    ASSERT_GE(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), maxKey * 0.98);
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 namespace {
 struct CompatibilityConfig {
   std::shared_ptr<const FilterPolicy> policy;
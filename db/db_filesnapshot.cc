@@ -306,14 +306,15 @@ Status DBImpl::GetLiveFilesStorageInfo(
       results.emplace_back();
       LiveFileStorageInfo& info = results.back();
 
-      info.relative_filename = BlobFileName(meta->GetBlobFileNumber());
+      info.relative_filename =
+          BlobFileName(meta->GetPhysicalBlobFileNumber());
       info.directory = GetDir(/* path_id */ 0);
-      info.file_number = meta->GetBlobFileNumber();
+      info.file_number = meta->GetPhysicalBlobFileNumber();
       info.file_type = kBlobFile;
       info.size = meta->GetBlobFileSize();
       if (opts.include_checksum_info) {
-        info.file_checksum_func_name = meta->GetChecksumMethod();
-        info.file_checksum = meta->GetChecksumValue();
+        info.file_checksum_func_name = meta->GetPhysicalChecksumMethod();
+        info.file_checksum = meta->GetPhysicalChecksumValue();
         if (info.file_checksum_func_name.empty()) {
           info.file_checksum_func_name = kUnknownFileChecksumFuncName;
           info.file_checksum = kUnknownFileChecksum;
@@ -3047,12 +3047,72 @@ void DB::MultiGet(const ReadOptions& options, ColumnFamilyHandle* column_family,
   }
 }
 
+namespace {
+// Copies values pinned in place beyond the first max_pinned_bytes, releasing
+// what they pinned
+void CapPinnedValues(size_t num_keys, PinnableSlice* values,
+                     const Status* statuses, size_t max_pinned_bytes) {
+  size_t pinned_bytes = 0;
+  for (size_t i = 0; i < num_keys; ++i) {
+    PinnableSlice& value = values[i];
+    if (!statuses[i].ok() || !value.IsPinned()) {
+      continue;
+    }
+    if (value.size() <= max_pinned_bytes - pinned_bytes) {
+      pinned_bytes += value.size();
+    } else {
+      value.GetSelf()->assign(value.data(), value.size());
+      value.Reset();
+      value.PinSelf();
+      // Don't pin any smaller values that might fit, to keep it simple to
+      // reason about which values are pinned
+      pinned_bytes = max_pinned_bytes;
+    }
+  }
+}
+}  // namespace
+
+void DB::MultiGetPinned(const ReadOptions& options,
+                        ColumnFamilyHandle* column_family,
+                        const size_t num_keys, const Slice* keys,
+                        PinnableSlice* values, Status* statuses,
+                        size_t max_pinned_bytes, const bool sorted_input) {
+  MultiGet(options, column_family, num_keys, keys, values, statuses,
+           sorted_input);
+  CapPinnedValues(num_keys, values, statuses, max_pinned_bytes);
+}
+
+void DBImpl::MultiGetPinned(const ReadOptions& _read_options,
+                            ColumnFamilyHandle* column_family,
+                            const size_t num_keys, const Slice* keys,
+                            PinnableSlice* values, Status* statuses,
+                            size_t max_pinned_bytes, const bool sorted_input) {
+  if (_read_options.io_activity != Env::IOActivity::kUnknown &&
+      _read_options.io_activity != Env::IOActivity::kMultiGet) {
+    Status s = Status::InvalidArgument(
+        "Can only call MultiGetPinned with `ReadOptions::io_activity` is "
+        "`Env::IOActivity::kUnknown` or `Env::IOActivity::kMultiGet`");
+    for (size_t i = 0; i < num_keys; ++i) {
+      statuses[i] = s;
+    }
+    return;
+  }
+  ReadOptions read_options(_read_options);
+  if (read_options.io_activity == Env::IOActivity::kUnknown) {
+    read_options.io_activity = Env::IOActivity::kMultiGet;
+  }
+  MultiGetCommon(read_options, column_family, num_keys, keys, values,
+                 /* columns */ nullptr, /* timestamps */ nullptr, statuses,
+                 sorted_input, /* pin_memtable_values */ true);
+  CapPinnedValues(num_keys, values, statuses, max_pinned_bytes);
+}
+
 void DBImpl::MultiGetCommon(const ReadOptions& read_options,
                             ColumnFamilyHandle* column_family,
                             const size_t num_keys, const Slice* keys,
                             PinnableSlice* values, PinnableWideColumns* columns,
                             std::string* timestamps, Status* statuses,
-                            bool sorted_input) {
+                            bool sorted_input, bool pin_memtable_values) {
   if (tracer_) {
     // TODO: This mutex should be removed later, to improve performance when
     // tracing is enabled.
@@ -3087,7 +3147,8 @@ void DBImpl::MultiGetCommon(const ReadOptions& read_options,
     sorted_keys[i] = &key_context[i];
   }
   PrepareMultiGetKeys(num_keys, sorted_input, &sorted_keys);
-  MultiGetWithCallbackImpl(read_options, column_family, nullptr, &sorted_keys);
+  MultiGetWithCallbackImpl(read_options, column_family, nullptr, &sorted_keys,
+                           pin_memtable_values);
 }
 
 void DBImpl::MultiGetWithCallback(
@@ -3110,7 +3171,8 @@ void DBImpl::MultiGetWithCallback(
 void DBImpl::MultiGetWithCallbackImpl(
     const ReadOptions& read_options, ColumnFamilyHandle* column_family,
     ReadCallback* callback,
-    autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys) {
+    autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys,
+    bool pin_memtable_values) {
   std::array<ColumnFamilySuperVersionPair, 1> cf_sv_pairs;
   cf_sv_pairs[0] = ColumnFamilySuperVersionPair(column_family, nullptr);
   size_t num_keys = sorted_keys->size();
@@ -3162,7 +3224,7 @@ void DBImpl::MultiGetWithCallbackImpl(
 
   s = MultiGetImpl(read_options, 0, num_keys, sorted_keys,
                    cf_sv_pairs[0].super_version, consistent_seqnum,
-                   read_callback);
+                   read_callback, pin_memtable_values);
   assert(s.ok() || s.IsTimedOut() || s.IsAborted());
   ReturnAndCleanupSuperVersion(cf_sv_pairs[0].cfd,
                                cf_sv_pairs[0].super_version);
@@ -3181,7 +3243,7 @@ Status DBImpl::MultiGetImpl(
     const ReadOptions& read_options, size_t start_key, size_t num_keys,
     autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys,
     SuperVersion* super_version, SequenceNumber snapshot,
-    ReadCallback* callback) {
+    ReadCallback* callback, bool pin_memtable_values) {
   PERF_CPU_TIMER_GUARD(get_cpu_nanos, immutable_db_options_.clock);
   StopWatch sw(immutable_db_options_.clock, stats_, DB_MULTIGET);
 
@@ -3203,6 +3265,19 @@ Status DBImpl::MultiGetImpl(
   size_t keys_left = num_keys;
   Status s;
   uint64_t curr_value_size = 0;
+  // Values pinned in memtables share one reference to the SuperVersion,
+  // released along with the last of them
+  SharedCleanablePtr memtable_value_pinner;
+  if (pin_memtable_values) {
+    super_version->Ref();
+    memtable_value_pinner.Allocate();
+    memtable_value_pinner->RegisterCleanup(
+        CleanupSuperVersionHandle,
+        new SuperVersionHandle(
+            this, &mutex_, super_version,
+            immutable_db_options_.avoid_unnecessary_blocking_io),
+        nullptr);
+  }
   while (keys_left) {
     if (read_options.deadline.count() &&
         immutable_db_options_.clock->NowMicros() >
@@ -3217,6 +3292,9 @@ Status DBImpl::MultiGetImpl(
     MultiGetContext ctx(sorted_keys, start_key + num_keys - keys_left,
                         batch_size, snapshot, read_options, GetFileSystem(),
                         stats_);
+    if (pin_memtable_values) {
+      ctx.SetMemTableValuePinner(&memtable_value_pinner);
+    }
     MultiGetRange range = ctx.GetMultiGetRange();
     range.AddValueSize(curr_value_size);
     bool lookup_current = true;
@@ -4380,10 +4458,13 @@ void DBImpl::ReleaseSnapshot(const Snapshot* s) {
         if (cfd->IsDropped() || CfdListContains(cf_scheduled, cfd)) {
           continue;
         }
+        VersionStorageInfo* vstorage = cfd->current()->storage_info();
         if (oldest_snapshot >=
-            cfd->current()
-                ->storage_info()
-                ->standalone_range_tombstone_files_mark_threshold()) {
+            vstorage->standalone_range_tombstone_files_mark_threshold()) {
+          // Lists the files covered by range tombstones that the released
+          // snapshots still saw.
+          vstorage->UpdateOldestSnapshot(oldest_snapshot,
+                                         cfd->AllowIngestBehind());
           EnqueuePendingCompaction(cfd);
           MaybeScheduleFlushOrCompaction();
           cf_scheduled.push_back(cfd);
@@ -6413,13 +6494,13 @@ Status DBImpl::VerifyChecksumInternal(const ReadOptions& read_options,
       for (const auto& meta : blob_files) {
         assert(meta);
 
-        const uint64_t blob_file_number = meta->GetBlobFileNumber();
+        const uint64_t blob_file_number = meta->GetPhysicalBlobFileNumber();
 
         const std::string blob_file_name = BlobFileName(
             cfd->ioptions().cf_paths.front().path, blob_file_number);
-        s = VerifyFullFileChecksum(meta->GetChecksumValue(),
-                                   meta->GetChecksumMethod(), blob_file_name,
-                                   read_options);
+        s = VerifyFullFileChecksum(meta->GetPhysicalChecksumValue(),
+                                   meta->GetPhysicalChecksumMethod(),
+                                   blob_file_name, read_options);
         RecordTick(stats_, VERIFY_CHECKSUM_READ_BYTES,
                    IOSTATS(bytes_read) - prev_bytes_read);
         prev_bytes_read = IOSTATS(bytes_read);
@@ -34,6 +34,7 @@
 #include "db/log_writer.h"
 #include "db/logs_with_prep_tracker.h"
 #include "db/memtable_list.h"
+#include "db/parallel_wal_replayer.h"
 #include "db/periodic_task_scheduler.h"
 #include "db/post_memtable_callback.h"
 #include "db/pre_release_callback.h"
@@ -65,7 +66,9 @@
 #include "rocksdb/write_buffer_manager.h"
 #include "table/merging_iterator.h"
 #include "util/autovector.h"
+#include "util/core_local.h"
 #include "util/hash.h"
+#include "util/mutexlock.h"
 #include "util/repeatable_thread.h"
 #include "util/stop_watch.h"
 #include "util/thread_local.h"
@@ -305,6 +308,12 @@ class DBImpl : public DB {
       ReadCallback* callback,
       autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys);
 
+  void MultiGetPinned(const ReadOptions& _read_options,
+                      ColumnFamilyHandle* column_family, const size_t num_keys,
+                      const Slice* keys, PinnableSlice* values,
+                      Status* statuses, size_t max_pinned_bytes,
+                      const bool sorted_input = false) override;
+
   using DB::MultiGetEntity;
 
   void MultiGetEntity(const ReadOptions& options,
@@ -447,6 +456,9 @@ class DBImpl : public DB {
       std::vector<std::string>* const output_file_names = nullptr,
       CompactionJobInfo* compaction_job_info = nullptr) override;
 
+  Status CompactBlobFiles(const CompactBlobFilesOptions& options,
+                          ColumnFamilyHandle* column_family) override;
+
   Status PauseBackgroundWork() override;
   Status ContinueBackgroundWork() override;
 
@@ -1588,12 +1600,39 @@ class DBImpl : public DB {
                             bool disable_memtable = false,
                             uint64_t* seq_used = nullptr);
 
+  // With enable_pipelined_wal_sync, waits until the WAL sync requested by
+  // the write group with the given ticket is done, syncing the WALs itself
+  // if no other thread is. A single sync covers every write group that
+  // finished writing to the WAL when it started.
+  Status WaitForWalGroupSync(uint64_t ticket);
+
   // Write only to memtables without joining any write queue
   Status UnorderedWriteMemtable(const WriteOptions& write_options,
                                 WriteBatch* my_batch, WriteCallback* callback,
                                 uint64_t log_ref, SequenceNumber seq,
                                 const size_t sub_batch_cnt);
 
+  // Whether an unordered_write can go through the core-local write staging
+  // of core_local_write_staging, which merges batches without callbacks.
+  bool CanStageUnorderedWrite(const WriteOptions& write_options,
+                              const WriteBatch* my_batch,
+                              WriteCallback* callback,
+                              UserWriteCallback* user_write_cb,
+                              uint64_t log_ref, size_t batch_cnt,
+                              PreReleaseCallback* pre_release_callback,
+                              PostMemTableCallback* post_memtable_callback,
+                              bool disable_memtable) const;
+
+  // The WAL part of an unordered_write with core_local_write_staging. The
+  // batch is staged in the shard of the current core. One of the writers
+  // staged there merges the shard's batches and writes them to the WAL as one
+  // batch through write_thread_, which reserves one sequence range for the
+  // whole shard and publishes it in order. Each writer gets its own sub-range
+  // back in *seq_used and then does its own memtable insert.
+  Status StagedUnorderedWriteWAL(const WriteOptions& write_options,
+                                 WriteBatch* my_batch, uint64_t* wal_used,
+                                 SequenceNumber* seq_used);
+
   // Whether the batch requires to be assigned with an order
   enum AssignOrder : bool { kDontAssignOrder, kDoAssignOrder };
   // Whether it requires publishing last sequence or not
@@ -1614,7 +1653,8 @@ class DBImpl : public DB {
       UserWriteCallback* user_write_cb, uint64_t* wal_used,
       const uint64_t log_ref, uint64_t* seq_used, const size_t sub_batch_cnt,
       PreReleaseCallback* pre_release_callback, const AssignOrder assign_order,
-      const PublishLastSeq publish_last_seq, const bool disable_memtable);
+      const PublishLastSeq publish_last_seq, const bool disable_memtable,
+      const size_t staged_write_cnt = 1);
 
   // write cached_recoverable_state_ to memtable if it is not empty
   // The writer must be the leader in write_thread_ and holding mutex_
@@ -2126,7 +2166,8 @@ class DBImpl : public DB {
       SequenceNumber* last_seqno_observed, SequenceNumber* next_sequence,
       bool* stop_replay_for_corruption, Status* status,
       bool* stop_replay_by_wal_filter,
-      std::unordered_map<int, VersionEdit>* version_edits, bool* flushed);
+      std::unordered_map<int, VersionEdit>* version_edits, bool* flushed,
+      uint64_t* insert_micros);
 
   Status InitializeWriteBatchForLogRecord(
       Slice record, const std::unique_ptr<log::Reader>& reader,
@@ -2148,6 +2189,11 @@ class DBImpl : public DB {
       SequenceNumber const* const next_sequence,
       std::unordered_map<int, VersionEdit>* version_edits, bool* flushed);
 
+  // Waits for the write batches handed to parallel_wal_replayer_ to be
+  // inserted into the memtables. Must be called before the memtables are
+  // flushed or switched during recovery.
+  Status WaitForParallelWalReplay(bool* has_valid_writes);
+
   Status HandleNonOkStatusOrOldLogRecord(
       uint64_t wal_number, SequenceNumber const* const next_sequence,
       Status status, const DBOpenLogRecordReadReporter& reporter,
@@ -2186,6 +2232,13 @@ class DBImpl : public DB {
   Status WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
                                      MemTable* mem, VersionEdit* edit);
 
+  // Calls WriteLevel0TableForRecovery() on the active memtable of each of
+  // `cfds`, from up to wal_recovery_threads threads. REQUIRES: mutex held,
+  // which is released while the tables are written.
+  Status WriteLevel0TablesForRecovery(
+      int job_id, const autovector<ColumnFamilyData*>& cfds,
+      std::unordered_map<int, VersionEdit>* version_edits);
+
   // Get the size of a log file and, if truncate is true, truncate the
   // log file to its actual size, thereby freeing preallocated space.
   // Return success even if truncate fails
@@ -2282,6 +2335,14 @@ class DBImpl : public DB {
       const autovector<const uint64_t*>& flush_memtable_ids,
       bool resuming_from_bg_err, std::optional<FlushReason> flush_reason);
 
+  int64_t NumPendingMemTableWrites() const {
+    int64_t total = 0;
+    for (size_t i = 0; i < pending_memtable_writes_.Size(); ++i) {
+      total += pending_memtable_writes_.AccessAtCore(i)->obj_.load();
+    }
+    return total;
+  }
+
   inline void WaitForPendingWrites() {
     mutex_.AssertHeld();
     TEST_SYNC_POINT("DBImpl::WaitForPendingWrites:BeforeBlock");
@@ -2298,11 +2359,13 @@ class DBImpl : public DB {
     if (immutable_db_options_.unordered_write) {
       // Wait for the ones who already wrote to the WAL to finish their
       // memtable write.
-      if (pending_memtable_writes_.load() != 0) {
+      if (NumPendingMemTableWrites() != 0) {
         // XXX: suspicious wait while holding DB mutex?
         std::unique_lock<std::mutex> guard(switch_mutex_);
+        pending_memtable_writes_waiter_.store(true);
         switch_cv_.wait(guard,
-                        [&] { return pending_memtable_writes_.load() == 0; });
+                        [&] { return NumPendingMemTableWrites() == 0; });
+        pending_memtable_writes_waiter_.store(false);
       }
     } else {
       // (Writes are finished before the next write group starts.)
@@ -2628,11 +2691,14 @@ class DBImpl : public DB {
       const size_t num_keys, bool sorted,
       autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* key_ptrs);
 
+  // With pin_memtable_values, values found in memtables are returned pinned
+  // in place (see MultiGetPinned()) rather than copied.
   void MultiGetCommon(const ReadOptions& options,
                       ColumnFamilyHandle* column_family, const size_t num_keys,
                       const Slice* keys, PinnableSlice* values,
                       PinnableWideColumns* columns, std::string* timestamps,
-                      Status* statuses, bool sorted_input);
+                      Status* statuses, bool sorted_input,
+                      bool pin_memtable_values = false);
 
   void MultiGetCommon(const ReadOptions& options, const size_t num_keys,
                       ColumnFamilyHandle** column_families, const Slice* keys,
@@ -2716,12 +2782,14 @@ class DBImpl : public DB {
   Status MultiGetImpl(
       const ReadOptions& read_options, size_t start_key, size_t num_keys,
       autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys,
-      SuperVersion* sv, SequenceNumber snap_seqnum, ReadCallback* callback);
+      SuperVersion* sv, SequenceNumber snap_seqnum, ReadCallback* callback,
+      bool pin_memtable_values = false);
 
   void MultiGetWithCallbackImpl(
       const ReadOptions& read_options, ColumnFamilyHandle* column_family,
       ReadCallback* callback,
-      autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys);
+      autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys,
+      bool pin_memtable_values = false);
 
   Status DisableFileDeletionsWithLock();
 
@@ -2765,6 +2833,19 @@ class DBImpl : public DB {
   // mutex_, the order should be first mutex_ and then wal_write_mutex_.
   InstrumentedMutex wal_write_mutex_;
 
+  // With enable_pipelined_wal_sync, sync write groups leaving the WAL stage
+  // take increasing tickets from wal_group_sync_requested_. The other members
+  // are protected by wal_group_sync_mutex_: tickets up to
+  // wal_group_sync_done_ are durable, and those up to
+  // wal_group_sync_failed_up_to_ failed with wal_group_sync_error_.
+  std::atomic<uint64_t> wal_group_sync_requested_{0};
+  InstrumentedMutex wal_group_sync_mutex_;
+  InstrumentedCondVar wal_group_sync_cv_{&wal_group_sync_mutex_};
+  uint64_t wal_group_sync_done_ = 0;
+  uint64_t wal_group_sync_failed_up_to_ = 0;
+  Status wal_group_sync_error_;
+  bool wal_group_sync_in_progress_ = false;
+
   // If zero, manual compactions are allowed to proceed. If non-zero, manual
   // compactions may still be running, but will quickly fail with
   // `Status::Incomplete`. The value indicates how many threads have paused
@@ -2784,6 +2865,7 @@ class DBImpl : public DB {
   // * whenever pending_purge_obsolete_files_ goes to 0.
   // * whenever disable_delete_obsolete_files_ goes to 0.
   // * whenever SetOptions successfully updates options.
+  // * whenever blob_file_gc_installing_ goes back to false.
   // * whenever a column family is dropped.
   InstrumentedCondVar bg_cv_;
 
@@ -2955,6 +3037,11 @@ class DBImpl : public DB {
 
   TrimHistoryScheduler trim_history_scheduler_;
 
+  // Inserts the recovered write batches into the memtables while
+  // RecoverLogFiles() replays WALs with wal_recovery_threads > 1. Null
+  // otherwise.
+  std::unique_ptr<ParallelWalReplayer> parallel_wal_replayer_;
+
   SnapshotList snapshots_;
 
   TimestampedSnapshotList timestamped_snapshots_;
@@ -3035,6 +3122,12 @@ class DBImpl : public DB {
   // number of background obsolete file purge jobs, submitted to the HIGH pool
   int bg_purge_scheduled_ = 0;
 
+  // Whether a blob file GC job is installing its relocations. Installs are
+  // serialized, so that a job's checks against the current version stay
+  // valid until its edit is applied. bg_cv_ is signaled when it goes back to
+  // false.
+  bool blob_file_gc_installing_ = false;
+
   std::deque<ManualCompactionState*> manual_compaction_dequeue_;
 
   // shall we disable deletion of obsolete files
@@ -3058,8 +3151,46 @@ class DBImpl : public DB {
   std::condition_variable switch_cv_;
   // The mutex used by switch_cv_. mutex_ should be acquired beforehand.
   std::mutex switch_mutex_;
-  // Number of threads intending to write to memtable
-  std::atomic<size_t> pending_memtable_writes_{0};
+  // Number of threads intending to write to memtable, sharded by core so that
+  // concurrent unordered_write memtable writers do not all contend on one
+  // cache line. A writer's increment (done by its write group leader) and its
+  // decrement may land on different shards, so individual shards can go
+  // negative; only the sum is meaningful. New increments only happen from a
+  // write group leader, which cannot run concurrently with
+  // WaitForPendingWrites(), so the sum can only drop while it is being read.
+  CoreLocalArray<CacheAlignedWrapper<std::atomic<int64_t>>>
+      pending_memtable_writes_;
+  // Set while WaitForPendingWrites() is blocked on switch_cv_, so that
+  // memtable writers only sum up pending_memtable_writes_ and signal the cv
+  // when somebody is waiting.
+  std::atomic<bool> pending_memtable_writes_waiter_{false};
+
+  // With core_local_write_staging, unordered_write batches are staged per
+  // core, and the staged batches of a core are written to the WAL by one of
+  // their writers at a time, so that only one writer per core enters
+  // write_thread_.
+  struct StagedWrite {
+    explicit StagedWrite(WriteBatch* _batch, bool _sync)
+        : batch(_batch), sync(_sync) {}
+
+    WriteBatch* batch;
+    bool sync;
+    // The following are set, under the shard mutex, once the staged batch has
+    // been written to the WAL (or failed to)
+    bool done = false;
+    SequenceNumber sequence = kMaxSequenceNumber;
+    uint64_t wal_used = 0;
+    Status status;
+  };
+  struct WriteStagingShard {
+    port::Mutex mutex;
+    port::CondVar cv{&mutex};
+    // Writes waiting for a writer of this shard to take them to the WAL
+    std::vector<StagedWrite*> staged;
+    // Whether a writer of this shard is writing staged batches to the WAL
+    bool draining = false;
+  };
+  CoreLocalArray<CacheAlignedWrapper<WriteStagingShard>> write_staging_shards_;
 
   // A flag indicating whether the current rocksdb database has any
   // data that is not yet persisted into either WAL or SST file.
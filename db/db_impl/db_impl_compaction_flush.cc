@@ -9,6 +9,7 @@
 #include <cinttypes>
 #include <deque>
 
+#include "db/blob/blob_file_gc_job.h"
 #include "db/builder.h"
 #include "db/db_impl/db_impl.h"
 #include "db/error_handler.h"
@@ -1641,6 +1642,117 @@ Status DBImpl::CompactFilesImpl(
   return status;
 }
 
+Status DBImpl::CompactBlobFiles(const CompactBlobFilesOptions& options,
+                                ColumnFamilyHandle* column_family) {
+  if (column_family == nullptr) {
+    return Status::InvalidArgument("ColumnFamilyHandle must be non-null.");
+  }
+
+  if (!(options.garbage_ratio_threshold > 0.0 &&
+        options.garbage_ratio_threshold <= 1.0)) {
+    return Status::InvalidArgument(
+        "garbage_ratio_threshold must be in (0, 1]");
+  }
+
+  auto cfd =
+      static_cast_with_check<ColumnFamilyHandleImpl>(column_family)->cfd();
+  assert(cfd);
+
+  // Blob records keep the timestamps of the keys, and the blob indexes in the
+  // SSTs then do not have enough to locate the records.
+  if (!cfd->ioptions().persist_user_defined_timestamps) {
+    return Status::NotSupported(
+        "CompactBlobFiles() does not support persist_user_defined_timestamps "
+        "= false");
+  }
+
+  Status s;
+  JobContext job_context(next_job_id_.fetch_add(1), true);
+  BlobFileGCJob blob_file_gc_job(
+      job_context.job_id, cfd, immutable_db_options_,
+      file_options_for_compaction_, versions_.get(), &shutting_down_,
+      &blob_callback_, io_tracer_, options);
+  Version* version = nullptr;
+  std::unique_ptr<std::list<uint64_t>::iterator> pending_outputs_inserted_elem;
+
+  {
+    InstrumentedMutexLock l(&mutex_);
+
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      return Status::ShutdownInProgress();
+    }
+    if (manual_compaction_paused_.load(std::memory_order_acquire) > 0) {
+      return Status::Incomplete(Status::SubCode::kManualCompactionPaused);
+    }
+    if (error_handler_.IsBGWorkStopped()) {
+      return error_handler_.GetBGError();
+    }
+
+    bg_compaction_scheduled_++;
+    version = cfd->current();
+    version->Ref();
+    pending_outputs_inserted_elem.reset(new std::list<uint64_t>::iterator(
+        CaptureCurrentFileNumberInPendingOutputs()));
+
+    blob_file_gc_job.Prepare(version);
+  }
+
+  TEST_SYNC_POINT("DBImpl::CompactBlobFiles:BeforeRun");
+
+  if (blob_file_gc_job.HasInputs()) {
+    s = blob_file_gc_job.Run();
+  }
+
+  TEST_SYNC_POINT("DBImpl::CompactBlobFiles:AfterRun");
+
+  {
+    InstrumentedMutexLock l(&mutex_);
+
+    if (s.ok() && blob_file_gc_job.HasInputs()) {
+      while (blob_file_gc_installing_) {
+        bg_cv_.Wait();
+      }
+      blob_file_gc_installing_ = true;
+      s = blob_file_gc_job.Install(&mutex_, directories_.GetDbDir(),
+                                   GetDataDir(cfd, 0));
+      if (s.ok()) {
+        InstallSuperVersionAndScheduleWork(
+            cfd, job_context.superversion_contexts.data());
+      }
+      blob_file_gc_installing_ = false;
+      bg_cv_.SignalAll();
+    }
+
+    if (!s.ok() && !s.IsShutdownInProgress() && !s.IsColumnFamilyDropped()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "[%s] [JOB %d] Blob file GC error: %s",
+                     cfd->GetName().c_str(), job_context.job_id,
+                     s.ToString().c_str());
+      error_handler_.SetBGError(s, BackgroundErrorReason::kCompaction);
+    }
+
+    blob_file_gc_job.ReleaseInputs();
+    ReleaseFileNumberFromPendingOutputs(pending_outputs_inserted_elem);
+    version->Unref();
+
+    bg_compaction_scheduled_--;
+    if (bg_compaction_scheduled_ == 0) {
+      bg_cv_.SignalAll();
+    }
+
+    // New blob files that were not installed are only found by a full scan.
+    FindObsoleteFiles(&job_context,
+                      !s.ok() || blob_file_gc_job.HasDroppedOutputs());
+  }
+
+  if (job_context.HaveSomethingToDelete()) {
+    PurgeObsoleteFiles(job_context);
+  }
+  job_context.Clean();
+
+  return s;
+}
+
 Status DBImpl::PauseBackgroundWork() {
   InstrumentedMutexLock guard_lock(&mutex_);
   bg_compaction_paused_++;
@@ -3705,7 +3817,8 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
       TEST_SYNC_POINT("DBImpl::BackgroundCompaction():BeforePickCompaction");
       // This info is not useful for other scenarios, so save querying existing
       // snapshots for those cases.
-      if (cfd->ioptions().compaction_style == kCompactionStyleUniversal &&
+      if ((cfd->ioptions().compaction_style == kCompactionStyleUniversal ||
+           cfd->ioptions().compaction_style == kCompactionStyleLevel) &&
           cfd->user_comparator()->timestamp_size() == 0) {
         InitSnapshotContext(job_context);
         assert(is_snapshot_supported_ || snapshots_.empty());
@@ -3787,7 +3900,9 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
                              c->column_family_data());
     assert(c->num_input_files(1) == 0);
     assert(c->column_family_data()->ioptions().compaction_style ==
-           kCompactionStyleFIFO);
+               kCompactionStyleFIFO ||
+           c->compaction_reason() ==
+               CompactionReason::kFilesCoveredByRangeDeletion);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -3811,7 +3926,9 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     ROCKS_LOG_BUFFER(log_buffer, "[%s] Deleted %d files\n",
                      c->column_family_data()->GetName().c_str(),
                      c->num_input_files(0));
-    if (status.ok() && io_s.ok()) {
+    if (status.ok() && io_s.ok() &&
+        c->compaction_reason() !=
+            CompactionReason::kFilesCoveredByRangeDeletion) {
       UpdateFIFOCompactionStatus(c);
     }
     *made_progress = true;
@@ -4653,6 +4770,19 @@ void DBImpl::InstallSuperVersionAndScheduleWork(
   cfd->InstallSuperVersion(sv_context, &mutex_,
                            std::move(new_seqno_to_time_mapping));
 
+  // The oldest snapshot of a new version is the one it was last updated to,
+  // which can be older than the current one. The files covered by range
+  // tombstones are only listed once no snapshot sees them, so do not wait for
+  // a snapshot release that may never come to list them.
+  VersionStorageInfo* vstorage = cfd->current()->storage_info();
+  const SequenceNumber oldest_snapshot = snapshots_.empty()
+                                             ? GetLastPublishedSequence()
+                                             : snapshots_.oldest()->number_;
+  if (oldest_snapshot >=
+      vstorage->files_covered_by_range_tombstones_threshold()) {
+    vstorage->UpdateOldestSnapshot(oldest_snapshot, cfd->AllowIngestBehind());
+  }
+
   // There may be a small data race here. The snapshot tricking bottommost
   // compaction may already be released here. But assuming there will always be
   // newer snapshot created and released frequently, the compaction will be
@@ -25,6 +25,7 @@
 #include "rocksdb/table.h"
 #include "rocksdb/wal_filter.h"
 #include "test_util/sync_point.h"
+#include "util/defer.h"
 #include "util/rate_limiter_impl.h"
 #include "util/string_util.h"
 #include "util/udt_util.h"
@@ -271,11 +272,28 @@ Status DBImpl::ValidateOptions(const DBOptions& db_options) {
         "unordered_write is incompatible with enable_pipelined_write");
   }
 
+  if (db_options.core_local_write_staging && !db_options.unordered_write) {
+    return Status::InvalidArgument(
+        "core_local_write_staging requires unordered_write");
+  }
+
   if (db_options.atomic_flush && db_options.enable_pipelined_write) {
     return Status::InvalidArgument(
         "atomic_flush is incompatible with enable_pipelined_write");
   }
 
+  if (db_options.enable_pipelined_wal_sync) {
+    if (!db_options.enable_pipelined_write) {
+      return Status::InvalidArgument(
+          "enable_pipelined_wal_sync requires enable_pipelined_write");
+    }
+    if (db_options.manual_wal_flush || db_options.allow_mmap_writes) {
+      return Status::InvalidArgument(
+          "enable_pipelined_wal_sync is incompatible with manual_wal_flush "
+          "and allow_mmap_writes");
+    }
+  }
+
   if (db_options.use_direct_io_for_flush_and_compaction &&
       0 == db_options.writable_file_max_buffer_size) {
     return Status::InvalidArgument(
@@ -1139,10 +1157,59 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
   uint64_t min_wal_number = 0;
   SetupLogFilesRecovery(wal_numbers, &version_edits, &job_id, &min_wal_number);
 
+  InternalStats* const stats = default_cf_internal_stats_;
+  assert(stats);
+  const uint64_t prev_read_micros =
+      stats->GetDBStats(InternalStats::kIntStatsWalRecoveryReadMicros);
+  const uint64_t prev_insert_micros =
+      stats->GetDBStats(InternalStats::kIntStatsWalRecoveryInsertMicros);
+  const uint64_t prev_flush_micros =
+      stats->GetDBStats(InternalStats::kIntStatsWalRecoveryFlushMicros);
+
+  // Concurrent memtable inserts need a memtable that supports them, and
+  // cannot rebuild the prepared transactions of 2PC or assign sequence
+  // numbers per batch.
+  if (immutable_db_options_.wal_recovery_threads > 1 &&
+      immutable_db_options_.allow_concurrent_memtable_write && !allow_2pc() &&
+      !seq_per_batch_) {
+    parallel_wal_replayer_.reset(new ParallelWalReplayer(
+        immutable_db_options_.wal_recovery_threads,
+        versions_->GetColumnFamilySet(), &flush_scheduler_,
+        &trim_history_scheduler_, this, batch_per_txn_,
+        immutable_db_options_.clock));
+  }
+  const int num_replay_threads =
+      parallel_wal_replayer_ ? immutable_db_options_.wal_recovery_threads : 1;
+
   Status status = ProcessLogFiles(
       wal_numbers, read_only, is_retry, min_wal_number, job_id, next_sequence,
       &version_edits, corrupted_wal_found, recovery_ctx);
 
+  uint64_t insert_wait_micros = 0;
+  if (parallel_wal_replayer_) {
+    // Stops the insert threads. Every batch was inserted unless recovery
+    // failed.
+    stats->AddDBStats(InternalStats::kIntStatsWalRecoveryInsertMicros,
+                      parallel_wal_replayer_->GetInsertMicros());
+    insert_wait_micros = parallel_wal_replayer_->GetWaitMicros();
+    stats->AddDBStats(InternalStats::kIntStatsWalRecoveryInsertWaitMicros,
+                      insert_wait_micros);
+    parallel_wal_replayer_.reset();
+  }
+  ROCKS_LOG_INFO(
+      immutable_db_options_.info_log,
+      "[JOB %d] WAL recovery with %d threads: read %" PRIu64
+      " us, memtable insert %" PRIu64 " us, insert wait %" PRIu64
+      " us, flush %" PRIu64 " us",
+      job_id, num_replay_threads,
+      stats->GetDBStats(InternalStats::kIntStatsWalRecoveryReadMicros) -
+          prev_read_micros,
+      stats->GetDBStats(InternalStats::kIntStatsWalRecoveryInsertMicros) -
+          prev_insert_micros,
+      insert_wait_micros,
+      stats->GetDBStats(InternalStats::kIntStatsWalRecoveryFlushMicros) -
+          prev_flush_micros);
+
   FinishLogFilesRecovery(job_id, status);
   return status;
 }
@@ -1307,6 +1374,32 @@ Status DBImpl::ProcessLogFile(
 
   TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                            /*cb_arg=*/nullptr);
+  // The replay of the WAL is timed as a whole rather than per record. Reading
+  // it is what is left after the memtable inserts, the flushes and the waits
+  // for the insert threads. Without insert threads, the inserts are not timed
+  // and are part of reading.
+  InternalStats* const stats = default_cf_internal_stats_;
+  const uint64_t prev_flush_micros =
+      stats->GetDBStats(InternalStats::kIntStatsWalRecoveryFlushMicros);
+  const uint64_t prev_wait_micros =
+      parallel_wal_replayer_ ? parallel_wal_replayer_->GetWaitMicros() : 0;
+  uint64_t insert_micros = 0;
+  const uint64_t replay_start_micros = immutable_db_options_.clock->NowMicros();
+  Defer record_replay_micros([&]() {
+    const uint64_t other_micros =
+        insert_micros +
+        (stats->GetDBStats(InternalStats::kIntStatsWalRecoveryFlushMicros) -
+         prev_flush_micros) +
+        (parallel_wal_replayer_
+             ? parallel_wal_replayer_->GetWaitMicros() - prev_wait_micros
+             : 0);
+    const uint64_t replay_micros =
+        immutable_db_options_.clock->NowMicros() - replay_start_micros;
+    stats->AddDBStats(InternalStats::kIntStatsWalRecoveryReadMicros,
+                      replay_micros - std::min(replay_micros, other_micros));
+    stats->AddDBStats(InternalStats::kIntStatsWalRecoveryInsertMicros,
+                      insert_micros);
+  });
   while (true) {
     if (*stop_replay_by_wal_filter) {
       break;
@@ -1329,7 +1422,7 @@ Status DBImpl::ProcessLogFile(
         record, reader, running_ts_sz, wal_number, fname, read_only, job_id,
         logFileDropped, &reporter, &record_checksum, &last_seqno_observed,
         next_sequence, stop_replay_for_corruption, &status,
-        stop_replay_by_wal_filter, version_edits, flushed);
+        stop_replay_by_wal_filter, version_edits, flushed, &insert_micros);
 
     if (!process_status.ok()) {
       return process_status;
@@ -1344,6 +1437,17 @@ Status DBImpl::ProcessLogFile(
     }
   }
 
+  if (parallel_wal_replayer_) {
+    // The memtable inserts of this WAL must be done before the corruption
+    // handling and the flushes at the end of recovery.
+    bool has_valid_writes = false;
+    Status insert_status = WaitForParallelWalReplay(&has_valid_writes);
+    if (!insert_status.ok()) {
+      status.PermitUncheckedError();
+      return insert_status;
+    }
+  }
+
   ROCKS_LOG_INFO(immutable_db_options_.info_log,
                  "Recovered to log #%" PRIu64 " next seq #%" PRIu64, wal_number,
                  *next_sequence);
@@ -1435,8 +1539,10 @@ Status DBImpl::ProcessLogRecord(
     SequenceNumber* last_seqno_observed, SequenceNumber* next_sequence,
     bool* stop_replay_for_corruption, Status* status,
     bool* stop_replay_by_wal_filter,
-    std::unordered_map<int, VersionEdit>* version_edits, bool* flushed) {
+    std::unordered_map<int, VersionEdit>* version_edits, bool* flushed,
+    uint64_t* insert_micros) {
   assert(reporter);
+  assert(insert_micros);
   assert(last_seqno_observed);
   assert(stop_replay_for_corruption);
   assert(status);
@@ -1496,8 +1602,61 @@ Status DBImpl::ProcessLogRecord(
   }
 
   assert(process_status.ok());
+  if (parallel_wal_replayer_) {
+    // Transaction markers and merges subject to max_successive_merges need
+    // the single-threaded insert below.
+    bool concurrent_insert =
+        !batch_to_use->HasBeginPrepare() && !batch_to_use->HasEndPrepare() &&
+        !batch_to_use->HasCommit() && !batch_to_use->HasRollback();
+    if (concurrent_insert && batch_to_use->HasMerge()) {
+      for (auto cfd : *versions_->GetColumnFamilySet()) {
+        if (cfd->GetLatestMutableCFOptions().max_successive_merges > 0) {
+          concurrent_insert = false;
+          break;
+        }
+      }
+    }
+    if (concurrent_insert) {
+      // Sequence numbers are assigned per key, see MemTableInserter.
+      *next_sequence = WriteBatchInternal::Sequence(batch_to_use) +
+                       WriteBatchInternal::Count(batch_to_use);
+      if (!new_batch) {
+        new_batch.reset(new WriteBatch(std::move(batch)));
+      }
+      parallel_wal_replayer_->Schedule(std::move(new_batch), wal_number);
+      if (read_only || flush_scheduler_.Empty()) {
+        return process_status;
+      }
+      // A memtable is full. Its inserts need to finish before it is flushed.
+      process_status = WaitForParallelWalReplay(&has_valid_writes);
+      if (!process_status.ok()) {
+        return process_status;
+      }
+      return MaybeWriteLevel0TableForRecovery(has_valid_writes, read_only,
+                                              wal_number, job_id,
+                                              next_sequence, version_edits,
+                                              flushed);
+    }
+    bool pending_valid_writes = false;
+    process_status = WaitForParallelWalReplay(&pending_valid_writes);
+    if (!process_status.ok()) {
+      return process_status;
+    }
+    has_valid_writes = pending_valid_writes;
+  }
+
+  // Only the batches that the insert threads cannot take are timed here.
+  // Without insert threads, the inserts count as part of reading the WAL,
+  // rather than reading the clock twice per record.
+  const bool time_insert = parallel_wal_replayer_ != nullptr;
+  const uint64_t insert_start_micros =
+      time_insert ? immutable_db_options_.clock->NowMicros() : 0;
   process_status = InsertLogRecordToMemtable(batch_to_use, wal_number,
                                              next_sequence, &has_valid_writes);
+  if (time_insert) {
+    *insert_micros +=
+        immutable_db_options_.clock->NowMicros() - insert_start_micros;
+  }
   MaybeIgnoreError(&process_status);
   // We are treating this as a failure while reading since we read valid
   // blocks that do not form coherent data
@@ -1604,6 +1763,7 @@ Status DBImpl::MaybeWriteLevel0TableForRecovery(
     // we can do this because this is called before client has access to the
     // DB and there is only a single thread operating on DB
     ColumnFamilyData* cfd;
+    autovector<ColumnFamilyData*> cfds_to_flush;
 
     while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
       cfd->UnrefAndTryDelete();
@@ -1611,23 +1771,37 @@ Status DBImpl::MaybeWriteLevel0TableForRecovery(
       // filtering updates to already-flushed column families
       assert(cfd->GetLogNumber() <= wal_number);
       (void)wal_number;
-      auto iter = version_edits->find(cfd->GetID());
-      assert(iter != version_edits->end());
-      VersionEdit* edit = &iter->second;
-      status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
-      if (!status.ok()) {
-        // Reflect errors immediately so that conditions like full
-        // file-systems cause the DB::Open() to fail.
-        return status;
-      }
-      *flushed = true;
+      cfds_to_flush.push_back(cfd);
+    }
+    if (cfds_to_flush.empty()) {
+      return status;
+    }
+    status = WriteLevel0TablesForRecovery(job_id, cfds_to_flush, version_edits);
+    if (!status.ok()) {
+      // Reflect errors immediately so that conditions like full
+      // file-systems cause the DB::Open() to fail.
+      return status;
+    }
+    *flushed = true;
 
-      cfd->CreateNewMemtable(*next_sequence - 1);
+    for (auto flushed_cfd : cfds_to_flush) {
+      flushed_cfd->CreateNewMemtable(*next_sequence - 1);
     }
   }
   return status;
 }
 
+Status DBImpl::WaitForParallelWalReplay(bool* has_valid_writes) {
+  assert(parallel_wal_replayer_);
+  Status status =
+      parallel_wal_replayer_->WaitForPendingInserts(has_valid_writes);
+  // Unlike in the single-threaded replay, the failed write batch cannot be
+  // reported as a WAL corruption at its position, since the records after
+  // it may have been inserted already.
+  MaybeIgnoreError(&status);
+  return status;
+}
+
 Status DBImpl::HandleNonOkStatusOrOldLogRecord(
     uint64_t wal_number, SequenceNumber const* const next_sequence,
     Status status, const DBOpenLogRecordReadReporter& reporter,
@@ -1787,6 +1961,7 @@ Status DBImpl::MaybeFlushFinalMemtableOrRestoreActiveLogFiles(
     // no need to refcount since client still doesn't have access
     // to the DB and can not drop column families while we iterate
     const WalNumber max_wal_number = wal_numbers.back();
+    autovector<ColumnFamilyData*> cfds_to_flush;
     for (auto cfd : *versions_->GetColumnFamilySet()) {
       auto iter = version_edits->find(cfd->GetID());
       assert(iter != version_edits->end());
@@ -1811,14 +1986,9 @@ Status DBImpl::MaybeFlushFinalMemtableOrRestoreActiveLogFiles(
         // being full), we flush at the end. Otherwise we'll need to record
         // where we were on last flush, which make the logic complicated.
         if (flushed || !immutable_db_options_.avoid_flush_during_recovery) {
-          status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
-          if (!status.ok()) {
-            // Recovery failed
-            break;
-          }
+          // Flushed below, together with the other column families.
+          cfds_to_flush.push_back(cfd);
           flushed = true;
-
-          cfd->CreateNewMemtable(versions_->LastSequence());
         }
         data_seen = true;
       }
@@ -1835,6 +2005,15 @@ Status DBImpl::MaybeFlushFinalMemtableOrRestoreActiveLogFiles(
         edit->SetLogNumber(max_wal_number + 1);
       }
     }
+    if (!cfds_to_flush.empty()) {
+      status =
+          WriteLevel0TablesForRecovery(job_id, cfds_to_flush, version_edits);
+      if (status.ok()) {
+        for (auto cfd : cfds_to_flush) {
+          cfd->CreateNewMemtable(versions_->LastSequence());
+        }
+      }
+    }
     if (status.ok()) {
       // we must mark the next log number as used, even though it's
       // not actually used. that is because VersionSet assumes
@@ -1901,6 +2080,73 @@ void DBImpl::FinishLogFilesRecovery(int job_id, const Status& status) {
                       << "status" << status.ToString();
 }
 
+Status DBImpl::WriteLevel0TablesForRecovery(
+    int job_id, const autovector<ColumnFamilyData*>& cfds,
+    std::unordered_map<int, VersionEdit>* version_edits) {
+  mutex_.AssertHeld();
+  assert(version_edits);
+
+  const uint64_t start_micros = immutable_db_options_.clock->NowMicros();
+  std::vector<VersionEdit*> edits;
+  edits.reserve(cfds.size());
+  for (auto cfd : cfds) {
+    auto iter = version_edits->find(cfd->GetID());
+    assert(iter != version_edits->end());
+    edits.push_back(&iter->second);
+  }
+
+  Status status;
+  const size_t num_threads = std::min(
+      cfds.size(),
+      static_cast<size_t>(
+          std::max(immutable_db_options_.wal_recovery_threads, 1)));
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < cfds.size(); ++i) {
+      status = WriteLevel0TableForRecovery(job_id, cfds[i], cfds[i]->mem(),
+                                           edits[i]);
+      if (!status.ok()) {
+        break;
+      }
+    }
+  } else {
+    // Each table is built without holding the mutex, so the column families
+    // are flushed in parallel. Clients have no access to the DB yet and no
+    // background work has been scheduled, so releasing the mutex here is as
+    // safe as it is in WriteLevel0TableForRecovery().
+    std::vector<Status> statuses(cfds.size());
+    std::atomic<size_t> next_cfd{0};
+    auto flush_cfds = [&]() {
+      size_t i;
+      while ((i = next_cfd.fetch_add(1, std::memory_order_relaxed)) <
+             cfds.size()) {
+        InstrumentedMutexLock l(&mutex_);
+        statuses[i] = WriteLevel0TableForRecovery(job_id, cfds[i],
+                                                  cfds[i]->mem(), edits[i]);
+      }
+    };
+    mutex_.Unlock();
+    std::vector<port::Thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back(flush_cfds);
+    }
+    flush_cfds();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    mutex_.Lock();
+    for (auto& s : statuses) {
+      if (!s.ok() && status.ok()) {
+        status = s;
+      }
+    }
+  }
+  default_cf_internal_stats_->AddDBStats(
+      InternalStats::kIntStatsWalRecoveryFlushMicros,
+      immutable_db_options_.clock->NowMicros() - start_micros);
+  return status;
+}
+
 Status DBImpl::GetLogSizeAndMaybeTruncate(uint64_t wal_number, bool truncate,
                                           WalFileNumberSize* log_ptr) {
   WalFileNumberSize log(wal_number);
@@ -2520,6 +2766,15 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
                         preallocate_block_size,
                         PredecessorWALInfo() /* predecessor_wal_info */,
                         &new_log);
+    if (s.ok() && impl->immutable_db_options_.enable_pipelined_wal_sync &&
+        !new_log->file()->writable_file()->IsSyncThreadSafe()) {
+      // WAL syncs would otherwise fail on every sync write
+      delete new_log;
+      new_log = nullptr;
+      s = Status::InvalidArgument(
+          "enable_pipelined_wal_sync requires WAL files that can be synced "
+          "concurrently with writes (FSWritableFile::IsSyncThreadSafe())");
+    }
     if (s.ok()) {
       // Prevent log files created by previous instance from being recycled.
       // They might be in alive_log_file_, and might get recycled otherwise.
@@ -96,6 +96,11 @@ class DBImplReadOnly : public DBImpl {
     return Status::NotSupported("Not supported operation in read only mode.");
   }
 
+  Status CompactBlobFiles(const CompactBlobFilesOptions& /*options*/,
+                          ColumnFamilyHandle* /*column_family*/) override {
+    return Status::NotSupported("Not supported operation in read only mode.");
+  }
+
   Status DisableFileDeletions() override {
     return Status::NotSupported("Not supported operation in read only mode.");
   }
@@ -186,6 +186,11 @@ class DBImplSecondary : public DBImpl {
     return Status::NotSupported("Not supported operation in secondary mode.");
   }
 
+  Status CompactBlobFiles(const CompactBlobFilesOptions& /*options*/,
+                          ColumnFamilyHandle* /*column_family*/) override {
+    return Status::NotSupported("Not supported operation in secondary mode.");
+  }
+
   Status DisableFileDeletions() override {
     return Status::NotSupported("Not supported operation in secondary mode.");
   }
@@ -516,12 +516,23 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                                      // every key is a sub-batch consuming a seq
                                      : WriteBatchInternal::Count(my_batch);
     uint64_t seq = 0;
-    // Use a write thread to i) optimize for WAL write, ii) publish last
-    // sequence in in increasing order, iii) call pre_release_callback serially
-    Status status = WriteImplWALOnly(
-        &write_thread_, write_options, my_batch, callback, user_write_cb,
-        wal_used, log_ref, &seq, sub_batch_cnt, pre_release_callback,
-        kDoAssignOrder, kDoPublishLastSeq, disable_memtable);
+    Status status;
+    if (immutable_db_options_.core_local_write_staging &&
+        CanStageUnorderedWrite(write_options, my_batch, callback,
+                               user_write_cb, log_ref, batch_cnt,
+                               pre_release_callback, post_memtable_callback,
+                               disable_memtable)) {
+      status =
+          StagedUnorderedWriteWAL(write_options, my_batch, wal_used, &seq);
+    } else {
+      // Use a write thread to i) optimize for WAL write, ii) publish last
+      // sequence in in increasing order, iii) call pre_release_callback
+      // serially
+      status = WriteImplWALOnly(
+          &write_thread_, write_options, my_batch, callback, user_write_cb,
+          wal_used, log_ref, &seq, sub_batch_cnt, pre_release_callback,
+          kDoAssignOrder, kDoPublishLastSeq, disable_memtable);
+    }
     TEST_SYNC_POINT("DBImpl::WriteImpl:UnorderedWriteAfterWriteWAL");
     if (!status.ok()) {
       return status;
@@ -988,7 +999,13 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     if (w.callback && !w.callback->AllowWriteBatching()) {
       write_thread_.WaitForMemTableWriters();
     }
-    WalContext wal_context(!write_options.disableWAL && write_options.sync);
+    // With enable_pipelined_wal_sync, the WAL sync is left to the memtable
+    // stage so that the next write group can write to the WAL meanwhile.
+    const bool defer_wal_sync =
+        immutable_db_options_.enable_pipelined_wal_sync &&
+        !write_options.disableWAL && write_options.sync;
+    WalContext wal_context(!write_options.disableWAL && write_options.sync &&
+                           !defer_wal_sync);
     // PreprocessWrite does its own perf timing.
     PERF_TIMER_STOP(write_pre_and_post_process_time);
     w.status = PreprocessWrite(write_options, &wal_context, &write_context);
@@ -1077,6 +1094,15 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
       WriteStatusCheck(w.status);
     }
 
+    if (defer_wal_sync && w.status.ok()) {
+      const uint64_t ticket = wal_group_sync_requested_.fetch_add(1) + 1;
+      for (auto* writer : wal_write_group) {
+        writer->wal_sync_ticket = ticket;
+      }
+      TEST_SYNC_POINT_CALLBACK("DBImpl::PipelinedWriteImpl:WalSyncDeferred",
+                               &wal_write_group);
+    }
+
     VersionEdit synced_wals;
     if (wal_context.need_wal_sync) {
       InstrumentedMutexLock l(&wal_write_mutex_);
@@ -1106,8 +1132,18 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     PERF_TIMER_FOR_WAIT_GUARD(write_memtable_time);
     assert(w.ShouldWriteToMemtable());
     write_thread_.EnterAsMemTableWriter(&w, &memtable_write_group);
-    if (memtable_write_group.size > 1 &&
-        immutable_db_options_.allow_concurrent_memtable_write) {
+    uint64_t wal_sync_ticket = 0;
+    for (auto* writer : memtable_write_group) {
+      wal_sync_ticket = std::max(wal_sync_ticket, writer->wal_sync_ticket);
+    }
+    if (wal_sync_ticket > 0) {
+      // Not visible to readers before it is durable
+      memtable_write_group.status = WaitForWalGroupSync(wal_sync_ticket);
+    }
+    if (!memtable_write_group.status.ok()) {
+      write_thread_.ExitAsMemTableWriter(&w, memtable_write_group);
+    } else if (memtable_write_group.size > 1 &&
+               immutable_db_options_.allow_concurrent_memtable_write) {
       write_thread_.LaunchParallelMemTableWriters(&memtable_write_group);
     } else {
       memtable_write_group.status = WriteBatchInternal::InsertInto(
@@ -1157,6 +1193,12 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
       write_thread_.ExitAsMemTableWriter(&w, *w.write_group);
     }
   }
+  if (w.wal_sync_ticket > 0 && w.status.ok() && !w.CallbackFailed() &&
+      w.disable_memtable) {
+    // Completed on leaving the WAL stage, without a memtable stage to wait
+    // for the WAL sync in
+    w.status = WaitForWalGroupSync(w.wal_sync_ticket);
+  }
   if (seq_used != nullptr) {
     *seq_used = w.sequence;
   }
@@ -1165,6 +1207,51 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
   return w.FinalStatus();
 }
 
+Status DBImpl::WaitForWalGroupSync(uint64_t ticket) {
+  assert(immutable_db_options_.enable_pipelined_wal_sync);
+  InstrumentedMutexLock l(&wal_group_sync_mutex_);
+  while (true) {
+    if (wal_group_sync_done_ >= ticket) {
+      return Status::OK();
+    }
+    if (wal_group_sync_failed_up_to_ >= ticket) {
+      return wal_group_sync_error_;
+    }
+    if (!wal_group_sync_in_progress_) {
+      break;
+    }
+    wal_group_sync_cv_.Wait();
+  }
+
+  // Become the syncer for every write group that wrote to the WAL so far
+  wal_group_sync_in_progress_ = true;
+  const uint64_t covered = wal_group_sync_requested_.load();
+  assert(covered >= ticket);
+  Status s;
+  wal_group_sync_mutex_.Unlock();
+  {
+    PERF_TIMER_GUARD(write_wal_time);
+    StopWatch sw(immutable_db_options_.clock, stats_, WAL_FILE_SYNC_MICROS);
+    TEST_SYNC_POINT("DBImpl::WaitForWalGroupSync:BeforeSync");
+    s = SyncWAL();
+  }
+  if (s.ok()) {
+    default_cf_internal_stats_->AddDBStats(
+        InternalStats::kIntStatsWalFileSynced, 1);
+  }
+  wal_group_sync_mutex_.Lock();
+  if (s.ok()) {
+    wal_group_sync_done_ = covered;
+  } else {
+    wal_group_sync_failed_up_to_ = covered;
+    wal_group_sync_error_ = s;
+    wal_group_sync_error_.PermitUncheckedError();
+  }
+  wal_group_sync_in_progress_ = false;
+  wal_group_sync_cv_.SignalAll();
+  return s;
+}
+
 Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
                                       WriteBatch* my_batch,
                                       WriteCallback* callback, uint64_t log_ref,
@@ -1202,14 +1289,19 @@ Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
     PERF_TIMER_START(write_pre_and_post_process_time);
   }
 
-  size_t pending_cnt = pending_memtable_writes_.fetch_sub(1) - 1;
-  if (pending_cnt == 0) {
-    // switch_cv_ waits until pending_memtable_writes_ = 0. Locking its mutex
-    // before notify ensures that cv is in waiting state when it is notified
-    // thus not missing the update to pending_memtable_writes_ even though it is
-    // not modified under the mutex.
+  pending_memtable_writes_.Access()->obj_.fetch_sub(1);
+  // The waiter publishes pending_memtable_writes_waiter_ before summing the
+  // shards and we decrement before checking it, so (both being sequentially
+  // consistent) either it observes our decrement or we observe the flag.
+  if (pending_memtable_writes_waiter_.load()) {
+    // switch_cv_ waits until pending_memtable_writes_ sums up to 0. Locking
+    // its mutex before notify ensures that cv is in waiting state when it is
+    // notified thus not missing the update to pending_memtable_writes_ even
+    // though it is not modified under the mutex.
     std::lock_guard<std::mutex> lck(switch_mutex_);
-    switch_cv_.notify_all();
+    if (NumPendingMemTableWrites() == 0) {
+      switch_cv_.notify_all();
+    }
   }
   WriteStatusCheck(w.status);
 
@@ -1222,17 +1314,116 @@ Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
 // The 2nd write queue. If enabled it will be used only for WAL-only writes.
 // This is the only queue that updates LastPublishedSequence which is only
 // applicable in a two-queue setting.
+bool DBImpl::CanStageUnorderedWrite(
+    const WriteOptions& write_options, const WriteBatch* my_batch,
+    WriteCallback* callback, UserWriteCallback* user_write_cb,
+    uint64_t log_ref, size_t batch_cnt,
+    PreReleaseCallback* pre_release_callback,
+    PostMemTableCallback* post_memtable_callback,
+    bool disable_memtable) const {
+  // Staged batches are merged and written with the options of whichever
+  // writer takes them to the WAL, so only plain writes are staged.
+  return callback == nullptr && user_write_cb == nullptr && log_ref == 0 &&
+         batch_cnt == 0 && pre_release_callback == nullptr &&
+         post_memtable_callback == nullptr && !disable_memtable &&
+         !seq_per_batch_ && !write_options.disableWAL &&
+         !write_options.no_slowdown &&
+         write_options.rate_limiter_priority == Env::IO_TOTAL &&
+         my_batch->GetProtectionBytesPerKey() == 0;
+}
+
+Status DBImpl::StagedUnorderedWriteWAL(const WriteOptions& write_options,
+                                       WriteBatch* my_batch,
+                                       uint64_t* wal_used,
+                                       SequenceNumber* seq_used) {
+  assert(immutable_db_options_.unordered_write);
+  StagedWrite w(my_batch, write_options.sync);
+  WriteStagingShard* shard = &write_staging_shards_.Access()->obj_;
+  std::vector<StagedWrite*> group;
+  {
+    MutexLock l(&shard->mutex);
+    shard->staged.push_back(&w);
+    TEST_SYNC_POINT_CALLBACK("DBImpl::StagedUnorderedWriteWAL:Staged", shard);
+    while (shard->draining && !w.done) {
+      shard->cv.Wait();
+    }
+    if (!w.done) {
+      // Take everything staged on this core to the WAL
+      shard->draining = true;
+      group.swap(shard->staged);
+    }
+  }
+  if (group.empty()) {
+    // Written by another writer of this core
+    if (wal_used != nullptr) {
+      *wal_used = w.wal_used;
+    }
+    *seq_used = w.sequence;
+    return w.status;
+  }
+  [[maybe_unused]] size_t group_size = group.size();
+  TEST_SYNC_POINT_CALLBACK("DBImpl::StagedUnorderedWriteWAL:Group",
+                           &group_size);
+
+  WriteOptions group_options = write_options;
+  WriteBatch merged_batch;
+  WriteBatch* group_batch = my_batch;
+  Status status;
+  if (group.size() > 1) {
+    group_batch = &merged_batch;
+    for (auto* staged : group) {
+      group_options.sync |= staged->sync;
+      status = WriteBatchInternal::Append(&merged_batch, staged->batch);
+      if (!status.ok()) {
+        break;
+      }
+    }
+  }
+  SequenceNumber seq = 0;
+  uint64_t group_wal_used = 0;
+  if (status.ok()) {
+    // Reserves one range of sequence numbers for the whole group, and counts
+    // every staged write as a pending memtable write
+    status = WriteImplWALOnly(
+        &write_thread_, group_options, group_batch, /*callback=*/nullptr,
+        /*user_write_cb=*/nullptr, &group_wal_used, /*log_ref=*/0, &seq,
+        WriteBatchInternal::Count(group_batch),
+        /*pre_release_callback=*/nullptr, kDoAssignOrder, kDoPublishLastSeq,
+        /*disable_memtable=*/false, group.size());
+  }
+
+  {
+    MutexLock l(&shard->mutex);
+    for (auto* staged : group) {
+      staged->sequence = seq;
+      seq += WriteBatchInternal::Count(staged->batch);
+      staged->wal_used = group_wal_used;
+      staged->status = status;
+      staged->done = true;
+    }
+    shard->draining = false;
+    shard->cv.SignalAll();
+  }
+  if (wal_used != nullptr) {
+    *wal_used = group_wal_used;
+  }
+  *seq_used = w.sequence;
+  return status;
+}
+
 Status DBImpl::WriteImplWALOnly(
     WriteThread* write_thread, const WriteOptions& write_options,
     WriteBatch* my_batch, WriteCallback* callback,
     UserWriteCallback* user_write_cb, uint64_t* wal_used,
     const uint64_t log_ref, uint64_t* seq_used, const size_t sub_batch_cnt,
     PreReleaseCallback* pre_release_callback, const AssignOrder assign_order,
-    const PublishLastSeq publish_last_seq, const bool disable_memtable) {
+    const PublishLastSeq publish_last_seq, const bool disable_memtable,
+    const size_t staged_write_cnt) {
   PERF_TIMER_GUARD(write_pre_and_post_process_time);
   WriteThread::Writer w(write_options, my_batch, callback, user_write_cb,
                         log_ref, disable_memtable, sub_batch_cnt,
                         pre_release_callback);
+  w.staged_write_cnt = staged_write_cnt;
   StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE);
 
   write_thread->JoinBatchGroup(&w);
@@ -1383,7 +1574,7 @@ Status DBImpl::WriteImplWALOnly(
       curr_seq += writer->batch_cnt;
     }
     if (!writer->disable_memtable) {
-      memtable_write_cnt++;
+      memtable_write_cnt += writer->staged_write_cnt;
     }
     // else seq advances only by memtable writes
   }
@@ -1423,7 +1614,8 @@ Status DBImpl::WriteImplWALOnly(
     assert(immutable_db_options_.unordered_write);
   }
   if (immutable_db_options_.unordered_write && status.ok()) {
-    pending_memtable_writes_ += memtable_write_cnt;
+    pending_memtable_writes_.Access()->obj_.fetch_add(
+        static_cast<int64_t>(memtable_write_cnt));
   }
   write_thread->ExitAsBatchGroupLeader(write_group, status);
   if (status.ok()) {
@@ -514,6 +514,106 @@ TEST_F(DBMemTableTest, VectorConcurrentInsert) {
   ASSERT_OK(Flush(0));
   ASSERT_OK(Flush(1));
 }
+
+TEST_F(DBMemTableTest, BTreeConcurrentInsert) {
+  Options options;
+  options.create_if_missing = true;
+  options.allow_concurrent_memtable_write = true;
+  options.write_buffer_size = 64 << 20;
+  options.memtable_factory.reset(new BTreeRepFactory());
+  DestroyAndReopen(options);
+
+  // Enough keys to grow the tree to three levels, written by concurrent
+  // writers while readers keep seeking.
+  const int kNumThreads = 8;
+  const int kKeysPerThread = 4000;
+  const int kNumKeys = kNumThreads * kKeysPerThread;
+  std::atomic<bool> writes_done{false};
+  std::vector<port::Thread> readers;
+  for (int i = 0; i < 2; ++i) {
+    readers.emplace_back([&]() {
+      Random rnd(301);
+      while (!writes_done.load()) {
+        std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+        std::string target = Key(rnd.Uniform(kNumKeys));
+        iter->Seek(target);
+        std::string prev;
+        for (int j = 0; j < 10 && iter->Valid(); ++j, iter->Next()) {
+          ASSERT_GE(iter->key().ToString(), target);
+          ASSERT_GT(iter->key().ToString(), prev);
+          prev = iter->key().ToString();
+        }
+        ASSERT_OK(iter->status());
+      }
+    });
+  }
+  {
+    std::vector<port::Thread> writers;
+    for (int i = 0; i < kNumThreads; ++i) {
+      writers.emplace_back([&, i]() {
+        WriteOptions write_options;
+        // Interleave the key ranges of the writers.
+        for (int j = 0; j < kKeysPerThread; j += 10) {
+          WriteBatch batch;
+          for (int k = j; k < j + 10; ++k) {
+            int key = k * kNumThreads + i;
+            ASSERT_OK(batch.Put(Key(key), "value" + std::to_string(key)));
+          }
+          ASSERT_OK(db_->Write(write_options, &batch));
+        }
+      });
+    }
+    for (auto& t : writers) {
+      t.join();
+    }
+  }
+  writes_done.store(true);
+  for (auto& t : readers) {
+    t.join();
+  }
+
+  auto verify = [&]() {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key().ToString(), Key(i));
+      ASSERT_EQ(iter->value().ToString(), "value" + std::to_string(i));
+      iter->Next();
+    }
+    ASSERT_FALSE(iter->Valid());
+    iter->SeekToLast();
+    for (int i = kNumKeys - 1; i >= 0; --i) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key().ToString(), Key(i));
+      iter->Prev();
+    }
+    ASSERT_FALSE(iter->Valid());
+    iter->Seek(Key(kNumKeys / 2) + "a");
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(iter->key().ToString(), Key(kNumKeys / 2 + 1));
+    iter->SeekForPrev(Key(kNumKeys / 2) + "a");
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(iter->key().ToString(), Key(kNumKeys / 2));
+    ASSERT_OK(iter->status());
+    for (int i = 0; i < kNumKeys; i += 97) {
+      ASSERT_EQ(Get(Key(i)), "value" + std::to_string(i));
+    }
+  };
+  verify();
+
+  // Overwrites and deletes create multiple versions of the same user key.
+  ASSERT_OK(Put(Key(7), "new"));
+  ASSERT_OK(Delete(Key(8)));
+  ASSERT_EQ(Get(Key(7)), "new");
+  ASSERT_EQ(Get(Key(8)), "NOT_FOUND");
+  ASSERT_OK(Put(Key(7), "value7"));
+  ASSERT_OK(Put(Key(8), "value8"));
+  verify();
+
+  ASSERT_OK(Flush());
+  verify();
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -558,6 +558,108 @@ TEST_F(DBRangeDelTest, CompactionRemovesCoveredMergeOperands) {
   ASSERT_EQ(expected, actual);
 }
 
+TEST_F(DBRangeDelTest, ReadsWhileDeletingRangesInMemtable) {
+  // The fragmented range tombstones of the memtable are updated incrementally
+  // between reads, or rebuilt when many tombstones were added since the last
+  // read.
+  Options options = CurrentOptions();
+  options.write_buffer_size = 64 << 20;
+  DestroyAndReopen(options);
+
+  constexpr int kNumKeys = 200;
+  std::vector<bool> live(kNumKeys, true);
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), "val" + std::to_string(i)));
+  }
+  auto verify = [&]() {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    for (int i = 0; i < kNumKeys; ++i) {
+      if (live[i]) {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(Key(i), iter->key());
+        iter->Next();
+      }
+      ASSERT_EQ(live[i] ? "val" + std::to_string(i) : "NOT_FOUND", Get(Key(i)));
+    }
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+  };
+
+  Random rnd(301);
+  for (int round = 0; round < 800; ++round) {
+    const int start = static_cast<int>(rnd.Uniform(kNumKeys));
+    const int end =
+        std::min(kNumKeys, start + static_cast<int>(rnd.Uniform(8)));
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               Key(start), Key(end)));
+    std::fill(live.begin() + start, live.begin() + end, false);
+    const int key = static_cast<int>(rnd.Uniform(kNumKeys));
+    ASSERT_OK(Put(Key(key), "val" + std::to_string(key)));
+    live[key] = true;
+    // No reads for a while in the middle.
+    if (round % 5 == 0 && (round < 200 || round > 600)) {
+      verify();
+    }
+  }
+  verify();
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  verify();
+  ASSERT_OK(Flush());
+  verify();
+}
+
+TEST_F(DBRangeDelTest, ConcurrentDeleteRangeGetFlush) {
+  // Readers that fragment the memtable range tombstones while DeleteRanges
+  // are added must not count a tombstone twice, or flush fails to verify the
+  // number of memtable entries.
+  Options options = CurrentOptions();
+  options.flush_verify_memtable_count = true;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  constexpr int kNumKeys = 1000;
+  constexpr int kNumReaders = 2;
+  constexpr int kNumFlushes = 10;
+  std::atomic<bool> stop{false};
+  std::vector<port::Thread> threads;
+  threads.emplace_back([&]() {
+    Random rnd(301);
+    while (!stop.load(std::memory_order_relaxed)) {
+      const int start = static_cast<int>(rnd.Uniform(kNumKeys));
+      const int end = start + 1 + static_cast<int>(rnd.Uniform(10));
+      ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                                 Key(start), Key(end)));
+      const int key = static_cast<int>(rnd.Uniform(kNumKeys));
+      ASSERT_OK(Put(Key(key), "val"));
+    }
+  });
+  for (int i = 0; i < kNumReaders; ++i) {
+    threads.emplace_back([&, i]() {
+      Random rnd(static_cast<uint32_t>(i));
+      std::string value;
+      while (!stop.load(std::memory_order_relaxed)) {
+        Status s = db_->Get(ReadOptions(),
+                            Key(static_cast<int>(rnd.Uniform(kNumKeys))),
+                            &value);
+        ASSERT_TRUE(s.ok() || s.IsNotFound());
+      }
+    });
+  }
+  for (int i = 0; i < kNumFlushes; ++i) {
+    env_->SleepForMicroseconds(20000);
+    ASSERT_OK(Flush());
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_GetBGError());
+}
+
 TEST_F(DBRangeDelTest, PutDeleteRangeMergeFlush) {
   // Test the sequence of operations: (1) Put, (2) DeleteRange, (3) Merge, (4)
   // Flush. The `CompactionIterator` previously had a bug where we forgot to
@@ -1248,6 +1350,88 @@ TEST_F(DBRangeDelTest, UnorderedTombstones) {
   ASSERT_TRUE(s.IsNotFound());
 }
 
+TEST_F(DBRangeDelTest, DropFilesCoveredByStandaloneRangeDeletion) {
+  // Counts the input files of the compactions dropping covered files.
+  class DroppedFilesListener : public EventListener {
+   public:
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& ci) override {
+      if (ci.compaction_reason ==
+          CompactionReason::kFilesCoveredByRangeDeletion) {
+        EXPECT_EQ(ci.base_input_level, ci.output_level);
+        EXPECT_TRUE(ci.output_files.empty());
+        num_dropped_files += ci.input_files.size();
+      }
+    }
+    std::atomic<size_t> num_dropped_files{0};
+  };
+  auto listener = std::make_shared<DroppedFilesListener>();
+  Options options = CurrentOptions();
+  options.listeners.push_back(listener);
+  DestroyAndReopen(options);
+
+  // L6: [key000000, key000009] [key000010, key000019] [key000020, key000029]
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      ASSERT_OK(Put(Key(10 * i + j), "val"));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(6);
+  }
+  ASSERT_EQ(3, NumTableFilesAtLevel(6));
+
+  // A flush of just the range tombstone makes a standalone range tombstone
+  // file in L0, which covers the first two files of L6.
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(0), Key(25)));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  // The snapshot still sees the covered files, so no compaction is needed.
+  ASSERT_EQ(3, NumTableFilesAtLevel(6));
+  ASSERT_EQ(0, listener->num_dropped_files.load());
+  uint64_t compaction_pending = 0;
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kCompactionPending,
+                                  &compaction_pending));
+  ASSERT_EQ(0, compaction_pending);
+
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  ASSERT_EQ(1, NumTableFilesAtLevel(6));
+  ASSERT_EQ(2, listener->num_dropped_files.load());
+  for (int i = 0; i < 30; ++i) {
+    if (i < 25) {
+      ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+    } else {
+      ASSERT_EQ("val", Get(Key(i)));
+    }
+  }
+
+  // The range tombstone still deletes the keys after being compacted with
+  // the remaining file.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("NOT_FOUND", Get(Key(24)));
+  ASSERT_EQ("val", Get(Key(25)));
+
+  // Without any snapshot, a covered file is dropped right after the flush.
+  for (int i = 30; i < 40; ++i) {
+    ASSERT_OK(Put(Key(i), "val"));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(6);
+  const int num_l6_files = NumTableFilesAtLevel(6);
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(30), Key(40)));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(num_l6_files - 1, NumTableFilesAtLevel(6));
+  ASSERT_EQ(3, listener->num_dropped_files.load());
+  ASSERT_EQ("NOT_FOUND", Get(Key(30)));
+  ASSERT_EQ("val", Get(Key(25)));
+}
+
 class MockMergeOperator : public MergeOperator {
   // Mock non-associative operator. Non-associativity is expressed by lack of
   // implementation for any `PartialMerge*` functions.
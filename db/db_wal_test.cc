@@ -1321,6 +1321,83 @@ TEST_F(DBWALTest, RecoverWithLargeLog) {
   } while (ChangeWalOptions());
 }
 
+TEST_F(DBWALTest, ParallelWalRecovery) {
+  for (bool avoid_flush_during_recovery : {false, true}) {
+    Options options = CurrentOptions();
+    options.merge_operator = MergeOperators::CreateStringAppendOperator();
+    options.avoid_flush_during_recovery = avoid_flush_during_recovery;
+    DestroyAndReopen(options);
+    CreateAndReopenWithCF({"one", "two", "three"}, options);
+
+    // Random batches spanning column families, with puts, merges, deletes
+    // and range deletions, all left in the WAL.
+    Random rnd(301);
+    std::vector<std::map<std::string, std::string>> expected(4);
+    for (int i = 0; i < 2000; ++i) {
+      WriteBatch batch;
+      for (int j = 0; j < 4; ++j) {
+        const int cf = static_cast<int>(rnd.Uniform(4));
+        const int k = static_cast<int>(rnd.Uniform(500));
+        const std::string key = Key(k);
+        auto& kvs = expected[cf];
+        if (rnd.OneIn(50)) {
+          const std::string end_key = Key(k + 3);
+          ASSERT_OK(batch.DeleteRange(handles_[cf], key, end_key));
+          kvs.erase(kvs.lower_bound(key), kvs.lower_bound(end_key));
+        } else if (rnd.OneIn(5)) {
+          ASSERT_OK(batch.Delete(handles_[cf], key));
+          kvs.erase(key);
+        } else if (rnd.OneIn(4)) {
+          const std::string value = rnd.RandomString(20);
+          ASSERT_OK(batch.Merge(handles_[cf], key, value));
+          auto it = kvs.find(key);
+          if (it == kvs.end()) {
+            kvs[key] = value;
+          } else {
+            it->second += "," + value;
+          }
+        } else {
+          const std::string value = rnd.RandomString(100);
+          ASSERT_OK(batch.Put(handles_[cf], key, value));
+          kvs[key] = value;
+        }
+      }
+      ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    }
+
+    // A small write buffer makes the memtables fill up and get flushed in
+    // the middle of the recovery.
+    options.wal_recovery_threads = 4;
+    options.write_buffer_size = 64 << 10;
+    ReopenWithColumnFamilies({"default", "one", "two", "three"}, options);
+
+    for (int cf = 0; cf < 4; ++cf) {
+      std::map<std::string, std::string> actual;
+      std::unique_ptr<Iterator> iter(
+          db_->NewIterator(ReadOptions(), handles_[cf]));
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        actual[iter->key().ToString()] = iter->value().ToString();
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(expected[cf], actual);
+    }
+
+    std::map<std::string, std::string> db_stats;
+    ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kDBStats, &db_stats));
+    ASSERT_GT(std::stoull(db_stats.at("db.wal_recovery_insert_micros")), 0);
+    ASSERT_GT(std::stoull(db_stats.at("db.wal_recovery_flush_micros")), 0);
+
+    // Reopening with a single thread recovers the same data.
+    options.wal_recovery_threads = 1;
+    ReopenWithColumnFamilies({"default", "one", "two", "three"}, options);
+    for (int cf = 0; cf < 4; ++cf) {
+      for (const auto& kv : expected[cf]) {
+        ASSERT_EQ(kv.second, Get(cf, kv.first));
+      }
+    }
+  }
+}
+
 // In https://reviews.facebook.net/D20661 we change
 // recovery behavior: previously for each log file each column family
 // memtable was flushed, even it was empty. Now it's changed:
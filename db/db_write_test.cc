@@ -3,11 +3,15 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "db/db_test_util.h"
@@ -493,6 +497,316 @@ TEST_F(DBWriteTestUnparameterized, PipelinedWriteRace) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
 }
 
+// Memtable switches have to wait for unordered_write memtable writers that
+// already went through the WAL, whose pending count is spread over per-core
+// shards.
+TEST_F(DBWriteTestUnparameterized, UnorderedWriteMemTableSwitchRace) {
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.unordered_write = true;
+  options.allow_concurrent_memtable_write = true;
+  options.write_buffer_size = 64 << 10;
+  options.max_write_buffer_number = 4;
+  DestroyAndReopen(options);
+
+  std::atomic<int> memtable_waits{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WaitForPendingWrites:BeforeBlock",
+      [&](void*) { memtable_waits.fetch_add(1); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumKeysPerThread = 500;
+  const std::string value(256, 'v');
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kNumKeysPerThread; i++) {
+        ASSERT_OK(Put("key" + std::to_string(t) + "_" + std::to_string(i),
+                      value));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_GT(memtable_waits.load(), 0);
+  for (int t = 0; t < kNumThreads; t++) {
+    for (int i = 0; i < kNumKeysPerThread; i++) {
+      ASSERT_EQ(value,
+                Get("key" + std::to_string(t) + "_" + std::to_string(i)));
+    }
+  }
+}
+
+TEST_F(DBWriteTestUnparameterized, CoreLocalWriteStaging) {
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.core_local_write_staging = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+
+  options.unordered_write = true;
+  options.allow_concurrent_memtable_write = true;
+  DestroyAndReopen(options);
+
+  // Hold the first writer to reach the WAL until all writers have staged
+  // their batches. The writers staged on the same core as the first one
+  // have to go to the WAL together in the next group of that core.
+  constexpr int kNumThreads = 8;
+  std::mutex mu;
+  std::condition_variable cv;
+  int num_staged = 0;
+  std::unordered_map<void*, int> staged_per_shard;
+  void* first_shard = nullptr;
+  std::vector<std::pair<void*, size_t>> groups;
+  static thread_local void* my_shard = nullptr;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::StagedUnorderedWriteWAL:Staged", [&](void* arg) {
+        my_shard = arg;
+        std::lock_guard<std::mutex> l(mu);
+        num_staged++;
+        staged_per_shard[arg]++;
+        cv.notify_all();
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::StagedUnorderedWriteWAL:Group", [&](void* arg) {
+        std::unique_lock<std::mutex> l(mu);
+        groups.emplace_back(my_shard, *static_cast<size_t*>(arg));
+        if (first_shard == nullptr) {
+          first_shard = my_shard;
+          cv.wait(l, [&] { return num_staged == kNumThreads; });
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back(
+        [&, t] { ASSERT_OK(Put("key" + std::to_string(t), Key(t))); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Every write went to the WAL in exactly one group
+  size_t total = 0;
+  for (const auto& group : groups) {
+    total += group.second;
+  }
+  ASSERT_EQ(total, static_cast<size_t>(kNumThreads));
+  const size_t num_held_back =
+      static_cast<size_t>(staged_per_shard[first_shard] - 1);
+  if (num_held_back > 0) {
+    ASSERT_NE(std::find(groups.begin(), groups.end(),
+                        std::make_pair(first_shard, num_held_back)),
+              groups.end());
+  }
+
+  // Each write got its own range of sequence numbers
+  ASSERT_EQ(static_cast<SequenceNumber>(kNumThreads),
+            dbfull()->GetLatestSequenceNumber());
+  Reopen(options);
+  ASSERT_EQ(static_cast<SequenceNumber>(kNumThreads),
+            dbfull()->GetLatestSequenceNumber());
+  for (int t = 0; t < kNumThreads; t++) {
+    ASSERT_EQ(Key(t), Get("key" + std::to_string(t)));
+  }
+}
+
+TEST_F(DBWriteTestUnparameterized, CoreLocalWriteStagingMemTableSwitch) {
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.unordered_write = true;
+  options.allow_concurrent_memtable_write = true;
+  options.core_local_write_staging = true;
+  options.write_buffer_size = 64 << 10;
+  options.max_write_buffer_number = 4;
+  DestroyAndReopen(options);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumKeysPerThread = 500;
+  const std::string value(256, 'v');
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t] {
+      WriteOptions wo;
+      // Staged with writes of other threads, a sync write makes the whole
+      // group sync
+      wo.sync = (t == 0);
+      for (int i = 0; i < kNumKeysPerThread; i++) {
+        ASSERT_OK(dbfull()->Put(
+            wo, "key" + std::to_string(t) + "_" + std::to_string(i), value));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  ASSERT_EQ(static_cast<SequenceNumber>(kNumThreads * kNumKeysPerThread),
+            dbfull()->GetLatestSequenceNumber());
+  for (int pass = 0; pass < 2; pass++) {
+    for (int t = 0; t < kNumThreads; t++) {
+      for (int i = 0; i < kNumKeysPerThread; i++) {
+        ASSERT_EQ(value,
+                  Get("key" + std::to_string(t) + "_" + std::to_string(i)));
+      }
+    }
+    Reopen(options);
+  }
+}
+
+TEST_F(DBWriteTestUnparameterized, PipelinedWalSync) {
+  std::unique_ptr<FaultInjectionTestEnv> fault_env(
+      new FaultInjectionTestEnv(env_));
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.env = fault_env.get();
+  options.enable_pipelined_wal_sync = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.enable_pipelined_write = true;
+  options.manual_wal_flush = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.manual_wal_flush = false;
+
+  // WAL files that cannot be synced concurrently with writes
+  class NoSyncThreadSafeFileSystem : public FileSystemWrapper {
+   public:
+    explicit NoSyncThreadSafeFileSystem(
+        const std::shared_ptr<FileSystem>& base)
+        : FileSystemWrapper(base) {}
+    static const char* kClassName() { return "NoSyncThreadSafeFileSystem"; }
+    const char* Name() const override { return kClassName(); }
+    IOStatus NewWritableFile(const std::string& fname,
+                             const FileOptions& file_opts,
+                             std::unique_ptr<FSWritableFile>* result,
+                             IODebugContext* dbg) override {
+      IOStatus s = target()->NewWritableFile(fname, file_opts, result, dbg);
+      if (s.ok()) {
+        *result = std::make_unique<NoSyncThreadSafeFile>(std::move(*result));
+      }
+      return s;
+    }
+
+   private:
+    class NoSyncThreadSafeFile : public FSWritableFileOwnerWrapper {
+     public:
+      explicit NoSyncThreadSafeFile(std::unique_ptr<FSWritableFile>&& file)
+          : FSWritableFileOwnerWrapper(std::move(file)) {}
+      bool IsSyncThreadSafe() const override { return false; }
+    };
+  };
+  std::unique_ptr<Env> no_sync_thread_safe_env(NewCompositeEnv(
+      std::make_shared<NoSyncThreadSafeFileSystem>(env_->GetFileSystem())));
+  options.env = no_sync_thread_safe_env.get();
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.env = fault_env.get();
+
+  // Switch memtables and WALs while sync writes are in flight
+  options.write_buffer_size = 64 << 10;
+  DestroyAndReopen(options);
+
+  std::atomic<int> num_syncs{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WaitForWalGroupSync:BeforeSync",
+      [&](void*) { num_syncs.fetch_add(1); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumKeysPerThread = 200;
+  const std::string value(1024, 'v');
+  WriteOptions write_options;
+  write_options.sync = true;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kNumKeysPerThread; i++) {
+        ASSERT_OK(db_->Put(write_options,
+                           "key" + std::to_string(t) + "_" + std::to_string(i),
+                           value));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_GT(num_syncs.load(), 0);
+
+  // Every acknowledged write survives losing unsynced data
+  Close();
+  ASSERT_OK(fault_env->DropUnsyncedFileData());
+  Reopen(options);
+  for (int t = 0; t < kNumThreads; t++) {
+    for (int i = 0; i < kNumKeysPerThread; i++) {
+      ASSERT_EQ(value,
+                Get("key" + std::to_string(t) + "_" + std::to_string(i)));
+    }
+  }
+  // Need to close before `fault_env` goes out of scope.
+  Close();
+}
+
+TEST_F(DBWriteTestUnparameterized, PipelinedWalSyncOverlap) {
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.enable_pipelined_write = true;
+  options.enable_pipelined_wal_sync = true;
+  DestroyAndReopen(options);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  int num_syncs = 0;
+  // Writes appended to the WAL with their sync deferred
+  size_t num_appended = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::PipelinedWriteImpl:WalSyncDeferred", [&](void* arg) {
+        auto* write_group = static_cast<WriteThread::WriteGroup*>(arg);
+        std::lock_guard<std::mutex> lock(mutex);
+        num_appended += write_group->size;
+        cv.notify_all();
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WaitForWalGroupSync:BeforeSync", [&](void*) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (++num_syncs == 1) {
+          cv.notify_all();
+          // Hold the first sync until two more writes reach the WAL
+          cv.wait(lock, [&] { return num_appended >= 3; });
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  WriteOptions write_options;
+  write_options.sync = true;
+  port::Thread first([&] { ASSERT_OK(db_->Put(write_options, "k1", "v1")); });
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return num_syncs == 1; });
+  }
+  // Later write groups append to the WAL while the first sync is in flight
+  port::Thread second([&] { ASSERT_OK(db_->Put(write_options, "k2", "v2")); });
+  port::Thread third([&] { ASSERT_OK(db_->Put(write_options, "k3", "v3")); });
+  first.join();
+  second.join();
+  third.join();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The first sync covered only the first write, and a single sync covered
+  // both later ones
+  ASSERT_EQ(num_syncs, 2);
+  ASSERT_EQ("v1", Get("k1"));
+  ASSERT_EQ("v2", Get("k2"));
+  ASSERT_EQ("v3", Get("k3"));
+}
+
 TEST_P(DBWriteTest, ManualWalFlushInEffect) {
   Options options = GetOptions();
   Reopen(options);
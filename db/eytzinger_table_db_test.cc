@@ -0,0 +1,238 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+#include "rocksdb/sst_file_reader.h"
+#include "rocksdb/table.h"
+#include "table/eytzinger/eytzinger_table_builder.h"
+#include "table/eytzinger/eytzinger_table_factory.h"
+#include "utilities/merge_operators.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Parameters: allow_mmap_reads, index_sample_interval
+class EytzingerTableDBTest
+    : public DBTestBase,
+      public testing::WithParamInterface<std::tuple<bool, uint32_t>> {
+ public:
+  EytzingerTableDBTest()
+      : DBTestBase("eytzinger_table_db_test", /*env_do_fsync=*/false) {}
+
+  Options GetOptions() {
+    Options options = CurrentOptions();
+    options.allow_mmap_reads = std::get<0>(GetParam());
+    EytzingerTableOptions table_options;
+    table_options.index_sample_interval = std::get<1>(GetParam());
+    options.table_factory.reset(NewEytzingerTableFactory(table_options));
+    options.merge_operator = MergeOperators::CreateStringAppendOperator();
+    options.disable_auto_compactions = true;
+    return options;
+  }
+
+  static std::string Key(int i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "key%06d", i);
+    return buf;
+  }
+};
+
+TEST_P(EytzingerTableDBTest, GetAndIterate) {
+  Options options = GetOptions();
+  DestroyAndReopen(options);
+  ASSERT_EQ("NOT_FOUND", Get(Key(0)));
+
+  // Keys of varying length, several versions of some of them, and a
+  // snapshot that keeps an old version visible.
+  constexpr int kNumKeys = 1000;
+  for (int i = 0; i < kNumKeys; i += 2) {
+    ASSERT_OK(Put(Key(i), "v1_" + std::string(i % 37, 'x')));
+  }
+  const Snapshot* snapshot = db_->GetSnapshot();
+  for (int i = 0; i < kNumKeys; i += 6) {
+    ASSERT_OK(Put(Key(i), "v2_" + std::to_string(i)));
+  }
+  for (int i = 0; i < kNumKeys; i += 10) {
+    ASSERT_OK(Delete(Key(i)));
+  }
+  ASSERT_OK(Put("a_long_key_" + std::string(100, 'k'), "long"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1", FilesPerLevel());
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    std::string expected;
+    if (i % 2 != 0 || i % 10 == 0) {
+      expected = "NOT_FOUND";
+    } else if (i % 6 == 0) {
+      expected = "v2_" + std::to_string(i);
+    } else {
+      expected = "v1_" + std::string(i % 37, 'x');
+    }
+    ASSERT_EQ(expected, Get(Key(i)));
+    if (i % 2 == 0) {
+      ASSERT_EQ("v1_" + std::string(i % 37, 'x'), Get(Key(i), snapshot));
+    }
+  }
+  ASSERT_EQ("long", Get("a_long_key_" + std::string(100, 'k')));
+  ASSERT_EQ("NOT_FOUND", Get("zzz"));
+  ASSERT_EQ("NOT_FOUND", Get(""));
+
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    // Live keys are even and not multiples of 10, plus the long key.
+    ASSERT_EQ(kNumKeys / 2 - kNumKeys / 10 + 1, count);
+
+    iter->Seek(Key(11));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(12), iter->key().ToString());
+    iter->SeekForPrev(Key(11));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(8), iter->key().ToString());
+    iter->Prev();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(6), iter->key().ToString());
+    ASSERT_EQ("v2_6", iter->value().ToString());
+    iter->SeekToLast();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(kNumKeys - 2), iter->key().ToString());
+    iter->Seek("zzz");
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+  }
+  db_->ReleaseSnapshot(snapshot);
+
+  // Compacting rewrites the file without the hidden versions.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("v2_6", Get(Key(6)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(10)));
+  ASSERT_EQ("v1_" + std::string(2, 'x'), Get(Key(2)));
+}
+
+TEST_P(EytzingerTableDBTest, MergeAndRangeDeletion) {
+  Options options = GetOptions();
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "a"));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Merge(Key(i), "b"));
+  }
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(20), Key(40)));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("2", FilesPerLevel());
+
+  ASSERT_EQ("a,b", Get(Key(0)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(20)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(39)));
+  ASSERT_EQ("a,b", Get(Key(40)));
+  ASSERT_EQ("a,b", Get(Key(30), snapshot));
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  iter->Seek(Key(15));
+  for (int i = 15; i < 20; ++i) {
+    ASSERT_TRUE(iter->Valid());
+    iter->Next();
+  }
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(40), iter->key().ToString());
+  iter.reset();
+  db_->ReleaseSnapshot(snapshot);
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("a,b", Get(Key(99)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(25)));
+
+  // A file holding nothing but a range deletion
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(90), Key(95)));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("NOT_FOUND", Get(Key(90)));
+  ASSERT_EQ("a,b", Get(Key(95)));
+
+  Reopen(options);
+  ASSERT_EQ("NOT_FOUND", Get(Key(94)));
+  ASSERT_EQ("a,b", Get(Key(89)));
+}
+
+TEST_P(EytzingerTableDBTest, CorruptSlots) {
+  Options options = GetOptions();
+  DestroyAndReopen(options);
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(1U, props.size());
+  const std::string fname = props.begin()->first;
+  const TableProperties& table_props = *props.begin()->second;
+  EytzingerTableLayout layout;
+  ASSERT_OK(layout.DecodeFrom(table_props.user_collected_properties.at(
+      EytzingerTablePropertyNames::kLayout)));
+  Close();
+
+  std::string contents;
+  ASSERT_OK(ReadFileToString(env_, fname, &contents));
+  auto open = [&](const std::string& data) {
+    EXPECT_OK(WriteStringToFile(env_, data, fname));
+    SstFileReader reader(options);
+    return reader.Open(fname);
+  };
+  ASSERT_OK(open(contents));
+
+  const size_t key_slot = static_cast<size_t>(layout.key_slots_offset +
+                                              5 * layout.slot_stride);
+  const size_t index_slot =
+      static_cast<size_t>(layout.index_offset + layout.slot_stride);
+  const uint32_t bad_key_size =
+      layout.slot_stride - EytzingerTableLayout::kSlotHeaderSize + 1;
+  // Each of these would have a lookup read outside of the slot or the data
+  // section.
+  for (int i = 0; i < 5; ++i) {
+    SCOPED_TRACE("corruption " + std::to_string(i));
+    std::string corrupted = contents;
+    switch (i) {
+      case 0:
+        EncodeFixed32(&corrupted[key_slot], bad_key_size);
+        break;
+      case 1:
+        EncodeFixed32(&corrupted[key_slot + 4],
+                      static_cast<uint32_t>(table_props.data_size));
+        break;
+      case 2:
+        EncodeFixed64(&corrupted[key_slot + 8], table_props.data_size + 1);
+        break;
+      case 3:
+        EncodeFixed32(&corrupted[index_slot], bad_key_size);
+        break;
+      default:
+        EncodeFixed64(&corrupted[index_slot + 8], layout.num_entries);
+        break;
+    }
+    ASSERT_TRUE(open(corrupted).IsCorruption());
+  }
+  ASSERT_OK(open(contents));
+}
+
+INSTANTIATE_TEST_CASE_P(EytzingerTableDBTest, EytzingerTableDBTest,
+                        ::testing::Combine(::testing::Bool(),
+                                           ::testing::Values(1U, 4U, 7U)));
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -993,6 +993,12 @@ Status FlushJob::WriteLevel0Table() {
           preclude_last_level_min_seqno_ == kMaxSequenceNumber
               ? preclude_last_level_min_seqno_
               : std::min(earliest_snapshot_, preclude_last_level_min_seqno_));
+      if (base_ != nullptr) {
+        tboptions.adaptive_filter_bits_per_key =
+            base_->storage_info()->GetAdaptiveFilterBitsPerKey(
+                mutable_cf_options_.filter_memory_budget_bits_per_key,
+                0 /* level */);
+      }
       s = BuildTable(
           dbname_, versions_, db_options_, tboptions, file_options_,
           cfd_->table_cache(), iter.get(), std::move(range_del_iters), &meta_,
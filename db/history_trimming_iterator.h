@@ -78,6 +78,10 @@ class HistoryTrimmingIterator : public InternalIterator {
 
   Status status() const override { return input_->status(); }
 
+  void SetPinnedItersMgr(PinnedIteratorsManager* pinned_iters_mgr) override {
+    input_->SetPinnedItersMgr(pinned_iters_mgr);
+  }
+
   bool IsKeyPinned() const override { return input_->IsKeyPinned(); }
 
   bool IsValuePinned() const override { return input_->IsValuePinned(); }
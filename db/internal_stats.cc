@@ -84,6 +84,14 @@ const std::map<InternalStats::InternalDBStatsType, DBStatInfo>
          DBStatInfo{WriteStallStatsMapKeys::CauseConditionCount(
              WriteStallCause::kWriteBufferManagerLimit,
              WriteStallCondition::kStopped)}},
+        {InternalStats::kIntStatsWalRecoveryReadMicros,
+         DBStatInfo{"db.wal_recovery_read_micros"}},
+        {InternalStats::kIntStatsWalRecoveryInsertMicros,
+         DBStatInfo{"db.wal_recovery_insert_micros"}},
+        {InternalStats::kIntStatsWalRecoveryInsertWaitMicros,
+         DBStatInfo{"db.wal_recovery_insert_wait_micros"}},
+        {InternalStats::kIntStatsWalRecoveryFlushMicros,
+         DBStatInfo{"db.wal_recovery_flush_micros"}},
 };
 
 namespace {
@@ -259,6 +267,7 @@ static const std::string cf_write_stall_stats = "cf-write-stall-stats";
 static const std::string dbstats = "dbstats";
 static const std::string db_write_stall_stats = "db-write-stall-stats";
 static const std::string levelstats = "levelstats";
+static const std::string filter_io_stats = "filter-io-stats";
 static const std::string block_cache_entry_stats = "block-cache-entry-stats";
 static const std::string fast_block_cache_entry_stats =
     "fast-block-cache-entry-stats";
@@ -346,6 +355,8 @@ const std::string DB::Properties::kDBWriteStallStats =
     rocksdb_prefix + db_write_stall_stats;
 const std::string DB::Properties::kDBStats = rocksdb_prefix + dbstats;
 const std::string DB::Properties::kLevelStats = rocksdb_prefix + levelstats;
+const std::string DB::Properties::kFilterIOStats =
+    rocksdb_prefix + filter_io_stats;
 const std::string DB::Properties::kBlockCacheEntryStats =
     rocksdb_prefix + block_cache_entry_stats;
 const std::string DB::Properties::kFastBlockCacheEntryStats =
@@ -461,6 +472,9 @@ const UnorderedMap<std::string, DBPropertyInfo>
           nullptr, nullptr}},
         {DB::Properties::kLevelStats,
          {false, &InternalStats::HandleLevelStats, nullptr, nullptr, nullptr}},
+        {DB::Properties::kFilterIOStats,
+         {false, &InternalStats::HandleFilterIOStats, nullptr, nullptr,
+          nullptr}},
         {DB::Properties::kStats,
          {false, &InternalStats::HandleStats, nullptr, nullptr, nullptr}},
         {DB::Properties::kCFStats,
@@ -1061,6 +1075,60 @@ bool InternalStats::HandleLevelStats(std::string* value, Slice /*suffix*/) {
   return true;
 }
 
+bool InternalStats::HandleFilterIOStats(std::string* value,
+                                        Slice /*suffix*/) {
+  char buf[1000];
+  const auto* vstorage = cfd_->current()->storage_info();
+  VersionStorageInfo::FilterBitsAllocation allocation;
+  vstorage->ComputeFilterBitsAllocation(
+      cfd_->GetCurrentMutableCFOptions().filter_memory_budget_bits_per_key,
+      &allocation);
+  const bool allocated = !allocation.bits_per_key.empty();
+  snprintf(buf, sizeof(buf),
+           "Level      Entries       Misses  FalsePos(obs) Bits/key"
+           "  FalsePos(exp)\n"
+           "------------------------------------------------------"
+           "---------------\n");
+  value->append(buf);
+
+  uint64_t total_misses = 0;
+  uint64_t total_false_positives = 0;
+  double total_expected_false_positives = 0;
+  for (int level = 0; level < number_levels_; level++) {
+    const uint64_t misses = allocation.num_misses[level];
+    total_misses += misses;
+    total_false_positives += allocation.num_false_positives[level];
+    if (allocated) {
+      total_expected_false_positives +=
+          allocation.expected_false_positives[level];
+      snprintf(buf, sizeof(buf),
+               "%5d %12" PRIu64 " %12" PRIu64 " %14" PRIu64 " %8.2f %14.0f\n",
+               level, allocation.num_entries[level], misses,
+               allocation.num_false_positives[level],
+               allocation.bits_per_key[level],
+               allocation.expected_false_positives[level]);
+    } else {
+      snprintf(buf, sizeof(buf),
+               "%5d %12" PRIu64 " %12" PRIu64 " %14" PRIu64 " %8s %14s\n",
+               level, allocation.num_entries[level], misses,
+               allocation.num_false_positives[level], "-", "-");
+    }
+    value->append(buf);
+  }
+  if (allocated) {
+    snprintf(buf, sizeof(buf),
+             "  Sum %12s %12" PRIu64 " %14" PRIu64 " %8s %14.0f\n", "",
+             total_misses, total_false_positives, "",
+             total_expected_false_positives);
+  } else {
+    snprintf(buf, sizeof(buf),
+             "  Sum %12s %12" PRIu64 " %14" PRIu64 " %8s %14s\n", "",
+             total_misses, total_false_positives, "", "-");
+  }
+  value->append(buf);
+  return true;
+}
+
 bool InternalStats::HandleStats(std::string* value, Slice suffix) {
   if (!HandleCFStats(value, suffix)) {
     return false;
@@ -1631,6 +1699,19 @@ void InternalStats::DumpDBStats(std::string* value) {
            // 10000 = divide by 1M to get secs, then multiply by 100 for pct
            write_stall_micros / 10000.0 / std::max(seconds_up, 0.001));
   value->append(buf);
+  // WAL recovery on DB open
+  snprintf(buf, sizeof(buf),
+           "WAL recovery: read %.3f, insert %.3f, insert wait %.3f, "
+           "flush %.3f secs\n",
+           GetDBStats(InternalStats::kIntStatsWalRecoveryReadMicros) /
+               kMicrosInSec,
+           GetDBStats(InternalStats::kIntStatsWalRecoveryInsertMicros) /
+               kMicrosInSec,
+           GetDBStats(InternalStats::kIntStatsWalRecoveryInsertWaitMicros) /
+               kMicrosInSec,
+           GetDBStats(InternalStats::kIntStatsWalRecoveryFlushMicros) /
+               kMicrosInSec);
+  value->append(buf);
 
   // Interval
   uint64_t interval_write_other = write_other - db_stats_snapshot_.write_other;
@@ -147,6 +147,16 @@ class InternalStats {
     // So we should improve, rename or clarify it
     kIntStatsWriteStallMicros,
     kIntStatsWriteBufferManagerLimitStopsCounts,
+    // Breakdown of the time DB::Open spent replaying WALs: reading, decoding
+    // and verifying WAL records, inserting them into memtables (summed over
+    // threads with wal_recovery_threads > 1), waiting for those inserts, and
+    // writing recovered memtables to L0. When the WALs are replayed by a
+    // single thread, the memtable inserts are not timed on their own and are
+    // counted in kIntStatsWalRecoveryReadMicros.
+    kIntStatsWalRecoveryReadMicros,
+    kIntStatsWalRecoveryInsertMicros,
+    kIntStatsWalRecoveryInsertWaitMicros,
+    kIntStatsWalRecoveryFlushMicros,
     kIntStatsNumMax,
   };
 
@@ -817,6 +827,7 @@ class InternalStats {
   bool HandleNumFilesAtLevel(std::string* value, Slice suffix);
   bool HandleCompressionRatioAtLevelPrefix(std::string* value, Slice suffix);
   bool HandleLevelStats(std::string* value, Slice suffix);
+  bool HandleFilterIOStats(std::string* value, Slice suffix);
   bool HandleStats(std::string* value, Slice suffix);
   bool HandleCFMapStats(std::map<std::string, std::string>* compaction_stats,
                         Slice suffix);
@@ -812,11 +812,8 @@ FragmentedRangeTombstoneIterator* MemTable::NewRangeTombstoneIteratorInternal(
   if (!cache->initialized.load(std::memory_order_acquire)) {
     cache->reader_mutex.lock();
     if (!cache->tombstones) {
-      auto* unfragmented_iter = new MemTableIterator(
-          MemTableIterator::kRangeDelEntries, *this, read_options);
-      cache->tombstones.reset(new FragmentedRangeTombstoneList(
-          std::unique_ptr<InternalIterator>(unfragmented_iter),
-          comparator_.comparator));
+      cache->tombstones = FragmentRangeTombstones(*cache, read_options);
+      cache->prev.reset();
       cache->initialized.store(true, std::memory_order_release);
     }
     cache->reader_mutex.unlock();
@@ -827,12 +824,74 @@ FragmentedRangeTombstoneIterator* MemTable::NewRangeTombstoneIteratorInternal(
   return fragmented_iter;
 }
 
+std::unique_ptr<FragmentedRangeTombstoneList>
+MemTable::FragmentRangeTombstones(
+    const FragmentedRangeTombstoneListCache& cache,
+    const ReadOptions& read_options) {
+  // Find the newest cache in the chain that is already fragmented, and the
+  // tombstones added since.
+  const FragmentedRangeTombstoneList* base_tombstones = cache.tombstones.get();
+  std::shared_ptr<FragmentedRangeTombstoneListCache> base;
+  std::vector<RangeTombstone> new_tombstones;
+  if (base_tombstones == nullptr && cache.prev != nullptr) {
+    new_tombstones.push_back(cache.new_tombstone);
+    for (auto prev = cache.prev; prev != nullptr;) {
+      std::shared_ptr<FragmentedRangeTombstoneListCache> next;
+      {
+        std::lock_guard<std::mutex> lock(prev->reader_mutex);
+        if (prev->tombstones != nullptr) {
+          base = prev;
+          break;
+        }
+        if (prev->prev != nullptr) {
+          new_tombstones.push_back(prev->new_tombstone);
+          next = prev->prev;
+        }
+      }
+      prev = std::move(next);
+    }
+    if (base != nullptr) {
+      base_tombstones = base->tombstones.get();
+    }
+  }
+  if (base_tombstones != nullptr) {
+    // The tombstones of `base` are immutable once set. They can already
+    // include some of `new_tombstones`: Add() inserts a tombstone before
+    // publishing its cache, so a reader can fragment all tombstones in
+    // between. The merge skips those instead of counting them twice.
+    return std::make_unique<FragmentedRangeTombstoneList>(
+        *base_tombstones, std::move(new_tombstones), comparator_.comparator);
+  }
+
+  auto* unfragmented_iter = new MemTableIterator(
+      MemTableIterator::kRangeDelEntries, *this, read_options);
+  return std::make_unique<FragmentedRangeTombstoneList>(
+      std::unique_ptr<InternalIterator>(unfragmented_iter),
+      comparator_.comparator);
+}
+
 void MemTable::ConstructFragmentedRangeTombstones() {
   // There should be no concurrent Construction.
   // We could also check fragmented_range_tombstone_list_ to avoid repeate
   // constructions. We just construct them here again to be safe.
   if (!is_range_del_table_empty_.LoadRelaxed()) {
     // TODO: plumb Env::IOActivity, Env::IOPriority
+    if (SupportsIncrementalRangeTombstoneFragmentation()) {
+      // Start from the fragments cached for reads of the mutable memtable.
+      std::shared_ptr<FragmentedRangeTombstoneListCache> cache =
+#if defined(__cpp_lib_atomic_shared_ptr)
+          cached_range_tombstone_.AccessAtCore(0)->load(
+              std::memory_order_relaxed)
+#else
+          std::atomic_load_explicit(cached_range_tombstone_.AccessAtCore(0),
+                                    std::memory_order_relaxed)
+#endif
+          ;
+      std::lock_guard<std::mutex> lock(cache->reader_mutex);
+      fragmented_range_tombstone_list_ =
+          FragmentRangeTombstones(*cache, ReadOptions());
+      return;
+    }
     auto* unfragmented_iter = new MemTableIterator(
         MemTableIterator::kRangeDelEntries, *this, ReadOptions());
 
@@ -1066,11 +1125,40 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
   }
   if (type == kTypeRangeDeletion) {
     auto new_cache = std::make_shared<FragmentedRangeTombstoneListCache>();
+    const bool link_cache = SupportsIncrementalRangeTombstoneFragmentation();
+    if (link_cache) {
+      // Both keys are in the arena of this memtable.
+      new_cache->new_tombstone =
+          RangeTombstone(key_slice, Slice(p, val_size), s);
+    }
     size_t size = cached_range_tombstone_.Size();
     if (allow_concurrent) {
       post_process_info->num_range_deletes++;
       range_del_mutex_.lock();
     }
+    if (link_cache) {
+      // Let the first reader of the new cache fragment the tombstones
+      // incrementally, unless too many tombstones were added since the cache
+      // was last fragmented.
+      constexpr uint32_t kMaxChainLength = 256;
+      std::shared_ptr<FragmentedRangeTombstoneListCache> prev =
+#if defined(__cpp_lib_atomic_shared_ptr)
+          cached_range_tombstone_.AccessAtCore(0)->load(
+              std::memory_order_relaxed)
+#else
+          std::atomic_load_explicit(cached_range_tombstone_.AccessAtCore(0),
+                                    std::memory_order_relaxed)
+#endif
+          ;
+      const uint32_t chain_length =
+          prev->initialized.load(std::memory_order_acquire)
+              ? 1
+              : prev->chain_length + 1;
+      if (chain_length <= kMaxChainLength) {
+        new_cache->chain_length = chain_length;
+        new_cache->prev = std::move(prev);
+      }
+    }
     for (size_t i = 0; i < size; ++i) {
 #if defined(__cpp_lib_atomic_shared_ptr)
       std::atomic<std::shared_ptr<FragmentedRangeTombstoneListCache>>*
@@ -1137,6 +1225,9 @@ struct Saver {
   bool* is_blob_index;
   bool allow_data_in_errors;
   uint32_t protection_bytes_per_key;
+  // When non-null, a plain value is returned here referencing memtable
+  // memory, instead of being copied to `value`
+  Slice* value_in_place;
   bool CheckCallback(SequenceNumber _seq) {
     if (callback_) {
       return callback_->IsVisible(_seq);
@@ -1284,11 +1375,20 @@ static bool SaveValue(void* arg, const char* entry) {
           v = ParsePackedValueForValue(v);
         }
 
-        ReadOnlyMemTable::HandleTypeValue(
-            s->key->user_key(), v, s->inplace_update_support == false,
-            s->do_merge, *(s->merge_in_progress), merge_context,
-            s->merge_operator, s->clock, s->statistics, s->logger, s->status,
-            s->value, s->columns, s->is_blob_index);
+        if (s->value_in_place != nullptr && s->do_merge &&
+            !*(s->merge_in_progress) && !s->inplace_update_support) {
+          *(s->status) = Status::OK();
+          *(s->value_in_place) = v;
+          if (s->is_blob_index != nullptr) {
+            *(s->is_blob_index) = false;
+          }
+        } else {
+          ReadOnlyMemTable::HandleTypeValue(
+              s->key->user_key(), v, s->inplace_update_support == false,
+              s->do_merge, *(s->merge_in_progress), merge_context,
+              s->merge_operator, s->clock, s->statistics, s->logger, s->status,
+              s->value, s->columns, s->is_blob_index);
+        }
         *(s->found_final_value) = true;
         return false;
       }
@@ -1469,7 +1569,8 @@ void MemTable::GetFromTable(const LookupKey& key,
                             PinnableWideColumns* columns,
                             std::string* timestamp, Status* s,
                             MergeContext* merge_context, SequenceNumber* seq,
-                            bool* found_final_value, bool* merge_in_progress) {
+                            bool* found_final_value, bool* merge_in_progress,
+                            Slice* value_in_place) {
   Saver saver;
   saver.status = s;
   saver.found_final_value = found_final_value;
@@ -1492,6 +1593,7 @@ void MemTable::GetFromTable(const LookupKey& key,
   saver.do_merge = do_merge;
   saver.allow_data_in_errors = moptions_.allow_data_in_errors;
   saver.protection_bytes_per_key = moptions_.protection_bytes_per_key;
+  saver.value_in_place = value_in_place;
 
   if (!moptions_.paranoid_memory_checks) {
     table_->Get(key, &saver, SaveValue);
@@ -1522,6 +1624,7 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
   // handled. TODO: allow Bloom checks where max_covering_tombstone_seq==0
   bool no_range_del = read_options.ignore_range_deletions ||
                       is_range_del_table_empty_.LoadRelaxed();
+  SharedCleanablePtr* value_pinner = range->context()->memtable_value_pinner();
   MultiGetRange temp_range(*range, range->begin(), range->end());
   if (bloom_filter_ && no_range_del) {
     bool whole_key =
@@ -1571,11 +1674,15 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
       }
     }
     SequenceNumber dummy_seq;
+    Slice value_in_place(nullptr, 0);
     GetFromTable(*(iter->lkey), iter->max_covering_tombstone_seq, true,
                  callback, &iter->is_blob_index,
                  iter->value ? iter->value->GetSelf() : nullptr, iter->columns,
                  iter->timestamp, iter->s, &(iter->merge_context), &dummy_seq,
-                 &found_final_value, &merge_in_progress);
+                 &found_final_value, &merge_in_progress,
+                 value_pinner != nullptr && iter->value != nullptr
+                     ? &value_in_place
+                     : nullptr);
 
     if (!found_final_value && merge_in_progress) {
       if (iter->s->ok()) {
@@ -1592,7 +1699,12 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
       // set `found_final_value` properly.
       assert(found_final_value);
       if (iter->value) {
-        iter->value->PinSelf();
+        if (value_in_place.data() != nullptr) {
+          iter->value->PinSlice(value_in_place, nullptr /* cleanable */);
+          value_pinner->RegisterCopyWith(iter->value);
+        } else {
+          iter->value->PinSelf();
+        }
         range->AddValueSize(iter->value->size());
       } else {
         assert(iter->columns);
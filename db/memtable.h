@@ -541,6 +541,9 @@ class MemTable final : public ReadOnlyMemTable {
                    const char* prefix_len_key2) const override;
     int operator()(const char* prefix_len_key,
                    const DecodedType& key) const override;
+    const Comparator* user_comparator() const override {
+      return comparator.user_comparator();
+    }
   };
 
   // earliest_seq should be the current SequenceNumber in the db such that any
@@ -909,6 +912,13 @@ class MemTable final : public ReadOnlyMemTable {
   // Updates flush_state_ using ShouldFlushNow()
   void UpdateFlushState();
 
+  // Whether the range tombstones can be fragmented by merging the new ones
+  // into the cached fragments, which requires their keys to be pinned in the
+  // arena and no user-defined timestamps.
+  bool SupportsIncrementalRangeTombstoneFragmentation() const {
+    return ts_sz_ == 0 && !moptions_.inplace_update_support;
+  }
+
   void UpdateOldestKeyTime();
 
   void GetFromTable(const LookupKey& key,
@@ -917,7 +927,8 @@ class MemTable final : public ReadOnlyMemTable {
                     std::string* value, PinnableWideColumns* columns,
                     std::string* timestamp, Status* s,
                     MergeContext* merge_context, SequenceNumber* seq,
-                    bool* found_final_value, bool* merge_in_progress);
+                    bool* found_final_value, bool* merge_in_progress,
+                    Slice* value_in_place = nullptr);
 
   // Always returns non-null and assumes certain pre-checks (e.g.,
   // is_range_del_table_empty_) are done. This is only valid during the lifetime
@@ -928,6 +939,14 @@ class MemTable final : public ReadOnlyMemTable {
       const ReadOptions& read_options, SequenceNumber read_seq,
       bool immutable_memtable);
 
+  // Fragments the range tombstones covered by `cache`, whose reader_mutex must
+  // be held. Merges the tombstones added since the newest fragmented
+  // predecessor of `cache` into its fragments where possible, and fragments
+  // all range tombstones of the memtable otherwise.
+  std::unique_ptr<FragmentedRangeTombstoneList> FragmentRangeTombstones(
+      const FragmentedRangeTombstoneListCache& cache,
+      const ReadOptions& read_options);
+
   // The fragmented range tombstones of this memtable.
   // This is constructed when this memtable becomes immutable
   // if !is_range_del_table_empty_.
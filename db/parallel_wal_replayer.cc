@@ -0,0 +1,145 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/parallel_wal_replayer.h"
+
+#include "db/column_family.h"
+#include "db/write_batch_internal.h"
+#include "rocksdb/system_clock.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Bounds the memory held by batches that were read but not inserted yet.
+constexpr size_t kMaxPendingBytes = 64 << 20;
+}  // anonymous namespace
+
+ParallelWalReplayer::ParallelWalReplayer(
+    int num_threads, ColumnFamilySet* column_family_set,
+    FlushScheduler* flush_scheduler,
+    TrimHistoryScheduler* trim_history_scheduler, DB* db, bool batch_per_txn,
+    SystemClock* clock)
+    : column_family_set_(column_family_set),
+      flush_scheduler_(flush_scheduler),
+      trim_history_scheduler_(trim_history_scheduler),
+      db_(db),
+      batch_per_txn_(batch_per_txn),
+      clock_(clock),
+      max_pending_(4 * static_cast<size_t>(num_threads)),
+      work_cv_(&mu_),
+      done_cv_(&mu_) {
+  assert(num_threads > 0);
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(&ParallelWalReplayer::InsertThread, this);
+  }
+}
+
+ParallelWalReplayer::~ParallelWalReplayer() {
+  {
+    MutexLock l(&mu_);
+    shutdown_ = true;
+    work_cv_.SignalAll();
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  status_.PermitUncheckedError();
+}
+
+void ParallelWalReplayer::Schedule(std::unique_ptr<WriteBatch>&& batch,
+                                   uint64_t wal_number) {
+  assert(batch);
+  const size_t bytes = WriteBatchInternal::ByteSize(batch.get());
+  MutexLock l(&mu_);
+  if (num_pending_ >= max_pending_ || pending_bytes_ >= kMaxPendingBytes) {
+    const uint64_t start_micros = clock_->NowMicros();
+    while (num_pending_ >= max_pending_ || pending_bytes_ >= kMaxPendingBytes) {
+      done_cv_.Wait();
+    }
+    wait_micros_ += clock_->NowMicros() - start_micros;
+  }
+  queue_.push_back(Work{std::move(batch), wal_number, bytes});
+  ++num_pending_;
+  pending_bytes_ += bytes;
+  work_cv_.Signal();
+}
+
+Status ParallelWalReplayer::WaitForPendingInserts(bool* has_valid_writes) {
+  assert(has_valid_writes);
+  MutexLock l(&mu_);
+  if (num_pending_ > 0) {
+    const uint64_t start_micros = clock_->NowMicros();
+    while (num_pending_ > 0) {
+      done_cv_.Wait();
+    }
+    wait_micros_ += clock_->NowMicros() - start_micros;
+  }
+  if (has_valid_writes_) {
+    *has_valid_writes = true;
+    has_valid_writes_ = false;
+  }
+  Status s = std::move(status_);
+  status_ = Status::OK();
+  return s;
+}
+
+void ParallelWalReplayer::InsertThread() {
+  MutexLock l(&mu_);
+  while (true) {
+    while (queue_.empty() && !shutdown_) {
+      work_cv_.Wait();
+    }
+    if (shutdown_) {
+      // Only reached before WaitForPendingInserts() returned when the
+      // recovery failed, so the remaining batches are not needed.
+      return;
+    }
+    Work work = std::move(queue_.front());
+    queue_.pop_front();
+
+    bool has_valid_writes = false;
+    mu_.Unlock();
+    Status s = Insert(work, &has_valid_writes);
+    work.batch.reset();
+    mu_.Lock();
+
+    has_valid_writes_ = has_valid_writes_ || has_valid_writes;
+    if (!s.ok() && status_.ok()) {
+      status_ = s;
+    }
+    --num_pending_;
+    pending_bytes_ -= work.bytes;
+    done_cv_.SignalAll();
+  }
+}
+
+Status ParallelWalReplayer::Insert(const Work& work, bool* has_valid_writes) {
+  const uint64_t start_micros = clock_->NowMicros();
+  const WriteBatch* batch = work.batch.get();
+  const SequenceNumber expected_next_seq =
+      WriteBatchInternal::Sequence(batch) + WriteBatchInternal::Count(batch);
+  SequenceNumber next_seq = 0;
+  // Each thread needs its own cursor over the column families.
+  ColumnFamilyMemTablesImpl column_family_memtables(column_family_set_);
+  // Same as the single-threaded recovery, updates to column families that
+  // were dropped are ignored.
+  Status s = WriteBatchInternal::InsertInto(
+      batch, &column_family_memtables, flush_scheduler_,
+      trim_history_scheduler_, true /* ignore_missing_column_families */,
+      work.wal_number, db_, true /* concurrent_memtable_writes */, &next_seq,
+      has_valid_writes, false /* seq_per_batch */, batch_per_txn_);
+  if (s.ok() && next_seq != expected_next_seq) {
+    s = Status::Corruption("WAL write batch at sequence " +
+                           std::to_string(WriteBatchInternal::Sequence(batch)) +
+                           " does not match its count");
+  }
+  insert_micros_.fetch_add(clock_->NowMicros() - start_micros,
+                           std::memory_order_relaxed);
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,108 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ColumnFamilySet;
+class DB;
+class FlushScheduler;
+class SystemClock;
+class TrimHistoryScheduler;
+class WriteBatch;
+
+// ParallelWalReplayer inserts the write batches recovered from WALs into the
+// memtables from a pool of threads, so that the thread opening the DB can
+// keep reading and verifying WAL records in the meantime. Batches are
+// inserted with concurrent memtable writes, in no particular order, which is
+// fine because each of them carries its own sequence numbers. Memtables that
+// become full are reported to `flush_scheduler` as usual. Batches must not
+// carry sequence numbers per batch (seq_per_batch) nor two-phase commit
+// markers, and merges are only supported when no column family uses
+// max_successive_merges.
+//
+// Except for the constructor and destructor, the methods must be called from
+// the single thread doing the recovery. That thread must call
+// WaitForPendingInserts() before it touches the memtables itself, e.g. to
+// flush or switch them.
+class ParallelWalReplayer {
+ public:
+  ParallelWalReplayer(int num_threads, ColumnFamilySet* column_family_set,
+                      FlushScheduler* flush_scheduler,
+                      TrimHistoryScheduler* trim_history_scheduler, DB* db,
+                      bool batch_per_txn, SystemClock* clock);
+
+  // Waits for the pending inserts and stops the threads.
+  ~ParallelWalReplayer();
+
+  ParallelWalReplayer(const ParallelWalReplayer&) = delete;
+  ParallelWalReplayer& operator=(const ParallelWalReplayer&) = delete;
+
+  // Hands `batch`, read from WAL `wal_number`, to the insert threads. Blocks
+  // while too many batches are pending.
+  void Schedule(std::unique_ptr<WriteBatch>&& batch, uint64_t wal_number);
+
+  // Waits until every scheduled batch has been inserted. Returns the first
+  // error hit by an insert since the previous call, and sets
+  // `*has_valid_writes` if any of the inserted batches had an update for a
+  // column family that still needed it.
+  Status WaitForPendingInserts(bool* has_valid_writes);
+
+  // Time spent inserting into the memtables, summed over all threads.
+  uint64_t GetInsertMicros() const {
+    return insert_micros_.load(std::memory_order_relaxed);
+  }
+
+  // Time the recovery thread spent blocked in Schedule() and
+  // WaitForPendingInserts().
+  uint64_t GetWaitMicros() const { return wait_micros_; }
+
+ private:
+  struct Work {
+    std::unique_ptr<WriteBatch> batch;
+    uint64_t wal_number;
+    size_t bytes;
+  };
+
+  void InsertThread();
+  Status Insert(const Work& work, bool* has_valid_writes);
+
+  ColumnFamilySet* const column_family_set_;
+  FlushScheduler* const flush_scheduler_;
+  TrimHistoryScheduler* const trim_history_scheduler_;
+  DB* const db_;
+  const bool batch_per_txn_;
+  SystemClock* const clock_;
+  const size_t max_pending_;
+
+  port::Mutex mu_;
+  // Signaled when work is queued or the threads need to stop.
+  port::CondVar work_cv_;
+  // Signaled when a batch has been inserted.
+  port::CondVar done_cv_;
+  std::deque<Work> queue_;
+  // Batches queued or being inserted.
+  size_t num_pending_ = 0;
+  size_t pending_bytes_ = 0;
+  bool shutdown_ = false;
+  Status status_;
+  bool has_valid_writes_ = false;
+
+  std::atomic<uint64_t> insert_micros_{0};
+  uint64_t wait_micros_ = 0;
+  std::vector<port::Thread> threads_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
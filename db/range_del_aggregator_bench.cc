@@ -20,10 +20,12 @@ int main() {
 #include <vector>
 
 #include "db/dbformat.h"
+#include "db/memtable.h"
 #include "db/range_del_aggregator.h"
 #include "db/range_tombstone_fragmenter.h"
 #include "rocksdb/comparator.h"
 #include "rocksdb/system_clock.h"
+#include "rocksdb/write_buffer_manager.h"
 #include "util/coding.h"
 #include "util/gflags_compat.h"
 #include "util/random.h"
@@ -58,6 +60,14 @@ DEFINE_bool(use_compaction_range_del_aggregator, false,
             "Whether to use CompactionRangeDelAggregator. Default is to use "
             "ReadRangeDelAggregator.");
 
+DEFINE_bool(memtable_delete_ranges, false,
+            "Instead of the range deletion aggregators, measure reads of the "
+            "range tombstones of a memtable while range tombstones keep being "
+            "added to it, as with a high DeleteRange rate. The memtable "
+            "starts with --num_range_tombstones tombstones, and each run adds "
+            "--add_tombstones_per_run tombstones before "
+            "--should_deletes_per_run reads.");
+
 namespace {
 
 struct Stats {
@@ -173,6 +183,84 @@ static std::string Key(int64_t val) {
   return big_endian_key;
 }
 
+int RunMemtableDeleteRanges() {
+  SystemClock* clock = SystemClock::Default().get();
+  Random64 rnd(FLAGS_seed);
+  std::default_random_engine random_gen(FLAGS_seed);
+  std::normal_distribution<double> normal_dist(FLAGS_tombstone_width_mean,
+                                               FLAGS_tombstone_width_stddev);
+
+  Options options;
+  ImmutableOptions ioptions(options);
+  WriteBufferManager wb(options.db_write_buffer_size);
+  MemTable* mem = new MemTable(icmp, ioptions, MutableCFOptions(options), &wb,
+                               kMaxSequenceNumber, 0 /* column_family_id */);
+  mem->Ref();
+
+  SequenceNumber seq = 0;
+  auto add_tombstone = [&]() {
+    uint64_t start = rnd.Uniform(FLAGS_tombstone_start_upper_bound);
+    uint64_t end = static_cast<uint64_t>(
+        std::round(start + std::max(1.0, normal_dist(random_gen))));
+    Status s = mem->Add(++seq, kTypeRangeDeletion, Key(start), Key(end),
+                        nullptr /* kv_prot_info */);
+    if (!s.ok()) {
+      std::cerr << "Failed to add range tombstone: " << s.ToString() << "\n";
+      std::abort();
+    }
+  };
+  for (int i = 0; i < FLAGS_num_range_tombstones; i++) {
+    add_tombstone();
+  }
+
+  uint64_t time_add_tombstones = 0;
+  uint64_t time_new_iterator = 0;
+  uint64_t time_should_delete = 0;
+  for (int i = 0; i < FLAGS_num_runs; i++) {
+    StopWatchNano stop_watch_add_tombstones(clock, true /* auto_start */);
+    for (int j = 0; j < FLAGS_add_tombstones_per_run; j++) {
+      add_tombstone();
+    }
+    time_add_tombstones += stop_watch_add_tombstones.ElapsedNanos();
+
+    for (int j = 0; j < FLAGS_should_deletes_per_run; j++) {
+      // Each read creates its own iterator, like a point lookup does.
+      StopWatchNano stop_watch_new_iterator(clock, true /* auto_start */);
+      std::unique_ptr<FragmentedRangeTombstoneIterator> iter(
+          mem->NewRangeTombstoneIterator(ReadOptions(), seq,
+                                         false /* immutable_memtable */));
+      time_new_iterator += stop_watch_new_iterator.ElapsedNanos();
+
+      std::string key = Key(rnd.Uniform(FLAGS_should_delete_upper_bound));
+      StopWatchNano stop_watch_should_delete(clock, true /* auto_start */);
+      iter->MaxCoveringTombstoneSeqnum(key);
+      time_should_delete += stop_watch_should_delete.ElapsedNanos();
+    }
+  }
+  delete mem->Unref();
+
+  std::ios fmt_holder(nullptr);
+  fmt_holder.copyfmt(std::cout);
+  std::cout << "=========================\n"
+            << "Results:\n"
+            << "=========================\n"
+            << std::left;
+  std::cout << std::setw(30) << "Add tombstone: "
+            << time_add_tombstones /
+                   (FLAGS_add_tombstones_per_run * FLAGS_num_runs * 1.0e3)
+            << " us\n";
+  std::cout << std::setw(30) << "NewRangeTombstoneIterator: "
+            << time_new_iterator /
+                   (FLAGS_should_deletes_per_run * FLAGS_num_runs * 1.0e3)
+            << " us\n";
+  std::cout << std::setw(30) << "MaxCoveringTombstoneSeqnum: "
+            << time_should_delete /
+                   (FLAGS_should_deletes_per_run * FLAGS_num_runs * 1.0e3)
+            << " us\n";
+  std::cout.copyfmt(fmt_holder);
+  return 0;
+}
+
 }  // anonymous namespace
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -180,6 +268,10 @@ static std::string Key(int64_t val) {
 int main(int argc, char** argv) {
   ParseCommandLineFlags(&argc, &argv, true);
 
+  if (FLAGS_memtable_delete_ranges) {
+    return ROCKSDB_NAMESPACE::RunMemtableDeleteRanges();
+  }
+
   Stats stats;
   ROCKSDB_NAMESPACE::SystemClock* clock =
       ROCKSDB_NAMESPACE::SystemClock::Default().get();
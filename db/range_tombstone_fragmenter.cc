@@ -85,6 +85,162 @@ FragmentedRangeTombstoneList::FragmentedRangeTombstoneList(
   FragmentTombstones(std::move(iter), icmp, for_compaction, snapshots);
 }
 
+FragmentedRangeTombstoneList::FragmentedRangeTombstoneList(
+    const FragmentedRangeTombstoneList& base,
+    std::vector<RangeTombstone> new_tombstones,
+    const InternalKeyComparator& icmp)
+    : num_unfragmented_tombstones_(base.num_unfragmented_tombstones_),
+      total_tombstone_payload_bytes_(base.total_tombstone_payload_bytes_) {
+  const Comparator* ucmp = icmp.user_comparator();
+  assert(ucmp->timestamp_size() == 0);
+  // Whether `base` already covers the range of `t` at the seqno of `t`, i.e.
+  // `base` was fragmented after `t` was added, so merging `t` again would
+  // only count it twice. This cannot be told for empty tombstones, which
+  // MemTableInserter does not add anyway.
+  auto already_in_base = [&](const RangeTombstone& t) {
+    if (ucmp->Compare(t.start_key_, t.end_key_) >= 0) {
+      return false;
+    }
+    auto it = std::upper_bound(
+        base.tombstones_.begin(), base.tombstones_.end(), t.start_key_,
+        [ucmp](const Slice& key, const RangeTombstoneStack& stack) {
+          return ucmp->Compare(key, stack.start_key) < 0;
+        });
+    if (it == base.tombstones_.begin()) {
+      return false;
+    }
+    --it;
+    Slice covered_until = t.start_key_;
+    for (; it != base.tombstones_.end() &&
+           ucmp->Compare(it->start_key, covered_until) <= 0 &&
+           ucmp->Compare(covered_until, t.end_key_) < 0;
+         ++it) {
+      if (ucmp->Compare(it->end_key, covered_until) <= 0 ||
+          !std::binary_search(base.seq_iter(it->seq_start_idx),
+                              base.seq_iter(it->seq_end_idx), t.seq_,
+                              std::greater<SequenceNumber>())) {
+        return false;
+      }
+      covered_until = it->end_key;
+    }
+    return ucmp->Compare(covered_until, t.end_key_) >= 0;
+  };
+  new_tombstones.erase(
+      std::remove_if(new_tombstones.begin(), new_tombstones.end(),
+                     already_in_base),
+      new_tombstones.end());
+  num_unfragmented_tombstones_ += new_tombstones.size();
+  for (const auto& tombstone : new_tombstones) {
+    total_tombstone_payload_bytes_ += tombstone.start_key_.size() +
+                                      kNumInternalBytes +
+                                      tombstone.end_key_.size();
+  }
+  // Empty tombstones do not cover any key, and are not fragmented either.
+  new_tombstones.erase(
+      std::remove_if(new_tombstones.begin(), new_tombstones.end(),
+                     [ucmp](const RangeTombstone& t) {
+                       return ucmp->Compare(t.start_key_, t.end_key_) >= 0;
+                     }),
+      new_tombstones.end());
+  std::sort(new_tombstones.begin(), new_tombstones.end(),
+            [ucmp](const RangeTombstone& a, const RangeTombstone& b) {
+              return ucmp->Compare(a.start_key_, b.start_key_) < 0;
+            });
+  tombstones_.reserve(base.tombstones_.size() + 2 * new_tombstones.size());
+  tombstone_seqs_.reserve(base.tombstone_seqs_.size() +
+                          2 * new_tombstones.size());
+
+  // Sweep over the boundaries of the fragments of `base` and of the new
+  // tombstones. Between two consecutive boundaries, a fragment is covered by
+  // at most one fragment of `base` and by the new tombstones in `active`, a
+  // min-heap on their end keys.
+  auto ends_later = [ucmp](const RangeTombstone* a, const RangeTombstone* b) {
+    return ucmp->Compare(a->end_key_, b->end_key_) > 0;
+  };
+  std::vector<const RangeTombstone*> active;
+  auto base_it = base.tombstones_.begin();
+  size_t next_new = 0;
+  Slice pos;
+  bool has_pos = false;
+  while (true) {
+    if (has_pos) {
+      if (base_it != base.tombstones_.end() &&
+          ucmp->Compare(base_it->end_key, pos) <= 0) {
+        ++base_it;
+      }
+      while (!active.empty() &&
+             ucmp->Compare(active.front()->end_key_, pos) <= 0) {
+        std::pop_heap(active.begin(), active.end(), ends_later);
+        active.pop_back();
+      }
+    }
+    bool in_base = has_pos && base_it != base.tombstones_.end() &&
+                   ucmp->Compare(base_it->start_key, pos) <= 0;
+    if (!in_base && active.empty()) {
+      // Nothing covers pos, so skip to the next tombstone.
+      const bool base_done = base_it == base.tombstones_.end();
+      const bool new_done = next_new == new_tombstones.size();
+      if (base_done && new_done) {
+        break;
+      }
+      if (new_done ||
+          (!base_done && ucmp->Compare(base_it->start_key,
+                                       new_tombstones[next_new].start_key_) <=
+                             0)) {
+        pos = base_it->start_key;
+        in_base = true;
+      } else {
+        pos = new_tombstones[next_new].start_key_;
+        in_base = !base_done && ucmp->Compare(base_it->start_key, pos) == 0;
+      }
+      has_pos = true;
+    }
+    while (next_new < new_tombstones.size() &&
+           ucmp->Compare(new_tombstones[next_new].start_key_, pos) <= 0) {
+      active.push_back(&new_tombstones[next_new++]);
+      std::push_heap(active.begin(), active.end(), ends_later);
+    }
+
+    // The fragment ends at the next boundary after pos.
+    Slice next;
+    bool has_next = false;
+    auto limit_next = [&](const Slice& key) {
+      if (!has_next || ucmp->Compare(key, next) < 0) {
+        next = key;
+        has_next = true;
+      }
+    };
+    if (in_base) {
+      limit_next(base_it->end_key);
+    } else if (base_it != base.tombstones_.end()) {
+      limit_next(base_it->start_key);
+    }
+    if (next_new < new_tombstones.size()) {
+      limit_next(new_tombstones[next_new].start_key_);
+    }
+    if (!active.empty()) {
+      limit_next(active.front()->end_key_);
+    }
+    assert(has_next && ucmp->Compare(pos, next) < 0);
+
+    const size_t start_idx = tombstone_seqs_.size();
+    if (in_base) {
+      tombstone_seqs_.insert(tombstone_seqs_.end(),
+                             base.seq_iter(base_it->seq_start_idx),
+                             base.seq_iter(base_it->seq_end_idx));
+    }
+    for (const RangeTombstone* tombstone : active) {
+      tombstone_seqs_.push_back(tombstone->seq_);
+    }
+    if (!active.empty()) {
+      std::sort(tombstone_seqs_.begin() + start_idx, tombstone_seqs_.end(),
+                std::greater<SequenceNumber>());
+    }
+    tombstones_.emplace_back(pos, next, start_idx, tombstone_seqs_.size());
+    pos = next;
+  }
+}
+
 void FragmentedRangeTombstoneList::FragmentTombstones(
     std::unique_ptr<InternalIterator> unfragmented_tombstones,
     const InternalKeyComparator& icmp, bool for_compaction,
@@ -47,6 +47,17 @@ struct FragmentedRangeTombstoneList {
       const std::vector<SequenceNumber>& snapshots = {},
       const bool tombstone_end_include_ts = true);
 
+  // Fragments the tombstones of `base` together with `new_tombstones`, by
+  // merging the new tombstones into the fragments of `base` instead of
+  // fragmenting all of them again. The result is the same as fragmenting all
+  // the tombstones for reads, except that empty tombstones do not split any
+  // fragment, which does not change the keys covered. The keys of `base` and
+  // `new_tombstones` must stay valid for the lifetime of this list.
+  // User-defined timestamps are not supported.
+  FragmentedRangeTombstoneList(const FragmentedRangeTombstoneList& base,
+                               std::vector<RangeTombstone> new_tombstones,
+                               const InternalKeyComparator& icmp);
+
   std::vector<RangeTombstoneStack>::const_iterator begin() const {
     return tombstones_.begin();
   }
@@ -120,6 +131,17 @@ struct FragmentedRangeTombstoneListCache {
   std::unique_ptr<FragmentedRangeTombstoneList> tombstones = nullptr;
   // readers will first check this bool to avoid
   std::atomic<bool> initialized = false;
+  // If not null, the cache this one replaced when `new_tombstone` was added.
+  // The first reader can then merge the tombstones added since the newest
+  // predecessor with `tombstones` into its fragments, instead of fragmenting
+  // all tombstones again. Reset once `tombstones` is set. Protected by
+  // reader_mutex.
+  std::shared_ptr<FragmentedRangeTombstoneListCache> prev;
+  RangeTombstone new_tombstone;
+  // Number of caches in the chain of `prev`, which is bounded to keep the
+  // work of the first reader, and the recursion when the chain is destroyed,
+  // in check.
+  uint32_t chain_length = 0;
 };
 
 // FragmentedRangeTombstoneIterator converts an InternalIterator of a range-del
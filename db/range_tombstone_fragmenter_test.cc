@@ -546,6 +546,134 @@ TEST_F(RangeTombstoneFragmenterTest, SeekOutOfBounds) {
                     {{"", {}, true /* out of range */}, {"z", {"l", "n", 4}}});
 }
 
+TEST_F(RangeTombstoneFragmenterTest, MergeNewTombstones) {
+  auto range_del_iter = MakeRangeDelIter({{"a", "e", 10}, {"g", "h", 4}});
+  FragmentedRangeTombstoneList base(std::move(range_del_iter), bytewise_icmp);
+
+  FragmentedRangeTombstoneList fragment_list(
+      base, {{"c", "g", 8}, {"b", "c", 12}, {"x", "x", 14}}, bytewise_icmp);
+  ASSERT_EQ(5, fragment_list.num_unfragmented_tombstones());
+  FragmentedRangeTombstoneIterator iter(&fragment_list, bytewise_icmp,
+                                        kMaxSequenceNumber);
+  VerifyFragmentedRangeDels(&iter, {{"a", "b", 10},
+                                    {"b", "c", 12},
+                                    {"b", "c", 10},
+                                    {"c", "e", 10},
+                                    {"c", "e", 8},
+                                    {"e", "g", 8},
+                                    {"g", "h", 4}});
+  VerifyMaxCoveringTombstoneSeqnum(
+      &iter, {{"a", 10}, {"b", 12}, {"d", 10}, {"f", 8}, {"g", 4}, {"x", 0}});
+
+  // Merging nothing copies the fragments.
+  FragmentedRangeTombstoneList copy(fragment_list, {}, bytewise_icmp);
+  FragmentedRangeTombstoneIterator copy_iter(&copy, bytewise_icmp,
+                                             kMaxSequenceNumber);
+  VerifyFragmentedRangeDels(&copy_iter, {{"a", "b", 10},
+                                         {"b", "c", 12},
+                                         {"b", "c", 10},
+                                         {"c", "e", 10},
+                                         {"c", "e", 8},
+                                         {"e", "g", 8},
+                                         {"g", "h", 4}});
+}
+
+TEST_F(RangeTombstoneFragmenterTest, MergeTombstonesAlreadyInBase) {
+  // A memtable reader can fragment all the tombstones after a tombstone was
+  // added but before its cache is published, so the new cache merges a
+  // tombstone that the base already includes.
+  auto range_del_iter =
+      MakeRangeDelIter({{"a", "e", 10}, {"g", "h", 4}, {"c", "g", 8}});
+  FragmentedRangeTombstoneList base(std::move(range_del_iter), bytewise_icmp);
+
+  FragmentedRangeTombstoneList fragment_list(
+      base, {{"c", "g", 8}, {"b", "c", 12}, {"a", "h", 6}}, bytewise_icmp);
+  ASSERT_EQ(5, fragment_list.num_unfragmented_tombstones());
+  FragmentedRangeTombstoneIterator iter(&fragment_list, bytewise_icmp,
+                                        kMaxSequenceNumber);
+  VerifyFragmentedRangeDels(&iter, {{"a", "b", 10},
+                                    {"a", "b", 6},
+                                    {"b", "c", 12},
+                                    {"b", "c", 10},
+                                    {"b", "c", 6},
+                                    {"c", "e", 10},
+                                    {"c", "e", 8},
+                                    {"c", "e", 6},
+                                    {"e", "g", 8},
+                                    {"e", "g", 6},
+                                    {"g", "h", 6},
+                                    {"g", "h", 4}});
+
+  // Merging the same tombstones again changes nothing.
+  FragmentedRangeTombstoneList again(
+      fragment_list, {{"b", "c", 12}, {"a", "h", 6}, {"c", "g", 8}},
+      bytewise_icmp);
+  ASSERT_EQ(5, again.num_unfragmented_tombstones());
+  ASSERT_EQ(fragment_list.total_tombstone_payload_bytes(),
+            again.total_tombstone_payload_bytes());
+  FragmentedRangeTombstoneIterator again_iter(&again, bytewise_icmp,
+                                              kMaxSequenceNumber);
+  VerifyFragmentedRangeDels(&again_iter, {{"a", "b", 10},
+                                          {"a", "b", 6},
+                                          {"b", "c", 12},
+                                          {"b", "c", 10},
+                                          {"b", "c", 6},
+                                          {"c", "e", 10},
+                                          {"c", "e", 8},
+                                          {"c", "e", 6},
+                                          {"e", "g", 8},
+                                          {"e", "g", 6},
+                                          {"g", "h", 6},
+                                          {"g", "h", 4}});
+}
+
+TEST_F(RangeTombstoneFragmenterTest, MergeNewTombstonesRandomized) {
+  Random rnd(301);
+  // Merging the tombstones a few at a time gives the same fragments as
+  // fragmenting all of them at once. Empty tombstones are left out, as they
+  // split the fragments covering them only when fragmenting all at once.
+  std::vector<std::string> keys;
+  constexpr int kTombstones = 200;
+  keys.reserve(2 * kTombstones);
+  std::vector<RangeTombstone> all;
+  std::vector<std::unique_ptr<FragmentedRangeTombstoneList>> lists;
+  lists.emplace_back(new FragmentedRangeTombstoneList(
+      MakeRangeDelIter({{"m", "n", 1}}), bytewise_icmp));
+  all.emplace_back("m", "n", 1);
+  for (int i = 0; i < kTombstones;) {
+    std::vector<RangeTombstone> new_tombstones;
+    const int batch = 1 + static_cast<int>(rnd.Uniform(5));
+    for (int j = 0; j < batch && i < kTombstones; ++i, ++j) {
+      const int start = static_cast<int>(rnd.Uniform(100));
+      const int end = start + 1 + static_cast<int>(rnd.Uniform(20));
+      keys.push_back(std::to_string(start + 100));
+      Slice start_key = keys.back();
+      keys.push_back(std::to_string(end + 100));
+      Slice end_key = keys.back();
+      new_tombstones.emplace_back(start_key, end_key, i + 2);
+      all.emplace_back(start_key, end_key, i + 2);
+    }
+    lists.emplace_back(new FragmentedRangeTombstoneList(
+        *lists.back(), std::move(new_tombstones), bytewise_icmp));
+
+    FragmentedRangeTombstoneList expected_list(MakeRangeDelIter(all),
+                                               bytewise_icmp);
+    ASSERT_EQ(all.size(), lists.back()->num_unfragmented_tombstones());
+    FragmentedRangeTombstoneIterator expected(&expected_list, bytewise_icmp,
+                                              kMaxSequenceNumber);
+    FragmentedRangeTombstoneIterator merged(lists.back().get(), bytewise_icmp,
+                                            kMaxSequenceNumber);
+    for (expected.SeekToFirst(), merged.SeekToFirst(); expected.Valid();
+         expected.Next(), merged.Next()) {
+      ASSERT_TRUE(merged.Valid());
+      ASSERT_EQ(expected.start_key(), merged.start_key());
+      ASSERT_EQ(expected.end_key(), merged.end_key());
+      ASSERT_EQ(expected.seq(), merged.seq());
+    }
+    ASSERT_FALSE(merged.Valid());
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
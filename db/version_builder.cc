@@ -201,7 +201,9 @@ class VersionBuilder::Rep {
       return shared_meta_->GetBlobFileNumber();
     }
 
-    bool HasDelta() const { return !delta_.IsEmpty(); }
+    bool HasDelta() const { return relocated_ || !delta_.IsEmpty(); }
+
+    bool IsRelocated() const { return relocated_; }
 
     const std::unordered_set<uint64_t>& GetLinkedSsts() const {
       return linked_ssts_;
@@ -227,6 +229,14 @@ class VersionBuilder::Rep {
       return true;
     }
 
+    void Relocate(std::shared_ptr<SharedBlobFileMetaData>&& shared_meta) {
+      assert(shared_meta);
+      assert(shared_meta->GetBlobFileNumber() == GetBlobFileNumber());
+
+      shared_meta_ = std::move(shared_meta);
+      relocated_ = true;
+    }
+
     void LinkSst(uint64_t sst_file_number) {
       delta_.LinkSst(sst_file_number);
 
@@ -249,6 +259,8 @@ class VersionBuilder::Rep {
     BlobFileMetaData::LinkedSsts linked_ssts_;
     uint64_t garbage_blob_count_ = 0;
     uint64_t garbage_blob_bytes_ = 0;
+    // Whether shared_meta_ was replaced because the blobs were moved
+    bool relocated_ = false;
   };
 
   const FileOptions& file_options_;
@@ -735,39 +747,46 @@ class VersionBuilder::Rep {
     return nullptr;
   }
 
-  Status ApplyBlobFileAddition(const BlobFileAddition& blob_file_addition) {
-    const uint64_t blob_file_number = blob_file_addition.GetBlobFileNumber();
-
-    if (IsBlobFileInVersion(blob_file_number)) {
-      std::ostringstream oss;
-      oss << "Blob file #" << blob_file_number << " already added";
-
-      return Status::Corruption("VersionBuilder", oss.str());
-    }
+  // Returns the deleter for SharedBlobFileMetaData objects, which marks the
+  // file holding the blobs obsolete.
+  auto MakeBlobFileDeleter() const {
+    return [vs = version_set_, ioptions = ioptions_,
+            bc = cfd_ ? cfd_->blob_file_cache()
+                      : nullptr](SharedBlobFileMetaData* shared_meta) {
+      assert(shared_meta);
+      const uint64_t blob_file_number =
+          shared_meta->GetPhysicalBlobFileNumber();
 
-    auto deleter = [vs = version_set_, ioptions = ioptions_,
-                    bc = cfd_ ? cfd_->blob_file_cache()
-                              : nullptr](SharedBlobFileMetaData* shared_meta) {
       if (vs) {
         assert(ioptions);
         assert(!ioptions->cf_paths.empty());
-        assert(shared_meta);
 
-        vs->AddObsoleteBlobFile(shared_meta->GetBlobFileNumber(),
+        vs->AddObsoleteBlobFile(blob_file_number,
                                 ioptions->cf_paths.front().path);
       }
       if (bc) {
-        bc->Evict(shared_meta->GetBlobFileNumber());
+        bc->Evict(blob_file_number);
       }
 
       delete shared_meta;
     };
+  }
+
+  Status ApplyBlobFileAddition(const BlobFileAddition& blob_file_addition) {
+    const uint64_t blob_file_number = blob_file_addition.GetBlobFileNumber();
+
+    if (IsBlobFileInVersion(blob_file_number)) {
+      std::ostringstream oss;
+      oss << "Blob file #" << blob_file_number << " already added";
+
+      return Status::Corruption("VersionBuilder", oss.str());
+    }
 
     auto shared_meta = SharedBlobFileMetaData::Create(
         blob_file_number, blob_file_addition.GetTotalBlobCount(),
         blob_file_addition.GetTotalBlobBytes(),
         blob_file_addition.GetChecksumMethod(),
-        blob_file_addition.GetChecksumValue(), std::move(deleter));
+        blob_file_addition.GetChecksumValue(), MakeBlobFileDeleter());
 
     mutable_blob_file_metas_.emplace(
         blob_file_number, MutableBlobFileMetaData(std::move(shared_meta)));
@@ -813,6 +832,68 @@ class VersionBuilder::Rep {
     return Status::OK();
   }
 
+  Status ApplyBlobFileRelocation(
+      const BlobFileRelocation& blob_file_relocation) {
+    const uint64_t blob_file_number = blob_file_relocation.GetBlobFileNumber();
+
+    MutableBlobFileMetaData* const mutable_meta =
+        GetOrCreateMutableBlobFileMetaData(blob_file_number);
+
+    if (!mutable_meta) {
+      // The blob file GC job validates its relocations before writing them
+      // to the MANIFEST, but compactions can drop the file while the edit
+      // waits for its turn. None of its blobs are referenced anymore then, so
+      // there is nothing to relocate, and the new file is left obsolete.
+      return Status::OK();
+    }
+
+    const auto& shared_meta = mutable_meta->GetSharedMeta();
+    assert(shared_meta);
+
+    if (blob_file_relocation.GetBlobCount() >
+            shared_meta->GetTotalBlobCount() ||
+        blob_file_relocation.GetBlobBytes() >
+            shared_meta->GetTotalBlobBytes()) {
+      std::ostringstream oss;
+      oss << "Relocation overflow for blob file #" << blob_file_number;
+
+      return Status::Corruption("VersionBuilder", oss.str());
+    }
+
+    mutable_meta->Relocate(SharedBlobFileMetaData::CreateRelocated(
+        *shared_meta,
+        std::make_shared<const BlobFileRelocation>(blob_file_relocation),
+        MakeBlobFileDeleter()));
+
+    Status s;
+    if (track_found_and_missing_files_) {
+      assert(version_edit_handler_);
+      // The original file may be gone; only the new one needs to exist.
+      missing_blob_files_.erase(blob_file_number);
+      missing_blob_files_high_ = kInvalidBlobFileNumber;
+      for (uint64_t missing_blob_file : missing_blob_files_) {
+        missing_blob_files_high_ =
+            std::max(missing_blob_files_high_, missing_blob_file);
+      }
+
+      s = version_edit_handler_->VerifyBlobFile(
+          cfd_, blob_file_relocation.GetNewBlobFileNumber(),
+          BlobFileAddition(blob_file_relocation.GetNewBlobFileNumber(),
+                           blob_file_relocation.GetBlobCount(),
+                           blob_file_relocation.GetBlobBytes(),
+                           blob_file_relocation.GetChecksumMethod(),
+                           blob_file_relocation.GetChecksumValue()));
+      if (s.IsPathNotFound() || s.IsNotFound() || s.IsCorruption()) {
+        missing_blob_files_high_ =
+            std::max(missing_blob_files_high_, blob_file_number);
+        missing_blob_files_.insert(blob_file_number);
+        s = Status::OK();
+      }
+    }
+
+    return s;
+  }
+
   int GetCurrentLevelForTableFile(uint64_t file_number) const {
     auto it = table_file_levels_.find(file_number);
     if (it != table_file_levels_.end()) {
@@ -1075,6 +1156,15 @@ class VersionBuilder::Rep {
       version_updated = true;
     }
 
+    // Move the blobs of blob files rewritten by blob file GC
+    for (const auto& blob_file_relocation : edit->GetBlobFileRelocations()) {
+      const Status s = ApplyBlobFileRelocation(blob_file_relocation);
+      if (!s.ok()) {
+        return s;
+      }
+      version_updated = true;
+    }
+
     // Delete table files
     for (const auto& deleted_file : edit->GetDeletedFiles()) {
       const int level = deleted_file.first;
@@ -1236,7 +1326,8 @@ class VersionBuilder::Rep {
                             const MutableBlobFileMetaData& mutable_meta) {
 #ifndef NDEBUG
       assert(base_meta);
-      assert(base_meta->GetSharedMeta() == mutable_meta.GetSharedMeta());
+      assert(base_meta->GetSharedMeta() == mutable_meta.GetSharedMeta() ||
+             mutable_meta.IsRelocated());
 #else
       (void)base_meta;
 #endif
@@ -1335,7 +1426,8 @@ class VersionBuilder::Rep {
                             const std::shared_ptr<BlobFileMetaData>& base_meta,
                             const MutableBlobFileMetaData& mutable_meta) {
       assert(base_meta);
-      assert(base_meta->GetSharedMeta() == mutable_meta.GetSharedMeta());
+      assert(base_meta->GetSharedMeta() == mutable_meta.GetSharedMeta() ||
+             mutable_meta.IsRelocated());
 
       if (!mutable_meta.HasDelta()) {
         assert(base_meta->GetGarbageBlobCount() ==
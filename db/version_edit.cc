@@ -242,6 +242,11 @@ bool VersionEdit::EncodeTo(std::string* dst,
     blob_file_garbage.EncodeTo(dst);
   }
 
+  for (const auto& blob_file_relocation : blob_file_relocations_) {
+    PutVarint32(dst, kBlobFileRelocation);
+    blob_file_relocation.EncodeTo(dst);
+  }
+
   for (const auto& wal_addition : wal_additions_) {
     PutVarint32(dst, kWalAddition2);
     std::string encoded;
@@ -658,6 +663,17 @@ Status VersionEdit::DecodeFrom(const Slice& src) {
         break;
       }
 
+      case kBlobFileRelocation: {
+        BlobFileRelocation blob_file_relocation;
+        const Status s = blob_file_relocation.DecodeFrom(&input);
+        if (!s.ok()) {
+          return s;
+        }
+
+        AddBlobFileRelocation(std::move(blob_file_relocation));
+        break;
+      }
+
       case kWalAddition: {
         WalAddition wal_addition;
         const Status s = wal_addition.DecodeFrom(&input);
@@ -905,6 +921,11 @@ std::string VersionEdit::DebugString(bool hex_key) const {
     r.append(blob_file_garbage.DebugString());
   }
 
+  for (const auto& blob_file_relocation : blob_file_relocations_) {
+    r.append("\n  BlobFileRelocation: ");
+    r.append(blob_file_relocation.DebugString());
+  }
+
   for (const auto& wal_addition : wal_additions_) {
     r.append("\n  WalAddition: ");
     r.append(wal_addition.DebugString());
@@ -1045,6 +1066,20 @@ std::string VersionEdit::DebugJSON(int edit_num, bool hex_key) const {
     jw.EndArray();
   }
 
+  if (!blob_file_relocations_.empty()) {
+    jw << "BlobFileRelocations";
+
+    jw.StartArray();
+
+    for (const auto& blob_file_relocation : blob_file_relocations_) {
+      jw.StartArrayedObject();
+      jw << blob_file_relocation;
+      jw.EndArrayedObject();
+    }
+
+    jw.EndArray();
+  }
+
   if (!wal_additions_.empty()) {
     jw << "WalAdditions";
 
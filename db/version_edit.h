@@ -17,6 +17,7 @@
 
 #include "db/blob/blob_file_addition.h"
 #include "db/blob/blob_file_garbage.h"
+#include "db/blob/blob_file_relocation.h"
 #include "db/dbformat.h"
 #include "db/wal_edit.h"
 #include "memory/arena.h"
@@ -58,6 +59,7 @@ enum Tag : uint32_t {
 
   kBlobFileAddition = 400,
   kBlobFileGarbage,
+  kBlobFileRelocation,
 
   // Mask for an unidentified tag from the future which can be safely ignored.
   kTagSafeIgnoreMask = 1 << 13,
@@ -164,15 +166,25 @@ struct FileDescriptor {
 };
 
 struct FileSampledStats {
-  FileSampledStats() : num_reads_sampled(0) {}
+  FileSampledStats()
+      : num_reads_sampled(0),
+        num_misses_sampled(0),
+        num_false_positives_sampled(0) {}
   FileSampledStats(const FileSampledStats& other) { *this = other; }
   FileSampledStats& operator=(const FileSampledStats& other) {
     num_reads_sampled = other.num_reads_sampled.load();
+    num_misses_sampled = other.num_misses_sampled.load();
+    num_false_positives_sampled = other.num_false_positives_sampled.load();
     return *this;
   }
 
   // number of user reads to this file.
   mutable std::atomic<uint64_t> num_reads_sampled;
+  // number of point lookups to this file that found no entry for the key,
+  // i.e. the lookups a filter should have stopped.
+  mutable std::atomic<uint64_t> num_misses_sampled;
+  // number of those misses that a filter did not stop.
+  mutable std::atomic<uint64_t> num_false_positives_sampled;
 };
 
 struct FileMetaData {
@@ -381,6 +393,22 @@ struct FileMetaData {
     return res;
   }
 
+  // Returns whether the range tombstone of this standalone range tombstone
+  // file deletes every entry of `file`, judging by the file boundaries. Not
+  // applicable with user-defined timestamps.
+  bool StandAloneRangeTombstoneCovers(const FileMetaData& file,
+                                      const Comparator* ucmp) const {
+    assert(FileIsStandAloneRangeTombstone());
+    // When range data and point data has the same sequence number, point
+    // data wins. Range deletion end key is exclusive, so check it's bigger
+    // than file right boundary user key.
+    return fd.smallest_seqno > file.fd.largest_seqno &&
+           ucmp->CompareWithoutTimestamp(smallest.user_key(),
+                                         file.smallest.user_key()) <= 0 &&
+           ucmp->CompareWithoutTimestamp(largest.user_key(),
+                                         file.largest.user_key()) > 0;
+  }
+
   static uint64_t CalculateTailSize(uint64_t file_size,
                                     const TableProperties& props) {
 #ifndef NDEBUG
@@ -644,6 +672,19 @@ class VersionEdit {
     blob_file_garbages_ = std::move(blob_file_garbages);
   }
 
+  // Move the blobs of an existing blob file to a new file.
+  void AddBlobFileRelocation(BlobFileRelocation blob_file_relocation) {
+    blob_file_relocations_.emplace_back(std::move(blob_file_relocation));
+    files_to_quarantine_.push_back(
+        blob_file_relocations_.back().GetNewBlobFileNumber());
+  }
+
+  // Retrieve all the blob file relocations added.
+  using BlobFileRelocations = std::vector<BlobFileRelocation>;
+  const BlobFileRelocations& GetBlobFileRelocations() const {
+    return blob_file_relocations_;
+  }
+
   // Add a WAL (either just created or closed).
   // AddWal and DeleteWalsBefore cannot be called on the same VersionEdit.
   void AddWal(WalNumber number, WalMetadata metadata = WalMetadata()) {
@@ -677,7 +718,8 @@ class VersionEdit {
   size_t NumEntries() const {
     return new_files_.size() + deleted_files_.size() +
            blob_file_additions_.size() + blob_file_garbages_.size() +
-           wal_additions_.size() + !wal_deletion_.IsEmpty();
+           blob_file_relocations_.size() + wal_additions_.size() +
+           !wal_deletion_.IsEmpty();
   }
 
   void SetColumnFamily(uint32_t column_family_id) {
@@ -795,6 +837,7 @@ class VersionEdit {
 
   BlobFileAdditions blob_file_additions_;
   BlobFileGarbages blob_file_garbages_;
+  BlobFileRelocations blob_file_relocations_;
 
   WalAdditions wal_additions_;
   WalDeletion wal_deletion_;
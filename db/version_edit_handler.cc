@@ -17,6 +17,7 @@
 #include "db/version_edit.h"
 #include "logging/logging.h"
 #include "monitoring/persistent_stats_history.h"
+#include "util/run_in_parallel.h"
 #include "util/udt_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -30,37 +31,16 @@ void VersionEditHandlerBase::Iterate(log::Reader& reader,
 
   [[maybe_unused]] size_t recovered_edits = 0;
   Status s = Initialize();
-  while (reader.LastRecordEnd() < max_manifest_read_size_ && s.ok() &&
+  if (s.ok() && num_threads_ > 1) {
+    s = IterateInBatches(reader, log_read_status, &recovered_edits);
+  }
+  while (num_threads_ <= 1 &&
+         reader.LastRecordEnd() < max_manifest_read_size_ && s.ok() &&
          reader.ReadRecord(&record, &scratch) && log_read_status->ok()) {
     VersionEdit edit;
     s = edit.DecodeFrom(record);
     if (s.ok()) {
-      s = read_buffer_.AddEdit(&edit);
-    }
-    if (s.ok()) {
-      ColumnFamilyData* cfd = nullptr;
-      if (edit.IsInAtomicGroup()) {
-        if (read_buffer_.IsFull()) {
-          s = OnAtomicGroupReplayBegin();
-          for (size_t i = 0; s.ok() && i < read_buffer_.replay_buffer().size();
-               i++) {
-            auto& e = read_buffer_.replay_buffer()[i];
-            s = ApplyVersionEdit(e, &cfd);
-            if (s.ok()) {
-              recovered_edits++;
-            }
-          }
-          if (s.ok()) {
-            read_buffer_.Clear();
-            s = OnAtomicGroupReplayEnd();
-          }
-        }
-      } else {
-        s = ApplyVersionEdit(edit, &cfd);
-        if (s.ok()) {
-          recovered_edits++;
-        }
-      }
+      s = ProcessEdit(edit, &recovered_edits);
     }
   }
   if (s.ok() && !log_read_status->ok()) {
@@ -97,6 +77,105 @@ void VersionEditHandlerBase::Iterate(log::Reader& reader,
                            &recovered_edits);
 }
 
+Status VersionEditHandlerBase::ProcessEdit(VersionEdit& edit,
+                                           size_t* recovered_edits) {
+  assert(recovered_edits);
+  Status s = read_buffer_.AddEdit(&edit);
+  if (s.ok()) {
+    ColumnFamilyData* cfd = nullptr;
+    if (edit.IsInAtomicGroup()) {
+      if (read_buffer_.IsFull()) {
+        s = OnAtomicGroupReplayBegin();
+        for (size_t i = 0; s.ok() && i < read_buffer_.replay_buffer().size();
+             i++) {
+          auto& e = read_buffer_.replay_buffer()[i];
+          s = ApplyVersionEdit(e, &cfd);
+          if (s.ok()) {
+            (*recovered_edits)++;
+          }
+        }
+        // The replayed edits are about to be cleared.
+        Status apply_s = ApplyPendingEdits();
+        if (s.ok()) {
+          s = apply_s;
+        }
+        if (s.ok()) {
+          read_buffer_.Clear();
+          s = OnAtomicGroupReplayEnd();
+        }
+      }
+    } else {
+      s = ApplyVersionEdit(edit, &cfd);
+      if (s.ok()) {
+        (*recovered_edits)++;
+      }
+    }
+  }
+  return s;
+}
+
+Status VersionEditHandlerBase::IterateInBatches(log::Reader& reader,
+                                                Status* log_read_status,
+                                                size_t* recovered_edits) {
+  // Large enough to amortize starting the decoding threads.
+  constexpr size_t kBatchSize = 1024;
+  // Below this, a batch is decoded on the calling thread.
+  constexpr size_t kMinParallelBatchSize = 64;
+
+  Slice record;
+  std::string scratch;
+  std::vector<std::string> records;
+  std::vector<VersionEdit> edits;
+  std::vector<Status> decode_statuses;
+  Status s;
+  bool more_records = true;
+  while (s.ok() && more_records) {
+    records.clear();
+    while (records.size() < kBatchSize) {
+      if (reader.LastRecordEnd() >= max_manifest_read_size_ ||
+          !reader.ReadRecord(&record, &scratch) || !log_read_status->ok()) {
+        more_records = false;
+        break;
+      }
+      records.emplace_back(record.data(), record.size());
+    }
+    if (records.empty()) {
+      break;
+    }
+
+    edits.clear();
+    edits.resize(records.size());
+    decode_statuses.assign(records.size(), Status::OK());
+    auto decode = [&](size_t i) {
+      decode_statuses[i] = edits[i].DecodeFrom(records[i]);
+    };
+    if (records.size() < kMinParallelBatchSize) {
+      for (size_t i = 0; i < records.size(); ++i) {
+        decode(i);
+      }
+    } else {
+      RunInParallel(num_threads_, records.size(), decode);
+    }
+
+    // Records after the first one that fails are ignored, like when they are
+    // decoded one at a time.
+    for (size_t i = 0; i < edits.size(); ++i) {
+      if (s.ok()) {
+        s = decode_statuses[i];
+      }
+      if (s.ok()) {
+        s = ProcessEdit(edits[i], recovered_edits);
+      }
+    }
+    // `edits` is reused by the next batch.
+    Status apply_s = ApplyPendingEdits();
+    if (s.ok()) {
+      s = apply_s;
+    }
+  }
+  return s;
+}
+
 Status ListColumnFamiliesHandler::ApplyVersionEdit(
     VersionEdit& edit, ColumnFamilyData** /*unused*/) {
   Status s;
@@ -167,6 +246,17 @@ Status FileChecksumRetriever::ApplyVersionEdit(VersionEdit& edit,
         new_blob_file.GetBlobFileNumber(),
         std::make_pair(checksum_value, checksum_method));
   }
+  for (const auto& relocation : edit.GetBlobFileRelocations()) {
+    std::string checksum_value = relocation.GetChecksumValue();
+    std::string checksum_method = relocation.GetChecksumMethod();
+    if (checksum_method.empty()) {
+      checksum_value = kUnknownFileChecksum;
+      checksum_method = kUnknownFileChecksumFuncName;
+    }
+    cf_file_checksums_[column_family_id].emplace(
+        relocation.GetNewBlobFileNumber(),
+        std::make_pair(checksum_value, checksum_method));
+  }
   return Status::OK();
 }
 
@@ -187,8 +277,13 @@ VersionEditHandler::VersionEditHandler(
       skip_load_table_files_(skip_load_table_files),
       initialized_(false),
       allow_incomplete_valid_version_(allow_incomplete_valid_version),
-      epoch_number_requirement_(epoch_number_requirement) {
+      epoch_number_requirement_(epoch_number_requirement),
+      defer_apply_edits_(
+          version_set->db_options()->manifest_recovery_threads > 1 &&
+          !track_found_and_missing_files) {
   assert(version_set_ != nullptr);
+  num_threads_ =
+      std::max(1, version_set_->db_options()->manifest_recovery_threads);
 }
 
 Status VersionEditHandler::Initialize() {
@@ -287,6 +382,8 @@ Status VersionEditHandler::OnColumnFamilyDrop(VersionEdit& edit,
   ColumnFamilyData* tmp_cfd = nullptr;
   Status s;
   if (cf_in_builders) {
+    // The edits of the dropped column family go away with its builder.
+    s = ApplyPendingEdits();
     tmp_cfd = DestroyCfAndCleanup(edit);
   } else if (do_not_open_cf) {
     do_not_open_column_families_.erase(edit.GetColumnFamily());
@@ -525,6 +622,10 @@ Status VersionEditHandler::MaybeCreateVersionBeforeApplyEdit(
   assert(builder_iter != builders_.end());
   auto* builder = builder_iter->second->version_builder();
   if (force_create_version) {
+    s = ApplyPendingEdits();
+    if (!s.ok()) {
+      return s;
+    }
     auto* v = new Version(cfd, version_set_, version_set_->file_options_,
                           cfd->GetLatestMutableCFOptions(), io_tracer_,
                           version_set_->current_version_number_++,
@@ -540,10 +641,56 @@ Status VersionEditHandler::MaybeCreateVersionBeforeApplyEdit(
       delete v;
     }
   }
+  if (defer_apply_edits_) {
+    pending_edits_[cfd->GetID()].push_back(&edit);
+    return s;
+  }
   s = builder->Apply(&edit);
   return s;
 }
 
+Status VersionEditHandler::ApplyPendingEdits() {
+  if (pending_edits_.empty()) {
+    return Status::OK();
+  }
+  std::vector<std::pair<VersionBuilder*, std::vector<const VersionEdit*>*>>
+      work;
+  work.reserve(pending_edits_.size());
+  for (auto& cf_id_and_edits : pending_edits_) {
+    auto builder_iter = builders_.find(cf_id_and_edits.first);
+    assert(builder_iter != builders_.end());
+    work.emplace_back(builder_iter->second->version_builder(),
+                      &cf_id_and_edits.second);
+  }
+  // Builders are independent of each other, but the edits of one column
+  // family must be applied in order.
+  std::vector<Status> statuses(work.size());
+  auto apply = [&](size_t i) {
+    for (const VersionEdit* edit : *work[i].second) {
+      statuses[i] = work[i].first->Apply(edit);
+      if (!statuses[i].ok()) {
+        break;
+      }
+    }
+  };
+  if (work.size() == 1) {
+    apply(0);
+  } else {
+    RunInParallel(num_threads_, work.size(), apply);
+  }
+  pending_edits_.clear();
+
+  Status s;
+  for (auto& status : statuses) {
+    if (s.ok()) {
+      s = status;
+    } else {
+      status.PermitUncheckedError();
+    }
+  }
+  return s;
+}
+
 Status VersionEditHandler::LoadTables(ColumnFamilyData* cfd,
                                       bool prefetch_index_and_filter_in_cache,
                                       bool is_initial_load) {
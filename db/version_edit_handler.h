@@ -46,13 +46,30 @@ class VersionEditHandlerBase {
   virtual void CheckIterationResult(const log::Reader& /*reader*/,
                                     Status* /*s*/) {}
 
+  // Called before the edits passed to ApplyVersionEdit() since the previous
+  // call are destroyed, for handlers that defer part of their processing.
+  virtual Status ApplyPendingEdits() { return Status::OK(); }
+
   void ClearReadBuffer() { read_buffer_.Clear(); }
 
   Status status_;
 
   const ReadOptions& read_options_;
 
+  // Number of threads decoding MANIFEST records in Iterate(). With 1, each
+  // record is decoded and applied before the next one is read.
+  int num_threads_ = 1;
+
  private:
+  // Iterate() when num_threads_ > 1: reads records in batches, decodes each
+  // batch in parallel and then applies its edits in order.
+  Status IterateInBatches(log::Reader& reader, Status* log_read_status,
+                          size_t* recovered_edits);
+
+  // Applies a decoded edit, buffering the edits of an atomic group until the
+  // group is complete.
+  Status ProcessEdit(VersionEdit& edit, size_t* recovered_edits);
+
   AtomicGroupReadBuffer read_buffer_;
   const uint64_t max_manifest_read_size_;
 };
@@ -225,6 +242,10 @@ class VersionEditHandler : public VersionEditHandlerBase {
     return !version_set_->unchanging();
   }
 
+  // Applies the edits deferred by MaybeCreateVersionBeforeApplyEdit() to the
+  // version builders, one thread per column family.
+  Status ApplyPendingEdits() override;
+
   const bool read_only_;
   std::vector<ColumnFamilyDescriptor> column_families_;
   VersionSet* version_set_;
@@ -249,6 +270,13 @@ class VersionEditHandler : public VersionEditHandlerBase {
   const bool allow_incomplete_valid_version_;
   EpochNumberRequirement epoch_number_requirement_;
   std::unordered_set<uint32_t> cfds_to_mark_no_udt_;
+  // With num_threads_ > 1 and without tracking missing files, the edits are
+  // applied to the version builders in parallel across column families:
+  // MaybeCreateVersionBeforeApplyEdit() queues them here, in MANIFEST order
+  // per column family, until ApplyPendingEdits().
+  const bool defer_apply_edits_;
+  std::unordered_map<uint32_t, std::vector<const VersionEdit*>>
+      pending_edits_;
 
  private:
   Status ExtractInfoFromVersionEdit(ColumnFamilyData* cfd,
@@ -392,6 +392,38 @@ TEST_F(VersionEditTest, BlobFileAdditionAndGarbage) {
   TestEncodeDecode(edit);
 }
 
+TEST_F(VersionEditTest, BlobFileRelocation) {
+  VersionEdit edit;
+
+  // Blobs at offsets 100, 200 and 300 of blob file #5 were copied back to
+  // back to offsets 20, 120 and 170 of blob file #12.
+  BlobFileRelocation::OffsetRuns offset_runs{{100, 20}, {300, 170}};
+  edit.AddBlobFileRelocation(
+      BlobFileRelocation(5, 12, 3, 250, "Hash", "Value", offset_runs));
+  edit.AddBlobFileRelocation(BlobFileRelocation(
+      6, 13, 0, 0, "", "", BlobFileRelocation::OffsetRuns()));
+
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  ASSERT_TRUE(edit.EncodeTo(&encoded, 0 /* ts_sz */));
+  VersionEdit decoded;
+  ASSERT_OK(decoded.DecodeFrom(encoded));
+  ASSERT_EQ(decoded.GetBlobFileRelocations(), edit.GetBlobFileRelocations());
+  // The new files are deleted if the edit cannot be committed.
+  const autovector<uint64_t>* files_to_quarantine =
+      edit.GetFilesToQuarantineIfCommitFail();
+  ASSERT_EQ(files_to_quarantine->size(), 2);
+  ASSERT_EQ((*files_to_quarantine)[0], 12);
+  ASSERT_EQ((*files_to_quarantine)[1], 13);
+
+  const BlobFileRelocation& relocation = decoded.GetBlobFileRelocations()[0];
+  ASSERT_EQ(relocation.GetOffsetRuns(), offset_runs);
+  ASSERT_EQ(relocation.MapOffset(100), 20);
+  ASSERT_EQ(relocation.MapOffset(200), 120);
+  ASSERT_EQ(relocation.MapOffset(300), 170);
+}
+
 TEST_F(VersionEditTest, AddWalEncodeDecode) {
   VersionEdit edit;
   for (uint64_t log_number = 1; log_number <= 20; log_number++) {
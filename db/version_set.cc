@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <array>
 #include <cinttypes>
+#include <cmath>
 #include <cstdio>
 #include <list>
 #include <map>
@@ -1936,11 +1937,12 @@ void Version::GetColumnFamilyMetaData(ColumnFamilyMetaData* cf_meta) {
     assert(meta);
 
     cf_meta->blob_files.emplace_back(
-        meta->GetBlobFileNumber(), BlobFileName("", meta->GetBlobFileNumber()),
+        meta->GetBlobFileNumber(),
+        BlobFileName("", meta->GetPhysicalBlobFileNumber()),
         ioptions.cf_paths.front().path, meta->GetBlobFileSize(),
         meta->GetTotalBlobCount(), meta->GetTotalBlobBytes(),
         meta->GetGarbageBlobCount(), meta->GetGarbageBlobBytes(),
-        meta->GetChecksumMethod(), meta->GetChecksumValue());
+        meta->GetPhysicalChecksumMethod(), meta->GetPhysicalChecksumValue());
     ++cf_meta->blob_file_count;
     cf_meta->blob_file_size += meta->GetBlobFileSize();
   }
@@ -2377,11 +2379,16 @@ Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
     return Status::Corruption("Invalid blob file number");
   }
 
+  uint64_t offset = blob_index.offset();
+  if (const BlobFileRelocation* relocation = blob_file_meta->GetRelocation()) {
+    offset = relocation->MapOffset(offset);
+  }
+
   assert(blob_source_);
   value->Reset();
   const Status s = blob_source_->GetBlob(
-      read_options, user_key, blob_file_number, blob_index.offset(),
-      blob_file_meta->GetBlobFileSize(), blob_index.size(),
+      read_options, user_key, blob_file_meta->GetPhysicalBlobFileNumber(),
+      offset, blob_file_meta->GetBlobFileSize(), blob_index.size(),
       blob_index.compression(), prefetch_buffer, value, bytes_read);
 
   return s;
@@ -2425,14 +2432,20 @@ void Version::MultiGetBlob(
         continue;
       }
 
+      // Relocation keeps the blobs in order, so the offsets stay sorted.
+      const BlobFileRelocation* const relocation =
+          blob_file_meta->GetRelocation();
       blob_reqs_in_file.emplace_back(
           key_context->get_context->ukey_to_get_blob_value(),
-          blob_index.offset(), blob_index.size(), blob_index.compression(),
-          &blob.result, key_context->s);
+          relocation ? relocation->MapOffset(blob_index.offset())
+                     : blob_index.offset(),
+          blob_index.size(), blob_index.compression(), &blob.result,
+          key_context->s);
     }
     if (blob_reqs_in_file.size() > 0) {
       const auto file_size = blob_file_meta->GetBlobFileSize();
-      blob_reqs.emplace_back(file_number, file_size, blob_reqs_in_file);
+      blob_reqs.emplace_back(blob_file_meta->GetPhysicalBlobFileNumber(),
+                             file_size, blob_reqs_in_file);
     }
   }
 
@@ -2530,8 +2543,15 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       // stop here.
       break;
     }
-    if (get_context.sample()) {
+    const bool sampled = get_context.sample();
+    const GetContext::GetState state_before = get_context.State();
+    size_t num_operands_before = 0;
+    uint64_t num_filter_useful_before = 0;
+    if (sampled) {
       sample_file_read_inc(f->file_metadata);
+      num_operands_before = merge_context->GetNumOperands();
+      num_filter_useful_before =
+          get_context.get_context_stats_.num_filter_useful;
     }
 
     bool timer_enabled =
@@ -2550,6 +2570,14 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       PERF_COUNTER_BY_LEVEL_ADD(get_from_table_nanos, timer.ElapsedNanos(),
                                 fp.GetHitFileLevel());
     }
+    if (sampled && status->ok() && get_context.State() == state_before &&
+        merge_context->GetNumOperands() == num_operands_before &&
+        *max_covering_tombstone_seq == 0) {
+      // Nothing for the key in this file
+      sample_file_read_miss_inc(
+          f->file_metadata, get_context.get_context_stats_.num_filter_useful >
+                                num_filter_useful_before);
+    }
     if (!status->ok()) {
       if (db_statistics_ != nullptr) {
         get_context.ReportCounters();
@@ -3729,6 +3757,7 @@ void VersionStorageInfo::ComputeCompactionScore(
       mutable_cf_options.blob_garbage_collection_age_cutoff,
       mutable_cf_options.blob_garbage_collection_force_threshold,
       mutable_cf_options.enable_blob_garbage_collection);
+  ComputeFilesCoveredByRangeTombstones();
 
   EstimateCompactionBytesNeeded(mutable_cf_options);
 }
@@ -3762,6 +3791,79 @@ void VersionStorageInfo::ComputeFilesMarkedForCompaction(int last_level) {
   }
 }
 
+void VersionStorageInfo::ComputeFilesCoveredByRangeTombstones() {
+  files_covered_by_range_tombstones_.clear();
+  files_covered_by_range_tombstones_threshold_ = kMaxSequenceNumber;
+  // With user-defined timestamps, the file boundaries do not tell whether a
+  // range tombstone covers a file, see
+  // Compaction::FilterInputsForCompactionIterator().
+  if (compaction_style_ != kCompactionStyleLevel ||
+      user_comparator_->timestamp_size() != 0) {
+    return;
+  }
+
+  std::vector<FileMetaData*> overlapping_files;
+  for (int level = 0; level < num_non_empty_levels_ - 1; level++) {
+    for (auto* tombstone_file : files_[level]) {
+      if (tombstone_file->being_compacted ||
+          !tombstone_file->FileIsStandAloneRangeTombstone()) {
+        continue;
+      }
+      for (int lower_level = level + 1; lower_level < num_non_empty_levels_;
+           lower_level++) {
+        GetOverlappingInputs(lower_level, &tombstone_file->smallest,
+                             &tombstone_file->largest, &overlapping_files,
+                             /*hint_index=*/-1, /*file_index=*/nullptr,
+                             /*expand_range=*/false);
+        for (auto* f : overlapping_files) {
+          if (f->being_compacted ||
+              !tombstone_file->StandAloneRangeTombstoneCovers(
+                  *f, user_comparator_)) {
+            continue;
+          }
+          if (tombstone_file->fd.smallest_seqno > oldest_snapshot_seqnum_) {
+            // A snapshot older than the range tombstone still sees the file.
+            // Releasing it makes the file eligible to be dropped.
+            files_covered_by_range_tombstones_threshold_ =
+                std::min(files_covered_by_range_tombstones_threshold_,
+                         tombstone_file->fd.smallest_seqno);
+            continue;
+          }
+          files_covered_by_range_tombstones_.push_back(
+              {lower_level, f, tombstone_file->fd.smallest_seqno});
+        }
+      }
+    }
+  }
+  if (files_covered_by_range_tombstones_.empty()) {
+    return;
+  }
+
+  // A file covered by several range tombstones is listed once, with the
+  // oldest of them.
+  std::sort(files_covered_by_range_tombstones_.begin(),
+            files_covered_by_range_tombstones_.end(),
+            [this](const FileCoveredByRangeTombstone& a,
+                   const FileCoveredByRangeTombstone& b) {
+              if (a.level != b.level) {
+                return a.level < b.level;
+              }
+              if (a.file != b.file) {
+                return internal_comparator_->Compare(a.file->smallest,
+                                                     b.file->smallest) < 0;
+              }
+              return a.tombstone_seqno < b.tombstone_seqno;
+            });
+  auto last = std::unique(files_covered_by_range_tombstones_.begin(),
+                          files_covered_by_range_tombstones_.end(),
+                          [](const FileCoveredByRangeTombstone& a,
+                             const FileCoveredByRangeTombstone& b) {
+                            return a.file == b.file;
+                          });
+  files_covered_by_range_tombstones_.resize(
+      last - files_covered_by_range_tombstones_.begin());
+}
+
 void VersionStorageInfo::ComputeExpiredTtlFiles(
     const ImmutableOptions& ioptions, const uint64_t ttl) {
   expired_ttl_files_.clear();
@@ -4061,8 +4163,17 @@ void SortFileByOverlappingRatio(
   FileTtlBooster ttl_booster(static_cast<uint64_t>(curr_time), ttl,
                              num_non_empty_levels, level);
 
+  const Comparator* ucmp = icmp.user_comparator();
+  // The next level files a standalone range tombstone file covers are dropped
+  // rather than rewritten when compacting it, see
+  // Compaction::FilterInputsForCompactionIterator(). Leaving them out ranks
+  // such a file by the space it reclaims per byte written.
+  const bool can_skip_covered_files = ucmp->timestamp_size() == 0;
+
   for (auto& file : files) {
     uint64_t overlapping_bytes = 0;
+    const bool skip_covered_files =
+        can_skip_covered_files && file->FileIsStandAloneRangeTombstone();
     // Skip files in next level that is smaller than current file
     while (next_level_it != next_level_files.end() &&
            icmp.Compare((*next_level_it)->largest, file->smallest) < 0) {
@@ -4071,7 +4182,10 @@ void SortFileByOverlappingRatio(
 
     while (next_level_it != next_level_files.end() &&
            icmp.Compare((*next_level_it)->smallest, file->largest) < 0) {
-      overlapping_bytes += (*next_level_it)->fd.file_size;
+      if (!skip_covered_files ||
+          !file->StandAloneRangeTombstoneCovers(**next_level_it, ucmp)) {
+        overlapping_bytes += (*next_level_it)->fd.file_size;
+      }
 
       if (icmp.Compare((*next_level_it)->largest, file->largest) > 0) {
         // next level file cross large boundary of current file.
@@ -4318,6 +4432,9 @@ void VersionStorageInfo::UpdateOldestSnapshot(SequenceNumber seqnum,
   if (oldest_snapshot_seqnum_ > bottommost_files_mark_threshold_) {
     ComputeBottommostFilesMarkedForCompaction(allow_ingest_behind);
   }
+  if (oldest_snapshot_seqnum_ >= files_covered_by_range_tombstones_threshold_) {
+    ComputeFilesCoveredByRangeTombstones();
+  }
 }
 
 void VersionStorageInfo::ComputeBottommostFilesMarkedForCompaction(
@@ -4977,6 +5094,122 @@ uint64_t VersionStorageInfo::EstimateLiveDataSize() const {
   return size;
 }
 
+void VersionStorageInfo::ComputeFilterBitsAllocation(
+    double budget_bits_per_key, FilterBitsAllocation* allocation) const {
+  assert(allocation);
+  allocation->num_entries.assign(num_levels_, 0);
+  allocation->num_misses.assign(num_levels_, 0);
+  allocation->num_false_positives.assign(num_levels_, 0);
+  allocation->bits_per_key.clear();
+  allocation->expected_false_positives.clear();
+
+  uint64_t total_entries = 0;
+  uint64_t total_misses = 0;
+  for (int level = 0; level < num_levels_; ++level) {
+    for (const FileMetaData* file : files_[level]) {
+      const uint64_t entries =
+          file->num_entries > file->num_range_deletions
+              ? file->num_entries - file->num_range_deletions
+              : 0;
+      const uint64_t misses =
+          file->stats.num_misses_sampled.load(std::memory_order_relaxed);
+      allocation->num_entries[level] += entries;
+      allocation->num_misses[level] += misses;
+      allocation->num_false_positives[level] +=
+          file->stats.num_false_positives_sampled.load(
+              std::memory_order_relaxed);
+      total_entries += entries;
+      total_misses += misses;
+    }
+  }
+  if (!(budget_bits_per_key > 0) || total_entries == 0 || total_misses == 0) {
+    return;
+  }
+
+  // Bounds of what the built-in filter policies support
+  constexpr double kMinBitsPerKey = 1.0;
+  constexpr double kMaxBitsPerKey = 100.0;
+  // ln(2)^2
+  constexpr double kBitsToLogFpRate = 0.4804530139182014;
+  const double budget =
+      std::min(std::max(budget_bits_per_key, kMinBitsPerKey), kMaxBitsPerKey);
+
+  // Minimizing sum(misses_l * exp(-c * bits_l)) subject to
+  // sum(entries_l * bits_l) == budget * total_entries gives
+  // bits_l = (ln(misses_l / entries_l) - t) / c for some t, within bounds.
+  // The bits used fall as t grows, so find t by bisection.
+  std::vector<double> log_density(num_levels_, 0);
+  double lo = 0;
+  double hi = 0;
+  bool first = true;
+  for (int level = 0; level < num_levels_; ++level) {
+    if (allocation->num_entries[level] == 0 ||
+        allocation->num_misses[level] == 0) {
+      continue;
+    }
+    log_density[level] =
+        std::log(static_cast<double>(allocation->num_misses[level]) /
+                 static_cast<double>(allocation->num_entries[level]));
+    if (first || log_density[level] < lo) {
+      lo = log_density[level];
+    }
+    if (first || log_density[level] > hi) {
+      hi = log_density[level];
+    }
+    first = false;
+  }
+  lo -= kBitsToLogFpRate * kMaxBitsPerKey;
+  hi -= kBitsToLogFpRate * kMinBitsPerKey;
+  auto bits_for = [&](int level, double t) {
+    if (allocation->num_misses[level] == 0) {
+      return kMinBitsPerKey;
+    }
+    return std::min(
+        std::max((log_density[level] - t) / kBitsToLogFpRate, kMinBitsPerKey),
+        kMaxBitsPerKey);
+  };
+  const double target = budget * static_cast<double>(total_entries);
+  for (int i = 0; i < 64; ++i) {
+    const double mid = (lo + hi) / 2;
+    double used = 0;
+    for (int level = 0; level < num_levels_; ++level) {
+      used += static_cast<double>(allocation->num_entries[level]) *
+              bits_for(level, mid);
+    }
+    if (used > target) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  allocation->bits_per_key.resize(num_levels_);
+  allocation->expected_false_positives.resize(num_levels_);
+  for (int level = 0; level < num_levels_; ++level) {
+    // Levels with no entries yet get the average
+    const double bits = allocation->num_entries[level] == 0
+                            ? budget
+                            : bits_for(level, hi);
+    allocation->bits_per_key[level] = bits;
+    allocation->expected_false_positives[level] =
+        static_cast<double>(allocation->num_misses[level]) *
+        std::exp(-kBitsToLogFpRate * bits);
+  }
+}
+
+double VersionStorageInfo::GetAdaptiveFilterBitsPerKey(
+    double budget_bits_per_key, int level) const {
+  if (!(budget_bits_per_key > 0) || level < 0 || level >= num_levels_) {
+    return 0;
+  }
+  FilterBitsAllocation allocation;
+  ComputeFilterBitsAllocation(budget_bits_per_key, &allocation);
+  if (allocation.bits_per_key.empty()) {
+    return 0;
+  }
+  return allocation.bits_per_key[level];
+}
+
 bool VersionStorageInfo::RangeMightExistAfterSortedRun(
     const Slice& smallest_user_key, const Slice& largest_user_key,
     int last_level, int last_l0_idx) {
@@ -5061,7 +5294,7 @@ void Version::AddLiveFiles(std::vector<uint64_t>* live_table_files,
   for (const auto& meta : blob_files) {
     assert(meta);
 
-    live_blob_files->emplace_back(meta->GetBlobFileNumber());
+    live_blob_files->emplace_back(meta->GetPhysicalBlobFileNumber());
   }
 }
 
@@ -5080,7 +5313,11 @@ void Version::RemoveLiveFiles(
       std::remove_if(
           blob_delete_candidates.begin(), blob_delete_candidates.end(),
           [this](ObsoleteBlobFileInfo& x) {
-            return storage_info()->GetBlobFileMetaData(x.GetBlobFileNumber());
+            const auto meta =
+                storage_info()->GetBlobFileMetaData(x.GetBlobFileNumber());
+            // A relocated blob file no longer uses its original file.
+            return meta && meta->GetPhysicalBlobFileNumber() ==
+                               x.GetBlobFileNumber();
           }),
       blob_delete_candidates.end());
 }
@@ -6624,16 +6861,16 @@ Status VersionSet::GetLiveFilesChecksumInfo(FileChecksumList* checksum_list) {
     for (const auto& meta : blob_files) {
       assert(meta);
 
-      std::string checksum_value = meta->GetChecksumValue();
-      std::string checksum_method = meta->GetChecksumMethod();
+      std::string checksum_value = meta->GetPhysicalChecksumValue();
+      std::string checksum_method = meta->GetPhysicalChecksumMethod();
       assert(checksum_value.empty() == checksum_method.empty());
-      if (meta->GetChecksumMethod().empty()) {
+      if (checksum_method.empty()) {
         checksum_value = kUnknownFileChecksum;
         checksum_method = kUnknownFileChecksumFuncName;
       }
 
-      s = checksum_list->InsertOneFileChecksum(meta->GetBlobFileNumber(),
-                                               checksum_value, checksum_method);
+      s = checksum_list->InsertOneFileChecksum(
+          meta->GetPhysicalBlobFileNumber(), checksum_value, checksum_method);
       if (!s.ok()) {
         return s;
       }
@@ -6847,6 +7084,9 @@ Status VersionSet::WriteCurrentStateToManifest(
           edit.AddBlobFileGarbage(blob_file_number, meta->GetGarbageBlobCount(),
                                   meta->GetGarbageBlobBytes());
         }
+        if (meta->GetRelocation()) {
+          edit.AddBlobFileRelocation(*meta->GetRelocation());
+        }
       }
 
       const auto iter = curr_state.find(cfd->GetID());
@@ -7487,7 +7727,7 @@ uint64_t VersionSet::GetTotalBlobFileSize(Version* dummy_versions) {
     for (const auto& meta : blob_files) {
       assert(meta);
 
-      const uint64_t blob_file_number = meta->GetBlobFileNumber();
+      const uint64_t blob_file_number = meta->GetPhysicalBlobFileNumber();
 
       if (unique_blob_files.find(blob_file_number) == unique_blob_files.end()) {
         // find Blob file that has not been counted
@@ -19,6 +19,7 @@
 // synchronization on all accesses.
 
 #pragma once
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <limits>
@@ -242,10 +243,21 @@ class VersionStorageInfo {
       double blob_garbage_collection_force_threshold,
       bool enable_blob_garbage_collection);
 
+  // This computes files_covered_by_range_tombstones_ and is called by
+  // ComputeCompactionScore() or UpdateOldestSnapshot().
+  //
+  // Lists the files that a range tombstone covers, unless the seqnum of the
+  // oldest existing snapshot is older than the range tombstone, so that the
+  // snapshot can still see the file. Must be called every time the oldest
+  // snapshot reaches files_covered_by_range_tombstones_threshold_.
+  //
+  // REQUIRES: DB mutex held
+  void ComputeFilesCoveredByRangeTombstones();
+
   bool level0_non_overlapping() const { return level0_non_overlapping_; }
 
   // Updates the oldest snapshot and related internal state, like the bottommost
-  // files marked for compaction.
+  // files marked for compaction and the files covered by range tombstones.
   // REQUIRES: DB mutex held
   void UpdateOldestSnapshot(SequenceNumber oldest_snapshot_seqnum,
                             bool allow_ingest_behind);
@@ -441,7 +453,7 @@ class VersionStorageInfo {
       assert(meta);
 
       total_file_size += meta->GetBlobFileSize();
-      total_garbage_size += meta->GetGarbageBlobBytes();
+      total_garbage_size += meta->GetStoredGarbageBlobBytes();
     }
 
     double space_amp = 0.0;
@@ -520,6 +532,26 @@ class VersionStorageInfo {
     return files_marked_for_forced_blob_gc_;
   }
 
+  // A file that every entry of is deleted by the range tombstone of a
+  // standalone range tombstone file in a higher level. Once no snapshot is
+  // older than the range tombstone, the file can be dropped without reading
+  // or rewriting it.
+  struct FileCoveredByRangeTombstone {
+    int level;
+    FileMetaData* file;
+    // The smallest sequence number of the range tombstones covering the file
+    SequenceNumber tombstone_seqno;
+  };
+
+  // Sorted by level.
+  // REQUIRES: ComputeCompactionScore has been called
+  // REQUIRES: DB mutex held during access
+  const std::vector<FileCoveredByRangeTombstone>&
+  FilesCoveredByRangeTombstones() const {
+    assert(finalized_);
+    return files_covered_by_range_tombstones_;
+  }
+
   int base_level() const { return base_level_; }
   double level_multiplier() const { return level_multiplier_; }
 
@@ -600,6 +632,37 @@ class VersionStorageInfo {
   // Returns an estimate of the amount of live data in bytes.
   uint64_t EstimateLiveDataSize() const;
 
+  // Per-level inputs and result of splitting a filter memory budget between
+  // levels to minimize the expected number of lookups for absent keys that
+  // filters fail to stop (Monkey style), from the sampled read statistics of
+  // the files.
+  struct FilterBitsAllocation {
+    // Point entries in the files of each level
+    std::vector<uint64_t> num_entries;
+    // Sampled lookups per level that found no entry in the file probed
+    std::vector<uint64_t> num_misses;
+    // Of those, the lookups that a filter did not stop
+    std::vector<uint64_t> num_false_positives;
+    // Filter bits per key allocated to each level. Empty without a budget or
+    // without sampled misses to allocate it by.
+    std::vector<double> bits_per_key;
+    // Expected number of num_misses per level that filters with the
+    // allocated bits per key would not stop. Empty like bits_per_key.
+    std::vector<double> expected_false_positives;
+  };
+
+  // Splits budget_bits_per_key (an average over all point entries) between
+  // the levels. A Bloom filter with b bits per key has a false positive rate
+  // of about exp(-b * ln(2)^2), so the optimum gives each level bits per key
+  // growing with the log of its misses per entry.
+  void ComputeFilterBitsAllocation(double budget_bits_per_key,
+                                   FilterBitsAllocation* allocation) const;
+
+  // Filter bits per key allocated to a new file at `level`, or 0 to use the
+  // filter policy's own setting
+  double GetAdaptiveFilterBitsPerKey(double budget_bits_per_key,
+                                     int level) const;
+
   uint64_t estimated_compaction_needed_bytes() const {
     return estimated_compaction_needed_bytes_;
   }
@@ -617,7 +680,12 @@ class VersionStorageInfo {
   }
 
   SequenceNumber standalone_range_tombstone_files_mark_threshold() const {
-    return standalone_range_tombstone_files_mark_threshold_;
+    return std::min(standalone_range_tombstone_files_mark_threshold_,
+                    files_covered_by_range_tombstones_threshold_);
+  }
+
+  SequenceNumber files_covered_by_range_tombstones_threshold() const {
+    return files_covered_by_range_tombstones_threshold_;
   }
 
   // Returns whether any key in [`smallest_key`, `largest_key`] could appear in
@@ -728,6 +796,12 @@ class VersionStorageInfo {
 
   autovector<std::pair<int, FileMetaData*>> files_marked_for_forced_blob_gc_;
 
+  // Files not being compacted that standalone range tombstone files in higher
+  // levels cover, and that no snapshot still sees. Only computed for leveled
+  // compaction without user-defined timestamps. Protected by DB mutex and
+  // calculated in ComputeCompactionScore() and UpdateOldestSnapshot().
+  std::vector<FileCoveredByRangeTombstone> files_covered_by_range_tombstones_;
+
   // Threshold for needing to mark another bottommost file. Maintain it so we
   // can quickly check when releasing a snapshot whether more bottommost files
   // became eligible for compaction. It's defined as the min of the max nonzero
@@ -740,6 +814,12 @@ class VersionStorageInfo {
   SequenceNumber standalone_range_tombstone_files_mark_threshold_ =
       kMaxSequenceNumber;
 
+  // Threshold for listing more files covered by range tombstones. It's the
+  // min of the seqnums of the standalone range tombstone files covering
+  // files that the oldest snapshot still sees.
+  SequenceNumber files_covered_by_range_tombstones_threshold_ =
+      kMaxSequenceNumber;
+
   // Monotonically increases as we release old snapshots. Zero indicates no
   // snapshots have been released yet. When no snapshots remain we set it to the
   // current seqnum, which needs to be protected as a snapshot can still be
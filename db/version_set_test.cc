@@ -10,6 +10,7 @@
 #include "db/version_set.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "db/blob/blob_log_writer.h"
 #include "db/db_impl/db_impl.h"
@@ -523,6 +524,56 @@ TEST_F(VersionStorageInfoTest, EstimateLiveDataSize2) {
   ASSERT_EQ(4U, vstorage_.EstimateLiveDataSize());
 }
 
+TEST_F(VersionStorageInfoTest, FilterBitsAllocation) {
+  Add(1, 1U, "1", "4", 1U);
+  Add(2, 2U, "1", "4", 1U);
+  Add(2, 3U, "5", "9", 1U);
+
+  UpdateVersionStorageInfo();
+
+  vstorage_.LevelFiles(1)[0]->num_entries = 1000;
+  vstorage_.LevelFiles(2)[0]->num_entries = 5000;
+  vstorage_.LevelFiles(2)[1]->num_entries = 4000;
+
+  VersionStorageInfo::FilterBitsAllocation allocation;
+  // No sampled misses to allocate by
+  vstorage_.ComputeFilterBitsAllocation(10.0, &allocation);
+  ASSERT_EQ(1000U, allocation.num_entries[1]);
+  ASSERT_EQ(9000U, allocation.num_entries[2]);
+  ASSERT_TRUE(allocation.bits_per_key.empty());
+  ASSERT_EQ(0, vstorage_.GetAdaptiveFilterBitsPerKey(10.0, 1));
+
+  vstorage_.LevelFiles(1)[0]->stats.num_misses_sampled = 100;
+  vstorage_.LevelFiles(2)[0]->stats.num_misses_sampled = 40;
+  vstorage_.LevelFiles(2)[1]->stats.num_misses_sampled = 50;
+  vstorage_.LevelFiles(2)[1]->stats.num_false_positives_sampled = 1;
+
+  // No budget
+  vstorage_.ComputeFilterBitsAllocation(0.0, &allocation);
+  ASSERT_EQ(90U, allocation.num_misses[2]);
+  ASSERT_EQ(1U, allocation.num_false_positives[2]);
+  ASSERT_TRUE(allocation.bits_per_key.empty());
+
+  vstorage_.ComputeFilterBitsAllocation(10.0, &allocation);
+  ASSERT_EQ(static_cast<size_t>(vstorage_.num_levels()),
+            allocation.bits_per_key.size());
+  // Level 1 sees more misses per entry, so gets more bits per key
+  ASSERT_GT(allocation.bits_per_key[1], allocation.bits_per_key[2]);
+  ASSERT_GE(allocation.bits_per_key[2], 1.0);
+  // The budget is spent over all entries
+  const double avg =
+      (1000 * allocation.bits_per_key[1] + 9000 * allocation.bits_per_key[2]) /
+      10000;
+  ASSERT_NEAR(10.0, avg, 0.01);
+  // Versus a uniform 10 bits per key
+  const double uniform_fp = 190 * std::exp(-10 * std::log(2) * std::log(2));
+  ASSERT_LT(allocation.expected_false_positives[1] +
+                allocation.expected_false_positives[2],
+            uniform_fp);
+  ASSERT_EQ(allocation.bits_per_key[1],
+            vstorage_.GetAdaptiveFilterBitsPerKey(10.0, 1));
+}
+
 TEST_F(VersionStorageInfoTest, SingleLevelBottommostData) {
   // In case of a single level, the oldest L0 file is bottommost. This could be
   // improved in case the L0 files cover disjoint key-ranges.
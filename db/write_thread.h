@@ -134,6 +134,12 @@ class WriteThread {
     PostMemTableCallback* post_memtable_callback;
     uint64_t wal_used;  // log number that this batch was inserted into
     uint64_t log_ref;   // log number that memtable insert should reference
+    // With enable_pipelined_wal_sync, the WAL sync this write must wait for
+    // before being acknowledged (see DBImpl::WaitForWalGroupSync()), or 0
+    uint64_t wal_sync_ticket;
+    // With core_local_write_staging, the number of staged writes merged into
+    // this batch, each of which does its own memtable insert. Otherwise 1.
+    size_t staged_write_cnt;
     WriteCallback* callback;
     UserWriteCallback* user_write_cb;
     bool made_waitable;          // records lazy construction of mutex and cv
@@ -163,6 +169,8 @@ class WriteThread {
           post_memtable_callback(nullptr),
           wal_used(0),
           log_ref(0),
+          wal_sync_ticket(0),
+          staged_write_cnt(1),
           callback(nullptr),
           user_write_cb(nullptr),
           made_waitable(false),
@@ -192,6 +200,8 @@ class WriteThread {
           post_memtable_callback(_post_memtable_callback),
           wal_used(0),
           log_ref(_log_ref),
+          wal_sync_ticket(0),
+          staged_write_cnt(1),
           callback(_callback),
           user_write_cb(_user_write_cb),
           made_waitable(false),
@@ -97,6 +97,7 @@ DECLARE_int32(ttl);
 DECLARE_int32(value_size_mult);
 DECLARE_int32(compaction_readahead_size);
 DECLARE_bool(enable_pipelined_write);
+DECLARE_bool(enable_pipelined_wal_sync);
 DECLARE_bool(verify_before_write);
 DECLARE_bool(histogram);
 DECLARE_bool(destroy_db_initially);
@@ -427,6 +428,8 @@ DECLARE_int32(remote_compaction_worker_interval);
 DECLARE_bool(auto_refresh_iterator_with_snapshot);
 DECLARE_uint32(memtable_op_scan_flush_trigger);
 DECLARE_uint32(memtable_avg_op_scan_flush_trigger);
+DECLARE_uint32(compaction_iterator_batch_size);
+DECLARE_double(filter_memory_budget_bits_per_key);
 DECLARE_uint32(ingest_wbwi_one_in);
 DECLARE_bool(universal_reduce_file_locking);
 DECLARE_bool(use_multiscan);
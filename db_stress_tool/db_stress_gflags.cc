@@ -128,6 +128,9 @@ DEFINE_int32(compaction_readahead_size, 0, "Compaction readahead size");
 
 DEFINE_bool(enable_pipelined_write, false, "Pipeline WAL/memtable writes");
 
+DEFINE_bool(enable_pipelined_wal_sync, false,
+            "Sync the WAL in the memtable write stage with pipelined writes");
+
 DEFINE_bool(verify_before_write, false, "Verify before write");
 
 DEFINE_bool(histogram, false, "Print histogram of operation timings");
@@ -1517,6 +1520,16 @@ DEFINE_uint32(
     ROCKSDB_NAMESPACE::ColumnFamilyOptions().memtable_avg_op_scan_flush_trigger,
     "Sets CF option memtable_avg_op_scan_flush_trigger.");
 
+DEFINE_uint32(
+    compaction_iterator_batch_size,
+    ROCKSDB_NAMESPACE::ColumnFamilyOptions().compaction_iterator_batch_size,
+    "Sets CF option compaction_iterator_batch_size.");
+
+DEFINE_double(
+    filter_memory_budget_bits_per_key,
+    ROCKSDB_NAMESPACE::ColumnFamilyOptions().filter_memory_budget_bits_per_key,
+    "Sets CF option filter_memory_budget_bits_per_key.");
+
 DEFINE_bool(
     universal_reduce_file_locking,
     ROCKSDB_NAMESPACE::ColumnFamilyOptions()
@@ -4403,6 +4403,7 @@ void InitializeOptionsFromFlags(
       static_cast<unsigned int>(FLAGS_stats_dump_period_sec);
   options.ttl = FLAGS_compaction_ttl;
   options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+  options.enable_pipelined_wal_sync = FLAGS_enable_pipelined_wal_sync;
   options.enable_write_thread_adaptive_yield =
       FLAGS_enable_write_thread_adaptive_yield;
   options.compaction_options_universal.size_ratio = FLAGS_universal_size_ratio;
@@ -4588,6 +4589,9 @@ void InitializeOptionsFromFlags(
   options.uncache_aggressiveness = FLAGS_uncache_aggressiveness;
 
   options.memtable_op_scan_flush_trigger = FLAGS_memtable_op_scan_flush_trigger;
+  options.compaction_iterator_batch_size = FLAGS_compaction_iterator_batch_size;
+  options.filter_memory_budget_bits_per_key =
+      FLAGS_filter_memory_budget_bits_per_key;
   options.compaction_options_universal.reduce_file_locking =
       FLAGS_universal_reduce_file_locking;
 }
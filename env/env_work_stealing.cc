@@ -0,0 +1,79 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/env.h"
+#include "util/work_stealing_scheduler.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// An Env that runs the jobs scheduled through it with a
+// WorkStealingScheduler instead of the thread pools of the base Env.
+class WorkStealingEnv : public EnvWrapper {
+ public:
+  WorkStealingEnv(Env* base_env, const WorkStealingSchedulerOptions& options)
+      : EnvWrapper(base_env),
+        scheduler_(this, base_env->GetSystemClock(), options) {}
+
+  static const char* kClassName() { return "WorkStealingEnv"; }
+  const char* Name() const override { return kClassName(); }
+
+  void Schedule(void (*function)(void* arg), void* arg, Priority pri,
+                void* tag, void (*unschedFunction)(void* arg)) override {
+    scheduler_.Schedule(function, arg, pri, tag, unschedFunction);
+  }
+
+  int UnSchedule(void* tag, Priority pri) override {
+    return scheduler_.UnSchedule(tag, pri);
+  }
+
+  unsigned int GetThreadPoolQueueLen(Priority pri) const override {
+    return scheduler_.GetQueueLen(pri);
+  }
+
+  int ReserveThreads(int threads_to_be_reserved, Priority pri) override {
+    return scheduler_.ReserveThreads(threads_to_be_reserved, pri);
+  }
+
+  int ReleaseThreads(int threads_to_be_released, Priority pri) override {
+    return scheduler_.ReleaseThreads(threads_to_be_released, pri);
+  }
+
+  void SetBackgroundThreads(int num, Priority pri) override {
+    scheduler_.SetBackgroundThreads(num, pri);
+  }
+
+  int GetBackgroundThreads(Priority pri) override {
+    return scheduler_.GetBackgroundThreads(pri);
+  }
+
+  void IncBackgroundThreadsIfNeeded(int num, Priority pri) override {
+    scheduler_.IncBackgroundThreadsIfNeeded(num, pri);
+  }
+
+  void LowerThreadPoolIOPriority(Priority pool) override {
+    scheduler_.LowerIOPriority(pool);
+  }
+
+  void LowerThreadPoolCPUPriority(Priority pool) override {
+    scheduler_.LowerCPUPriority(pool, CpuPriority::kLow);
+  }
+
+  Status LowerThreadPoolCPUPriority(Priority pool, CpuPriority pri) override {
+    scheduler_.LowerCPUPriority(pool, pri);
+    return Status::OK();
+  }
+
+ private:
+  WorkStealingScheduler scheduler_;
+};
+}  // namespace
+
+Env* NewWorkStealingEnv(Env* base_env,
+                        const WorkStealingSchedulerOptions& options) {
+  return new WorkStealingEnv(base_env, options);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -126,8 +126,10 @@ Status FilePrefetchBuffer::Read(BufferInfo* buf, const IOOptions& opts,
 
   if (usage_ == FilePrefetchBufferUsage::kUserScanPrefetch) {
     RecordTick(stats_, PREFETCH_BYTES, read_len);
+    PERF_COUNTER_ADD(prefetch_bytes, read_len);
   } else if (usage_ == FilePrefetchBufferUsage::kCompactionPrefetch) {
     RecordInHistogram(stats_, COMPACTION_PREFETCH_BYTES, read_len);
+    PERF_COUNTER_ADD(prefetch_bytes, read_len);
   }
   if (!use_fs_buffer) {
     // Update the buffer size.
@@ -158,6 +160,7 @@ Status FilePrefetchBuffer::ReadAsync(BufferInfo* buf, const IOOptions& opts,
   if (s.ok()) {
     if (usage_ == FilePrefetchBufferUsage::kUserScanPrefetch) {
       RecordTick(stats_, PREFETCH_BYTES, read_len);
+      PERF_COUNTER_ADD(prefetch_bytes, read_len);
     }
     buf->async_read_in_progress_ = true;
   }
@@ -18,6 +18,7 @@
 #include "file/random_access_file_reader.h"
 #include "file/readahead_file_info.h"
 #include "file_util.h"
+#include "monitoring/perf_context_imp.h"
 #include "monitoring/statistics_impl.h"
 #include "port/port.h"
 #include "rocksdb/env.h"
@@ -274,6 +275,10 @@ class FilePrefetchBuffer {
     }
 
     RecordInHistogram(stats_, PREFETCHED_BYTES_DISCARDED, bytes_discarded);
+    if (usage_ == FilePrefetchBufferUsage::kUserScanPrefetch ||
+        usage_ == FilePrefetchBufferUsage::kCompactionPrefetch) {
+      PERF_COUNTER_ADD(prefetch_bytes_wasted, bytes_discarded);
+    }
 
     for (auto& buf : bufs_) {
       delete buf;
@@ -1227,6 +1227,140 @@ TEST_P(PrefetchTest, PrefetchWhenReseek) {
   Close();
 }
 
+// This test verifies that ReadOptions::pattern_aware_readahead reads ahead of
+// reverse and strided scans, and not past iterate_upper_bound.
+TEST_P(PrefetchTest, PatternAwareReadahead) {
+  // First param is if the mockFS support_prefetch or not
+  bool support_prefetch =
+      std::get<0>(GetParam()) &&
+      test::IsPrefetchSupported(env_->GetFileSystem(), dbname_);
+  std::shared_ptr<MockFS> fs =
+      std::make_shared<MockFS>(env_->GetFileSystem(), support_prefetch);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  // Second param is if directIO is enabled or not
+  bool use_direct_io = std::get<1>(GetParam());
+
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  int buff_prefetch_count = 0;
+  SyncPoint::GetInstance()->SetCallBack("FilePrefetchBuffer::Prefetch:Start",
+                                        [&](void*) { buff_prefetch_count++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  // About 4 keys per data block
+  const int kNumKeys = 2000;
+  WriteBatch batch;
+  Random rnd(309);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(batch.Put(BuildKey(i), rnd.RandomString(1000)));
+  }
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  std::vector<std::string> keys;
+  {
+    auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      keys.push_back(iter->key().ToString());
+    }
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumKeys), keys.size());
+  const bool fs_prefetch = support_prefetch && !use_direct_io;
+
+  // Reverse scan
+  for (bool pattern_aware : {false, true}) {
+    SCOPED_TRACE("pattern_aware = " + std::to_string(pattern_aware));
+    fs->ClearPrefetchCount();
+    buff_prefetch_count = 0;
+    get_perf_context()->Reset();
+    ReadOptions ro;
+    ro.pattern_aware_readahead = pattern_aware;
+    {
+      auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ro));
+      int count = 0;
+      for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+        ++count;
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(kNumKeys, count);
+    }
+    // The prefetch buffer only reads forward
+    ASSERT_EQ(0, buff_prefetch_count);
+    if (pattern_aware && fs_prefetch) {
+      ASSERT_GT(fs->GetPrefetchCount(), 0);
+      ASSERT_GT(get_perf_context()->prefetch_bytes, 0);
+    } else {
+      ASSERT_EQ(0, fs->GetPrefetchCount());
+    }
+  }
+
+  // Strided scan, reading every 6th key and so skipping about every other
+  // block
+  for (bool pattern_aware : {false, true}) {
+    SCOPED_TRACE("pattern_aware = " + std::to_string(pattern_aware));
+    fs->ClearPrefetchCount();
+    buff_prefetch_count = 0;
+    ReadOptions ro;
+    ro.pattern_aware_readahead = pattern_aware;
+    {
+      auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ro));
+      for (size_t i = 0; i < keys.size(); i += 6) {
+        iter->Seek(keys[i]);
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(keys[i], iter->key().ToString());
+      }
+    }
+    if (pattern_aware) {
+      ASSERT_GT(fs_prefetch ? fs->GetPrefetchCount() : buff_prefetch_count,
+                0);
+    }
+  }
+
+  // Forward scans up to an upper bound inside of a block never read ahead of
+  // it with pattern_aware_readahead, so waste less.
+  if (fs_prefetch) {
+    uint64_t wasted[2] = {0, 0};
+    for (bool pattern_aware : {false, true}) {
+      for (size_t end = 8; end < 48; ++end) {
+        get_perf_context()->Reset();
+        ReadOptions ro;
+        ro.pattern_aware_readahead = pattern_aware;
+        Slice upper_bound(keys[end]);
+        ro.iterate_upper_bound = &upper_bound;
+        {
+          auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ro));
+          size_t count = 0;
+          for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            ++count;
+          }
+          ASSERT_OK(iter->status());
+          ASSERT_EQ(end, count);
+        }
+        wasted[pattern_aware] += get_perf_context()->prefetch_bytes_wasted;
+      }
+    }
+    ASSERT_GT(wasted[0], 0);
+    ASSERT_LT(wasted[1], wasted[0]);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  Close();
+}
+
 // This test verifies the functionality of implicit autoreadahead when caching
 // is enabled:
 // - If data is already in buffer and few blocks are not requested to read,
@@ -2158,29 +2292,30 @@ TEST_P(PrefetchTest1, SeekWithExtraPrefetchAsyncIO) {
           0));  // Prefetch data on seek because of seek parallelization.
       ASSERT_TRUE(iter->Valid());
 
-      // Do extra prefetching in Seek only if
+      // The index partition and the data block are both read asynchronously,
+      // so both are prefetched. Do extra prefetching for each in Seek only if
       // num_file_reads_for_auto_readahead = 0.
-      ASSERT_EQ(extra_prefetch_buff_cnt, (i == 0 ? 1 : 0));
-      // buff_prefetch_count is 2 because of index block when
-      // num_file_reads_for_auto_readahead = 0.
-      // If num_file_reads_for_auto_readahead > 0, index block isn't
-      // prefetched.
-      ASSERT_EQ(buff_prefetch_count, i == 0 ? 2 : 1);
+      ASSERT_EQ(extra_prefetch_buff_cnt, (i == 0 ? 2 : 0));
+      ASSERT_EQ(buff_prefetch_count, 2);
 
       extra_prefetch_buff_cnt = 0;
       buff_prefetch_count = 0;
-      // Reset all values of FilePrefetchBuffer on new seek.
+      // Reset all values of FilePrefetchBuffer on new seek. The key is in
+      // another index partition.
       iter->Seek(
           BuildKey(22));  // Prefetch data because of seek parallelization.
       ASSERT_TRUE(iter->Valid());
       // Do extra prefetching in Seek only if
       // num_file_reads_for_auto_readahead = 0.
-      ASSERT_EQ(extra_prefetch_buff_cnt, (i == 0 ? 1 : 0));
-      ASSERT_EQ(buff_prefetch_count, 1);
+      ASSERT_EQ(extra_prefetch_buff_cnt, (i == 0 ? 2 : 0));
+      // With direct IO and num_file_reads_for_auto_readahead = 0, the
+      // readahead of the previous Seek already covers the index partition.
+      ASSERT_EQ(buff_prefetch_count, (GetParam() && i == 0) ? 1 : 2);
 
       extra_prefetch_buff_cnt = 0;
       buff_prefetch_count = 0;
-      // Reset all values of FilePrefetchBuffer on new seek.
+      // Reset all values of FilePrefetchBuffer on new seek. The key is in
+      // the same index partition.
       iter->Seek(
           BuildKey(33));  // Prefetch data because of seek parallelization.
       ASSERT_TRUE(iter->Valid());
@@ -2918,6 +3053,100 @@ TEST_P(PrefetchTest, SeekParallelizationTestWithPosix) {
   Close();
 }
 
+// This test verifies that with PosixFileSystem, a Seek across several levels
+// with partitioned index reads index partitions asynchronously too, and that
+// the results match a synchronous Seek.
+TEST_P(PrefetchTest, SeekAsyncIndexPartitionsWithPosix) {
+  if (mem_env_ || encrypted_env_) {
+    ROCKSDB_GTEST_SKIP("Test requires non-mem or non-encrypted environment");
+    return;
+  }
+  const int kNumKeys = 900;
+  const int kNumLevels = 3;
+  std::shared_ptr<MockFS> fs = std::make_shared<MockFS>(
+      FileSystem::Default(), /*support_prefetch=*/false);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  bool use_direct_io = std::get<0>(GetParam());
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  // One file per level, each covering the whole key range.
+  Random rnd(309);
+  for (int level = kNumLevels - 1; level >= 0; level--) {
+    WriteBatch batch;
+    for (int i = level; i < kNumKeys; i += kNumLevels) {
+      ASSERT_OK(batch.Put(BuildKey(i), rnd.RandomString(1000)));
+    }
+    ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    ASSERT_OK(Flush());
+    if (level > 0) {
+      MoveFilesToLevel(level);
+    }
+  }
+
+  bool read_async_called = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "UpdateResults::io_uring_result",
+      [&](void* /*arg*/) { read_async_called = true; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ReadOptions ro;
+  ro.async_io = true;
+  if (std::get<1>(GetParam())) {
+    ro.readahead_size = 16 * 1024;
+  }
+  auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ro));
+  auto cmp_iter = std::unique_ptr<Iterator>(db_->NewIterator(ReadOptions()));
+  for (int i = 0; i < 20; i++) {
+    std::string target = BuildKey(rnd.Uniform(kNumKeys + 10));
+    get_perf_context()->Reset();
+    iter->Seek(target);
+    cmp_iter->Seek(target);
+    uint64_t num_async_seek = get_perf_context()->number_async_seek;
+    for (int j = 0; j < 5 && cmp_iter->Valid(); j++) {
+      ASSERT_OK(iter->status());
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), cmp_iter->key());
+      ASSERT_EQ(iter->value(), cmp_iter->value());
+      iter->Next();
+      cmp_iter->Next();
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_OK(cmp_iter->status());
+    if (!cmp_iter->Valid()) {
+      ASSERT_FALSE(iter->Valid());
+    }
+    if (i == 0) {
+      if (read_async_called) {
+        // Each level first retrieves an index partition, then a data block.
+        ASSERT_GT(num_async_seek, static_cast<uint64_t>(kNumLevels));
+      } else {
+        // Not all platforms support iouring. In that case, ReadAsync in posix
+        // won't submit async requests.
+        ASSERT_EQ(num_async_seek, 0);
+      }
+    }
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  iter.reset();
+  cmp_iter.reset();
+  Close();
+}
+
 #ifdef GFLAGS
 // This test verifies io_tracing with PosixFileSystem during prefetching.
 TEST_P(PrefetchTest, TraceReadAsyncWithCallbackWrapper) {
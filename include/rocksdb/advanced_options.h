@@ -1142,6 +1142,34 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API.
   uint32_t memtable_avg_op_scan_flush_trigger = 0;
 
+  // EXPERIMENTAL
+  // If non-zero, compaction reads its merged input this many entries at a
+  // time into a buffer, and parses keys, detects user key changes and (when
+  // not using a SnapshotChecker) finds the earliest visible snapshot for the
+  // whole batch at once rather than one entry at a time. This trades an extra
+  // copy of keys and values for less per-key overhead; the compaction output
+  // is the same either way.
+  //
+  // Default: 0 (disabled)
+  // Dynamically changeable through the SetOptions() API.
+  uint32_t compaction_iterator_batch_size = 0;
+
+  // EXPERIMENTAL
+  // If positive, the average number of filter bits per key to spend across
+  // the SST files of this column family, split between levels to minimize
+  // the expected I/O of lookups that a filter fails to stop (as in "Monkey:
+  // Optimal Navigable Key-Value Store"). Levels whose files see more lookups
+  // for absent keys, per key stored, get more bits than colder ones, with a
+  // floor of one bit per key. The split is computed from sampled read
+  // statistics when a file is written by flush or compaction, and is used by
+  // the built-in Bloom and Ribbon filter policies in place of their
+  // configured bits_per_key. Until there are samples, the configured
+  // bits_per_key applies. See the "rocksdb.filter-io-stats" DB property.
+  //
+  // Default: 0 (disabled)
+  // Dynamically changeable through the SetOptions() API.
+  double filter_memory_budget_bits_per_key = 0.0;
+
   // If either DBOptions::allow_ingest_behind or this option is set to true,
   // this column family will prepare for ingesting files to the last level
   // (IngestExternalFiles() with ingest_behind=true). Users should set only
@@ -24,6 +24,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Cache;  // defined in advanced_cache.h
 struct ConfigOptions;
+class Env;
 class SecondaryCache;
 
 // These definitions begin source compatibility for a future change in which
@@ -175,6 +176,30 @@ struct ShardedCacheOptions {
   // this option must be kept as default empty.
   std::shared_ptr<SecondaryCache> secondary_cache;
 
+  // EXPERIMENTAL
+  // If true, each cache shard keeps a compact frequency sketch (count-min
+  // sketch of 4-bit counters, using about 1% of the shard's capacity) of
+  // recently looked-up keys, TinyLFU style. When inserting a new entry
+  // would require an eviction, the entry is only admitted if its estimated
+  // access frequency is higher than that of the entry that would be evicted
+  // next. This protects a frequently accessed working set from being flushed
+  // out by one-off accesses such as long scans over cold data.
+  //
+  // A declined Insert() still returns OK. If a handle was requested, it
+  // refers to a standalone entry that is not findable by Lookup(), is still
+  // charged to the cache (without evicting anything), and is freed on its
+  // last Release(). Otherwise the object is freed immediately, as if inserted
+  // and evicted. With strict_capacity_limit, an entry with a handle requested
+  // that does not fit without evicting is inserted as usual. Entries without
+  // an object to own (CacheItemHelper::del_cb == nullptr), such as the
+  // placeholders of memory charged to the cache, are always admitted.
+  //
+  // Like the other options of a block cache given in an options string, this
+  // can only be set there for an LRUCache, as Cache::CreateFromString()
+  // creates LRUCaches only. A HyperClockCache gets it from
+  // HyperClockCacheOptions.
+  bool tiny_lfu_admission = false;
+
   // See hash_seed comments below
   static constexpr int32_t kQuasiRandomHashSeed = -1;
   static constexpr int32_t kHostHashSeed = -2;
@@ -328,6 +353,22 @@ struct CompressedSecondaryCacheOptions : LRUCacheOptions {
   // (Filter blocks are essentially non-compressible but others usually are.)
   CacheEntryRoleSet do_not_compress_roles = {CacheEntryRole::kFilterBlock};
 
+  // EXPERIMENTAL
+  // If > 0, each shard of the cache trains a shared compression dictionary of
+  // up to this many bytes from a sample of the blocks it compresses, so that
+  // small blocks sharing structure compress better. Each entry records the
+  // dictionary it was compressed with. Only used with kZSTD, kLZ4Compression
+  // and kLZ4HCCompression. With kZSTD and compression_opts.zstd_max_train_bytes
+  // > 0, that many sample bytes are used to train the dictionary.
+  uint32_t max_dict_bytes = 0;
+
+  // EXPERIMENTAL
+  // With max_dict_bytes > 0, number of compressed insertions into a shard
+  // between trainings of a new dictionary for it. An older dictionary is kept,
+  // and charged to the cache, until the last entry compressed with it is
+  // evicted.
+  uint32_t dict_retrain_interval = 4096;
+
   CompressedSecondaryCacheOptions() {}
   CompressedSecondaryCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -386,6 +427,47 @@ inline std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
   return opts.MakeSharedSecondaryCache();
 }
 
+// EXPERIMENTAL
+// Options structure for configuring a SecondaryCache instance that keeps
+// blocks in a file on local storage, such as an SSD in front of
+// network-attached storage. Blocks are appended through in-memory write
+// buffers to a circular log in the file and found through an in-memory index,
+// so the oldest blocks are overwritten first and nothing survives a restart.
+// Lookups with wait=false return a pending handle, and WaitAll() reads the
+// pending blocks in a single MultiRead.
+//
+// When a block is evicted from the primary cache without forced admission
+// (see TieredAdmissionPolicy), it is only written on its second eviction
+// within a recent history, to keep one-off blocks from wearing the device.
+struct LocalFileSecondaryCacheOptions {
+  // File (or block device) to hold the cache. It is created if missing, and
+  // any existing contents are overwritten.
+  std::string path;
+
+  // Bytes of the file to use, rounded down to a multiple of
+  // write_buffer_size. Must allow for at least two write buffers.
+  uint64_t capacity = 0;
+
+  // Blocks are written to the file in units of this size, which is also the
+  // granularity of eviction. Rounded up to a multiple of 4KB.
+  size_t write_buffer_size = 1 << 20;
+
+  // Write buffers filled but not yet written to the file, plus the one being
+  // filled. Insertions are dropped while all of them are in use.
+  int max_write_buffer_number = 4;
+
+  // Read and write the file with direct I/O, bypassing the OS page cache
+  bool use_direct_io = false;
+
+  // Env::Default() if nullptr
+  Env* env = nullptr;
+};
+
+// Construct an instance of LocalFileSecondaryCache, or return an error if the
+// file cannot be opened.
+Status NewLocalFileSecondaryCache(const LocalFileSecondaryCacheOptions& opts,
+                                  std::shared_ptr<SecondaryCache>* result);
+
 // HyperClockCache - A lock-free Cache alternative for RocksDB block cache
 // that offers much improved CPU efficiency vs. LRUCache under high parallel
 // load or high contention, with some caveats:
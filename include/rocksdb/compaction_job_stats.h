@@ -107,6 +107,13 @@ struct CompactionJobStats {
   // Time spent on preparing file write (fallocate, etc)
   uint64_t file_prepare_write_nanos = 0;
 
+  // Time spent finishing output table files, by stage: writing out the
+  // remaining data blocks (including waiting for parallel compression),
+  // finishing filter blocks, and finishing index blocks.
+  uint64_t output_data_blocks_finish_nanos = 0;
+  uint64_t output_filter_finish_nanos = 0;
+  uint64_t output_index_finish_nanos = 0;
+
   // 0-terminated strings storing the first 8 bytes of the smallest and
   // largest key in the output.
   static const size_t kMaxPrefixLength = 8;
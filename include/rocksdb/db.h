@@ -985,6 +985,25 @@ class DB {
              statuses, sorted_input);
   }
 
+  // EXPERIMENTAL
+  // Batched lookup in a single column family like MultiGet() with
+  // PinnableSlice values, except that values are returned without copying
+  // wherever possible: "values[i]" references the memory of a block cache
+  // entry or of a memtable directly, which stays pinned until "values[i]" is
+  // Reset() or destroyed. Values that cannot be referenced in place (e.g.
+  // merge results) are copied as usual.
+  //
+  // Pinned block cache entries cannot be evicted and pinned memtables cannot
+  // be freed, so the total size of values returned pinned in place is capped
+  // at "max_pinned_bytes" (in order of "keys"); values beyond that are
+  // copied. Release results promptly, especially when pinning memtables.
+  virtual void MultiGetPinned(const ReadOptions& options,
+                              ColumnFamilyHandle* column_family,
+                              const size_t num_keys, const Slice* keys,
+                              PinnableSlice* values, Status* statuses,
+                              size_t max_pinned_bytes,
+                              const bool sorted_input = false);
+
   // Batched MultiGet-like API that returns wide-column entities from a single
   // column family. For any given "key[i]" in "keys" (where 0 <= "i" <
   // "num_keys"), if the column family specified by "column_family" contains an
@@ -1266,6 +1285,15 @@ class DB {
     //      of files per level and total size of each level (MB).
     static const std::string kLevelStats;
 
+    //  "rocksdb.filter-io-stats" - returns a multi-line string with, per
+    //      level, the number of point entries, the sampled lookups that found
+    //      no entry in the file probed (misses), the misses that a filter did
+    //      not stop (observed false positive I/O) and, when
+    //      filter_memory_budget_bits_per_key is set, the filter bits per key
+    //      allocated to new files and the false positive I/O expected with
+    //      that allocation.
+    static const std::string kFilterIOStats;
+
     //  "rocksdb.block-cache-entry-stats" - returns a multi-line string or
     //      map with statistics on block cache usage. See
     //      `BlockCacheEntryStatsMapKeys` for structured representation of keys
@@ -1727,6 +1755,20 @@ class DB {
                         output_file_names, compaction_job_info);
   }
 
+  // EXPERIMENTAL
+  // CompactBlobFiles() reclaims the space taken up by garbage in the blob
+  // files of the column family without compacting any table files. The live
+  // blobs of each blob file with enough garbage (see CompactBlobFilesOptions)
+  // are copied to a new file, which then replaces the blob file atomically.
+  // The blob references in the table files stay valid: reads map them to the
+  // new locations of the blobs. Like CompactFiles(), the job runs in the
+  // current thread. The bytes the job reads, writes and reclaims are reported
+  // by the BLOB_FILE_GC_* tickers.
+  virtual Status CompactBlobFiles(const CompactBlobFilesOptions& /*options*/,
+                                  ColumnFamilyHandle* /*column_family*/) {
+    return Status::NotSupported("Not implemented");
+  }
+
   // This function will wait until all currently running background processes
   // finish. After it returns, no background process will be run until
   // ContinueBackgroundWork is called, once for each preceding OK-returning
@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 
+#include <array>
 #include <cstdarg>
 #include <functional>
 #include <limits>
@@ -63,6 +64,7 @@ struct DBOptions;
 struct ImmutableDBOptions;
 struct MutableDBOptions;
 class RateLimiter;
+class Statistics;
 class ThreadStatusUpdater;
 struct ThreadStatus;
 class FileSystem;
@@ -1940,6 +1942,39 @@ Env* NewMemEnv(Env* base_env);
 // This is a factory method for TimedEnv defined in utilities/env_timed.cc.
 Env* NewTimedEnv(Env* base_env);
 
+// EXPERIMENTAL
+// Options for NewWorkStealingEnv()
+struct WorkStealingSchedulerOptions {
+  // The relative share of the jobs run by a busy thread that goes to each
+  // Env::Priority class, as long as the class has jobs queued. A weight of 0
+  // counts as 1.
+  //
+  // Default: 1 for BOTTOM, 4 for LOW, 8 for HIGH and 4 for USER
+  std::array<uint32_t, Env::Priority::TOTAL> weights{{1, 4, 8, 4}};
+
+  // If set, the time each job spends queued is recorded in the
+  // SCHEDULER_QUEUE_DELAY_*_MICROS histogram of its class.
+  //
+  // Default: nullptr
+  std::shared_ptr<Statistics> statistics;
+};
+
+// EXPERIMENTAL
+// Returns a new environment that runs the jobs scheduled through it on one
+// set of threads shared by all Env::Priority classes instead of on a thread
+// pool per class. Each thread has its own job queues and steals jobs from
+// the other threads when it runs out, and the classes share the threads
+// according to WorkStealingSchedulerOptions::weights. The number of threads
+// is the sum of the numbers set for the classes with SetBackgroundThreads(),
+// so a class without threads of its own still has its jobs run. All other
+// calls are delegated to base_env. The caller must delete the result when
+// it is no longer needed.
+// *base_env must remain live while the result is in use.
+// This is a factory method for WorkStealingEnv defined in
+// env/env_work_stealing.cc.
+Env* NewWorkStealingEnv(Env* base_env,
+                        const WorkStealingSchedulerOptions& options);
+
 // Returns an instance of logger that can be used for storing informational
 // messages.
 // This is a factory method for EnvLogger declared in logging/env_logging.h
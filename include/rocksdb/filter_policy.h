@@ -79,6 +79,13 @@ struct FilterBuildingContext {
 
   // Reason for creating the file with the filter
   TableFileCreationReason reason = TableFileCreationReason::kMisc;
+
+  // If positive, the bits per key that this file's filter should use, as
+  // allocated from the column family's filter_memory_budget_bits_per_key
+  // by how often lookups miss in files at its level. The built-in Bloom and
+  // Ribbon policies use it in place of their configured bits_per_key (unless
+  // configured for no filter).
+  double adaptive_bits_per_key = 0.0;
 };
 
 // Determines what kind of filter (if any) to generate in SST files, and under
@@ -157,6 +157,9 @@ enum class CompactionReason : int {
   // [InternalOnly] DBImpl::ReFitLevel treated as a compaction,
   // Used only for internal conflict checking with other compactions
   kRefitLevel,
+  // Dropping files that a standalone range tombstone file in a higher level
+  // fully covers, without rewriting them.
+  kFilesCoveredByRangeDeletion,
   // total number of compaction reasons, new reasons must be added above this.
   kNumOfReasons,
 };
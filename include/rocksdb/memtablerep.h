@@ -17,7 +17,7 @@
 // The factory will be passed an MemTableAllocator object when a new MemTableRep
 // is requested.
 //
-// Users can implement their own memtable representations. We include three
+// Users can implement their own memtable representations. We include four
 // types built in:
 //  - SkipListRep: This is the default; it is backed by a skip list.
 //  - HashSkipListRep: The memtable rep that is best used for keys that are
@@ -28,10 +28,13 @@
 // vector is sorted. It is intelligent about sorting; once the MarkReadOnly()
 // has been called, the vector will only be sorted once. It is optimized for
 // random-write-heavy workloads.
+//  - BTreeRep: This is backed by a cache-conscious B+-tree. It is optimized
+//  for point lookups and seeks.
 //
-// The last four implementations are designed for situations in which
-// iteration over the entire collection is rare since doing so requires all the
-// keys to be copied into a sorted data structure.
+// SkipListRep and BTreeRep keep keys sorted. HashSkipListRep and VectorRep
+// are designed for situations in which iteration over the entire collection
+// is rare since doing so requires all the keys to be copied into a sorted
+// data structure.
 
 #pragma once
 
@@ -49,6 +52,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Arena;
 class Allocator;
+class Comparator;
 class LookupKey;
 class SliceTransform;
 class Logger;
@@ -80,6 +84,12 @@ class MemTableRep {
     virtual int operator()(const char* prefix_len_key,
                            const Slice& key) const = 0;
 
+    // If the compared keys are internal keys ordered by a user comparator
+    // (then by decreasing sequence number), returns that user comparator.
+    // Otherwise returns nullptr. A MemTableRep may use this to specialize
+    // for well-known orderings.
+    virtual const Comparator* user_comparator() const { return nullptr; }
+
     virtual ~KeyComparator() {}
   };
 
@@ -433,6 +443,36 @@ class VectorRepFactory : public MemTableRepFactory {
   bool IsInsertConcurrentlySupported() const override { return true; }
 };
 
+// This creates MemTableReps backed by a B+-tree. Each node packs up to 32
+// keys together with their 8-byte key prefixes, so that point lookups and
+// seeks touch a few contiguous cache lines per level instead of taking one
+// cache miss per skip list level. The prefixes are only used when the user
+// comparator is BytewiseComparator().
+//
+// Reads are lock-free and may run concurrently with inserts. Concurrent
+// inserts are supported, but are serialized internally for the duration of
+// the tree update.
+class BTreeRepFactory : public MemTableRepFactory {
+ public:
+  BTreeRepFactory() {}
+
+  // Methods for Configurable/Customizable class overrides
+  static const char* kClassName() { return "BTreeRepFactory"; }
+  static const char* kNickName() { return "btree"; }
+  const char* Name() const override { return kClassName(); }
+  const char* NickName() const override { return kNickName(); }
+
+  // Methods for MemTableRepFactory class overrides
+  using MemTableRepFactory::CreateMemTableRep;
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&, Allocator*,
+                                 const SliceTransform*,
+                                 Logger* logger) override;
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+  bool CanHandleDuplicatedKey() const override { return true; }
+};
+
 // This class contains a fixed array of buckets, each
 // pointing to a skiplist (null if the bucket is empty).
 // bucket_count: number of fixed array buckets
@@ -784,6 +784,15 @@ struct DBOptions {
   // Default: 16
   int max_file_opening_threads = 16;
 
+  // EXPERIMENTAL
+  // Number of threads used to load the MANIFEST on DB::Open(). With a value
+  // above 1, MANIFEST records are decoded into version edits in parallel, and
+  // the edits of different column families are applied to their version
+  // builders in parallel. This mostly helps DBs with many column families or
+  // with a large MANIFEST.
+  // Default: 1
+  int manifest_recovery_threads = 1;
+
   // Once write-ahead logs exceed this size, we will start forcing the flush of
   // column families whose memtables are backed by the oldest live WAL file
   // (i.e. the ones that are causing all the space amplification). If set to 0
@@ -1228,6 +1237,22 @@ struct DBOptions {
   // Default: false
   bool enable_pipelined_write = false;
 
+  // EXPERIMENTAL
+  // With enable_pipelined_write, a write group with WriteOptions::sync leaves
+  // the WAL writer queue once its records are appended to the WAL, without
+  // waiting for the WAL sync. The sync is instead awaited before the group's
+  // memtable writes, so the next write group can append to the WAL while the
+  // previous sync is in flight, and a single sync can cover several groups
+  // (group commit). Sync writes are acknowledged only once durable, as
+  // before. This can considerably raise the throughput of sync writes.
+  //
+  // Requires WAL files that can be synced concurrently with appends (see
+  // FSWritableFile::IsSyncThreadSafe()), so it is incompatible with
+  // manual_wal_flush and allow_mmap_writes.
+  //
+  // Default: false
+  bool enable_pipelined_wal_sync = false;
+
   // Setting unordered_write to true trades higher write throughput with
   // relaxing the immutability guarantee of snapshots. This violates the
   // repeatability one expects from ::Get from a snapshot, as well as
@@ -1254,6 +1279,24 @@ struct DBOptions {
   // Default: false
   bool unordered_write = false;
 
+  // EXPERIMENTAL
+  // With unordered_write, stage write batches in a per-core buffer instead of
+  // having every writer join the single write queue. One writer per core at a
+  // time takes the batches staged on its core, writes them to the WAL as a
+  // single record that reserves one range of sequence numbers for all of
+  // them, and publishes that range in order. The memtable inserts then run
+  // concurrently in the writers as usual. This reduces contention on the
+  // write queue with many concurrent writers.
+  //
+  // Writes with a callback, WriteOptions::disableWAL, no_slowdown, a
+  // non-default rate_limiter_priority or protection_bytes_per_key, and
+  // transaction writes bypass the staging.
+  //
+  // Requires unordered_write.
+  //
+  // Default: false
+  bool core_local_write_staging = false;
+
   // If true, allow multi-writers to update mem tables in parallel.
   // Only some memtable_factory-s support concurrent writes; currently it
   // is implemented only for SkipListFactory.  Concurrent memtable writes
@@ -1352,6 +1395,26 @@ struct DBOptions {
   // DEFAULT: false
   bool avoid_flush_during_recovery = false;
 
+  // EXPERIMENTAL
+  // Number of threads used to replay WALs into memtables and to flush the
+  // recovered memtables to L0 during DB::Open. With a value above 1, the
+  // opening thread reads and verifies WAL records and hands the write batches
+  // to a pool of threads that insert them into the memtables concurrently,
+  // and column families that need a flush during or at the end of recovery
+  // are flushed in parallel.
+  //
+  // Concurrent replay is only used with allow_concurrent_memtable_write and
+  // without allow_2pc; otherwise only the flushes run in parallel. Unless
+  // paranoid_checks is false, a write batch that fails to be inserted into
+  // the memtables fails DB::Open whatever the wal_recovery_mode, because
+  // later records may already have been applied.
+  //
+  // Per-phase recovery timings are reported in the info log and in the
+  // "rocksdb.dbstats" property.
+  //
+  // DEFAULT: 1
+  int wal_recovery_threads = 1;
+
   // By default RocksDB will flush all memtables on DB close if there are
   // unpersisted data (i.e. with WAL disabled) The flush can be skip to speedup
   // DB close. Unpersisted data WILL BE LOST.
@@ -1997,6 +2060,10 @@ struct ReadOptions {
   // If async_io is enabled, RocksDB will prefetch some of data asynchronously.
   // RocksDB apply it if reads are sequential and its internal automatic
   // prefetching.
+  //
+  // Iterator Seek() also submits the block reads of all levels together
+  // rather than one level at a time, including the index partition reads of
+  // partitioned indexes, and waits for them afterwards.
   bool async_io = false;
 
   // Experimental
@@ -2157,6 +2224,24 @@ struct ReadOptions {
   // Default: true
   bool auto_readahead_size = true;
 
+  // EXPERIMENTAL
+  //
+  // When set, implicit auto readahead of block-based table iterators tells
+  // forward, backward and strided (skipping some blocks) reads apart, instead
+  // of only recognizing forward reads:
+  // - A reverse scan has the file system read ahead of it, backward, after as
+  //   many reads as a forward scan would. Not done with direct IO, as
+  //   RocksDB's own prefetch buffer only reads forward.
+  // - A scan that keeps skipping over as much data as it reads, no more than
+  //   a block at a time, is read ahead of like a forward scan.
+  // - Nothing is read ahead of the last block within iterate_upper_bound (or
+  //   the prefix with `prefix_same_as_start`), nor past the data blocks of a
+  //   file.
+  // PerfContext::prefetch_bytes_wasted shows how much read ahead goes unused.
+  //
+  // Default: false
+  bool pattern_aware_readahead = false;
+
   // When set, the iterator may defer loading and/or preparing the value when
   // moving to a different entry (i.e. during SeekToFirst/SeekToLast/Seek/
   // SeekForPrev/Next/Prev operations). This can be used to save on I/O and/or
@@ -2466,6 +2551,23 @@ struct CompactRangeOptions {
   double blob_garbage_collection_age_cutoff = -1;
 };
 
+// EXPERIMENTAL
+// For DB::CompactBlobFiles()
+struct CompactBlobFilesOptions {
+  // Blob files in which at least this fraction of the bytes is garbage are
+  // rewritten. Garbage already dropped by an earlier rewrite of the file does
+  // not count.
+  //
+  // Default: 0.5
+  double garbage_ratio_threshold = 0.5;
+
+  // The priority of the reads and writes of the job for
+  // DBOptions::rate_limiter.
+  //
+  // Default: IO_LOW
+  Env::IOPriority rate_limiter_priority = Env::IO_LOW;
+};
+
 // IngestExternalFileOptions setting guide:
 //
 // The options in IngestExternalFileOptions interact in complex ways depending
@@ -290,6 +290,13 @@ struct PerfContextBase {
   uint64_t file_ingestion_nanos;
   // Time IngestExternalFile blocked live writes.
   uint64_t file_ingestion_blocking_live_writes_nanos;
+
+  // Bytes read by RocksDB's prefetch buffers for iterators, or hinted to the
+  // file system to read ahead of them
+  uint64_t prefetch_bytes;
+  // Of prefetch_bytes, those that were not read by the iterator before it
+  // moved elsewhere or was deleted
+  uint64_t prefetch_bytes_wasted;
 };
 
 struct PerfContext : public PerfContextBase {
@@ -542,6 +542,15 @@ enum Tickers : uint32_t {
   // TransactionOptions::large_txn_commit_optimize_threshold.
   NUMBER_WBWI_INGEST,
 
+  // Blob file GC (DB::CompactBlobFiles), which rewrites blob files outside of
+  // compactions: the number of blob files rewritten, the bytes read from and
+  // written to blob files, and the bytes of blob files freed. The bytes
+  // written per byte freed are the write amplification of blob file GC.
+  BLOB_FILE_GC_NUM_FILES,
+  BLOB_FILE_GC_BYTES_READ,
+  BLOB_FILE_GC_BYTES_WRITTEN,
+  BLOB_FILE_GC_BYTES_RECLAIMED,
+
   TICKER_ENUM_MAX
 };
 
@@ -682,6 +691,14 @@ enum Histograms : uint32_t {
   // Number of operations per transaction.
   NUM_OP_PER_TRANSACTION,
 
+  // Time jobs of each Env::Priority class spend queued before a thread of
+  // NewWorkStealingEnv() starts running them. Must stay in the order of
+  // Env::Priority.
+  SCHEDULER_QUEUE_DELAY_BOTTOM_MICROS,
+  SCHEDULER_QUEUE_DELAY_LOW_MICROS,
+  SCHEDULER_QUEUE_DELAY_HIGH_MICROS,
+  SCHEDULER_QUEUE_DELAY_USER_MICROS,
+
   HISTOGRAM_ENUM_MAX
 };
 
@@ -275,6 +275,19 @@ struct BlockBasedTableOptions {
   // kDataBlockBinaryAndHash.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // If true, each data block also stores the first 8 bytes of every restart
+  // key's user key as a fixed-width integer array following the restart
+  // array. Seeks within a data block first narrow the restart points to those
+  // whose prefix matches the target's, using only this array (vectorized
+  // where supported), so fewer restart keys need to be decoded and compared.
+  // This costs 8 bytes per restart point and helps most with small
+  // block_restart_interval and keys that differ within their first 8 bytes.
+  //
+  // Only takes effect with BytewiseComparator(). Data blocks written with
+  // this option cannot be read by RocksDB versions that do not support it
+  // (they are reported as corruption).
+  bool data_block_restart_key_prefixes = false;
+
   // Option hash_index_allow_collision is now deleted.
   // It will behave as if hash_index_allow_collision=true.
 
@@ -888,6 +901,30 @@ struct CuckooTableOptions {
 TableFactory* NewCuckooTableFactory(
     const CuckooTableOptions& table_options = CuckooTableOptions());
 
+struct EytzingerTableOptions {
+  static const char* kName() { return "EytzingerTableOptions"; }
+
+  // Every index_sample_interval-th key is copied into an Eytzinger-ordered
+  // (breadth-first) search tree that is binary searched without data
+  // dependent branches. A lookup then scans at most
+  // index_sample_interval - 1 adjacent key slots. Smaller values make the
+  // index larger and the final scan shorter; 1 indexes every key.
+  uint32_t index_sample_interval = 4;
+};
+
+// Eytzinger Table Factory for an SST format designed for read-mostly column
+// families whose files live on tmpfs or stay in the page cache. Keys are laid
+// out in a sorted array of cache-line-aligned fixed-stride slots, searched
+// through an Eytzinger-ordered sample index, so a point lookup touches a
+// handful of cache lines and never goes through the block cache. Values are
+// stored uncompressed. All internal keys (snapshots, merges, deletions) and
+// range deletions are supported.
+//
+// The whole file is accessed in place when options.allow_mmap_reads is true;
+// otherwise it is read into memory when the table is opened.
+TableFactory* NewEytzingerTableFactory(
+    const EytzingerTableOptions& table_options = EytzingerTableOptions());
+
 class RandomAccessFileReader;
 
 // A base class for table factories.
@@ -899,6 +936,7 @@ class TableFactory : public Customizable {
   static const char* kBlockBasedTableName() { return "BlockBasedTable"; }
   static const char* kPlainTableName() { return "PlainTable"; }
   static const char* kCuckooTableName() { return "CuckooTable"; }
+  static const char* kEytzingerTableName() { return "EytzingerTable"; }
 
   // Creates and configures a new TableFactory from the input options and id.
   static Status CreateFromString(const ConfigOptions& config_options,
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "rocksdb/advanced_iterator.h"
@@ -165,4 +166,14 @@ class UserDefinedIndexFactory : public Customizable {
       Slice& index_block) const = 0;
 };
 
+// Returns a UserDefinedIndexFactory named "learned_index", for tables whose
+// keys all have the same width, e.g. monotonic counters behind a fixed
+// prefix. The index keeps only the key bytes that vary between data blocks,
+// and replaces the binary search over all blocks with a piecewise linear
+// model predicting the block of a key to within `epsilon` blocks, followed
+// by a search around the prediction. Building a table with keys of different
+// widths fails with NotSupported.
+std::shared_ptr<UserDefinedIndexFactory> NewLearnedIndexFactory(
+    uint32_t epsilon = 4);
+
 }  // namespace ROCKSDB_NAMESPACE
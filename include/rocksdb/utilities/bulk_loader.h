@@ -0,0 +1,93 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ColumnFamilyHandle;
+class DB;
+
+struct BulkLoaderOptions {
+  // Directory where the SST files are written, along with temporary files
+  // holding the sorted runs that do not fit in memory. Must exist.
+  std::string output_dir;
+
+  // Number of threads sorting and writing SST files in Finish().
+  int num_threads = 4;
+
+  // Approximate memory used to buffer the added entries, over all threads.
+  // Once full, buffered entries are sorted and spilled to a temporary file
+  // by the thread adding to them.
+  size_t write_buffer_size = 256 << 20;
+
+  // Number of key ranges the output is split into, to be written in
+  // parallel. Each range is written to one or more SST files. The range
+  // boundaries are picked from a sample of the added keys. 0 means
+  // 4 * num_threads.
+  uint32_t num_partitions = 0;
+
+  // SST files are cut once they reach about this size.
+  uint64_t target_file_size = 256 << 20;
+
+  // Passed to IngestExternalFileOptions::ingest_behind by FinishAndIngest(),
+  // to load into the bottommost level of a column family that already has
+  // data. Requires allow_ingest_behind.
+  bool ingest_behind = false;
+};
+
+// EXPERIMENTAL
+// BulkLoader builds SST files from key/value pairs added in any order, from
+// any number of threads, for ingestion with DB::IngestExternalFile(). The
+// files it creates do not overlap each other, so when ingested into an empty
+// column family they all go straight to the bottommost level.
+//
+// Added entries are buffered in memory, and sorted and spilled to temporary
+// SST files when the buffers are full. Finish() splits the key space into
+// ranges and, for each range in parallel, merges the buffered and spilled
+// entries into the output SST files.
+//
+// Only Put entries without timestamps are supported. If a key is added more
+// than once, one of its values is kept and which one is unspecified.
+class BulkLoader {
+ public:
+  // `options` are used to write the SST files: comparator, table factory,
+  // compression, etc. `column_family`, if not nullptr, is the column family
+  // the files are meant for, as with SstFileWriter.
+  BulkLoader(const Options& options, const BulkLoaderOptions& loader_options,
+             ColumnFamilyHandle* column_family = nullptr);
+
+  // Deletes any temporary file left.
+  ~BulkLoader();
+
+  BulkLoader(const BulkLoader&) = delete;
+  BulkLoader& operator=(const BulkLoader&) = delete;
+
+  // Adds an entry. Thread-safe. Returns a non-ok status if spilling failed,
+  // or after Finish() was called.
+  Status Add(const Slice& key, const Slice& value);
+
+  // Writes all added entries into SST files in output_dir and sets
+  // `*file_paths` to them, in key order. Must be called once, after all
+  // Add() calls returned.
+  Status Finish(std::vector<std::string>* file_paths);
+
+  // Finish(), then moves the SST files into `column_family` of `db`.
+  Status FinishAndIngest(DB* db, ColumnFamilyHandle* column_family);
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -19,6 +19,8 @@
 namespace ROCKSDB_NAMESPACE {
 
 class ColumnFamilyHandle;
+class DB;
+struct BulkLoaderOptions;
 
 // EXPERIMENTAL
 //
@@ -187,4 +189,24 @@ class SecondaryIndexIterator {
   std::string prefix_;
 };
 
+// EXPERIMENTAL
+//
+// Builds the secondary index entries of all key-values in the primary column
+// family of the given index, and ingests them into its secondary column family
+// as external SST files. This can be used to backfill a secondary index that
+// is added to a database that already has data, which is much faster than
+// rewriting all primary key-values through transactions. The primary column
+// family is read from a snapshot, split into key ranges at the boundaries of
+// its SST files, which are scanned in parallel; the index entries are then
+// sorted and written into SST files by a BulkLoader configured by `options`.
+//
+// This is an offline operation: the primary column family must not be written
+// to until it returns, and the secondary column family must not contain any
+// entries of the index yet. The primary and secondary column families have to
+// be different. Since the original value of the primary column is no longer
+// available, GetSecondaryValue is called with the stored (potentially updated)
+// value as both the primary and the previous column value.
+Status BackfillSecondaryIndex(DB* db, const SecondaryIndex* index,
+                              const BulkLoaderOptions& options);
+
 }  // namespace ROCKSDB_NAMESPACE
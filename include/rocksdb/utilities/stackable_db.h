@@ -139,6 +139,15 @@ class StackableDB : public DB {
                          timestamps, statuses, sorted_input);
   }
 
+  void MultiGetPinned(const ReadOptions& options,
+                      ColumnFamilyHandle* column_family, const size_t num_keys,
+                      const Slice* keys, PinnableSlice* values,
+                      Status* statuses, size_t max_pinned_bytes,
+                      const bool sorted_input = false) override {
+    db_->MultiGetPinned(options, column_family, num_keys, keys, values,
+                        statuses, max_pinned_bytes, sorted_input);
+  }
+
   using DB::MultiGetEntity;
 
   void MultiGetEntity(const ReadOptions& options,
@@ -359,6 +368,11 @@ class StackableDB : public DB {
                              compaction_job_info);
   }
 
+  Status CompactBlobFiles(const CompactBlobFilesOptions& options,
+                          ColumnFamilyHandle* column_family) override {
+    return db_->CompactBlobFiles(options, column_family);
+  }
+
   Status PauseBackgroundWork() override { return db_->PauseBackgroundWork(); }
   Status ContinueBackgroundWork() override {
     return db_->ContinueBackgroundWork();
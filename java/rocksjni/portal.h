@@ -7471,6 +7471,9 @@ class CompactionReasonJni {
         return 0x12;
       case ROCKSDB_NAMESPACE::CompactionReason::kRefitLevel:
         return 0x13;
+      case ROCKSDB_NAMESPACE::CompactionReason::
+          kFilesCoveredByRangeDeletion:
+        return 0x14;
       default:
         return 0x7F;  // undefined
     }
@@ -7521,6 +7524,9 @@ class CompactionReasonJni {
         return ROCKSDB_NAMESPACE::CompactionReason::kRoundRobinTtl;
       case 0x13:
         return ROCKSDB_NAMESPACE::CompactionReason::kRefitLevel;
+      case 0x14:
+        return ROCKSDB_NAMESPACE::CompactionReason::
+            kFilesCoveredByRangeDeletion;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionReason::kUnknown;
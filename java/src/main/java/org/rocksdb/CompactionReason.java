@@ -104,7 +104,13 @@ public enum CompactionReason {
   /**
    * Compaction by calling DBImpl::ReFitLevel
    */
-  kRefitLevel((byte) 0x13);
+  kRefitLevel((byte) 0x13),
+
+  /**
+   * Dropping files fully covered by a standalone range tombstone file in a
+   * higher level, without rewriting them
+   */
+  kFilesCoveredByRangeDeletion((byte) 0x14);
 
   private final byte value;
 
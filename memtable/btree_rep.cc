@@ -0,0 +1,641 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// A MemTableRep backed by a B+-tree whose nodes pack many keys into a few
+// consecutive cache lines, as an alternative to the skip list for point
+// lookup heavy workloads.
+//
+// Layout: every node stores an array of up to kBTreeFanout key pointers and,
+// next to it, an array of 8-byte big-endian key prefixes. When the memtable
+// is ordered by BytewiseComparator() the binary search within a node is
+// decided by the prefix array alone for most probes, so a lookup only
+// dereferences entries whose prefix ties with the target instead of taking
+// one cache miss per skip list level.
+//
+// Concurrency: readers never block. Each node carries a version counter used
+// as a seqlock; a reader examines a node, then validates that the version did
+// not change, retrying that node otherwise. Nodes form a B-link tree (every
+// node knows its right sibling and the exclusive upper bound of its keys), so
+// a reader that arrives at a node that split underneath it simply moves
+// right. Writers, including concurrent inserts, are serialized by a mutex
+// that is held only for the tree update itself. Keys never move left and
+// nodes are never freed (they live in the memtable arena), so stale node
+// pointers held by readers and iterators stay safe to dereference.
+
+#include <atomic>
+
+#include "db/memtable.h"
+#include "memory/arena.h"
+#include "port/port.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/memtablerep.h"
+#include "util/autovector.h"
+#include "util/coding.h"
+#include "util/math.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+
+// Number of keys per node. The prefix array of a full node spans four cache
+// lines, which keeps the in-node binary search within a handful of lines.
+constexpr uint32_t kBTreeFanout = 32;
+
+class BTreeRep : public MemTableRep {
+ public:
+  BTreeRep(const KeyComparator& compare, Allocator* allocator);
+
+  void Insert(KeyHandle handle) override {
+    InsertImpl(static_cast<const char*>(handle));
+  }
+
+  bool InsertKey(KeyHandle handle) override {
+    return InsertImpl(static_cast<const char*>(handle));
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    InsertImpl(static_cast<const char*>(handle));
+  }
+
+  bool InsertKeyConcurrently(KeyHandle handle) override {
+    return InsertImpl(static_cast<const char*>(handle));
+  }
+
+  bool Contains(const char* key) const override;
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override;
+
+  ~BTreeRep() override = default;
+
+  MemTableRep::Iterator* GetIterator(Arena* arena) override;
+
+ private:
+  struct Node {
+    explicit Node(bool is_leaf) : leaf(is_leaf) {}
+
+    // Seqlock over the node contents; odd while a writer modifies the node.
+    std::atomic<uint64_t> version{0};
+    std::atomic<uint32_t> count{0};
+    const bool leaf;
+    // Right sibling, and the exclusive upper bound of the keys reachable
+    // through this node. Both are null for the rightmost node of a level.
+    std::atomic<Node*> next{nullptr};
+    std::atomic<const char*> high_key{nullptr};
+    std::atomic<uint64_t> high_prefix{0};
+    std::atomic<uint64_t> prefixes[kBTreeFanout];
+    // Entries in a leaf; separators in an inner node, where child i holds
+    // the keys in [keys[i - 1], keys[i]).
+    std::atomic<const char*> keys[kBTreeFanout];
+  };
+
+  struct InnerNode : public Node {
+    InnerNode() : Node(false) {}
+
+    std::atomic<Node*> children[kBTreeFanout + 1];
+  };
+
+  struct SearchKey {
+    const char* key;
+    uint64_t prefix;
+  };
+
+  enum class SearchMode {
+    kGreaterOrEqual,
+    kGreater,
+    kLess,
+    kLessOrEqual,
+  };
+
+  struct Position {
+    Node* leaf = nullptr;
+    uint32_t index = 0;
+    uint64_t version = 0;
+    const char* key = nullptr;
+  };
+
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const BTreeRep* rep) : rep_(rep) {}
+
+    ~Iterator() override = default;
+
+    bool Valid() const override { return pos_.key != nullptr; }
+
+    const char* key() const override {
+      assert(Valid());
+      return pos_.key;
+    }
+
+    void Next() override;
+
+    void Prev() override {
+      assert(Valid());
+      rep_->Find(rep_->MakeSearchKey(pos_.key), SearchMode::kLess, nullptr,
+                 &pos_);
+    }
+
+    void Seek(const Slice& internal_key, const char* memtable_key) override {
+      const char* encoded_key = (memtable_key != nullptr)
+                                    ? memtable_key
+                                    : EncodeKey(&tmp_, internal_key);
+      rep_->Find(rep_->MakeSearchKey(encoded_key),
+                 SearchMode::kGreaterOrEqual, nullptr, &pos_);
+    }
+
+    void SeekForPrev(const Slice& internal_key,
+                     const char* memtable_key) override {
+      const char* encoded_key = (memtable_key != nullptr)
+                                    ? memtable_key
+                                    : EncodeKey(&tmp_, internal_key);
+      rep_->Find(rep_->MakeSearchKey(encoded_key), SearchMode::kLessOrEqual,
+                 nullptr, &pos_);
+    }
+
+    void SeekToFirst() override { rep_->FindFirst(&pos_); }
+
+    void SeekToLast() override { rep_->FindLast(&pos_); }
+
+   private:
+    const BTreeRep* const rep_;
+    Position pos_;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  static uint64_t BeginRead(const Node* node) {
+    uint64_t v = node->version.load(std::memory_order_acquire);
+    while (v & 1) {
+      port::AsmVolatilePause();
+      v = node->version.load(std::memory_order_acquire);
+    }
+    return v;
+  }
+
+  static bool Validate(const Node* node, uint64_t v) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return node->version.load(std::memory_order_relaxed) == v;
+  }
+
+  static void BeginWrite(Node* node) {
+    node->version.store(node->version.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  static void EndWrite(Node* node) {
+    node->version.store(node->version.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+  }
+
+  static void SetEntry(Node* node, uint32_t i, uint64_t prefix,
+                       const char* key) {
+    node->prefixes[i].store(prefix, std::memory_order_relaxed);
+    // Release so that a reader that loads the pointer may dereference it.
+    node->keys[i].store(key, std::memory_order_release);
+  }
+
+  SearchKey MakeSearchKey(const char* memtable_key) const;
+
+  // Compares the entry (prefix, key) against the target.
+  int Compare(uint64_t prefix, const char* key, const SearchKey& t) const {
+    if (use_prefix_ && prefix != t.prefix) {
+      return prefix < t.prefix ? -1 : 1;
+    }
+    return compare_(key, t.key);
+  }
+
+  // Number of keys among the first `count` of `node` that are less than the
+  // target, or less than or equal to it when `inclusive`.
+  uint32_t Rank(const Node* node, uint32_t count, const SearchKey& t,
+                bool inclusive) const;
+
+  // Whether the keys the search is looking for may lie to the right of
+  // `node`, in which case the search has to move to its right sibling.
+  bool PastHighKey(const Node* node, const SearchKey& t,
+                   SearchMode mode) const;
+
+  // Positions `pos` at the entry that is >=, >, <, or <= the target. `pos`
+  // is invalid (key == nullptr) if there is no such entry. A rightwards
+  // search may start from a leaf at or left of the target's leaf instead of
+  // the root, which is valid because keys never move left.
+  void Find(const SearchKey& t, SearchMode mode, Node* start,
+            Position* pos) const;
+  void FindFirst(Position* pos) const;
+  void FindLast(Position* pos) const;
+
+  bool InsertImpl(const char* key);
+  Node* NewLeaf();
+  InnerNode* NewInnerNode();
+
+  const KeyComparator& compare_;
+  // True if entries are internal keys ordered bytewise on the user key, in
+  // which case the 8-byte user key prefixes are order preserving.
+  const bool use_prefix_;
+  std::atomic<Node*> root_;
+  port::Mutex write_mutex_;
+};
+
+BTreeRep::BTreeRep(const KeyComparator& compare, Allocator* allocator)
+    : MemTableRep(allocator),
+      compare_(compare),
+      use_prefix_(compare.user_comparator() == BytewiseComparator()),
+      root_(nullptr) {
+  root_.store(NewLeaf(), std::memory_order_release);
+}
+
+BTreeRep::Node* BTreeRep::NewLeaf() {
+  void* mem = allocator_->AllocateAligned(sizeof(Node));
+  return new (mem) Node(true);
+}
+
+BTreeRep::InnerNode* BTreeRep::NewInnerNode() {
+  void* mem = allocator_->AllocateAligned(sizeof(InnerNode));
+  return new (mem) InnerNode();
+}
+
+BTreeRep::SearchKey BTreeRep::MakeSearchKey(const char* memtable_key) const {
+  SearchKey t{memtable_key, 0};
+  if (use_prefix_) {
+    Slice user_key = UserKey(memtable_key);
+    char buf[sizeof(uint64_t)] = {};
+    memcpy(buf, user_key.data(), std::min(user_key.size(), sizeof(buf)));
+    // Big-endian so that integer order matches bytewise order.
+    t.prefix = EndianSwapValue(DecodeFixed64(buf));
+  }
+  return t;
+}
+
+uint32_t BTreeRep::Rank(const Node* node, uint32_t count, const SearchKey& t,
+                        bool inclusive) const {
+  uint32_t lo = 0;
+  uint32_t hi = count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    int c = Compare(node->prefixes[mid].load(std::memory_order_relaxed),
+                    node->keys[mid].load(std::memory_order_acquire), t);
+    if (c < 0 || (inclusive && c == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+bool BTreeRep::PastHighKey(const Node* node, const SearchKey& t,
+                           SearchMode mode) const {
+  const char* high = node->high_key.load(std::memory_order_acquire);
+  if (high == nullptr) {
+    return false;
+  }
+  int c = Compare(node->high_prefix.load(std::memory_order_relaxed), high, t);
+  // The right sibling holds keys >= high, all of which are greater than the
+  // target for a strictly-less search when target == high.
+  return mode == SearchMode::kLess ? c < 0 : c <= 0;
+}
+
+void BTreeRep::Find(const SearchKey& t, SearchMode mode, Node* start,
+                    Position* pos) const {
+  const bool rightwards =
+      mode == SearchMode::kGreaterOrEqual || mode == SearchMode::kGreater;
+  assert(start == nullptr || rightwards);
+  Node* node =
+      start != nullptr ? start : root_.load(std::memory_order_acquire);
+  // Inner nodes route by "separator <= target" except for a strictly-less
+  // search, which must descend into the child holding keys < target.
+  const bool inner_inclusive = mode != SearchMode::kLess;
+  const bool leaf_inclusive =
+      mode == SearchMode::kGreater || mode == SearchMode::kLessOrEqual;
+  while (true) {
+    uint64_t v = BeginRead(node);
+    if (PastHighKey(node, t, mode)) {
+      Node* next = node->next.load(std::memory_order_acquire);
+      if (Validate(node, v)) {
+        node = next;
+      }
+      continue;
+    }
+    uint32_t count = node->count.load(std::memory_order_acquire);
+    if (!node->leaf) {
+      uint32_t c = Rank(node, count, t, inner_inclusive);
+      Node* child = static_cast<const InnerNode*>(node)->children[c].load(
+          std::memory_order_acquire);
+      if (Validate(node, v)) {
+        node = child;
+      }
+      continue;
+    }
+    uint32_t rank = Rank(node, count, t, leaf_inclusive);
+    if (rightwards) {
+      if (rank < count) {
+        const char* key = node->keys[rank].load(std::memory_order_acquire);
+        if (Validate(node, v)) {
+          *pos = Position{node, rank, v, key};
+          return;
+        }
+        continue;
+      }
+      // Everything in this leaf is before the target; the answer, if any, is
+      // the first entry of the right sibling.
+      Node* next = node->next.load(std::memory_order_acquire);
+      if (!Validate(node, v)) {
+        continue;
+      }
+      if (next == nullptr) {
+        *pos = Position();
+        return;
+      }
+      node = next;
+      continue;
+    }
+    if (rank == 0) {
+      if (Validate(node, v)) {
+        *pos = Position();
+        return;
+      }
+      continue;
+    }
+    const char* key = node->keys[rank - 1].load(std::memory_order_acquire);
+    if (Validate(node, v)) {
+      *pos = Position{node, rank - 1, v, key};
+      return;
+    }
+  }
+}
+
+void BTreeRep::FindFirst(Position* pos) const {
+  // The leftmost node of every level keeps its position across splits, so
+  // following the first child always reaches the leftmost leaf.
+  Node* node = root_.load(std::memory_order_acquire);
+  while (!node->leaf) {
+    node = static_cast<const InnerNode*>(node)->children[0].load(
+        std::memory_order_acquire);
+  }
+  while (true) {
+    uint64_t v = BeginRead(node);
+    uint32_t count = node->count.load(std::memory_order_acquire);
+    const char* key =
+        count > 0 ? node->keys[0].load(std::memory_order_acquire) : nullptr;
+    if (Validate(node, v)) {
+      *pos = key != nullptr ? Position{node, 0, v, key} : Position();
+      return;
+    }
+  }
+}
+
+void BTreeRep::FindLast(Position* pos) const {
+  Node* node = root_.load(std::memory_order_acquire);
+  while (true) {
+    uint64_t v = BeginRead(node);
+    Node* next = node->next.load(std::memory_order_acquire);
+    uint32_t count = node->count.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      if (Validate(node, v)) {
+        node = next;
+      }
+      continue;
+    }
+    if (!node->leaf) {
+      Node* child = static_cast<const InnerNode*>(node)->children[count].load(
+          std::memory_order_acquire);
+      if (Validate(node, v)) {
+        node = child;
+      }
+      continue;
+    }
+    const char* key =
+        count > 0 ? node->keys[count - 1].load(std::memory_order_acquire)
+                  : nullptr;
+    if (Validate(node, v)) {
+      *pos = key != nullptr ? Position{node, count - 1, v, key} : Position();
+      return;
+    }
+  }
+}
+
+void BTreeRep::Iterator::Next() {
+  assert(Valid());
+  // Fast path: the leaf has not changed since we were positioned on it.
+  Node* leaf = pos_.leaf;
+  if (leaf->version.load(std::memory_order_acquire) == pos_.version) {
+    uint32_t count = leaf->count.load(std::memory_order_acquire);
+    if (pos_.index + 1 < count) {
+      const char* key =
+          leaf->keys[pos_.index + 1].load(std::memory_order_acquire);
+      if (Validate(leaf, pos_.version)) {
+        ++pos_.index;
+        pos_.key = key;
+        return;
+      }
+    }
+  }
+  rep_->Find(rep_->MakeSearchKey(pos_.key), SearchMode::kGreater, leaf,
+             &pos_);
+}
+
+bool BTreeRep::Contains(const char* key) const {
+  Position pos;
+  Find(MakeSearchKey(key), SearchMode::kGreaterOrEqual, nullptr, &pos);
+  return pos.key != nullptr && compare_(pos.key, key) == 0;
+}
+
+void BTreeRep::Get(const LookupKey& k, void* callback_args,
+                   bool (*callback_func)(void* arg, const char* entry)) {
+  BTreeRep::Iterator iter(this);
+  Slice dummy_slice;
+  for (iter.Seek(dummy_slice, k.memtable_key().data());
+       iter.Valid() && callback_func(callback_args, iter.key()); iter.Next()) {
+  }
+}
+
+MemTableRep::Iterator* BTreeRep::GetIterator(Arena* arena) {
+  void* mem = arena ? arena->AllocateAligned(sizeof(BTreeRep::Iterator))
+                    : operator new(sizeof(BTreeRep::Iterator));
+  return new (mem) BTreeRep::Iterator(this);
+}
+
+bool BTreeRep::InsertImpl(const char* key) {
+  const SearchKey t = MakeSearchKey(key);
+  MutexLock l(&write_mutex_);
+
+  // Writers are serialized, so the tree is structurally consistent here and
+  // the descent never needs to move right.
+  autovector<std::pair<InnerNode*, uint32_t>, 8> path;
+  Node* node = root_.load(std::memory_order_relaxed);
+  while (!node->leaf) {
+    auto* inner = static_cast<InnerNode*>(node);
+    uint32_t c =
+        Rank(inner, inner->count.load(std::memory_order_relaxed), t, true);
+    path.emplace_back(inner, c);
+    node = inner->children[c].load(std::memory_order_relaxed);
+  }
+
+  const uint32_t count = node->count.load(std::memory_order_relaxed);
+  const uint32_t idx = Rank(node, count, t, false);
+  if (idx < count &&
+      compare_(node->keys[idx].load(std::memory_order_relaxed), key) == 0) {
+    return false;
+  }
+
+  if (count < kBTreeFanout) {
+    BeginWrite(node);
+    for (uint32_t i = count; i > idx; --i) {
+      SetEntry(node, i, node->prefixes[i - 1].load(std::memory_order_relaxed),
+               node->keys[i - 1].load(std::memory_order_relaxed));
+    }
+    SetEntry(node, idx, t.prefix, key);
+    node->count.store(count + 1, std::memory_order_release);
+    EndWrite(node);
+    return true;
+  }
+
+  // Split the leaf. The new right sibling is fully built before it becomes
+  // reachable through the left node's next pointer.
+  uint64_t prefixes[kBTreeFanout + 1];
+  const char* keys[kBTreeFanout + 1];
+  for (uint32_t i = 0, j = 0; i <= kBTreeFanout; ++i) {
+    if (i == idx) {
+      prefixes[i] = t.prefix;
+      keys[i] = key;
+    } else {
+      prefixes[i] = node->prefixes[j].load(std::memory_order_relaxed);
+      keys[i] = node->keys[j].load(std::memory_order_relaxed);
+      ++j;
+    }
+  }
+  const uint32_t left_count = (kBTreeFanout + 1) / 2;
+  Node* right = NewLeaf();
+  for (uint32_t i = left_count; i <= kBTreeFanout; ++i) {
+    SetEntry(right, i - left_count, prefixes[i], keys[i]);
+  }
+  right->count.store(kBTreeFanout + 1 - left_count, std::memory_order_relaxed);
+  right->next.store(node->next.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+  right->high_key.store(node->high_key.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+  right->high_prefix.store(node->high_prefix.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+
+  BeginWrite(node);
+  for (uint32_t i = 0; i < left_count; ++i) {
+    SetEntry(node, i, prefixes[i], keys[i]);
+  }
+  node->count.store(left_count, std::memory_order_release);
+  node->high_key.store(keys[left_count], std::memory_order_release);
+  node->high_prefix.store(prefixes[left_count], std::memory_order_relaxed);
+  node->next.store(right, std::memory_order_release);
+  EndWrite(node);
+
+  // Propagate the separator upwards, splitting full inner nodes.
+  uint64_t sep_prefix = prefixes[left_count];
+  const char* sep = keys[left_count];
+  Node* new_child = right;
+  while (!path.empty()) {
+    InnerNode* parent = path.back().first;
+    const uint32_t c = path.back().second;
+    path.pop_back();
+    const uint32_t pcount = parent->count.load(std::memory_order_relaxed);
+    if (pcount < kBTreeFanout) {
+      BeginWrite(parent);
+      for (uint32_t i = pcount; i > c; --i) {
+        SetEntry(parent, i,
+                 parent->prefixes[i - 1].load(std::memory_order_relaxed),
+                 parent->keys[i - 1].load(std::memory_order_relaxed));
+        parent->children[i + 1].store(
+            parent->children[i].load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+      }
+      SetEntry(parent, c, sep_prefix, sep);
+      parent->children[c + 1].store(new_child, std::memory_order_relaxed);
+      parent->count.store(pcount + 1, std::memory_order_release);
+      EndWrite(parent);
+      return true;
+    }
+
+    uint64_t seps_prefix[kBTreeFanout + 1];
+    const char* seps[kBTreeFanout + 1];
+    Node* children[kBTreeFanout + 2];
+    for (uint32_t i = 0, j = 0; i <= kBTreeFanout; ++i) {
+      if (i == c) {
+        seps_prefix[i] = sep_prefix;
+        seps[i] = sep;
+      } else {
+        seps_prefix[i] = parent->prefixes[j].load(std::memory_order_relaxed);
+        seps[i] = parent->keys[j].load(std::memory_order_relaxed);
+        ++j;
+      }
+    }
+    for (uint32_t i = 0, j = 0; i <= kBTreeFanout + 1; ++i) {
+      if (i == c + 1) {
+        children[i] = new_child;
+      } else {
+        children[i] = parent->children[j].load(std::memory_order_relaxed);
+        ++j;
+      }
+    }
+    // seps[mid] moves up; the left node keeps seps[0, mid) and the right
+    // node takes seps(mid, kBTreeFanout].
+    const uint32_t mid = (kBTreeFanout + 1) / 2;
+    InnerNode* right_inner = NewInnerNode();
+    for (uint32_t i = mid + 1; i <= kBTreeFanout; ++i) {
+      SetEntry(right_inner, i - mid - 1, seps_prefix[i], seps[i]);
+    }
+    for (uint32_t i = mid + 1; i <= kBTreeFanout + 1; ++i) {
+      right_inner->children[i - mid - 1].store(children[i],
+                                               std::memory_order_relaxed);
+    }
+    right_inner->count.store(kBTreeFanout - mid, std::memory_order_relaxed);
+    right_inner->next.store(parent->next.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+    right_inner->high_key.store(
+        parent->high_key.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    right_inner->high_prefix.store(
+        parent->high_prefix.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+
+    BeginWrite(parent);
+    for (uint32_t i = 0; i < mid; ++i) {
+      SetEntry(parent, i, seps_prefix[i], seps[i]);
+    }
+    for (uint32_t i = 0; i <= mid; ++i) {
+      parent->children[i].store(children[i], std::memory_order_relaxed);
+    }
+    parent->count.store(mid, std::memory_order_release);
+    parent->high_key.store(seps[mid], std::memory_order_release);
+    parent->high_prefix.store(seps_prefix[mid], std::memory_order_relaxed);
+    parent->next.store(right_inner, std::memory_order_release);
+    EndWrite(parent);
+
+    sep_prefix = seps_prefix[mid];
+    sep = seps[mid];
+    new_child = right_inner;
+  }
+
+  // The root split; grow the tree by one level.
+  InnerNode* new_root = NewInnerNode();
+  SetEntry(new_root, 0, sep_prefix, sep);
+  new_root->children[0].store(root_.load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+  new_root->children[1].store(new_child, std::memory_order_relaxed);
+  new_root->count.store(1, std::memory_order_relaxed);
+  root_.store(new_root, std::memory_order_release);
+  return true;
+}
+
+}  // namespace
+
+MemTableRep* BTreeRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* /*transform*/, Logger* /*logger*/) {
+  return new BTreeRep(compare, allocator);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
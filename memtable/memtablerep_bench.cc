@@ -49,6 +49,9 @@ DEFINE_string(benchmarks, "fillrandom",
               "\tfillseq                -- write N values in sequential order\n"
               "\treadrandom             -- read N values in random order\n"
               "\treadseq                -- scan the DB\n"
+              "\tseekrandom             -- N random seeks, each followed by "
+              "--seek_nexts\n"
+              "\t                          calls to Next()\n"
               "\treadwrite              -- 1 thread writes while N - 1 threads "
               "do random\n"
               "\t                          reads\n"
@@ -61,6 +64,7 @@ DEFINE_string(memtablerep, "skiplist",
               "  more details. Options:\n"
               "\tskiplist            -- backed by a skiplist\n"
               "\tvector              -- backed by an std::vector\n"
+              "\tbtree               -- backed by a cache-conscious B+-tree\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
               "\tcuckoo              -- backed by a cuckoo hash table");
@@ -111,6 +115,9 @@ DEFINE_int32(num_scans, 10,
 
 DEFINE_int32(item_size, 100, "Number of bytes each item should be");
 
+DEFINE_int32(seek_nexts, 0,
+             "How many times to call Next() after each Seek() in seekrandom");
+
 DEFINE_int32(prefix_length, 8,
              "Prefix length to pass into NewFixedPrefixTransform");
 
@@ -332,6 +339,39 @@ class ReadBenchmarkThread : public BenchmarkThread {
   }
 };
 
+class SeekBenchmarkThread : public BenchmarkThread {
+ public:
+  SeekBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                      uint64_t* bytes_written, uint64_t* bytes_read,
+                      uint64_t* sequence, uint64_t num_ops, uint64_t* read_hits)
+      : BenchmarkThread(table, key_gen, bytes_written, bytes_read, sequence,
+                        num_ops, read_hits) {}
+
+  void SeekOne(MemTableRep::Iterator* iter) {
+    std::string user_key;
+    auto key = key_gen_->Next();
+    PutFixed64(&user_key, key);
+    LookupKey lookup_key(user_key, *sequence_);
+    iter->Seek(lookup_key.internal_key(), lookup_key.memtable_key().data());
+    if (!iter->Valid()) {
+      return;
+    }
+    ++*read_hits_;
+    *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+    for (int i = 0; i < FLAGS_seek_nexts && iter->Valid(); ++i) {
+      iter->Next();
+      *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+    }
+  }
+
+  void operator()() override {
+    std::unique_ptr<MemTableRep::Iterator> iter(table_->GetIterator());
+    for (unsigned int i = 0; i < num_ops_; ++i) {
+      SeekOne(iter.get());
+    }
+  }
+};
+
 class SeqReadBenchmarkThread : public BenchmarkThread {
  public:
   SeqReadBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
@@ -502,6 +542,31 @@ class ReadBenchmark : public Benchmark {
   }
 };
 
+class SeekBenchmark : public Benchmark {
+ public:
+  explicit SeekBenchmark(MemTableRep* table, KeyGenerator* key_gen,
+                         uint64_t* sequence)
+      : Benchmark(table, key_gen, sequence, FLAGS_num_threads) {
+    num_read_ops_per_thread_ = FLAGS_num_operations / FLAGS_num_threads;
+  }
+
+  void RunThreads(std::vector<port::Thread>* threads, uint64_t* bytes_written,
+                  uint64_t* bytes_read, bool /*write*/,
+                  uint64_t* read_hits) override {
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      threads->emplace_back(
+          SeekBenchmarkThread(table_, key_gen_, bytes_written, bytes_read,
+                              sequence_, num_read_ops_per_thread_, read_hits));
+    }
+    for (auto& thread : *threads) {
+      thread.join();
+    }
+    std::cout << "seek hit%: "
+              << (static_cast<double>(*read_hits) / FLAGS_num_operations) * 100
+              << std::endl;
+  }
+};
+
 class SeqReadBenchmark : public Benchmark {
  public:
   explicit SeqReadBenchmark(MemTableRep* table, uint64_t* sequence)
@@ -583,6 +648,8 @@ int main(int argc, char** argv) {
     factory.reset(new ROCKSDB_NAMESPACE::SkipListFactory);
   } else if (FLAGS_memtablerep == "vector") {
     factory.reset(new ROCKSDB_NAMESPACE::VectorRepFactory);
+  } else if (FLAGS_memtablerep == "btree") {
+    factory.reset(new ROCKSDB_NAMESPACE::BTreeRepFactory);
   } else if (FLAGS_memtablerep == "hashskiplist" ||
              FLAGS_memtablerep == "prefix_hash") {
     factory.reset(ROCKSDB_NAMESPACE::NewHashSkipListRepFactory(
@@ -655,6 +722,11 @@ int main(int argc, char** argv) {
           &rng, ROCKSDB_NAMESPACE::RANDOM, FLAGS_num_operations));
       benchmark.reset(new ROCKSDB_NAMESPACE::ReadBenchmark(
           memtablerep.get(), key_gen.get(), &sequence));
+    } else if (name == ROCKSDB_NAMESPACE::Slice("seekrandom")) {
+      key_gen.reset(new ROCKSDB_NAMESPACE::KeyGenerator(
+          &rng, ROCKSDB_NAMESPACE::RANDOM, FLAGS_num_operations));
+      benchmark.reset(new ROCKSDB_NAMESPACE::SeekBenchmark(
+          memtablerep.get(), key_gen.get(), &sequence));
     } else if (name == ROCKSDB_NAMESPACE::Slice("readseq")) {
       key_gen.reset(new ROCKSDB_NAMESPACE::KeyGenerator(
           &rng, ROCKSDB_NAMESPACE::SEQUENTIAL, FLAGS_num_operations));
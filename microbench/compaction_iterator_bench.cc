@@ -0,0 +1,103 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Micro-benchmark of CompactionIterator over in-memory input, comparing the
+// per-key path with batched input (compaction_iterator_batch_size).
+#include "benchmark/benchmark.h"
+#include "db/compaction/compaction_iterator.h"
+#include "db/dbformat.h"
+#include "db/merge_helper.h"
+#include "db/range_del_aggregator.h"
+#include "rocksdb/env.h"
+#include "util/random.h"
+#include "util/vector_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// benchmark arguments:
+// 0. input batch size (0 for the per-key path)
+// 1. versions per user key
+// 2. number of snapshots
+static void CustomArguments(benchmark::internal::Benchmark *b) {
+  for (int64_t batch_size : {0, 16, 256}) {
+    for (int64_t versions_per_key : {1, 4}) {
+      for (int64_t num_snapshots : {0, 8}) {
+        b->Args({batch_size, versions_per_key, num_snapshots});
+      }
+    }
+  }
+  b->ArgNames({"batch_size", "versions_per_key", "num_snapshots"});
+}
+
+static void CompactionIteratorScan(benchmark::State &state) {
+  const size_t batch_size = static_cast<size_t>(state.range(0));
+  const int versions_per_key = static_cast<int>(state.range(1));
+  const int num_snapshots = static_cast<int>(state.range(2));
+  constexpr int kNumEntries = 1 << 18;
+
+  // setup data
+  const Comparator *ucmp = BytewiseComparator();
+  InternalKeyComparator icmp(ucmp);
+  Random rnd(301);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  keys.reserve(kNumEntries);
+  values.reserve(kNumEntries);
+  char user_key[20];
+  for (int i = 0; i < kNumEntries; ++i) {
+    snprintf(user_key, sizeof(user_key), "%016d", i / versions_per_key);
+    // Newer versions of a user key first
+    const SequenceNumber seq = static_cast<SequenceNumber>(kNumEntries - i);
+    const ValueType type = rnd.OneIn(8) ? kTypeDeletion : kTypeValue;
+    keys.push_back(InternalKey(user_key, seq, type).Encode().ToString());
+    values.push_back(type == kTypeDeletion ? "" : rnd.RandomString(64));
+  }
+  std::vector<SequenceNumber> snapshots;
+  for (int i = 1; i <= num_snapshots; ++i) {
+    snapshots.push_back(static_cast<SequenceNumber>(
+        uint64_t{kNumEntries} * i / (num_snapshots + 1)));
+  }
+  const SequenceNumber earliest_snapshot =
+      snapshots.empty() ? kMaxSequenceNumber : snapshots[0];
+  VectorIterator input(std::move(keys), std::move(values), &icmp);
+  const std::atomic<bool> manual_compaction_canceled{false};
+
+  uint64_t num_output = 0;
+  for (auto _ : state) {
+    input.SeekToFirst();
+    MergeHelper merge(Env::Default(), ucmp, nullptr /* merge_op */,
+                      nullptr /* filter */, nullptr /* logger */, false,
+                      kMaxSequenceNumber);
+    CompactionRangeDelAggregator range_del_agg(&icmp, snapshots);
+    CompactionIterator c_iter(
+        &input, ucmp, &merge, kMaxSequenceNumber, &snapshots,
+        earliest_snapshot, kMaxSequenceNumber, kMaxSequenceNumber,
+        nullptr /* snapshot_checker */, Env::Default(),
+        false /* report_detailed_time */, &range_del_agg,
+        nullptr /* blob_file_builder */, false /* allow_data_in_errors */,
+        true /* enforce_single_del_contracts */, manual_compaction_canceled,
+        false /* must_count_input_entries */, nullptr /* compaction */,
+        nullptr /* compaction_filter */, nullptr /* shutting_down */,
+        nullptr /* info_log */, nullptr /* full_history_ts_low */,
+        {} /* preserve_seqno_min */, batch_size);
+    for (c_iter.SeekToFirst(); c_iter.Valid(); c_iter.Next()) {
+      benchmark::DoNotOptimize(c_iter.value());
+      ++num_output;
+    }
+    if (!c_iter.status().ok()) {
+      state.SkipWithError(c_iter.status().ToString().c_str());
+      break;
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          kNumEntries);
+  state.counters["output_entries"] = benchmark::Counter(
+      static_cast<double>(num_output), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(CompactionIteratorScan)->Apply(CustomArguments);
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
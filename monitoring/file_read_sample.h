@@ -20,4 +20,15 @@ inline void sample_file_read_inc(FileMetaData* meta) {
   meta->stats.num_reads_sampled.fetch_add(kFileReadSampleRate,
                                           std::memory_order_relaxed);
 }
+
+// Records a sampled point lookup that found no entry for the key in the file,
+// and whether a filter stopped it before the data was read.
+inline void sample_file_read_miss_inc(FileMetaData* meta, bool filtered) {
+  meta->stats.num_misses_sampled.fetch_add(kFileReadSampleRate,
+                                           std::memory_order_relaxed);
+  if (!filtered) {
+    meta->stats.num_false_positives_sampled.fetch_add(
+        kFileReadSampleRate, std::memory_order_relaxed);
+  }
+}
 }  // namespace ROCKSDB_NAMESPACE
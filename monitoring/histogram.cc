@@ -241,6 +241,159 @@ void HistogramStat::Data(HistogramData* const data) const {
   data->min = static_cast<double>(min());
 }
 
+void CoreLocalHistogram::Clear() {
+  min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  sum_squares_.store(0, std::memory_order_relaxed);
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+void CoreLocalHistogram::Add(uint64_t value) {
+  // Like HistogramStat::Add(), this is lock free and only does relaxed loads
+  // and stores, as it's in the critical path of any operation. Each
+  // individual value is atomic, and the rare update lost to another thread
+  // adding to the same part at the same time is tolerable.
+  auto& bucket = buckets_[LogLinearBucketMapper::IndexForValue(value)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+
+  if (value < min_.load(std::memory_order_relaxed)) {
+    min_.store(value, std::memory_order_relaxed);
+  }
+  if (value > max_.load(std::memory_order_relaxed)) {
+    max_.store(value, std::memory_order_relaxed);
+  }
+
+  sum_.store(sum_.load(std::memory_order_relaxed) + value,
+             std::memory_order_relaxed);
+  sum_squares_.store(
+      sum_squares_.load(std::memory_order_relaxed) + value * value,
+      std::memory_order_relaxed);
+}
+
+void HistogramSnapshot::Merge(const CoreLocalHistogram& part) {
+  for (size_t b = 0; b < LogLinearBucketMapper::kBucketCount; ++b) {
+    const uint64_t count = part.buckets_[b].load(std::memory_order_relaxed);
+    buckets_[b] += count;
+    num_ += count;
+  }
+  min_ = std::min(min_, part.min_.load(std::memory_order_relaxed));
+  max_ = std::max(max_, part.max_.load(std::memory_order_relaxed));
+  sum_ += part.sum_.load(std::memory_order_relaxed);
+  sum_squares_ += part.sum_squares_.load(std::memory_order_relaxed);
+}
+
+double HistogramSnapshot::Percentile(double p) const {
+  const double threshold = num_ * (p / 100.0);
+  uint64_t cumulative_sum = 0;
+  for (size_t b = 0; b < LogLinearBucketMapper::kBucketCount; ++b) {
+    const uint64_t bucket_value = buckets_[b];
+    cumulative_sum += bucket_value;
+    if (cumulative_sum >= threshold) {
+      // Scale linearly within this bucket, whose values are assumed to be
+      // spread evenly over [left_point, right_point).
+      const double left_point =
+          static_cast<double>(LogLinearBucketMapper::BucketLowerBound(b));
+      const double right_point =
+          static_cast<double>(LogLinearBucketMapper::BucketUpperBound(b)) +
+          1.0;
+      const uint64_t left_sum = cumulative_sum - bucket_value;
+      double pos = 0;
+      if (bucket_value != 0) {
+        pos = (threshold - left_sum) / bucket_value;
+      }
+      double r = left_point + (right_point - left_point) * pos;
+      // Values recorded concurrently with the snapshot may be missing from
+      // min_ or max_.
+      r = std::max(r, static_cast<double>(min()));
+      r = std::min(r, static_cast<double>(max_));
+      return r;
+    }
+  }
+  return static_cast<double>(max_);
+}
+
+double HistogramSnapshot::Average() const {
+  if (num_ == 0) {
+    return 0;
+  }
+  return static_cast<double>(sum_) / static_cast<double>(num_);
+}
+
+double HistogramSnapshot::StandardDeviation() const {
+  // Use double to avoid integer overflow
+  const double cur_num = static_cast<double>(num_);
+  const double cur_sum = static_cast<double>(sum_);
+  const double cur_sum_squares = static_cast<double>(sum_squares_);
+  if (cur_num == 0.0) {
+    return 0.0;
+  }
+  const double variance =
+      (cur_sum_squares * cur_num - cur_sum * cur_sum) / (cur_num * cur_num);
+  return std::sqrt(std::max(variance, 0.0));
+}
+
+void HistogramSnapshot::Data(HistogramData* const data) const {
+  assert(data);
+  data->median = Median();
+  data->percentile95 = Percentile(95);
+  data->percentile99 = Percentile(99);
+  data->max = static_cast<double>(max_);
+  data->average = Average();
+  data->standard_deviation = StandardDeviation();
+  data->count = num_;
+  data->sum = sum_;
+  data->min = static_cast<double>(min());
+}
+
+std::string HistogramSnapshot::ToString() const {
+  std::string r;
+  char buf[1650];
+  snprintf(buf, sizeof(buf), "Count: %" PRIu64 " Average: %.4f  StdDev: %.2f\n",
+           num_, Average(), StandardDeviation());
+  r.append(buf);
+  snprintf(buf, sizeof(buf),
+           "Min: %" PRIu64 "  Median: %.4f  Max: %" PRIu64 "\n", min(),
+           Median(), max_);
+  r.append(buf);
+  snprintf(buf, sizeof(buf),
+           "Percentiles: "
+           "P50: %.2f P75: %.2f P99: %.2f P99.9: %.2f P99.99: %.2f\n",
+           Percentile(50), Percentile(75), Percentile(99), Percentile(99.9),
+           Percentile(99.99));
+  r.append(buf);
+  r.append("------------------------------------------------------\n");
+  if (num_ == 0) {
+    return r;  // all buckets are empty
+  }
+  const double mult = 100.0 / num_;
+  uint64_t cumulative_sum = 0;
+  for (size_t b = 0; b < LogLinearBucketMapper::kBucketCount; ++b) {
+    const uint64_t bucket_value = buckets_[b];
+    if (bucket_value == 0) {
+      continue;
+    }
+    cumulative_sum += bucket_value;
+    snprintf(buf, sizeof(buf),
+             "[ %7" PRIu64 ", %7" PRIu64 " ] %8" PRIu64 " %7.3f%% %7.3f%% ",
+             LogLinearBucketMapper::BucketLowerBound(b),  // left
+             LogLinearBucketMapper::BucketUpperBound(b),  // right
+             bucket_value,                                // count
+             (mult * bucket_value),                       // percentage
+             (mult * cumulative_sum));  // cumulative percentage
+    r.append(buf);
+
+    // Add hash marks based on percentage; 20 marks for 100%.
+    size_t marks = static_cast<size_t>(mult * bucket_value / 5 + 0.5);
+    r.append(marks, '#');
+    r.push_back('\n');
+  }
+  return r;
+}
+
 void HistogramImpl::Clear() {
   std::lock_guard<std::mutex> lock(mutex_);
   stats_.Clear();
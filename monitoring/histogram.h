@@ -8,13 +8,16 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #pragma once
+#include <atomic>
 #include <cassert>
+#include <limits>
 #include <map>
 #include <mutex>
 #include <string>
 #include <vector>
 
 #include "rocksdb/statistics.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -85,6 +88,109 @@ struct HistogramStat {
   const uint64_t num_buckets_;
 };
 
+// LogLinearBucketMapper is the bucket layout of the histograms kept by
+// StatisticsImpl. As in HdrHistogram, each value below kSubBuckets has a
+// bucket of its own, and each larger range [2^e, 2^(e+1)) is split into
+// kSubBuckets buckets of equal width. A bucket is then at most half of its
+// lower bound wide, like the buckets of HistogramBucketMapper that grow by
+// half, but the bucket of a value is found with a few bit operations instead
+// of a binary search. More sub-buckets did not make Add() any faster, only
+// the per-core histograms larger, so there are two. To keep the per-core
+// histograms compact, values of 2^kMaxValueBits and more (200 days in
+// microseconds, 16TB in bytes) share the last bucket.
+class LogLinearBucketMapper {
+ public:
+  static constexpr int kSubBucketBits = 1;
+  static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+  static constexpr int kMaxValueBits = 44;
+  static constexpr size_t kBucketCount =
+      kSubBuckets * (kMaxValueBits - kSubBucketBits + 1);
+
+  static size_t IndexForValue(uint64_t value) {
+    if (value < kSubBuckets) {
+      return static_cast<size_t>(value);
+    }
+    if (value >> kMaxValueBits) {
+      return kBucketCount - 1;
+    }
+    const int shift = FloorLog2(value) - kSubBucketBits;
+    return (static_cast<size_t>(shift + 1) << kSubBucketBits) +
+           static_cast<size_t>((value >> shift) & (kSubBuckets - 1));
+  }
+
+  // The smallest value in bucket `index`
+  static uint64_t BucketLowerBound(size_t index) {
+    assert(index < kBucketCount);
+    if (index < kSubBuckets) {
+      return index;
+    }
+    const int shift = static_cast<int>(index >> kSubBucketBits) - 1;
+    return (kSubBuckets + (index & (kSubBuckets - 1))) << shift;
+  }
+
+  // The largest value in bucket `index`
+  static uint64_t BucketUpperBound(size_t index) {
+    assert(index < kBucketCount);
+    return index + 1 < kBucketCount ? BucketLowerBound(index + 1) - 1
+                                    : std::numeric_limits<uint64_t>::max();
+  }
+};
+
+// CoreLocalHistogram is the part of a histogram of StatisticsImpl recorded on
+// one core. Add() only updates its counters with relaxed atomic loads and stores and
+// never blocks; readers merge the parts of all cores into a HistogramSnapshot
+// while values keep being added. The number of values is not counted on its
+// own but derived from the buckets, so that it always agrees with them.
+struct CoreLocalHistogram {
+  CoreLocalHistogram() { Clear(); }
+
+  CoreLocalHistogram(const CoreLocalHistogram&) = delete;
+  CoreLocalHistogram& operator=(const CoreLocalHistogram&) = delete;
+
+  // Not atomic with respect to concurrent Add()s
+  void Clear();
+  void Add(uint64_t value);
+
+  std::atomic<uint64_t> min_;
+  std::atomic<uint64_t> max_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> sum_squares_;
+  std::atomic<uint64_t> buckets_[LogLinearBucketMapper::kBucketCount];
+};
+
+// HistogramSnapshot aggregates CoreLocalHistograms into plain counters, from
+// which the statistics are then computed without further synchronization.
+class HistogramSnapshot {
+ public:
+  HistogramSnapshot() = default;
+
+  void Merge(const CoreLocalHistogram& part);
+
+  uint64_t num() const { return num_; }
+  uint64_t min() const { return num_ == 0 ? 0 : min_; }
+  uint64_t max() const { return max_; }
+  uint64_t sum() const { return sum_; }
+  uint64_t bucket_at(size_t b) const {
+    assert(b < LogLinearBucketMapper::kBucketCount);
+    return buckets_[b];
+  }
+
+  double Median() const { return Percentile(50.0); }
+  double Percentile(double p) const;
+  double Average() const;
+  double StandardDeviation() const;
+  void Data(HistogramData* const data) const;
+  std::string ToString() const;
+
+ private:
+  uint64_t num_ = 0;
+  uint64_t min_ = std::numeric_limits<uint64_t>::max();
+  uint64_t max_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t sum_squares_ = 0;
+  uint64_t buckets_[LogLinearBucketMapper::kBucketCount] = {};
+};
+
 class Histogram {
  public:
   Histogram() {}
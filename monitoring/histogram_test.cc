@@ -245,6 +245,89 @@ TEST_F(HistogramTest, LostUpdateStandardDeviation) {
   ASSERT_GE(histogram.StandardDeviation(), 0.0);
 }
 
+TEST_F(HistogramTest, LogLinearBucketMapper) {
+  using Mapper = LogLinearBucketMapper;
+
+  // The buckets cover all values without gaps.
+  ASSERT_EQ(Mapper::BucketLowerBound(0), 0);
+  for (size_t b = 0; b < Mapper::kBucketCount; ++b) {
+    const uint64_t lower = Mapper::BucketLowerBound(b);
+    const uint64_t upper = Mapper::BucketUpperBound(b);
+    ASSERT_LE(lower, upper);
+    ASSERT_EQ(Mapper::IndexForValue(lower), b);
+    ASSERT_EQ(Mapper::IndexForValue(upper), b);
+    if (b > 0) {
+      ASSERT_EQ(Mapper::BucketUpperBound(b - 1) + 1, lower);
+    }
+    // Up to the last one, buckets are at most half of their lower bound
+    // wide.
+    if (lower >= Mapper::kSubBuckets && b + 1 < Mapper::kBucketCount) {
+      ASSERT_LE(upper - lower + 1, lower / 2);
+    }
+  }
+  ASSERT_EQ(Mapper::BucketUpperBound(Mapper::kBucketCount - 1),
+            std::numeric_limits<uint64_t>::max());
+
+  ASSERT_EQ(Mapper::IndexForValue(3), 3);
+  ASSERT_EQ(Mapper::IndexForValue(4), 4);
+  ASSERT_EQ(Mapper::IndexForValue(5), 4);
+  ASSERT_EQ(Mapper::BucketLowerBound(8), 16);
+  ASSERT_EQ(Mapper::BucketUpperBound(8), 23);
+  ASSERT_EQ(Mapper::IndexForValue(768), Mapper::IndexForValue(1023));
+  ASSERT_NE(Mapper::IndexForValue(767), Mapper::IndexForValue(768));
+  ASSERT_NE(Mapper::IndexForValue(1023), Mapper::IndexForValue(1024));
+  ASSERT_EQ(Mapper::IndexForValue(uint64_t{1} << Mapper::kMaxValueBits),
+            Mapper::kBucketCount - 1);
+}
+
+TEST_F(HistogramTest, HistogramSnapshot) {
+  // Values 1 to 110 spread over two cores
+  CoreLocalHistogram parts[2];
+  for (uint64_t i = 1; i <= 110; ++i) {
+    parts[i % 2].Add(i);
+  }
+
+  HistogramSnapshot snapshot;
+  for (const auto& part : parts) {
+    snapshot.Merge(part);
+  }
+
+  HistogramData data;
+  snapshot.Data(&data);
+  ASSERT_EQ(data.count, 110);
+  ASSERT_EQ(data.sum, 110 * 111 / 2);
+  ASSERT_EQ(data.min, 1);
+  ASSERT_EQ(data.max, 110);
+  ASSERT_EQ(data.average, 55.5);
+  ASSERT_LT(fabs(data.standard_deviation - 31.75), kIota);
+  // Within a bucket, values are assumed to be spread evenly, each value v
+  // covering [v, v + 1). This holds for the full buckets [48, 63] of the
+  // median and [64, 95] of P75, but only 15 of the 32 values of [96, 127]
+  // were added, so the higher percentiles are overestimated and then capped
+  // by the maximum.
+  ASSERT_LE(fabs(data.median - 56.0), kIota);
+  ASSERT_LE(fabs(snapshot.Percentile(75.0) - 83.5), kIota);
+  ASSERT_LE(fabs(data.percentile95 - 110.0), kIota);
+  ASSERT_LE(fabs(data.percentile99 - 110.0), kIota);
+  ASSERT_LE(fabs(snapshot.Percentile(100.0) - 110.0), kIota);
+  ASSERT_NE(snapshot.ToString().find("[      96,     127 ]       15"),
+            std::string::npos);
+
+  // Snapshots do not change with the histograms.
+  parts[0].Clear();
+  parts[1].Add(1000);
+  ASSERT_EQ(snapshot.num(), 110);
+  ASSERT_EQ(snapshot.max(), 110);
+
+  HistogramSnapshot empty;
+  empty.Data(&data);
+  ASSERT_EQ(data.count, 0);
+  ASSERT_EQ(data.min, 0);
+  ASSERT_EQ(data.max, 0);
+  ASSERT_EQ(data.median, 0);
+  ASSERT_EQ(data.average, 0);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -155,7 +155,9 @@ struct PerfContextByLevelInt {
   defCmd(decrypt_data_nanos)                       \
   defCmd(number_async_seek)                        \
   defCmd(file_ingestion_nanos)                     \
-  defCmd(file_ingestion_blocking_live_writes_nanos)
+  defCmd(file_ingestion_blocking_live_writes_nanos) \
+  defCmd(prefetch_bytes)                           \
+  defCmd(prefetch_bytes_wasted)
 // clang-format on
 
 struct PerfContextInt {
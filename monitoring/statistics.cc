@@ -273,6 +273,10 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT,
      "rocksdb.file.read.corruption.retry.success.count"},
     {NUMBER_WBWI_INGEST, "rocksdb.number.wbwi.ingest"},
+    {BLOB_FILE_GC_NUM_FILES, "rocksdb.blob.file.gc.num.files"},
+    {BLOB_FILE_GC_BYTES_READ, "rocksdb.blob.file.gc.bytes.read"},
+    {BLOB_FILE_GC_BYTES_WRITTEN, "rocksdb.blob.file.gc.bytes.written"},
+    {BLOB_FILE_GC_BYTES_RECLAIMED, "rocksdb.blob.file.gc.bytes.reclaimed"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -345,6 +349,14 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
      "rocksdb.table.open.prefetch.tail.read.bytes"},
     {NUM_OP_PER_TRANSACTION, "rocksdb.num.op.per.transaction"},
+    {SCHEDULER_QUEUE_DELAY_BOTTOM_MICROS,
+     "rocksdb.scheduler.queue.delay.bottom.micros"},
+    {SCHEDULER_QUEUE_DELAY_LOW_MICROS,
+     "rocksdb.scheduler.queue.delay.low.micros"},
+    {SCHEDULER_QUEUE_DELAY_HIGH_MICROS,
+     "rocksdb.scheduler.queue.delay.high.micros"},
+    {SCHEDULER_QUEUE_DELAY_USER_MICROS,
+     "rocksdb.scheduler.queue.delay.user.micros"},
 };
 
 std::shared_ptr<Statistics> CreateDBStatistics() {
@@ -395,11 +407,6 @@ StatisticsImpl::StatisticsImpl(std::shared_ptr<Statistics> stats)
 StatisticsImpl::~StatisticsImpl() = default;
 
 uint64_t StatisticsImpl::getTickerCount(uint32_t tickerType) const {
-  MutexLock lock(&aggregate_lock_);
-  return getTickerCountLocked(tickerType);
-}
-
-uint64_t StatisticsImpl::getTickerCountLocked(uint32_t tickerType) const {
   assert(tickerType < TICKER_ENUM_MAX);
   uint64_t res = 0;
   for (size_t core_idx = 0; core_idx < per_core_stats_.Size(); ++core_idx) {
@@ -410,24 +417,25 @@ uint64_t StatisticsImpl::getTickerCountLocked(uint32_t tickerType) const {
 
 void StatisticsImpl::histogramData(uint32_t histogramType,
                                    HistogramData* const data) const {
-  MutexLock lock(&aggregate_lock_);
-  getHistogramImplLocked(histogramType)->Data(data);
+  HistogramSnapshot snapshot;
+  getHistogramSnapshot(histogramType, &snapshot);
+  snapshot.Data(data);
 }
 
-std::unique_ptr<HistogramImpl> StatisticsImpl::getHistogramImplLocked(
-    uint32_t histogramType) const {
+void StatisticsImpl::getHistogramSnapshot(uint32_t histogramType,
+                                          HistogramSnapshot* snapshot) const {
   assert(histogramType < HISTOGRAM_ENUM_MAX);
-  std::unique_ptr<HistogramImpl> res_hist(new HistogramImpl());
+  assert(snapshot);
   for (size_t core_idx = 0; core_idx < per_core_stats_.Size(); ++core_idx) {
-    res_hist->Merge(
+    snapshot->Merge(
         per_core_stats_.AccessAtCore(core_idx)->histograms_[histogramType]);
   }
-  return res_hist;
 }
 
 std::string StatisticsImpl::getHistogramString(uint32_t histogramType) const {
-  MutexLock lock(&aggregate_lock_);
-  return getHistogramImplLocked(histogramType)->ToString();
+  HistogramSnapshot snapshot;
+  getHistogramSnapshot(histogramType, &snapshot);
+  return snapshot.ToString();
 }
 
 void StatisticsImpl::setTickerCount(uint32_t tickerType, uint64_t count) {
@@ -515,21 +523,20 @@ const int kTmpStrBufferSize = 200;
 }  // namespace
 
 std::string StatisticsImpl::ToString() const {
-  MutexLock lock(&aggregate_lock_);
   std::string res;
   res.reserve(20000);
   for (const auto& t : TickersNameMap) {
     assert(t.first < TICKER_ENUM_MAX);
     char buffer[kTmpStrBufferSize];
     snprintf(buffer, kTmpStrBufferSize, "%s COUNT : %" PRIu64 "\n",
-             t.second.c_str(), getTickerCountLocked(t.first));
+             t.second.c_str(), getTickerCount(t.first));
     res.append(buffer);
   }
   for (const auto& h : HistogramsNameMap) {
     assert(h.first < HISTOGRAM_ENUM_MAX);
     char buffer[kTmpStrBufferSize];
     HistogramData hData;
-    getHistogramImplLocked(h.first)->Data(&hData);
+    histogramData(h.first, &hData);
     // don't handle failures - buffer should always be big enough and arguments
     // should be provided correctly
     int ret =
@@ -555,10 +562,9 @@ bool StatisticsImpl::getTickerMap(
     return false;
   }
   stats_map->clear();
-  MutexLock lock(&aggregate_lock_);
   for (const auto& t : TickersNameMap) {
     assert(t.first < TICKER_ENUM_MAX);
-    (*stats_map)[t.second.c_str()] = getTickerCountLocked(t.first);
+    (*stats_map)[t.second.c_str()] = getTickerCount(t.first);
   }
   return true;
 }
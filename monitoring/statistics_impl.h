@@ -73,9 +73,11 @@ class StatisticsImpl : public Statistics {
  private:
   // If non-nullptr, forwards updates to the object pointed to by `stats_`.
   std::shared_ptr<Statistics> stats_;
-  // Synchronizes anything that operates across other cores' local data,
-  // such that operations like Reset() can be performed atomically.
-  mutable port::Mutex aggregate_lock_;
+  // Synchronizes anything that writes across other cores' local data, such
+  // that operations like Reset() can be performed atomically. Readers sum up
+  // the per-core data without it, so they neither block recorders nor wait
+  // for each other.
+  port::Mutex aggregate_lock_;
 
   // The ticker/histogram data are stored in this structure, which we will store
   // per-core. It is cache-aligned, so tickers/histograms belonging to different
@@ -84,12 +86,12 @@ class StatisticsImpl : public Statistics {
   // Alignment attributes expand to nothing depending on the platform
   struct ALIGN_AS(CACHE_LINE_SIZE) StatisticsData {
     std::atomic_uint_fast64_t tickers_[INTERNAL_TICKER_ENUM_MAX] = {{0}};
-    HistogramImpl histograms_[INTERNAL_HISTOGRAM_ENUM_MAX];
+    CoreLocalHistogram histograms_[INTERNAL_HISTOGRAM_ENUM_MAX];
 #ifndef HAVE_ALIGNED_NEW
     char
         padding[(CACHE_LINE_SIZE -
                  (INTERNAL_TICKER_ENUM_MAX * sizeof(std::atomic_uint_fast64_t) +
-                  INTERNAL_HISTOGRAM_ENUM_MAX * sizeof(HistogramImpl)) %
+                  INTERNAL_HISTOGRAM_ENUM_MAX * sizeof(CoreLocalHistogram)) %
                      CACHE_LINE_SIZE)] ROCKSDB_FIELD_UNUSED;
 #endif
     void* operator new(size_t s) { return port::cacheline_aligned_alloc(s); }
@@ -105,9 +107,8 @@ class StatisticsImpl : public Statistics {
 
   CoreLocalArray<StatisticsData> per_core_stats_;
 
-  uint64_t getTickerCountLocked(uint32_t ticker_type) const;
-  std::unique_ptr<HistogramImpl> getHistogramImplLocked(
-      uint32_t histogram_type) const;
+  void getHistogramSnapshot(uint32_t histogram_type,
+                            HistogramSnapshot* snapshot) const;
   void setTickerCountLocked(uint32_t ticker_type, uint64_t count);
 };
 
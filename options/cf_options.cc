@@ -720,6 +720,14 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, memtable_avg_op_scan_flush_trigger),
           OptionType::kUInt32T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"compaction_iterator_batch_size",
+         {offsetof(struct MutableCFOptions, compaction_iterator_batch_size),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"filter_memory_budget_bits_per_key",
+         {offsetof(struct MutableCFOptions, filter_memory_budget_bits_per_key),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
 };
 
 static std::unordered_map<std::string, OptionTypeInfo>
@@ -1210,6 +1218,10 @@ void MutableCFOptions::Dump(Logger* log) const {
                  memtable_op_scan_flush_trigger);
   ROCKS_LOG_INFO(log, "         memtable_avg_op_scan_flush_trigger: %" PRIu32,
                  memtable_avg_op_scan_flush_trigger);
+  ROCKS_LOG_INFO(log, "             compaction_iterator_batch_size: %" PRIu32,
+                 compaction_iterator_batch_size);
+  ROCKS_LOG_INFO(log, "          filter_memory_budget_bits_per_key: %f",
+                 filter_memory_budget_bits_per_key);
   // Universal Compaction Options
   ROCKS_LOG_INFO(log, "compaction_options_universal.size_ratio : %d",
                  compaction_options_universal.size_ratio);
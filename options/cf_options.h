@@ -179,7 +179,10 @@ struct MutableCFOptions {
         uncache_aggressiveness(options.uncache_aggressiveness),
         memtable_op_scan_flush_trigger(options.memtable_op_scan_flush_trigger),
         memtable_avg_op_scan_flush_trigger(
-            options.memtable_avg_op_scan_flush_trigger) {
+            options.memtable_avg_op_scan_flush_trigger),
+        compaction_iterator_batch_size(options.compaction_iterator_batch_size),
+        filter_memory_budget_bits_per_key(
+            options.filter_memory_budget_bits_per_key) {
     RefreshDerivedOptions(options.num_levels, options.compaction_style);
   }
 
@@ -236,7 +239,9 @@ struct MutableCFOptions {
         bottommost_file_compaction_delay(0),
         uncache_aggressiveness(0),
         memtable_op_scan_flush_trigger(0),
-        memtable_avg_op_scan_flush_trigger(0) {}
+        memtable_avg_op_scan_flush_trigger(0),
+        compaction_iterator_batch_size(0),
+        filter_memory_budget_bits_per_key(0.0) {}
 
   explicit MutableCFOptions(const Options& options);
 
@@ -345,6 +350,8 @@ struct MutableCFOptions {
   uint32_t uncache_aggressiveness;
   uint32_t memtable_op_scan_flush_trigger;
   uint32_t memtable_avg_op_scan_flush_trigger;
+  uint32_t compaction_iterator_batch_size;
+  double filter_memory_budget_bits_per_key;
 
   // Derived options
   // Per-level target file size.
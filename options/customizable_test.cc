@@ -1881,6 +1881,8 @@ TEST_F(LoadCustomizableTest, LoadMemTableRepFactoryTest) {
   std::unordered_set<std::string> expected = {
       SkipListFactory::kClassName(),
       SkipListFactory::kNickName(),
+      BTreeRepFactory::kClassName(),
+      BTreeRepFactory::kNickName(),
   };
 
   std::vector<std::string> failures;
@@ -35,6 +35,7 @@ struct ImmutableDBOptions {
   std::shared_ptr<Logger> info_log;
   InfoLogLevel info_log_level;
   int max_file_opening_threads;
+  int manifest_recovery_threads;
   std::shared_ptr<Statistics> statistics;
   bool use_fsync;
   std::vector<DbPath> db_paths;
@@ -66,7 +67,9 @@ struct ImmutableDBOptions {
   std::vector<std::shared_ptr<EventListener>> listeners;
   bool enable_thread_tracking;
   bool enable_pipelined_write;
+  bool enable_pipelined_wal_sync;
   bool unordered_write;
+  bool core_local_write_staging;
   bool allow_concurrent_memtable_write;
   bool enable_write_thread_adaptive_yield;
   uint64_t write_thread_max_yield_usec;
@@ -79,6 +82,7 @@ struct ImmutableDBOptions {
   WalFilter* wal_filter;
   bool dump_malloc_stats;
   bool avoid_flush_during_recovery;
+  int wal_recovery_threads;
   bool allow_ingest_behind;
   bool two_write_queues;
   bool manual_wal_flush;
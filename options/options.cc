@@ -114,7 +114,10 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       persist_user_defined_timestamps(options.persist_user_defined_timestamps),
       memtable_op_scan_flush_trigger(options.memtable_op_scan_flush_trigger),
       memtable_avg_op_scan_flush_trigger(
-          options.memtable_avg_op_scan_flush_trigger) {
+          options.memtable_avg_op_scan_flush_trigger),
+      compaction_iterator_batch_size(options.compaction_iterator_batch_size),
+      filter_memory_budget_bits_per_key(
+          options.filter_memory_budget_bits_per_key) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
       static_cast<unsigned int>(num_levels)) {
@@ -292,6 +295,12 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "     Options.memtable_avg_op_scan_flush_trigger: %" PRIu32,
                    memtable_avg_op_scan_flush_trigger);
+  ROCKS_LOG_HEADER(log,
+                   "         Options.compaction_iterator_batch_size: %" PRIu32,
+                   compaction_iterator_batch_size);
+  ROCKS_LOG_HEADER(log,
+                   "      Options.filter_memory_budget_bits_per_key: %f",
+                   filter_memory_budget_bits_per_key);
   ROCKS_LOG_HEADER(log,
                    "                   Options.max_compaction_bytes: %" PRIu64,
                    max_compaction_bytes);
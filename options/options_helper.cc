@@ -82,6 +82,8 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.max_open_files = mutable_db_options.max_open_files;
   options.max_file_opening_threads =
       immutable_db_options.max_file_opening_threads;
+  options.manifest_recovery_threads =
+      immutable_db_options.manifest_recovery_threads;
   options.max_total_wal_size = mutable_db_options.max_total_wal_size;
   options.statistics = immutable_db_options.statistics;
   options.use_fsync = immutable_db_options.use_fsync;
@@ -134,7 +136,11 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.enable_thread_tracking = immutable_db_options.enable_thread_tracking;
   options.delayed_write_rate = mutable_db_options.delayed_write_rate;
   options.enable_pipelined_write = immutable_db_options.enable_pipelined_write;
+  options.enable_pipelined_wal_sync =
+      immutable_db_options.enable_pipelined_wal_sync;
   options.unordered_write = immutable_db_options.unordered_write;
+  options.core_local_write_staging =
+      immutable_db_options.core_local_write_staging;
   options.allow_concurrent_memtable_write =
       immutable_db_options.allow_concurrent_memtable_write;
   options.enable_write_thread_adaptive_yield =
@@ -156,6 +162,7 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.dump_malloc_stats = immutable_db_options.dump_malloc_stats;
   options.avoid_flush_during_recovery =
       immutable_db_options.avoid_flush_during_recovery;
+  options.wal_recovery_threads = immutable_db_options.wal_recovery_threads;
   options.avoid_flush_during_shutdown =
       mutable_db_options.avoid_flush_during_shutdown;
   options.allow_ingest_behind = immutable_db_options.allow_ingest_behind;
@@ -304,6 +311,10 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.memtable_op_scan_flush_trigger;
   cf_opts->memtable_avg_op_scan_flush_trigger =
       moptions.memtable_avg_op_scan_flush_trigger;
+  cf_opts->compaction_iterator_batch_size =
+      moptions.compaction_iterator_batch_size;
+  cf_opts->filter_memory_budget_bits_per_key =
+      moptions.filter_memory_budget_bits_per_key;
 }
 
 void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
@@ -185,6 +185,7 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "data_block_index_type=kDataBlockBinaryAndHash;"
       "index_shortening=kNoShortening;"
       "data_block_hash_table_util_ratio=0.75;"
+      "data_block_restart_key_prefixes=true;"
       "checksum=kxxHash;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;"
       "block_size_deviation=8;block_restart_interval=4; "
@@ -394,6 +395,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "table_cache_numshardbits=28;"
                              "max_open_files=72;"
                              "max_file_opening_threads=35;"
+                             "manifest_recovery_threads=3;"
                              "max_background_jobs=8;"
                              "max_background_compactions=33;"
                              "use_fsync=true;"
@@ -436,7 +438,9 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "max_log_file_size=4607;"
                              "advise_random_on_open=true;"
                              "enable_pipelined_write=false;"
+                             "enable_pipelined_wal_sync=false;"
                              "unordered_write=false;"
+                             "core_local_write_staging=false;"
                              "allow_concurrent_memtable_write=true;"
                              "wal_recovery_mode=kPointInTimeRecovery;"
                              "enable_write_thread_adaptive_yield=true;"
@@ -446,6 +450,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "dump_malloc_stats=false;"
                              "allow_2pc=false;"
                              "avoid_flush_during_recovery=false;"
+                             "wal_recovery_threads=2;"
                              "avoid_flush_during_shutdown=false;"
                              "allow_ingest_behind=false;"
                              "concurrent_prepare=false;"
@@ -682,6 +687,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "paranoid_memory_checks=1;"
       "memtable_op_scan_flush_trigger=123;"
       "memtable_avg_op_scan_flush_trigger=12;"
+      "compaction_iterator_batch_size=64;"
+      "filter_memory_budget_bits_per_key=8.5;"
       "cf_allow_ingest_behind=1;",
       new_options));
 
@@ -7,6 +7,8 @@ LIB_SOURCES =                                                   \
   cache/cache_reservation_manager.cc                            \
   cache/charged_cache.cc                                        \
   cache/clock_cache.cc                                          \
+  cache/frequency_sketch.cc                                     \
+  cache/local_file_secondary_cache.cc                           \
   cache/lru_cache.cc                                            \
   cache/compressed_secondary_cache.cc                           \
   cache/secondary_cache.cc                                      \
@@ -21,8 +23,10 @@ LIB_SOURCES =                                                   \
   db/blob/blob_file_builder.cc                                  \
   db/blob/blob_file_cache.cc                                    \
   db/blob/blob_file_garbage.cc                                  \
+  db/blob/blob_file_gc_job.cc                                   \
   db/blob/blob_file_meta.cc                                     \
   db/blob/blob_file_reader.cc                                   \
+  db/blob/blob_file_relocation.cc                               \
   db/blob/blob_garbage_meter.cc                                 \
   db/blob/blob_log_format.cc                                    \
   db/blob/blob_log_sequential_reader.cc                         \
@@ -82,6 +86,7 @@ LIB_SOURCES =                                                   \
   db/merge_operator.cc                                          \
   db/multi_scan.cc						\
   db/output_validator.cc                                        \
+  db/parallel_wal_replayer.cc                                   \
   db/periodic_task_scheduler.cc                                 \
   db/range_del_aggregator.cc                                    \
   db/range_tombstone_fragmenter.cc                              \
@@ -110,6 +115,7 @@ LIB_SOURCES =                                                   \
   env/env.cc                                                    \
   env/env_chroot.cc                                             \
   env/env_encryption.cc                                         \
+  env/env_work_stealing.cc                                      \
   env/env_posix.cc                                              \
   env/file_system.cc                                            \
   env/fs_on_demand.cc                                           \
@@ -139,6 +145,7 @@ LIB_SOURCES =                                                   \
   memory/memkind_kmem_allocator.cc                              \
   memory/memory_allocator.cc                                    \
   memtable/alloc_tracker.cc                                     \
+  memtable/btree_rep.cc                                         \
   memtable/hash_linklist_rep.cc                                 \
   memtable/hash_skiplist_rep.cc                                 \
   memtable/skiplistrep.cc                                       \
@@ -196,6 +203,7 @@ LIB_SOURCES =                                                   \
   table/block_based/hash_index_reader.cc                        \
   table/block_based/index_builder.cc                            \
   table/block_based/index_reader_common.cc                      \
+  table/block_based/learned_index.cc                            \
   table/block_based/parsed_full_filter_block.cc                 \
   table/block_based/partitioned_filter_block.cc                 \
   table/block_based/partitioned_index_iterator.cc               \
@@ -206,6 +214,9 @@ LIB_SOURCES =                                                   \
   table/cuckoo/cuckoo_table_builder.cc                          \
   table/cuckoo/cuckoo_table_factory.cc                          \
   table/cuckoo/cuckoo_table_reader.cc                           \
+  table/eytzinger/eytzinger_table_builder.cc                    \
+  table/eytzinger/eytzinger_table_factory.cc                    \
+  table/eytzinger/eytzinger_table_reader.cc                     \
   table/external_table.cc					\
   table/format.cc                                               \
   table/get_context.cc                                          \
@@ -265,6 +276,7 @@ LIB_SOURCES =                                                   \
   util/thread_local.cc                                          \
   util/threadpool_imp.cc                                        \
   util/udt_util.cc                                              \
+  util/work_stealing_scheduler.cc                               \
   util/write_batch_util.cc                                      \
   util/xxhash.cc                                                \
   utilities/agg_merge/agg_merge.cc                              \
@@ -274,6 +286,7 @@ LIB_SOURCES =                                                   \
   utilities/blob_db/blob_db_impl.cc                             \
   utilities/blob_db/blob_db_impl_filesnapshot.cc                \
   utilities/blob_db/blob_file.cc                                \
+  utilities/bulk_loader/bulk_loader.cc                          \
   utilities/cache_dump_load.cc                                  \
   utilities/cache_dump_load_impl.cc                             \
   utilities/cassandra/cassandra_compaction_filter.cc            \
@@ -308,6 +321,7 @@ LIB_SOURCES =                                                   \
   utilities/persistent_cache/block_cache_tier_metadata.cc       \
   utilities/persistent_cache/persistent_cache_tier.cc           \
   utilities/persistent_cache/volatile_tier_impl.cc              \
+  utilities/secondary_index/secondary_index_backfill.cc         \
   utilities/secondary_index/secondary_index_iterator.cc         \
   utilities/secondary_index/simple_secondary_index.cc           \
   utilities/simulator_cache/cache_simulator.cc                  \
@@ -456,6 +470,7 @@ TEST_MAIN_SOURCES =                                                     \
   cache/cache_test.cc                                                   \
   cache/cache_reservation_manager_test.cc                               \
   cache/compressed_secondary_cache_test.cc                              \
+  cache/local_file_secondary_cache_test.cc                              \
   cache/lru_cache_test.cc                                               \
   cache/tiered_secondary_cache_test.cc					                        \
   db/blob/blob_counting_iterator_test.cc                                \
@@ -469,6 +484,7 @@ TEST_MAIN_SOURCES =                                                     \
   db/blob/db_blob_basic_test.cc                                         \
   db/blob/db_blob_compaction_test.cc                                    \
   db/blob/db_blob_corruption_test.cc                                    \
+  db/blob/db_blob_file_gc_test.cc                                       \
   db/blob/db_blob_index_test.cc                                         \
   db/column_family_test.cc                                              \
   db/compact_files_test.cc                                              \
@@ -525,6 +541,7 @@ TEST_MAIN_SOURCES =                                                     \
   db/dbformat_test.cc                                                   \
   db/deletefile_test.cc                                                 \
   db/error_handler_fs_test.cc                                           \
+  db/eytzinger_table_db_test.cc                                         \
   db/external_sst_file_basic_test.cc                                    \
   db/external_sst_file_test.cc                                          \
   db/fault_injection_test.cc                                            \
@@ -586,6 +603,7 @@ TEST_MAIN_SOURCES =                                                     \
   table/block_based/block_test.cc                                       \
   table/block_based/data_block_hash_index_test.cc                       \
   table/block_based/full_filter_block_test.cc                           \
+  table/block_based/learned_index_test.cc                               \
   table/block_based/partitioned_filter_block_test.cc                    \
   table/cleanable_test.cc                                               \
   table/cuckoo/cuckoo_table_builder_test.cc                             \
@@ -627,9 +645,11 @@ TEST_MAIN_SOURCES =                                                     \
   util/thread_local_test.cc                                             \
   util/udt_util_test.cc                                                 \
   util/work_queue_test.cc                                               \
+  util/work_stealing_scheduler_test.cc                                  \
   utilities/agg_merge/agg_merge_test.cc                                 \
   utilities/backup/backup_engine_test.cc                                \
   utilities/blob_db/blob_db_test.cc                                     \
+  utilities/bulk_loader/bulk_loader_test.cc                             \
   utilities/cassandra/cassandra_format_test.cc                          \
   utilities/cassandra/cassandra_functional_test.cc                      \
   utilities/cassandra/cassandra_row_merge_test.cc                       \
@@ -669,6 +689,7 @@ WITH_FAISS_TEST_MAIN_SOURCES =                                          \
 MICROBENCH_SOURCES =                                          \
   microbench/ribbon_bench.cc                                  \
   microbench/db_basic_bench.cc                                \
+  microbench/compaction_iterator_bench.cc                     \
 
 JNI_NATIVE_SOURCES =                                          \
   java/rocksjni/backupenginejni.cc                            \
@@ -22,6 +22,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/restart_key_prefixes.h"
 #include "table/format.h"
 #include "util/coding.h"
 
@@ -299,6 +300,21 @@ void DataBlockIter::PrevImpl() {
   prev_entries_idx_ = static_cast<int32_t>(prev_entries_.size()) - 1;
 }
 
+void DataBlockIter::NarrowBinarySeekByPrefix(const Slice& target,
+                                             int64_t* left,
+                                             int64_t* right) const {
+  assert(use_restart_key_prefixes_);
+  const uint64_t prefix = RestartKeyPrefix(ExtractUserKey(target));
+  uint32_t num_less = 0;
+  uint32_t num_greater = 0;
+  CountRestartKeyPrefixes(restart_key_prefixes_, num_restarts_, prefix,
+                          &num_less, &num_greater);
+  // A restart key whose prefix is less (greater) than the target's is
+  // strictly less (greater) than the target.
+  *left = static_cast<int64_t>(num_less) - 1;
+  *right = static_cast<int64_t>(num_restarts_ - num_greater) - 1;
+}
+
 void DataBlockIter::SeekImpl(const Slice& target) {
   Slice seek_key = target;
   PERF_TIMER_GUARD(block_seek_nanos);
@@ -307,7 +323,13 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  int64_t left = -1;
+  int64_t right = std::numeric_limits<int64_t>::max();
+  if (use_restart_key_prefixes_) {
+    NarrowBinarySeekByPrefix(seek_key, &left, &right);
+  }
+  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan, left,
+                                  right);
 
   if (!ok) {
     return;
@@ -359,6 +381,9 @@ void MetaBlockIter::SeekImpl(const Slice& target) {
 bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   Slice target_user_key = ExtractUserKey(target);
   uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
+  if (restart_key_prefixes_ != nullptr) {
+    map_offset += num_restarts_ * sizeof(uint64_t);
+  }
   uint8_t entry =
       data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
 
@@ -514,7 +539,13 @@ void DataBlockIter::SeekForPrevImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  int64_t left = -1;
+  int64_t right = std::numeric_limits<int64_t>::max();
+  if (use_restart_key_prefixes_) {
+    NarrowBinarySeekByPrefix(seek_key, &left, &right);
+  }
+  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan, left,
+                                  right);
 
   if (!ok) {
     return;
@@ -827,7 +858,8 @@ void BlockIter<TValue>::FindKeyAfterBinarySeek(const Slice& target,
 template <class TValue>
 template <typename DecodeKeyFunc>
 bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
-                                   bool* skip_linear_scan) {
+                                   bool* skip_linear_scan, int64_t left,
+                                   int64_t right) {
   if (restarts_ == 0) {
     // SST files dedicated to range tombstones are written with index blocks
     // that have no keys while also having `num_restarts_ == 1`. This would
@@ -845,7 +877,8 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
+  right = std::min<int64_t>(right, int64_t{num_restarts_} - 1);
+  assert(left >= -1 && left <= right);
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -1030,6 +1063,12 @@ uint32_t Block::NumRestarts() const {
     // Such check is for backward compatibility. We can ensure legacy block
     // with a vary large num_restarts i.e. >= 0x80000000 can be interpreted
     // correctly as no HashIndex even if the MSB of num_restarts is set.
+    //
+    // The restart key prefix flag is still honored here, since no legacy
+    // block can be large enough to have 2^30 restarts.
+    if (HasRestartKeyPrefixes()) {
+      UnPackIndexTypeAndNumRestarts(block_footer, nullptr, &num_restarts);
+    }
     return num_restarts;
   }
   BlockBasedTableOptions::DataBlockIndexType index_type;
@@ -1037,6 +1076,15 @@ uint32_t Block::NumRestarts() const {
   return num_restarts;
 }
 
+bool Block::HasRestartKeyPrefixes() const {
+  assert(size() >= 2 * sizeof(uint32_t));
+  uint32_t block_footer = DecodeFixed32(data() + size() - sizeof(uint32_t));
+  bool has_restart_key_prefixes;
+  UnPackIndexTypeAndNumRestarts(block_footer, nullptr, nullptr,
+                                &has_restart_key_prefixes);
+  return has_restart_key_prefixes;
+}
+
 BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
   assert(size() >= 2 * sizeof(uint32_t));
   if (size() > kMaxBlockSizeSupportedByHashIndex) {
@@ -1067,15 +1115,20 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
   } else {
     // Should only decode restart points for uncompressed blocks
     num_restarts_ = NumRestarts();
+    const bool has_restart_key_prefixes = HasRestartKeyPrefixes();
+    // The restart key prefixes, if any, follow the restart array.
+    const uint64_t restart_array_size =
+        uint64_t{num_restarts_} *
+        (sizeof(uint32_t) + (has_restart_key_prefixes ? sizeof(uint64_t) : 0));
     switch (IndexType()) {
       case BlockBasedTableOptions::kDataBlockBinarySearch:
-        restart_offset_ = static_cast<uint32_t>(size) -
-                          (1 + num_restarts_) * sizeof(uint32_t);
-        if (restart_offset_ > size - sizeof(uint32_t)) {
-          // The size is too small for NumRestarts() and therefore
-          // restart_offset_ wrapped around.
+        if (restart_array_size > size - sizeof(uint32_t)) {
+          // The size is too small for NumRestarts().
           size = 0;
+          break;
         }
+        restart_offset_ = static_cast<uint32_t>(size - sizeof(uint32_t) -
+                                                restart_array_size);
         break;
       case BlockBasedTableOptions::kDataBlockBinaryAndHash:
         if (size < sizeof(uint32_t) /* block footer */ +
@@ -1090,18 +1143,21 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
             /* chop off NUM_RESTARTS */
             static_cast<uint16_t>(size - sizeof(uint32_t)), &map_offset);
 
-        restart_offset_ = map_offset - num_restarts_ * sizeof(uint32_t);
-
-        if (restart_offset_ > map_offset) {
-          // map_offset is too small for NumRestarts() and
-          // therefore restart_offset_ wrapped around.
+        if (restart_array_size > map_offset) {
+          // map_offset is too small for NumRestarts().
           size = 0;
           break;
         }
+        restart_offset_ =
+            static_cast<uint32_t>(map_offset - restart_array_size);
         break;
       default:
         size = 0;  // Error marker
     }
+    if (size != 0 && has_restart_key_prefixes) {
+      restart_key_prefixes_ =
+          data() + restart_offset_ + num_restarts_ * sizeof(uint32_t);
+    }
   }
   if (read_amp_bytes_per_bit != 0 && statistics && size != 0) {
     read_amp_bitmap_.reset(new BlockReadAmpBitmap(
@@ -1276,7 +1332,8 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
         read_amp_bitmap_.get(), block_contents_pinned,
         user_defined_timestamps_persisted,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        protection_bytes_per_key_, kv_checksum_, block_restart_interval_,
+        restart_key_prefixes_);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -168,6 +169,9 @@ class Block {
   // The additional memory space taken by the block data.
   size_t usable_size() const { return contents_.usable_size(); }
   uint32_t NumRestarts() const;
+  // Whether the block stores an 8-byte user key prefix for each restart
+  // point. See BlockBasedTableOptions::data_block_restart_key_prefixes.
+  bool HasRestartKeyPrefixes() const;
   bool own_bytes() const { return contents_.own_bytes(); }
 
   BlockBasedTableOptions::DataBlockIndexType IndexType() const;
@@ -279,6 +283,8 @@ class Block {
   BlockContents contents_;
   uint32_t restart_offset_;  // Offset in data_ of restart array
   uint32_t num_restarts_;
+  // Fixed64 restart key prefixes following the restart array, or nullptr
+  const char* restart_key_prefixes_{nullptr};
   std::unique_ptr<BlockReadAmpBitmap> read_amp_bitmap_;
   char* kv_checksum_{nullptr};
   uint32_t checksum_size_{0};
@@ -663,9 +669,14 @@ class BlockIter : public InternalIteratorBase<TValue> {
   }
 
  protected:
+  // `left` and `right` optionally narrow the search to restart points in
+  // [`left` + 1, `right`]; the caller guarantees that the restart key at
+  // `left` (if not -1) is less than `target` and that those after `right`
+  // are greater.
   template <typename DecodeKeyFunc>
   inline bool BinarySeek(const Slice& target, uint32_t* index,
-                         bool* is_index_key_result);
+                         bool* is_index_key_result, int64_t left = -1,
+                         int64_t right = std::numeric_limits<int64_t>::max());
 
   // Find the first key in restart interval `index` that is >= `target`.
   // If there is no such key, iterator is positioned at the first key in
@@ -692,7 +703,8 @@ class DataBlockIter final : public BlockIter<Slice> {
                   bool user_defined_timestamps_persisted,
                   DataBlockHashIndex* data_block_hash_index,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
-                  uint32_t block_restart_interval) {
+                  uint32_t block_restart_interval,
+                  const char* restart_key_prefixes = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
                    block_contents_pinned, user_defined_timestamps_persisted,
                    protection_bytes_per_key, kv_checksum,
@@ -701,6 +713,12 @@ class DataBlockIter final : public BlockIter<Slice> {
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    restart_key_prefixes_ = restart_key_prefixes;
+    // The prefixes order restart keys consistently with the comparator only
+    // for bytewise ordering, which the builder guarantees; ignore them if the
+    // block is somehow read with anything else.
+    use_restart_key_prefixes_ = restart_key_prefixes != nullptr &&
+                                raw_ucmp == BytewiseComparator();
   }
 
   Slice value() const override {
@@ -778,6 +796,15 @@ class DataBlockIter final : public BlockIter<Slice> {
 
   DataBlockHashIndex* data_block_hash_index_;
 
+  // See Block::restart_key_prefixes_.
+  const char* restart_key_prefixes_ = nullptr;
+  bool use_restart_key_prefixes_ = false;
+
+  // Narrows the restart range that BinarySeek() must search for the internal
+  // key `target` to [`*left`, `*right`] using only the restart key prefixes.
+  void NarrowBinarySeekByPrefix(const Slice& target, int64_t* left,
+                                int64_t* right) const;
+
   bool SeekForGetImpl(const Slice& target);
 };
 
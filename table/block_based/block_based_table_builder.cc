@@ -12,6 +12,7 @@
 #include <atomic>
 #include <cassert>
 #include <cstdio>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -72,7 +73,8 @@ FilterBlockBuilder* CreateFilterBlockBuilder(
     const FilterBuildingContext& context,
     const bool use_delta_encoding_for_index_values,
     PartitionedIndexBuilder* const p_index_builder, size_t ts_sz,
-    const bool persist_user_defined_timestamps) {
+    const bool persist_user_defined_timestamps,
+    FilterBlockBuilder::BackgroundWorkScheduler scheduler) {
   const BlockBasedTableOptions& table_opt = context.table_options;
   assert(table_opt.filter_policy);  // precondition
 
@@ -99,11 +101,14 @@ FilterBlockBuilder* CreateFilterBlockBuilder(
           filter_bits_builder, table_opt.index_block_restart_interval,
           use_delta_encoding_for_index_values, p_index_builder, partition_size,
           ts_sz, persist_user_defined_timestamps,
-          table_opt.decouple_partitioned_filters);
+          table_opt.decouple_partitioned_filters, std::move(scheduler),
+          [context]() {
+            return BloomFilterPolicy::GetBuilderFromContext(context);
+          });
     } else {
-      return new FullFilterBlockBuilder(mopt.prefix_extractor.get(),
-                                        table_opt.whole_key_filtering,
-                                        filter_bits_builder);
+      return new FullFilterBlockBuilder(
+          mopt.prefix_extractor.get(), table_opt.whole_key_filtering,
+          filter_bits_builder, std::move(scheduler));
     }
   }
 }
@@ -270,7 +275,13 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
   // Compression queue will pass references to BlockRep in block_rep_buf,
   // and those references are always valid before the destruction of
   // block_rep_buf.
-  using CompressQueue = WorkQueue<BlockRep*>;
+  // Work for the compression threads: a data block to compress, or other
+  // work handed off to them, such as finishing filters.
+  struct CompressWork {
+    BlockRep* block_rep = nullptr;
+    std::function<void()> other_work;
+  };
+  using CompressQueue = WorkQueue<CompressWork>;
   CompressQueue compress_queue;
   std::vector<port::Thread> compress_thread_pool;
 
@@ -430,7 +441,7 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
     if (!write_queue.push(&block_rep->slot)) {
       return;
     }
-    if (!compress_queue.push(block_rep)) {
+    if (!compress_queue.push(CompressWork{block_rep, nullptr})) {
       return;
     }
 
@@ -595,6 +606,9 @@ struct BlockBasedTableBuilder::Rep {
   // all blocks after data blocks till the end of the SST file.
   uint64_t tail_size;
 
+  // Stage timing of Finish(), for GetFinishTimes()
+  TableBuilderFinishTimes finish_times;
+
   // The total size of all blocks in this file before they are compressed.
   // This is used for logging compaction stats.
   uint64_t pre_compression_size = 0;
@@ -609,6 +623,17 @@ struct BlockBasedTableBuilder::Rep {
     return compression_parallel_threads > 1;
   }
 
+  // Hands filter construction work to the parallel compression threads, or
+  // runs it inline when they are not running
+  void ScheduleFilterWork(std::function<void()> work) {
+    ParallelCompressionRep::CompressWork item;
+    item.other_work = std::move(work);
+    // Not moved from if not pushed
+    if (pc_rep == nullptr || !pc_rep->compress_queue.push(std::move(item))) {
+      item.other_work();
+    }
+  }
+
   Status GetStatus() {
     // We need to make modifications of status visible when status_ok is set
     // to false, and this is ensured by status_mutex, so no special memory
@@ -697,7 +722,10 @@ struct BlockBasedTableBuilder::Rep {
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
                    table_options.data_block_hash_table_util_ratio, ts_sz,
-                   persist_user_defined_timestamps),
+                   persist_user_defined_timestamps, false /* is_user_key */,
+                   table_options.data_block_restart_key_prefixes &&
+                       tbo.internal_comparator.user_comparator() ==
+                           BytewiseComparator()),
         range_del_block(
             1 /* block_restart_interval */, true /* use_delta_encoding */,
             false /* use_value_delta_encoding */,
@@ -749,6 +777,7 @@ struct BlockBasedTableBuilder::Rep {
       filter_context.num_levels = ioptions.num_levels;
       filter_context.level_at_creation = tbo.level_at_creation;
       filter_context.is_bottommost = tbo.is_bottommost;
+      filter_context.adaptive_bits_per_key = tbo.adaptive_filter_bits_per_key;
       assert(filter_context.level_at_creation < filter_context.num_levels);
     }
 
@@ -907,10 +936,19 @@ struct BlockBasedTableBuilder::Rep {
       // Null filter_policy -> no filter
       filter_builder.reset();
     } else {
+      // With parallel compression, filters are finished (e.g. Ribbon banding
+      // and solving) on the compression threads rather than on the thread
+      // adding keys
+      FilterBlockBuilder::BackgroundWorkScheduler scheduler;
+      if (IsParallelCompressionEnabled()) {
+        scheduler = [this](std::function<void()> work) {
+          ScheduleFilterWork(std::move(work));
+        };
+      }
       filter_builder.reset(CreateFilterBlockBuilder(
           ioptions, tbo.moptions, filter_context,
           use_delta_encoding_for_index_values, p_index_builder_, ts_sz,
-          persist_user_defined_timestamps));
+          persist_user_defined_timestamps, std::move(scheduler)));
     }
 
     assert(tbo.internal_tbl_prop_coll_factories);
@@ -1367,8 +1405,14 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& uncompressed_block_data,
 }
 
 void BlockBasedTableBuilder::BGWorkCompression(WorkingAreaPair& working_area) {
-  ParallelCompressionRep::BlockRep* block_rep = nullptr;
-  while (rep_->pc_rep->compress_queue.pop(block_rep)) {
+  ParallelCompressionRep::CompressWork work;
+  while (rep_->pc_rep->compress_queue.pop(work)) {
+    if (work.other_work) {
+      work.other_work();
+      work.other_work = nullptr;
+      continue;
+    }
+    ParallelCompressionRep::BlockRep* block_rep = work.block_rep;
     assert(block_rep != nullptr);
     // Skip compression if we are aborting anyway
     if (ok()) {
@@ -2181,6 +2225,7 @@ void BlockBasedTableBuilder::MaybeEnterUnbuffered(
 Status BlockBasedTableBuilder::Finish() {
   Rep* r = rep_;
   assert(r->state != Rep::State::kClosed);
+  StopWatchNano stage_timer(r->ioptions.clock, /*auto_start=*/true);
   // To make sure properties block is able to keep the accurate size of index
   // block, we will finish writing all index entries first, in Flush().
   Flush(/*first_key_in_next_block=*/nullptr);
@@ -2189,6 +2234,16 @@ Status BlockBasedTableBuilder::Finish() {
   }
   assert(r->state == Rep::State::kUnbuffered);
   if (r->IsParallelCompressionEnabled()) {
+    // All keys have been added to the filter, so the filter can be finished
+    // (notably solving a Ribbon filter) while the last data blocks are still
+    // being compressed and written.
+    if (ok() && r->filter_builder != nullptr &&
+        !r->filter_builder->IsEmpty()) {
+      assert(!r->last_ikey.empty());
+      r->filter_builder->PrevKeyBeforeFinish(
+          ExtractUserKeyAndStripTimestamp(r->last_ikey, r->ts_sz));
+      r->filter_builder->StartFinishInBackground();
+    }
     StopParallelCompression();
 #ifndef NDEBUG
     for (const auto& br : r->pc_rep->block_rep_buf) {
@@ -2196,6 +2251,7 @@ Status BlockBasedTableBuilder::Finish() {
     }
 #endif  // !NDEBUG
   }
+  r->finish_times.data_blocks_nanos = stage_timer.ElapsedNanos(/*reset=*/true);
 
   r->props.tail_start_offset = r->offset;
 
@@ -2210,7 +2266,9 @@ Status BlockBasedTableBuilder::Finish() {
   BlockHandle metaindex_block_handle, index_block_handle;
   MetaIndexBuilder meta_index_builder;
   WriteFilterBlock(&meta_index_builder);
+  r->finish_times.filter_nanos = stage_timer.ElapsedNanos(/*reset=*/true);
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
+  r->finish_times.index_nanos = stage_timer.ElapsedNanos(/*reset=*/true);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
   WritePropertiesBlock(&meta_index_builder);
@@ -2285,6 +2343,10 @@ TableProperties BlockBasedTableBuilder::GetTableProperties() const {
   return rep_->props;
 }
 
+TableBuilderFinishTimes BlockBasedTableBuilder::GetFinishTimes() const {
+  return rep_->finish_times;
+}
+
 std::string BlockBasedTableBuilder::GetFileChecksum() const {
   if (rep_->file != nullptr) {
     return rep_->file->GetFileChecksum();
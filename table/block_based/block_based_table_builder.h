@@ -103,6 +103,8 @@ class BlockBasedTableBuilder : public TableBuilder {
   // Get table properties
   TableProperties GetTableProperties() const override;
 
+  TableBuilderFinishTimes GetFinishTimes() const override;
+
   // Get file checksum
   std::string GetFileChecksum() const override;
 
@@ -60,6 +60,12 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
     SeekSecondPass(target);
     return;
   }
+  if (async_index_read_in_progress_) {
+    // The previous pass submitted an asynchronous index partition read.
+    async_index_read_in_progress_ = false;
+    SeekFromIndex(target, /*need_seek_index=*/true, async_prefetch);
+    return;
+  }
 
   ResetBlockCacheLookupVar();
 
@@ -120,13 +126,32 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
     }
   }
 
+  SeekFromIndex(target, need_seek_index, async_prefetch);
+}
+
+void BlockBasedTableIterator::SeekFromIndex(const Slice* target,
+                                            bool need_seek_index,
+                                            bool async_prefetch) {
   if (need_seek_index) {
+    is_index_at_curr_block_ = true;
     if (target) {
-      index_iter_->Seek(*target);
+      if (read_options_.async_io && async_prefetch) {
+        index_iter_->SeekAsync(*target);
+        if (index_iter_->status().IsTryAgain()) {
+          // Status::TryAgain indicates asynchronous request for retrieval of
+          // an index partition has been submitted. Seek should be called
+          // again to retrieve it and execute the remaining code, which may
+          // in turn submit an asynchronous data block read.
+          ResetDataIter();
+          async_index_read_in_progress_ = true;
+          return;
+        }
+      } else {
+        index_iter_->Seek(*target);
+      }
     } else {
       index_iter_->SeekToFirst();
     }
-    is_index_at_curr_block_ = true;
     if (!index_iter_->Valid()) {
       ResetDataIter();
       return;
@@ -191,6 +216,7 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
 void BlockBasedTableIterator::SeekForPrev(const Slice& target) {
   multi_scan_.reset();
   direction_ = IterDirection::kBackward;
+  async_index_read_in_progress_ = false;
   ResetBlockCacheLookupVar();
   is_out_of_bound_ = false;
   is_at_first_key_from_index_ = false;
@@ -266,6 +292,7 @@ void BlockBasedTableIterator::SeekForPrev(const Slice& target) {
 void BlockBasedTableIterator::SeekToLast() {
   multi_scan_.reset();
   direction_ = IterDirection::kBackward;
+  async_index_read_in_progress_ = false;
   ResetBlockCacheLookupVar();
   is_out_of_bound_ = false;
   is_at_first_key_from_index_ = false;
@@ -400,6 +427,11 @@ void BlockBasedTableIterator::InitDataBlock() {
             std::placeholders::_3);
       }
 
+      // index_iter_ is at this block unless block handles are queued.
+      const bool is_last_block_in_range =
+          read_options_.pattern_aware_readahead && !is_for_compaction &&
+          !DoesContainBlockHandles() && IsNextBlockOutOfReadaheadBound();
+
       // Prefetch additional data for range scans (iterators).
       // Implicit auto readahead:
       //   Enabled after 2 sequential IOs when ReadOptions.readahead_size == 0.
@@ -410,7 +442,7 @@ void BlockBasedTableIterator::InitDataBlock() {
           rep, data_block_handle, read_options_.readahead_size,
           is_for_compaction,
           /*no_sequential_checking=*/false, read_options_, readaheadsize_cb,
-          read_options_.async_io);
+          read_options_.async_io, is_last_block_in_range);
 
       Status s;
       table_->NewDataBlockIterator<DataBlockIter>(
@@ -340,6 +340,9 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   bool need_upper_bound_check_;
 
   bool async_read_in_progress_;
+  // True if the index iterator has an asynchronous read in progress for the
+  // seek (see InternalIteratorBase::SeekAsync()).
+  bool async_index_read_in_progress_ = false;
 
   mutable SeekStatState seek_stat_state_ = SeekStatState::kNone;
   bool is_last_level_;
@@ -403,6 +406,10 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
 
   // If `target` is null, seek to first.
   void SeekImpl(const Slice* target, bool async_prefetch);
+  // The part of SeekImpl() from the index seek on, also used to resume a seek
+  // after an asynchronous index read.
+  void SeekFromIndex(const Slice* target, bool need_seek_index,
+                     bool async_prefetch);
 
   void InitDataBlock();
   void AsyncInitDataBlock(bool is_first_pass);
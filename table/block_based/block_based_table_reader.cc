@@ -2330,6 +2330,9 @@ bool BlockBasedTable::FullFilterKeyMayMatch(
       PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, 1, rep_->level);
     }
   }
+  if (!may_match && get_context != nullptr) {
+    ++get_context->get_context_stats_.num_filter_useful;
+  }
   return may_match;
 }
 
@@ -28,12 +28,18 @@
 //
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
-//     num_restarts: uint32
+//     restart_key_prefixes: uint64[num_restarts] (NOTE2)
+//     data block hash index (optional)
+//     num_restarts: uint32 (packed with flags, see data_block_footer.h)
 // restarts[i] contains the offset within the block of the ith restart point.
 //
 // NOTE1: omitted for format_version >= 4 index blocks, because the value is
 // composed of one (shared_bytes > 0) or two (shared_bytes == 0) varints, whose
 // length is self-describing.
+//
+// NOTE2: only present if the block was built with use_restart_key_prefixes.
+// restart_key_prefixes[i] is RestartKeyPrefix() of the ith restart key's user
+// key.
 
 #include "table/block_based/block_builder.h"
 
@@ -43,6 +49,7 @@
 #include "db/dbformat.h"
 #include "rocksdb/comparator.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/restart_key_prefixes.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -52,12 +59,14 @@ BlockBuilder::BlockBuilder(
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
     double data_block_hash_table_util_ratio, size_t ts_sz,
-    bool persist_user_defined_timestamps, bool is_user_key)
+    bool persist_user_defined_timestamps, bool is_user_key,
+    bool use_restart_key_prefixes)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
       strip_ts_sz_(persist_user_defined_timestamps ? 0 : ts_sz),
       is_user_key_(is_user_key),
+      use_restart_key_prefixes_(use_restart_key_prefixes),
       restarts_(1, 0),  // First restart point is at offset 0
       counter_(0),
       finished_(false) {
@@ -72,14 +81,17 @@ BlockBuilder::BlockBuilder(
       assert(0);
   }
   assert(block_restart_interval_ >= 1);
-  estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
+  // Restart key prefixes rely on bytewise ordering of whole user keys
+  assert(!use_restart_key_prefixes_ || (!is_user_key_ && ts_sz == 0));
+  estimate_ = sizeof(uint32_t) + RestartEntrySize();
 }
 
 void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.resize(1);  // First restart point is at offset 0
   assert(restarts_[0] == 0);
-  estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
+  restart_key_prefixes_.clear();
+  estimate_ = sizeof(uint32_t) + RestartEntrySize();
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
@@ -113,7 +125,7 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
           : value.size() / 2;
 
   if (counter_ >= block_restart_interval_) {
-    estimate += sizeof(uint32_t);  // a new restart entry.
+    estimate += RestartEntrySize();  // a new restart entry.
   }
 
   estimate += sizeof(int32_t);  // varint for shared prefix length.
@@ -132,6 +144,12 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
+  if (use_restart_key_prefixes_) {
+    assert(restart_key_prefixes_.size() == restarts_.size());
+    for (uint64_t prefix : restart_key_prefixes_) {
+      PutFixed64(&buffer_, prefix);
+    }
+  }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
   BlockBasedTableOptions::DataBlockIndexType index_type =
@@ -143,7 +161,8 @@ Slice BlockBuilder::Finish() {
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  uint32_t block_footer = PackIndexTypeAndNumRestarts(
+      index_type, num_restarts, use_restart_key_prefixes_);
 
   PutFixed32(&buffer_, block_footer);
   finished_ = true;
@@ -209,13 +228,17 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
   if (counter_ >= block_restart_interval_) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_size));
-    estimate_ += sizeof(uint32_t);
+    estimate_ += RestartEntrySize();
     counter_ = 0;
   } else if (use_delta_encoding_) {
     // See how much sharing to do with previous string
     shared = key_to_persist.difference_offset(last_key_persisted);
   }
 
+  if (use_restart_key_prefixes_ && counter_ == 0) {
+    restart_key_prefixes_.push_back(RestartKeyPrefix(ExtractUserKey(key)));
+  }
+
   const size_t non_shared = key_to_persist.size() - shared;
 
   if (use_value_delta_encoding_) {
@@ -31,7 +31,8 @@ class BlockBuilder {
                         double data_block_hash_table_util_ratio = 0.75,
                         size_t ts_sz = 0,
                         bool persist_user_defined_timestamps = true,
-                        bool is_user_key = false);
+                        bool is_user_key = false,
+                        bool use_restart_key_prefixes = false);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -91,6 +92,12 @@ class BlockBuilder {
   inline const Slice MaybeStripTimestampFromKey(std::string* key_buf,
                                                 const Slice& key);
 
+  // Size of the trailer entries for one restart point
+  size_t RestartEntrySize() const {
+    return sizeof(uint32_t) +
+           (use_restart_key_prefixes_ ? sizeof(uint64_t) : 0);
+  }
+
   const int block_restart_interval_;
   // TODO(myabandeh): put it into a separate IndexBlockBuilder
   const bool use_delta_encoding_;
@@ -114,9 +121,13 @@ class BlockBuilder {
   // index block for partitioned index blocks. In summary, this only applies to
   // block whose key are real user keys or internal keys created from user keys.
   const bool is_user_key_;
+  // Whether to append the restart key prefix array. Only for data blocks
+  // (internal keys) under a bytewise comparator.
+  const bool use_restart_key_prefixes_;
 
   std::string buffer_;              // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
+  std::vector<uint64_t> restart_key_prefixes_;
   size_t estimate_;
   int counter_;    // Number of entries emitted since restart
   bool finished_;  // Has Finish() been called?
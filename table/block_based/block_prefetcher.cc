@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "table/block_based/block_prefetcher.h"
 
+#include "monitoring/perf_context_imp.h"
 #include "rocksdb/file_system.h"
 #include "table/block_based/block_based_table_reader.h"
 
@@ -17,7 +18,7 @@ void BlockPrefetcher::PrefetchIfNeeded(
     const size_t readahead_size, bool is_for_compaction,
     const bool no_sequential_checking, const ReadOptions& read_options,
     const std::function<void(bool, uint64_t&, uint64_t&)>& readaheadsize_cb,
-    bool is_async_io_prefetch) {
+    bool is_async_io_prefetch, bool is_last_block_in_range) {
   if (read_options.read_tier == ReadTier::kBlockCacheTier) {
     // Disable prefetching when IO disallowed. (Note that we haven't allocated
     // any buffers yet despite the various tracked settings.)
@@ -36,6 +37,7 @@ void BlockPrefetcher::PrefetchIfNeeded(
       // If FS supports prefetching (readahead_limit_ will be non zero in that
       // case) and current block exists in prefetch buffer then return.
       if (offset + len <= readahead_limit_) {
+        UpdateReadPattern(offset, len);
         return;
       }
       IOOptions opts;
@@ -46,7 +48,10 @@ void BlockPrefetcher::PrefetchIfNeeded(
       }
       s = rep->file->Prefetch(opts, offset, len + compaction_readahead_size_);
       if (s.ok()) {
+        // Compaction reads sequentially, so all of the previous hint was used
+        UpdateReadPattern(offset, len);
         readahead_limit_ = offset + len + compaction_readahead_size_;
+        PERF_COUNTER_ADD(prefetch_bytes, compaction_readahead_size_);
         return;
       } else if (!s.IsNotSupported()) {
         return;
@@ -109,19 +114,54 @@ void BlockPrefetcher::PrefetchIfNeeded(
     return;
   }
 
-  if (!IsBlockSequential(offset)) {
+  if (read_options.pattern_aware_readahead) {
+    if (offset >= backward_readahead_start_ &&
+        offset + len <= backward_readahead_end_) {
+      UpdateReadPattern(offset, len);
+      return;
+    }
+    const ReadPattern pattern = ClassifyRead(offset, len);
+    const bool backward = pattern == ReadPattern::kBackward;
+    // Forward (or strided) and backward runs of reads are counted
+    // separately, the previous block being the first read of a new run.
+    if (pattern == ReadPattern::kRandom || backward != reading_backward_) {
+      RecordUnusedReadahead();
+      ResetValues(rep->table_options.initial_auto_readahead_size);
+      reading_backward_ = backward;
+    }
+    UpdateReadPattern(offset, len);
+    if (pattern == ReadPattern::kRandom) {
+      return;
+    }
+    num_file_reads_++;
+    if (num_file_reads_ <=
+        rep->table_options.num_file_reads_for_auto_readahead) {
+      return;
+    }
+    if (pattern == ReadPattern::kBackward) {
+      PrefetchBackwardIfNeeded(rep, offset, read_options);
+      return;
+    }
+    if (is_last_block_in_range) {
+      return;
+    }
+  } else {
+    if (!IsBlockSequential(offset)) {
+      RecordUnusedReadahead();
+      UpdateReadPattern(offset, len);
+      ResetValues(rep->table_options.initial_auto_readahead_size);
+      return;
+    }
     UpdateReadPattern(offset, len);
-    ResetValues(rep->table_options.initial_auto_readahead_size);
-    return;
-  }
-  UpdateReadPattern(offset, len);
 
-  // Implicit auto readahead, which will be enabled if the number of reads
-  // reached `table_options.num_file_reads_for_auto_readahead` (default: 2)  and
-  // scans are sequential.
-  num_file_reads_++;
-  if (num_file_reads_ <= rep->table_options.num_file_reads_for_auto_readahead) {
-    return;
+    // Implicit auto readahead, which will be enabled if the number of reads
+    // reached `table_options.num_file_reads_for_auto_readahead` (default: 2)
+    // and scans are sequential.
+    num_file_reads_++;
+    if (num_file_reads_ <=
+        rep->table_options.num_file_reads_for_auto_readahead) {
+      return;
+    }
   }
 
   readahead_params.num_file_reads = num_file_reads_;
@@ -135,6 +175,16 @@ void BlockPrefetcher::PrefetchIfNeeded(
   if (readahead_size_ > max_auto_readahead_size) {
     readahead_size_ = max_auto_readahead_size;
   }
+  size_t hint_size = readahead_size_;
+  if (read_options.pattern_aware_readahead && rep->table_properties) {
+    // Data blocks are at the start of the file, so don't read past them
+    // when reading a data block.
+    const uint64_t data_end = rep->table_properties->data_size;
+    if (offset + len <= data_end) {
+      hint_size = static_cast<size_t>(
+          std::min<uint64_t>(hint_size, data_end - (offset + len)));
+    }
+  }
 
   // If prefetch is not supported, fall back to use internal prefetch buffer.
   IOOptions opts;
@@ -144,7 +194,7 @@ void BlockPrefetcher::PrefetchIfNeeded(
   }
   s = rep->file->Prefetch(
       opts, handle.offset(),
-      BlockBasedTable::BlockSizeWithTrailer(handle) + readahead_size_);
+      BlockBasedTable::BlockSizeWithTrailer(handle) + hint_size);
   if (s.IsNotSupported()) {
     rep->CreateFilePrefetchBufferIfNotExists(
         readahead_params, &prefetch_buffer_, readaheadsize_cb,
@@ -152,9 +202,58 @@ void BlockPrefetcher::PrefetchIfNeeded(
     return;
   }
 
-  readahead_limit_ = offset + len + readahead_size_;
+  RecordUnusedReadahead();
+  readahead_limit_ = offset + len + hint_size;
+  PERF_COUNTER_ADD(prefetch_bytes, hint_size);
   // Keep exponentially increasing readahead size until
   // max_auto_readahead_size.
   readahead_size_ = std::min(max_auto_readahead_size, readahead_size_ * 2);
 }
+
+void BlockPrefetcher::PrefetchBackwardIfNeeded(
+    const BlockBasedTable::Rep* rep, uint64_t offset,
+    const ReadOptions& read_options) {
+  // The prefetch buffer only reads ahead of forward reads, so only a file
+  // system that prefetches can help a reverse scan.
+  if (rep->file->use_direct_io() || offset == 0) {
+    return;
+  }
+  const size_t max_auto_readahead_size =
+      rep->table_options.max_auto_readahead_size;
+  if (readahead_size_ > max_auto_readahead_size) {
+    readahead_size_ = max_auto_readahead_size;
+  }
+  // The current block is about to be read, so hint what precedes it.
+  const uint64_t start =
+      offset > readahead_size_ ? offset - readahead_size_ : 0;
+  IOOptions opts;
+  Status s = rep->file->PrepareIOOptions(read_options, opts);
+  if (!s.ok()) {
+    return;
+  }
+  s = rep->file->Prefetch(opts, start, static_cast<size_t>(offset - start));
+  if (!s.ok()) {
+    return;
+  }
+  RecordUnusedReadahead();
+  backward_readahead_start_ = start;
+  backward_readahead_end_ = offset;
+  PERF_COUNTER_ADD(prefetch_bytes, offset - start);
+  readahead_size_ = std::min(max_auto_readahead_size, readahead_size_ * 2);
+}
+
+void BlockPrefetcher::RecordUnusedReadahead() {
+  const uint64_t prev_end = prev_offset_ + prev_len_;
+  if (readahead_limit_ > prev_end) {
+    PERF_COUNTER_ADD(prefetch_bytes_wasted, readahead_limit_ - prev_end);
+  }
+  if (backward_readahead_end_ > 0 && prev_offset_ > backward_readahead_start_) {
+    PERF_COUNTER_ADD(prefetch_bytes_wasted,
+                     std::min(prev_offset_, backward_readahead_end_) -
+                         backward_readahead_start_);
+  }
+  readahead_limit_ = 0;
+  backward_readahead_start_ = 0;
+  backward_readahead_end_ = 0;
+}
 }  // namespace ROCKSDB_NAMESPACE
@@ -17,13 +17,17 @@ class BlockPrefetcher {
       : compaction_readahead_size_(compaction_readahead_size),
         readahead_size_(initial_auto_readahead_size),
         initial_auto_readahead_size_(initial_auto_readahead_size) {}
+  ~BlockPrefetcher() { RecordUnusedReadahead(); }
 
+  // With ReadOptions::pattern_aware_readahead, is_last_block_in_range tells
+  // that no block after this one is within the scan's bounds, so nothing is
+  // read ahead of it.
   void PrefetchIfNeeded(
       const BlockBasedTable::Rep* rep, const BlockHandle& handle,
       size_t readahead_size, bool is_for_compaction,
       const bool no_sequential_checking, const ReadOptions& read_options,
       const std::function<void(bool, uint64_t&, uint64_t&)>& readaheadsize_cb,
-      bool is_async_io_prefetch);
+      bool is_async_io_prefetch, bool is_last_block_in_range = false);
   FilePrefetchBuffer* prefetch_buffer() { return prefetch_buffer_.get(); }
 
   void UpdateReadPattern(const uint64_t& offset, const size_t& len) {
@@ -55,6 +59,44 @@ class BlockPrefetcher {
   }
 
  private:
+  // How a block read relates to the previous one, for
+  // ReadOptions::pattern_aware_readahead
+  enum class ReadPattern {
+    // Right after the previous block, or the first block read
+    kForward,
+    // Right before the previous block, as in a reverse scan
+    kBackward,
+    // After the previous block by no more than the size of the block, as in
+    // a scan that skips some blocks. Reading the gaps too is cheaper than a
+    // separate read per block.
+    kStrided,
+    kRandom,
+  };
+
+  ReadPattern ClassifyRead(uint64_t offset, size_t len) const {
+    const uint64_t prev_end = prev_offset_ + prev_len_;
+    if (prev_len_ == 0 || offset == prev_end) {
+      return ReadPattern::kForward;
+    }
+    if (offset + len == prev_offset_) {
+      return ReadPattern::kBackward;
+    }
+    if (offset > prev_end && offset - prev_end <= len) {
+      return ReadPattern::kStrided;
+    }
+    return ReadPattern::kRandom;
+  }
+
+  // Hints the file system to read ahead of a reverse scan once it has read
+  // enough blocks backward.
+  void PrefetchBackwardIfNeeded(const BlockBasedTable::Rep* rep,
+                                uint64_t offset,
+                                const ReadOptions& read_options);
+
+  // Counts what was hinted to the file system to read ahead but was not
+  // read by the scan as wasted, and forgets about it.
+  void RecordUnusedReadahead();
+
   // Readahead size used in compaction, its value is used only if
   // lookup_context_.caller = kCompaction.
   size_t compaction_readahead_size_;
@@ -69,6 +111,11 @@ class BlockPrefetcher {
   uint64_t num_file_reads_ = 0;
   uint64_t prev_offset_ = 0;
   size_t prev_len_ = 0;
+  // Whether the last reads were classified as kBackward
+  bool reading_backward_ = false;
+  // Range hinted to the file system to read ahead of a reverse scan
+  uint64_t backward_readahead_start_ = 0;
+  uint64_t backward_readahead_end_ = 0;
   std::unique_ptr<FilePrefetchBuffer> prefetch_buffer_;
 };
 }  // namespace ROCKSDB_NAMESPACE
@@ -301,6 +301,155 @@ INSTANTIATE_TEST_CASE_P(
             BlockBasedTableOptions::DataBlockIndexType::
                 kDataBlockBinaryAndHash)));
 
+// Param 0: block restart interval
+// Param 1: data block index type
+class BlockRestartKeyPrefixTest
+    : public testing::Test,
+      public testing::WithParamInterface<
+          std::tuple<int, BlockBasedTableOptions::DataBlockIndexType>> {
+ public:
+  int restartInterval() const { return std::get<0>(GetParam()); }
+  BlockBasedTableOptions::DataBlockIndexType dataBlockIndexType() const {
+    return std::get<1>(GetParam());
+  }
+};
+
+TEST_P(BlockRestartKeyPrefixTest, SeekMatchesReference) {
+  Random rnd(301);
+  // User keys drawn from a tiny alphabet including '\0' so that many keys
+  // share 8-byte prefixes, and that keys shorter than 8 bytes collide with
+  // their zero-padded extensions.
+  auto random_user_key = [&rnd]() {
+    std::string k;
+    int len = 1 + rnd.Uniform(12);
+    for (int i = 0; i < len; ++i) {
+      k.push_back("\0ab"[rnd.Uniform(3)]);
+    }
+    return k;
+  };
+  std::set<std::string> user_keys;
+  for (int i = 0; i < 2000; ++i) {
+    user_keys.insert(random_user_key());
+  }
+  InternalKeyComparator icmp(BytewiseComparator());
+  std::vector<std::string> keys;
+  for (const auto &user_key : user_keys) {
+    // Some user keys have several versions, possibly spanning restarts
+    int versions = rnd.OneIn(4) ? 3 : 1;
+    for (int v = versions; v > 0; --v) {
+      keys.push_back(
+          InternalKey(user_key, 100 * v, kTypeValue).Encode().ToString());
+    }
+  }
+
+  BlockBuilder builder(restartInterval(), true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       dataBlockIndexType(),
+                       0.75 /* data_block_hash_table_util_ratio */,
+                       0 /* ts_sz */, true /* persist_udt */,
+                       false /* is_user_key */,
+                       true /* use_restart_key_prefixes */);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    builder.Add(keys[i], std::to_string(i));
+  }
+  BlockContents contents;
+  contents.data = builder.Finish();
+  if (dataBlockIndexType() == BlockBasedTableOptions::kDataBlockBinarySearch) {
+    ASSERT_EQ(contents.data.size(), builder.CurrentSizeEstimate());
+  }
+  Block reader(std::move(contents));
+  ASSERT_TRUE(reader.HasRestartKeyPrefixes());
+  ASSERT_EQ(reader.NumRestarts(),
+            (keys.size() + restartInterval() - 1) / restartInterval());
+
+  std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++count) {
+    ASSERT_EQ(iter->key(), keys[count]);
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(count, keys.size());
+
+  for (int i = 0; i < 5000; ++i) {
+    std::string target =
+        InternalKey(random_user_key(), rnd.Uniform(400), kTypeValue)
+            .Encode()
+            .ToString();
+    auto cmp = [&icmp](const std::string &a, const std::string &b) {
+      return icmp.Compare(a, b) < 0;
+    };
+    auto it = std::lower_bound(keys.begin(), keys.end(), target, cmp);
+
+    iter->Seek(target);
+    ASSERT_OK(iter->status());
+    if (it == keys.end()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), *it);
+    }
+
+    iter->SeekForPrev(target);
+    ASSERT_OK(iter->status());
+    auto prev = std::upper_bound(keys.begin(), keys.end(), target, cmp);
+    if (prev == keys.begin()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), *std::prev(prev));
+    }
+
+    if (iter->SeekForGet(target) && iter->Valid() && it != keys.end() &&
+        ExtractUserKey(*it) == ExtractUserKey(target)) {
+      ASSERT_EQ(iter->key(), *it);
+    }
+  }
+}
+
+TEST_P(BlockRestartKeyPrefixTest, IgnoredWithOtherComparator) {
+  Random rnd(302);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0, 1000);
+  BlockBuilder builder(restartInterval(), true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       dataBlockIndexType(),
+                       0.75 /* data_block_hash_table_util_ratio */,
+                       0 /* ts_sz */, true /* persist_udt */,
+                       false /* is_user_key */,
+                       true /* use_restart_key_prefixes */);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    builder.Add(keys[i], values[i]);
+  }
+  BlockContents contents;
+  contents.data = builder.Finish();
+  Block reader(std::move(contents));
+
+  // The prefixes are only trusted with BytewiseComparator(), but the block
+  // layout must still be honored with an equivalent comparator.
+  test::SimpleSuffixReverseComparator other_cmp;
+  for (const Comparator *ucmp :
+       {BytewiseComparator(), static_cast<const Comparator *>(&other_cmp)}) {
+    std::unique_ptr<DataBlockIter> iter(
+        reader.NewDataIterator(ucmp, kDisableGlobalSequenceNumber));
+    for (size_t i = 0; i < keys.size(); i += 7) {
+      ASSERT_TRUE(iter->SeekForGet(keys[i]));
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->value(), values[i]);
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    P, BlockRestartKeyPrefixTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 16),
+        ::testing::Values(
+            BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch,
+            BlockBasedTableOptions::DataBlockIndexType::
+                kDataBlockBinaryAndHash)));
+
 // A slow and accurate version of BlockReadAmpBitmap that simply store
 // all the marked ranges in a set.
 class BlockReadAmpBitmapSlowAndAccurate {
@@ -13,13 +13,20 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+// The block footer packs, from the most significant bit down:
+//   bit 31:     data block index type (kDataBlockBinaryAndHash if set)
+//   bit 30:     restart key prefix array present (see
+//               BlockBasedTableOptions::data_block_restart_key_prefixes)
+//   bits 0-29:  number of restart points
+// Bit 30 can never be set by legacy writers, since 2^30 restarts would need a
+// block larger than 4GB.
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool has_restart_key_prefixes = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* has_restart_key_prefixes = nullptr);
 
 }  // namespace ROCKSDB_NAMESPACE
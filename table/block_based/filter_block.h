@@ -16,6 +16,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -73,6 +74,18 @@ class FilterBlockBuilder {
   // accurate regardless.)
   virtual void PrevKeyBeforeFinish(const Slice& /*prev_key_without_ts*/) {}
 
+  // Runs filter construction work handed off by a builder, e.g. on the
+  // parallel compression threads of the table builder. May run the work
+  // inline, on the calling thread.
+  using BackgroundWorkScheduler = std::function<void(std::function<void()>)>;
+
+  // Optionally starts the remaining filter construction work of Finish()
+  // (e.g. solving a Ribbon filter) in the background, if the builder was
+  // given a BackgroundWorkScheduler, so that it can overlap with other work
+  // to finish the table. May be called once, after all keys are added and
+  // PrevKeyBeforeFinish() (when needed), and before Finish().
+  virtual void StartFinishInBackground() {}
+
   // Generate a filter block. Returns OK if finished, or Incomplete if more
   // filters are needed (partitioned filter). In the latter case, subsequent
   // calls require the BlockHandle of the most recently generated and written
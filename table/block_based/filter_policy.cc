@@ -1413,6 +1413,11 @@ const char* BuiltinFilterPolicy::CompatibilityName() const {
 
 BloomLikeFilterPolicy::BloomLikeFilterPolicy(double bits_per_key)
     : warned_(false), aggregate_rounding_balance_(0) {
+  settings_ = ComputeSettings(bits_per_key);
+}
+
+BloomLikeFilterPolicy::Settings BloomLikeFilterPolicy::ComputeSettings(
+    double bits_per_key) {
   // Sanitize bits_per_key
   if (bits_per_key < 0.5) {
     // Round down to no filter
@@ -1424,24 +1429,36 @@ BloomLikeFilterPolicy::BloomLikeFilterPolicy(double bits_per_key)
     bits_per_key = 100.0;
   }
 
+  Settings settings;
   // Includes a nudge toward rounding up, to ensure on all platforms
   // that doubles specified with three decimal digits after the decimal
   // point are interpreted accurately.
-  millibits_per_key_ = static_cast<int>(bits_per_key * 1000.0 + 0.500001);
+  settings.millibits_per_key =
+      static_cast<int>(bits_per_key * 1000.0 + 0.500001);
 
   // For now configure Ribbon filter to match Bloom FP rate and save
   // memory. (Ribbon bits per key will be ~30% less than Bloom bits per key
   // for same FP rate.)
-  desired_one_in_fp_rate_ =
+  settings.desired_one_in_fp_rate =
       1.0 / BloomMath::CacheLocalFpRate(
                 bits_per_key,
-                FastLocalBloomImpl::ChooseNumProbes(millibits_per_key_),
+                FastLocalBloomImpl::ChooseNumProbes(settings.millibits_per_key),
                 /*cache_line_bits*/ 512);
 
   // For better or worse, this is a rounding up of a nudged rounding up,
   // e.g. 7.4999999999999 will round up to 8, but that provides more
   // predictability against small arithmetic errors in floating point.
-  whole_bits_per_key_ = (millibits_per_key_ + 500) / 1000;
+  settings.whole_bits_per_key = (settings.millibits_per_key + 500) / 1000;
+  return settings;
+}
+
+BloomLikeFilterPolicy::Settings BloomLikeFilterPolicy::GetSettings(
+    const FilterBuildingContext& context) const {
+  // A policy configured for no filter stays that way
+  if (context.adaptive_bits_per_key > 0 && settings_.millibits_per_key > 0) {
+    return ComputeSettings(std::max(context.adaptive_bits_per_key, 1.0));
+  }
+  return settings_;
 }
 
 BloomLikeFilterPolicy::~BloomLikeFilterPolicy() = default;
@@ -1510,17 +1527,19 @@ FilterBitsBuilder* BloomLikeFilterPolicy::GetFastLocalBloomBuilderWithContext(
         context.table_options.block_cache);
   }
   return new FastLocalBloomBitsBuilder(
-      millibits_per_key_, offm ? &aggregate_rounding_balance_ : nullptr,
+      GetSettings(context).millibits_per_key,
+      offm ? &aggregate_rounding_balance_ : nullptr,
       cache_res_mgr, context.table_options.detect_filter_construct_corruption);
 }
 
 FilterBitsBuilder* BloomLikeFilterPolicy::GetLegacyBloomBuilderWithContext(
     const FilterBuildingContext& context) const {
-  if (whole_bits_per_key_ >= 14 && context.info_log &&
+  const int whole_bits_per_key = GetSettings(context).whole_bits_per_key;
+  if (whole_bits_per_key >= 14 && context.info_log &&
       !warned_.load(std::memory_order_relaxed)) {
     warned_ = true;
     const char* adjective;
-    if (whole_bits_per_key_ >= 20) {
+    if (whole_bits_per_key >= 20) {
       adjective = "Dramatic";
     } else {
       adjective = "Significant";
@@ -1531,9 +1550,9 @@ FilterBitsBuilder* BloomLikeFilterPolicy::GetLegacyBloomBuilderWithContext(
                    "Using legacy Bloom filter with high (%d) bits/key. "
                    "%s filter space and/or accuracy improvement is available "
                    "with format_version>=5.",
-                   whole_bits_per_key_, adjective);
+                   whole_bits_per_key, adjective);
   }
-  return new LegacyBloomBitsBuilder(whole_bits_per_key_, context.info_log);
+  return new LegacyBloomBitsBuilder(whole_bits_per_key, context.info_log);
 }
 
 FilterBitsBuilder*
@@ -1558,16 +1577,17 @@ BloomLikeFilterPolicy::GetStandard128RibbonBuilderWithContext(
         CacheReservationManagerImpl<CacheEntryRole::kFilterConstruction>>(
         context.table_options.block_cache);
   }
+  const Settings settings = GetSettings(context);
   return new Standard128RibbonBitsBuilder(
-      desired_one_in_fp_rate_, millibits_per_key_,
+      settings.desired_one_in_fp_rate, settings.millibits_per_key,
       offm ? &aggregate_rounding_balance_ : nullptr, cache_res_mgr,
       context.table_options.detect_filter_construct_corruption,
       context.info_log);
 }
 
 std::string BloomLikeFilterPolicy::GetBitsPerKeySuffix() const {
-  std::string rv = ":" + std::to_string(millibits_per_key_ / 1000);
-  int frac = millibits_per_key_ % 1000;
+  std::string rv = ":" + std::to_string(settings_.millibits_per_key / 1000);
+  int frac = settings_.millibits_per_key % 1000;
   if (frac > 0) {
     rv.push_back('.');
     rv.push_back(static_cast<char>('0' + (frac / 100)));
@@ -203,9 +203,9 @@ class BloomLikeFilterPolicy : public BuiltinFilterPolicy {
   std::string GetId() const override;
 
   // Essentially for testing only: configured millibits/key
-  int GetMillibitsPerKey() const { return millibits_per_key_; }
+  int GetMillibitsPerKey() const { return settings_.millibits_per_key; }
   // Essentially for testing only: legacy whole bits/key
-  int GetWholeBitsPerKey() const { return whole_bits_per_key_; }
+  int GetWholeBitsPerKey() const { return settings_.whole_bits_per_key; }
 
   // All the different underlying implementations that a BloomLikeFilterPolicy
   // might use, as a configuration string name for a testing mode for
@@ -229,20 +229,27 @@ class BloomLikeFilterPolicy : public BuiltinFilterPolicy {
 
  private:
   // Bits per key settings are for configuring Bloom filters.
-
-  // Newer filters support fractional bits per key. For predictable behavior
-  // of 0.001-precision values across floating point implementations, we
-  // round to thousandths of a bit (on average) per key.
-  int millibits_per_key_;
-
-  // Older filters round to whole number bits per key. (There *should* be no
-  // compatibility issue with fractional bits per key, but preserving old
-  // behavior with format_version < 5 just in case.)
-  int whole_bits_per_key_;
-
-  // For configuring Ribbon filter: a desired value for 1/fp_rate. For
-  // example, 100 -> 1% fp rate.
-  double desired_one_in_fp_rate_;
+  struct Settings {
+    // Newer filters support fractional bits per key. For predictable
+    // behavior of 0.001-precision values across floating point
+    // implementations, we round to thousandths of a bit (on average) per key.
+    int millibits_per_key = 0;
+
+    // Older filters round to whole number bits per key. (There *should* be no
+    // compatibility issue with fractional bits per key, but preserving old
+    // behavior with format_version < 5 just in case.)
+    int whole_bits_per_key = 0;
+
+    // For configuring Ribbon filter: a desired value for 1/fp_rate. For
+    // example, 100 -> 1% fp rate.
+    double desired_one_in_fp_rate = 0;
+  };
+  static Settings ComputeSettings(double bits_per_key);
+  // The configured settings, unless the context carries an adaptive
+  // bits/key allocation for the file
+  Settings GetSettings(const FilterBuildingContext& context) const;
+
+  Settings settings_;
 
   // Whether relevant warnings have been logged already. (Remember so we
   // only report once per BloomFilterPolicy instance, to keep the noise down.)
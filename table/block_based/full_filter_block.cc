@@ -13,20 +13,30 @@
 #include "port/port.h"
 #include "rocksdb/filter_policy.h"
 #include "table/block_based/block_based_table_reader.h"
+#include "test_util/sync_point.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
 
 FullFilterBlockBuilder::FullFilterBlockBuilder(
     const SliceTransform* _prefix_extractor, bool whole_key_filtering,
-    FilterBitsBuilder* filter_bits_builder)
+    FilterBitsBuilder* filter_bits_builder, BackgroundWorkScheduler scheduler)
     : prefix_extractor_(_prefix_extractor),
-      whole_key_filtering_(whole_key_filtering) {
+      whole_key_filtering_(whole_key_filtering),
+      scheduler_(std::move(scheduler)) {
   assert(filter_bits_builder != nullptr);
   filter_bits_builder_.reset(filter_bits_builder);
 }
 
+FullFilterBlockBuilder::~FullFilterBlockBuilder() {
+  WaitForBackgroundWork();
+  bg_finish_status_.PermitUncheckedError();
+}
+
 size_t FullFilterBlockBuilder::EstimateEntriesAdded() {
+  if (bg_finish_started_) {
+    return bg_entries_added_;
+  }
   return filter_bits_builder_->EstimateEntriesAdded();
 }
 
@@ -48,9 +58,53 @@ void FullFilterBlockBuilder::Add(const Slice& key_without_ts) {
   }
 }
 
+void FullFilterBlockBuilder::ScheduleBackgroundWork(
+    std::function<void()> work) {
+  assert(scheduler_);
+  {
+    std::lock_guard<std::mutex> lock(bg_work_mutex_);
+    bg_work_pending_++;
+  }
+  scheduler_([this, work = std::move(work)]() {
+    work();
+    std::lock_guard<std::mutex> lock(bg_work_mutex_);
+    if (--bg_work_pending_ == 0) {
+      bg_work_cv_.notify_all();
+    }
+  });
+}
+
+void FullFilterBlockBuilder::WaitForBackgroundWork() {
+  std::unique_lock<std::mutex> lock(bg_work_mutex_);
+  bg_work_cv_.wait(lock, [this] { return bg_work_pending_ == 0; });
+}
+
+void FullFilterBlockBuilder::StartFinishInBackground() {
+  assert(!bg_finish_started_);
+  if (!HasBackgroundWorkScheduler()) {
+    return;
+  }
+  bg_entries_added_ = filter_bits_builder_->EstimateEntriesAdded();
+  bg_finish_started_ = true;
+  ScheduleBackgroundWork([this]() { BGWorkFinishFilter(); });
+}
+
+void FullFilterBlockBuilder::BGWorkFinishFilter() {
+  TEST_SYNC_POINT("FullFilterBlockBuilder::BGWorkFinishFilter");
+  bg_filter_ = filter_bits_builder_->Finish(&filter_data_, &bg_finish_status_);
+}
+
 Status FullFilterBlockBuilder::Finish(
     const BlockHandle& /*last_partition_block_handle*/, Slice* filter,
     std::unique_ptr<const char[]>* filter_owner) {
+  if (bg_finish_started_) {
+    WaitForBackgroundWork();
+    if (filter_owner != nullptr) {
+      *filter_owner = std::move(filter_data_);
+    }
+    *filter = bg_filter_;
+    return bg_finish_status_;
+  }
   Status s = Status::OK();
   *filter = filter_bits_builder_->Finish(
       filter_owner ? filter_owner : &filter_data_, &s);
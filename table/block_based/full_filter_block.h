@@ -8,7 +8,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -38,30 +40,40 @@ class FilterBitsReader;
 //
 class FullFilterBlockBuilder : public FilterBlockBuilder {
  public:
-  explicit FullFilterBlockBuilder(const SliceTransform* prefix_extractor,
-                                  bool whole_key_filtering,
-                                  FilterBitsBuilder* filter_bits_builder);
+  // With a scheduler, StartFinishInBackground() finishes the filter through
+  // it.
+  explicit FullFilterBlockBuilder(
+      const SliceTransform* prefix_extractor, bool whole_key_filtering,
+      FilterBitsBuilder* filter_bits_builder,
+      BackgroundWorkScheduler scheduler = nullptr);
   // No copying allowed
   FullFilterBlockBuilder(const FullFilterBlockBuilder&) = delete;
   void operator=(const FullFilterBlockBuilder&) = delete;
 
   // bits_builder is created in filter_policy, it should be passed in here
   // directly. and be deleted here
-  ~FullFilterBlockBuilder() {}
+  ~FullFilterBlockBuilder();
 
   void Add(const Slice& key_without_ts) override;
   void AddWithPrevKey(const Slice& key_without_ts,
                       const Slice& prev_key_without_ts) override;
 
   bool IsEmpty() const override {
+    if (bg_finish_started_) {
+      return bg_entries_added_ == 0;
+    }
     return filter_bits_builder_->EstimateEntriesAdded() == 0;
   }
   size_t EstimateEntriesAdded() override;
+  void StartFinishInBackground() override;
   Status Finish(const BlockHandle& last_partition_block_handle, Slice* filter,
                 std::unique_ptr<const char[]>* filter_owner = nullptr) override;
   using FilterBlockBuilder::Finish;
 
-  void ResetFilterBitsBuilder() override { filter_bits_builder_.reset(); }
+  void ResetFilterBitsBuilder() override {
+    WaitForBackgroundWork();
+    filter_bits_builder_.reset();
+  }
 
   Status MaybePostVerifyFilter(const Slice& filter_content) override {
     return filter_bits_builder_->MaybePostVerify(filter_content);
@@ -73,13 +85,35 @@ class FullFilterBlockBuilder : public FilterBlockBuilder {
 
   std::unique_ptr<FilterBitsBuilder> filter_bits_builder_;
 
+  bool HasBackgroundWorkScheduler() const { return scheduler_ != nullptr; }
+  // Hands work to the scheduler, to be waited for by WaitForBackgroundWork()
+  void ScheduleBackgroundWork(std::function<void()> work);
+  // Waits for all work handed off by ScheduleBackgroundWork() to finish
+  void WaitForBackgroundWork();
+
  private:
+  void BGWorkFinishFilter();
+
   // important: all of these might point to invalid addresses
   // at the time of destruction of this filter block. destructor
   // should NOT dereference them.
   const SliceTransform* const prefix_extractor_;
   const bool whole_key_filtering_;
   std::unique_ptr<const char[]> filter_data_;
+
+  BackgroundWorkScheduler scheduler_;
+  std::mutex bg_work_mutex_;
+  std::condition_variable bg_work_cv_;
+  size_t bg_work_pending_ = 0;
+
+  // Result of filter_bits_builder_->Finish() when started by
+  // StartFinishInBackground(), valid after WaitForBackgroundWork()
+  Slice bg_filter_;
+  Status bg_finish_status_;
+  // The bits builder is off limits while finishing in the background, so
+  // its entry count is saved beforehand
+  bool bg_finish_started_ = false;
+  size_t bg_entries_added_ = 0;
 };
 
 // A FilterBlockReader is used to parse filter from SST table.
@@ -0,0 +1,465 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr size_t kHeaderSize = 7 * sizeof(uint32_t);
+constexpr size_t kSegmentSize = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+constexpr uint32_t kNoGap = std::numeric_limits<uint32_t>::max();
+// Number of varying key bytes the model looks at.
+constexpr size_t kModelKeyBytes = sizeof(uint64_t);
+
+uint64_t ProjectKey(const Slice& key, const std::vector<uint32_t>& positions) {
+  uint64_t x = 0;
+  const size_t num = std::min(positions.size(), kModelKeyBytes);
+  for (size_t k = 0; k < num; ++k) {
+    const uint32_t pos = positions[k];
+    x = (x << 8) |
+        (pos < key.size() ? static_cast<unsigned char>(key[pos]) : 0);
+  }
+  return x;
+}
+
+struct Segment {
+  uint64_t key;
+  uint32_t first_block;
+  double slope;
+};
+
+// Greedily fits segments over the points (xs[i], i), such that every point is
+// predicted within `epsilon` of i by the segment it belongs to. Each segment
+// keeps the range of slopes that satisfy all its points so far, and a point
+// that narrows that range down to nothing starts a new segment.
+std::vector<Segment> FitSegments(const std::vector<uint64_t>& xs,
+                                 uint32_t epsilon) {
+  std::vector<Segment> segments;
+  double slope_lo = 0;
+  double slope_hi = 0;
+  auto finish_segment = [&]() {
+    segments.back().slope =
+        slope_hi == std::numeric_limits<double>::infinity()
+            ? 0
+            : (slope_lo + slope_hi) / 2;
+  };
+  for (size_t i = 0; i < xs.size(); ++i) {
+    if (!segments.empty()) {
+      const Segment& seg = segments.back();
+      const double dy = static_cast<double>(i - seg.first_block);
+      if (xs[i] == seg.key) {
+        if (dy <= epsilon) {
+          continue;
+        }
+      } else {
+        const double dx = static_cast<double>(xs[i] - seg.key);
+        const double lo = (dy - epsilon) / dx;
+        const double hi = (dy + epsilon) / dx;
+        if (lo <= slope_hi && hi >= slope_lo) {
+          slope_lo = std::max(slope_lo, lo);
+          slope_hi = std::min(slope_hi, hi);
+          continue;
+        }
+      }
+      finish_segment();
+    }
+    segments.push_back({xs[i], static_cast<uint32_t>(i), 0});
+    slope_lo = 0;
+    slope_hi = std::numeric_limits<double>::infinity();
+  }
+  if (!segments.empty()) {
+    finish_segment();
+  }
+  return segments;
+}
+
+class LearnedIndexBuilder : public UserDefinedIndexBuilder {
+ public:
+  explicit LearnedIndexBuilder(uint32_t epsilon) : epsilon_(epsilon) {}
+
+  Slice AddIndexEntry(const Slice& last_key_in_current_block,
+                      const Slice* /*first_key_in_next_block*/,
+                      const BlockHandle& block_handle,
+                      std::string* /*separator_scratch*/) override {
+    if (handles_.empty()) {
+      key_width_ = last_key_in_current_block.size();
+    } else if (last_key_in_current_block.size() != key_width_ &&
+               status_.ok()) {
+      status_ = Status::NotSupported(
+          "learned index requires keys of the same width");
+    }
+    if (status_.ok()) {
+      keys_.append(last_key_in_current_block.data(),
+                   last_key_in_current_block.size());
+      handles_.push_back(block_handle);
+    }
+    return last_key_in_current_block;
+  }
+
+  Status Finish(Slice* index_contents) override;
+
+ private:
+  const uint32_t epsilon_;
+  Status status_;
+  size_t key_width_ = 0;
+  // Index keys, back to back.
+  std::string keys_;
+  std::vector<BlockHandle> handles_;
+  std::string contents_;
+};
+
+Status LearnedIndexBuilder::Finish(Slice* index_contents) {
+  if (!status_.ok()) {
+    return status_;
+  }
+  const size_t n = handles_.size();
+  if (n > std::numeric_limits<uint32_t>::max()) {
+    return Status::NotSupported("too many data blocks for learned index");
+  }
+  const char* keys = keys_.data();
+
+  std::vector<uint32_t> positions;
+  for (size_t j = 0; j < key_width_; ++j) {
+    for (size_t i = 1; i < n; ++i) {
+      if (keys[i * key_width_ + j] != keys[j]) {
+        positions.push_back(static_cast<uint32_t>(j));
+        break;
+      }
+    }
+  }
+
+  // Blocks are usually written back to back, separated by their trailer, in
+  // which case the sizes follow from the offsets.
+  uint64_t gap = 0;
+  if (n >= 2) {
+    gap = handles_[1].offset - handles_[0].offset - handles_[0].size;
+  }
+  bool even = gap < kNoGap;
+  for (size_t i = 1; even && i < n; ++i) {
+    even = handles_[i].offset == handles_[i - 1].offset +
+                                     handles_[i - 1].size + gap;
+  }
+  if (!even) {
+    gap = kNoGap;
+  }
+  const uint64_t end =
+      n > 0 ? handles_[n - 1].offset + handles_[n - 1].size +
+                  (even ? gap : 0)
+            : 0;
+  const uint32_t offset_width =
+      end > std::numeric_limits<uint32_t>::max() ? 8 : 4;
+
+  std::vector<uint64_t> xs;
+  xs.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    xs.push_back(
+        ProjectKey(Slice(keys + i * key_width_, key_width_), positions));
+  }
+  const std::vector<Segment> segments = FitSegments(xs, epsilon_);
+
+  contents_.clear();
+  PutFixed32(&contents_, static_cast<uint32_t>(key_width_));
+  PutFixed32(&contents_, static_cast<uint32_t>(positions.size()));
+  PutFixed32(&contents_, static_cast<uint32_t>(n));
+  PutFixed32(&contents_, static_cast<uint32_t>(segments.size()));
+  PutFixed32(&contents_, epsilon_);
+  PutFixed32(&contents_, offset_width);
+  PutFixed32(&contents_, static_cast<uint32_t>(gap));
+  // Template
+  contents_.append(keys, key_width_);
+  for (uint32_t pos : positions) {
+    PutFixed32(&contents_, pos);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    for (uint32_t pos : positions) {
+      contents_.push_back(keys[i * key_width_ + pos]);
+    }
+  }
+  auto put_offset = [&](uint64_t offset) {
+    if (offset_width == 4) {
+      PutFixed32(&contents_, static_cast<uint32_t>(offset));
+    } else {
+      PutFixed64(&contents_, offset);
+    }
+  };
+  for (const auto& handle : handles_) {
+    put_offset(handle.offset);
+  }
+  put_offset(end);
+  if (!even) {
+    for (const auto& handle : handles_) {
+      PutFixed32(&contents_, static_cast<uint32_t>(handle.size));
+    }
+  }
+  for (const auto& seg : segments) {
+    uint64_t slope_bits;
+    static_assert(sizeof(slope_bits) == sizeof(seg.slope), "double size");
+    memcpy(&slope_bits, &seg.slope, sizeof(slope_bits));
+    PutFixed64(&contents_, seg.key);
+    PutFixed32(&contents_, seg.first_block);
+    PutFixed64(&contents_, slope_bits);
+  }
+  *index_contents = contents_;
+  return Status::OK();
+}
+
+class LearnedIndexReader : public UserDefinedIndexReader {
+ public:
+  explicit LearnedIndexReader(const Slice& block);
+
+  std::unique_ptr<UserDefinedIndexIterator> NewIterator(
+      const ReadOptions& read_options) override;
+
+  size_t ApproximateMemoryUsage() const override {
+    return sizeof(*this) + block_.size() +
+           positions_.capacity() * sizeof(uint32_t);
+  }
+
+  const Status& status() const { return status_; }
+  size_t num_blocks() const { return num_blocks_; }
+
+  // Returns the first block whose index key is >= `target`, or num_blocks()
+  // if there is none. `scratch` backs the keys compared along the way.
+  size_t LowerBound(const Slice& target, std::string* scratch) const;
+
+  // Returns the index key of block `i`, backed by `buf`.
+  Slice GetKey(size_t i, std::string* buf) const {
+    buf->assign(template_, key_width_);
+    const char* varying = keys_ + i * positions_.size();
+    for (size_t k = 0; k < positions_.size(); ++k) {
+      (*buf)[positions_[k]] = varying[k];
+    }
+    return *buf;
+  }
+
+  UserDefinedIndexBuilder::BlockHandle GetHandle(size_t i) const {
+    UserDefinedIndexBuilder::BlockHandle handle;
+    handle.offset = GetOffset(i);
+    handle.size = sizes_ != nullptr ? DecodeFixed32(sizes_ + i * 4)
+                                    : GetOffset(i + 1) - handle.offset - gap_;
+    return handle;
+  }
+
+ private:
+  uint64_t GetOffset(size_t i) const {
+    return offset_width_ == 4 ? DecodeFixed32(offsets_ + i * 4)
+                              : DecodeFixed64(offsets_ + i * 8);
+  }
+
+  size_t Predict(uint64_t x) const;
+
+  const Slice block_;
+  Status status_;
+  uint32_t key_width_ = 0;
+  uint32_t num_blocks_ = 0;
+  uint32_t num_segments_ = 0;
+  uint32_t epsilon_ = 0;
+  uint32_t offset_width_ = 4;
+  uint32_t gap_ = 0;
+  std::vector<uint32_t> positions_;
+  const char* template_ = nullptr;
+  const char* keys_ = nullptr;
+  const char* offsets_ = nullptr;
+  const char* sizes_ = nullptr;
+  const char* segments_ = nullptr;
+};
+
+class LearnedIndexIterator : public UserDefinedIndexIterator {
+ public:
+  LearnedIndexIterator(const LearnedIndexReader* reader,
+                       const ReadOptions& read_options)
+      : reader_(reader), upper_bound_(read_options.iterate_upper_bound) {}
+
+  void Prepare(const ScanOptions* /*scan_opts*/,
+               size_t /*num_opts*/) override {}
+
+  Status SeekAndGetResult(const Slice& target,
+                          IterateResult* result) override {
+    if (!reader_->status().ok()) {
+      return reader_->status();
+    }
+    cur_ = reader_->LowerBound(target, &key_buf_);
+    SetResult(IterBoundCheck::kOutOfBound, result);
+    return Status::OK();
+  }
+
+  Status NextAndGetResult(IterateResult* result) override {
+    if (cur_ < reader_->num_blocks()) {
+      if (upper_bound_ != nullptr && key_.compare(*upper_bound_) >= 0) {
+        // The following blocks only have keys past the current index key.
+        result->key = Slice();
+        result->bound_check_result = IterBoundCheck::kOutOfBound;
+        return Status::OK();
+      }
+      ++cur_;
+    }
+    SetResult(IterBoundCheck::kUnknown, result);
+    return Status::OK();
+  }
+
+  UserDefinedIndexBuilder::BlockHandle value() override {
+    return reader_->GetHandle(cur_);
+  }
+
+ private:
+  void SetResult(IterBoundCheck at_end, IterateResult* result) {
+    if (cur_ < reader_->num_blocks()) {
+      key_ = reader_->GetKey(cur_, &key_buf_);
+      result->key = key_;
+      result->bound_check_result = IterBoundCheck::kInbound;
+    } else {
+      key_ = Slice();
+      result->key = Slice();
+      result->bound_check_result = at_end;
+    }
+  }
+
+  const LearnedIndexReader* const reader_;
+  const Slice* const upper_bound_;
+  size_t cur_ = 0;
+  Slice key_;
+  std::string key_buf_;
+};
+
+LearnedIndexReader::LearnedIndexReader(const Slice& block) : block_(block) {
+  if (block_.size() < kHeaderSize) {
+    status_ = Status::Corruption("learned index block too short");
+    return;
+  }
+  const char* p = block_.data();
+  key_width_ = DecodeFixed32(p);
+  const uint32_t num_positions = DecodeFixed32(p + 4);
+  num_blocks_ = DecodeFixed32(p + 8);
+  num_segments_ = DecodeFixed32(p + 12);
+  epsilon_ = DecodeFixed32(p + 16);
+  offset_width_ = DecodeFixed32(p + 20);
+  gap_ = DecodeFixed32(p + 24);
+  const uint64_t n = num_blocks_;
+  const uint64_t expected_size =
+      kHeaderSize + key_width_ + uint64_t{num_positions} * 4 +
+      n * num_positions + (n + 1) * offset_width_ +
+      (gap_ == kNoGap ? n * 4 : 0) + uint64_t{num_segments_} * kSegmentSize;
+  if ((offset_width_ != 4 && offset_width_ != 8) ||
+      num_positions > key_width_ || (n > 0 && num_segments_ == 0) ||
+      expected_size != block_.size()) {
+    status_ = Status::Corruption("bad learned index block");
+    num_blocks_ = 0;
+    return;
+  }
+  p += kHeaderSize;
+  template_ = p;
+  p += key_width_;
+  positions_.reserve(num_positions);
+  for (uint32_t k = 0; k < num_positions; ++k, p += 4) {
+    positions_.push_back(DecodeFixed32(p));
+    if (positions_.back() >= key_width_) {
+      status_ = Status::Corruption("bad learned index key position");
+      num_blocks_ = 0;
+      return;
+    }
+  }
+  keys_ = p;
+  p += n * num_positions;
+  offsets_ = p;
+  p += (n + 1) * offset_width_;
+  if (gap_ == kNoGap) {
+    sizes_ = p;
+    p += n * 4;
+  }
+  segments_ = p;
+}
+
+std::unique_ptr<UserDefinedIndexIterator> LearnedIndexReader::NewIterator(
+    const ReadOptions& read_options) {
+  return std::make_unique<LearnedIndexIterator>(this, read_options);
+}
+
+size_t LearnedIndexReader::Predict(uint64_t x) const {
+  // Last segment starting at or before x
+  size_t left = 0;
+  size_t right = num_segments_;
+  while (left < right) {
+    const size_t mid = left + (right - left) / 2;
+    if (DecodeFixed64(segments_ + mid * kSegmentSize) <= x) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  const char* seg = segments_ + (left > 0 ? left - 1 : 0) * kSegmentSize;
+  const uint64_t key = DecodeFixed64(seg);
+  const uint32_t first_block = DecodeFixed32(seg + 8);
+  if (x <= key) {
+    return first_block;
+  }
+  const uint64_t slope_bits = DecodeFixed64(seg + 12);
+  double slope;
+  memcpy(&slope, &slope_bits, sizeof(slope));
+  const double pos = first_block + slope * static_cast<double>(x - key);
+  const size_t last = num_blocks_ - 1;
+  return pos >= static_cast<double>(last) ? last
+                                          : static_cast<size_t>(pos + 0.5);
+}
+
+size_t LearnedIndexReader::LowerBound(const Slice& target,
+                                      std::string* scratch) const {
+  const size_t n = num_blocks_;
+  if (n == 0) {
+    return 0;
+  }
+  auto less = [&](size_t i) { return GetKey(i, scratch).compare(target) < 0; };
+  const size_t pred = Predict(ProjectKey(target, positions_));
+
+  // The model is only accurate for the index keys themselves, while targets
+  // can fall anywhere between them or differ from the template, so the
+  // window around the prediction is widened until it brackets the target:
+  // blocks before `lo` have smaller keys, and block `hi` does not.
+  size_t lo = pred > epsilon_ ? pred - epsilon_ : 0;
+  size_t step = size_t{epsilon_} + 1;
+  while (lo > 0 && !less(lo - 1)) {
+    lo = lo > step ? lo - step : 0;
+    step *= 2;
+  }
+  size_t hi = std::min(n, pred + epsilon_ + 1);
+  step = size_t{epsilon_} + 1;
+  while (hi < n && less(hi)) {
+    lo = hi + 1;
+    hi = std::min(n, hi + step);
+    step *= 2;
+  }
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (less(mid)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+}  // anonymous namespace
+
+UserDefinedIndexBuilder* LearnedIndexFactory::NewBuilder() const {
+  return new LearnedIndexBuilder(epsilon_);
+}
+
+std::unique_ptr<UserDefinedIndexReader> LearnedIndexFactory::NewReader(
+    Slice& index_block) const {
+  return std::make_unique<LearnedIndexReader>(index_block);
+}
+
+std::shared_ptr<UserDefinedIndexFactory> NewLearnedIndexFactory(
+    uint32_t epsilon) {
+  return std::make_shared<LearnedIndexFactory>(epsilon);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,58 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/user_defined_index.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// LearnedIndexFactory builds a user defined index for tables whose keys all
+// have the same width. Instead of binary searching the index block, a lookup
+// predicts the position of the target among the data blocks with a piecewise
+// linear model, which is accurate to within `epsilon` blocks for the keys of
+// the table, and then searches only around the prediction.
+//
+// The index block is laid out for lookups straight out of it, without
+// decoding:
+//
+//   header:    7 x fixed32: key width, number of varying key bytes (v),
+//              number of data blocks (n), number of segments, epsilon,
+//              offset width (4 or 8), gap between blocks (kNoGap if the
+//              block sizes are stored)
+//   template:  the first index key
+//   positions: v x fixed32, the key bytes not shared by all index keys
+//   keys:      n x v bytes, the varying bytes of each index key
+//   offsets:   (n + 1) x offset width bytes, the block offsets followed by
+//              the end of the last block and its trailer
+//   sizes:     n x fixed32, only if the blocks are not evenly spaced
+//   segments:  fixed64 first key, fixed32 first block, fixed64 slope bits
+//
+// The index key of each block is its last key. The model maps the first 8
+// varying bytes of a key, read as a big-endian integer, to a block number.
+// For monotonic keys such as counters behind a fixed prefix, the stored keys
+// are only the bytes that change and the model needs very few segments.
+class LearnedIndexFactory : public UserDefinedIndexFactory {
+ public:
+  explicit LearnedIndexFactory(uint32_t epsilon) : epsilon_(epsilon) {}
+
+  static const char* kClassName() { return "learned_index"; }
+  const char* Name() const override { return kClassName(); }
+
+  UserDefinedIndexBuilder* NewBuilder() const override;
+
+  std::unique_ptr<UserDefinedIndexReader> NewReader(
+      Slice& index_block) const override;
+
+ private:
+  const uint32_t epsilon_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
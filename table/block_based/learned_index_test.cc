@@ -0,0 +1,249 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index.h"
+
+#include <algorithm>
+
+#include "port/stack_trace.h"
+#include "rocksdb/sst_file_reader.h"
+#include "rocksdb/sst_file_writer.h"
+#include "rocksdb/table.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using UdiBlockHandle = UserDefinedIndexBuilder::BlockHandle;
+
+class LearnedIndexTest : public testing::Test {
+ protected:
+  // Builds an index over `keys`, one per block, with blocks written back to
+  // back unless `uneven`.
+  std::unique_ptr<UserDefinedIndexReader> Build(
+      const std::vector<std::string>& keys, bool uneven, uint32_t epsilon) {
+    LearnedIndexFactory factory(epsilon);
+    std::unique_ptr<UserDefinedIndexBuilder> builder(factory.NewBuilder());
+    Random rnd(301);
+    handles_.clear();
+    uint64_t offset = 0;
+    std::string scratch;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      UdiBlockHandle handle{offset, 4000 + rnd.Uniform(100)};
+      handles_.push_back(handle);
+      offset += handle.size + 5 + (uneven ? rnd.Uniform(3) : 0);
+      Slice next = i + 1 < keys.size() ? Slice(keys[i + 1]) : Slice();
+      Slice sep = builder->AddIndexEntry(
+          keys[i], i + 1 < keys.size() ? &next : nullptr, handle, &scratch);
+      EXPECT_EQ(sep, keys[i]);
+    }
+    Slice contents;
+    EXPECT_OK(builder->Finish(&contents));
+    contents_ = contents.ToString();
+    Slice block(contents_);
+    return factory.NewReader(block);
+  }
+
+  // Checks that seeking to each target finds the first key >= target, and
+  // that Next() walks the following blocks.
+  void Verify(UserDefinedIndexReader* reader,
+              const std::vector<std::string>& keys,
+              const std::vector<std::string>& targets) {
+    ReadOptions ro;
+    std::unique_ptr<UserDefinedIndexIterator> iter = reader->NewIterator(ro);
+    for (const auto& target : targets) {
+      size_t expected = std::lower_bound(keys.begin(), keys.end(), target) -
+                        keys.begin();
+      IterateResult result;
+      ASSERT_OK(iter->SeekAndGetResult(target, &result));
+      if (expected == keys.size()) {
+        ASSERT_EQ(result.bound_check_result, IterBoundCheck::kOutOfBound);
+        continue;
+      }
+      ASSERT_EQ(result.bound_check_result, IterBoundCheck::kInbound);
+      ASSERT_EQ(result.key, keys[expected]) << Slice(target).ToString(true);
+      ASSERT_EQ(iter->value().offset, handles_[expected].offset);
+      ASSERT_EQ(iter->value().size, handles_[expected].size);
+      for (size_t i = expected + 1; i < std::min(keys.size(), expected + 3);
+           ++i) {
+        ASSERT_OK(iter->NextAndGetResult(&result));
+        ASSERT_EQ(result.bound_check_result, IterBoundCheck::kInbound);
+        ASSERT_EQ(result.key, keys[i]);
+        ASSERT_EQ(iter->value().offset, handles_[i].offset);
+        ASSERT_EQ(iter->value().size, handles_[i].size);
+      }
+    }
+  }
+
+  std::vector<UdiBlockHandle> handles_;
+  std::string contents_;
+};
+
+TEST_F(LearnedIndexTest, MonotonicKeys) {
+  for (bool uneven : {false, true}) {
+    for (uint32_t epsilon : {0, 1, 4, 64}) {
+      std::vector<std::string> keys;
+      for (int i = 0; i < 5000; ++i) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%04d__key___%04d", i / 7, i % 7 * 97);
+        keys.emplace_back(buf);
+      }
+      std::unique_ptr<UserDefinedIndexReader> reader =
+          Build(keys, uneven, epsilon);
+      // Only 6 of the 16 key bytes vary, and each block needs those plus
+      // its 4-byte offset, and its 4-byte size if the blocks are not evenly
+      // spaced. With a small epsilon, the model needs about one segment per
+      // prefix, i.e. per 7 blocks, as the keys jump between prefixes.
+      if (epsilon >= 4) {
+        ASSERT_LT(contents_.size(), keys.size() * (uneven ? 18 : 14));
+      }
+
+      std::vector<std::string> targets = keys;
+      targets.push_back("");
+      targets.push_back("0");
+      targets.push_back("0000__key___0000");
+      targets.push_back("0000__kez");
+      targets.push_back("9999");
+      targets.push_back("0500__key___0001");
+      targets.push_back("0700__key___9999");
+      targets.push_back(keys.back() + "x");
+      Random rnd(42);
+      for (int i = 0; i < 1000; ++i) {
+        std::string t = keys[rnd.Uniform(static_cast<int>(keys.size()))];
+        t[rnd.Uniform(16)] = static_cast<char>(rnd.Uniform(256));
+        targets.push_back(t);
+      }
+      Verify(reader.get(), keys, targets);
+    }
+  }
+}
+
+TEST_F(LearnedIndexTest, RandomKeys) {
+  Random rnd(301);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 3000; ++i) {
+    keys.push_back(rnd.RandomBinaryString(12));
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  std::unique_ptr<UserDefinedIndexReader> reader =
+      Build(keys, /*uneven=*/false, /*epsilon=*/4);
+  std::vector<std::string> targets = keys;
+  for (int i = 0; i < 1000; ++i) {
+    int len = static_cast<int>(rnd.Uniform(20));
+    targets.push_back(rnd.RandomBinaryString(len));
+  }
+  Verify(reader.get(), keys, targets);
+}
+
+TEST_F(LearnedIndexTest, FewBlocks) {
+  for (size_t n : {0, 1, 2}) {
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < n; ++i) {
+      keys.push_back("key" + std::to_string(i));
+    }
+    std::unique_ptr<UserDefinedIndexReader> reader =
+        Build(keys, /*uneven=*/false, /*epsilon=*/4);
+    Verify(reader.get(), keys, {"", "key0", "key05", "key1", "key2"});
+  }
+}
+
+TEST_F(LearnedIndexTest, UpperBound) {
+  std::vector<std::string> keys = {"a1", "a3", "a5", "a7"};
+  std::unique_ptr<UserDefinedIndexReader> reader =
+      Build(keys, /*uneven=*/false, /*epsilon=*/1);
+  ReadOptions ro;
+  Slice upper_bound("a4");
+  ro.iterate_upper_bound = &upper_bound;
+  std::unique_ptr<UserDefinedIndexIterator> iter = reader->NewIterator(ro);
+  IterateResult result;
+  ASSERT_OK(iter->SeekAndGetResult("a2", &result));
+  ASSERT_EQ(result.key, "a3");
+  // Block "a5" may hold keys below the upper bound.
+  ASSERT_OK(iter->NextAndGetResult(&result));
+  ASSERT_EQ(result.bound_check_result, IterBoundCheck::kInbound);
+  ASSERT_EQ(result.key, "a5");
+  ASSERT_OK(iter->NextAndGetResult(&result));
+  ASSERT_EQ(result.bound_check_result, IterBoundCheck::kOutOfBound);
+}
+
+TEST_F(LearnedIndexTest, VariableWidthKeys) {
+  LearnedIndexFactory factory(4);
+  std::unique_ptr<UserDefinedIndexBuilder> builder(factory.NewBuilder());
+  std::string scratch;
+  builder->AddIndexEntry("aa", nullptr, UdiBlockHandle{0, 10}, &scratch);
+  builder->AddIndexEntry("aab", nullptr, UdiBlockHandle{15, 10}, &scratch);
+  Slice contents;
+  ASSERT_TRUE(builder->Finish(&contents).IsNotSupported());
+}
+
+TEST_F(LearnedIndexTest, CorruptBlock) {
+  std::unique_ptr<UserDefinedIndexReader> reader =
+      Build({"a", "b", "c"}, /*uneven=*/false, /*epsilon=*/4);
+  contents_.pop_back();
+  Slice block(contents_);
+  reader = LearnedIndexFactory(4).NewReader(block);
+  std::unique_ptr<UserDefinedIndexIterator> iter =
+      reader->NewIterator(ReadOptions());
+  IterateResult result;
+  ASSERT_TRUE(iter->SeekAndGetResult("a", &result).IsCorruption());
+}
+
+TEST_F(LearnedIndexTest, Table) {
+  Options options;
+  BlockBasedTableOptions table_options;
+  std::shared_ptr<UserDefinedIndexFactory> factory = NewLearnedIndexFactory();
+  table_options.user_defined_index_factory = factory;
+  table_options.block_size = 256;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  const std::string file = test::PerThreadDBPath("learned_index_test.sst");
+
+  SstFileWriter writer(EnvOptions(), options);
+  ASSERT_OK(writer.Open(file));
+  const int kNumKeys = 10000;
+  auto key = [](int i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "prefix__%08d", i * 2);
+    return std::string(buf);
+  };
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(writer.Put(key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(writer.Finish());
+
+  SstFileReader reader(options);
+  ASSERT_OK(reader.Open(file));
+  ReadOptions ro;
+  ro.table_index_factory = factory.get();
+  std::unique_ptr<Iterator> iter(reader.NewIterator(ro));
+  Random rnd(301);
+  for (int n = 0; n < 1000; ++n) {
+    int i = static_cast<int>(rnd.Uniform(kNumKeys));
+    // Odd numbers fall between the keys.
+    char buf[32];
+    snprintf(buf, sizeof(buf), "prefix__%08d", i * 2 - 1);
+    iter->Seek(buf);
+    for (int j = i; j < std::min(kNumKeys, i + 3); ++j) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), key(j));
+      ASSERT_EQ(iter->value(), "value" + std::to_string(j));
+      iter->Next();
+    }
+  }
+  iter->Seek(key(kNumKeys));
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+  iter.reset();
+  ASSERT_OK(Env::Default()->DeleteFile(file));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,6 +17,7 @@
 #include "rocksdb/filter_policy.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_table_reader.h"
+#include "test_util/sync_point.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -28,12 +29,14 @@ PartitionedFilterBlockBuilder::PartitionedFilterBlockBuilder(
     PartitionedIndexBuilder* const p_index_builder,
     const uint32_t partition_size, size_t ts_sz,
     const bool persist_user_defined_timestamps,
-    bool decouple_from_index_partitions)
+    bool decouple_from_index_partitions, BackgroundWorkScheduler scheduler,
+    std::function<FilterBitsBuilder*()> new_filter_bits_builder)
     : FullFilterBlockBuilder(_prefix_extractor, whole_key_filtering,
-                             filter_bits_builder),
+                             filter_bits_builder, std::move(scheduler)),
       p_index_builder_(p_index_builder),
       ts_sz_(ts_sz),
       decouple_from_index_partitions_(decouple_from_index_partitions),
+      new_filter_bits_builder_(std::move(new_filter_bits_builder)),
       index_on_filter_block_builder_(
           index_block_restart_interval, true /*use_delta_encoding*/,
           use_value_delta_encoding,
@@ -74,12 +77,24 @@ PartitionedFilterBlockBuilder::PartitionedFilterBlockBuilder(
     // against this threshold
     keys_per_partition_--;
   }
+  assert(!HasBackgroundWorkScheduler() || new_filter_bits_builder_);
 }
 
 PartitionedFilterBlockBuilder::~PartitionedFilterBlockBuilder() {
+  // Before filters_ goes away
+  WaitForBackgroundWork();
   partitioned_filters_construction_status_.PermitUncheckedError();
 }
 
+void PartitionedFilterBlockBuilder::BGWorkFinishFilter(FilterEntry* e) {
+  TEST_SYNC_POINT("PartitionedFilterBlockBuilder::BGWorkFinishFilter");
+  e->filter = e->bits_builder->Finish(&e->filter_owner, &e->status);
+  if (e->status.ok()) {
+    e->status = e->bits_builder->MaybePostVerify(e->filter);
+  }
+  e->bits_builder.reset();
+}
+
 bool PartitionedFilterBlockBuilder::DecideCutAFilterBlock() {
   size_t added = filter_bits_builder_->EstimateEntriesAdded();
   if (decouple_from_index_partitions_) {
@@ -124,13 +139,6 @@ void PartitionedFilterBlockBuilder::CutAFilterBlock(const Slice* next_key,
 
   // Cut the partition
   total_added_in_built_ += filter_bits_builder_->EstimateEntriesAdded();
-  std::unique_ptr<const char[]> filter_data;
-  Status filter_construction_status = Status::OK();
-  Slice filter =
-      filter_bits_builder_->Finish(&filter_data, &filter_construction_status);
-  if (filter_construction_status.ok()) {
-    filter_construction_status = filter_bits_builder_->MaybePostVerify(filter);
-  }
   std::string ikey;
   if (decouple_from_index_partitions_) {
     if (ts_sz_ > 0) {
@@ -142,9 +150,27 @@ void PartitionedFilterBlockBuilder::CutAFilterBlock(const Slice* next_key,
   } else {
     ikey = p_index_builder_->GetPartitionKey();
   }
-  filters_.push_back({std::move(ikey), std::move(filter_data), filter});
-  partitioned_filters_construction_status_.UpdateIfOk(
-      filter_construction_status);
+  if (HasBackgroundWorkScheduler()) {
+    // Hand off the keys of this partition and continue with a new builder
+    filters_.push_back({std::move(ikey), nullptr, Slice(),
+                        std::move(filter_bits_builder_), Status::OK()});
+    filter_bits_builder_.reset(new_filter_bits_builder_());
+    FilterEntry* e = &filters_.back();
+    ScheduleBackgroundWork([this, e]() { BGWorkFinishFilter(e); });
+  } else {
+    std::unique_ptr<const char[]> filter_data;
+    Status filter_construction_status = Status::OK();
+    Slice filter = filter_bits_builder_->Finish(&filter_data,
+                                                &filter_construction_status);
+    if (filter_construction_status.ok()) {
+      filter_construction_status =
+          filter_bits_builder_->MaybePostVerify(filter);
+    }
+    filters_.push_back({std::move(ikey), std::move(filter_data), filter,
+                        nullptr, Status::OK()});
+    partitioned_filters_construction_status_.UpdateIfOk(
+        filter_construction_status);
+  }
 
   // If we are building another filter partition, the last prefix in the
   // previous partition should be added to support prefix SeekForPrev.
@@ -256,6 +282,12 @@ Status PartitionedFilterBlockBuilder::Finish(
     }
     // Nothing uncommitted
     assert(filter_bits_builder_->EstimateEntriesAdded() == 0);
+    if (HasBackgroundWorkScheduler()) {
+      WaitForBackgroundWork();
+      for (auto& e : filters_) {
+        partitioned_filters_construction_status_.UpdateIfOk(e.status);
+      }
+    }
   }
 
   Status s = partitioned_filters_construction_status_;
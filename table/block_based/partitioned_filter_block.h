@@ -6,6 +6,7 @@
 #pragma once
 
 #include <deque>
+#include <functional>
 #include <list>
 #include <string>
 #include <unordered_map>
@@ -26,6 +27,10 @@ class InternalKeyComparator;
 
 class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
  public:
+  // With a scheduler, the filter of each partition is finished (e.g. Ribbon
+  // banding and solving) through it, while keys for later partitions are
+  // added. Each partition then needs its own FilterBitsBuilder, which
+  // new_filter_bits_builder must provide.
   explicit PartitionedFilterBlockBuilder(
       const SliceTransform* prefix_extractor, bool whole_key_filtering,
       FilterBitsBuilder* filter_bits_builder, int index_block_restart_interval,
@@ -33,7 +38,9 @@ class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
       PartitionedIndexBuilder* const p_index_builder,
       const uint32_t partition_size, size_t ts_sz,
       const bool persist_user_defined_timestamps,
-      bool decouple_from_index_partitions);
+      bool decouple_from_index_partitions,
+      BackgroundWorkScheduler scheduler = nullptr,
+      std::function<FilterBitsBuilder*()> new_filter_bits_builder = nullptr);
 
   virtual ~PartitionedFilterBlockBuilder();
 
@@ -48,10 +55,13 @@ class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
   size_t EstimateEntriesAdded() override;
 
   void PrevKeyBeforeFinish(const Slice& prev_key_without_ts) override;
+  // Partitions are already finished in the background, if configured
+  void StartFinishInBackground() override {}
   Status Finish(const BlockHandle& last_partition_block_handle, Slice* filter,
                 std::unique_ptr<const char[]>* filter_owner = nullptr) override;
 
   void ResetFilterBitsBuilder() override {
+    WaitForBackgroundWork();
     filters_.clear();
     total_added_in_built_ = 0;
     index_on_filter_block_builder_.Reset();
@@ -75,6 +85,9 @@ class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
 
   void AddImpl(const Slice& key_without_ts, const Slice& prev_key_without_ts);
 
+  struct FilterEntry;
+  void BGWorkFinishFilter(FilterEntry* e);
+
  private:  // data
   // Currently we keep the same number of partitions for filters and indexes.
   // This would allow for some potentioal optimizations in future. If such
@@ -89,6 +102,10 @@ class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
     std::string ikey;  // internal key or separator *after* this filter
     std::unique_ptr<const char[]> filter_owner;
     Slice filter;
+    // When finishing in the background, holds the keys of this partition
+    // until the filter is finished, and then the construction status
+    std::unique_ptr<FilterBitsBuilder> bits_builder;
+    Status status;
   };
   std::deque<FilterEntry> filters_;  // list of partitioned filters and keys
                                      // used in building the index
@@ -107,6 +124,10 @@ class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
   // For Add without prev key
   std::string prev_key_without_ts_;
 
+  // For finishing filter partitions in the background. Entries of filters_
+  // are not moved by push_back, so the background work can refer to them.
+  std::function<FilterBitsBuilder*()> new_filter_bits_builder_;
+
 #ifndef NDEBUG
   // For verifying accurate previous keys are provided by the caller, so that
   // release code can be fast
@@ -9,11 +9,29 @@
 #include "table/block_based/partitioned_index_iterator.h"
 
 namespace ROCKSDB_NAMESPACE {
-void PartitionedIndexIterator::Seek(const Slice& target) { SeekImpl(&target); }
+void PartitionedIndexIterator::Seek(const Slice& target) {
+  async_read_in_progress_ = false;
+  SeekImpl(&target);
+}
 
-void PartitionedIndexIterator::SeekToFirst() { SeekImpl(nullptr); }
+void PartitionedIndexIterator::SeekAsync(const Slice& target) {
+  if (!async_read_in_progress_) {
+    SeekImpl(&target, /*async_prefetch=*/true);
+    return;
+  }
+  // Second pass. index_iter_ is still positioned from the first pass.
+  FinishAsyncPartitionedIndexBlock();
+  block_iter_.Seek(target);
+  FindKeyForward();
+}
+
+void PartitionedIndexIterator::SeekToFirst() {
+  async_read_in_progress_ = false;
+  SeekImpl(nullptr);
+}
 
-void PartitionedIndexIterator::SeekImpl(const Slice* target) {
+void PartitionedIndexIterator::SeekImpl(const Slice* target,
+                                        bool async_prefetch) {
   SavePrevIndexValue();
 
   if (target) {
@@ -27,7 +45,13 @@ void PartitionedIndexIterator::SeekImpl(const Slice* target) {
     return;
   }
 
-  InitPartitionedIndexBlock();
+  InitPartitionedIndexBlock(async_prefetch && read_options_.async_io);
+  if (async_read_in_progress_) {
+    // Status::TryAgain indicates asynchronous request for retrieval of the
+    // index partition has been submitted. SeekAsync() must be called again
+    // to retrieve it and finish the seek.
+    return;
+  }
 
   if (target) {
     block_iter_.Seek(*target);
@@ -48,6 +72,7 @@ void PartitionedIndexIterator::SeekImpl(const Slice* target) {
 }
 
 void PartitionedIndexIterator::SeekToLast() {
+  async_read_in_progress_ = false;
   SavePrevIndexValue();
   index_iter_->SeekToLast();
   if (!index_iter_->Valid()) {
@@ -72,7 +97,7 @@ void PartitionedIndexIterator::Prev() {
   FindKeyBackward();
 }
 
-void PartitionedIndexIterator::InitPartitionedIndexBlock() {
+void PartitionedIndexIterator::InitPartitionedIndexBlock(bool async_read) {
   BlockHandle partitioned_index_handle = index_iter_->value().handle;
   if (!block_iter_points_to_real_block_ ||
       partitioned_index_handle.offset() != prev_block_offset_ ||
@@ -89,18 +114,26 @@ void PartitionedIndexIterator::InitPartitionedIndexBlock() {
     //   Enabled after 2 sequential IOs when ReadOptions.readahead_size == 0.
     // Explicit user requested readahead:
     //   Enabled from the very first IO when ReadOptions.readahead_size is set.
+    //
+    // As for data blocks, an asynchronous read always creates the prefetch
+    // buffer by setting no_sequential_checking = true.
     block_prefetcher_.PrefetchIfNeeded(
         rep, partitioned_index_handle, read_options_.readahead_size,
-        is_for_compaction, /*no_sequential_checking=*/false, read_options_,
-        /*readaheadsize_cb=*/nullptr, /*is_async_io_prefetch=*/false);
+        is_for_compaction, /*no_sequential_checking=*/async_read,
+        read_options_, /*readaheadsize_cb=*/nullptr,
+        /*is_async_io_prefetch=*/async_read);
     Status s;
     table_->NewDataBlockIterator<IndexBlockIter>(
         read_options_, partitioned_index_handle, &block_iter_,
         BlockType::kIndex,
         /*get_context=*/nullptr, &lookup_context_,
         block_prefetcher_.prefetch_buffer(),
-        /*for_compaction=*/is_for_compaction, /*async_read=*/false, s,
+        /*for_compaction=*/is_for_compaction, async_read, s,
         /*use_block_cache_for_lookup=*/true);
+    if (async_read && s.IsTryAgain()) {
+      async_read_in_progress_ = true;
+      return;
+    }
     block_iter_points_to_real_block_ = true;
     // We could check upper bound here but it is complicated to reason about
     // upper bound in index iterator. On the other than, in large scans, index
@@ -109,6 +142,23 @@ void PartitionedIndexIterator::InitPartitionedIndexBlock() {
   }
 }
 
+void PartitionedIndexIterator::FinishAsyncPartitionedIndexBlock() {
+  assert(async_read_in_progress_);
+  assert(index_iter_->Valid());
+  async_read_in_progress_ = false;
+  bool is_for_compaction =
+      lookup_context_.caller == TableReaderCaller::kCompaction;
+  Status s;
+  table_->NewDataBlockIterator<IndexBlockIter>(
+      read_options_, index_iter_->value().handle, &block_iter_,
+      BlockType::kIndex,
+      /*get_context=*/nullptr, &lookup_context_,
+      block_prefetcher_.prefetch_buffer(),
+      /*for_compaction=*/is_for_compaction, /*async_read=*/false, s,
+      /*use_block_cache_for_lookup=*/false);
+  block_iter_points_to_real_block_ = true;
+}
+
 void PartitionedIndexIterator::FindKeyForward() {
   // This method's code is kept short to make it likely to be inlined.
 
@@ -43,6 +43,7 @@ class PartitionedIndexIterator : public InternalIteratorBase<IndexValue> {
   ~PartitionedIndexIterator() override {}
 
   void Seek(const Slice& target) override;
+  void SeekAsync(const Slice& target) override;
   void SeekForPrev(const Slice&) override {
     // Shouldn't be called.
     assert(false);
@@ -76,6 +77,8 @@ class PartitionedIndexIterator : public InternalIteratorBase<IndexValue> {
       return index_iter_->status();
     } else if (block_iter_points_to_real_block_) {
       return block_iter_.status();
+    } else if (async_read_in_progress_) {
+      return Status::TryAgain("Async read in progress");
     } else {
       return Status::OK();
     }
@@ -148,11 +151,19 @@ class PartitionedIndexIterator : public InternalIteratorBase<IndexValue> {
   uint64_t prev_block_offset_ = std::numeric_limits<uint64_t>::max();
   BlockCacheLookupContext lookup_context_;
   BlockPrefetcher block_prefetcher_;
+  // True if SeekAsync() submitted an asynchronous read for the index
+  // partition, which the next SeekAsync() completes.
+  bool async_read_in_progress_ = false;
 
   // If `target` is null, seek to first.
-  void SeekImpl(const Slice* target);
+  void SeekImpl(const Slice* target, bool async_prefetch = false);
 
-  void InitPartitionedIndexBlock();
+  // With `async_read`, the partition may be requested asynchronously, in
+  // which case async_read_in_progress_ is set and block_iter_ stays unset.
+  void InitPartitionedIndexBlock(bool async_read = false);
+  // Retrieves the partition requested by an asynchronous
+  // InitPartitionedIndexBlock().
+  void FinishAsyncPartitionedIndexBlock();
   void FindKeyForward();
   void FindBlockForward();
   void FindKeyBackward();
@@ -0,0 +1,98 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Helpers for the optional restart key prefix array of data blocks (see
+// BlockBasedTableOptions::data_block_restart_key_prefixes). The array holds,
+// for each restart point, the first 8 bytes of the restart key's user key
+// (zero padded), read as a big-endian integer and stored as a fixed64. With
+// a bytewise comparator these integers are non-decreasing across the restart
+// array, and comparing two of them gives the same result as comparing the
+// user keys whenever they differ.
+
+#pragma once
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+#include "util/math.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace ROCKSDB_NAMESPACE {
+
+inline uint64_t RestartKeyPrefix(const Slice& user_key) {
+  char buf[sizeof(uint64_t)] = {};
+  std::memcpy(buf, user_key.data(),
+              std::min(user_key.size(), sizeof(uint64_t)));
+  return EndianSwapValue(DecodeFixed64(buf));
+}
+
+// Counts the entries of the `num_restarts` restart key prefixes at
+// `prefixes` that are less than and greater than `prefix`.
+inline void CountRestartKeyPrefixes(const char* prefixes, uint32_t num_restarts,
+                                    uint64_t prefix, uint32_t* num_less,
+                                    uint32_t* num_greater) {
+#ifdef __AVX2__
+  // Small arrays (the common case for data blocks) are scanned in full with
+  // 4-wide unsigned compares, which avoids the unpredictable branches of a
+  // binary search.
+  if (num_restarts <= 64) {
+    // AVX2 only has a signed 64-bit compare, so flip the sign bits.
+    const __m256i sign = _mm256_set1_epi64x(int64_t{1} << 63);
+    const __m256i target = _mm256_xor_si256(
+        _mm256_set1_epi64x(static_cast<int64_t>(prefix)), sign);
+    uint32_t less = 0;
+    uint32_t greater = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= num_restarts; i += 4) {
+      const __m256i v = _mm256_xor_si256(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+              prefixes + i * sizeof(uint64_t))),
+          sign);
+      less += BitsSetToOne(static_cast<uint32_t>(_mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_cmpgt_epi64(target, v)))));
+      greater += BitsSetToOne(static_cast<uint32_t>(_mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_cmpgt_epi64(v, target)))));
+    }
+    for (; i < num_restarts; ++i) {
+      const uint64_t p = DecodeFixed64(prefixes + i * sizeof(uint64_t));
+      less += p < prefix;
+      greater += p > prefix;
+    }
+    *num_less = less;
+    *num_greater = greater;
+    return;
+  }
+#endif
+  // Binary search for the equal range, relying on the array being sorted.
+  uint32_t lo = 0;
+  uint32_t hi = num_restarts;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (DecodeFixed64(prefixes + mid * sizeof(uint64_t)) < prefix) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  *num_less = lo;
+  hi = num_restarts;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (DecodeFixed64(prefixes + mid * sizeof(uint64_t)) <= prefix) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  *num_greater = num_restarts - lo;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -295,7 +295,8 @@ class UserDefinedIndexReaderWrapper : public BlockBasedTable::IndexReader {
   }
 
   size_t ApproximateMemoryUsage() const override {
-    return reader_->ApproximateMemoryUsage();
+    return reader_->ApproximateMemoryUsage() +
+           udi_reader_->ApproximateMemoryUsage();
   }
 
   virtual void EraseFromCacheBeforeDestruction(
@@ -0,0 +1,365 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/eytzinger/eytzinger_table_builder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <string>
+
+#include "db/dbformat.h"
+#include "file/writable_file_writer.h"
+#include "logging/logging.h"
+#include "port/port.h"
+#include "table/format.h"
+#include "table/meta_blocks.h"
+#include "util/coding.h"
+#include "util/compression.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// kEytzingerTableMagicNumber was picked by running
+//    echo rocksdb.table.eytzinger | sha1sum
+// and taking the leading 64 bits.
+const uint64_t kEytzingerTableMagicNumber = 0xf20d236498f80a64ull;
+
+const std::string EytzingerTablePropertyNames::kLayout =
+    "rocksdb.eytzinger.layout";
+
+namespace {
+// Assigns the samples, in sorted order, to the nodes of the implicit tree
+// rooted at index slot k by an in-order walk, which is what makes a
+// breadth-first array of the tree searchable like a sorted array.
+void AssignSamples(uint64_t k, uint64_t num_samples, uint64_t* next_sample,
+                   std::vector<uint64_t>* sample_at_slot) {
+  if (k > num_samples) {
+    return;
+  }
+  AssignSamples(2 * k, num_samples, next_sample, sample_at_slot);
+  (*sample_at_slot)[k] = (*next_sample)++;
+  AssignSamples(2 * k + 1, num_samples, next_sample, sample_at_slot);
+}
+}  // namespace
+
+void EytzingerTableLayout::EncodeTo(std::string* dst) const {
+  PutFixed64(dst, key_slots_offset);
+  PutFixed64(dst, num_entries);
+  PutFixed64(dst, index_offset);
+  PutFixed64(dst, num_samples);
+  PutFixed64(dst, range_del_offset);
+  PutFixed64(dst, range_del_size);
+  PutFixed32(dst, slot_stride);
+  PutFixed32(dst, sample_interval);
+}
+
+Status EytzingerTableLayout::DecodeFrom(const Slice& src) {
+  Slice input = src;
+  if (!GetFixed64(&input, &key_slots_offset) ||
+      !GetFixed64(&input, &num_entries) || !GetFixed64(&input, &index_offset) ||
+      !GetFixed64(&input, &num_samples) ||
+      !GetFixed64(&input, &range_del_offset) ||
+      !GetFixed64(&input, &range_del_size) ||
+      !GetFixed32(&input, &slot_stride) ||
+      !GetFixed32(&input, &sample_interval)) {
+    return Status::Corruption("Bad Eytzinger table layout");
+  }
+  if (slot_stride < kSlotHeaderSize || sample_interval == 0) {
+    return Status::Corruption("Bad Eytzinger table slot stride");
+  }
+  return Status::OK();
+}
+
+EytzingerTableBuilder::EytzingerTableBuilder(
+    const ImmutableOptions& ioptions, const MutableCFOptions& /*moptions*/,
+    const InternalTblPropCollFactories* internal_tbl_prop_coll_factories,
+    uint32_t column_family_id, int level_at_creation, WritableFileWriter* file,
+    uint32_t index_sample_interval, const std::string& column_family_name,
+    const std::string& db_id, const std::string& db_session_id,
+    uint64_t file_number)
+    : ioptions_(ioptions),
+      file_(file),
+      index_sample_interval_(std::max(index_sample_interval, 1U)) {
+  // All the data is in one uncompressed chunk.
+  properties_.num_data_blocks = 1;
+  properties_.index_size = 0;
+  properties_.filter_size = 0;
+  properties_.format_version = 1;
+  properties_.column_family_id = column_family_id;
+  properties_.column_family_name = column_family_name;
+  properties_.db_id = db_id;
+  properties_.db_session_id = db_session_id;
+  properties_.db_host_id = ioptions.db_host_id;
+  if (!ReifyDbHostIdProperty(ioptions_.env, &properties_.db_host_id).ok()) {
+    ROCKS_LOG_INFO(ioptions_.logger, "db_host_id property will not be set");
+  }
+  properties_.orig_file_number = file_number;
+  properties_.compression_name = CompressionTypeToString(kNoCompression);
+
+  assert(internal_tbl_prop_coll_factories);
+  for (auto& factory : *internal_tbl_prop_coll_factories) {
+    assert(factory);
+    std::unique_ptr<InternalTblPropColl> collector{
+        factory->CreateInternalTblPropColl(column_family_id, level_at_creation,
+                                           ioptions.num_levels)};
+    if (collector) {
+      table_properties_collectors_.emplace_back(std::move(collector));
+    }
+  }
+}
+
+EytzingerTableBuilder::~EytzingerTableBuilder() {
+  // They are supposed to have been passed to users through Finish()
+  // if the file succeeds.
+  status_.PermitUncheckedError();
+  io_status_.PermitUncheckedError();
+}
+
+IOStatus EytzingerTableBuilder::Append(const Slice& data) {
+  IOStatus io_s = file_->Append(IOOptions(), data);
+  if (io_s.ok()) {
+    offset_ += data.size();
+  }
+  return io_s;
+}
+
+IOStatus EytzingerTableBuilder::PadToCacheLine() {
+  static const char kZeros[CACHE_LINE_SIZE] = {};
+  const size_t rem = static_cast<size_t>(offset_ % CACHE_LINE_SIZE);
+  if (rem == 0) {
+    return IOStatus::OK();
+  }
+  return Append(Slice(kZeros, CACHE_LINE_SIZE - rem));
+}
+
+void EytzingerTableBuilder::EncodeSlot(const Slice& key, uint32_t value_size,
+                                       uint64_t value_offset, uint32_t stride,
+                                       std::string* dst) {
+  const size_t start = dst->size();
+  PutFixed32(dst, static_cast<uint32_t>(key.size()));
+  PutFixed32(dst, value_size);
+  PutFixed64(dst, value_offset);
+  dst->append(key.data(), key.size());
+  dst->resize(start + stride, '\0');
+}
+
+void EytzingerTableBuilder::Add(const Slice& key, const Slice& value) {
+  assert(!closed_);
+  if (!status_.ok()) {
+    return;
+  }
+  ParsedInternalKey ikey;
+  status_ = ParseInternalKey(key, &ikey, false /* log_err_key */);
+  if (!status_.ok()) {
+    return;
+  }
+  properties_.key_largest_seqno =
+      std::max(properties_.key_largest_seqno, ikey.sequence);
+
+  if (ikey.type == kTypeRangeDeletion) {
+    PutLengthPrefixedSlice(&range_dels_, key);
+    PutLengthPrefixedSlice(&range_dels_, value);
+    properties_.num_deletions++;
+    properties_.num_range_deletions++;
+  } else {
+    if (value.size() > std::numeric_limits<uint32_t>::max()) {
+      status_ = Status::NotSupported("Value too large for Eytzinger table");
+      return;
+    }
+    // Values are streamed to the file; keys wait for Finish().
+    entries_.push_back({keys_.size() + key.size(), offset_,
+                        static_cast<uint32_t>(value.size())});
+    keys_.append(key.data(), key.size());
+    max_key_size_ = std::max(max_key_size_, key.size());
+    io_status_ = Append(value);
+    status_ = io_status_;
+    if (!status_.ok()) {
+      return;
+    }
+    if (ikey.type == kTypeDeletion || ikey.type == kTypeSingleDeletion ||
+        ikey.type == kTypeDeletionWithTimestamp) {
+      properties_.num_deletions++;
+    } else if (ikey.type == kTypeMerge) {
+      properties_.num_merge_operands++;
+    }
+  }
+  properties_.num_entries++;
+  properties_.raw_key_size += key.size();
+  properties_.raw_value_size += value.size();
+
+  NotifyCollectTableCollectorsOnAdd(key, value, offset_,
+                                    table_properties_collectors_,
+                                    ioptions_.logger);
+}
+
+Status EytzingerTableBuilder::Finish() {
+  assert(!closed_);
+  closed_ = true;
+  if (!status_.ok()) {
+    return status_;
+  }
+  properties_.data_size = offset_;
+
+  EytzingerTableLayout layout;
+  layout.num_entries = entries_.size();
+  layout.sample_interval = index_sample_interval_;
+  // A stride no larger than a cache line divides it, so that a slot never
+  // straddles two lines; larger strides are whole lines.
+  const size_t slot_size =
+      EytzingerTableLayout::kSlotHeaderSize + max_key_size_;
+  size_t stride = EytzingerTableLayout::kSlotHeaderSize;
+  while (stride < slot_size && stride < CACHE_LINE_SIZE) {
+    stride *= 2;
+  }
+  if (stride < slot_size) {
+    stride = (slot_size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE *
+             CACHE_LINE_SIZE;
+  }
+  layout.slot_stride = static_cast<uint32_t>(stride);
+
+  //  Write the following sections
+  //  1. [key slots]
+  //  2. [index slots]
+  //  3. [range deletions]
+  //  4. [meta block: properties]
+  //  5. [metaindex block]
+  //  6. [footer]
+  io_status_ = PadToCacheLine();
+  layout.key_slots_offset = offset_;
+  std::string slot;
+  uint64_t key_start = 0;
+  for (size_t i = 0; io_status_.ok() && i < entries_.size(); ++i) {
+    const EntryInfo& entry = entries_[i];
+    slot.clear();
+    EncodeSlot(Slice(keys_.data() + key_start, entry.key_end - key_start),
+               entry.value_size, entry.value_offset, layout.slot_stride,
+               &slot);
+    io_status_ = Append(slot);
+    key_start = entry.key_end;
+  }
+
+  if (io_status_.ok()) {
+    io_status_ = PadToCacheLine();
+  }
+  layout.index_offset = offset_;
+  layout.num_samples = (layout.num_entries + index_sample_interval_ - 1) /
+                       index_sample_interval_;
+  if (io_status_.ok() && layout.num_samples > 0) {
+    std::vector<uint64_t> sample_at_slot(layout.num_samples + 1);
+    uint64_t next_sample = 0;
+    AssignSamples(1, layout.num_samples, &next_sample, &sample_at_slot);
+    assert(next_sample == layout.num_samples);
+    // Slot 0 is unused so that the children of slot k are 2k and 2k+1.
+    io_status_ = Append(std::string(layout.slot_stride, '\0'));
+    for (uint64_t k = 1; io_status_.ok() && k <= layout.num_samples; ++k) {
+      const uint64_t pos = sample_at_slot[k] * index_sample_interval_;
+      const uint64_t start = pos == 0 ? 0 : entries_[pos - 1].key_end;
+      slot.clear();
+      EncodeSlot(Slice(keys_.data() + start, entries_[pos].key_end - start),
+                 0 /* value_size */, pos, layout.slot_stride, &slot);
+      io_status_ = Append(slot);
+    }
+  }
+  properties_.index_size = offset_ - layout.index_offset;
+
+  layout.range_del_offset = offset_;
+  layout.range_del_size = range_dels_.size();
+  if (io_status_.ok()) {
+    io_status_ = Append(range_dels_);
+  }
+  if (!io_status_.ok()) {
+    status_ = io_status_;
+    return status_;
+  }
+  layout.EncodeTo(
+      &properties_.user_collected_properties[EytzingerTablePropertyNames::
+                                                 kLayout]);
+
+  PropertyBlockBuilder property_block_builder;
+  // -- Add basic properties
+  property_block_builder.AddTableProperty(properties_);
+  // -- Add existing user collected properties
+  property_block_builder.Add(properties_.user_collected_properties);
+  // -- Add more user collected properties
+  UserCollectedProperties more_user_collected_properties;
+  NotifyCollectTableCollectorsOnFinish(
+      table_properties_collectors_, ioptions_.logger, &property_block_builder,
+      more_user_collected_properties, properties_.readable_properties);
+  properties_.user_collected_properties.insert(
+      more_user_collected_properties.begin(),
+      more_user_collected_properties.end());
+
+  // -- Write property block
+  BlockHandle property_block_handle;
+  property_block_handle.set_offset(offset_);
+  Slice property_block = property_block_builder.Finish();
+  property_block_handle.set_size(property_block.size());
+  io_status_ = Append(property_block);
+  if (!io_status_.ok()) {
+    status_ = io_status_;
+    return status_;
+  }
+
+  // -- Write metaindex block
+  MetaIndexBuilder meta_index_builder;
+  meta_index_builder.Add(kPropertiesBlockName, property_block_handle);
+  BlockHandle metaindex_block_handle;
+  metaindex_block_handle.set_offset(offset_);
+  Slice metaindex_block = meta_index_builder.Finish();
+  metaindex_block_handle.set_size(metaindex_block.size());
+  io_status_ = Append(metaindex_block);
+  if (!io_status_.ok()) {
+    status_ = io_status_;
+    return status_;
+  }
+
+  // Write Footer
+  FooterBuilder footer;
+  status_ = footer.Build(kEytzingerTableMagicNumber, /* format_version */ 1,
+                         offset_, kNoChecksum, metaindex_block_handle);
+  if (!status_.ok()) {
+    return status_;
+  }
+  io_status_ = Append(footer.GetSlice());
+  status_ = io_status_;
+
+  // The buffered keys are no longer needed.
+  std::string().swap(keys_);
+  std::vector<EntryInfo>().swap(entries_);
+  return status_;
+}
+
+void EytzingerTableBuilder::Abandon() { closed_ = true; }
+
+uint64_t EytzingerTableBuilder::NumEntries() const {
+  return properties_.num_entries;
+}
+
+uint64_t EytzingerTableBuilder::FileSize() const {
+  if (closed_) {
+    return offset_;
+  }
+  return offset_ + keys_.size() +
+         entries_.size() * EytzingerTableLayout::kSlotHeaderSize +
+         range_dels_.size();
+}
+
+std::string EytzingerTableBuilder::GetFileChecksum() const {
+  if (file_ != nullptr) {
+    return file_->GetFileChecksum();
+  } else {
+    return kUnknownFileChecksum;
+  }
+}
+
+const char* EytzingerTableBuilder::GetFileChecksumFuncName() const {
+  if (file_ != nullptr) {
+    return file_->GetFileChecksumFuncName();
+  } else {
+    return kUnknownFileChecksumFuncName;
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
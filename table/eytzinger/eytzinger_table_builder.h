@@ -0,0 +1,136 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/table_properties_collector.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+#include "rocksdb/table.h"
+#include "rocksdb/table_properties.h"
+#include "table/table_builder.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class WritableFileWriter;
+
+struct EytzingerTablePropertyNames {
+  // Encoded EytzingerTableLayout
+  static const std::string kLayout;
+};
+
+// Positions of the sections of an Eytzinger Table file. See
+// EytzingerTableFactory for the file layout.
+struct EytzingerTableLayout {
+  // Size of a key slot header: key size, value size and value offset.
+  static constexpr uint32_t kSlotHeaderSize = 16;
+
+  uint64_t key_slots_offset = 0;
+  uint64_t num_entries = 0;
+  uint64_t index_offset = 0;
+  // Number of index slots, not counting the unused slot 0.
+  uint64_t num_samples = 0;
+  uint64_t range_del_offset = 0;
+  uint64_t range_del_size = 0;
+  uint32_t slot_stride = 0;
+  uint32_t sample_interval = 0;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+class EytzingerTableBuilder : public TableBuilder {
+ public:
+  EytzingerTableBuilder(
+      const ImmutableOptions& ioptions, const MutableCFOptions& moptions,
+      const InternalTblPropCollFactories* internal_tbl_prop_coll_factories,
+      uint32_t column_family_id, int level_at_creation,
+      WritableFileWriter* file, uint32_t index_sample_interval,
+      const std::string& column_family_name, const std::string& db_id = "",
+      const std::string& db_session_id = "", uint64_t file_number = 0);
+  // No copying allowed
+  EytzingerTableBuilder(const EytzingerTableBuilder&) = delete;
+  void operator=(const EytzingerTableBuilder&) = delete;
+
+  // REQUIRES: Either Finish() or Abandon() has been called.
+  ~EytzingerTableBuilder();
+
+  // Add key,value to the table being constructed.
+  // REQUIRES: key is after any previously added key according to comparator.
+  // REQUIRES: Finish(), Abandon() have not been called
+  void Add(const Slice& key, const Slice& value) override;
+
+  // Return non-ok iff some error has been detected.
+  Status status() const override { return status_; }
+
+  // Return non-ok iff some error happens during IO.
+  IOStatus io_status() const override { return io_status_; }
+
+  // Finish building the table.  Stops using the file passed to the
+  // constructor after this function returns.
+  // REQUIRES: Finish(), Abandon() have not been called
+  Status Finish() override;
+
+  // Indicate that the contents of this builder should be abandoned.  Stops
+  // using the file passed to the constructor after this function returns.
+  // If the caller is not going to call Finish(), it must call Abandon()
+  // before destroying this builder.
+  // REQUIRES: Finish(), Abandon() have not been called
+  void Abandon() override;
+
+  // Number of calls to Add() so far.
+  uint64_t NumEntries() const override;
+
+  // Size of the file generated so far. Key slots are buffered in memory
+  // until Finish(), so their size is included as an estimate.
+  uint64_t FileSize() const override;
+
+  TableProperties GetTableProperties() const override { return properties_; }
+
+  // Get file checksum
+  std::string GetFileChecksum() const override;
+
+  // Get file checksum function name
+  const char* GetFileChecksumFuncName() const override;
+
+ private:
+  IOStatus Append(const Slice& data);
+  IOStatus PadToCacheLine();
+  void EncodeSlot(const Slice& key, uint32_t value_size,
+                  uint64_t value_offset, uint32_t stride, std::string* dst);
+
+  const ImmutableOptions& ioptions_;
+  std::vector<std::unique_ptr<InternalTblPropColl>>
+      table_properties_collectors_;
+
+  WritableFileWriter* file_;
+  uint64_t offset_ = 0;
+  const uint32_t index_sample_interval_;
+  Status status_;
+  IOStatus io_status_;
+  TableProperties properties_;
+
+  // Internal keys concatenated, with the end of each key and its value
+  // location. Slots can only be laid out once the longest key is known.
+  std::string keys_;
+  struct EntryInfo {
+    uint64_t key_end;
+    uint64_t value_offset;
+    uint32_t value_size;
+  };
+  std::vector<EntryInfo> entries_;
+  size_t max_key_size_ = 0;
+  // Encoded range deletions
+  std::string range_dels_;
+
+  bool closed_ = false;  // Either Finish() or Abandon() has been called.
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,91 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/eytzinger/eytzinger_table_factory.h"
+
+#include "db/dbformat.h"
+#include "options/configurable_helper.h"
+#include "rocksdb/utilities/options_type.h"
+#include "table/eytzinger/eytzinger_table_builder.h"
+#include "table/eytzinger/eytzinger_table_reader.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+Status EytzingerTableFactory::NewTableReader(
+    const ReadOptions& ro, const TableReaderOptions& table_reader_options,
+    std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+    std::unique_ptr<TableReader>* table,
+    bool /*prefetch_index_and_filter_in_cache*/) const {
+  std::unique_ptr<EytzingerTableReader> new_reader(new EytzingerTableReader(
+      ro, table_reader_options.ioptions, std::move(file), file_size,
+      table_reader_options.internal_comparator,
+      table_reader_options.immortal));
+  Status s = new_reader->status();
+  if (s.ok()) {
+    *table = std::move(new_reader);
+  }
+  return s;
+}
+
+TableBuilder* EytzingerTableFactory::NewTableBuilder(
+    const TableBuilderOptions& table_builder_options,
+    WritableFileWriter* file) const {
+  return new EytzingerTableBuilder(
+      table_builder_options.ioptions, table_builder_options.moptions,
+      table_builder_options.internal_tbl_prop_coll_factories,
+      table_builder_options.column_family_id,
+      table_builder_options.level_at_creation, file,
+      table_options_.index_sample_interval,
+      table_builder_options.column_family_name, table_builder_options.db_id,
+      table_builder_options.db_session_id, table_builder_options.cur_file_num);
+}
+
+std::string EytzingerTableFactory::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(200);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+
+  snprintf(buffer, kBufferSize, "  index_sample_interval: %u\n",
+           table_options_.index_sample_interval);
+  ret.append(buffer);
+  return ret;
+}
+
+Status EytzingerTableFactory::ValidateOptions(
+    const DBOptions& db_opts, const ColumnFamilyOptions& cf_opts) const {
+  if (table_options_.index_sample_interval == 0) {
+    return Status::InvalidArgument(
+        "index_sample_interval must be at least 1");
+  }
+  if (cf_opts.comparator != nullptr &&
+      cf_opts.comparator->timestamp_size() > 0 &&
+      !cf_opts.persist_user_defined_timestamps) {
+    return Status::NotSupported(
+        "Eytzinger table requires persist_user_defined_timestamps");
+  }
+  return TableFactory::ValidateOptions(db_opts, cf_opts);
+}
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    eytzinger_table_type_info = {
+        {"index_sample_interval",
+         {offsetof(struct EytzingerTableOptions, index_sample_interval),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+EytzingerTableFactory::EytzingerTableFactory(
+    const EytzingerTableOptions& table_options)
+    : table_options_(table_options) {
+  RegisterOptions(&table_options_, &eytzinger_table_type_info);
+}
+
+TableFactory* NewEytzingerTableFactory(
+    const EytzingerTableOptions& table_options) {
+  return new EytzingerTableFactory(table_options);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,71 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+
+#include "rocksdb/options.h"
+#include "rocksdb/table.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Eytzinger Table is an uncompressed, pointer-free table format for
+// read-mostly data that is served from memory (tmpfs or the page cache).
+//
+// File layout:
+//   [values]               values concatenated in key order
+//   [key slots]            one fixed-stride slot per entry, sorted
+//   [index slots]          every index_sample_interval-th key slot, in
+//                          Eytzinger (breadth-first) order, 1-based
+//   [range deletions]      length-prefixed (start key, end key) pairs
+//   [properties]
+//   [metaindex]
+//   [footer]
+//
+// Both slot arrays start on a cache line boundary and the slot stride is
+// either a power of two no larger than a cache line or a multiple of it, so
+// no slot straddles more cache lines than necessary. Each slot holds
+//   fixed32 key_size, fixed32 value_size, fixed64 value_offset, internal key
+// (index slots store the sorted position of the sampled key instead of a
+// value location). The positions of the sections are kept in the
+// kLayout user collected property.
+class EytzingerTableFactory : public TableFactory {
+ public:
+  explicit EytzingerTableFactory(
+      const EytzingerTableOptions& table_options = EytzingerTableOptions());
+  ~EytzingerTableFactory() {}
+
+  // Method to allow CheckedCast to work for this class
+  static const char* kClassName() { return kEytzingerTableName(); }
+  const char* Name() const override { return kEytzingerTableName(); }
+
+  using TableFactory::NewTableReader;
+  Status NewTableReader(
+      const ReadOptions& ro, const TableReaderOptions& table_reader_options,
+      std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+      std::unique_ptr<TableReader>* table,
+      bool prefetch_index_and_filter_in_cache = true) const override;
+
+  TableBuilder* NewTableBuilder(
+      const TableBuilderOptions& table_builder_options,
+      WritableFileWriter* file) const override;
+
+  std::string GetPrintableOptions() const override;
+
+  Status ValidateOptions(const DBOptions& db_opts,
+                         const ColumnFamilyOptions& cf_opts) const override;
+
+  std::unique_ptr<TableFactory> Clone() const override {
+    return std::make_unique<EytzingerTableFactory>(*this);
+  }
+
+  bool IsDeleteRangeSupported() const override { return true; }
+
+ private:
+  EytzingerTableOptions table_options_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
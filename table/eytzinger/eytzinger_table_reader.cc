@@ -0,0 +1,380 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/eytzinger/eytzinger_table_reader.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "file/file_util.h"
+#include "memory/arena.h"
+#include "options/cf_options.h"
+#include "port/port.h"
+#include "rocksdb/snapshot.h"
+#include "table/get_context.h"
+#include "table/internal_iterator.h"
+#include "table/meta_blocks.h"
+#include "util/math.h"
+#include "util/vector_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+EytzingerTableReader::EytzingerTableReader(
+    const ReadOptions& read_options, const ImmutableOptions& ioptions,
+    std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+    const InternalKeyComparator& icomparator, bool immortal_table)
+    : file_(std::move(file)), icomparator_(icomparator) {
+  {
+    std::unique_ptr<TableProperties> props;
+    status_ =
+        ReadTableProperties(file_.get(), file_size, kEytzingerTableMagicNumber,
+                            ioptions, read_options, &props);
+    if (!status_.ok()) {
+      return;
+    }
+    table_props_ = std::move(props);
+  }
+  auto& user_props = table_props_->user_collected_properties;
+  auto layout = user_props.find(EytzingerTablePropertyNames::kLayout);
+  if (layout == user_props.end()) {
+    status_ = Status::Corruption("Eytzinger table layout not found");
+    return;
+  }
+  status_ = layout_.DecodeFrom(layout->second);
+  if (!status_.ok()) {
+    return;
+  }
+  const uint64_t slots_end =
+      layout_.index_offset +
+      (layout_.num_samples > 0 ? layout_.num_samples + 1 : 0) *
+          layout_.slot_stride;
+  if (layout_.key_slots_offset +
+              layout_.num_entries * layout_.slot_stride >
+          layout_.index_offset ||
+      slots_end > layout_.range_del_offset ||
+      layout_.range_del_offset + layout_.range_del_size > file_size) {
+    status_ = Status::Corruption("Eytzinger table layout out of range");
+    return;
+  }
+
+  if (ioptions.allow_mmap_reads) {
+    // Only maps the file, so there is nothing to rate limit.
+    status_ = file_->Read(IOOptions(), 0, static_cast<size_t>(file_size),
+                          &file_data_, nullptr, nullptr);
+  } else {
+    IOOptions opts;
+    status_ = PrepareIOFromReadOptions(read_options, ioptions.clock, opts);
+    if (!status_.ok()) {
+      return;
+    }
+    // Keep the slot arrays cache line aligned in memory, as they are in the
+    // file.
+    buf_.reset(new char[file_size + CACHE_LINE_SIZE]);
+    char* aligned = buf_.get() + (CACHE_LINE_SIZE -
+                                  reinterpret_cast<uintptr_t>(buf_.get()) %
+                                      CACHE_LINE_SIZE) %
+                                     CACHE_LINE_SIZE;
+    // The read is split into rate limiter requests if
+    // read_options.rate_limiter_priority is not Env::IO_TOTAL.
+    status_ = file_->Read(opts, 0, static_cast<size_t>(file_size),
+                          &file_data_, aligned, nullptr);
+  }
+  if (!status_.ok()) {
+    return;
+  }
+  if (file_data_.size() != file_size) {
+    status_ = Status::Corruption("Truncated Eytzinger table file");
+    return;
+  }
+  key_slots_ = file_data_.data() + layout_.key_slots_offset;
+  index_slots_ = file_data_.data() + layout_.index_offset;
+  status_ = ValidateSlots();
+  if (!status_.ok()) {
+    return;
+  }
+  status_ = LoadRangeDeletions();
+  if (status_.ok() && immortal_table) {
+    dummy_cleanable_.reset(new Cleanable());
+  }
+}
+
+Status EytzingerTableReader::ValidateSlots() const {
+  const uint64_t max_key_size =
+      layout_.slot_stride - EytzingerTableLayout::kSlotHeaderSize;
+  const uint64_t data_size = table_props_->data_size;
+  if (data_size > layout_.key_slots_offset) {
+    return Status::Corruption("Eytzinger table data size out of range");
+  }
+  for (uint64_t pos = 0; pos < layout_.num_entries; ++pos) {
+    const char* slot = KeySlot(pos);
+    const uint64_t value_size = DecodeFixed32(slot + 4);
+    const uint64_t value_offset = DecodeFixed64(slot + 8);
+    if (DecodeFixed32(slot) > max_key_size) {
+      return Status::Corruption("Eytzinger table key size out of range");
+    }
+    if (value_offset > data_size || value_size > data_size - value_offset) {
+      return Status::Corruption("Eytzinger table value out of range");
+    }
+  }
+  for (uint64_t k = 1; k <= layout_.num_samples; ++k) {
+    const char* slot = IndexSlot(k);
+    if (DecodeFixed32(slot) > max_key_size) {
+      return Status::Corruption("Eytzinger table key size out of range");
+    }
+    if (DecodeFixed64(slot + 8) >= layout_.num_entries) {
+      return Status::Corruption("Eytzinger table index entry out of range");
+    }
+  }
+  return Status::OK();
+}
+
+Status EytzingerTableReader::LoadRangeDeletions() {
+  if (layout_.range_del_size == 0) {
+    return Status::OK();
+  }
+  Slice input(file_data_.data() + layout_.range_del_offset,
+              static_cast<size_t>(layout_.range_del_size));
+  std::vector<std::string> start_keys;
+  std::vector<std::string> end_keys;
+  while (!input.empty()) {
+    Slice start_key;
+    Slice end_key;
+    if (!GetLengthPrefixedSlice(&input, &start_key) ||
+        !GetLengthPrefixedSlice(&input, &end_key)) {
+      return Status::Corruption("Bad Eytzinger table range deletion");
+    }
+    start_keys.emplace_back(start_key.data(), start_key.size());
+    end_keys.emplace_back(end_key.data(), end_key.size());
+  }
+  std::unique_ptr<InternalIterator> iter(new VectorIterator(
+      std::move(start_keys), std::move(end_keys), &icomparator_));
+  fragmented_range_dels_ = std::make_shared<FragmentedRangeTombstoneList>(
+      std::move(iter), icomparator_);
+  return Status::OK();
+}
+
+uint64_t EytzingerTableReader::LowerBound(const Slice& target) const {
+  const uint64_t num_samples = layout_.num_samples;
+  // Descend the implicit tree; k ends up as the would-be child of the last
+  // node, with the path taken encoded in its bits.
+  uint64_t k = 1;
+  while (k <= num_samples) {
+    // The four grandchildren of k are adjacent, so fetching them now hides
+    // the latency of the next two levels behind this comparison.
+    const uint64_t grandchild = 4 * k;
+    if (grandchild <= num_samples) {
+      const char* first = IndexSlot(grandchild);
+      const char* last = IndexSlot(std::min(grandchild + 3, num_samples));
+      for (const char* p = first; p <= last; p += CACHE_LINE_SIZE) {
+        PREFETCH(p, 0, 3);
+      }
+    }
+    k = 2 * k +
+        (icomparator_.Compare(SlotKey(IndexSlot(k)), target) < 0 ? 1 : 0);
+  }
+  // Undo the right turns taken after the last left turn to get the node of
+  // the smallest sample at or after target, or 0 if there is none.
+  k >>= CountTrailingZeroBits(~k) + 1;
+
+  const uint64_t interval = layout_.sample_interval;
+  uint64_t begin;
+  uint64_t end;
+  if (k == 0) {
+    // Every sample is before target.
+    if (num_samples == 0) {
+      return 0;
+    }
+    begin = (num_samples - 1) * interval + 1;
+    end = layout_.num_entries;
+  } else {
+    end = DecodeFixed64(IndexSlot(k) + 8);
+    if (end == 0) {
+      return 0;
+    }
+    begin = end - interval + 1;
+  }
+  // The sample at begin - 1 is before target and the one at end (if any) is
+  // not, so a short scan over adjacent slots settles it.
+  for (uint64_t pos = begin; pos < end; ++pos) {
+    if (icomparator_.Compare(SlotKey(KeySlot(pos)), target) >= 0) {
+      return pos;
+    }
+  }
+  return end;
+}
+
+Status EytzingerTableReader::Get(const ReadOptions& /*readOptions*/,
+                                 const Slice& key, GetContext* get_context,
+                                 const SliceTransform* /* prefix_extractor */,
+                                 bool /*skip_filters*/) {
+  Status s;
+  ParsedInternalKey found_key;
+  for (uint64_t pos = LowerBound(key); pos < layout_.num_entries; ++pos) {
+    const char* slot = KeySlot(pos);
+    s = ParseInternalKey(SlotKey(slot), &found_key, false /* log_err_key */);
+    if (!s.ok()) {
+      return s;
+    }
+    bool dont_care __attribute__((__unused__));
+    bool ret = get_context->SaveValue(found_key, SlotValue(slot), &dont_care,
+                                      &s, dummy_cleanable_.get());
+    if (!s.ok()) {
+      return s;
+    }
+    if (!ret) {
+      break;
+    }
+  }
+  return s;
+}
+
+void EytzingerTableReader::Prepare(const Slice& /*target*/) {
+  // Warm the first levels of the index, which every lookup goes through.
+  if (layout_.num_samples > 0) {
+    const char* end =
+        IndexSlot(std::min<uint64_t>(layout_.num_samples, 15) + 1);
+    for (const char* p = IndexSlot(1); p < end; p += CACHE_LINE_SIZE) {
+      PREFETCH(p, 0, 3);
+    }
+  }
+}
+
+uint64_t EytzingerTableReader::ApproximateOffsetOf(
+    const ReadOptions& /*read_options*/, const Slice& key,
+    TableReaderCaller /*caller*/) {
+  // Values are stored in key order at the start of the file, so the offset
+  // of the value of the first entry at or after key is exact for the values
+  // and ignores the slot arrays.
+  const uint64_t pos = LowerBound(key);
+  if (pos >= layout_.num_entries) {
+    return table_props_->data_size;
+  }
+  return DecodeFixed64(KeySlot(pos) + 8);
+}
+
+uint64_t EytzingerTableReader::ApproximateSize(
+    const ReadOptions& read_options, const Slice& start, const Slice& end,
+    TableReaderCaller caller) {
+  const uint64_t start_offset =
+      ApproximateOffsetOf(read_options, start, caller);
+  const uint64_t end_offset = ApproximateOffsetOf(read_options, end, caller);
+  assert(end_offset >= start_offset);
+  return end_offset - start_offset;
+}
+
+size_t EytzingerTableReader::ApproximateMemoryUsage() const {
+  return buf_ != nullptr ? file_data_.size() : 0;
+}
+
+FragmentedRangeTombstoneIterator*
+EytzingerTableReader::NewRangeTombstoneIterator(
+    const ReadOptions& read_options) {
+  if (fragmented_range_dels_ == nullptr) {
+    return nullptr;
+  }
+  SequenceNumber snapshot = kMaxSequenceNumber;
+  if (read_options.snapshot != nullptr) {
+    snapshot = read_options.snapshot->GetSequenceNumber();
+  }
+  return new FragmentedRangeTombstoneIterator(
+      fragmented_range_dels_, icomparator_, snapshot, read_options.timestamp);
+}
+
+FragmentedRangeTombstoneIterator*
+EytzingerTableReader::NewRangeTombstoneIterator(SequenceNumber read_seqno,
+                                                const Slice* timestamp) {
+  if (fragmented_range_dels_ == nullptr) {
+    return nullptr;
+  }
+  return new FragmentedRangeTombstoneIterator(
+      fragmented_range_dels_, icomparator_, read_seqno, timestamp);
+}
+
+class EytzingerTableIterator : public InternalIterator {
+ public:
+  explicit EytzingerTableIterator(const EytzingerTableReader* reader)
+      : reader_(reader), pos_(reader->layout_.num_entries) {}
+  // No copying allowed
+  EytzingerTableIterator(const EytzingerTableIterator&) = delete;
+  void operator=(const Iterator&) = delete;
+  ~EytzingerTableIterator() override = default;
+
+  bool Valid() const override { return pos_ < reader_->layout_.num_entries; }
+
+  void SeekToFirst() override { pos_ = 0; }
+
+  void SeekToLast() override { SetPrevOf(reader_->layout_.num_entries); }
+
+  void Seek(const Slice& target) override {
+    pos_ = reader_->LowerBound(target);
+  }
+
+  void SeekForPrev(const Slice& target) override {
+    const uint64_t pos = reader_->LowerBound(target);
+    if (pos < reader_->layout_.num_entries &&
+        reader_->icomparator_.Compare(key(pos), target) <= 0) {
+      pos_ = pos;
+    } else {
+      SetPrevOf(pos);
+    }
+  }
+
+  void Next() override {
+    assert(Valid());
+    ++pos_;
+  }
+
+  void Prev() override {
+    assert(Valid());
+    SetPrevOf(pos_);
+  }
+
+  Slice key() const override {
+    assert(Valid());
+    return key(pos_);
+  }
+
+  Slice value() const override {
+    assert(Valid());
+    return reader_->SlotValue(reader_->KeySlot(pos_));
+  }
+
+  Status status() const override { return Status::OK(); }
+
+  // The file contents outlive the iterator.
+  bool IsKeyPinned() const override { return true; }
+  bool IsValuePinned() const override { return true; }
+
+ private:
+  Slice key(uint64_t pos) const {
+    return EytzingerTableReader::SlotKey(reader_->KeySlot(pos));
+  }
+
+  void SetPrevOf(uint64_t pos) {
+    pos_ = pos == 0 ? reader_->layout_.num_entries : pos - 1;
+  }
+
+  const EytzingerTableReader* reader_;
+  uint64_t pos_;
+};
+
+InternalIterator* EytzingerTableReader::NewIterator(
+    const ReadOptions& /*read_options*/,
+    const SliceTransform* /* prefix_extractor */, Arena* arena,
+    bool /*skip_filters*/, TableReaderCaller /*caller*/,
+    size_t /*compaction_readahead_size*/, bool /* allow_unprepared_value */) {
+  if (!status().ok()) {
+    return NewErrorInternalIterator<Slice>(status(), arena);
+  }
+  if (arena == nullptr) {
+    return new EytzingerTableIterator(this);
+  }
+  auto iter_mem = arena->AllocateAligned(sizeof(EytzingerTableIterator));
+  return new (iter_mem) EytzingerTableIterator(this);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
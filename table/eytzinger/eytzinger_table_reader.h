@@ -0,0 +1,126 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <memory>
+#include <string>
+
+#include "db/dbformat.h"
+#include "db/range_tombstone_fragmenter.h"
+#include "file/random_access_file_reader.h"
+#include "rocksdb/options.h"
+#include "table/eytzinger/eytzinger_table_builder.h"
+#include "table/table_reader.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Arena;
+struct ImmutableOptions;
+
+// Reader for the Eytzinger Table format. See EytzingerTableFactory for the
+// file layout. The whole file is mapped (allow_mmap_reads) or loaded into a
+// cache-line-aligned buffer when the reader is opened, subject to the rate
+// limiter at the priority of the ReadOptions it is opened with; after that no
+// I/O and no block cache lookups happen. Every slot is checked against the
+// file layout on open, so lookups can trust them.
+//
+// Get() walks the Eytzinger index from the root, prefetching the slots of
+// the next levels while comparing, which locates the group of at most
+// index_sample_interval adjacent key slots holding the key. The top of the
+// index is shared by every lookup and stays cache resident, so a lookup
+// typically misses on the last index levels, the key slot and the value.
+class EytzingerTableReader : public TableReader {
+ public:
+  EytzingerTableReader(const ReadOptions& read_options,
+                       const ImmutableOptions& ioptions,
+                       std::unique_ptr<RandomAccessFileReader>&& file,
+                       uint64_t file_size,
+                       const InternalKeyComparator& icomparator,
+                       bool immortal_table);
+  ~EytzingerTableReader() {}
+
+  std::shared_ptr<const TableProperties> GetTableProperties() const override {
+    return table_props_;
+  }
+
+  Status status() const { return status_; }
+
+  Status Get(const ReadOptions& readOptions, const Slice& key,
+             GetContext* get_context, const SliceTransform* prefix_extractor,
+             bool skip_filters = false) override;
+
+  // Returns a new iterator over table contents
+  InternalIterator* NewIterator(const ReadOptions&,
+                                const SliceTransform* prefix_extractor,
+                                Arena* arena, bool skip_filters,
+                                TableReaderCaller caller,
+                                size_t compaction_readahead_size = 0,
+                                bool allow_unprepared_value = false) override;
+
+  FragmentedRangeTombstoneIterator* NewRangeTombstoneIterator(
+      const ReadOptions& read_options) override;
+
+  FragmentedRangeTombstoneIterator* NewRangeTombstoneIterator(
+      SequenceNumber read_seqno, const Slice* timestamp) override;
+
+  void Prepare(const Slice& target) override;
+
+  // Report an approximation of how much memory has been used.
+  size_t ApproximateMemoryUsage() const override;
+
+  uint64_t ApproximateOffsetOf(const ReadOptions& read_options,
+                               const Slice& key,
+                               TableReaderCaller caller) override;
+
+  uint64_t ApproximateSize(const ReadOptions& read_options, const Slice& start,
+                           const Slice& end, TableReaderCaller caller) override;
+
+  void SetupForCompaction() override {}
+
+ private:
+  friend class EytzingerTableIterator;
+
+  const char* KeySlot(uint64_t pos) const {
+    return key_slots_ + pos * layout_.slot_stride;
+  }
+  const char* IndexSlot(uint64_t k) const {
+    return index_slots_ + k * layout_.slot_stride;
+  }
+  static Slice SlotKey(const char* slot) {
+    return Slice(slot + EytzingerTableLayout::kSlotHeaderSize,
+                 DecodeFixed32(slot));
+  }
+  Slice SlotValue(const char* slot) const {
+    return Slice(file_data_.data() + DecodeFixed64(slot + 8),
+                 DecodeFixed32(slot + 4));
+  }
+
+  // Returns the position of the first entry whose internal key is at or
+  // after target, or layout_.num_entries if there is none.
+  uint64_t LowerBound(const Slice& target) const;
+
+  // Returns Corruption if a key or value of a slot is outside of it or of the
+  // data section, or an index slot points past the entries.
+  Status ValidateSlots() const;
+
+  Status LoadRangeDeletions();
+
+  std::unique_ptr<RandomAccessFileReader> file_;
+  const InternalKeyComparator& icomparator_;
+  // Backs file_data_ unless the file is memory mapped.
+  std::unique_ptr<char[]> buf_;
+  Slice file_data_;
+  const char* key_slots_ = nullptr;
+  const char* index_slots_ = nullptr;
+  EytzingerTableLayout layout_;
+  std::shared_ptr<const TableProperties> table_props_;
+  std::shared_ptr<FragmentedRangeTombstoneList> fragmented_range_dels_;
+  // Lets Get() pin values in place when the mapping outlives the reader.
+  std::unique_ptr<Cleanable> dummy_cleanable_;
+  Status status_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
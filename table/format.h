@@ -42,6 +42,8 @@ extern const uint64_t kPlainTableMagicNumber;
 
 extern const uint64_t kCuckooTableMagicNumber;
 
+extern const uint64_t kEytzingerTableMagicNumber;
+
 // BlockHandle is a pointer to the extent of a file that stores a data
 // block or a meta block.
 class BlockHandle {
@@ -64,6 +64,13 @@ class InternalIteratorBase : public Cleanable {
   // 'target' contains user timestamp if timestamp is enabled.
   virtual void Seek(const Slice& target) = 0;
 
+  // Same as Seek(), for callers that can handle asynchronous IO (see
+  // ReadOptions::async_io). An implementation may submit asynchronous reads
+  // for the blocks the seek needs and return with status() TryAgain, in which
+  // case the caller must call SeekAsync() again with the same target to
+  // complete the seek. By default this is a synchronous Seek().
+  virtual void SeekAsync(const Slice& target) { Seek(target); }
+
   // Position at the first key in the source that at or before target
   // The iterator is Valid() after this call iff the source contains
   // an entry that comes at or before target.
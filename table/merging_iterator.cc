@@ -594,6 +594,15 @@ class MergingIterator : public InternalIterator {
   void SeekImpl(const Slice& target, size_t starting_level = 0,
                 bool range_tombstone_reseek = false);
 
+  // With ReadOptions::async_io, the max number of additional Seek() passes
+  // SeekImpl() makes over children that report Status::TryAgain. A block based
+  // table child needs one for its data block, plus one for a partitioned index
+  // partition. A child still reporting Status::TryAgain after the last pass is
+  // not retried: its status becomes the status of the MergingIterator, so a
+  // reader or file system that keeps deferring its reads fails the Seek()
+  // instead of spinning in it.
+  static constexpr int kMaxAsyncSeekPasses = 2;
+
   // Seek to fist key <= target key (internal key) for
   // children_[starting_level:].
   void SeekForPrevImpl(const Slice& target, size_t starting_level = 0,
@@ -900,26 +909,55 @@ void MergingIterator::SeekImpl(const Slice& target, size_t starting_level,
     }
   }
 
+  // Complete the asynchronous seeks. A child may need more than one more pass,
+  // e.g. one to retrieve an index partition and submit the read for the data
+  // block it points to, and one to retrieve that data block. Each pass goes
+  // over all pending children, so their reads stay in flight together. The
+  // passes are capped by kMaxAsyncSeekPasses.
   if (range_tombstone_iters_.empty()) {
-    for (auto& child : children_) {
-      if (child.iter.status().IsTryAgain()) {
-        child.iter.Seek(target);
+    for (int pass = 1; pass <= kMaxAsyncSeekPasses; ++pass) {
+      bool pending = false;
+      for (auto& child : children_) {
+        if (child.iter.status().IsTryAgain()) {
+          child.iter.Seek(target);
+          PERF_COUNTER_ADD(number_async_seek, 1);
+          if (pass < kMaxAsyncSeekPasses && child.iter.status().IsTryAgain()) {
+            pending = true;
+            continue;
+          }
+          {
+            PERF_TIMER_GUARD(seek_min_heap_time);
+            AddToMinHeapOrCheckStatus(&child);
+          }
+        }
+      }
+      if (!pending) {
+        break;
+      }
+    }
+  } else {
+    for (int pass = 1; pass <= kMaxAsyncSeekPasses; ++pass) {
+      bool pending = false;
+      for (auto& prefetch : prefetched_target) {
+        // (level, target) pairs
+        auto& child = children_[prefetch.first];
+        if (pass > 1 && !child.iter.status().IsTryAgain()) {
+          continue;
+        }
+        child.iter.Seek(prefetch.second);
+        PERF_COUNTER_ADD(number_async_seek, 1);
+        if (pass < kMaxAsyncSeekPasses && child.iter.status().IsTryAgain()) {
+          pending = true;
+          continue;
+        }
         {
           PERF_TIMER_GUARD(seek_min_heap_time);
           AddToMinHeapOrCheckStatus(&child);
         }
-        PERF_COUNTER_ADD(number_async_seek, 1);
       }
-    }
-  } else {
-    for (auto& prefetch : prefetched_target) {
-      // (level, target) pairs
-      children_[prefetch.first].iter.Seek(prefetch.second);
-      {
-        PERF_TIMER_GUARD(seek_min_heap_time);
-        AddToMinHeapOrCheckStatus(&children_[prefetch.first]);
+      if (!pending) {
+        break;
       }
-      PERF_COUNTER_ADD(number_async_seek, 1);
     }
   }
 }
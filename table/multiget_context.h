@@ -11,6 +11,7 @@
 #include "db/dbformat.h"
 #include "db/lookup_key.h"
 #include "db/merge_context.h"
+#include "rocksdb/cleanable.h"
 #include "rocksdb/env.h"
 #include "rocksdb/options.h"
 #include "rocksdb/statistics.h"
@@ -151,6 +152,17 @@ class MultiGetContext {
     }
   }
 
+  // When set, values found in memtables are returned pinned in place rather
+  // than copied, with their lifetime tied to `pinner` (which must keep the
+  // memtables alive, e.g. by holding a SuperVersion reference).
+  void SetMemTableValuePinner(SharedCleanablePtr* pinner) {
+    memtable_value_pinner_ = pinner;
+  }
+
+  SharedCleanablePtr* memtable_value_pinner() const {
+    return memtable_value_pinner_;
+  }
+
 #if USE_COROUTINES
   SingleThreadExecutor& executor() { return executor_; }
 
@@ -168,6 +180,7 @@ class MultiGetContext {
   uint64_t value_size_;
   std::unique_ptr<char[]> lookup_key_heap_buf;
   LookupKey* lookup_key_ptr_;
+  SharedCleanablePtr* memtable_value_pinner_ = nullptr;
 #if USE_COROUTINES
   AsyncFileReader reader_;
   SingleThreadExecutor executor_;
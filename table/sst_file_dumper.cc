@@ -451,6 +451,11 @@ Status SstFileDumper::SetTableOptionsByMagicNumber(
     if (!silent_) {
       fprintf(stdout, "Sst file format: cuckoo table\n");
     }
+  } else if (table_magic_number == kEytzingerTableMagicNumber) {
+    options_.table_factory.reset(NewEytzingerTableFactory());
+    if (!silent_) {
+      fprintf(stdout, "Sst file format: eytzinger table\n");
+    }
   } else {
     char error_msg_buffer[80];
     snprintf(error_msg_buffer, sizeof(error_msg_buffer) - 1,
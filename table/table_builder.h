@@ -168,9 +168,24 @@ struct TableBuilderOptions : public TablePropertiesCollectorFactory::Context {
   // want to skip filters, that should be (for example) null filter_policy
   // in the table options of the ioptions.table_factory
   bool skip_filters = false;
+  // If positive, bits per key for the filter of the new file, allocated from
+  // filter_memory_budget_bits_per_key. See
+  // VersionStorageInfo::ComputeFilterBitsAllocation().
+  double adaptive_filter_bits_per_key = 0.0;
   const uint64_t cur_file_num;
 };
 
+// Time a TableBuilder spent in the stages of Finish(), in nanoseconds
+struct TableBuilderFinishTimes {
+  // Writing out the remaining data blocks, including waiting for parallel
+  // compression of in-flight blocks
+  uint64_t data_blocks_nanos = 0;
+  // Finishing and writing the filter block(s)
+  uint64_t filter_nanos = 0;
+  // Finishing and writing the index block(s)
+  uint64_t index_nanos = 0;
+};
+
 // TableBuilder provides the interface used to build a Table
 // (an immutable and sorted map from keys to values).
 //
@@ -234,6 +249,10 @@ class TableBuilder {
   // Returns table properties
   virtual TableProperties GetTableProperties() const = 0;
 
+  // Returns the time spent in the stages of a successful Finish(), where
+  // measured
+  virtual TableBuilderFinishTimes GetFinishTimes() const { return {}; }
+
   // Return file checksum
   virtual std::string GetFileChecksum() const = 0;
 
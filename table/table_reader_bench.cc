@@ -11,6 +11,8 @@ int main() {
 }
 #else
 
+#include <cinttypes>
+
 #include "db/db_impl/db_impl.h"
 #include "db/dbformat.h"
 #include "file/random_access_file_reader.h"
@@ -20,9 +22,12 @@ int main() {
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/system_clock.h"
 #include "rocksdb/table.h"
+#include "rocksdb/user_defined_index.h"
 #include "table/block_based/block_based_table_factory.h"
+#include "table/format.h"
 #include "table/get_context.h"
 #include "table/internal_iterator.h"
+#include "table/meta_blocks.h"
 #include "table/plain/plain_table_factory.h"
 #include "table/table_builder.h"
 #include "test_util/testharness.h"
@@ -153,6 +158,33 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
       fprintf(stderr, "Open Table Error: %s\n", s.ToString().c_str());
       exit(1);
     }
+
+    std::shared_ptr<const TableProperties> props =
+        table_reader->GetTableProperties();
+    fprintf(stderr, "Data blocks: %" PRIu64 ", index size: %" PRIu64 "\n",
+            props->num_data_blocks, props->index_size);
+    if (read_options.table_index_factory != nullptr) {
+      // The user defined index is built next to the regular index, and is
+      // what the reads go through.
+      const std::string udi_name =
+          kUserDefinedIndexPrefix + read_options.table_index_factory->Name();
+      BlockHandle udi_handle;
+      std::unique_ptr<FSRandomAccessFile> udi_raf;
+      s = fs->NewRandomAccessFile(file_name, fopts, &udi_raf, nullptr);
+      if (s.ok()) {
+        RandomAccessFileReader udi_file_reader(std::move(udi_raf), file_name);
+        s = FindMetaBlockInFile(&udi_file_reader, file_size,
+                                kBlockBasedTableMagicNumber, ioptions,
+                                read_options, udi_name, &udi_handle);
+      }
+      if (!s.ok()) {
+        fprintf(stderr, "Find %s Error: %s\n", udi_name.c_str(),
+                s.ToString().c_str());
+        exit(1);
+      }
+      fprintf(stderr, "%s size: %" PRIu64 "\n", udi_name.c_str(),
+              udi_handle.size());
+    }
   }
 
   Random rnd(301);
@@ -279,6 +311,16 @@ DEFINE_bool(mmap_read, true, "Whether use mmap read");
 DEFINE_string(table_factory, "block_based",
               "Table factory to use: `block_based` (default), `plain_table` or "
               "`cuckoo_hash`.");
+DEFINE_bool(data_block_restart_key_prefixes, false,
+            "For block_based, store 8-byte restart key prefixes in data "
+            "blocks");
+DEFINE_int32(block_restart_interval, 16,
+             "For block_based, the data block restart interval");
+DEFINE_bool(learned_index, false,
+            "For block_based, also build a learned index "
+            "(NewLearnedIndexFactory) and read through it");
+DEFINE_uint32(learned_index_epsilon, 4,
+              "Error bound, in data blocks, of the learned index model");
 DEFINE_string(time_unit, "microsecond",
               "The time unit used for measuring performance. User can specify "
               "`microsecond` (default) or `nanosecond`");
@@ -296,6 +338,7 @@ int main(int argc, char** argv) {
   }
   ROCKSDB_NAMESPACE::ReadOptions ro;
   ROCKSDB_NAMESPACE::EnvOptions env_options;
+  std::shared_ptr<ROCKSDB_NAMESPACE::UserDefinedIndexFactory> learned_index;
   options.create_if_missing = true;
   options.compression = ROCKSDB_NAMESPACE::CompressionType::kNoCompression;
 
@@ -318,7 +361,17 @@ int main(int argc, char** argv) {
     options.prefix_extractor.reset(
         ROCKSDB_NAMESPACE::NewFixedPrefixTransform(FLAGS_prefix_len));
   } else if (FLAGS_table_factory == "block_based") {
-    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory());
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions table_options;
+    table_options.data_block_restart_key_prefixes =
+        FLAGS_data_block_restart_key_prefixes;
+    table_options.block_restart_interval = FLAGS_block_restart_interval;
+    if (FLAGS_learned_index) {
+      learned_index = ROCKSDB_NAMESPACE::NewLearnedIndexFactory(
+          FLAGS_learned_index_epsilon);
+      table_options.user_defined_index_factory = learned_index;
+      ro.table_index_factory = learned_index.get();
+    }
+    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory(table_options));
   } else {
     fprintf(stderr, "Invalid table type %s\n", FLAGS_table_factory.c_str());
   }
@@ -143,7 +143,10 @@ bool RandomTransactionInserter::DoInsert(DB* db, Transaction* txn,
   for (uint16_t set_i : set_vec) {
     uint64_t int_value = 0;
     std::string full_key;
-    uint64_t rand_key = rand_->Next() % num_keys_;
+    uint64_t rand_key =
+        num_hot_keys_ > 0 && rand_->Uniform(100) < hot_key_pct_
+            ? rand_->Uniform(num_hot_keys_)
+            : rand_->Next() % num_keys_;
     const bool get_for_update = txn ? rand_->OneIn(2) : false;
     s = DBGet(db, txn, read_options_, set_i, rand_key, get_for_update,
               &int_value, &full_key, &unexpected_error);
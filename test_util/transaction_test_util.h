@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "port/port.h"
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
@@ -60,6 +62,14 @@ class RandomTransactionInserter {
 
   ~RandomTransactionInserter();
 
+  // Makes `hot_key_pct` percent of the keys picked in each set come from
+  // the first `num_hot_keys` keys of the set, to simulate contention on hot
+  // keys. By default keys are picked uniformly.
+  void SetHotKeys(uint64_t num_hot_keys, uint32_t hot_key_pct) {
+    num_hot_keys_ = std::min(num_hot_keys, num_keys_);
+    hot_key_pct_ = hot_key_pct;
+  }
+
   // Increment a key in each set using a Transaction on a TransactionDB.
   //
   // Returns true if the transaction succeeded OR if any error encountered was
@@ -119,6 +129,8 @@ class RandomTransactionInserter {
   ReadOptions read_options_;
   const uint64_t num_keys_;
   const uint16_t num_sets_;
+  uint64_t num_hot_keys_ = 0;
+  uint32_t hot_key_pct_ = 0;
 
   // Number of successful insert batches performed
   uint64_t success_count_ = 0;
@@ -64,6 +64,7 @@
 #include "rocksdb/table.h"
 #include "rocksdb/tool_hooks.h"
 #include "rocksdb/utilities/backup_engine.h"
+#include "rocksdb/utilities/bulk_loader.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
 #include "rocksdb/utilities/options_type.h"
@@ -177,6 +178,8 @@ DEFINE_string(
     "sync mode\n"
     "\tfill100K      -- write N/1000 100K values in random order in"
     " async mode\n"
+    "\tbulkload      -- add N values in random key order to a BulkLoader"
+    " and ingest the SST files it builds into the bottommost level\n"
     "\tdeleteseq     -- delete N keys in sequential order\n"
     "\tdeleterandom  -- delete N keys in random order\n"
     "\treadseq       -- read N times sequentially\n"
@@ -737,6 +740,12 @@ DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "This is only valid if use_data_block_hash_index is "
               "set to true");
 
+DEFINE_bool(data_block_restart_key_prefixes,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .data_block_restart_key_prefixes,
+            "Store 8-byte restart key prefixes in data blocks to speed up "
+            "seeks within a block");
+
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
 
@@ -753,6 +762,11 @@ DEFINE_int32(file_opening_threads,
              "If open_files is set to -1, this option set the number of "
              "threads that will be used to open files during DB::Open()");
 
+DEFINE_int32(manifest_recovery_threads,
+             ROCKSDB_NAMESPACE::Options().manifest_recovery_threads,
+             "Number of threads decoding and applying MANIFEST records "
+             "during DB::Open()");
+
 DEFINE_uint64(compaction_readahead_size,
               ROCKSDB_NAMESPACE::Options().compaction_readahead_size,
               "Compaction readahead size");
@@ -967,6 +981,15 @@ DEFINE_int64(max_num_range_tombstones, 0,
 DEFINE_bool(expand_range_tombstones, false,
             "Expand range tombstone into sequential regular tombstones.");
 
+// BulkLoader Options
+DEFINE_int32(bulk_load_threads, 4,
+             "Number of threads sorting and writing SST files when the "
+             "bulkload benchmark finishes.");
+
+DEFINE_uint64(bulk_load_buffer_size, 256 << 20,
+              "Memory buffering the entries added by the bulkload benchmark "
+              "before they are spilled to temporary files.");
+
 // Transactions Options
 DEFINE_bool(optimistic_transaction_db, false,
             "Open a OptimisticTransactionDB instance. "
@@ -991,6 +1014,19 @@ DEFINE_int32(transaction_sleep, 0,
 DEFINE_uint64(transaction_lock_timeout, 100,
               "If using a transaction_db, specifies the lock wait timeout in"
               " milliseconds before failing a transaction waiting on a lock");
+
+DEFINE_uint64(transaction_hot_keys, 0,
+              "If > 0, number of hot keys per set that "
+              "--transaction_hot_key_pct percent of the keys picked by "
+              "randomtransaction come from, to measure lock contention.");
+
+DEFINE_uint32(transaction_hot_key_pct, 90,
+              "Percentage of keys picked among the --transaction_hot_keys "
+              "hot keys of each set (used in RandomTransaction only).");
+
+DEFINE_bool(transaction_deadlock_detect, false,
+            "If using a transaction_db, whether transactions detect "
+            "deadlocks while waiting for locks.");
 DEFINE_string(
     options_file, "",
     "The path to a RocksDB options file.  If specified, then db_bench will "
@@ -1278,6 +1314,11 @@ DEFINE_bool(
     auto_readahead_size, false,
     "When set true, RocksDB does auto tuning of readahead size during Scans");
 
+DEFINE_bool(pattern_aware_readahead, false,
+            "Sets ReadOptions::pattern_aware_readahead, which has implicit "
+            "readahead follow backward and strided scans and stop at the "
+            "iterate upper bound");
+
 DEFINE_bool(paranoid_memory_checks, false,
             "Sets CF option paranoid_memory_checks");
 
@@ -1487,11 +1528,20 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
+DEFINE_bool(enable_pipelined_wal_sync, false,
+            "Sync the WAL for sync writes in the memtable write stage, "
+            "overlapping with later WAL writes. Requires "
+            "--enable_pipelined_write");
+
 DEFINE_bool(
     unordered_write, false,
     "Enable the unordered write feature, which provides higher throughput but "
     "relaxes the guarantees around atomic reads and immutable snapshots");
 
+DEFINE_bool(core_local_write_staging, false,
+            "Stage unordered_write batches per core and write each core's "
+            "batches to the WAL together. Requires --unordered_write");
+
 DEFINE_bool(allow_concurrent_memtable_write, true,
             "Allow multi-writers to update mem tables in parallel.");
 
@@ -1751,6 +1801,11 @@ DEFINE_bool(avoid_flush_during_recovery,
             ROCKSDB_NAMESPACE::Options().avoid_flush_during_recovery,
             "If true, avoids flushing the recovered WAL data where possible.");
 
+DEFINE_int32(wal_recovery_threads,
+             ROCKSDB_NAMESPACE::Options().wal_recovery_threads,
+             "Number of threads replaying WALs into memtables and flushing "
+             "the recovered memtables during DB open.");
+
 DEFINE_bool(avoid_flush_during_shutdown,
             ROCKSDB_NAMESPACE::Options().avoid_flush_during_shutdown,
             "If true, avoids flushing the recovered WAL data where possible.");
@@ -2866,6 +2921,8 @@ class Benchmark {
 
   std::unique_ptr<TimestampEmulator> mock_app_clock_;
 
+  std::unique_ptr<BulkLoader> bulk_loader_;
+
   bool SanityCheck() {
     if (FLAGS_compression_ratio > 1) {
       fprintf(stderr, "compression_ratio should be between 0 and 1\n");
@@ -3544,6 +3601,7 @@ class Benchmark {
       read_options_.async_io = FLAGS_async_io;
       read_options_.optimize_multiget_for_io = FLAGS_optimize_multiget_for_io;
       read_options_.auto_readahead_size = FLAGS_auto_readahead_size;
+      read_options_.pattern_aware_readahead = FLAGS_pattern_aware_readahead;
       read_options_.auto_refresh_iterator_with_snapshot =
           FLAGS_auto_refresh_iterator_with_snapshot;
 
@@ -3769,6 +3827,23 @@ class Benchmark {
         method = &Benchmark::Compress;
       } else if (name == "uncompress") {
         method = &Benchmark::Uncompress;
+      } else if (name == "bulkload") {
+        fresh_db = true;
+        BulkLoaderOptions loader_options;
+        loader_options.output_dir = FLAGS_db + "_bulk_load";
+        loader_options.num_threads = FLAGS_bulk_load_threads;
+        loader_options.write_buffer_size =
+            static_cast<size_t>(FLAGS_bulk_load_buffer_size);
+        loader_options.target_file_size = FLAGS_target_file_size_base;
+        Status s = FLAGS_env->CreateDirIfMissing(loader_options.output_dir);
+        if (!s.ok()) {
+          fprintf(stderr, "Cannot create %s: %s\n",
+                  loader_options.output_dir.c_str(), s.ToString().c_str());
+          ErrorExit();
+        }
+        bulk_loader_.reset(new BulkLoader(open_options_, loader_options));
+        method = &Benchmark::BulkLoad;
+        post_process_method = &Benchmark::BulkLoadFinish;
       } else if (name == "randomtransaction") {
         method = &Benchmark::RandomTransaction;
         post_process_method = &Benchmark::RandomTransactionVerify;
@@ -4299,6 +4374,7 @@ class Benchmark {
     options.stats_history_buffer_size =
         static_cast<size_t>(FLAGS_stats_history_buffer_size);
     options.avoid_flush_during_recovery = FLAGS_avoid_flush_during_recovery;
+    options.wal_recovery_threads = FLAGS_wal_recovery_threads;
     options.avoid_flush_during_shutdown = FLAGS_avoid_flush_during_shutdown;
 
     options.compression_opts.level = FLAGS_compression_level;
@@ -4363,6 +4439,7 @@ class Benchmark {
     }
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
+    options.manifest_recovery_threads = FLAGS_manifest_recovery_threads;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
@@ -4570,6 +4647,8 @@ class Benchmark {
       }
       block_based_options.data_block_hash_table_util_ratio =
           FLAGS_data_block_hash_table_util_ratio;
+      block_based_options.data_block_restart_key_prefixes =
+          FLAGS_data_block_restart_key_prefixes;
       if (FLAGS_read_cache_path != "") {
         Status rc_status;
 
@@ -4735,7 +4814,9 @@ class Benchmark {
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+    options.enable_pipelined_wal_sync = FLAGS_enable_pipelined_wal_sync;
     options.unordered_write = FLAGS_unordered_write;
+    options.core_local_write_staging = FLAGS_core_local_write_staging;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.table_cache_numshardbits = FLAGS_table_cache_numshardbits;
@@ -5991,6 +6072,7 @@ class Benchmark {
     options.adaptive_readahead = FLAGS_adaptive_readahead;
     options.async_io = FLAGS_async_io;
     options.auto_readahead_size = FLAGS_auto_readahead_size;
+    options.pattern_aware_readahead = FLAGS_pattern_aware_readahead;
     std::unique_ptr<ManagedSnapshot> snapshot = nullptr;
     if (FLAGS_explicit_snapshot) {
       snapshot = std::make_unique<ManagedSnapshot>(db);
@@ -8171,10 +8253,13 @@ class Benchmark {
     TransactionOptions txn_options;
     txn_options.lock_timeout = FLAGS_transaction_lock_timeout;
     txn_options.set_snapshot = FLAGS_transaction_set_snapshot;
+    txn_options.deadlock_detect = FLAGS_transaction_deadlock_detect;
 
     RandomTransactionInserter inserter(&thread->rand, write_options_,
                                        read_options_, FLAGS_num,
                                        num_prefix_ranges);
+    inserter.SetHotKeys(FLAGS_transaction_hot_keys,
+                        FLAGS_transaction_hot_key_pct);
 
     if (FLAGS_num_multi_db > 1) {
       fprintf(stderr,
@@ -8219,6 +8304,44 @@ class Benchmark {
     thread->stats.AddBytes(static_cast<int64_t>(inserter.GetBytesInserted()));
   }
 
+  // Adds random keys to bulk_loader_. The SST files are built and ingested by
+  // BulkLoadFinish() once every thread is done.
+  void BulkLoad(ThreadState* thread) {
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    RandomGenerator gen;
+    int64_t bytes = 0;
+    Duration duration(FLAGS_duration, num_);
+    while (!duration.Done(1)) {
+      GenerateKeyFromInt(thread->rand.Next() % FLAGS_num, FLAGS_num, &key);
+      Slice value = gen.Generate();
+      Status s = bulk_loader_->Add(key, value);
+      if (!s.ok()) {
+        fprintf(stderr, "Bulk load failed: %s\n", s.ToString().c_str());
+        ErrorExit();
+      }
+      bytes += key.size() + value.size();
+      thread->stats.FinishedOps(nullptr, nullptr, 1, kWrite);
+    }
+    thread->stats.AddBytes(bytes);
+  }
+
+  void BulkLoadFinish() {
+    const uint64_t start_micros = FLAGS_env->NowMicros();
+    Status s =
+        bulk_loader_->FinishAndIngest(db_.db, db_.db->DefaultColumnFamily());
+    const uint64_t elapsed_micros = FLAGS_env->NowMicros() - start_micros;
+    bulk_loader_.reset();
+    if (!s.ok()) {
+      fprintf(stderr, "Bulk load failed: %s\n", s.ToString().c_str());
+      ErrorExit();
+    }
+    std::string level_stats;
+    db_.db->GetProperty(DB::Properties::kLevelStats, &level_stats);
+    fprintf(stdout, "bulkload finish and ingest: %.3f seconds\n%s",
+            elapsed_micros / 1e6, level_stats.c_str());
+  }
+
   // Verifies consistency of data after RandomTransaction() has been run.
   // Since each iteration of RandomTransaction() incremented a key in each set
   // by the same value, the sum of the keys in each set should be the same.
@@ -100,6 +100,7 @@ default_params = {
     "delrangepercent": 1,
     "destroy_db_initially": 0,
     "enable_pipelined_write": lambda: random.randint(0, 1),
+    "enable_pipelined_wal_sync": lambda: random.randint(0, 1),
     "enable_compaction_filter": lambda: random.choice([0, 0, 0, 1]),
     "enable_compaction_on_deletion_trigger": lambda: random.choice([0, 0, 0, 1]),
     # `inplace_update_support` is incompatible with DB that has delete
@@ -371,6 +372,8 @@ default_params = {
     "auto_refresh_iterator_with_snapshot": lambda: random.choice([0, 1]),
     "memtable_op_scan_flush_trigger": lambda: random.choice([0, 10, 100, 1000]),
     "memtable_avg_op_scan_flush_trigger": lambda: random.choice([0, 2, 20, 200]),
+    "compaction_iterator_batch_size": lambda: random.choice([0, 0, 1, 64]),
+    "filter_memory_budget_bits_per_key": lambda: random.choice([0, 0, 6, 10]),
     "ingest_wbwi_one_in": lambda: random.choice([0, 0, 100, 500]),
     "universal_reduce_file_locking": lambda: random.randint(0, 1),
     "compression_manager": lambda: random.choice(
@@ -1150,6 +1153,12 @@ def finalize_and_sanitize(src_params):
     if dest_params.get("use_multiscan") == 1:
         dest_params["fill_cache"] = 1
         dest_params["async_io"] = 0
+    if (
+        dest_params.get("enable_pipelined_write", 0) == 0
+        or dest_params.get("manual_wal_flush_one_in", 0) > 0
+        or dest_params.get("mmap_write", 0) == 1
+    ):
+        dest_params["enable_pipelined_wal_sync"] = 0
     return dest_params
 
 
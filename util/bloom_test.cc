@@ -1193,6 +1193,29 @@ TEST(RibbonTest, RibbonTestLevelThreshold) {
   }
 }
 
+TEST(BloomTest, AdaptiveBitsPerKey) {
+  BlockBasedTableOptions opts;
+  FilterBuildingContext ctx(opts);
+  std::unique_ptr<FilterBitsBuilder> builder;
+
+  std::shared_ptr<const FilterPolicy> policy{NewBloomFilterPolicy(10)};
+  builder.reset(policy->GetBuilderWithContext(ctx));
+  ASSERT_NEAR(GetEffectiveBitsPerKey(builder.get()), 10, 1);
+
+  // Allocated bits per key override the configured setting
+  ctx.adaptive_bits_per_key = 20;
+  builder.reset(policy->GetBuilderWithContext(ctx));
+  ASSERT_GT(GetEffectiveBitsPerKey(builder.get()), 15);
+  ctx.adaptive_bits_per_key = 2;
+  builder.reset(policy->GetBuilderWithContext(ctx));
+  ASSERT_LT(GetEffectiveBitsPerKey(builder.get()), 4);
+
+  // But not a policy configured to build no filters
+  policy.reset(NewBloomFilterPolicy(0));
+  builder.reset(policy->GetBuilderWithContext(ctx));
+  ASSERT_EQ(builder, nullptr);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -47,6 +47,9 @@ void CompactionJobStats::Reset() {
   file_range_sync_nanos = 0;
   file_fsync_nanos = 0;
   file_prepare_write_nanos = 0;
+  output_data_blocks_finish_nanos = 0;
+  output_filter_finish_nanos = 0;
+  output_index_finish_nanos = 0;
 
   smallest_output_key_prefix.clear();
   largest_output_key_prefix.clear();
@@ -92,6 +95,9 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
   file_range_sync_nanos += stats.file_range_sync_nanos;
   file_fsync_nanos += stats.file_fsync_nanos;
   file_prepare_write_nanos += stats.file_prepare_write_nanos;
+  output_data_blocks_finish_nanos += stats.output_data_blocks_finish_nanos;
+  output_filter_finish_nanos += stats.output_filter_finish_nanos;
+  output_index_finish_nanos += stats.output_index_finish_nanos;
 
   num_single_del_fallthru += stats.num_single_del_fallthru;
   num_single_del_mismatch += stats.num_single_del_mismatch;
@@ -0,0 +1,45 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Runs `fn(i)` for every i in [0, n) on up to `num_threads` threads,
+// including the calling one. Each thread picks the next index as soon as it
+// is done with the previous one, so uneven work items balance out. Returns
+// once all calls have returned.
+inline void RunInParallel(int num_threads, size_t n,
+                          const std::function<void(size_t)>& fn) {
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < n;
+         i = next.fetch_add(1, std::memory_order_relaxed)) {
+      fn(i);
+    }
+  };
+  std::vector<port::Thread> threads;
+  const size_t num_helpers =
+      std::min(n, static_cast<size_t>(std::max(num_threads, 1))) - (n > 0);
+  threads.reserve(num_helpers);
+  for (size_t i = 0; i < num_helpers; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
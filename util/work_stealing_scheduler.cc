@@ -0,0 +1,497 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/work_stealing_scheduler.h"
+
+#ifdef OS_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+#include "monitoring/statistics_impl.h"
+#include "monitoring/thread_status_util.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// The worker, if any, the current thread is
+thread_local WorkStealingScheduler* tls_scheduler = nullptr;
+thread_local size_t tls_worker_id = 0;
+
+// Strides are this divided by the class weights.
+constexpr uint64_t kStrideScale = uint64_t{1} << 20;
+
+constexpr Histograms kQueueDelayHistograms[] = {
+    SCHEDULER_QUEUE_DELAY_BOTTOM_MICROS, SCHEDULER_QUEUE_DELAY_LOW_MICROS,
+    SCHEDULER_QUEUE_DELAY_HIGH_MICROS, SCHEDULER_QUEUE_DELAY_USER_MICROS};
+static_assert(sizeof(kQueueDelayHistograms) /
+                      sizeof(kQueueDelayHistograms[0]) ==
+                  Env::Priority::TOTAL,
+              "One histogram per priority class");
+
+struct WorkerThreadMetadata {
+  WorkStealingScheduler* scheduler;
+  size_t worker_id;
+};
+}  // namespace
+
+WorkStealingScheduler::WorkStealingScheduler(
+    Env* host_env, const std::shared_ptr<SystemClock>& clock,
+    const WorkStealingSchedulerOptions& options)
+    : host_env_(host_env),
+      clock_(clock),
+      statistics_(options.statistics),
+      workers_(new std::unique_ptr<Worker>[kMaxWorkers]),
+      num_workers_(1),
+      next_worker_(0),
+      total_queue_len_(0),
+      num_sleeping_(0),
+      num_idle_(0),
+      total_reserved_(0),
+      exit_all_threads_(false),
+      total_threads_limit_(0) {
+  for (int cls = 0; cls < kNumClasses; ++cls) {
+    strides_[cls] = kStrideScale / std::max<uint32_t>(options.weights[cls], 1);
+    queue_len_[cls].store(0, std::memory_order_relaxed);
+    low_io_priority_[cls].store(false, std::memory_order_relaxed);
+    cpu_priority_[cls].store(static_cast<int>(CpuPriority::kNormal),
+                             std::memory_order_relaxed);
+  }
+  // Jobs scheduled before any thread is started are queued on the first
+  // worker.
+  workers_[0].reset(new Worker());
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+  JoinAllThreads(/*wait_for_jobs_to_complete=*/false);
+}
+
+void WorkStealingScheduler::Schedule(void (*function)(void* arg), void* arg,
+                                     Env::Priority pri, void* tag,
+                                     void (*unsched_function)(void* arg)) {
+  assert(pri >= Env::Priority::BOTTOM && pri < Env::Priority::TOTAL);
+
+  if (exit_all_threads_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  Job job;
+  job.function = std::bind(function, arg);
+  if (unsched_function) {
+    job.unsched_function = std::bind(unsched_function, arg);
+  }
+  job.tag = tag;
+  if (statistics_) {
+    job.enqueue_micros = clock_->NowMicros();
+  }
+
+  // Jobs scheduled by a job stay with its worker, where they are likely to
+  // find their data in the caches.
+  const size_t worker_id =
+      tls_scheduler == this
+          ? tls_worker_id
+          : next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                num_workers_.load(std::memory_order_acquire);
+  Worker* const worker = workers_[worker_id].get();
+  {
+    std::lock_guard<std::mutex> lock(worker->mu);
+    worker->queues[pri].push_back(std::move(job));
+    queue_len_[pri].fetch_add(1);
+    total_queue_len_.fetch_add(1);
+  }
+  TEST_SYNC_POINT("WorkStealingScheduler::Schedule:Enqueue");
+
+  // Pairs with the check of total_queue_len_ by workers going to sleep.
+  if (num_sleeping_.load() > 0) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (threads_.size() > static_cast<size_t>(total_threads_limit_.load())) {
+      // The one woken up could be an excess thread, which does not run jobs.
+      cv_.notify_all();
+    } else {
+      cv_.notify_one();
+    }
+  }
+}
+
+int WorkStealingScheduler::UnSchedule(void* tag, Env::Priority pri) {
+  assert(pri >= Env::Priority::BOTTOM && pri < Env::Priority::TOTAL);
+
+  std::vector<std::function<void()>> unsched_functions;
+  int count = 0;
+
+  const size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < num_workers; ++i) {
+    Worker* const worker = workers_[i].get();
+    std::lock_guard<std::mutex> lock(worker->mu);
+
+    auto& queue = worker->queues[pri];
+    for (auto it = queue.begin(); it != queue.end();) {
+      if (it->tag != tag) {
+        ++it;
+        continue;
+      }
+      if (it->unsched_function) {
+        unsched_functions.push_back(std::move(it->unsched_function));
+      }
+      it = queue.erase(it);
+      queue_len_[pri].fetch_sub(1);
+      total_queue_len_.fetch_sub(1);
+      ++count;
+    }
+  }
+
+  // Run unschedule functions outside the mutexes
+  for (auto& f : unsched_functions) {
+    f();
+  }
+
+  return count;
+}
+
+unsigned int WorkStealingScheduler::GetQueueLen(Env::Priority pri) const {
+  assert(pri >= Env::Priority::BOTTOM && pri < Env::Priority::TOTAL);
+  return static_cast<unsigned int>(
+      queue_len_[pri].load(std::memory_order_relaxed));
+}
+
+void WorkStealingScheduler::SetBackgroundThreads(int num, Env::Priority pri) {
+  assert(pri >= Env::Priority::BOTTOM && pri < Env::Priority::TOTAL);
+
+  std::lock_guard<std::mutex> lock(mu_);
+  if (exit_all_threads_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  threads_limit_[pri] = std::max(0, num);
+  int total = 0;
+  for (int limit : threads_limit_) {
+    total += limit;
+  }
+  total = std::min(total, static_cast<int>(kMaxWorkers));
+  if (total != total_threads_limit_.load(std::memory_order_relaxed)) {
+    total_threads_limit_.store(total);
+    cv_.notify_all();
+    StartThreads();
+  }
+}
+
+int WorkStealingScheduler::GetBackgroundThreads(Env::Priority pri) {
+  assert(pri >= Env::Priority::BOTTOM && pri < Env::Priority::TOTAL);
+
+  std::lock_guard<std::mutex> lock(mu_);
+  return threads_limit_[pri];
+}
+
+void WorkStealingScheduler::IncBackgroundThreadsIfNeeded(int num,
+                                                         Env::Priority pri) {
+  if (num > GetBackgroundThreads(pri)) {
+    SetBackgroundThreads(num, pri);
+  }
+}
+
+int WorkStealingScheduler::ReserveThreads(int num, Env::Priority pri) {
+  assert(pri >= Env::Priority::BOTTOM && pri < Env::Priority::TOTAL);
+
+  std::lock_guard<std::mutex> lock(mu_);
+  // Like with ThreadPoolImpl, a worker that has just picked up a job may
+  // still count as idle, so fewer workers than reserved may be available.
+  const int total_reserved = total_reserved_.load();
+  const int reserved = std::min(
+      std::max(num_idle_.load() - total_reserved, 0), std::max(num, 0));
+  reserved_[pri] += reserved;
+  total_reserved_.store(total_reserved + reserved);
+  return reserved;
+}
+
+int WorkStealingScheduler::ReleaseThreads(int num, Env::Priority pri) {
+  assert(pri >= Env::Priority::BOTTOM && pri < Env::Priority::TOTAL);
+
+  std::lock_guard<std::mutex> lock(mu_);
+  const int released = std::min(reserved_[pri], std::max(num, 0));
+  reserved_[pri] -= released;
+  total_reserved_.fetch_sub(released);
+  cv_.notify_all();
+  return released;
+}
+
+void WorkStealingScheduler::LowerIOPriority(Env::Priority pri) {
+  assert(pri >= Env::Priority::BOTTOM && pri < Env::Priority::TOTAL);
+  low_io_priority_[pri].store(true, std::memory_order_relaxed);
+}
+
+void WorkStealingScheduler::LowerCPUPriority(Env::Priority pri,
+                                             CpuPriority cpu_priority) {
+  assert(pri >= Env::Priority::BOTTOM && pri < Env::Priority::TOTAL);
+  cpu_priority_[pri].store(static_cast<int>(cpu_priority),
+                           std::memory_order_relaxed);
+}
+
+void WorkStealingScheduler::JoinAllThreads(bool wait_for_jobs_to_complete) {
+  std::unique_lock<std::mutex> lock(mu_);
+  if (threads_.empty()) {
+    return;
+  }
+  assert(!exit_all_threads_.load(std::memory_order_relaxed));
+
+  wait_for_jobs_to_complete_ = wait_for_jobs_to_complete;
+  exit_all_threads_.store(true);
+  // Prevent threads from being recreated right after they're joined.
+  threads_limit_.fill(0);
+  total_threads_limit_.store(0);
+  reserved_.fill(0);
+  total_reserved_.store(0);
+
+  lock.unlock();
+
+  cv_.notify_all();
+
+  // Workers only remove themselves from threads_ while not exiting.
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+
+  lock.lock();
+  threads_.clear();
+  exit_all_threads_.store(false);
+  wait_for_jobs_to_complete_ = false;
+}
+
+void WorkStealingScheduler::StartThreads() {
+  const size_t total_threads_limit = static_cast<size_t>(
+      total_threads_limit_.load(std::memory_order_relaxed));
+  while (threads_.size() < total_threads_limit) {
+    const size_t worker_id = threads_.size();
+    if (worker_id >= num_workers_.load(std::memory_order_relaxed)) {
+      assert(worker_id == num_workers_.load(std::memory_order_relaxed));
+      workers_[worker_id].reset(new Worker());
+      num_workers_.store(worker_id + 1, std::memory_order_release);
+    }
+
+    port::Thread thread(&WorkerThreadWrapper,
+                        new WorkerThreadMetadata{this, worker_id});
+
+// Set the thread name to aid debugging
+#if defined(_GNU_SOURCE) && defined(__GLIBC_PREREQ)
+#if __GLIBC_PREREQ(2, 12)
+    pthread_setname_np(thread.native_handle(), "rocksdb:ws");
+#endif
+#endif
+    threads_.push_back(std::move(thread));
+  }
+}
+
+void WorkStealingScheduler::WorkerThreadWrapper(void* arg) {
+  std::unique_ptr<WorkerThreadMetadata> meta(
+      static_cast<WorkerThreadMetadata*>(arg));
+  meta->scheduler->WorkerThread(meta->worker_id);
+}
+
+void WorkStealingScheduler::WorkerThread(size_t worker_id) {
+  tls_scheduler = this;
+  tls_worker_id = worker_id;
+
+  WorkerState state;
+  num_idle_.fetch_add(1);
+
+  while (true) {
+    const bool exiting = exit_all_threads_.load(std::memory_order_acquire);
+    Job job;
+    int cls = 0;
+    if ((exiting || !IsExcessThread(worker_id)) &&
+        total_reserved_.load() < num_idle_.load() &&
+        PickJob(worker_id, &state, &job, &cls)) {
+      num_idle_.fetch_sub(1);
+      SetThreadPriorities(&state, cls);
+      RegisterThread(&state, cls);
+      TEST_SYNC_POINT_CALLBACK("WorkStealingScheduler::WorkerThread:BeforeRun",
+                               &cls);
+      job.function();
+      num_idle_.fetch_add(1);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mu_);
+    if (exit_all_threads_.load(std::memory_order_relaxed)) {
+      if (!wait_for_jobs_to_complete_ || total_queue_len_.load() == 0) {
+        break;
+      }
+      continue;
+    }
+
+    if (IsLastExcessThread(worker_id)) {
+      // Like ThreadPoolImpl, terminate the excess threads in the reverse
+      // order of their creation.
+      threads_.back().detach();
+      threads_.pop_back();
+      if (threads_.size() >
+          static_cast<size_t>(total_threads_limit_.load())) {
+        cv_.notify_all();
+      }
+      TEST_SYNC_POINT("WorkStealingScheduler::WorkerThread:Termination");
+      break;
+    }
+
+    // Pairs with the check of num_sleeping_ in Schedule().
+    num_sleeping_.fetch_add(1);
+    cv_.wait(lock, [&] {
+      return exit_all_threads_.load(std::memory_order_relaxed) ||
+             IsLastExcessThread(worker_id) ||
+             (!IsExcessThread(worker_id) && total_queue_len_.load() > 0 &&
+              total_reserved_.load() < num_idle_.load());
+    });
+    num_sleeping_.fetch_sub(1);
+  }
+
+  num_idle_.fetch_sub(1);
+#ifdef ROCKSDB_USING_THREAD_STATUS
+  if (state.registered_class >= 0) {
+    ThreadStatusUtil::UnregisterThread();
+  }
+#endif
+  tls_scheduler = nullptr;
+}
+
+bool WorkStealingScheduler::PickJob(size_t worker_id, WorkerState* state,
+                                    Job* job, int* cls) {
+  assert(state);
+  assert(job);
+  assert(cls);
+
+  if (total_queue_len_.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+
+  // Stride scheduling: run the class with queued jobs and the lowest pass,
+  // then advance its pass by its stride. A class cannot bank the turns it
+  // missed while it had nothing queued, as passes lag behind the virtual time
+  // at most by a stride.
+  std::array<bool, kNumClasses> tried{};
+  for (int attempt = 0; attempt < kNumClasses; ++attempt) {
+    int best = -1;
+    uint64_t best_pass = 0;
+    for (int c = 0; c < kNumClasses; ++c) {
+      if (tried[c] || queue_len_[c].load(std::memory_order_relaxed) <= 0) {
+        continue;
+      }
+      const uint64_t pass = std::max(state->pass[c], state->virtual_time);
+      // Ties go to the class with the higher Env::Priority.
+      if (best < 0 || pass <= best_pass) {
+        best = c;
+        best_pass = pass;
+      }
+    }
+    if (best < 0) {
+      return false;
+    }
+    tried[best] = true;
+
+    if (PopJob(worker_id, best, job)) {
+      state->virtual_time = best_pass;
+      state->pass[best] = best_pass + strides_[best];
+      *cls = best;
+
+      if (statistics_) {
+        const uint64_t now = clock_->NowMicros();
+        RecordInHistogram(
+            statistics_.get(), kQueueDelayHistograms[best],
+            now > job->enqueue_micros ? now - job->enqueue_micros : 0);
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool WorkStealingScheduler::PopJob(size_t worker_id, int cls, Job* job) {
+  // Own jobs first, then the oldest job of the next worker that has one
+  const size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < num_workers; ++i) {
+    Worker* const worker = workers_[(worker_id + i) % num_workers].get();
+    std::lock_guard<std::mutex> lock(worker->mu);
+
+    auto& queue = worker->queues[cls];
+    if (queue.empty()) {
+      continue;
+    }
+    *job = std::move(queue.front());
+    queue.pop_front();
+    queue_len_[cls].fetch_sub(1);
+    total_queue_len_.fetch_sub(1);
+    return true;
+  }
+
+  return false;
+}
+
+void WorkStealingScheduler::SetThreadPriorities(WorkerState* state, int cls) {
+  assert(state);
+
+#ifdef OS_LINUX
+  const bool low_io_priority =
+      low_io_priority_[cls].load(std::memory_order_relaxed);
+  if (low_io_priority != state->low_io_priority) {
+    // IOPRIO_CLASS_IDLE, or back to the default of the process
+    constexpr int kIOPrioClassShift = 13;
+    const int ioprio = low_io_priority ? (3 << kIOPrioClassShift) : 0;
+    syscall(SYS_ioprio_set, 1,  // IOPRIO_WHO_PROCESS
+            0,                  // current thread
+            ioprio);
+    state->low_io_priority = low_io_priority;
+  }
+#endif
+
+  const CpuPriority cpu_priority = static_cast<CpuPriority>(
+      cpu_priority_[cls].load(std::memory_order_relaxed));
+  if (cpu_priority != state->cpu_priority) {
+    // 0 means current thread. Raising the priority back may not be allowed.
+    port::SetCpuPriority(0, cpu_priority);
+    state->cpu_priority = cpu_priority;
+  }
+}
+
+void WorkStealingScheduler::RegisterThread(WorkerState* state, int cls) {
+  assert(state);
+
+#ifdef ROCKSDB_USING_THREAD_STATUS
+  if (state->registered_class == cls) {
+    return;
+  }
+  if (state->registered_class >= 0) {
+    ThreadStatusUtil::UnregisterThread();
+  }
+
+  ThreadStatus::ThreadType thread_type = ThreadStatus::NUM_THREAD_TYPES;
+  switch (static_cast<Env::Priority>(cls)) {
+    case Env::Priority::HIGH:
+      thread_type = ThreadStatus::HIGH_PRIORITY;
+      break;
+    case Env::Priority::LOW:
+      thread_type = ThreadStatus::LOW_PRIORITY;
+      break;
+    case Env::Priority::BOTTOM:
+      thread_type = ThreadStatus::BOTTOM_PRIORITY;
+      break;
+    case Env::Priority::USER:
+      thread_type = ThreadStatus::USER;
+      break;
+    case Env::Priority::TOTAL:
+      assert(false);
+      return;
+  }
+  ThreadStatusUtil::RegisterThread(host_env_, thread_type);
+  state->registered_class = cls;
+#else
+  (void)state;
+  (void)cls;
+#endif
+}
+
+}  // namespace ROCKSDB_NAMESPACE
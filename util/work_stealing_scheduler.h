@@ -0,0 +1,158 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/env.h"
+#include "rocksdb/statistics.h"
+#include "rocksdb/system_clock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// WorkStealingScheduler runs the jobs of all Env::Priority classes on one set
+// of worker threads, so that an idle thread can run any job instead of only
+// the jobs of its own pool. See NewWorkStealingEnv() for the semantics of the
+// Env scheduling calls it implements.
+//
+// Each worker owns a deque of jobs per priority class. Jobs scheduled from a
+// worker go to its own deques, other jobs are spread over the workers. A
+// worker picks the class of its next job by stride scheduling over the
+// classes with queued jobs, so that each class gets a share of the jobs run
+// by the worker proportional to its weight, and takes the oldest job of that
+// class from its own deque or else steals it from another worker. The deques
+// have their own mutexes; the scheduler mutex is only taken to park idle
+// workers and to manage threads and reservations.
+class WorkStealingScheduler {
+ public:
+  static constexpr int kNumClasses = Env::Priority::TOTAL;
+
+  // `host_env` is the Env the worker threads are registered with for thread
+  // status tracking.
+  WorkStealingScheduler(Env* host_env,
+                        const std::shared_ptr<SystemClock>& clock,
+                        const WorkStealingSchedulerOptions& options);
+
+  WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+  WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+  // Discards the queued jobs and waits for the running ones.
+  ~WorkStealingScheduler();
+
+  void Schedule(void (*function)(void* arg), void* arg, Env::Priority pri,
+                void* tag, void (*unsched_function)(void* arg));
+
+  // Removes the queued jobs of class `pri` scheduled with `tag`, calling their
+  // unschedule functions, and returns how many were removed.
+  int UnSchedule(void* tag, Env::Priority pri);
+
+  unsigned int GetQueueLen(Env::Priority pri) const;
+
+  // The number of threads of each class only sets the total number of
+  // workers, which is the sum over the classes.
+  void SetBackgroundThreads(int num, Env::Priority pri);
+  int GetBackgroundThreads(Env::Priority pri);
+  void IncBackgroundThreadsIfNeeded(int num, Env::Priority pri);
+
+  // Keeps up to `num` idle workers from picking up jobs. Reservations are
+  // counted against the idle workers of the whole scheduler.
+  int ReserveThreads(int num, Env::Priority pri);
+  int ReleaseThreads(int num, Env::Priority pri);
+
+  // The workers switch to the given priorities while running jobs of class
+  // `pri`, and back afterwards as far as the OS allows.
+  void LowerIOPriority(Env::Priority pri);
+  void LowerCPUPriority(Env::Priority pri, CpuPriority cpu_priority);
+
+  // Stops all workers, after running the queued jobs if
+  // `wait_for_jobs_to_complete` and discarding them otherwise.
+  void JoinAllThreads(bool wait_for_jobs_to_complete);
+
+ private:
+  struct Job {
+    std::function<void()> function;
+    std::function<void()> unsched_function;
+    void* tag = nullptr;
+    uint64_t enqueue_micros = 0;
+  };
+
+  struct Worker {
+    std::mutex mu;
+    std::array<std::deque<Job>, kNumClasses> queues;
+  };
+
+  // State owned by a worker thread
+  struct WorkerState {
+    // Stride scheduling passes of the classes
+    std::array<uint64_t, kNumClasses> pass{};
+    uint64_t virtual_time = 0;
+    bool low_io_priority = false;
+    CpuPriority cpu_priority = CpuPriority::kNormal;
+    int registered_class = -1;
+  };
+
+  static void WorkerThreadWrapper(void* arg);
+  void WorkerThread(size_t worker_id);
+
+  // Returns the next job of worker `worker_id`, if any.
+  bool PickJob(size_t worker_id, WorkerState* state, Job* job, int* cls);
+  bool PopJob(size_t worker_id, int cls, Job* job);
+  void SetThreadPriorities(WorkerState* state, int cls);
+  void RegisterThread(WorkerState* state, int cls);
+
+  // REQUIRES: mu_ held
+  void StartThreads();
+  // REQUIRES: mu_ held
+  bool IsLastExcessThread(size_t worker_id) const {
+    return threads_.size() > static_cast<size_t>(total_threads_limit_.load()) &&
+           worker_id == threads_.size() - 1;
+  }
+  bool IsExcessThread(size_t worker_id) const {
+    return worker_id >= static_cast<size_t>(total_threads_limit_.load());
+  }
+
+  Env* const host_env_;
+  const std::shared_ptr<SystemClock> clock_;
+  const std::shared_ptr<Statistics> statistics_;
+  std::array<uint64_t, kNumClasses> strides_;
+
+  // Workers are created with their threads and kept for the lifetime of the
+  // scheduler, so that the jobs queued on workers whose threads have exited
+  // can still be stolen.
+  static constexpr size_t kMaxWorkers = 1024;
+  std::unique_ptr<std::unique_ptr<Worker>[]> workers_;
+  std::atomic<size_t> num_workers_;
+  std::atomic<size_t> next_worker_;
+
+  std::array<std::atomic<int64_t>, kNumClasses> queue_len_;
+  std::atomic<int64_t> total_queue_len_;
+  std::atomic<int> num_sleeping_;
+  std::atomic<int> num_idle_;
+  std::atomic<int> total_reserved_;
+  std::atomic<bool> exit_all_threads_;
+  // The sum of the per-class limits, only changed with mu_ held
+  std::atomic<int> total_threads_limit_;
+  std::array<std::atomic<bool>, kNumClasses> low_io_priority_;
+  std::array<std::atomic<int>, kNumClasses> cpu_priority_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::array<int, kNumClasses> threads_limit_{};
+  std::array<int, kNumClasses> reserved_{};
+  bool wait_for_jobs_to_complete_ = false;
+  std::vector<port::Thread> threads_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,270 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/work_stealing_scheduler.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/db.h"
+#include "rocksdb/env.h"
+#include "rocksdb/statistics.h"
+#include "test_util/sync_point.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class WorkStealingSchedulerTest : public testing::Test {
+ public:
+  WorkStealingSchedulerTest() { options_.statistics = CreateDBStatistics(); }
+
+  void NewEnv() { env_.reset(NewWorkStealingEnv(Env::Default(), options_)); }
+
+  // Busy waits with a timeout, as the jobs run on other threads.
+  template <typename Pred>
+  static bool WaitFor(Pred pred) {
+    for (int i = 0; i < 100000; ++i) {
+      if (pred()) {
+        return true;
+      }
+      Env::Default()->SleepForMicroseconds(100);
+    }
+    return pred();
+  }
+
+  void TearDown() override {
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+  }
+
+  WorkStealingSchedulerOptions options_;
+  std::unique_ptr<Env> env_;
+};
+
+namespace {
+struct Counter {
+  std::atomic<int> count{0};
+  static void Inc(void* arg) { static_cast<Counter*>(arg)->count++; }
+};
+}  // namespace
+
+TEST_F(WorkStealingSchedulerTest, RunsJobsOfAllClasses) {
+  NewEnv();
+  env_->SetBackgroundThreads(1, Env::Priority::LOW);
+  env_->SetBackgroundThreads(1, Env::Priority::HIGH);
+  ASSERT_EQ(1, env_->GetBackgroundThreads(Env::Priority::LOW));
+  ASSERT_EQ(0, env_->GetBackgroundThreads(Env::Priority::BOTTOM));
+
+  constexpr int kJobsPerClass = 100;
+  std::array<Counter, Env::Priority::TOTAL> counters;
+  for (int i = 0; i < kJobsPerClass; ++i) {
+    for (int pri = 0; pri < Env::Priority::TOTAL; ++pri) {
+      env_->Schedule(&Counter::Inc, &counters[pri],
+                     static_cast<Env::Priority>(pri));
+    }
+  }
+
+  // The BOTTOM and USER classes have no threads of their own.
+  for (int pri = 0; pri < Env::Priority::TOTAL; ++pri) {
+    ASSERT_TRUE(
+        WaitFor([&] { return counters[pri].count.load() == kJobsPerClass; }));
+    ASSERT_EQ(0, env_->GetThreadPoolQueueLen(static_cast<Env::Priority>(pri)));
+
+    HistogramData data;
+    options_.statistics->histogramData(
+        static_cast<Histograms>(SCHEDULER_QUEUE_DELAY_BOTTOM_MICROS + pri),
+        &data);
+    ASSERT_EQ(kJobsPerClass, data.count);
+  }
+}
+
+TEST_F(WorkStealingSchedulerTest, UnSchedule) {
+  NewEnv();
+
+  // Nothing runs without threads.
+  Counter run;
+  Counter unscheduled;
+  int tag1 = 0;
+  int tag2 = 0;
+  for (int i = 0; i < 10; ++i) {
+    env_->Schedule(&Counter::Inc, &run, Env::Priority::LOW, &tag1,
+                   &Counter::Inc);
+    env_->Schedule(&Counter::Inc, &unscheduled, Env::Priority::LOW, &tag2,
+                   &Counter::Inc);
+  }
+  env_->Schedule(&Counter::Inc, &run, Env::Priority::HIGH, &tag2);
+  ASSERT_EQ(20, env_->GetThreadPoolQueueLen(Env::Priority::LOW));
+  ASSERT_EQ(1, env_->GetThreadPoolQueueLen(Env::Priority::HIGH));
+
+  // Only the jobs of the given class are removed.
+  ASSERT_EQ(10, env_->UnSchedule(&tag2, Env::Priority::LOW));
+  ASSERT_EQ(10, unscheduled.count.load());
+  ASSERT_EQ(10, env_->GetThreadPoolQueueLen(Env::Priority::LOW));
+  ASSERT_EQ(0, env_->UnSchedule(&tag2, Env::Priority::LOW));
+
+  env_->SetBackgroundThreads(2, Env::Priority::LOW);
+  ASSERT_TRUE(WaitFor([&] { return run.count.load() == 11; }));
+  ASSERT_EQ(0, env_->GetThreadPoolQueueLen(Env::Priority::LOW));
+  ASSERT_EQ(0, env_->GetThreadPoolQueueLen(Env::Priority::HIGH));
+}
+
+TEST_F(WorkStealingSchedulerTest, StealJobs) {
+  NewEnv();
+
+  // A job schedules more jobs, which are queued on its own worker, and waits
+  // for them. Only another worker can run them.
+  constexpr int kJobs = 20;
+  struct Parent {
+    Env* env;
+    Counter children;
+    std::atomic<bool> done{false};
+  } parent{env_.get(), {}};
+  auto parent_fn = [](void* arg) {
+    Parent* p = static_cast<Parent*>(arg);
+    for (int i = 0; i < kJobs; ++i) {
+      p->env->Schedule(&Counter::Inc, &p->children, Env::Priority::LOW);
+    }
+    p->done.store(WaitFor([&] { return p->children.count.load() == kJobs; }));
+  };
+  env_->SetBackgroundThreads(2, Env::Priority::LOW);
+  env_->Schedule(parent_fn, &parent, Env::Priority::LOW);
+
+  // The parent has to be done with `parent` before it goes out of scope.
+  ASSERT_TRUE(WaitFor([&] { return parent.done.load(); }));
+  ASSERT_EQ(kJobs, parent.children.count.load());
+  ASSERT_EQ(0, env_->GetThreadPoolQueueLen(Env::Priority::LOW));
+}
+
+TEST_F(WorkStealingSchedulerTest, Weights) {
+  options_.weights[Env::Priority::LOW] = 1;
+  options_.weights[Env::Priority::HIGH] = 3;
+  NewEnv();
+
+  // Queue the jobs of both classes before starting the only worker, and
+  // record the order it runs them in.
+  constexpr int kJobsPerClass = 100;
+  std::vector<int> order;
+  SyncPoint::GetInstance()->SetCallBack(
+      "WorkStealingScheduler::WorkerThread:BeforeRun",
+      [&](void* arg) { order.push_back(*static_cast<int*>(arg)); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Counter counter;
+  for (int i = 0; i < kJobsPerClass; ++i) {
+    env_->Schedule(&Counter::Inc, &counter, Env::Priority::LOW);
+    env_->Schedule(&Counter::Inc, &counter, Env::Priority::HIGH);
+  }
+  env_->SetBackgroundThreads(1, Env::Priority::LOW);
+  ASSERT_TRUE(
+      WaitFor([&] { return counter.count.load() == 2 * kJobsPerClass; }));
+  SyncPoint::GetInstance()->DisableProcessing();
+
+  ASSERT_EQ(2 * kJobsPerClass, order.size());
+  int high = 0;
+  for (size_t i = 0; i < 40; ++i) {
+    high += order[i] == Env::Priority::HIGH ? 1 : 0;
+  }
+  ASSERT_GE(high, 29);
+  ASSERT_LE(high, 31);
+}
+
+TEST_F(WorkStealingSchedulerTest, DecreaseThreads) {
+  NewEnv();
+
+  std::atomic<int> terminated{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "WorkStealingScheduler::WorkerThread:Termination",
+      [&](void*) { terminated++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  env_->SetBackgroundThreads(2, Env::Priority::LOW);
+  env_->SetBackgroundThreads(2, Env::Priority::HIGH);
+  env_->SetBackgroundThreads(1, Env::Priority::HIGH);
+  ASSERT_TRUE(WaitFor([&] { return terminated.load() == 1; }));
+  env_->SetBackgroundThreads(0, Env::Priority::LOW);
+  ASSERT_TRUE(WaitFor([&] { return terminated.load() == 3; }));
+  env_->SetBackgroundThreads(0, Env::Priority::HIGH);
+  ASSERT_TRUE(WaitFor([&] { return terminated.load() == 4; }));
+
+  // Jobs queued while there are no threads run once there are again.
+  Counter counter;
+  env_->Schedule(&Counter::Inc, &counter, Env::Priority::LOW);
+  Env::Default()->SleepForMicroseconds(10000);
+  ASSERT_EQ(0, counter.count.load());
+  env_->SetBackgroundThreads(1, Env::Priority::LOW);
+  ASSERT_TRUE(WaitFor([&] { return counter.count.load() == 1; }));
+}
+
+TEST_F(WorkStealingSchedulerTest, ReserveThreads) {
+  NewEnv();
+  env_->SetBackgroundThreads(2, Env::Priority::BOTTOM);
+  ASSERT_TRUE(WaitFor([&] {
+    return env_->ReserveThreads(0, Env::Priority::BOTTOM) == 0 &&
+           env_->ReleaseThreads(0, Env::Priority::BOTTOM) == 0;
+  }));
+
+  // Wait for both workers to be idle, then reserve them.
+  ASSERT_TRUE(WaitFor([&] {
+    const int reserved = env_->ReserveThreads(2, Env::Priority::BOTTOM);
+    if (reserved == 2) {
+      return true;
+    }
+    env_->ReleaseThreads(reserved, Env::Priority::BOTTOM);
+    return false;
+  }));
+  ASSERT_EQ(0, env_->ReserveThreads(1, Env::Priority::HIGH));
+
+  Counter counter;
+  env_->Schedule(&Counter::Inc, &counter, Env::Priority::HIGH);
+  Env::Default()->SleepForMicroseconds(10000);
+  ASSERT_EQ(0, counter.count.load());
+
+  ASSERT_EQ(1, env_->ReleaseThreads(1, Env::Priority::BOTTOM));
+  ASSERT_TRUE(WaitFor([&] { return counter.count.load() == 1; }));
+  ASSERT_EQ(1, env_->ReleaseThreads(3, Env::Priority::BOTTOM));
+}
+
+TEST_F(WorkStealingSchedulerTest, DB) {
+  NewEnv();
+
+  Options options;
+  options.env = env_.get();
+  options.create_if_missing = true;
+  options.write_buffer_size = 64 << 10;
+  options.level0_file_num_compaction_trigger = 2;
+  options.max_background_jobs = 4;
+  const std::string dbname =
+      test::PerThreadDBPath(Env::Default(), "work_stealing_scheduler_test");
+  ASSERT_OK(DestroyDB(dbname, options));
+
+  DB* db = nullptr;
+  ASSERT_OK(DB::Open(options, dbname, &db));
+  ASSERT_GT(env_->GetBackgroundThreads(Env::Priority::LOW), 0);
+  ASSERT_GT(env_->GetBackgroundThreads(Env::Priority::HIGH), 0);
+
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_OK(db->Put(WriteOptions(), std::to_string(i),
+                      std::string(100, static_cast<char>('a' + i % 26))));
+  }
+  ASSERT_OK(db->Flush(FlushOptions()));
+  ASSERT_OK(db->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  std::string value;
+  ASSERT_OK(db->Get(ReadOptions(), "42", &value));
+  ASSERT_EQ(std::string(100, 'a' + 42 % 26), value);
+
+  delete db;
+  ASSERT_OK(DestroyDB(dbname, options));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,470 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/bulk_loader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "memory/arena.h"
+#include "port/port.h"
+#include "rocksdb/db.h"
+#include "rocksdb/env.h"
+#include "rocksdb/iterator.h"
+#include "rocksdb/sst_file_reader.h"
+#include "rocksdb/sst_file_writer.h"
+#include "rocksdb/table.h"
+#include "util/coding.h"
+#include "util/heap.h"
+#include "util/mutexlock.h"
+#include "util/random.h"
+#include "util/run_in_parallel.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Keys sampled from each shard to pick the partition boundaries.
+constexpr size_t kSamplesPerShard = 1024;
+
+// An entry is stored as a length-prefixed key followed by a length-prefixed
+// value.
+Slice EntryKey(const char* entry) { return GetLengthPrefixedSlice(entry); }
+
+Slice EntryValue(const char* entry) {
+  Slice key = GetLengthPrefixedSlice(entry);
+  return GetLengthPrefixedSlice(key.data() + key.size());
+}
+
+// A sorted run of entries, either in memory or in a spilled file, positioned
+// at the first key of a partition.
+class RunCursor {
+ public:
+  virtual ~RunCursor() = default;
+  virtual bool Valid() const = 0;
+  virtual Slice key() const = 0;
+  virtual Slice value() const = 0;
+  virtual void Next() = 0;
+  virtual Status status() const = 0;
+};
+
+class MemRunCursor : public RunCursor {
+ public:
+  MemRunCursor(const char* const* begin, const char* const* end)
+      : cur_(begin), end_(end) {}
+  bool Valid() const override { return cur_ != end_; }
+  Slice key() const override { return EntryKey(*cur_); }
+  Slice value() const override { return EntryValue(*cur_); }
+  void Next() override { ++cur_; }
+  Status status() const override { return Status::OK(); }
+
+ private:
+  const char* const* cur_;
+  const char* const* const end_;
+};
+
+class FileRunCursor : public RunCursor {
+ public:
+  explicit FileRunCursor(Iterator* iter) : iter_(iter) {}
+  bool Valid() const override { return iter_->Valid(); }
+  Slice key() const override { return iter_->key(); }
+  Slice value() const override { return iter_->value(); }
+  void Next() override { iter_->Next(); }
+  Status status() const override { return iter_->status(); }
+
+ private:
+  std::unique_ptr<Iterator> iter_;
+};
+}  // anonymous namespace
+
+struct BulkLoader::Rep {
+  // Entries added by the threads hashed to it. Sharding keeps the threads
+  // adding entries from contending on a single mutex.
+  struct Shard {
+    port::Mutex mu;
+    std::unique_ptr<Arena> arena{new Arena()};
+    std::vector<const char*> entries;
+    size_t bytes = 0;
+    // Uniform sample of the keys added to this shard.
+    std::vector<std::string> samples;
+    uint64_t num_added = 0;
+    Random64 rnd{0};
+    std::vector<std::string> spilled_files;
+    Status status;
+  };
+
+  Rep(const Options& _options, const BulkLoaderOptions& _loader_options,
+      ColumnFamilyHandle* _column_family)
+      : options(_options),
+        spill_options(_options),
+        loader_options(_loader_options),
+        column_family(_column_family),
+        ucmp(_options.comparator),
+        shards(static_cast<size_t>(std::max(_loader_options.num_threads, 1))) {
+    // Spilled runs are read back once, so they are not worth compressing or
+    // filtering.
+    spill_options.compression = kNoCompression;
+    spill_options.compression_per_level.clear();
+    spill_options.bottommost_compression = kDisableCompressionOption;
+    spill_options.table_factory.reset(NewBlockBasedTableFactory());
+    shard_budget = std::max<size_t>(
+        loader_options.write_buffer_size / shards.size(), 1);
+    for (size_t i = 0; i < shards.size(); ++i) {
+      shards[i].rnd = Random64(i + 1);
+    }
+    if (ucmp->timestamp_size() > 0) {
+      init_status = Status::NotSupported(
+          "BulkLoader does not support user-defined timestamps");
+    } else if (loader_options.output_dir.empty()) {
+      init_status = Status::InvalidArgument("BulkLoader needs an output_dir");
+    }
+  }
+
+  Shard& GetShard() {
+    size_t h = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return shards[h % shards.size()];
+  }
+
+  std::string NewFilePath(const std::string& prefix) {
+    return loader_options.output_dir + "/" + prefix +
+           std::to_string(next_file_number.fetch_add(1)) + ".sst";
+  }
+
+  void SortAndDedup(std::vector<const char*>* entries) const;
+  Status Spill(Shard* shard);
+  std::vector<std::string> PickSplitters() const;
+  Status WritePartition(const std::vector<SstFileReader*>& spilled,
+                        const Slice* lower, const Slice* upper,
+                        std::vector<std::string>* file_paths);
+  void DeleteFiles(const std::vector<std::string>& file_paths) const;
+
+  const Options options;
+  Options spill_options;
+  const BulkLoaderOptions loader_options;
+  ColumnFamilyHandle* const column_family;
+  const Comparator* const ucmp;
+  std::vector<Shard> shards;
+  size_t shard_budget;
+  Status init_status;
+  std::atomic<bool> finished{false};
+  std::atomic<uint64_t> next_file_number{0};
+};
+
+void BulkLoader::Rep::SortAndDedup(std::vector<const char*>* entries) const {
+  // Stable, so that a key added again by the same thread keeps its last
+  // value.
+  std::stable_sort(entries->begin(), entries->end(),
+                   [this](const char* a, const char* b) {
+                     return ucmp->Compare(EntryKey(a), EntryKey(b)) < 0;
+                   });
+  auto last = std::unique(entries->rbegin(), entries->rend(),
+                          [this](const char* a, const char* b) {
+                            return ucmp->Equal(EntryKey(a), EntryKey(b));
+                          });
+  entries->erase(entries->begin(), last.base());
+}
+
+Status BulkLoader::Rep::Spill(Shard* shard) {
+  std::unique_ptr<Arena> arena(new Arena());
+  std::vector<const char*> entries;
+  {
+    MutexLock l(&shard->mu);
+    if (shard->bytes < shard_budget) {
+      // Another thread spilled it in the meantime.
+      return Status::OK();
+    }
+    std::swap(arena, shard->arena);
+    std::swap(entries, shard->entries);
+    shard->bytes = 0;
+  }
+
+  SortAndDedup(&entries);
+  const std::string file_path = NewFilePath("bulk_load_spill_");
+  SstFileWriter writer(EnvOptions(), spill_options);
+  Status s = writer.Open(file_path);
+  for (size_t i = 0; s.ok() && i < entries.size(); ++i) {
+    s = writer.Put(EntryKey(entries[i]), EntryValue(entries[i]));
+  }
+  if (s.ok()) {
+    s = writer.Finish();
+  }
+
+  MutexLock l(&shard->mu);
+  // Recorded even on failure so that the destructor removes it.
+  shard->spilled_files.push_back(file_path);
+  if (!s.ok() && shard->status.ok()) {
+    shard->status = s;
+  }
+  return s;
+}
+
+std::vector<std::string> BulkLoader::Rep::PickSplitters() const {
+  std::vector<std::string> samples;
+  for (const auto& shard : shards) {
+    samples.insert(samples.end(), shard.samples.begin(), shard.samples.end());
+  }
+  std::sort(samples.begin(), samples.end(),
+            [this](const std::string& a, const std::string& b) {
+              return ucmp->Compare(a, b) < 0;
+            });
+  const size_t num_partitions =
+      loader_options.num_partitions > 0
+          ? loader_options.num_partitions
+          : 4 * static_cast<size_t>(std::max(loader_options.num_threads, 1));
+  std::vector<std::string> splitters;
+  for (size_t i = 1; i < num_partitions && !samples.empty(); ++i) {
+    const std::string& key = samples[i * samples.size() / num_partitions];
+    if (splitters.empty() || ucmp->Compare(splitters.back(), key) < 0) {
+      splitters.push_back(key);
+    }
+  }
+  return splitters;
+}
+
+Status BulkLoader::Rep::WritePartition(
+    const std::vector<SstFileReader*>& spilled, const Slice* lower,
+    const Slice* upper, std::vector<std::string>* file_paths) {
+  auto less = [this](const char* a, const Slice& b) {
+    return ucmp->Compare(EntryKey(a), b) < 0;
+  };
+  std::vector<std::unique_ptr<RunCursor>> runs;
+  for (const auto& shard : shards) {
+    const char* const* begin = shard.entries.data();
+    const char* const* end = begin + shard.entries.size();
+    if (lower != nullptr) {
+      begin = std::lower_bound(begin, end, *lower, less);
+    }
+    if (upper != nullptr) {
+      end = std::lower_bound(begin, end, *upper, less);
+    }
+    if (begin != end) {
+      runs.emplace_back(new MemRunCursor(begin, end));
+    }
+  }
+  ReadOptions read_options;
+  read_options.verify_checksums = false;
+  read_options.fill_cache = false;
+  read_options.iterate_upper_bound = upper;
+  for (SstFileReader* reader : spilled) {
+    std::unique_ptr<Iterator> iter(reader->NewIterator(read_options));
+    if (lower != nullptr) {
+      iter->Seek(*lower);
+    } else {
+      iter->SeekToFirst();
+    }
+    if (!iter->Valid()) {
+      Status s = iter->status();
+      if (!s.ok()) {
+        return s;
+      }
+      continue;
+    }
+    runs.emplace_back(new FileRunCursor(iter.release()));
+  }
+
+  struct RunGreater {
+    const Comparator* ucmp;
+    bool operator()(RunCursor* a, RunCursor* b) const {
+      return ucmp->Compare(a->key(), b->key()) > 0;
+    }
+  };
+  BinaryHeap<RunCursor*, RunGreater> heap(RunGreater{ucmp});
+  for (auto& run : runs) {
+    heap.push(run.get());
+  }
+
+  std::unique_ptr<SstFileWriter> writer;
+  std::string last_key;
+  bool has_last_key = false;
+  Status s;
+  while (s.ok() && !heap.empty()) {
+    RunCursor* run = heap.top();
+    const Slice key = run->key();
+    if (!has_last_key || !ucmp->Equal(key, last_key)) {
+      // Files are only cut between distinct keys, so that they do not
+      // overlap.
+      if (writer && writer->FileSize() >= loader_options.target_file_size) {
+        s = writer->Finish();
+        writer.reset();
+      }
+      if (s.ok() && !writer) {
+        writer.reset(new SstFileWriter(EnvOptions(), options, column_family));
+        file_paths->push_back(NewFilePath("bulk_load_"));
+        s = writer->Open(file_paths->back());
+      }
+      if (s.ok()) {
+        s = writer->Put(key, run->value());
+      }
+      last_key.assign(key.data(), key.size());
+      has_last_key = true;
+    }
+    run->Next();
+    if (run->Valid()) {
+      heap.replace_top(run);
+    } else {
+      if (s.ok()) {
+        s = run->status();
+      }
+      heap.pop();
+    }
+  }
+  if (s.ok() && writer) {
+    s = writer->Finish();
+  }
+  return s;
+}
+
+void BulkLoader::Rep::DeleteFiles(
+    const std::vector<std::string>& file_paths) const {
+  for (const auto& file_path : file_paths) {
+    options.env->DeleteFile(file_path).PermitUncheckedError();
+  }
+}
+
+BulkLoader::BulkLoader(const Options& options,
+                       const BulkLoaderOptions& loader_options,
+                       ColumnFamilyHandle* column_family)
+    : rep_(new Rep(options, loader_options, column_family)) {}
+
+BulkLoader::~BulkLoader() {
+  for (auto& shard : rep_->shards) {
+    rep_->DeleteFiles(shard.spilled_files);
+    shard.status.PermitUncheckedError();
+  }
+  rep_->init_status.PermitUncheckedError();
+}
+
+Status BulkLoader::Add(const Slice& key, const Slice& value) {
+  Rep* r = rep_.get();
+  if (!r->init_status.ok()) {
+    return r->init_status;
+  }
+  if (r->finished.load(std::memory_order_relaxed)) {
+    return Status::InvalidArgument("BulkLoader::Finish() was called");
+  }
+  const size_t encoded_size = VarintLength(key.size()) + key.size() +
+                              VarintLength(value.size()) + value.size();
+  Rep::Shard& shard = r->GetShard();
+  bool need_spill;
+  {
+    MutexLock l(&shard.mu);
+    if (!shard.status.ok()) {
+      return shard.status;
+    }
+    char* buf = shard.arena->Allocate(encoded_size);
+    char* p = EncodeVarint32(buf, static_cast<uint32_t>(key.size()));
+    memcpy(p, key.data(), key.size());
+    p = EncodeVarint32(p + key.size(), static_cast<uint32_t>(value.size()));
+    memcpy(p, value.data(), value.size());
+    shard.entries.push_back(buf);
+    shard.bytes += encoded_size + sizeof(const char*);
+
+    // Reservoir sampling
+    ++shard.num_added;
+    if (shard.samples.size() < kSamplesPerShard) {
+      shard.samples.emplace_back(key.data(), key.size());
+    } else {
+      uint64_t i = shard.rnd.Uniform(shard.num_added);
+      if (i < kSamplesPerShard) {
+        shard.samples[i].assign(key.data(), key.size());
+      }
+    }
+    need_spill = shard.bytes >= r->shard_budget;
+  }
+  return need_spill ? r->Spill(&shard) : Status::OK();
+}
+
+Status BulkLoader::Finish(std::vector<std::string>* file_paths) {
+  assert(file_paths);
+  Rep* r = rep_.get();
+  if (!r->init_status.ok()) {
+    return r->init_status;
+  }
+  if (r->finished.exchange(true)) {
+    return Status::InvalidArgument("BulkLoader::Finish() was called");
+  }
+  file_paths->clear();
+  std::vector<std::string> spilled_files;
+  for (auto& shard : r->shards) {
+    if (!shard.status.ok()) {
+      return shard.status;
+    }
+    spilled_files.insert(spilled_files.end(), shard.spilled_files.begin(),
+                         shard.spilled_files.end());
+  }
+
+  const int num_threads = r->loader_options.num_threads;
+  RunInParallel(num_threads, r->shards.size(), [r](size_t i) {
+    r->SortAndDedup(&r->shards[i].entries);
+  });
+
+  std::vector<std::unique_ptr<SstFileReader>> readers;
+  std::vector<SstFileReader*> spilled;
+  for (const auto& file_path : spilled_files) {
+    readers.emplace_back(new SstFileReader(r->spill_options));
+    Status s = readers.back()->Open(file_path);
+    if (!s.ok()) {
+      return s;
+    }
+    spilled.push_back(readers.back().get());
+  }
+
+  // Partition i covers [splitters[i - 1], splitters[i]).
+  const std::vector<std::string> splitters = r->PickSplitters();
+  std::vector<Slice> bounds(splitters.begin(), splitters.end());
+  const size_t num_partitions = bounds.size() + 1;
+  std::vector<std::vector<std::string>> partition_files(num_partitions);
+  std::vector<Status> statuses(num_partitions);
+  RunInParallel(num_threads, num_partitions, [&](size_t i) {
+    const Slice* lower = i > 0 ? &bounds[i - 1] : nullptr;
+    const Slice* upper = i + 1 < num_partitions ? &bounds[i] : nullptr;
+    statuses[i] =
+        r->WritePartition(spilled, lower, upper, &partition_files[i]);
+  });
+
+  Status s;
+  for (size_t i = 0; i < num_partitions; ++i) {
+    if (s.ok() && !statuses[i].ok()) {
+      s = statuses[i];
+    }
+    file_paths->insert(file_paths->end(), partition_files[i].begin(),
+                       partition_files[i].end());
+  }
+
+  readers.clear();
+  for (auto& shard : r->shards) {
+    r->DeleteFiles(shard.spilled_files);
+    shard.spilled_files.clear();
+    shard.entries.clear();
+    shard.arena.reset();
+  }
+  if (!s.ok()) {
+    r->DeleteFiles(*file_paths);
+    file_paths->clear();
+  }
+  return s;
+}
+
+Status BulkLoader::FinishAndIngest(DB* db, ColumnFamilyHandle* column_family) {
+  assert(db);
+  std::vector<std::string> file_paths;
+  Status s = Finish(&file_paths);
+  if (!s.ok() || file_paths.empty()) {
+    return s;
+  }
+  IngestExternalFileOptions ingest_options;
+  ingest_options.move_files = true;
+  ingest_options.ingest_behind = rep_->loader_options.ingest_behind;
+  if (column_family == nullptr) {
+    column_family = db->DefaultColumnFamily();
+  }
+  s = db->IngestExternalFile(column_family, file_paths, ingest_options);
+  if (!s.ok()) {
+    rep_->DeleteFiles(file_paths);
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,151 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/bulk_loader.h"
+
+#include <map>
+#include <thread>
+
+#include "db/db_test_util.h"
+#include "file/file_util.h"
+#include "port/stack_trace.h"
+#include "rocksdb/sst_file_reader.h"
+#include "test_util/testharness.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class BulkLoaderTest : public DBTestBase {
+ public:
+  BulkLoaderTest() : DBTestBase("bulk_loader_test", /*env_do_fsync=*/false) {
+    loader_options_.output_dir = dbname_ + "_bulk_load";
+    EXPECT_OK(env_->CreateDirIfMissing(loader_options_.output_dir));
+  }
+
+  ~BulkLoaderTest() override {
+    EXPECT_OK(DestroyDir(env_, loader_options_.output_dir));
+  }
+
+ protected:
+  BulkLoaderOptions loader_options_;
+};
+
+TEST_F(BulkLoaderTest, UnsortedAddsFromManyThreads) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  // Small enough for every thread to spill a few times.
+  loader_options_.num_threads = 4;
+  loader_options_.write_buffer_size = 64 << 10;
+  loader_options_.num_partitions = 8;
+  loader_options_.target_file_size = 32 << 10;
+  BulkLoader loader(options, loader_options_);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kKeysPerThread = 5000;
+  constexpr int kNumKeys = 8000;
+  // Keys are added several times but always with the same value, since which
+  // value is kept is unspecified.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      Random rnd(301 + t);
+      for (int i = 0; i < kKeysPerThread; ++i) {
+        int k = static_cast<int>(rnd.Uniform(kNumKeys));
+        ASSERT_OK(loader.Add(Key(k), "v" + std::to_string(k)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_OK(loader.FinishAndIngest(db_, db_->DefaultColumnFamily()));
+  ASSERT_TRUE(loader.Add(Key(0), "v").IsInvalidArgument());
+
+  // Spilled runs were removed, and the output files were moved into the DB.
+  std::vector<std::string> children;
+  ASSERT_OK(env_->GetChildren(loader_options_.output_dir, &children));
+  for (const auto& child : children) {
+    ASSERT_TRUE(child == "." || child == "..") << child;
+  }
+
+  // Every file went straight to the bottommost level.
+  ColumnFamilyMetaData cf_meta;
+  db_->GetColumnFamilyMetaData(&cf_meta);
+  ASSERT_GT(cf_meta.file_count, 1);
+  const int last_level = options.num_levels - 1;
+  ASSERT_EQ(cf_meta.file_count, cf_meta.levels[last_level].files.size());
+
+  std::map<std::string, std::string> expected;
+  for (int t = 0; t < kNumThreads; ++t) {
+    Random rnd(301 + t);
+    for (int i = 0; i < kKeysPerThread; ++i) {
+      int k = static_cast<int>(rnd.Uniform(kNumKeys));
+      expected[Key(k)] = "v" + std::to_string(k);
+    }
+  }
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  auto it = expected.begin();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+    ASSERT_NE(it, expected.end());
+    ASSERT_EQ(it->first, iter->key().ToString());
+    ASSERT_EQ(it->second, iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(it, expected.end());
+}
+
+TEST_F(BulkLoaderTest, LastValueWinsWithinThread) {
+  Options options = CurrentOptions();
+  loader_options_.num_threads = 1;
+  BulkLoader loader(options, loader_options_);
+  ASSERT_OK(loader.Add("b", "1"));
+  ASSERT_OK(loader.Add("a", "1"));
+  ASSERT_OK(loader.Add("b", "2"));
+
+  // The keys may be split across partitions, so the output files are read
+  // back together, in key order.
+  std::vector<std::string> file_paths;
+  ASSERT_OK(loader.Finish(&file_paths));
+  ASSERT_GE(file_paths.size(), 1);
+  std::vector<std::pair<std::string, std::string>> entries;
+  for (const auto& file_path : file_paths) {
+    SstFileReader reader(options);
+    ASSERT_OK(reader.Open(file_path));
+    std::unique_ptr<Iterator> iter(reader.NewIterator(ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      entries.emplace_back(iter->key().ToString(), iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+  }
+  const std::vector<std::pair<std::string, std::string>> expected{{"a", "1"},
+                                                                  {"b", "2"}};
+  ASSERT_EQ(expected, entries);
+
+  ASSERT_TRUE(loader.Finish(&file_paths).IsInvalidArgument());
+}
+
+TEST_F(BulkLoaderTest, Empty) {
+  BulkLoader loader(CurrentOptions(), loader_options_);
+  std::vector<std::string> file_paths;
+  ASSERT_OK(loader.Finish(&file_paths));
+  ASSERT_TRUE(file_paths.empty());
+}
+
+TEST_F(BulkLoaderTest, TimestampNotSupported) {
+  Options options = CurrentOptions();
+  options.comparator = test::BytewiseComparatorWithU64TsWrapper();
+  BulkLoader loader(options, loader_options_);
+  ASSERT_TRUE(loader.Add("a", "1").IsNotSupported());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
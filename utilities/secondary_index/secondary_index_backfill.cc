@@ -0,0 +1,238 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/wide/wide_columns_helper.h"
+#include "port/port.h"
+#include "rocksdb/db.h"
+#include "rocksdb/metadata.h"
+#include "rocksdb/snapshot.h"
+#include "rocksdb/utilities/bulk_loader.h"
+#include "rocksdb/utilities/secondary_index.h"
+#include "util/mutexlock.h"
+#include "utilities/secondary_index/secondary_index_helper.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Key ranges scanned per thread, so that threads finishing early can pick up
+// more of the work.
+constexpr size_t kRangesPerThread = 4;
+
+// Splits the key space of `column_family` into up to `max_ranges` ranges, at
+// the smallest keys of its SST files. Returns the start keys of all ranges
+// but the first, which starts before all keys, in ascending order.
+std::vector<std::string> GetRangeBoundaries(DB* db,
+                                            ColumnFamilyHandle* column_family,
+                                            size_t max_ranges) {
+  ColumnFamilyMetaData metadata;
+  db->GetColumnFamilyMetaData(column_family, &metadata);
+
+  std::vector<std::string> keys;
+  for (const auto& level : metadata.levels) {
+    for (const auto& file : level.files) {
+      keys.push_back(file.smallestkey);
+    }
+  }
+
+  const Comparator* const ucmp = column_family->GetComparator();
+  std::sort(keys.begin(), keys.end(),
+            [ucmp](const std::string& lhs, const std::string& rhs) {
+              return ucmp->Compare(lhs, rhs) < 0;
+            });
+  keys.erase(std::unique(keys.begin(), keys.end(),
+                         [ucmp](const std::string& lhs, const std::string& rhs) {
+                           return ucmp->Equal(lhs, rhs);
+                         }),
+             keys.end());
+
+  // The smallest key of all starts the first range anyway.
+  if (!keys.empty()) {
+    keys.erase(keys.begin());
+  }
+
+  if (max_ranges == 0 || keys.size() < max_ranges) {
+    return keys;
+  }
+
+  std::vector<std::string> boundaries;
+  boundaries.reserve(max_ranges - 1);
+  for (size_t i = 1; i < max_ranges; ++i) {
+    boundaries.push_back(std::move(keys[i * keys.size() / max_ranges]));
+  }
+
+  return boundaries;
+}
+
+Status AddSecondaryEntry(const SecondaryIndex* index, const Slice& primary_key,
+                         const Slice& primary_column_value,
+                         BulkLoader* loader) {
+  std::variant<Slice, std::string> secondary_key_prefix;
+
+  {
+    const Status s = index->GetSecondaryKeyPrefix(
+        primary_key, primary_column_value, &secondary_key_prefix);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  {
+    const Status s = index->FinalizeSecondaryKeyPrefix(&secondary_key_prefix);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  std::optional<std::variant<Slice, std::string>> secondary_value;
+
+  {
+    const Status s =
+        index->GetSecondaryValue(primary_key, primary_column_value,
+                                 primary_column_value, &secondary_value);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  const std::string secondary_key =
+      SecondaryIndexHelper::AsString(secondary_key_prefix) +
+      primary_key.ToString();
+
+  return loader->Add(secondary_key,
+                     secondary_value.has_value()
+                         ? SecondaryIndexHelper::AsSlice(*secondary_value)
+                         : Slice());
+}
+
+Status ScanRange(DB* db, const SecondaryIndex* index, const Snapshot* snapshot,
+                 const std::string* lower_bound,
+                 const std::string* upper_bound, BulkLoader* loader) {
+  ColumnFamilyHandle* const column_family = index->GetPrimaryColumnFamily();
+
+  Slice lower_bound_slice;
+  Slice upper_bound_slice;
+
+  ReadOptions read_options;
+  read_options.snapshot = snapshot;
+  read_options.fill_cache = false;
+  if (lower_bound) {
+    lower_bound_slice = *lower_bound;
+    read_options.iterate_lower_bound = &lower_bound_slice;
+  }
+  if (upper_bound) {
+    upper_bound_slice = *upper_bound;
+    read_options.iterate_upper_bound = &upper_bound_slice;
+  }
+
+  std::unique_ptr<Iterator> it(db->NewIterator(read_options, column_family));
+
+  const Slice primary_column_name = index->GetPrimaryColumnName();
+
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    const WideColumns& columns = it->columns();
+
+    const auto column_it = WideColumnsHelper::Find(
+        columns.cbegin(), columns.cend(), primary_column_name);
+    if (column_it == columns.cend()) {
+      continue;
+    }
+
+    const Status s =
+        AddSecondaryEntry(index, it->key(), column_it->value(), loader);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  return it->status();
+}
+}  // namespace
+
+Status BackfillSecondaryIndex(DB* db, const SecondaryIndex* index,
+                              const BulkLoaderOptions& options) {
+  if (!db || !index) {
+    return Status::InvalidArgument("DB and index must be specified");
+  }
+
+  ColumnFamilyHandle* const primary_column_family =
+      index->GetPrimaryColumnFamily();
+  ColumnFamilyHandle* const secondary_column_family =
+      index->GetSecondaryColumnFamily();
+  if (!primary_column_family || !secondary_column_family) {
+    return Status::InvalidArgument(
+        "Primary and secondary column families of the index must be set");
+  }
+  if (primary_column_family->GetID() == secondary_column_family->GetID()) {
+    return Status::InvalidArgument(
+        "Backfill requires different primary and secondary column families");
+  }
+  if (primary_column_family->GetComparator()->timestamp_size() > 0 ||
+      secondary_column_family->GetComparator()->timestamp_size() > 0) {
+    return Status::NotSupported(
+        "Backfill with user-defined timestamps not supported");
+  }
+
+  BulkLoader loader(db->GetOptions(secondary_column_family), options,
+                    secondary_column_family);
+
+  {
+    ManagedSnapshot snapshot(db);
+
+    const size_t num_threads =
+        static_cast<size_t>(std::max(options.num_threads, 1));
+    const std::vector<std::string> boundaries = GetRangeBoundaries(
+        db, primary_column_family, num_threads * kRangesPerThread);
+    const size_t num_ranges = boundaries.size() + 1;
+
+    std::atomic<size_t> next_range{0};
+    port::Mutex status_mutex;
+    Status status;
+
+    auto worker = [&]() {
+      for (size_t i = next_range.fetch_add(1); i < num_ranges;
+           i = next_range.fetch_add(1)) {
+        const Status s =
+            ScanRange(db, index, snapshot.snapshot(),
+                      i > 0 ? &boundaries[i - 1] : nullptr,
+                      i < boundaries.size() ? &boundaries[i] : nullptr,
+                      &loader);
+        if (!s.ok()) {
+          MutexLock lock(&status_mutex);
+          if (status.ok()) {
+            status = s;
+          }
+          // Let the other threads stop after their current range.
+          next_range.store(num_ranges);
+          return;
+        }
+      }
+    };
+
+    std::vector<port::Thread> threads;
+    const size_t num_helpers = std::min(num_threads, num_ranges) - 1;
+    threads.reserve(num_helpers);
+    for (size_t i = 0; i < num_helpers; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return loader.FinishAndIngest(db, secondary_column_family);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
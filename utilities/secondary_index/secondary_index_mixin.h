@@ -6,16 +6,20 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "db/db_impl/db_impl.h"
+#include "db/wide/wide_column_serialization.h"
 #include "db/wide/wide_columns_helper.h"
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/secondary_index.h"
 #include "rocksdb/wide_columns.h"
+#include "rocksdb/write_batch.h"
 #include "util/autovector.h"
 #include "utilities/secondary_index/secondary_index_helper.h"
 
@@ -165,6 +169,19 @@ class SecondaryIndexMixin : public Txn {
     });
   }
 
+  // Adds the updates of the given write batch to the transaction, maintaining
+  // secondary indices the same way as the corresponding Put, PutEntity,
+  // Delete, and SingleDelete calls would but in batched mode: all keys written
+  // are locked upfront in sorted order, and the existing values of the keys of
+  // primary column families are read using a single MultiGetEntity call per
+  // column family instead of one GetEntityForUpdate call per key. Merge and
+  // DeleteRange are not supported. If any update fails, none of the updates in
+  // the batch are added to the transaction.
+  Status WriteBatchWithSecondaryIndices(WriteBatch* batch) {
+    return PerformWithSavePoint(
+        [&]() { return WriteBatchWithSecondaryIndicesImpl(batch); });
+  }
+
  private:
   class IndexData {
    public:
@@ -467,23 +484,36 @@ class SecondaryIndexMixin : public Txn {
       column_family = Txn::DefaultColumnFamily();
     }
 
-    const Slice& primary_key = key;
+    PinnableWideColumns existing_primary_columns;
 
-    {
-      PinnableWideColumns existing_primary_columns;
+    const Status s = GetPrimaryEntryForUpdate(
+        column_family, key, &existing_primary_columns, do_validate);
+    if (!s.ok() && !s.IsNotFound()) {
+      return s;
+    }
+
+    return PutWithExistingPrimaryEntry(
+        column_family, key, value_or_columns,
+        s.ok() ? &existing_primary_columns.columns() : nullptr);
+  }
 
-      const Status s = GetPrimaryEntryForUpdate(
-          column_family, primary_key, &existing_primary_columns, do_validate);
+  // Adds a primary key-value along with its secondary index entries, given the
+  // existing primary entry (nullptr if there is none), which the caller has
+  // read and locked.
+  template <typename Value>
+  Status PutWithExistingPrimaryEntry(
+      ColumnFamilyHandle* column_family, const Slice& key,
+      const Value& value_or_columns,
+      const WideColumns* existing_primary_columns) {
+    assert(column_family);
+
+    const Slice& primary_key = key;
+
+    if (existing_primary_columns) {
+      const Status s = RemoveSecondaryEntries(column_family, primary_key,
+                                              *existing_primary_columns);
       if (!s.ok()) {
-        if (!s.IsNotFound()) {
-          return s;
-        }
-      } else {
-        const Status st = RemoveSecondaryEntries(
-            column_family, primary_key, existing_primary_columns.columns());
-        if (!st.ok()) {
-          return st;
-        }
+        return s;
       }
     }
 
@@ -539,23 +569,38 @@ class SecondaryIndexMixin : public Txn {
       column_family = Txn::DefaultColumnFamily();
     }
 
-    {
-      PinnableWideColumns existing_primary_columns;
+    PinnableWideColumns existing_primary_columns;
 
-      const Status s = GetPrimaryEntryForUpdate(
-          column_family, key, &existing_primary_columns, do_validate);
-      if (!s.ok()) {
-        if (!s.IsNotFound()) {
-          return s;
-        }
+    const Status s = GetPrimaryEntryForUpdate(
+        column_family, key, &existing_primary_columns, do_validate);
+    if (!s.ok() && !s.IsNotFound()) {
+      return s;
+    }
 
-        return Status::OK();
-      } else {
-        const Status st = RemoveSecondaryEntries(
-            column_family, key, existing_primary_columns.columns());
-        if (!st.ok()) {
-          return st;
-        }
+    return DeleteWithExistingPrimaryEntry(
+        column_family, key,
+        s.ok() ? &existing_primary_columns.columns() : nullptr,
+        std::forward<Operation>(operation));
+  }
+
+  // Deletes a primary key-value along with its secondary index entries, given
+  // the existing primary entry (nullptr if there is none), which the caller
+  // has read and locked.
+  template <typename Operation>
+  Status DeleteWithExistingPrimaryEntry(
+      ColumnFamilyHandle* column_family, const Slice& key,
+      const WideColumns* existing_primary_columns, Operation&& operation) {
+    assert(column_family);
+
+    if (!existing_primary_columns) {
+      return Status::OK();
+    }
+
+    {
+      const Status s =
+          RemoveSecondaryEntries(column_family, key, *existing_primary_columns);
+      if (!s.ok()) {
+        return s;
       }
     }
 
@@ -595,6 +640,325 @@ class SecondaryIndexMixin : public Txn {
         });
   }
 
+  // An update read from a write batch applied in batched mode
+  struct BatchedUpdate {
+    enum Type { kPut, kPutEntity, kDelete, kSingleDelete, kLogData };
+
+    Type type;
+    uint32_t column_family_id;
+    Slice key;
+    // The value of kPut, the serialized entity of kPutEntity, or the blob of
+    // kLogData
+    Slice value;
+  };
+
+  class BatchedUpdateCollector : public WriteBatch::Handler {
+   public:
+    explicit BatchedUpdateCollector(std::vector<BatchedUpdate>* updates)
+        : updates_(updates) {
+      assert(updates_);
+    }
+
+    Status PutCF(uint32_t column_family_id, const Slice& key,
+                 const Slice& value) override {
+      updates_->push_back(
+          {BatchedUpdate::kPut, column_family_id, key, value});
+      return Status::OK();
+    }
+
+    Status PutEntityCF(uint32_t column_family_id, const Slice& key,
+                       const Slice& entity) override {
+      updates_->push_back(
+          {BatchedUpdate::kPutEntity, column_family_id, key, entity});
+      return Status::OK();
+    }
+
+    Status DeleteCF(uint32_t column_family_id, const Slice& key) override {
+      updates_->push_back(
+          {BatchedUpdate::kDelete, column_family_id, key, Slice()});
+      return Status::OK();
+    }
+
+    Status SingleDeleteCF(uint32_t column_family_id,
+                          const Slice& key) override {
+      updates_->push_back(
+          {BatchedUpdate::kSingleDelete, column_family_id, key, Slice()});
+      return Status::OK();
+    }
+
+    Status MergeCF(uint32_t /* column_family_id */, const Slice& /* key */,
+                   const Slice& /* value */) override {
+      return Status::NotSupported(
+          "Merge with secondary indices not yet supported");
+    }
+
+    Status DeleteRangeCF(uint32_t /* column_family_id */,
+                         const Slice& /* begin_key */,
+                         const Slice& /* end_key */) override {
+      return Status::NotSupported(
+          "DeleteRange with secondary indices not supported");
+    }
+
+    void LogData(const Slice& blob) override {
+      updates_->push_back({BatchedUpdate::kLogData, 0, Slice(), blob});
+    }
+
+   private:
+    std::vector<BatchedUpdate>* updates_;
+  };
+
+  // The keys of a column family updated by a write batch applied in batched
+  // mode, sorted and deduplicated. For primary column families, the existing
+  // entries of the keys are read before applying the updates.
+  struct BatchedColumnFamily {
+    uint32_t id = 0;
+    ColumnFamilyHandle* handle = nullptr;
+    std::unique_ptr<ColumnFamilyHandle> owned_handle;
+    bool is_primary = false;
+    std::vector<Slice> keys;
+    std::vector<PinnableWideColumns> existing_primary_entries;
+    std::vector<Status> statuses;
+    // Whether the key has already been updated by the write batch, in which
+    // case its existing entry is read again from the transaction
+    std::vector<bool> updated;
+  };
+
+  Status GetBatchedColumnFamily(uint32_t column_family_id,
+                                BatchedColumnFamily* column_family) {
+    assert(column_family);
+
+    column_family->id = column_family_id;
+
+    for (const auto& secondary_index : *secondary_indices_) {
+      assert(secondary_index);
+
+      ColumnFamilyHandle* const primary_column_family =
+          secondary_index->GetPrimaryColumnFamily();
+      assert(primary_column_family);
+
+      if (primary_column_family->GetID() == column_family_id) {
+        column_family->handle = primary_column_family;
+        column_family->is_primary = true;
+
+        return Status::OK();
+      }
+    }
+
+    column_family->owned_handle =
+        Txn::dbimpl_->GetColumnFamilyHandleUnlocked(column_family_id);
+    if (!column_family->owned_handle) {
+      return Status::InvalidArgument("Invalid column family specified");
+    }
+
+    column_family->handle = column_family->owned_handle.get();
+
+    return Status::OK();
+  }
+
+  Status ApplyBatchedUpdate(BatchedColumnFamily* column_family, size_t index,
+                            const BatchedUpdate& update) {
+    assert(column_family);
+    assert(index < column_family->keys.size());
+
+    constexpr bool assume_tracked = true;
+
+    ColumnFamilyHandle* const cfh = column_family->handle;
+
+    WideColumns columns;
+    if (update.type == BatchedUpdate::kPutEntity) {
+      Slice entity = update.value;
+
+      const Status s = WideColumnSerialization::Deserialize(entity, columns);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
+    if (!column_family->is_primary) {
+      switch (update.type) {
+        case BatchedUpdate::kPut:
+          return Txn::Put(cfh, update.key, update.value, assume_tracked);
+        case BatchedUpdate::kPutEntity:
+          return Txn::PutEntity(cfh, update.key, columns, assume_tracked);
+        case BatchedUpdate::kDelete:
+          return Txn::Delete(cfh, update.key, assume_tracked);
+        case BatchedUpdate::kSingleDelete:
+          return Txn::SingleDelete(cfh, update.key, assume_tracked);
+        default:
+          assert(false);
+          return Status::Corruption("Unexpected update in write batch");
+      }
+    }
+
+    PinnableWideColumns updated_primary_columns;
+    const WideColumns* existing_primary_columns = nullptr;
+
+    if (!column_family->updated[index]) {
+      const Status& s = column_family->statuses[index];
+      if (s.ok()) {
+        existing_primary_columns =
+            &column_family->existing_primary_entries[index].columns();
+      } else if (!s.IsNotFound()) {
+        return s;
+      }
+
+      column_family->updated[index] = true;
+    } else {
+      const Status s = Txn::GetEntity(ReadOptions(), cfh, update.key,
+                                      &updated_primary_columns);
+      if (s.ok()) {
+        existing_primary_columns = &updated_primary_columns.columns();
+      } else if (!s.IsNotFound()) {
+        return s;
+      }
+    }
+
+    switch (update.type) {
+      case BatchedUpdate::kPut:
+        return PutWithExistingPrimaryEntry(cfh, update.key, update.value,
+                                           existing_primary_columns);
+      case BatchedUpdate::kPutEntity:
+        return PutWithExistingPrimaryEntry(cfh, update.key, columns,
+                                           existing_primary_columns);
+      case BatchedUpdate::kDelete:
+        return DeleteWithExistingPrimaryEntry(
+            cfh, update.key, existing_primary_columns,
+            [&](ColumnFamilyHandle* primary_cfh, const Slice& primary_key) {
+              return Txn::Delete(primary_cfh, primary_key, assume_tracked);
+            });
+      case BatchedUpdate::kSingleDelete:
+        return DeleteWithExistingPrimaryEntry(
+            cfh, update.key, existing_primary_columns,
+            [&](ColumnFamilyHandle* primary_cfh, const Slice& primary_key) {
+              return Txn::SingleDelete(primary_cfh, primary_key,
+                                       assume_tracked);
+            });
+      default:
+        assert(false);
+        return Status::Corruption("Unexpected update in write batch");
+    }
+  }
+
+  Status WriteBatchWithSecondaryIndicesImpl(WriteBatch* batch) {
+    assert(batch);
+
+    std::vector<BatchedUpdate> updates;
+
+    {
+      BatchedUpdateCollector collector(&updates);
+
+      const Status s = batch->Iterate(&collector);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
+    // Group the keys by column family, in the order of the column family IDs
+    std::vector<BatchedColumnFamily> column_families;
+
+    auto find_column_family = [&](uint32_t column_family_id) {
+      return std::lower_bound(
+          column_families.begin(), column_families.end(), column_family_id,
+          [](const BatchedColumnFamily& column_family, uint32_t id) {
+            return column_family.id < id;
+          });
+    };
+
+    for (const auto& update : updates) {
+      if (update.type == BatchedUpdate::kLogData) {
+        continue;
+      }
+
+      auto it = find_column_family(update.column_family_id);
+      if (it == column_families.end() || it->id != update.column_family_id) {
+        BatchedColumnFamily column_family;
+
+        const Status s =
+            GetBatchedColumnFamily(update.column_family_id, &column_family);
+        if (!s.ok()) {
+          return s;
+        }
+
+        it = column_families.insert(it, std::move(column_family));
+      }
+
+      it->keys.push_back(update.key);
+    }
+
+    // Lock the keys of each column family in sorted order, like
+    // TransactionDB::Write does, then read the existing entries of the keys of
+    // primary column families with the locks held
+    for (auto& column_family : column_families) {
+      const Comparator* const ucmp = column_family.handle->GetComparator();
+      assert(ucmp);
+
+      auto& keys = column_family.keys;
+
+      std::sort(keys.begin(), keys.end(),
+                [ucmp](const Slice& lhs, const Slice& rhs) {
+                  return ucmp->Compare(lhs, rhs) < 0;
+                });
+      keys.erase(std::unique(keys.begin(), keys.end(),
+                             [ucmp](const Slice& lhs, const Slice& rhs) {
+                               return ucmp->Equal(lhs, rhs);
+                             }),
+                 keys.end());
+
+      for (const auto& key : keys) {
+        constexpr bool read_only = false;
+        constexpr bool exclusive = true;
+
+        const Status s =
+            Txn::TryLock(column_family.handle, key, read_only, exclusive);
+        if (!s.ok()) {
+          return s;
+        }
+      }
+
+      if (!column_family.is_primary) {
+        continue;
+      }
+
+      column_family.existing_primary_entries.resize(keys.size());
+      column_family.statuses.resize(keys.size());
+      column_family.updated.resize(keys.size());
+
+      constexpr bool sorted_input = true;
+
+      Txn::MultiGetEntity(ReadOptions(), column_family.handle, keys.size(),
+                          keys.data(),
+                          column_family.existing_primary_entries.data(),
+                          column_family.statuses.data(), sorted_input);
+    }
+
+    for (const auto& update : updates) {
+      if (update.type == BatchedUpdate::kLogData) {
+        Txn::PutLogData(update.value);
+        continue;
+      }
+
+      const auto it = find_column_family(update.column_family_id);
+      assert(it != column_families.end());
+      assert(it->id == update.column_family_id);
+
+      const Comparator* const ucmp = it->handle->GetComparator();
+      const auto key_it =
+          std::lower_bound(it->keys.begin(), it->keys.end(), update.key,
+                           [ucmp](const Slice& lhs, const Slice& rhs) {
+                             return ucmp->Compare(lhs, rhs) < 0;
+                           });
+      assert(key_it != it->keys.end());
+
+      const Status s = ApplyBatchedUpdate(
+          &*it, static_cast<size_t>(key_it - it->keys.begin()), update);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
+    return Status::OK();
+  }
+
   const std::vector<std::shared_ptr<SecondaryIndex>>* secondary_indices_;
 };
 
@@ -46,20 +46,72 @@ struct LockInfo {
 struct LockMapStripe {
   explicit LockMapStripe(std::shared_ptr<TransactionDBMutexFactory> factory) {
     stripe_mutex = factory->AllocateMutex();
-    stripe_cv = factory->AllocateCondVar();
     assert(stripe_mutex);
-    assert(stripe_cv);
   }
 
-  // Mutex must be held before modifying keys map
+  // Mutex must be held before modifying keys map or the waiters
   std::shared_ptr<TransactionDBMutex> stripe_mutex;
 
-  // Condition Variable per stripe for waiting on a lock
-  std::shared_ptr<TransactionDBCondVar> stripe_cv;
-
   // Locked keys mapped to the info about the transactions that locked them.
   // TODO(agiardullo): Explore performance of other data structures.
   UnorderedMap<std::string, LockInfo> keys;
+
+  // Each waiting transaction waits on its own condition variable, registered
+  // under the key it waits for, so that releasing a key only wakes up the
+  // transactions waiting for that key rather than every waiter in the stripe.
+  // Every spurious wakeup would also redo deadlock detection.
+  UnorderedMap<std::string, autovector<TransactionDBCondVar*>> key_waiters;
+
+  // Transactions waiting for the number of locks to go below max_num_locks.
+  // They are woken up whenever a key of this stripe is released.
+  autovector<TransactionDBCondVar*> lock_limit_waiters;
+
+  // Wakes up the waiters of `key`, and the lock limit waiters if
+  // `key_released`.
+  void NotifyWaiters(const std::string& key, bool key_released) {
+    auto waiters_iter = key_waiters.find(key);
+    if (waiters_iter != key_waiters.end()) {
+      for (auto* cv : waiters_iter->second) {
+        cv->Notify();
+      }
+    }
+    if (key_released) {
+      for (auto* cv : lock_limit_waiters) {
+        cv->Notify();
+      }
+    }
+  }
+
+  void AddWaiter(const std::string& key, bool lock_limit,
+                 TransactionDBCondVar* cv) {
+    if (lock_limit) {
+      lock_limit_waiters.push_back(cv);
+    } else {
+      key_waiters[key].push_back(cv);
+    }
+  }
+
+  void RemoveWaiter(const std::string& key, bool lock_limit,
+                    TransactionDBCondVar* cv) {
+    auto remove = [cv](autovector<TransactionDBCondVar*>* waiters) {
+      auto it = std::find(waiters->begin(), waiters->end(), cv);
+      assert(it != waiters->end());
+      if (it != waiters->end()) {
+        *it = waiters->back();
+        waiters->pop_back();
+      }
+    };
+    if (lock_limit) {
+      remove(&lock_limit_waiters);
+    } else {
+      auto waiters_iter = key_waiters.find(key);
+      assert(waiters_iter != key_waiters.end());
+      remove(&waiters_iter->second);
+      if (waiters_iter->second.empty()) {
+        key_waiters.erase(waiters_iter);
+      }
+    }
+  }
 };
 
 // Map of #num_stripes LockMapStripes
@@ -284,6 +336,9 @@ Status PointLockManager::AcquireWithTimeout(
     // as the timeout allows.
     bool timed_out = false;
     bool cv_wait_fail = false;
+    std::shared_ptr<TransactionDBCondVar> wait_cv =
+        mutex_factory_->AllocateCondVar();
+    assert(wait_cv);
     do {
       // Decide how long to wait
       int64_t cv_end_time = -1;
@@ -311,9 +366,13 @@ Status PointLockManager::AcquireWithTimeout(
       }
 
       TEST_SYNC_POINT("PointLockManager::AcquireWithTimeout:WaitingTxn");
+      // The waiter is removed under the stripe mutex, before `wait_cv` can
+      // be destroyed, which is why waiters are notified under that mutex.
+      const bool lock_limit = wait_ids.empty();
+      stripe->AddWaiter(key, lock_limit, wait_cv.get());
       if (cv_end_time < 0) {
         // Wait indefinitely
-        result = stripe->stripe_cv->Wait(stripe->stripe_mutex);
+        result = wait_cv->Wait(stripe->stripe_mutex);
         cv_wait_fail = !result.ok();
       } else {
         // FIXME: in this case, cv_end_time could be `expire_time_hint` from the
@@ -322,14 +381,14 @@ Status PointLockManager::AcquireWithTimeout(
         // instead of exiting this while loop below.
         uint64_t now = env->NowMicros();
         if (static_cast<uint64_t>(cv_end_time) > now) {
-          result = stripe->stripe_cv->WaitFor(stripe->stripe_mutex,
-                                              cv_end_time - now);
+          result = wait_cv->WaitFor(stripe->stripe_mutex, cv_end_time - now);
           cv_wait_fail = !result.ok() && !result.IsTimedOut();
         } else {
           // now >= cv_end_time, we already timed out
           result = Status::TimedOut(Status::SubCode::kLockTimeout);
         }
       }
+      stripe->RemoveWaiter(key, lock_limit, wait_cv.get());
 
       if (wait_ids.size() != 0) {
         txn->ClearWaitingTxn();
@@ -578,7 +637,8 @@ void PointLockManager::UnLockKey(PessimisticTransaction* txn,
     auto txn_it = std::find(txns.begin(), txns.end(), txn_id);
     // Found the key we locked.  unlock it.
     if (txn_it != txns.end()) {
-      if (txns.size() == 1) {
+      const bool key_released = txns.size() == 1;
+      if (key_released) {
         stripe->keys.erase(stripe_iter);
       } else {
         auto last_it = txns.end() - 1;
@@ -593,6 +653,10 @@ void PointLockManager::UnLockKey(PessimisticTransaction* txn,
         assert(lock_map->lock_cnt.load(std::memory_order_relaxed) > 0);
         lock_map->lock_cnt--;
       }
+
+      // Signal waiting threads to retry locking. A shared lock that still has
+      // holders may be upgraded by one of its waiters.
+      stripe->NotifyWaiters(key, key_released && max_num_locks_ > 0);
     }
   } else {
     // This key is either not locked or locked by someone else.  This should
@@ -620,9 +684,6 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
   stripe->stripe_mutex->Lock().PermitUncheckedError();
   UnLockKey(txn, key, stripe, lock_map, env);
   stripe->stripe_mutex->UnLock();
-
-  // Signal waiting threads to retry locking
-  stripe->stripe_cv->NotifyAll();
 }
 
 void PointLockManager::UnLock(PessimisticTransaction* txn,
@@ -666,9 +727,6 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
       }
 
       stripe->stripe_mutex->UnLock();
-
-      // Signal waiting threads to retry locking
-      stripe->stripe_cv->NotifyAll();
     }
   }
 }
@@ -5,6 +5,9 @@
 
 #include "utilities/transactions/lock/point/point_lock_manager_test.h"
 
+#include "util/fastrange.h"
+#include "util/hash.h"
+
 namespace ROCKSDB_NAMESPACE {
 
 // This test is not applicable for Range Lock manager as Range Lock Manager
@@ -156,6 +159,57 @@ TEST_F(PointLockManagerTest, DeadlockDepthExceeded) {
   delete txn1;
 }
 
+TEST_F(PointLockManagerTest, WakeUpOnlyWaitersOfReleasedKey) {
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  // Find a key in the same lock map stripe as "k"
+  auto get_stripe = [](const std::string& key) {
+    return FastRange64(GetSliceNPHash64(key),
+                       TransactionDBOptions().num_stripes);
+  };
+  std::string other_key;
+  for (int i = 0; get_stripe(other_key) != get_stripe("k"); ++i) {
+    other_key = "k" + std::to_string(i);
+  }
+
+  auto txn1 = NewTxn();
+  auto txn2 = NewTxn();
+  auto txn3 = NewTxn();
+  txn2->SetLockTimeout(1000000);
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, true));
+
+  std::atomic<int> num_waits{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      wait_sync_point_name_, [&](void* /*arg*/) { num_waits++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  port::Thread t([&]() {
+    // block because txn1 is holding a lock on k.
+    ASSERT_OK(locker_->TryLock(txn2, 1, "k", env_, true));
+  });
+  while (num_waits.load() == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // Releasing another key of the same stripe does not wake up txn2.
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(locker_->TryLock(txn3, 1, other_key, env_, true));
+    locker_->UnLock(txn3, 1, other_key, env_);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(num_waits.load(), 1);
+
+  locker_->UnLock(txn1, 1, "k", env_);
+  t.join();
+  ASSERT_EQ(num_waits.load(), 1);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  locker_->UnLock(txn2, 1, "k", env_);
+  delete txn3;
+  delete txn2;
+  delete txn1;
+}
+
 INSTANTIATE_TEST_CASE_P(PointLockManager, AnyLockManagerTest,
                         ::testing::Values(nullptr));
 
@@ -672,6 +672,9 @@ Status WriteCommittedTxnDB::Write(const WriteOptions& opts,
   if (!s.ok()) {
     return s;
   }
+  if (!txn_db_options_.secondary_indices.empty()) {
+    return WriteWithSecondaryIndices(opts, updates);
+  }
   if (txn_db_options_.skip_concurrency_control) {
     return db_impl_->Write(opts, updates);
   } else {
@@ -686,6 +689,9 @@ Status WriteCommittedTxnDB::Write(
   if (!s.ok()) {
     return s;
   }
+  if (!txn_db_options_.secondary_indices.empty()) {
+    return WriteWithSecondaryIndices(opts, updates);
+  }
   if (optimizations.skip_concurrency_control) {
     return db_impl_->Write(opts, updates);
   } else {
@@ -693,6 +699,29 @@ Status WriteCommittedTxnDB::Write(
   }
 }
 
+// Secondary index entries have to be maintained even if the client did not
+// request concurrency control, so the batch is applied via an internal
+// transaction, which maintains them for all updates of the batch at once.
+Status WriteCommittedTxnDB::WriteWithSecondaryIndices(const WriteOptions& opts,
+                                                      WriteBatch* updates) {
+  assert(updates);
+
+  std::unique_ptr<Transaction> txn(BeginInternalTransaction(opts));
+
+  auto* const txn_with_indices =
+      static_cast_with_check<SecondaryIndexMixin<WriteCommittedTxn>>(
+          txn.get());
+
+  {
+    const Status s = txn_with_indices->WriteBatchWithSecondaryIndices(updates);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  return txn->Commit();
+}
+
 void PessimisticTransactionDB::InsertExpirableTransaction(
     TransactionID tx_id, PessimisticTransaction* tx) {
   assert(tx->GetExpirationTime() > 0);
@@ -225,6 +225,7 @@ class PessimisticTransactionDB : public TransactionDB {
   virtual Status VerifyCFOptions(const ColumnFamilyOptions& cf_options);
 
  private:
+  friend class WriteCommittedTxnDB;
   friend class WritePreparedTxnDB;
   friend class WritePreparedTxnDBMock;
   friend class WriteUnpreparedTxn;
@@ -287,6 +288,12 @@ class WriteCommittedTxnDB : public PessimisticTransactionDB {
                const TransactionDBWriteOptimizations& optimizations,
                WriteBatch* updates) override;
   Status Write(const WriteOptions& opts, WriteBatch* updates) override;
+
+ private:
+  // Applies the updates via an internal transaction that maintains the
+  // secondary indices in batched mode.
+  Status WriteWithSecondaryIndices(const WriteOptions& opts,
+                                   WriteBatch* updates);
 };
 
 inline Status PessimisticTransactionDB::FailIfBatchHasTs(
@@ -18,6 +18,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/perf_context.h"
+#include "rocksdb/utilities/bulk_loader.h"
 #include "rocksdb/utilities/secondary_index.h"
 #include "rocksdb/utilities/secondary_index_simple.h"
 #include "rocksdb/utilities/transaction.h"
@@ -8862,6 +8863,216 @@ TEST_P(TransactionTest, SecondaryIndexOnKey) {
   }
 }
 
+TEST_P(TransactionTest, SecondaryIndexWriteBatch) {
+  const TxnDBWritePolicy write_policy = std::get<2>(GetParam());
+  if (write_policy != TxnDBWritePolicy::WRITE_COMMITTED) {
+    ROCKSDB_GTEST_BYPASS("Test only WriteCommitted for now");
+    return;
+  }
+
+  txn_db_options.secondary_indices.emplace_back(
+      std::make_shared<SimpleSecondaryIndex>(
+          kDefaultWideColumnName.ToString()));
+
+  ASSERT_OK(ReOpen());
+
+  ColumnFamilyOptions cf1_opts;
+  ColumnFamilyHandle* cfh1 = nullptr;
+  ASSERT_OK(db->CreateColumnFamily(cf1_opts, "cf1", &cfh1));
+  std::unique_ptr<ColumnFamilyHandle> cfh1_guard(cfh1);
+
+  ColumnFamilyOptions cf2_opts;
+  ColumnFamilyHandle* cfh2 = nullptr;
+  ASSERT_OK(db->CreateColumnFamily(cf2_opts, "cf2", &cfh2));
+  std::unique_ptr<ColumnFamilyHandle> cfh2_guard(cfh2);
+
+  auto& index = txn_db_options.secondary_indices.back();
+  index->SetPrimaryColumnFamily(cfh1);
+  index->SetSecondaryColumnFamily(cfh2);
+
+  ASSERT_OK(db->Put(WriteOptions(), cfh1, "key1", "foo"));
+  ASSERT_OK(db->Put(WriteOptions(), cfh1, "key4", "foo"));
+
+  // Apply a batch that updates some keys more than once. The existing values
+  // of all keys are read upfront; those of keys already updated by the batch
+  // have to come from the batch itself.
+  {
+    WriteBatch batch;
+
+    // Default CF => OK but not indexed
+    ASSERT_OK(batch.Put(db->DefaultColumnFamily(), "key0", "foo"));
+
+    // Replaces the index entry of the existing value
+    ASSERT_OK(batch.Put(cfh1, "key1", "bar"));
+
+    // Only the index entry of the last value remains
+    ASSERT_OK(batch.Put(cfh1, "key2", "baz"));
+    ASSERT_OK(batch.PutEntity(cfh1, "key2",
+                              {{kDefaultWideColumnName, "quux"}, {"a", "b"}}));
+
+    // Added and then deleted by the batch
+    ASSERT_OK(batch.Put(cfh1, "key3", "baz"));
+    ASSERT_OK(batch.Delete(cfh1, "key3"));
+
+    // Deletes an existing key and its index entry
+    ASSERT_OK(batch.SingleDelete(cfh1, "key4"));
+
+    ASSERT_OK(batch.PutLogData("blob"));
+
+    ASSERT_OK(db->Write(WriteOptions(), &batch));
+  }
+
+  std::string value;
+  ASSERT_OK(db->Get(ReadOptions(), db->DefaultColumnFamily(), "key0", &value));
+  ASSERT_EQ(value, "foo");
+
+  {
+    std::unique_ptr<Iterator> it(db->NewIterator(ReadOptions(), cfh1));
+
+    it->SeekToFirst();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(it->key(), "key1");
+    ASSERT_EQ(it->value(), "bar");
+
+    it->Next();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(it->key(), "key2");
+    WideColumns expected2{{kDefaultWideColumnName, "quux"}, {"a", "b"}};
+    ASSERT_EQ(it->columns(), expected2);
+
+    it->Next();
+    ASSERT_FALSE(it->Valid());
+    ASSERT_OK(it->status());
+  }
+
+  auto verify_index_entries = [&](const std::vector<std::string>& expected) {
+    std::unique_ptr<Iterator> it(db->NewIterator(ReadOptions(), cfh2));
+
+    std::vector<std::string> keys;
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+      ASSERT_TRUE(it->value().empty());
+      keys.push_back(it->key().ToString());
+    }
+    ASSERT_OK(it->status());
+    ASSERT_EQ(keys, expected);
+  };
+
+  verify_index_entries({"\3barkey1", "\4quuxkey2"});
+
+  // Merges are not supported, and none of the updates of the batch are
+  // applied
+  {
+    WriteBatch batch;
+    ASSERT_OK(batch.Put(cfh1, "key5", "foo"));
+    ASSERT_OK(batch.Merge(cfh1, "key1", "foo"));
+
+    ASSERT_TRUE(db->Write(WriteOptions(), &batch).IsNotSupported());
+  }
+
+  ASSERT_TRUE(db->Get(ReadOptions(), cfh1, "key5", &value).IsNotFound());
+  verify_index_entries({"\3barkey1", "\4quuxkey2"});
+
+  // Indices are maintained even if concurrency control is skipped
+  {
+    WriteBatch batch;
+    ASSERT_OK(batch.Delete(cfh1, "key1"));
+    ASSERT_OK(batch.Put(cfh1, "key5", "foo"));
+
+    TransactionDBWriteOptimizations optimizations;
+    optimizations.skip_concurrency_control = true;
+
+    ASSERT_OK(db->Write(WriteOptions(), optimizations, &batch));
+  }
+
+  verify_index_entries({"\3fookey5", "\4quuxkey2"});
+}
+
+TEST_P(TransactionTest, SecondaryIndexBackfill) {
+  const TxnDBWritePolicy write_policy = std::get<2>(GetParam());
+  if (write_policy != TxnDBWritePolicy::WRITE_COMMITTED) {
+    ROCKSDB_GTEST_BYPASS("Test only WriteCommitted for now");
+    return;
+  }
+
+  ColumnFamilyOptions cf1_opts;
+  ColumnFamilyHandle* cfh1 = nullptr;
+  ASSERT_OK(db->CreateColumnFamily(cf1_opts, "cf1", &cfh1));
+  std::unique_ptr<ColumnFamilyHandle> cfh1_guard(cfh1);
+
+  ColumnFamilyOptions cf2_opts;
+  ColumnFamilyHandle* cfh2 = nullptr;
+  ASSERT_OK(db->CreateColumnFamily(cf2_opts, "cf2", &cfh2));
+  std::unique_ptr<ColumnFamilyHandle> cfh2_guard(cfh2);
+
+  // Load the primary key-values without any index, into several SST files
+  // and the memtable
+  constexpr int kNumKeys = 100;
+  for (int i = 0; i < kNumKeys; ++i) {
+    char key[16];
+    snprintf(key, sizeof(key), "key%03d", i);
+    ASSERT_OK(db->Put(WriteOptions(), cfh1, key, "v" + std::to_string(i % 10)));
+    if (i % 30 == 29) {
+      ASSERT_OK(db->Flush(FlushOptions(), cfh1));
+    }
+  }
+
+  // Not indexed
+  ASSERT_OK(db->PutEntity(WriteOptions(), cfh1, "key999", {{"a", "b"}}));
+
+  SimpleSecondaryIndex index(kDefaultWideColumnName.ToString());
+  index.SetPrimaryColumnFamily(cfh1);
+
+  const std::string output_dir = dbname + "_backfill";
+  ASSERT_OK(env->CreateDirIfMissing(output_dir));
+
+  BulkLoaderOptions loader_options;
+  loader_options.output_dir = output_dir;
+  loader_options.num_threads = 3;
+
+  // The index has to be stored in a column family of its own
+  index.SetSecondaryColumnFamily(cfh1);
+  ASSERT_TRUE(
+      BackfillSecondaryIndex(db, &index, loader_options).IsInvalidArgument());
+
+  index.SetSecondaryColumnFamily(cfh2);
+  ASSERT_OK(BackfillSecondaryIndex(db, &index, loader_options));
+
+  {
+    std::unique_ptr<Iterator> it(db->NewIterator(ReadOptions(), cfh2));
+
+    int num_entries = 0;
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+      ++num_entries;
+    }
+    ASSERT_OK(it->status());
+    ASSERT_EQ(num_entries, kNumKeys);
+  }
+
+  {
+    std::unique_ptr<Iterator> underlying_it(
+        db->NewIterator(ReadOptions(), cfh2));
+    auto it = std::make_unique<SecondaryIndexIterator>(
+        &index, std::move(underlying_it));
+
+    it->Seek("v3");
+    for (int i = 3; i < kNumKeys; i += 10) {
+      char key[16];
+      snprintf(key, sizeof(key), "key%03d", i);
+
+      ASSERT_TRUE(it->Valid());
+      ASSERT_OK(it->status());
+      ASSERT_EQ(it->key(), key);
+      ASSERT_TRUE(it->value().empty());
+
+      it->Next();
+    }
+    ASSERT_FALSE(it->Valid());
+    ASSERT_OK(it->status());
+  }
+
+  ASSERT_OK(DestroyDir(env.get(), output_dir));
+}
+
 TEST_F(TransactionDBTest, CollapseKey) {
   ASSERT_OK(ReOpen());
   ASSERT_OK(db->Put({}, "hello", "world"));